@@ -3,7 +3,7 @@
  * @brief Implementation of AT commands for SmartMeter module.
  * 
  * This file contains the implementation of AT commands for the SmartMeter module.
- * It includes functions to retrieve and set the measurement interval, run a read cycle,
+ * It includes functions to retrieve and set the measurement interval, the meter profile, the meters on the bus and the register filter, run a read cycle,
  * and reset the stored configuration to default values.
  * 
  * @version 1.0
@@ -20,6 +20,7 @@
 #endif
 
 #include "mylog.h"
+#include "smprofile.h"
 #include "smat.h"
 
 /**
@@ -65,6 +66,255 @@ static int at_exec_measurementinterval(char *str)
 	return 0;
 }
 
+/**
+ * @brief Retrieves the meter profile.
+ *
+ * This function returns the configured meter profile and the list of the available profiles.
+ *
+ * @return The result of the query.
+ */
+static int at_query_meterprofile()
+{
+	AppConfig appConfig;
+
+	AppSettings::loadConfiguration(appConfig);
+
+	int length = snprintf(g_at_query_buf, ATQUERY_SIZE, "SmartMeter profile: %d, available: 0=auto-detect", appConfig.meterProfile);
+
+	for (uint8_t i = 0; i < SmProfiles::getCount() && length < ATQUERY_SIZE; i++)
+	{
+		SmProfile const& profile = SmProfiles::getAt(i);
+
+		length += snprintf(g_at_query_buf + length, ATQUERY_SIZE - length, " %d=%s", profile.id, profile.name);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Executes the meter profile command.
+ *
+ * This function stores the meter profile, it is used after the next restart. The profile 0 detects the serial
+ * settings and the profile in the next read cycle. Setting a profile drops the detected serial settings.
+ *
+ * @param str The command string containing the profile identifier.
+ * @return The result of the execution, AT_ERRNO_PARA_VAL if the profile is unknown.
+ */
+static int at_exec_meterprofile(char *str)
+{
+	uint32_t new_val = strtol(str, nullptr, 0);
+
+	if (new_val > 0xff || (new_val != AppConfig::SM_METERPROFILE_AUTODETECT && SmProfiles::find(new_val) == nullptr))
+	{
+		MyLog::log("APP", "Unknown SmartMeter profile %ld", new_val);
+
+		return AT_ERRNO_PARA_VAL;
+	}
+
+	MyLog::log("APP", "Set SmartMeter profile to %ld", new_val);
+
+	AppConfig appConfig;
+
+	AppSettings::loadConfiguration(appConfig);
+
+	appConfig.meterProfile = new_val;
+	appConfig.serialBaudRate = 0;
+
+	AppSettings::saveConfiguration(appConfig);
+
+	return 0;
+}
+
+/**
+ * @brief Retrieves the meters on the bus.
+ *
+ * This function returns the number of meters and the hdlc source address and uplink channel of each meter.
+ *
+ * @return The result of the query.
+ */
+static int at_query_meters()
+{
+	AppConfig appConfig;
+
+	AppSettings::loadConfiguration(appConfig);
+
+	int length = snprintf(g_at_query_buf, ATQUERY_SIZE, "SmartMeter meters: %d of max %d,", appConfig.meterCount, SM_MAX_METERS);
+
+	for (uint8_t i = 0; i < appConfig.meterCount && i < SM_MAX_METERS && length < ATQUERY_SIZE; i++)
+	{
+		length += snprintf(g_at_query_buf + length, ATQUERY_SIZE - length, " %lu:%d", (unsigned long) appConfig.meterAddress[i], appConfig.meterChannel[i]);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Executes the meters command.
+ *
+ * This function stores the meters on the bus as a list of <address>:<channel>, separated by commas. The
+ * number of entries is the number of meters, address 0 accepts any source address and channel 0 uses the
+ * channel of the profile. The meters are used after the next restart.
+ *
+ * @param str The command string containing the list of meters.
+ * @return The result of the execution, AT_ERRNO_PARA_VAL if the list is invalid.
+ */
+static int at_exec_meters(char *str)
+{
+	AppConfig appConfig;
+
+	AppSettings::loadConfiguration(appConfig);
+
+	uint8_t meterCount = 0;
+
+	char *position = str;
+
+	while (*position != 0)
+	{
+		if (meterCount >= SM_MAX_METERS)
+		{
+			MyLog::log("APP", "More than %d SmartMeter meters", SM_MAX_METERS);
+
+			return AT_ERRNO_PARA_VAL;
+		}
+
+		char *end;
+
+		uint32_t address = strtoul(position, &end, 0);
+
+		uint32_t channel = 0;
+
+		if (*end == ':')
+		{
+			channel = strtoul(end + 1, &end, 0);
+		}
+
+		if (end == position || channel > 0xff || (*end != ',' && *end != 0))
+		{
+			MyLog::log("APP", "Invalid SmartMeter meter %d", meterCount + 1);
+
+			return AT_ERRNO_PARA_VAL;
+		}
+
+		appConfig.meterAddress[meterCount] = address;
+		appConfig.meterChannel[meterCount] = channel;
+
+		meterCount++;
+
+		position = *end == ',' ? end + 1 : end;
+	}
+
+	if (meterCount == 0)
+	{
+		return AT_ERRNO_PARA_VAL;
+	}
+
+	MyLog::log("APP", "Set SmartMeter meters to %d", meterCount);
+
+	appConfig.meterCount = meterCount;
+
+	AppSettings::saveConfiguration(appConfig);
+
+	return 0;
+}
+
+/**
+ * @brief Retrieves the register filter.
+ *
+ * This function returns the OBIS codes of the registers which are sent, all registers of the profile are sent
+ * if the filter is empty.
+ *
+ * @return The result of the query.
+ */
+static int at_query_registerfilter()
+{
+	AppConfig appConfig;
+
+	AppSettings::loadConfiguration(appConfig);
+
+	if (appConfig.registerFilterCount == 0)
+	{
+		snprintf(g_at_query_buf, ATQUERY_SIZE, "SmartMeter register filter: all registers");
+
+		return 0;
+	}
+
+	int length = snprintf(g_at_query_buf, ATQUERY_SIZE, "SmartMeter register filter: %d of max %d,", appConfig.registerFilterCount, AppConfig::SM_MAX_REGISTERFILTER);
+
+	for (uint8_t i = 0; i < appConfig.registerFilterCount && i < AppConfig::SM_MAX_REGISTERFILTER && length < ATQUERY_SIZE; i++)
+	{
+		char obis[SmProfiles::OBIS_STRING_SIZE];
+
+		SmProfiles::formatObis(appConfig.registerFilter[i], obis, sizeof(obis));
+
+		length += snprintf(g_at_query_buf + length, ATQUERY_SIZE - length, " %s", obis);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Executes the register filter command.
+ *
+ * This function stores the OBIS codes of the registers which are sent as a list of A.B.C.D.E.F, separated by
+ * commas, the other registers of the push are skipped. 0 sends all registers of the profile. The filter is used
+ * after the next restart.
+ *
+ * @param str The command string containing the list of OBIS codes.
+ * @return The result of the execution, AT_ERRNO_PARA_VAL if the list is invalid.
+ */
+static int at_exec_registerfilter(char *str)
+{
+	AppConfig appConfig;
+
+	AppSettings::loadConfiguration(appConfig);
+
+	uint8_t count = 0;
+
+	char *position = str;
+
+	while (strcmp(str, "0") != 0 && *position != 0)
+	{
+		if (count >= AppConfig::SM_MAX_REGISTERFILTER)
+		{
+			MyLog::log("APP", "More than %d OBIS codes in the SmartMeter register filter", AppConfig::SM_MAX_REGISTERFILTER);
+
+			return AT_ERRNO_PARA_VAL;
+		}
+
+		char obis[SmProfiles::OBIS_STRING_SIZE];
+
+		size_t length = strcspn(position, ",");
+
+		if (length >= sizeof(obis))
+		{
+			return AT_ERRNO_PARA_VAL;
+		}
+
+		memcpy(obis, position, length);
+
+		obis[length] = 0;
+
+		if (!SmProfiles::parseObis(obis, appConfig.registerFilter[count]))
+		{
+			MyLog::log("APP", "Invalid OBIS code %d in the SmartMeter register filter", count + 1);
+
+			return AT_ERRNO_PARA_VAL;
+		}
+
+		count++;
+
+		position = position[length] == ',' ? position + length + 1 : position + length;
+	}
+
+	MyLog::log("APP", "Set SmartMeter register filter to %d OBIS codes", count);
+
+	appConfig.registerFilterCount = count;
+
+	AppSettings::saveConfiguration(appConfig);
+
+	return 0;
+}
+
 /**
  * @brief Executes the read cycle command.
  *
@@ -106,6 +356,9 @@ atcmd_t g_user_at_cmd_list_example[] = {
 	/*|    CMD    |     AT+CMD?      |    AT+CMD=?    |  AT+CMD=value |  AT+CMD  |  Permission  |*/
 	// GNSS commands
 	{"+SMMINT", "Get/Set SmartMeter measurement interval (wakeup timer) in ms", at_query_measurementinterval, at_exec_measurementinterval, NULL, "RW"},
+	{"+SMPROFILE", "Get/Set SmartMeter profile (applied after restart)", at_query_meterprofile, at_exec_meterprofile, NULL, "RW"},
+	{"+SMMETERS", "Get/Set SmartMeter meters on the bus as <address>:<channel>,... (applied after restart)", at_query_meters, at_exec_meters, NULL, "RW"},
+	{"+SMFILTER", "Get/Set SmartMeter registers sent as <OBIS>,..., 0 for all (applied after restart)", at_query_registerfilter, at_exec_registerfilter, NULL, "RW"},
 	{"+SMREAD", "Run a SmartMeter read cycle with data transmision", NULL, NULL, at_cmd_runcycle, "R"},
 	{"+SMRESETCONFIG", "Reset the stored configuration to the default values", NULL, NULL, at_cmd_resetflash, "R"}
 };
@@ -10,17 +10,53 @@
 
 #pragma once
 
+#include <stdint.h>
+
+#ifndef SM_MAX_METERS
+#define SM_MAX_METERS 2                                         // meters on one adapter, the memory of each meter is reserved at build time
+#endif
+
 struct AppConfig {
 
     static const uint8_t SM_SENDDATATYPE_GBTPARSED = 0;         // send parsed gbt data
     static const uint8_t SM_SENDDATATYPE_GBTLASTBLOCK = 1;      // send last block of gbt data
+    static const uint8_t SM_SENDDATATYPE_GBTSCALED = 2;         // send parsed gbt data, numeric values as fixed-point with unit
+    static const uint8_t SM_SENDDATATYPE_DERIVED = 3;           // send the consumption and average power of the energy counters since the last uplink (SmDerived)
+    static const uint8_t SM_SENDDATATYPE_DELTA = 4;             // send the changed values against the last acknowledged uplink (SmDeltaEncoder)
+    static const uint8_t SM_SENDDATATYPE_DICTIONARY = 5;        // send the values in the order of the dictionary, the dictionary on change or request (SmDictionarySession)
+    static const uint8_t SM_SENDDATATYPE_FIXED = 6;             // send the values in the fixed layout of the profile without headers (SmFixedLayout)
+    static const uint8_t SM_SENDDATATYPE_GBTCOMPRESSED = 7;     // send last block of gbt data compressed against the dictionary of the profile (SmGbtDictionary)
     static const uint32_t SM_MEASURE_INTERVAL = 900000;         // default measure interval in ms
     static const uint32_t SM_CYCLE_TIMEOUT = 90000;             // default smartmeter read cycle timeout in ms 
+    static const uint8_t SM_METERPROFILE = 1;                   // default meter profile (SmProfiles::SMPROFILE_LG_E450)
+    static const uint8_t SM_METERPROFILE_AUTODETECT = 0;        // detect the serial settings and the profile in the next read cycle (SmAutoDetect)
+    static const uint32_t SM_METERADDRESS_ANY = 0;              // meter accepts frames of any hdlc source address (SmMeterSlot::ADDRESS_ANY)
+    static const uint32_t SM_EVENT_HEARTBEAT = 21600;           // default heartbeat of the event uplinks in s
+    static const uint8_t SM_DELTA_KEYFRAME_INTERVAL = 16;       // default, every 16th delta frame is a keyframe
+    static const uint8_t SM_MAX_REGISTERFILTER = 8;             // maximum number of OBIS codes of the register filter
 
     uint32_t measureInterval = SM_MEASURE_INTERVAL;
     uint32_t smCycleTimeout = SM_CYCLE_TIMEOUT;
     uint8_t sendDataType = SM_SENDDATATYPE_GBTPARSED;
+    uint8_t meterProfile = SM_METERPROFILE;                     // profile of the connected meters (see SmProfiles)
+    uint32_t serialBaudRate = 0;                                // detected baud rate, 0 for the serial settings of the profile
+    uint8_t serialFormat = 0;                                   // detected serial format (SmSerialFormat), used if the baud rate is not 0
+    uint8_t meterCount = 1;                                     // number of meters on the adapter, 1 to SM_MAX_METERS
+    uint32_t meterAddress[SM_MAX_METERS] = { SM_METERADDRESS_ANY };  // hdlc source address of each meter
+    uint8_t meterChannel[SM_MAX_METERS] = { 0 };                // uplink channel of each meter, 0 for the channel of the profile
     bool decryptData = false;                                   // decrypt data from smartmeter (currently not fully implemented)
+    bool pushSchedule = true;                                   // wake up just before the learned push of the meter (see SmPushScheduler)
+    uint32_t aggregationWindow = 0;                             // listen for further pushes in ms and send their statistics (see SmAggregator), 0 for one push per cycle
+    bool eventUplinks = false;                                  // send only on events and with the heartbeat (see SmEventRules), false for every cycle
+    uint32_t eventPowerThreshold = 0;                           // event if a power rises above the threshold in W, 0 for off
+    uint32_t eventEnergyDelta = 0;                              // event if an energy counter has moved by the delta in Wh since the last uplink, 0 for off
+    bool eventStatusChange = true;                              // event if a status register (no unit) changes
+    uint32_t eventHeartbeat = SM_EVENT_HEARTBEAT;               // uplink at least once in the interval in s without events, 0 for off
+    uint8_t deltaKeyframeInterval = SM_DELTA_KEYFRAME_INTERVAL; // every n-th delta frame is a keyframe (full values), 0 for keyframes on resync only
+    bool priorityTruncation = false;                            // fill one frame in the priority of the registers, the others are deferred (see SmPriorityPlan)
+    uint8_t registerFilterCount = 0;                            // number of OBIS codes of the register filter, 0 sends all registers of the profile
+    uint8_t registerFilter[SM_MAX_REGISTERFILTER][6] = {};      // OBIS codes (fields A to F) of the registers which are sent (see SmRegisterFilter)
+    bool dictionaryRequest = false;                             // the server requested the dictionary with a downlink (not persisted)
     
     // security byte (1st byte) and authentication key (16 bytes) for smartmeter decryption
     uint8_t authenticationKey[17] = { 0x00, 0xd0, 0xd1, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xDB, 0xDC, 0xDD, 0xDE, 0xDF};
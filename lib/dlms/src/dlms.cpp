@@ -43,26 +43,26 @@ bool Dlms::gbtFrameReceived() const
  */
 bool Dlms::hdlcDataReceived(uint8_t const* data, size_t const size, GbtBlock const* addedBlock)
 {
-    if(data == nullptr || size == 0)
+    ByteCursor cursor(data, size);
+
+    if(!cursor.has(1))
     {
         return false;
     }
 
-    size_t pos = 0;
-
-    if(isLlcHeader(data)) 
+    if(isLlcHeader(cursor)) 
     {
         MyLog::log("HDLC", "LLC header detected");
 
         // forwards the LLC header to the GBT frame
-        pos = 3;
+        cursor.skip(3);
     }
 
     // only add the data if it is a GBT frame
-    if(isDlmsGbtFrame(data + pos))
+    if(isDlmsGbtFrame(cursor))
     {
         // add the data to the GBT frame
-        return m_gbtFrame.addPdu(data + pos, size - pos, addedBlock);
+        return m_gbtFrame.addPdu(cursor.current(), cursor.remaining(), addedBlock);
     }
 
     MyLog::logHex("HDLC", "Not a GBT frame", data, size);
@@ -73,35 +73,25 @@ bool Dlms::hdlcDataReceived(uint8_t const* data, size_t const size, GbtBlock con
 /**
  * @brief Checks if the given data is a DLMS GBT frame.
  * 
- * @param data Pointer to the data.
+ * @param cursor Cursor pointing to the data.
  * @return true if the data is a DLMS GBT frame, false otherwise.
  */
-bool Dlms::isDlmsGbtFrame(uint8_t const* data) const
+bool Dlms::isDlmsGbtFrame(ByteCursor const& cursor) const
 {
-    if(data == nullptr)
-    {
-        return false;
-    }
-
     // check if the data is a GBT frame (starts with GBT frame identifier)
-    return data[0] == 0xe0;
+    return cursor.has(1) && cursor.peekUint8(0) == 0xe0;
 }
 
 /**
  * @brief Checks if the given data is an LLC header.
  * 
- * @param data Pointer to the data.
+ * @param cursor Cursor pointing to the data.
  * @return true if the data is an LLC header, false otherwise.
  */
-bool Dlms::isLlcHeader(uint8_t const* data) const
+bool Dlms::isLlcHeader(ByteCursor const& cursor) const
 {
-    if(data == nullptr)
-    {
-        return false;
-    }
-
-    // check if the data is an LLC header (starts with LLC header identifier 0xe6 and 0xe7)
-    return data[0]==0xe6 && data[1]==0xe7;
+    // check if the data is an LLC header (starts with LLC header identifier 0xe6 and 0xe7, followed by the quality byte)
+    return cursor.has(3) && cursor.peekUint8(0) == 0xe6 && cursor.peekUint8(1) == 0xe7;
 }
     
 
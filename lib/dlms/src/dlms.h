@@ -17,13 +17,14 @@
 #include <stdbool.h>
 
 #include "gbt.h"
+#include "bytecursor.h"
 
 class Dlms
 {
     private:
         static size_t const MAX_DLMS_FRAME_SIZE = 1024;                                             // maximum size of a DLMS frame
-        bool isLlcHeader(uint8_t const* data) const;                                                // checks if the LLC header is present
-        bool isDlmsGbtFrame(uint8_t const* data) const;                                             // checks if the frame is a DLMS GBT frame
+        bool isLlcHeader(ByteCursor const& cursor) const;                                           // checks if the LLC header is present
+        bool isDlmsGbtFrame(ByteCursor const& cursor) const;                                        // checks if the frame is a DLMS GBT frame
         Gbt& m_gbtFrame;                                                                            // reference to the Gbt object
 
     public:
@@ -0,0 +1,166 @@
+/**
+ * @file bytecursor.h
+ * @brief This file contains the declaration of the ByteCursor class.
+ *
+ * The ByteCursor is a read position within a received buffer of known size. The decoders check the remaining
+ * length once per element with has() and fetch the bytes of the element afterwards without further checks.
+ * A truncated element is detected before anything is read, instead of reading past the end of the buffer.
+ *
+ * The big-endian fetches copy the bytes into an integer and swap them on little-endian targets, the compiler
+ * turns this into a single load (plus a byte reverse instruction on ARM Cortex-M4).
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+class ByteCursor
+{
+    public:
+        ByteCursor(uint8_t const* data, size_t const size) : m_data(data), m_size(data != nullptr ? size : 0), m_position(0) {}
+
+        bool has(size_t const count) const;                                 // checks if at least count bytes remain, call once per element
+        size_t remaining() const;                                           // number of bytes not read yet
+        size_t position() const;                                            // number of bytes read
+        uint8_t const* current() const;                                     // pointer to the current position
+
+        uint8_t peekUint8(size_t const offset) const;                       // fetches a byte at offset from the current position (unchecked)
+        uint16_t peekUint16(size_t const offset) const;                     // fetches a big-endian 16 bit value at offset (unchecked)
+        uint32_t peekUint32(size_t const offset) const;                     // fetches a big-endian 32 bit value at offset (unchecked)
+        void skip(size_t const count);                                      // moves the position count bytes forward (unchecked)
+
+        static uint16_t loadUint16(uint8_t const* data);                    // big-endian 16 bit load
+        static uint32_t loadUint32(uint8_t const* data);                    // big-endian 32 bit load
+
+    private:
+        uint8_t const* m_data;                                              // start of the buffer
+        size_t m_size;                                                      // size of the buffer
+        size_t m_position;                                                  // current read position
+};
+
+/**
+ * @brief Checks if at least count bytes remain in the buffer.
+ *
+ * @param count Number of bytes the next element needs (identifier included).
+ * @return true if the bytes are available, false if the element is truncated.
+ */
+inline bool ByteCursor::has(size_t const count) const
+{
+    return count <= m_size - m_position;
+}
+
+/**
+ * @brief Gets the number of bytes not read yet.
+ *
+ * @return The remaining bytes.
+ */
+inline size_t ByteCursor::remaining() const
+{
+    return m_size - m_position;
+}
+
+/**
+ * @brief Gets the number of bytes read.
+ *
+ * @return The current position within the buffer.
+ */
+inline size_t ByteCursor::position() const
+{
+    return m_position;
+}
+
+/**
+ * @brief Gets a pointer to the current position (e.g. for the octets of a string).
+ *
+ * @return Pointer into the buffer.
+ */
+inline uint8_t const* ByteCursor::current() const
+{
+    return m_data + m_position;
+}
+
+/**
+ * @brief Fetches a byte relative to the current position, has() must cover offset + 1 bytes.
+ *
+ * @param offset Offset from the current position.
+ * @return The byte.
+ */
+inline uint8_t ByteCursor::peekUint8(size_t const offset) const
+{
+    return m_data[m_position + offset];
+}
+
+/**
+ * @brief Fetches a big-endian 16 bit value relative to the current position, has() must cover offset + 2 bytes.
+ *
+ * @param offset Offset from the current position.
+ * @return The value in host byte order.
+ */
+inline uint16_t ByteCursor::peekUint16(size_t const offset) const
+{
+    return loadUint16(m_data + m_position + offset);
+}
+
+/**
+ * @brief Fetches a big-endian 32 bit value relative to the current position, has() must cover offset + 4 bytes.
+ *
+ * @param offset Offset from the current position.
+ * @return The value in host byte order.
+ */
+inline uint32_t ByteCursor::peekUint32(size_t const offset) const
+{
+    return loadUint32(m_data + m_position + offset);
+}
+
+/**
+ * @brief Moves the position forward, has() must cover count bytes.
+ *
+ * @param count Number of bytes to skip.
+ */
+inline void ByteCursor::skip(size_t const count)
+{
+    m_position += count;
+}
+
+/**
+ * @brief Loads a big-endian 16 bit value from an unaligned address.
+ *
+ * @param data Pointer to the two bytes.
+ * @return The value in host byte order.
+ */
+inline uint16_t ByteCursor::loadUint16(uint8_t const* data)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint16_t value;
+
+    memcpy(&value, data, sizeof(value));
+
+    return __builtin_bswap16(value);
+#else
+    return (uint16_t) (data[0] << 8 | data[1]);
+#endif
+}
+
+/**
+ * @brief Loads a big-endian 32 bit value from an unaligned address.
+ *
+ * @param data Pointer to the four bytes.
+ * @return The value in host byte order.
+ */
+inline uint32_t ByteCursor::loadUint32(uint8_t const* data)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint32_t value;
+
+    memcpy(&value, data, sizeof(value));
+
+    return __builtin_bswap32(value);
+#else
+    return (uint32_t) data[0] << 24 | (uint32_t) data[1] << 16 | (uint32_t) data[2] << 8 | data[3];
+#endif
+}
@@ -27,6 +27,16 @@ Gbt::Gbt(gbt_handler_type gbtHandler) : m_gbtFrameHandler(gbtHandler)
     }
 }
 
+/**
+ * @brief Sets the handler for GBT frames.
+ *
+ * @param gbtHandler The handler function for GBT frames, nullptr to drop the frames.
+ */
+void Gbt::setFrameHandler(gbt_handler_type gbtHandler)
+{
+    m_gbtFrameHandler = gbtHandler;
+}
+
 /**
  * @brief Destructor for the Gbt class.
  */
@@ -94,6 +104,7 @@ GbtBlock const* Gbt::addGbtBlock(uint8_t const* data, size_t const size)
  * This function adds a PDU to the Gbt object and performs necessary checks and actions based on the added block.
  * If the block number of the added block does not match the expected block number, the function resets the Gbt object.
  * If the block number is not 1, it skips blocks until a new first block is received.
+ * A truncated block drops the whole sequence.
  * If the added block is the last block of a sequence, it joins all the received blocks and calls the GBT block handler with the joined buffer.
  * 
  * @param data Pointer to the data of the PDU.
@@ -103,13 +114,34 @@ GbtBlock const* Gbt::addGbtBlock(uint8_t const* data, size_t const size)
  */
 bool Gbt::addPdu(uint8_t const* data, size_t const size, GbtBlock const* addBlock)
 {
+    // a sequence with more blocks than expected is dropped, no block could be stored
+    if(m_gbtBlockCounter >= MAX_GBTBLOCKS)
+    {
+        MyLog::log("GBT", "Maximum of %d blocks reached, sequence dropped", MAX_GBTBLOCKS);
+
+        reset();
+    }
+
     addBlock = addGbtBlock(data, size); 
 
-    if(addBlock->getBlockNumber() != m_gbtBlockCounter)
+    // truncated block, the sequence can not be completed anymore
+    if(!addBlock->isComplete())
+    {
+        MyLog::log("GBT", "Truncated block with %d bytes, sequence dropped", size);
+
+        reset();
+
+        return false;
+    }
+
+    uint16_t blockNumber = addBlock->getBlockNumber();
+
+    if(blockNumber != m_gbtBlockCounter)
     {
+        // the added block is deleted by the reset
         reset();
 
-        if(addBlock->getBlockNumber() != 1)
+        if(blockNumber != 1)
         {
             MyLog::log("GBT", "Block number missmatch, skip blocks till a new first block is received");
 
@@ -140,7 +172,10 @@ bool Gbt::addPdu(uint8_t const* data, size_t const size, GbtBlock const* addBloc
 
             MyLog::logHex("GBT", "...joined GBT block: ", receivedPduBuffer, bufferSize);
 
-            m_gbtFrameHandler(receivedPduBuffer, bufferSize);
+            if(m_gbtFrameHandler != nullptr)
+            {
+                m_gbtFrameHandler(receivedPduBuffer, bufferSize);
+            }
 
             m_gbtReceived = true;
 
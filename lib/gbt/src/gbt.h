@@ -45,6 +45,7 @@ class Gbt {
     public:
         ~Gbt();
         Gbt(gbt_handler_type gbtHandler);
+        void setFrameHandler(gbt_handler_type gbtHandler);                                  // sets the handler called with each joined GBT frame
         void reset();                                                                       // resets the GBT object and m_gbtFrameHandler counter
         bool addPdu(uint8_t const* data, size_t const size, GbtBlock const* addBlock);      // adds a PDU to the GBT frame
         bool gbtFrameReceived() const;                                                      // checks if a GBT frame has been received
@@ -23,7 +23,24 @@
  */
 GbtBlock::GbtBlock(uint8_t const* data, size_t const size)
 {
-    memcpy(m_gbtBlockFrame, data, size);
+    // frames larger than the buffer are kept empty and never complete
+    m_size = (data != nullptr && size <= GBTBLOCK_MAX_SIZE) ? size : 0;
+
+    memcpy(m_gbtBlockFrame, data, m_size);
+}
+
+/**
+ * @brief Checks if the GbtBlock holds the complete header and the PDU content announced in the header.
+ * 
+ * The getters read the header without further checks, a block must be complete before it is used.
+ * 
+ * @return True if the GbtBlock is complete, false if it is truncated.
+ */
+bool GbtBlock::isComplete() const
+{
+    ByteCursor cursor(m_gbtBlockFrame, m_size);
+
+    return cursor.has(GBTBLOCK_HEADER_SIZE) && cursor.has(GBTBLOCK_HEADER_SIZE + cursor.peekUint8(6));
 }
 
 /**
@@ -43,7 +60,7 @@ uint8_t GbtBlock::getBlockControl() const
  */
 uint16_t GbtBlock::getBlockNumber() const
 {
-    return m_gbtBlockFrame[3] | m_gbtBlockFrame[2] << 8;
+    return ByteCursor::loadUint16(m_gbtBlockFrame + 2);
 }
 
 /**
@@ -53,7 +70,7 @@ uint16_t GbtBlock::getBlockNumber() const
  */
 uint16_t GbtBlock::getBlockNumberAcknowledge() const
 {
-    return m_gbtBlockFrame[5] | m_gbtBlockFrame[4] << 8;
+    return ByteCursor::loadUint16(m_gbtBlockFrame + 4);
 }
 
 /**
@@ -107,7 +124,7 @@ bool GbtBlock::pduContentCopyInto(uint8_t* data, uint8_t& size) const
 {
     size = pduContentLength();
 
-    memcpy(data, m_gbtBlockFrame + 7, size);
+    memcpy(data, m_gbtBlockFrame + GBTBLOCK_HEADER_SIZE, size);
 
     return true;
 }
\ No newline at end of file
@@ -15,13 +15,20 @@
 #include <stddef.h>
 #include <stdbool.h>
 
+#include "bytecursor.h"
+
 class GbtBlock {
 
     private:
-        uint8_t m_gbtBlockFrame[1024];                                               // buffer for the GBT block frame (assumption for max. 1024 bytes, subotimal)
+        static size_t const GBTBLOCK_HEADER_SIZE = 7;                               // tag, block control, block number, block number acknowledge, content length
+        static size_t const GBTBLOCK_MAX_SIZE = 1024;                               // maximum size of a GBT block frame
+
+        uint8_t m_gbtBlockFrame[GBTBLOCK_MAX_SIZE];                                 // buffer for the GBT block frame (assumption for max. 1024 bytes, subotimal)
+        size_t m_size;                                                              // size of the received GBT block frame (0 if it did not fit into the buffer)
 
     public:
         GbtBlock(uint8_t const* data, size_t const size);                           // constructor with pointer to the GBT block frame and its size
+        bool isComplete() const;                                                    // checks if the header and the announced PDU content are present
         uint8_t getBlockControl() const;                                            // returns the GBT block control byte
         uint16_t getBlockNumber() const;                                            // returns the GBT block number
         uint16_t getBlockNumberAcknowledge() const;                                 // returns the GBT block number acknowledge
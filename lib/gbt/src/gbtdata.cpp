@@ -1,89 +1,119 @@
 /**
  * @file gbtdata.cpp
- * @brief Implementation of the GbtData class.
+ * @brief Implementation of the GbtDataBase class.
  * 
- * This file contains the implementation of the GbtData class, which represents a collection of GbtValueBase objects.
- * It provides methods for accessing and parsing the data.
+ * This file contains the implementation of the GbtDataBase class, which represents a collection of GbtValueBase objects.
+ * It provides methods for accessing and parsing the data, the storage of the values is provided by GbtDataStore.
  * 
  * @version 1.0
  * @author MFA Informatik AG, Andreas Schneider
  */
 
+#include <new>
+
 #include "gbtdata.h"
-#include "gbtuint16.h"
-#include "gbtuint8.h"
-#include "gbtoctetstring.h"
 #include "mylog.h"
 
 /**
- * @brief Default constructor for the GbtData class.
- * 
- * Initializes the GbtData object with default values.
+ * @brief Constructor for the GbtDataBase class, called by GbtDataStore with its storage.
+ *
+ * @param gbtValues Array for maxValues value pointers.
+ * @param numericSlots Storage for maxValues numeric values (NUMERIC_SLOT_SIZE bytes each).
+ * @param maxValues Maximum number of single GBT values.
+ * @param stringSlots Storage for maxStrings octet string values (STRING_SLOT_SIZE bytes each).
+ * @param maxStrings Maximum number of octet string values.
  */
-GbtData::GbtData()
+GbtDataBase::GbtDataBase(GbtValueBase** gbtValues, uint8_t* numericSlots, uint8_t const maxValues, uint8_t* stringSlots, uint8_t const maxStrings)
+    : m_gbtValues(gbtValues), m_numericSlots(numericSlots), m_stringSlots(stringSlots), m_maxValues(maxValues), m_maxStrings(maxStrings)
 {
-    m_gbtValueCount = 0;
-
-    // better save than sorry
-    for (size_t i = 0; i < MAX_GBTVALUES; i++)
-    {
-        m_gbtValues[i] = nullptr;
-    }
 }
 
 /**
- * @brief Destructor for the GbtData class.
- * 
- * Cleans up the memory allocated for GbtValueBase objects.
+ * @brief Forgets all values, the GbtDataBase object can be reused for the next PDU.
+ *
+ * Runs in constant time. The values in the slots are not destroyed, they hold no resources and are
+ * overwritten by the next parse.
  */
-GbtData::~GbtData()
+void GbtDataBase::reset()
 {
-    for(size_t i=0; i < MAX_GBTVALUES; i++)
-    {
-        if(m_gbtValues[i] != nullptr)
-        {
-            delete m_gbtValues[i];
-        }
-    }
+    m_gbtValueCount = 0;
+    m_numericCount = 0;
+    m_stringCount = 0;
+    m_valueDropped = false;
+    m_pdu = nullptr;
+    m_pduSize = 0;
+
+    m_dateAndTime.clone(GbtDateTime());
+    m_longInvokedPriorityId.assign(0, 0, 0);
 }
 
 /**
- * @brief Get the date and time associated with the GbtData object.
+ * @brief Get the date and time associated with the GbtDataBase object.
  * 
  * @return A constant reference to the GbtDateTime object representing the date and time.
  */
-GbtDateTime const& GbtData::getDateTime() const
+GbtDateTime const& GbtDataBase::getDateTime() const
 {
     return m_dateAndTime; 
 }
 
 /**
- * @brief Get the long invoked priority ID associated with the GbtData object.
+ * @brief Get the long invoked priority ID associated with the GbtDataBase object.
  * 
  * @return A constant reference to the GbtUint32 object representing the long invoked priority ID.
  */
-GbtUint32 const& GbtData::getLongInvokedPriorityId() const
+GbtUint32 const& GbtDataBase::getLongInvokedPriorityId() const
 {
     return m_longInvokedPriorityId;
 }
 
 /**
- * @brief Get the number of GbtValueBase objects stored in the GbtData object.
+ * @brief Get the number of GbtValueBase objects stored in the GbtDataBase object.
  * 
  * @return The number of GbtValueBase objects.
  */
-uint8_t GbtData::getValueCount() const
+uint8_t GbtDataBase::getValueCount() const
 {
     return m_gbtValueCount;
 }
 
 /**
- * @brief Get a specific GbtValueBase object from the GbtData object.
+ * @brief Get the PDU of the last parse, the buffer is not copied.
+ *
+ * @return Pointer to the parsed PDU, nullptr if nothing was parsed since the last reset.
+ */
+uint8_t const* GbtDataBase::getPdu() const
+{
+    return m_pdu;
+}
+
+/**
+ * @brief Get the size of the PDU of the last parse.
+ *
+ * @return The size in bytes, 0 if nothing was parsed since the last reset.
+ */
+size_t GbtDataBase::getPduSize() const
+{
+    return m_pduSize;
+}
+
+/**
+ * @brief Get the maximum number of GbtValueBase objects the GbtDataBase object can store.
+ * 
+ * @return The capacity given by the GbtDataStore template parameter.
+ */
+uint8_t GbtDataBase::getMaxValues() const
+{
+    return m_maxValues;
+}
+
+/**
+ * @brief Get a specific GbtValueBase object from the GbtDataBase object.
  * 
  * @param index The index of the GbtValueBase object to retrieve.
- * @return A constant pointer to the GbtValueBase object, or nullptr if the index is out of range.
+ * @return A constant pointer to the GbtValueBase object, or nullptr if the index is out of range or the value was skipped.
  */
-GbtValueBase const* GbtData::getValue(uint8_t index) const
+GbtValueBase const* GbtDataBase::getValue(uint8_t index) const
 {
     if(index >= m_gbtValueCount)
     {
@@ -94,215 +124,283 @@ GbtValueBase const* GbtData::getValue(uint8_t index) const
 }
 
 /**
- * @brief Parse the raw data and populate the GbtData object with GbtValueBase objects.
+ * @brief Parse the raw data and populate the GbtDataBase object with GbtValueBase objects.
  * 
- * This method parses the raw data and creates GbtValueBase objects based on the data types encountered.
- * The parsed GbtValueBase objects are stored in the GbtData object for later access.
+ * This method resets the object and runs the GbtParser with the GbtDataBase object as visitor. The visitor
+ * callbacks construct GbtValueBase objects in the slots based on the data types encountered and store them
+ * for later access. A value which cannot be stored stops the parse, the values up to it are kept.
  * 
  * @param data A pointer to the raw data.
  * @param size The size of the raw data.
- * @return 0 if the parsing is successful, otherwise the amount of unknown identifiers encountered.
+ * @return 0 if the parsing is successful, otherwise the amount of unknown identifiers encountered (GbtParser::GBTPARSE_MALFORMED if the data is malformed, GBTPARSE_VALUEDROPPED if a value could not be stored).
  */
-int GbtData::parse(uint8_t const* data,  size_t const size)
+int GbtDataBase::parse(uint8_t const* data,  size_t const size)
 {
-    size_t pos = 0;
-    uint8_t unknownIdentifierCount = 0;
-    uint8_t pduArrayIdent = 0;
-    uint8_t pduStructureIdent = 0;    
-    uint8_t pduStructureCounter[MAX_STRUCTURE_NESTED];
-    uint8_t pduArrayCounter[MAX_ARRAY_NESTED];
+    MyLog::log("GBTDATA", "Parse GBT datablock with size %d", size);
 
-    pduStructureCounter[0] = 0;
-    pduArrayCounter[0] = 0;
+    reset();
 
-    MyLog::log("GBTDATA", "Parse GBT datablock with size %d", size);
+    m_pdu = data;
+    m_pduSize = size;
+
+    int result = GbtParser::parse(data, size, *this);
+
+    return m_valueDropped ? GBTPARSE_VALUEDROPPED : result;
+}
+
+/**
+ * @brief Parse the raw data, the values marked in the mask are skipped.
+ *
+ * A skipped value keeps its index, getValue returns nullptr for it. It uses no slot and an octet string is not
+ * formatted, the parse only moves over its octets.
+ *
+ * @param data A pointer to the raw data.
+ * @param size The size of the raw data.
+ * @param skipMask The indexes of the values which are skipped.
+ * @return The result of parse(data, size).
+ */
+int GbtDataBase::parse(uint8_t const* data, size_t const size, GbtValueMask const& skipMask)
+{
+    m_skipMask = &skipMask;
+
+    int result = parse(data, size);
+
+    m_skipMask = nullptr;
+
+    return result;
+}
+
+/**
+ * @brief Reserves the next numeric slot and its value index.
+ * 
+ * @return Pointer to the storage for a GbtUint8, GbtUint16 or GbtUint32, nullptr if the maximum number of values is reached.
+ */
+void* GbtDataBase::allocateNumeric()
+{
+    if(m_gbtValueCount >= m_maxValues)
+    {
+        return nullptr;
+    }
+
+    return m_numericSlots + NUMERIC_SLOT_SIZE * m_numericCount++;
+}
 
-    while(pos < size)
+/**
+ * @brief Reserves the next string slot and its value index.
+ * 
+ * @return Pointer to the storage for a GbtOctetString, nullptr if the maximum number of values or strings is reached.
+ */
+void* GbtDataBase::allocateString()
+{
+    if(m_gbtValueCount >= m_maxValues || m_stringCount >= m_maxStrings)
     {
-        uint8_t identifier = data[pos];
-
-        // long invoke and priority
-        if(identifier == 0x0f && pos == 0)
-        {
-            // parse the long invoke and priority, pos will be incremented by the parse method
-            m_longInvokedPriorityId.parse(data, pos, 0, 0);
-
-            MyLog::log("GBTDATA", "Long invoke and priority ID: %d", m_longInvokedPriorityId.getValue());
-        }
-        
-        // datetime
-        else if(identifier == 0x0c)
-        {
-            // parse the date and time, pos will be incremented by the parse method
-            m_dateAndTime.parse(data, pos, 0, 0);
-
-            MyLog::log("GBTDATA", "Date and time: %d-%d-%d %d:%d:%d", m_dateAndTime.getYear(), m_dateAndTime.getMonth(), m_dateAndTime.getDay(), m_dateAndTime.getHour(), m_dateAndTime.getMinute(), m_dateAndTime.getSecond());
-        }
-
-        // structure
-        else if(identifier == 0x02)
-        {
-            // Current structure count decreased, remains on the same identifier
-            if(pduStructureCounter[pduStructureIdent] != 0)
-            {
-                pduStructureIdent++;
-            }
-
-            pduStructureCounter[pduStructureIdent] = data[pos + 1];
-
-            // The array, if present, is decremented when a new structure is encountered.
-            if(pduArrayCounter[pduArrayIdent] > 0)
-            {
-                pduArrayCounter[pduArrayIdent]--;
-            }
-
-            // move the position to the next identifier
-            pos += 2;
-        }
-
-        // array
-        else if(identifier == 0x01)
-        {
-            if(pduArrayCounter[pduArrayIdent] != 0)
-            {
-                pduArrayIdent++;
-            }
-
-            pduArrayCounter[pduArrayIdent] = data[pos + 1];
-
-            // move the position to the next identifier
-            pos += 2;
-        }
-
-        // unit16
-        else if(identifier == 0x12)
-        {
-            // create a new GbtUint16 object
-            auto* gbtUint16 = new GbtUint16();
-
-            // parse the data, pos will be incremented by the parse method
-            if(gbtUint16->parse(data, pos, pduStructureCounter[pduStructureIdent], pduArrayCounter[pduArrayIdent]))
-            {
-                // store the GbtUint16 object in the array
-                m_gbtValues[m_gbtValueCount++] = gbtUint16;
-
-                MyLog::log("GBTDATA", "GBT parse uint16 value %d", gbtUint16->getValue());
-            }
-            else    
-            {   
-                // delete the GbtUint16 object if the parsing failed
-                delete gbtUint16;
-
-                MyLog::log("GBTDATA", "GBT parse uint16 value failed");
-            }
-
-            // Current structure count decreased, remains on the same identifier
-            if(pduStructureCounter[pduStructureIdent] != 0)
-            {
-                pduStructureCounter[pduStructureIdent]--;
-            }
-        }
-
-        // octete string
-        else if(identifier == 0x09)
-        {
-            // create a new GbtOctetString object
-            auto* gbtOctetString = new GbtOctetString();
-
-            // parse the data, pos will be incremented by the parse method
-            if(gbtOctetString->parse(data, pos, pduStructureCounter[pduStructureIdent], pduArrayCounter[pduArrayIdent]))
-            {
-                // store the GbtOctetString object in the array
-                m_gbtValues[m_gbtValueCount++] = gbtOctetString;
-
-                MyLog::log("GBTDATA", "GBT parse octet string value %s", gbtOctetString->getStringValue());
-            }
-            else
-            {
-                // delete the GbtOctetString object if the parsing failed
-                delete gbtOctetString;
-
-                MyLog::log("GBTDATA", "GBT parse octet string value failed");
-            }
-
-            // Current structure count decreased, remains on the same identifier
-            if(pduStructureCounter[pduStructureIdent] != 0)
-            {
-                pduStructureCounter[pduStructureIdent]--;
-            }
-        }
-
-        // unit8
-        else if(identifier == 0x0f)
-        {
-            // create a new GbtUint8 object
-            auto* gbtUint8 = new GbtUint8();
-
-            // parse the data, pos will be incremented by the parse method
-            if(gbtUint8->parse(data, pos, pduStructureCounter[pduStructureIdent], pduArrayCounter[pduArrayIdent]))
-            {
-                // store the GbtUint8 object in the array
-                m_gbtValues[m_gbtValueCount++] = gbtUint8;
-
-                MyLog::log("GBTDATA", "GBT parse uint8 value %d", gbtUint8->getValue());
-            }
-            else
-            {
-                // delete the GbtUint8 object if the parsing failed
-                delete gbtUint8;
-
-                MyLog::log("GBTDATA", "GBT parse uint8 value failed");
-            }
-
-            // Current structure count decreased, remains on the same identifier
-            if(pduStructureCounter[pduStructureIdent] != 0)
-            {
-                pduStructureCounter[pduStructureIdent]--;
-            }
-        }
-
-        // unit32
-        else if(identifier == 0x06)
-        {
-            // create a new GbtUint32 object
-            auto* gbtUint32 = new GbtUint32();
-
-            // parse the data, pos will be incremented by the parse method
-            if(gbtUint32->parse(data, pos, pduStructureCounter[pduStructureIdent], pduArrayCounter[pduArrayIdent]))
-            {
-                // store the GbtUint32 object in the array
-                m_gbtValues[m_gbtValueCount++] = gbtUint32;
-
-                MyLog::log("GBTDATA", "GBT parse uint32 value %d", gbtUint32->getValue());
-            }
-            else
-            {
-                // delete the GbtUint32 object if the parsing failed
-                delete gbtUint32;
-
-                MyLog::log("GBTDATA", "GBT parse uint32 value failed");
-            }
-
-            // Current structure count decreased, remains on the same identifier
-            if(pduStructureCounter[pduStructureIdent] != 0)
-            {
-                pduStructureCounter[pduStructureIdent]--;
-            }
-        }
-        
-        // default
-        else {
-
-            MyLog::log("GBTDATA", "GBT parse unknown data type %d", identifier);
-
-            // move the position to the next identifier
-            pos++;
-
-            // count the number of unknown identifiers
-            unknownIdentifierCount++;
-        }
+        return nullptr;
     }
 
-    return unknownIdentifierCount;
+    return m_stringSlots + STRING_SLOT_SIZE * m_stringCount++;
+}
+
+/**
+ * @brief GbtParser callback, stores the long invoke and priority ID.
+ */
+GbtVisitResult GbtDataBase::onLongInvokeId(uint32_t const longInvokeId)
+{
+    m_longInvokedPriorityId.assign(longInvokeId, 0, 0);
+
+    MyLog::log("GBTDATA", "Long invoke and priority ID: %d", m_longInvokedPriorityId.getValue());
+
+    return GbtVisitResult::GBTVISIT_CONTINUE;
 }
 
+/**
+ * @brief GbtParser callback, stores the date and time.
+ */
+GbtVisitResult GbtDataBase::onDateTime(GbtDateTime const& dateTime)
+{
+    m_dateAndTime.clone(dateTime);
+
+    MyLog::log("GBTDATA", "Date and time: %d-%d-%d %d:%d:%d", m_dateAndTime.getYear(), m_dateAndTime.getMonth(), m_dateAndTime.getDay(), m_dateAndTime.getHour(), m_dateAndTime.getMinute(), m_dateAndTime.getSecond());
+
+    return GbtVisitResult::GBTVISIT_CONTINUE;
+}
+
+/**
+ * @brief GbtParser callback, structures are not materialised (the values carry the structure identifier).
+ */
+GbtVisitResult GbtDataBase::onStructureBegin(uint8_t const elementCount)
+{
+    return GbtVisitResult::GBTVISIT_CONTINUE;
+}
+
+/**
+ * @brief GbtParser callback, arrays are not materialised (the values carry the array identifier).
+ */
+GbtVisitResult GbtDataBase::onArrayBegin(uint8_t const elementCount)
+{
+    return GbtVisitResult::GBTVISIT_CONTINUE;
+}
+
+/**
+ * @brief GbtParser callback, constructs a GbtUint8 object in the next numeric slot.
+ */
+GbtVisitResult GbtDataBase::onUint8(uint8_t const value, uint8_t const structureIdent, uint8_t const arrayIdent)
+{
+    if(skipValue())
+    {
+        return GbtVisitResult::GBTVISIT_CONTINUE;
+    }
+
+    void* slot = allocateNumeric();
+
+    if(slot == nullptr)
+    {
+        return dropValue("maximum of values reached");
+    }
+
+    auto* gbtUint8 = new (slot) GbtUint8();
+
+    gbtUint8->assign(value, structureIdent, arrayIdent);
+
+    m_gbtValues[m_gbtValueCount++] = gbtUint8;
+
+    MyLog::log("GBTDATA", "GBT parse uint8 value %d", value);
+
+    return GbtVisitResult::GBTVISIT_CONTINUE;
+}
+
+/**
+ * @brief GbtParser callback, constructs a GbtUint16 object in the next numeric slot.
+ */
+GbtVisitResult GbtDataBase::onUint16(uint16_t const value, uint8_t const structureIdent, uint8_t const arrayIdent)
+{
+    if(skipValue())
+    {
+        return GbtVisitResult::GBTVISIT_CONTINUE;
+    }
+
+    void* slot = allocateNumeric();
+
+    if(slot == nullptr)
+    {
+        return dropValue("maximum of values reached");
+    }
+
+    auto* gbtUint16 = new (slot) GbtUint16();
+
+    gbtUint16->assign(value, structureIdent, arrayIdent);
+
+    m_gbtValues[m_gbtValueCount++] = gbtUint16;
+
+    MyLog::log("GBTDATA", "GBT parse uint16 value %d", value);
+
+    return GbtVisitResult::GBTVISIT_CONTINUE;
+}
+
+/**
+ * @brief GbtParser callback, constructs a GbtUint32 object in the next numeric slot.
+ */
+GbtVisitResult GbtDataBase::onUint32(uint32_t const value, uint8_t const structureIdent, uint8_t const arrayIdent)
+{
+    if(skipValue())
+    {
+        return GbtVisitResult::GBTVISIT_CONTINUE;
+    }
+
+    void* slot = allocateNumeric();
+
+    if(slot == nullptr)
+    {
+        return dropValue("maximum of values reached");
+    }
+
+    auto* gbtUint32 = new (slot) GbtUint32();
+
+    gbtUint32->assign(value, structureIdent, arrayIdent);
+
+    m_gbtValues[m_gbtValueCount++] = gbtUint32;
+
+    MyLog::log("GBTDATA", "GBT parse uint32 value %d", value);
+
+    return GbtVisitResult::GBTVISIT_CONTINUE;
+}
+
+/**
+ * @brief GbtParser callback, constructs a GbtOctetString object in the next string slot.
+ */
+GbtVisitResult GbtDataBase::onOctetString(uint8_t const* data, uint8_t const length, uint8_t const structureIdent, uint8_t const arrayIdent)
+{
+    if(skipValue())
+    {
+        return GbtVisitResult::GBTVISIT_CONTINUE;
+    }
+
+    void* slot = allocateString();
+
+    if(slot == nullptr)
+    {
+        return dropValue("maximum of values or strings reached");
+    }
+
+    auto* gbtOctetString = new (slot) GbtOctetString();
+
+    // the octets are formatted into the string buffer
+    if(!gbtOctetString->assign(data, length, structureIdent, arrayIdent))
+    {
+        // give the slot back if the parsing failed
+        m_stringCount--;
+
+        return dropValue("octet string too long");
+    }
+
+    m_gbtValues[m_gbtValueCount++] = gbtOctetString;
+
+    MyLog::log("GBTDATA", "GBT parse octet string value %s", gbtOctetString->getStringValue());
+
+    return GbtVisitResult::GBTVISIT_CONTINUE;
+}
+
+/**
+ * @brief GbtParser callback, unknown identifiers are counted by the parser.
+ */
+GbtVisitResult GbtDataBase::onUnknown(uint8_t const identifier)
+{
+    MyLog::log("GBTDATA", "GBT parse unknown data type %d", identifier);
+
+    return GbtVisitResult::GBTVISIT_CONTINUE;
+}
+
+/**
+ * @brief Stops the parse at a value which cannot be stored.
+ *
+ * The later values would move down one index and no longer match the push layout, the values are incomplete.
+ *
+ * @param reason The reason for the log.
+ * @return GBTVISIT_STOP.
+ */
+GbtVisitResult GbtDataBase::dropValue(char const* reason)
+{
+    MyLog::log("GBTDATA", "GBT value %d dropped (%s), parse stopped", m_gbtValueCount, reason);
+
+    m_valueDropped = true;
+
+    return GbtVisitResult::GBTVISIT_STOP;
+}
+
+/**
+ * @brief Skips the next value if it is marked in the skip mask of the running parse.
+ *
+ * The value keeps its index with an empty pointer, the indexes of the later values stay the same.
+ *
+ * @return true if the value was skipped, false if it is stored.
+ */
+bool GbtDataBase::skipValue()
+{
+    if(m_skipMask == nullptr || !m_skipMask->isSet(m_gbtValueCount) || m_gbtValueCount >= m_maxValues)
+    {
+        return false;
+    }
+
+    m_gbtValues[m_gbtValueCount++] = nullptr;
+
+    return true;
+}
\ No newline at end of file
@@ -1,10 +1,21 @@
 /**
  * @file gbtdata.h
- * @brief This file contains the declaration of the GbtData class.
- * 
+ * @brief This file contains the declaration of the GbtDataBase class and the GbtDataStore template.
+ *
  * The GbtData class represents a data structure that holds GBT (Generic Binary Telemetry) values.
  * It provides methods for parsing data, accessing values, and retrieving metadata such as date and time.
- * 
+ * GbtData is a visitor of the GbtParser which materialises every value of the PDU.
+ *
+ * The values are not allocated on the heap. GbtDataStore reserves the storage for a fixed number of values
+ * and strings (template parameters), the values are constructed in place into these slots. The object is
+ * meant to be long-lived, reset() makes it reusable in constant time (the slots are simply overwritten).
+ * GbtDataBase is the non-template interface used by the smart meter handlers. A value which cannot be stored
+ * stops the parse (GBTPARSE_VALUEDROPPED), the indexes of the later values would be shifted otherwise.
+ * The values marked in a GbtValueMask are skipped by the parse: they keep their index (getValue returns nullptr)
+ * but use no slot and are not formatted.
+ * The PDU itself is not copied, getPdu() refers to the buffer of the last parse. The caller keeps the buffer
+ * unchanged as long as it uses the raw PDU with the values (e.g. the cached layout of a push).
+ *
  * @version 1.0
  * @author MFA Informatik AG, Andreas Schneider
  */
@@ -12,29 +23,102 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #include "gbtvaluebase.h"
 #include "gbtddatetime.h"
+#include "gbtuint8.h"
+#include "gbtuint16.h"
 #include "gbtuint32.h"
+#include "gbtoctetstring.h"
+#include "gbtparser.h"
+#include "gbtvaluemask.h"
 
-class GbtData
+/**
+ * @brief Returns the larger of two sizes at compile time (slot size and alignment of the value storage).
+ */
+constexpr size_t gbtMaxSize(size_t const a, size_t const b)
+{
+    return a > b ? a : b;
+}
+
+class GbtDataBase
 {
     private:
-        static const uint8_t MAX_GBTVALUES = 100;                   // maximum number of single GBT values (e.g. int, float, string, etc.)
-        static const uint8_t MAX_STRUCTURE_NESTED = 20;             // maximum number of nested structures (GBT protocol)
-        static const uint8_t MAX_ARRAY_NESTED = 20;                 // maximum number of nested arrays (GBT protocol)
-        
-        GbtValueBase* m_gbtValues[MAX_GBTVALUES];                   // array of pointers to GBT values (m_gbtValueCount is the number of valid pointers in the array)
+        friend class GbtParser;
+
+        GbtValueBase** m_gbtValues;                                 // array of pointers to GBT values (m_gbtValueCount is the number of valid pointers in the array)
+        uint8_t* m_numericSlots;                                    // storage for the numeric values (uint8, uint16, uint32)
+        uint8_t* m_stringSlots;                                     // storage for the octet string values
+        uint8_t const m_maxValues;                                  // maximum number of single GBT values
+        uint8_t const m_maxStrings;                                 // maximum number of octet string values
         uint8_t m_gbtValueCount = 0;                                // number of valid pointers in the array
+        uint8_t m_numericCount = 0;                                 // number of used numeric slots
+        uint8_t m_stringCount = 0;                                  // number of used string slots
+        bool m_valueDropped = false;                                // flag indicating if the parse stopped at a value which could not be stored
+        GbtValueMask const* m_skipMask = nullptr;                   // values skipped by the running parse, nullptr for none
+        uint8_t const* m_pdu = nullptr;                             // PDU of the last parse, nullptr after a reset
+        size_t m_pduSize = 0;                                       // size of the PDU of the last parse
         GbtDateTime m_dateAndTime;                                  // date and time of the GBT data
         GbtUint32 m_longInvokedPriorityId;                          // invoked priority ID of the GBT data
 
+        void* allocateNumeric();                                                                                            // returns the next free numeric slot, nullptr if all values are used
+        void* allocateString();                                                                                             // returns the next free string slot, nullptr if all strings are used
+        GbtVisitResult onLongInvokeId(uint32_t const longInvokeId);                                                         // GbtParser callbacks
+        GbtVisitResult onDateTime(GbtDateTime const& dateTime);
+        GbtVisitResult onStructureBegin(uint8_t const elementCount);
+        GbtVisitResult onArrayBegin(uint8_t const elementCount);
+        GbtVisitResult onUint8(uint8_t const value, uint8_t const structureIdent, uint8_t const arrayIdent);
+        GbtVisitResult onUint16(uint16_t const value, uint8_t const structureIdent, uint8_t const arrayIdent);
+        GbtVisitResult onUint32(uint32_t const value, uint8_t const structureIdent, uint8_t const arrayIdent);
+        GbtVisitResult onOctetString(uint8_t const* data, uint8_t const length, uint8_t const structureIdent, uint8_t const arrayIdent);
+        GbtVisitResult onUnknown(uint8_t const identifier);
+        GbtVisitResult dropValue(char const* reason);                                                                       // stops the parse at a value which cannot be stored
+        bool skipValue();                                                                                                   // keeps the index of a value marked in the skip mask without storing it
+
+    protected:
+        static constexpr size_t NUMERIC_SLOT_SIZE = gbtMaxSize(sizeof(GbtUint8), gbtMaxSize(sizeof(GbtUint16), sizeof(GbtUint32)));     // size of one numeric value slot
+        static constexpr size_t NUMERIC_SLOT_ALIGN = gbtMaxSize(alignof(GbtUint8), gbtMaxSize(alignof(GbtUint16), alignof(GbtUint32)));  // alignment of the numeric value slots
+        static constexpr size_t STRING_SLOT_SIZE = sizeof(GbtOctetString);                                                        // size of one octet string slot
+
+        GbtDataBase(GbtValueBase** gbtValues, uint8_t* numericSlots, uint8_t const maxValues, uint8_t* stringSlots, uint8_t const maxStrings);
+
     public:
-        GbtData();                                                  
-        ~GbtData();
-        int parse(uint8_t const* data, size_t const size);          // parses the received GBT data into single values
+        static int const GBTPARSE_VALUEDROPPED = -2;                // a value could not be stored (storage full, octet string too long), the parse stopped
+
+        GbtDataBase(GbtDataBase const&) = delete;                   // the value pointers refer to the own storage, no copies
+        GbtDataBase& operator=(GbtDataBase const&) = delete;
+
+        void reset();                                               // forgets all values in constant time, the object can be reused
+        int parse(uint8_t const* data, size_t const size);          // resets the object and parses the received GBT data into single values, < 0 on failure
+        int parse(uint8_t const* data, size_t const size, GbtValueMask const& skipMask);    // same as parse, the marked values are skipped
         uint8_t getValueCount() const;                              // returns the number of single GBT values
+        uint8_t getMaxValues() const;                               // returns the maximum number of single GBT values
         GbtDateTime const& getDateTime() const;                     // returns the date and time of the GBT data
         GbtUint32 const& getLongInvokedPriorityId() const;          // returns the invoked priority ID of the GBT data
-        GbtValueBase const* getValue(uint8_t index) const;          // returns a pointer to the single GBT value at the given index
-};
\ No newline at end of file
+        GbtValueBase const* getValue(uint8_t index) const;          // returns a pointer to the single GBT value at the given index, nullptr if it was skipped
+        uint8_t const* getPdu() const;                              // returns the PDU of the last parse (not copied), nullptr after a reset
+        size_t getPduSize() const;                                  // returns the size of the PDU of the last parse
+};
+
+/**
+ * @brief GBT data with the storage for MAX_GBTVALUES values, MAX_GBTSTRINGS of them can be octet strings.
+ *
+ * sizeof(GbtDataStore) is the complete memory used, nothing is allocated at runtime.
+ */
+template <uint8_t MAX_GBTVALUES, uint8_t MAX_GBTSTRINGS>
+class GbtDataStore : public GbtDataBase
+{
+    private:
+        static_assert(MAX_GBTVALUES > 0, "GbtDataStore needs at least one value");
+        static_assert(MAX_GBTSTRINGS <= MAX_GBTVALUES, "GbtDataStore strings are values too");
+
+        GbtValueBase* m_gbtValueStorage[MAX_GBTVALUES];                                             // value pointers in PDU order
+        alignas(NUMERIC_SLOT_ALIGN) uint8_t m_numericStorage[MAX_GBTVALUES * NUMERIC_SLOT_SIZE];   // numeric values, constructed in place
+        alignas(GbtOctetString) uint8_t m_stringStorage[(MAX_GBTSTRINGS > 0 ? MAX_GBTSTRINGS : 1) * STRING_SLOT_SIZE];   // octet string values, constructed in place
+
+    public:
+        GbtDataStore() : GbtDataBase(m_gbtValueStorage, m_numericStorage, MAX_GBTVALUES, m_stringStorage, MAX_GBTSTRINGS) {}
+};
+
+typedef GbtDataStore<100, 20> GbtData;                              // default capacity (E450 push with 74 values, 17 of them octet strings)
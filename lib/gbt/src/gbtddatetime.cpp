@@ -8,7 +8,6 @@
  * @version 1.0
  * @author MFA Informatik AG, Andreas Schneider
  */
-#include <time.h>
 #include <stdio.h>
 
 #include "gbtddatetime.h"
@@ -77,30 +76,96 @@ uint8_t GbtDateTime::getSecond() const
 }
 
 /**
- * @brief Converts the GbtDateTime object to a Unix timestamp.
+ * @brief Get the deviation of the local time to UTC.
+ * 
+ * DLMS convention: UTC = local time + deviation, e.g. -60 for CET and -120 for CEST.
  * 
- * @return The Unix timestamp representing the GbtDateTime object.
+ * @return The deviation in minutes, DEVIATION_NOT_SPECIFIED if the meter does not provide it.
  */
-time_t GbtDateTime::asUnixTimeStamp() const 
+int16_t GbtDateTime::getDeviation() const
 {
-    time_t rawtime;
+    return m_deviation;
+}
 
-    struct tm * timeinfo;
+/**
+ * @brief Get the raw clock status byte of the GbtDateTime object.
+ * 
+ * @return The clock status, CLOCKSTATUS_NOT_SPECIFIED if the meter does not provide it.
+ */
+uint8_t GbtDateTime::getClockStatus() const
+{
+    return m_clockStatus;
+}
 
-    time(&rawtime); 
+/**
+ * @brief Checks if the meter flags the clock value as invalid.
+ * 
+ * @return true if the invalid value or the invalid clock status bit is set, false otherwise.
+ */
+bool GbtDateTime::isInvalidValue() const
+{
+    if(m_clockStatus == CLOCKSTATUS_NOT_SPECIFIED)
+    {
+        return false;
+    }
 
-    timeinfo = localtime(&rawtime); 
+    return (m_clockStatus & (CLOCKSTATUS_INVALID_VALUE | CLOCKSTATUS_INVALID_STATUS)) != 0;
+}
 
-    timeinfo->tm_year   = this->getYear() - 1900;
-    timeinfo->tm_mon    = this->getMonth() - 1;    
-    timeinfo->tm_mday   = this->getDay();           
-    timeinfo->tm_hour   = this->getHour();
-    timeinfo->tm_min    = this->getMinute();
-    timeinfo->tm_sec    = this->getSecond();
+/**
+ * @brief Checks if the meter flags daylight saving as active.
+ * 
+ * @return true if the daylight saving bit is set, false otherwise.
+ */
+bool GbtDateTime::isDaylightSavingActive() const
+{
+    if(m_clockStatus == CLOCKSTATUS_NOT_SPECIFIED)
+    {
+        return false;
+    }
 
-    time_t date = mktime(timeinfo);
+    return (m_clockStatus & CLOCKSTATUS_DAYLIGHT_SAVING) != 0;
+}
 
-    return date;
+/**
+ * @brief Checks if all date and time fields are specified and in range.
+ * 
+ * DLMS uses 0xff (0xffff for the year) for fields which are not specified.
+ * 
+ * @return true if the date and time can be converted to a Unix timestamp, false otherwise.
+ */
+bool GbtDateTime::isSpecified() const
+{
+    return m_year >= 1970 && m_year != 0xffff 
+        && m_month >= 1 && m_month <= 12 
+        && m_day >= 1 && m_day <= 31 
+        && m_hour < 24 && m_minute < 60 && m_second < 60;
+}
+
+/**
+ * @brief Converts the GbtDateTime object to a Unix timestamp.
+ * 
+ * The conversion does not depend on the time zone of the device. If the meter provides the deviation,
+ * the local time is converted to UTC, otherwise the date and time fields are taken as UTC.
+ * 
+ * @return The Unix timestamp representing the GbtDateTime object, 0 if the fields are not specified.
+ */
+time_t GbtDateTime::asUnixTimeStamp() const 
+{
+    if(!isSpecified())
+    {
+        return 0;
+    }
+
+    int64_t timeStamp = (int64_t) daysFromCivil(m_year, m_month, m_day) * 86400 + m_hour * 3600 + m_minute * 60 + m_second;
+
+    // DEVIATION_NOT_SPECIFIED is out of range as well
+    if(m_deviation >= -MAX_DEVIATION && m_deviation <= MAX_DEVIATION)
+    {
+        timeStamp += (int32_t) m_deviation * 60;
+    }
+
+    return (time_t) timeStamp;
 }
 
 /**
@@ -116,28 +181,38 @@ void GbtDateTime::clone(GbtDateTime const& source)
     m_hour = source.getHour();
     m_minute = source.getMinute();
     m_second = source.getSecond();
+    m_deviation = source.getDeviation();
+    m_clockStatus = source.getClockStatus();
 }
 
 /**
  * @brief Parses the data buffer and updates the GbtDateTime object with the parsed values.
  * 
- * @param data The data buffer containing the date and time information.
- * @param offset The offset in the data buffer from where to start parsing.
- * @return true if the parsing is successful, false otherwise.
+ * @param cursor The cursor pointing to the date time identifier, moved to the next element after parsing.
+ * @param structureIdent The structure identifier.
+ * @param arrayIdent The array identifier.
+ * @return true if the parsing is successful, false if the date time is truncated (the cursor is not moved).
  */
-bool GbtDateTime::parse(uint8_t const* data, size_t& offset, uint8_t const structureIdent, uint8_t const arrayIdent)
+bool GbtDateTime::parse(ByteCursor& cursor, uint8_t const structureIdent, uint8_t const arrayIdent)
 {
+    if(!cursor.has(DATETIME_ELEMENT_SIZE))
+    {
+        return false;
+    }
+
     m_structureIdent = structureIdent;
     m_arrayIdent = arrayIdent;
 
-    m_year = data[offset + 1] << 8 | data[offset + 2];
-    m_month = data[offset + 3];
-    m_day = data[offset + 4];
-    m_hour = data[offset + 6];
-    m_minute = data[offset + 7];
-    m_second = data[offset + 8];
+    m_year = cursor.peekUint16(1);
+    m_month = cursor.peekUint8(3);
+    m_day = cursor.peekUint8(4);
+    m_hour = cursor.peekUint8(6);
+    m_minute = cursor.peekUint8(7);
+    m_second = cursor.peekUint8(8);
+    m_deviation = (int16_t) cursor.peekUint16(10);
+    m_clockStatus = cursor.peekUint8(12);
 
-    offset += 13;
+    cursor.skip(DATETIME_ELEMENT_SIZE);
 
     return true;
 }
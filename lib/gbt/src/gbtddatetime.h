@@ -5,6 +5,9 @@
  * This class provides methods to parse GBT date and time data, clone the object, 
  * convert it to a string representation, and obtain the Unix timestamp.
  * 
+ * The Unix timestamp is calculated without the C library time functions (no time zone dependency),
+ * the DLMS deviation field is applied and the clock status flags are exposed.
+ * 
  * @version 1.0
  * @author MFA Informatik AG, Andreas Schneider
  */
@@ -13,30 +16,78 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include <time.h>
 
 #include "gbtvaluebase.h"
 
 class GbtDateTime : public GbtValueBase
 {
     public:
-        bool parse(uint8_t const* data, size_t& offset, uint8_t const structureIdent, uint8_t const arrayIdent) final;         
+        bool parse(ByteCursor& cursor, uint8_t const structureIdent, uint8_t const arrayIdent) final;         
         void asString(char* buffer, size_t const bufferSize) const final;                                                      
         GbtValueBase::GbtValueType getValueType() const final; 
         void clone(GbtDateTime const& source);                                  
 
-        time_t asUnixTimeStamp() const;                                         // converts the GbtDateTime object to a Unix timestamp
+        static int16_t const DEVIATION_NOT_SPECIFIED = -32768;                 // deviation 0x8000, local time is not related to UTC
+        static uint8_t const CLOCKSTATUS_NOT_SPECIFIED = 0xff;                  // clock status 0xff, no status available
+        static uint8_t const CLOCKSTATUS_INVALID_VALUE = 0x01;                  // clock status bit 0, invalid value
+        static uint8_t const CLOCKSTATUS_DOUBTFUL_VALUE = 0x02;                 // clock status bit 1, doubtful value
+        static uint8_t const CLOCKSTATUS_INVALID_STATUS = 0x08;                 // clock status bit 3, invalid clock status
+        static uint8_t const CLOCKSTATUS_DAYLIGHT_SAVING = 0x80;                // clock status bit 7, daylight saving active
+
+        time_t asUnixTimeStamp() const;                                         // converts the GbtDateTime object to a Unix timestamp (UTC)
         uint16_t getYear() const;                                               // returns the year
         uint8_t getMonth() const;                                               // returns the month
         uint8_t getDay() const;                                                 // returns the day
         uint8_t getHour() const;                                                // returns the hour
         uint8_t getMinute() const;                                              // returns the minute
         uint8_t getSecond() const;                                              // returns the second
+        int16_t getDeviation() const;                                           // returns the deviation of the local time to UTC in minutes
+        uint8_t getClockStatus() const;                                         // returns the raw clock status byte
+        bool isSpecified() const;                                               // checks if all date and time fields are specified and in range
+        bool isInvalidValue() const;                                            // checks if the meter flags the clock value as invalid
+        bool isDaylightSavingActive() const;                                    // checks if the meter flags daylight saving as active
+
+        /**
+         * @brief Number of days since 1970-01-01 of a date in the proleptic Gregorian calendar.
+         * 
+         * Branch-light days-from-civil conversion (H. Hinnant), usable in constant expressions.
+         */
+        static constexpr int32_t daysFromCivil(int32_t year, uint32_t month, uint32_t day)
+        {
+            return daysFromShiftedCivil(year - (month <= 2 ? 1 : 0), month, day);
+        }
 
     private:
-        uint16_t m_year;                                                          
-        uint8_t m_month;                  
-        uint8_t m_day;
-        uint8_t m_hour;
-        uint8_t m_minute;
-        uint8_t m_second;
+        static size_t const DATETIME_ELEMENT_SIZE = 13;                         // identifier and 12 bytes date time
+        static int16_t const MAX_DEVIATION = 840;                               // maximum deviation in minutes (+-14h)
+
+        static constexpr int32_t eraOfYear(int32_t year)                                                    // 400 year era of a march based year
+        {
+            return (year >= 0 ? year : year - 399) / 400;
+        }
+
+        static constexpr uint32_t dayOfYear(uint32_t month, uint32_t day)                                   // day of a march based year [0, 365]
+        {
+            return (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        }
+
+        static constexpr uint32_t dayOfEra(uint32_t yearOfEra, uint32_t dayOfYear)                          // day of the 400 year era [0, 146096]
+        {
+            return yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        }
+
+        static constexpr int32_t daysFromShiftedCivil(int32_t year, uint32_t month, uint32_t day)           // days since 1970-01-01 of a march based year
+        {
+            return eraOfYear(year) * 146097 + (int32_t) dayOfEra((uint32_t) (year - eraOfYear(year) * 400), dayOfYear(month, day)) - 719468;
+        }
+
+        uint16_t m_year = 0;                                                          
+        uint8_t m_month = 0;                  
+        uint8_t m_day = 0;
+        uint8_t m_hour = 0;
+        uint8_t m_minute = 0;
+        uint8_t m_second = 0;
+        int16_t m_deviation = DEVIATION_NOT_SPECIFIED;                          // minutes, UTC = local time + deviation (DLMS convention)
+        uint8_t m_clockStatus = CLOCKSTATUS_NOT_SPECIFIED;
 };
\ No newline at end of file
@@ -33,66 +33,89 @@ void GbtOctetString::asString(char* buffer, size_t const bufferSize) const
  * This function parses the GBT octet string from the given data and updates
  * the internal state of the object.
  * 
- * @param data The data containing the GBT octet string.
- * @param offset The offset in the data where the GBT octet string starts.
+ * @param cursor The cursor pointing to the identifier of the GBT octet string, moved to the next element after parsing.
  * @param structureIdent The structure identifier.
  * @param arrayIdent The array identifier.
- * @return True if the parsing is successful, false otherwise.
+ * @return True if the parsing is successful, false if the string is truncated or too long (the cursor is not moved).
  */
-bool GbtOctetString::parse(uint8_t const* data, size_t& offset, uint8_t const structureIdent, uint8_t const arrayIdent)
+bool GbtOctetString::parse(ByteCursor& cursor, uint8_t const structureIdent, uint8_t const arrayIdent)
 {
-    m_structureIdent = structureIdent;
-    m_arrayIdent = arrayIdent;
+    if(!cursor.has(2))
+    {
+        return false;
+    }
 
     // get the lenght of the string (single numbers as bytes)
-    size_t length = data[offset + 1];
+    size_t length = cursor.peekUint8(1);
 
-    // check for potential buffer overflow
-    if(length > MAX_GBTSTRINGSIZE)
+    if(!cursor.has(2 + length) || !assign(cursor.current() + 2, length, structureIdent, arrayIdent))
     {
         return false;
     }
 
-    // get the value of the last byte    
-    uint8_t lastValue = data[offset + 1 + length];
+    // move the cursor to the next value
+    cursor.skip(2 + length);
+
+    return true;
+}
+
+/**
+ * @brief Assigns the raw octets of the GBT octet string.
+ * 
+ * Octets ending with 0xff (e.g. OBIS codes) are formatted in the 1.2.3.4.5.255 way, all other
+ * octets are copied as characters.
+ * 
+ * @param data Pointer to the octets (without identifier and length byte).
+ * @param length The number of octets.
+ * @param structureIdent The structure identifier.
+ * @param arrayIdent The array identifier.
+ * @return True if the octets fit into the string buffer, false otherwise.
+ */
+bool GbtOctetString::assign(uint8_t const* data, size_t const length, uint8_t const structureIdent, uint8_t const arrayIdent)
+{
+    m_structureIdent = structureIdent;
+    m_arrayIdent = arrayIdent;
+
+    // check for potential buffer overflow (including the 0 termination)
+    if(length >= MAX_GBTSTRINGSIZE)
+    {
+        return false;
+    }
 
     // check if it is an string of octetes which can be formatet in an 1.2.3.4.5 way
-    if(lastValue == 0xff)
+    if(length > 0 && data[length - 1] == 0xff)
     {
-        // initialize the string
-        strcpy(_stringValue, "");
+        size_t stringPos = 0;
 
         for(size_t i=0; i < length; i++)
         {
-            char buf[10];
-
-            // convert the byte to a string
-            sprintf(buf, "%d", data[offset + 2 + i]);
+            // convert the byte to a string, add a dot if there are more bytes to come
+            int written = snprintf(_stringValue + stringPos, MAX_GBTSTRINGSIZE - stringPos, (i + 1 < length) ? "%d." : "%d", data[i]);
 
-            // append the string to the GBT octet string
-            strncat(_stringValue, buf, 10);
-
-            // add a dot if there are more bytes to come
-            if(i + 1 < length)
+            // formatted octets do not fit into the string buffer
+            if(written < 0 || stringPos + written >= MAX_GBTSTRINGSIZE)
             {
-                strcat(_stringValue, ".");
+                return false;
             }
+
+            stringPos += written;
         }
+
+        _stringLength = stringPos;
     }
     else 
     {
         // copy the bytes as characters into the string buffer
         for(size_t i=0; i < length; i++)
         {
-            _stringValue[i] = data[offset + 2 + i];
+            _stringValue[i] = data[i];
         }
 
         // append 0 byte to the string for termination
         _stringValue[length] = 0;
-    }
 
-    // move the pointer to the next value
-    offset = offset + 2 + length;
+        _stringLength = length;
+    }
 
     return true;
 }
@@ -111,13 +134,13 @@ char const* GbtOctetString::getStringValue() const
 /**
  * @brief Get the length of the octet string.
  * 
- * This function returns the length of the octet string, excluding the null terminator.
+ * This function returns the length of the octet string, excluding the null terminator (kept by assign).
  * 
  * @return The length of the octet string.
  */
 size_t GbtOctetString::getStringLength() const
 {
-    return strnlen(_stringValue, MAX_GBTSTRINGSIZE);
+    return _stringLength;
 }
 
 /**
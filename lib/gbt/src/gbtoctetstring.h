@@ -18,7 +18,8 @@
 class GbtOctetString : public GbtValueBase
 {
     public:
-        bool parse(uint8_t const* data, size_t& offset, uint8_t const structureIdent, uint8_t const arrayIdent) final;          
+        bool parse(ByteCursor& cursor, uint8_t const structureIdent, uint8_t const arrayIdent) final;          
+        bool assign(uint8_t const* data, size_t const length, uint8_t const structureIdent, uint8_t const arrayIdent);         // assigns the raw octets of the string
         void asString(char* buffer, size_t const bufferSize) const final;                                                       
         GbtValueBase::GbtValueType getValueType() const final; 
         bool compareOcteteString(char const* compareWith) const;                                                                // compares the GBT value with an octet string
@@ -29,5 +30,6 @@ class GbtOctetString : public GbtValueBase
         static const size_t MAX_GBTSTRINGSIZE = 32;
 
         char _stringValue[MAX_GBTSTRINGSIZE];
+        uint8_t _stringLength = 0;                                                                                              // length of the string value without termination
 
 };
\ No newline at end of file
@@ -0,0 +1,277 @@
+/**
+ * @file gbtparser.h
+ * @brief This file contains the declaration of the GbtParser class and the GbtVisitor callback interface.
+ *
+ * The GbtParser walks a joined GBT PDU in a single streaming pass and reports every element to a visitor
+ * (SAX style). The visitor is a template parameter, the callbacks are resolved at compile time and can be
+ * inlined. Nothing is allocated, a visitor only keeps what it really needs. Every callback returns a
+ * GbtVisitResult, GBTVISIT_STOP ends the pass immediately (e.g. once the wanted registers are found).
+ *
+ * GbtData is one visitor on top of this parser, it materialises all the values.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "bytecursor.h"
+#include "gbtddatetime.h"
+
+/**
+ * @brief Result of a visitor callback, controls if the parser continues or stops.
+ */
+enum class GbtVisitResult
+{
+    GBTVISIT_CONTINUE = 0,                                                                          // continue with the next element
+    GBTVISIT_STOP = 1                                                                               // stop parsing (early exit)
+};
+
+/**
+ * @brief Base class for GBT visitors with empty callbacks.
+ *
+ * Derive from this class and hide the callbacks of interest. There are no virtual methods, the parser
+ * calls the callbacks of the concrete visitor type given as template parameter.
+ */
+class GbtVisitor
+{
+    public:
+        GbtVisitResult onLongInvokeId(uint32_t const longInvokeId) { return GbtVisitResult::GBTVISIT_CONTINUE; }                                                   // long invoke and priority ID of the PDU
+        GbtVisitResult onDateTime(GbtDateTime const& dateTime) { return GbtVisitResult::GBTVISIT_CONTINUE; }                                                        // date and time of the PDU
+        GbtVisitResult onStructureBegin(uint8_t const elementCount) { return GbtVisitResult::GBTVISIT_CONTINUE; }                                                  // a structure with elementCount elements starts
+        GbtVisitResult onArrayBegin(uint8_t const elementCount) { return GbtVisitResult::GBTVISIT_CONTINUE; }                                                      // an array with elementCount elements starts
+        GbtVisitResult onUint8(uint8_t const value, uint8_t const structureIdent, uint8_t const arrayIdent) { return GbtVisitResult::GBTVISIT_CONTINUE; }           // 8 bit value
+        GbtVisitResult onUint16(uint16_t const value, uint8_t const structureIdent, uint8_t const arrayIdent) { return GbtVisitResult::GBTVISIT_CONTINUE; }         // 16 bit value
+        GbtVisitResult onUint32(uint32_t const value, uint8_t const structureIdent, uint8_t const arrayIdent) { return GbtVisitResult::GBTVISIT_CONTINUE; }         // 32 bit value
+        GbtVisitResult onOctetString(uint8_t const* data, uint8_t const length, uint8_t const structureIdent, uint8_t const arrayIdent) { return GbtVisitResult::GBTVISIT_CONTINUE; }  // raw octet string, data points into the PDU
+        GbtVisitResult onUnknown(uint8_t const identifier) { return GbtVisitResult::GBTVISIT_CONTINUE; }                                                           // unknown identifier, parser skips one byte
+};
+
+class GbtParser
+{
+    public:
+        static int const GBTPARSE_MALFORMED = -1;                                                   // the PDU is malformed (truncated element or nesting too deep)
+
+        template <typename TVisitor>
+        static int parse(uint8_t const* data, size_t const size, TVisitor& visitor);                // parse the PDU, returns the number of unknown identifiers or GBTPARSE_MALFORMED
+
+        static bool isObis(uint8_t const* data, uint8_t const length, uint8_t const* obis);         // compares a raw octet string with a 6 byte OBIS code
+
+    private:
+        static uint8_t const MAX_STRUCTURE_NESTED = 20;                                             // maximum number of nested structures (GBT protocol)
+        static uint8_t const MAX_ARRAY_NESTED = 20;                                                 // maximum number of nested arrays (GBT protocol)
+        static uint8_t const OBIS_LENGTH = 6;                                                       // length of an OBIS code in bytes
+};
+
+/**
+ * @brief Compares a raw octet string with an OBIS code.
+ *
+ * @param data Pointer to the octet string content.
+ * @param length Length of the octet string.
+ * @param obis Pointer to the 6 byte OBIS code to compare with.
+ * @return true if the octet string is the given OBIS code, false otherwise.
+ */
+inline bool GbtParser::isObis(uint8_t const* data, uint8_t const length, uint8_t const* obis)
+{
+    if(length != OBIS_LENGTH)
+    {
+        return false;
+    }
+
+    for(uint8_t i = 0; i < OBIS_LENGTH; i++)
+    {
+        if(data[i] != obis[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Parses the GBT PDU and reports every element to the visitor.
+ *
+ * The structure and array identifiers passed to the value callbacks are the remaining element counters of
+ * the current structure and array, the same values GbtValueBase::getStructureIdent() and getArrayIdent() return.
+ *
+ * The size of every element is checked once against the remaining size, the octets of the element are read
+ * unchecked afterwards. A truncated element ends the pass with GBTPARSE_MALFORMED (the visitor keeps the elements
+ * reported so far). The position is kept in locals instead of a ByteCursor, the cursor would be passed to the
+ * date time parse by reference and every fetch would reload it from memory.
+ *
+ * @param data Pointer to the joined GBT PDU.
+ * @param size Size of the PDU.
+ * @param visitor The visitor receiving the callbacks.
+ * @return The number of unknown identifiers (0 if the parsing is successful), or GBTPARSE_MALFORMED.
+ */
+template <typename TVisitor>
+int GbtParser::parse(uint8_t const* data, size_t const size, TVisitor& visitor)
+{
+    uint8_t const* element = data;
+    size_t remaining = data != nullptr ? size : 0;
+    int unknownIdentifierCount = 0;
+    uint8_t pduArrayIdent = 0;
+    uint8_t pduStructureIdent = 0;
+    uint8_t pduStructureCounter[MAX_STRUCTURE_NESTED];
+    uint8_t pduArrayCounter[MAX_ARRAY_NESTED];
+    GbtVisitResult result = GbtVisitResult::GBTVISIT_CONTINUE;
+
+    pduStructureCounter[0] = 0;
+    pduArrayCounter[0] = 0;
+
+    while(remaining > 0 && result == GbtVisitResult::GBTVISIT_CONTINUE)
+    {
+        uint8_t identifier = element[0];
+
+        // the octets of the element (elementSize) are checked against the remaining size once, then read unchecked
+        size_t elementSize;
+
+        // long invoke and priority
+        if(identifier == 0x0f && element == data)
+        {
+            elementSize = 5;
+
+            if(elementSize > remaining)
+            {
+                return GBTPARSE_MALFORMED;
+            }
+
+            result = visitor.onLongInvokeId(ByteCursor::loadUint32(element + 1));
+        }
+
+        // datetime
+        else if(identifier == 0x0c)
+        {
+            GbtDateTime dateTime;
+            ByteCursor cursor(element, remaining);
+
+            // parse the date and time through its own cursor over the remaining octets
+            if(!dateTime.parse(cursor, 0, 0))
+            {
+                return GBTPARSE_MALFORMED;
+            }
+
+            elementSize = cursor.position();
+
+            result = visitor.onDateTime(dateTime);
+        }
+
+        // structure and array, identifier and element count
+        else if(identifier == 0x02 || identifier == 0x01)
+        {
+            elementSize = 2;
+
+            if(elementSize > remaining)
+            {
+                return GBTPARSE_MALFORMED;
+            }
+
+            uint8_t elementCount = element[1];
+
+            if(identifier == 0x02)
+            {
+                // Current structure count decreased, remains on the same identifier
+                if(pduStructureCounter[pduStructureIdent] != 0)
+                {
+                    if(pduStructureIdent + 1 >= MAX_STRUCTURE_NESTED)
+                    {
+                        return GBTPARSE_MALFORMED;
+                    }
+
+                    pduStructureIdent++;
+                }
+
+                pduStructureCounter[pduStructureIdent] = elementCount;
+
+                // The array, if present, is decremented when a new structure is encountered.
+                if(pduArrayCounter[pduArrayIdent] > 0)
+                {
+                    pduArrayCounter[pduArrayIdent]--;
+                }
+
+                result = visitor.onStructureBegin(elementCount);
+            }
+            else
+            {
+                if(pduArrayCounter[pduArrayIdent] != 0)
+                {
+                    if(pduArrayIdent + 1 >= MAX_ARRAY_NESTED)
+                    {
+                        return GBTPARSE_MALFORMED;
+                    }
+
+                    pduArrayIdent++;
+                }
+
+                pduArrayCounter[pduArrayIdent] = elementCount;
+
+                result = visitor.onArrayBegin(elementCount);
+            }
+        }
+
+        // unit16, octet string, uint8 (integer and enum, e.g. scaler and unit), uint32
+        else if(identifier == 0x12 || identifier == 0x09 || identifier == 0x0f || identifier == 0x16 || identifier == 0x06)
+        {
+            uint8_t structureIdent = pduStructureCounter[pduStructureIdent];
+            uint8_t arrayIdent = pduArrayCounter[pduArrayIdent];
+
+            // identifier and length byte of the octet string, or identifier and value
+            elementSize = identifier == 0x12 ? 3 : (identifier == 0x06 ? 5 : 2);
+
+            // the length of the octet string is within the first two octets
+            if(identifier == 0x09 && elementSize <= remaining)
+            {
+                elementSize += element[1];
+            }
+
+            if(elementSize > remaining)
+            {
+                return GBTPARSE_MALFORMED;
+            }
+
+            if(identifier == 0x12)
+            {
+                result = visitor.onUint16(ByteCursor::loadUint16(element + 1), structureIdent, arrayIdent);
+            }
+            else if(identifier == 0x09)
+            {
+                result = visitor.onOctetString(element + 2, element[1], structureIdent, arrayIdent);
+            }
+            else if(identifier == 0x0f || identifier == 0x16)
+            {
+                result = visitor.onUint8(element[1], structureIdent, arrayIdent);
+            }
+            else
+            {
+                result = visitor.onUint32(ByteCursor::loadUint32(element + 1), structureIdent, arrayIdent);
+            }
+
+            // Current structure count decreased, remains on the same identifier
+            if(pduStructureCounter[pduStructureIdent] != 0)
+            {
+                pduStructureCounter[pduStructureIdent]--;
+            }
+        }
+
+        // default
+        else
+        {
+            result = visitor.onUnknown(identifier);
+
+            // move to the next identifier
+            elementSize = 1;
+
+            // count the number of unknown identifiers
+            unknownIdentifierCount++;
+        }
+
+        element += elementSize;
+        remaining -= elementSize;
+    }
+
+    return unknownIdentifierCount;
+}
@@ -25,25 +25,43 @@ void GbtUint16::asString(char* buffer, size_t const bufferSize) const
 /**
  * @brief Parses the GBT data and updates the GbtUint16 object.
  *
- * This function parses the GBT data starting from the specified offset and updates the GbtUint16 object with the parsed values.
+ * This function parses the GBT data at the cursor position and updates the GbtUint16 object with the parsed values.
  *
- * @param data The GBT data to parse.
- * @param offset The offset in the data to start parsing from.
+ * @param cursor The cursor pointing to the identifier of the value, moved to the next element after parsing.
  * @param structureIdent The structure identifier.
  * @param arrayIdent The array identifier.
- * @return True if the parsing is successful, false otherwise.
+ * @return True if the parsing is successful, false if the value is truncated (the cursor is not moved).
  */
-bool GbtUint16::parse(const uint8_t* data, size_t& offset, uint8_t const structureIdent, uint8_t const arrayIdent)
+bool GbtUint16::parse(ByteCursor& cursor, uint8_t const structureIdent, uint8_t const arrayIdent)
 {
-    _uint16Value = data[offset + 1] << 8 | data[offset + 2];
-    m_structureIdent = structureIdent;
-    m_arrayIdent = arrayIdent;
+    if(!cursor.has(3))
+    {
+        return false;
+    }
 
-    offset += 3;
+    assign(cursor.peekUint16(1), structureIdent, arrayIdent);
+
+    cursor.skip(3);
 
     return true;
 }
 
+/**
+ * @brief Assigns an already decoded value to the GbtUint16 object.
+ *
+ * This function is used by visitors of the GbtParser which decode the value themselves.
+ *
+ * @param value The value.
+ * @param structureIdent The structure identifier.
+ * @param arrayIdent The array identifier.
+ */
+void GbtUint16::assign(uint16_t const value, uint8_t const structureIdent, uint8_t const arrayIdent)
+{
+    _uint16Value = value;
+    m_structureIdent = structureIdent;
+    m_arrayIdent = arrayIdent;
+}
+
 /**
  * @brief Gets the value of the GbtUint16 object.
  *
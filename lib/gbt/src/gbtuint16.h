@@ -18,7 +18,8 @@
 class GbtUint16 : public GbtValueBase
 {
     public:
-        bool parse(const uint8_t* data, size_t& offset, uint8_t const structureIdent, uint8_t const arrayIdent) final;              
+        bool parse(ByteCursor& cursor, uint8_t const structureIdent, uint8_t const arrayIdent) final;              
+        void assign(uint16_t const value, uint8_t const structureIdent, uint8_t const arrayIdent);                                  // assigns an already decoded value
         void asString(char* buffer, size_t const bufferSize) const final;                                                           
         uint16_t getValue() const;                                                                                                  
         GbtValueBase::GbtValueType getValueType() const final; 
@@ -41,26 +41,44 @@ void GbtUint32::asString(char* buffer, size_t const bufferSize) const
 /**
  * @brief Parses the GbtUint32 object from data.
  * 
- * This function parses the GbtUint32 object from the provided data buffer at the specified offset. It also sets
- * the structure identifier and array identifier.
+ * This function parses the GbtUint32 object at the cursor position. It also sets the structure identifier and
+ * array identifier.
  * 
- * @param data The data buffer to parse from.
- * @param offset The offset in the data buffer to start parsing from.
+ * @param cursor The cursor pointing to the identifier of the value, moved to the next element after parsing.
  * @param structureIdent The structure identifier.
  * @param arrayIdent The array identifier.
- * @return True if the parsing is successful, false otherwise.
+ * @return True if the parsing is successful, false if the value is truncated (the cursor is not moved).
  */
-bool GbtUint32::parse(const uint8_t* data, size_t& offset, uint8_t const structureIdent, uint8_t const arrayIdent)
+bool GbtUint32::parse(ByteCursor& cursor, uint8_t const structureIdent, uint8_t const arrayIdent)
 {
-    _uint32Value = data[offset + 1] << 24 | data[offset + 2] << 16 | data[offset + 3] << 8 | data[offset + 4];
-    m_structureIdent = structureIdent;
-    m_arrayIdent = arrayIdent;
+    if(!cursor.has(5))
+    {
+        return false;
+    }
 
-    offset += 5;
+    assign(cursor.peekUint32(1), structureIdent, arrayIdent);
+
+    cursor.skip(5);
 
     return true;
 }
 
+/**
+ * @brief Assigns an already decoded value to the GbtUint32 object.
+ * 
+ * This function is used by visitors of the GbtParser which decode the value themselves.
+ * 
+ * @param value The value.
+ * @param structureIdent The structure identifier.
+ * @param arrayIdent The array identifier.
+ */
+void GbtUint32::assign(uint32_t const value, uint8_t const structureIdent, uint8_t const arrayIdent)
+{
+    _uint32Value = value;
+    m_structureIdent = structureIdent;
+    m_arrayIdent = arrayIdent;
+}
+
 /**
  * @brief Retrieves the value of the GbtUint32 object.
  * 
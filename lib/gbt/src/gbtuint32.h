@@ -17,7 +17,8 @@
 class GbtUint32 : public GbtValueBase
 {
     public:
-        bool parse(const uint8_t* data, size_t& offset, uint8_t const structureIdent, uint8_t const arrayIdent) final;          
+        bool parse(ByteCursor& cursor, uint8_t const structureIdent, uint8_t const arrayIdent) final;          
+        void assign(uint32_t const value, uint8_t const structureIdent, uint8_t const arrayIdent);                              // assigns an already decoded value
         void clone(GbtUint32 const& source);                                                                                    
         void asString(char* buffer, size_t const bufferSize) const final;                                                       
         uint32_t getValue() const;                                              
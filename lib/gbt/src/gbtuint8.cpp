@@ -27,25 +27,43 @@ void GbtUint8::asString(char* buffer, size_t const bufferSize) const
 /**
  * @brief Parses the GbtUint8 value from the given data.
  * 
- * This function parses the GbtUint8 value from the given data at the specified offset. It also updates the offset and sets the structure and array identifiers.
+ * This function parses the GbtUint8 value at the cursor position (identifier byte). It also moves the cursor and sets the structure and array identifiers.
  * 
- * @param data The data to parse the value from.
- * @param offset The offset in the data where the value starts. This will be updated to the next offset after parsing.
+ * @param cursor The cursor pointing to the identifier of the value, moved to the next element after parsing.
  * @param structureIdent The structure identifier.
  * @param arrayIdent The array identifier.
- * @return True if the parsing was successful, false otherwise.
+ * @return True if the parsing was successful, false if the value is truncated (the cursor is not moved).
  */
-bool GbtUint8::parse(const uint8_t* data, size_t& offset, uint8_t const structureIdent, uint8_t const arrayIdent)
+bool GbtUint8::parse(ByteCursor& cursor, uint8_t const structureIdent, uint8_t const arrayIdent)
 {
-    _uint8Value = data[offset + 1];
-    m_structureIdent = structureIdent;
-    m_arrayIdent = arrayIdent;
+    if(!cursor.has(2))
+    {
+        return false;
+    }
 
-    offset += 2;
+    assign(cursor.peekUint8(1), structureIdent, arrayIdent);
+
+    cursor.skip(2);
 
     return true;
 }
 
+/**
+ * @brief Assigns an already decoded value to the GbtUint8.
+ * 
+ * This function is used by visitors of the GbtParser which decode the value themselves.
+ * 
+ * @param value The value.
+ * @param structureIdent The structure identifier.
+ * @param arrayIdent The array identifier.
+ */
+void GbtUint8::assign(uint8_t const value, uint8_t const structureIdent, uint8_t const arrayIdent)
+{
+    _uint8Value = value;
+    m_structureIdent = structureIdent;
+    m_arrayIdent = arrayIdent;
+}
+
 /**
  * @brief Gets the value of the GbtUint8.
  * 
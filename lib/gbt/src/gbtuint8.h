@@ -19,7 +19,8 @@
 class GbtUint8 : public GbtValueBase
 {
     public:
-        bool parse(uint8_t const* data, size_t& offset, uint8_t const structureIdent, uint8_t const arrayIdent) final;         
+        bool parse(ByteCursor& cursor, uint8_t const structureIdent, uint8_t const arrayIdent) final;         
+        void assign(uint8_t const value, uint8_t const structureIdent, uint8_t const arrayIdent);                             // assigns an already decoded value
         void asString(char* buffer, size_t const bufferSize) const final;                                                      
         GbtValueBase::GbtValueType getValueType() const final; 
         uint8_t getValue() const;                                                                                              
@@ -11,6 +11,8 @@
 #include <stdbool.h>
 #include <stdio.h>
 
+#include "bytecursor.h"
+
 class GbtValueBase
 {
     public:
@@ -26,7 +28,7 @@ class GbtValueBase
         GbtValueBase() : m_structureIdent(0), m_arrayIdent(0) {};
         virtual ~GbtValueBase() = 0;
 
-        virtual bool parse(const uint8_t* data, size_t& offset, uint8_t const structureIdent, uint8_t const arrayIdent) = 0;        // parse the data and return the number of bytes parsed
+        virtual bool parse(ByteCursor& cursor, uint8_t const structureIdent, uint8_t const arrayIdent) = 0;                           // parse the element at the cursor, false if it is truncated
         virtual void asString(char* buffer, size_t const bufferSize) const = 0;                                                     // return the value as a string (debugging purposes)
         virtual GbtValueBase::GbtValueType getValueType() const = 0;                                                                // return the value type
 
@@ -0,0 +1,58 @@
+/**
+ * @file gbtvaluemask.cpp
+ * @brief Implementation of the GbtValueMask class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include <string.h>
+
+#include "gbtvaluemask.h"
+
+/**
+ * @brief Unmarks all values.
+ */
+void GbtValueMask::clear()
+{
+    memset(m_bits, 0, sizeof(m_bits));
+}
+
+/**
+ * @brief Marks the value at the index.
+ *
+ * @param index The index of the value within the GBT PDU.
+ */
+void GbtValueMask::set(uint8_t const index)
+{
+    m_bits[index / WORD_BITS] |= 1UL << (index % WORD_BITS);
+}
+
+/**
+ * @brief Checks if the value at the index is marked.
+ *
+ * @param index The index of the value within the GBT PDU.
+ * @return true if the value is marked, false otherwise.
+ */
+bool GbtValueMask::isSet(uint8_t const index) const
+{
+    return (m_bits[index / WORD_BITS] & (1UL << (index % WORD_BITS))) != 0;
+}
+
+/**
+ * @brief Checks if no value is marked.
+ *
+ * @return true if the mask is empty, false otherwise.
+ */
+bool GbtValueMask::isEmpty() const
+{
+    for(uint32_t const word : m_bits)
+    {
+        if(word != 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,29 @@
+/**
+ * @file gbtvaluemask.h
+ * @brief This file contains the declaration of the GbtValueMask class.
+ *
+ * The GbtValueMask class is a bit per value index of a GBT PDU. GbtDataBase::parse skips the marked values:
+ * they keep their index but are neither stored nor formatted (e.g. the registers a site does not send).
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+class GbtValueMask
+{
+    public:
+        void clear();                                                                               // unmarks all values
+        void set(uint8_t const index);                                                              // marks the value at the index
+        bool isSet(uint8_t const index) const;                                                      // checks if the value at the index is marked
+        bool isEmpty() const;                                                                       // checks if no value is marked
+
+    private:
+        static uint8_t const WORD_BITS = 32;                                                        // bits of one word of the mask
+
+        uint32_t m_bits[(UINT8_MAX + 1) / WORD_BITS] = {};                                          // one bit for each value index
+};
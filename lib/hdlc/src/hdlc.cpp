@@ -68,6 +68,22 @@ uint16_t Hdlc::swap_uint16(uint16_t val)
     return (val << 8) | (val >> 8 );
 }
 
+/**
+ * @brief Receives a chunk of characters (e.g. one bulk read of the serial port).
+ *
+ * The chunk may hold parts of several frames, each completed frame is passed to the frame handler.
+ *
+ * @param data The received characters.
+ * @param size The number of received characters.
+ */
+void Hdlc::bytesReceiver(uint8_t const* data, size_t const size)
+{
+    for(size_t i = 0; i < size; i++)
+    {
+        charReceiver(data[i]);
+    }
+}
+
 /**
  * @brief Receives a character and processes it as part of an HDLC frame.
  * 
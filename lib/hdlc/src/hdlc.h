@@ -31,6 +31,7 @@ class Hdlc
     public:
         Hdlc(frame_handler_type);                                                               // constructor with frame handler function
         void charReceiver(uint8_t data);                                                        // receive a character from the serial port
+        void bytesReceiver(uint8_t const* data, size_t const size);                             // receive a chunk of characters from the serial port
 
     private:
         static size_t const HDLC_MAX_FRAME_SIZE = 1024;                                         // maximum size of an HDLC frame
@@ -0,0 +1,126 @@
+/**
+ * @file hdlcheader.cpp
+ * @brief Implementation of the HdlcHeader class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include "hdlcheader.h"
+
+/**
+ * @brief Reads an HDLC address.
+ *
+ * Each address byte carries 7 bits of the address, the lowest bit marks the last byte of the address.
+ *
+ * @param data Pointer to the first address byte.
+ * @param size Number of bytes available.
+ * @param address The address (the 7 bit groups joined, e.g. 0xce 0xff is 0x33ff).
+ * @return The size of the address, 0 if the address is truncated or too long.
+ */
+size_t HdlcHeader::parseAddress(uint8_t const* data, size_t const size, uint32_t& address)
+{
+    address = 0;
+
+    for(size_t i = 0; i < size && i < MAX_ADDRESS_SIZE; i++)
+    {
+        address = (address << 7) | (data[i] >> 1);
+
+        if(data[i] & 0x01)
+        {
+            return i + 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Reads the header of the content of an HDLC frame.
+ *
+ * The content is the frame as passed to the frame handler of Hdlc, without the flags and the frame check sequence.
+ *
+ * @param data Pointer to the frame content.
+ * @param size Size of the frame content.
+ * @return true if the header is complete, false otherwise.
+ */
+bool HdlcHeader::parse(uint8_t const* data, size_t const size)
+{
+    m_size = 0;
+
+    if(size < FORMAT_SIZE)
+    {
+        return false;
+    }
+
+    size_t position = FORMAT_SIZE;
+
+    size_t destinationSize = parseAddress(data + position, size - position, m_destination);
+
+    if(destinationSize == 0)
+    {
+        return false;
+    }
+
+    position += destinationSize;
+
+    size_t sourceSize = parseAddress(data + position, size - position, m_source);
+
+    if(sourceSize == 0)
+    {
+        return false;
+    }
+
+    position += sourceSize;
+
+    if(size < position + CONTROL_SIZE + HCS_SIZE)
+    {
+        return false;
+    }
+
+    m_control = data[position];
+
+    m_size = position + CONTROL_SIZE + HCS_SIZE;
+
+    return true;
+}
+
+/**
+ * @brief Gets the destination address.
+ *
+ * @return The destination address.
+ */
+uint32_t HdlcHeader::getDestination() const
+{
+    return m_destination;
+}
+
+/**
+ * @brief Gets the source address.
+ *
+ * @return The source address.
+ */
+uint32_t HdlcHeader::getSource() const
+{
+    return m_source;
+}
+
+/**
+ * @brief Gets the control field.
+ *
+ * @return The control field.
+ */
+uint8_t HdlcHeader::getControl() const
+{
+    return m_control;
+}
+
+/**
+ * @brief Gets the size of the header.
+ *
+ * @return The size of the header, 0 if the last parse failed.
+ */
+size_t HdlcHeader::getSize() const
+{
+    return m_size;
+}
@@ -0,0 +1,39 @@
+/**
+ * @file hdlcheader.h
+ * @brief This file contains the declaration of the HdlcHeader class.
+ *
+ * Reads the header of the content of an HDLC frame (frame format, destination and source address, control
+ * field and header check sequence). The addresses have a variable length of 1 to 4 bytes, the header size
+ * follows from the addresses. The source address tells the meters on one bus apart.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+class HdlcHeader
+{
+    public:
+        bool parse(uint8_t const* data, size_t const size);                                     // reads the header of the frame content, false if it is truncated
+        uint32_t getDestination() const;                                                        // destination address
+        uint32_t getSource() const;                                                             // source address
+        uint8_t getControl() const;                                                             // control field
+        size_t getSize() const;                                                                 // size of the header, the information field starts here
+
+    private:
+        static size_t const FORMAT_SIZE = 2;                                                    // frame format field
+        static size_t const CONTROL_SIZE = 1;                                                   // control field
+        static size_t const HCS_SIZE = 2;                                                       // header check sequence
+        static uint8_t const MAX_ADDRESS_SIZE = 4;                                              // an address has 1, 2 or 4 bytes
+
+        uint32_t m_destination = 0;                                                             // destination address
+        uint32_t m_source = 0;                                                                  // source address
+        uint8_t m_control = 0;                                                                  // control field
+        size_t m_size = 0;                                                                      // size of the header
+
+        static size_t parseAddress(uint8_t const* data, size_t const size, uint32_t& address); // reads an address, returns its size or 0
+};
@@ -10,6 +10,8 @@
  * @author MFA Informatik AG, Andreas Schneider
  */
 
+#include <string.h>
+
 #include "gbtuint8.h"
 #include "gbtuint16.h"
 #include "gbtuint32.h"
@@ -21,14 +23,115 @@
  * @brief Resets the SmCayenne object and the CayenneLPP buffer.
  * 
  * This function resets the SmCayenne object by setting the LPP index to 0 and calling the reset() function of the CayenneLPP base class.
+ * The record boundaries are dropped.
  */
 void SmCayenne::reset()
 {
 	m_lppIndex = 0;	
+	m_recordCount = 0;
 
 	CayenneLPP::reset();
 }
 
+/**
+ * @brief Adds the unix time to the LPP message buffer (CayenneLPP record), its end is kept as record boundary.
+ *
+ * @param channel The channel number for the time stamp.
+ * @param unixtime The unix time stamp.
+ * @return The updated cursor position in the LPP message buffer, 0 on overflow.
+ */
+uint8_t SmCayenne::addUnixTime(uint8_t channel, uint32_t unixtime)
+{
+	if (CayenneLPP::addUnixTime(channel, unixtime) == 0)
+	{
+		return 0;
+	}
+
+	return closeRecord();
+}
+
+/**
+ * @brief Keeps the end of the record just added, the uplink is split into frames at these boundaries.
+ *
+ * If the table is full the last record is extended, the records stay together in one frame.
+ *
+ * @return The updated cursor position in the LPP message buffer.
+ */
+uint8_t SmCayenne::closeRecord()
+{
+	if (m_recordCount < SMLPP_MAX_RECORDS)
+	{
+		m_recordCount++;
+	}
+
+	m_recordEnds[m_recordCount - 1] = _cursor;
+
+	return _cursor;
+}
+
+/**
+ * @brief Gets the end offsets of the records in the LPP message buffer.
+ *
+ * @return The end offset of each record, ascending.
+ */
+uint16_t const* SmCayenne::getRecordEnds() const
+{
+	return m_recordEnds;
+}
+
+/**
+ * @brief Gets the number of records in the LPP message buffer.
+ *
+ * @return The number of records.
+ */
+uint8_t SmCayenne::getRecordCount() const
+{
+	return m_recordCount;
+}
+
+/**
+ * @brief Removes records from the LPP message buffer, the records behind them are moved up.
+ *
+ * The LPP index of the kept records is not changed, the server still knows which value each record is.
+ *
+ * @param first The first record which may be removed.
+ * @param count The number of records from first which may be removed (at most 32).
+ * @param keep The records which are kept, bit i for record first + i.
+ * @return The updated cursor position in the LPP message buffer, 0 if the records are not in the buffer.
+ */
+uint8_t SmCayenne::removeRecords(uint8_t first, uint8_t count, uint32_t keep)
+{
+	if (count > 32 || first + count > m_recordCount || m_recordCount >= SMLPP_MAX_RECORDS)
+	{
+		return 0;
+	}
+
+	uint16_t cursor = first > 0 ? m_recordEnds[first - 1] : 0;
+	uint8_t recordCount = first;
+
+	for (uint8_t i = first; i < m_recordCount; i++)
+	{
+		uint16_t start = i > 0 ? m_recordEnds[i - 1] : 0;
+		uint16_t size = m_recordEnds[i] - start;
+
+		if (i < first + count && (keep & (1UL << (i - first))) == 0)
+		{
+			continue;
+		}
+
+		memmove(_buffer + cursor, _buffer + start, size);
+
+		cursor += size;
+
+		m_recordEnds[recordCount++] = cursor;
+	}
+
+	m_recordCount = recordCount;
+	_cursor = cursor;
+
+	return _cursor;
+}
+
 /**
  * @brief Adds a battery voltage value to the LPP message buffer.
  * 
@@ -53,7 +156,7 @@ uint8_t SmCayenne::addBatteryVoltage(uint8_t channel, uint16_t value)
 	_buffer[_cursor++] = (value >> 8) & 0xFF;
 	_buffer[_cursor++] = (value) & 0xFF;
 
-	return _cursor;
+	return closeRecord();
 }
 
 /**
@@ -80,7 +183,7 @@ uint8_t SmCayenne::addSendFailures(uint8_t channel, uint16_t value)
 	_buffer[_cursor++] = (value >> 8) & 0xFF;
 	_buffer[_cursor++] = (value) & 0xFF;
 
-	return _cursor;
+	return closeRecord();
 }
 
 /**
@@ -109,7 +212,373 @@ uint8_t SmCayenne::addSendReadLoops(uint8_t channel, uint32_t value)
 	_buffer[_cursor++] = (value >> 8) & 0xFF;
 	_buffer[_cursor++] = (value) & 0xFF;
 
-	return _cursor;
+	return closeRecord();
+}
+
+/**
+ * @brief Adds the push schedule statistics to the LPP message buffer.
+ * 
+ * @param channel The channel number for the statistics.
+ * @param onTime The expected adapter on time of the next read cycle in ms.
+ * @param arrivalError The arrival of the last push minus the predicted arrival in ms (two's complement).
+ * @param savedOnTime The adapter on time saved in total in s.
+ * @return The updated cursor position in the LPP message buffer.
+ */
+uint8_t SmCayenne::addPushSchedule(uint8_t channel, uint32_t onTime, int32_t arrivalError, uint32_t savedOnTime)
+{
+	// check buffer overflow
+	if ((_cursor + SMLPP_PUSHSCHEDULE_SIZE + SMLPP_HEADER_SIZE) > _maxsize)
+	{
+		_error = LPP_ERROR_OVERFLOW;
+		
+		return 0;
+	}
+
+	uint32_t error = static_cast<uint32_t>(arrivalError);
+
+	_buffer[_cursor++] = channel;
+	_buffer[_cursor++] = SmCayenne::SMLPP_PUSHSCHEDULE;
+	_buffer[_cursor++] = SMLPP_PUSHSCHEDULE_SIZE;
+
+	_buffer[_cursor++] = (onTime >> 24) & 0xFF;
+	_buffer[_cursor++] = (onTime >> 16) & 0xFF;
+	_buffer[_cursor++] = (onTime >> 8) & 0xFF;
+	_buffer[_cursor++] = (onTime) & 0xFF;
+
+	_buffer[_cursor++] = (error >> 24) & 0xFF;
+	_buffer[_cursor++] = (error >> 16) & 0xFF;
+	_buffer[_cursor++] = (error >> 8) & 0xFF;
+	_buffer[_cursor++] = (error) & 0xFF;
+
+	_buffer[_cursor++] = (savedOnTime >> 24) & 0xFF;
+	_buffer[_cursor++] = (savedOnTime >> 16) & 0xFF;
+	_buffer[_cursor++] = (savedOnTime >> 8) & 0xFF;
+	_buffer[_cursor++] = (savedOnTime) & 0xFF;
+
+	return closeRecord();
+}
+
+/**
+ * @brief Adds the window of the aggregated pushes to the LPP message buffer.
+ * 
+ * @param channel The channel number of the meter.
+ * @param firstTime The unix time stamp of the first push of the window.
+ * @param lastTime The unix time stamp of the last push of the window.
+ * @param pushCount The number of pushes folded into the statistics.
+ * @return The updated cursor position in the LPP message buffer.
+ */
+uint8_t SmCayenne::addAggregationWindow(uint8_t channel, uint32_t firstTime, uint32_t lastTime, uint16_t pushCount)
+{
+	// check buffer overflow
+	if ((_cursor + SMLPP_AGGREGATIONWINDOW_SIZE + SMLPP_HEADER_SIZE) > _maxsize)
+	{
+		_error = LPP_ERROR_OVERFLOW;
+		
+		return 0;
+	}
+
+	_buffer[_cursor++] = channel;
+	_buffer[_cursor++] = SmCayenne::SMLPP_AGGREGATIONWINDOW;
+	_buffer[_cursor++] = SMLPP_AGGREGATIONWINDOW_SIZE;
+
+	appendUint32(firstTime);
+	appendUint32(lastTime);
+
+	_buffer[_cursor++] = (pushCount >> 8) & 0xFF;
+	_buffer[_cursor++] = (pushCount) & 0xFF;
+
+	return closeRecord();
+}
+
+/**
+ * @brief Adds the statistics of one register of the aggregation window to the LPP message buffer.
+ *
+ * Instantaneous values are sent as minimum, maximum and mean, energy counters as first and last value. The
+ * values are signed 32 bit mantissas (big endian) followed by the exponent (signed) and the DLMS unit.
+ *
+ * @param aggregate The statistics of the register.
+ * @return The updated cursor position in the LPP message buffer.
+ */
+uint8_t SmCayenne::addAggregate(SmAggregate const& aggregate)
+{
+	uint8_t size = aggregate.counter ? SMLPP_COUNTER_SIZE : SMLPP_AGGREGATE_SIZE;
+
+	// check buffer overflow
+	if ((_cursor + size + SMLPP_HEADER_SIZE) > _maxsize)
+	{
+		_error = LPP_ERROR_OVERFLOW;
+
+		return 0;
+	}
+
+	_buffer[_cursor++] = aggregate.channel;
+	_buffer[_cursor++] = m_lppIndex++;
+
+	if (aggregate.counter)
+	{
+		_buffer[_cursor++] = SMLPP_COUNTER_VALUETYPE;
+
+		appendUint32(static_cast<uint32_t>(static_cast<int32_t>(aggregate.first)));
+		appendUint32(static_cast<uint32_t>(static_cast<int32_t>(aggregate.last)));
+	}
+	else
+	{
+		_buffer[_cursor++] = SMLPP_AGGREGATE_VALUETYPE;
+
+		appendUint32(static_cast<uint32_t>(static_cast<int32_t>(aggregate.min)));
+		appendUint32(static_cast<uint32_t>(static_cast<int32_t>(aggregate.max)));
+		appendUint32(static_cast<uint32_t>(static_cast<int32_t>(aggregate.getMean())));
+	}
+
+	_buffer[_cursor++] = static_cast<uint8_t>(aggregate.exponent);
+	_buffer[_cursor++] = static_cast<uint8_t>(aggregate.unit);
+
+	return closeRecord();
+}
+
+/**
+ * @brief Adds the events which triggered the uplink to the LPP message buffer.
+ * 
+ * @param channel The channel number of the meter.
+ * @param events The events (SmEventRules::EVENT_* flags).
+ * @return The updated cursor position in the LPP message buffer.
+ */
+uint8_t SmCayenne::addEvents(uint8_t channel, uint8_t events)
+{
+	// check buffer overflow
+	if ((_cursor + SMLPP_UINT8_SIZE + SMLPP_HEADER_SIZE) > _maxsize)
+	{
+		_error = LPP_ERROR_OVERFLOW;
+		
+		return 0;
+	}
+
+	_buffer[_cursor++] = channel;
+	_buffer[_cursor++] = SmCayenne::SMLPP_EVENTS;
+	_buffer[_cursor++] = SMLPP_UINT8_SIZE;
+	_buffer[_cursor++] = events;
+
+	return closeRecord();
+}
+
+/**
+ * @brief Adds the interval of the derived values to the LPP message buffer.
+ * 
+ * @param channel The channel number of the meter.
+ * @param interval The time between the pushes the values are derived from in s.
+ * @return The updated cursor position in the LPP message buffer.
+ */
+uint8_t SmCayenne::addDerivedInterval(uint8_t channel, uint32_t interval)
+{
+	// check buffer overflow
+	if ((_cursor + SMLPP_UINT32_SIZE + SMLPP_HEADER_SIZE) > _maxsize)
+	{
+		_error = LPP_ERROR_OVERFLOW;
+		
+		return 0;
+	}
+
+	_buffer[_cursor++] = channel;
+	_buffer[_cursor++] = SmCayenne::SMLPP_DERIVEDINTERVAL;
+	_buffer[_cursor++] = SMLPP_UINT32_SIZE;
+
+	appendUint32(interval);
+
+	return closeRecord();
+}
+
+/**
+ * @brief Adds the derived values of one energy counter to the LPP message buffer.
+ *
+ * The consumption over the interval is followed by the average power, each as fixed-point value (signed 32 bit
+ * mantissa, signed exponent, DLMS unit).
+ *
+ * @param derivedValue The derived values of the counter.
+ * @return The updated cursor position in the LPP message buffer.
+ */
+uint8_t SmCayenne::addDerived(SmDerivedValue const& derivedValue)
+{
+	// check buffer overflow
+	if ((_cursor + SMLPP_DERIVED_SIZE + SMLPP_HEADER_SIZE) > _maxsize)
+	{
+		_error = LPP_ERROR_OVERFLOW;
+
+		return 0;
+	}
+
+	_buffer[_cursor++] = derivedValue.channel;
+	_buffer[_cursor++] = m_lppIndex++;
+	_buffer[_cursor++] = SMLPP_DERIVED_VALUETYPE;
+
+	appendScaled(derivedValue.delta);
+	appendScaled(derivedValue.averagePower);
+
+	return closeRecord();
+}
+
+/**
+ * @brief Adds the balance of the active energy import and export to the LPP message buffer.
+ * 
+ * @param channel The channel number of the meter.
+ * @param balance Import minus export over the interval.
+ * @return The updated cursor position in the LPP message buffer.
+ */
+uint8_t SmCayenne::addBalance(uint8_t channel, SmScaledValue const& balance)
+{
+	// check buffer overflow
+	if ((_cursor + SMLPP_SCALED_SIZE + SMLPP_HEADER_SIZE) > _maxsize)
+	{
+		_error = LPP_ERROR_OVERFLOW;
+		
+		return 0;
+	}
+
+	_buffer[_cursor++] = channel;
+	_buffer[_cursor++] = SmCayenne::SMLPP_BALANCE;
+	_buffer[_cursor++] = SMLPP_SCALED_SIZE;
+
+	appendScaled(balance);
+
+	return closeRecord();
+}
+
+/**
+ * @brief Adds the delta frame of the push to the LPP message buffer.
+ *
+ * The frame is encoded straight into the buffer behind the header (channel, identifier, size), the encoder
+ * waits for the acknowledgement of the frame afterwards.
+ *
+ * @param channel The channel number of the meter.
+ * @param encoder The delta encoder of the meter, holds the extracted push.
+ * @return The updated cursor position in the LPP message buffer.
+ */
+uint8_t SmCayenne::addDeltaFrame(uint8_t channel, SmDeltaEncoder& encoder)
+{
+	size_t size = 0;
+
+	// check buffer overflow, the frame size is known after the encoding
+	if ((_cursor + SMLPP_HEADER_SIZE) < _maxsize)
+	{
+		size = encoder.encode(_buffer + _cursor + SMLPP_HEADER_SIZE, min(_maxsize - _cursor - SMLPP_HEADER_SIZE, 255));
+	}
+
+	return addEncodedRecord(channel, SmCayenne::SMLPP_DELTAFRAME, size);
+}
+
+/**
+ * @brief Adds the dictionary of the push to the LPP message buffer.
+ *
+ * The dictionary is encoded straight into the buffer behind the header (channel, identifier, size).
+ *
+ * @param channel The channel number of the meter.
+ * @param session The dictionary session of the meter, holds the last push.
+ * @return The updated cursor position in the LPP message buffer.
+ */
+uint8_t SmCayenne::addDictionary(uint8_t channel, SmDictionarySession const& session)
+{
+	size_t size = 0;
+
+	// check buffer overflow, the dictionary size is known after the encoding
+	if ((_cursor + SMLPP_HEADER_SIZE) < _maxsize)
+	{
+		size = session.encodeDictionary(_buffer + _cursor + SMLPP_HEADER_SIZE, min(_maxsize - _cursor - SMLPP_HEADER_SIZE, 255));
+	}
+
+	return addEncodedRecord(channel, SmCayenne::SMLPP_DICTIONARY, size);
+}
+
+/**
+ * @brief Adds the values of the push in the order of the dictionary to the LPP message buffer.
+ *
+ * @param channel The channel number of the meter.
+ * @param session The dictionary session of the meter, holds the last push.
+ * @return The updated cursor position in the LPP message buffer.
+ */
+uint8_t SmCayenne::addDictionaryValues(uint8_t channel, SmDictionarySession const& session)
+{
+	size_t size = 0;
+
+	// check buffer overflow, the values size is known after the encoding
+	if ((_cursor + SMLPP_HEADER_SIZE) < _maxsize)
+	{
+		size = session.encodeValues(_buffer + _cursor + SMLPP_HEADER_SIZE, min(_maxsize - _cursor - SMLPP_HEADER_SIZE, 255));
+	}
+
+	return addEncodedRecord(channel, SmCayenne::SMLPP_DICTIONARYVALUES, size);
+}
+
+/**
+ * @brief Adds the fixed payload of the push to the LPP message buffer.
+ *
+ * The fields have no headers of their own, the record header is the only one (see SmFixedLayout).
+ *
+ * @param channel The channel number of the meter.
+ * @param encoder The fixed encoder, holds the last push.
+ * @return The updated cursor position in the LPP message buffer.
+ */
+uint8_t SmCayenne::addFixedLayout(uint8_t channel, SmFixedEncoder const& encoder)
+{
+	size_t size = 0;
+
+	// check buffer overflow, the payload size is known from the layout
+	if ((_cursor + SMLPP_HEADER_SIZE) < _maxsize)
+	{
+		size = encoder.encode(_buffer + _cursor + SMLPP_HEADER_SIZE, min(_maxsize - _cursor - SMLPP_HEADER_SIZE, 255));
+	}
+
+	return addEncodedRecord(channel, SmCayenne::SMLPP_FIXEDLAYOUT, size);
+}
+
+/**
+ * @brief Completes a record which was encoded behind its header, the caller checks the size.
+ *
+ * @param channel The channel number of the meter.
+ * @param identifier The identifier of the record.
+ * @param size The size of the encoded payload, 0 if it did not fit.
+ * @return The updated cursor position in the LPP message buffer, 0 on overflow.
+ */
+uint8_t SmCayenne::addEncodedRecord(uint8_t channel, uint8_t identifier, size_t size)
+{
+	if (size == 0)
+	{
+		_error = LPP_ERROR_OVERFLOW;
+
+		return 0;
+	}
+
+	_buffer[_cursor++] = channel;
+	_buffer[_cursor++] = identifier;
+	_buffer[_cursor++] = static_cast<uint8_t>(size);
+
+	_cursor += size;
+
+	return closeRecord();
+}
+
+/**
+ * @brief Appends a fixed-point value to the LPP message buffer, the caller checks the size.
+ *
+ * @param scaledValue The value (signed 32 bit mantissa, signed exponent, DLMS unit).
+ */
+void SmCayenne::appendScaled(SmScaledValue const& scaledValue)
+{
+	appendUint32(static_cast<uint32_t>(scaledValue.mantissa));
+
+	_buffer[_cursor++] = static_cast<uint8_t>(scaledValue.exponent);
+	_buffer[_cursor++] = static_cast<uint8_t>(scaledValue.unit);
+}
+
+/**
+ * @brief Appends a uint32_t to the LPP message buffer (big endian), the caller checks the size.
+ *
+ * @param value The value.
+ */
+void SmCayenne::appendUint32(uint32_t value)
+{
+	_buffer[_cursor++] = (value >> 24) & 0xFF;
+	_buffer[_cursor++] = (value >> 16) & 0xFF;
+	_buffer[_cursor++] = (value >> 8) & 0xFF;
+	_buffer[_cursor++] = (value) & 0xFF;
 }
 
 /**
@@ -142,7 +611,79 @@ uint8_t SmCayenne::addSmData(uint8_t channel, GbtValueBase const* gbtValue)
 
 	appendLppValue(gbtValue);
 
-	return _cursor;
+	return closeRecord();
+}
+
+/**
+ * @brief Adds the time stamp of a push (record sink of the push extraction).
+ * 
+ * @param channel The channel number for the time stamp.
+ * @param unixTime The unix time stamp.
+ * @return true if the time stamp was added, false otherwise.
+ */
+bool SmCayenne::addRecordTime(uint8_t const channel, uint32_t const unixTime)
+{
+	return addUnixTime(channel, unixTime) != 0;
+}
+
+/**
+ * @brief Adds a raw value of a push (record sink of the push extraction).
+ * 
+ * @param channel The channel number for the value.
+ * @param gbtValue The value.
+ * @return true if the value was added, false otherwise.
+ */
+bool SmCayenne::addRecordValue(uint8_t const channel, GbtValueBase const* gbtValue)
+{
+	return addSmData(channel, gbtValue) != 0;
+}
+
+/**
+ * @brief Adds a fixed-point value of a push (record sink of the push extraction).
+ * 
+ * @param channel The channel number for the value.
+ * @param scaledValue The fixed-point value.
+ * @return true if the value was added, false otherwise.
+ */
+bool SmCayenne::addRecordScaled(uint8_t const channel, SmScaledValue const& scaledValue)
+{
+	return addSmScaledData(channel, scaledValue) != 0;
+}
+
+/**
+ * @brief Adds a fixed-point value with unit to the LPP message buffer.
+ *
+ * The value is mantissa * 10^exponent in the unit, the mantissa is sent as signed 32 bit (big endian),
+ * followed by the exponent (signed) and the DLMS unit.
+ *
+ * @param channel The channel number for the value.
+ * @param scaledValue The fixed-point value.
+ * @return The updated cursor position in the LPP message buffer.
+ */
+uint8_t SmCayenne::addSmScaledData(uint8_t channel, SmScaledValue const& scaledValue)
+{
+	// check buffer overflow
+	if ((_cursor + SMLPP_SCALED_SIZE + SMLPP_HEADER_SIZE) > _maxsize)
+	{
+		_error = LPP_ERROR_OVERFLOW;
+
+		return 0;
+	}
+
+	uint32_t mantissa = static_cast<uint32_t>(scaledValue.mantissa);
+
+	_buffer[_cursor++] = channel;
+	_buffer[_cursor++] = m_lppIndex++;
+	_buffer[_cursor++] = SMLPP_SCALED_VALUETYPE;
+
+	_buffer[_cursor++] = (mantissa >> 24) & 0xFF;
+	_buffer[_cursor++] = (mantissa >> 16) & 0xFF;
+	_buffer[_cursor++] = (mantissa >> 8) & 0xFF;
+	_buffer[_cursor++] = (mantissa) & 0xFF;
+	_buffer[_cursor++] = static_cast<uint8_t>(scaledValue.exponent);
+	_buffer[_cursor++] = static_cast<uint8_t>(scaledValue.unit);
+
+	return closeRecord();
 }
 
 /**
@@ -276,7 +817,8 @@ uint8_t SmCayenne::getLppSize(GbtValueBase const* gbtValue) const
 		{
 			auto gbt = static_cast<GbtOctetString const*>(gbtValue);
 
-			return gbt->getStringLength();
+			// the octets and the terminating zero
+			return gbt->getStringLength() + 1;
 		}
 
 		default:
@@ -291,19 +833,29 @@ uint8_t SmCayenne::getLppSize(GbtValueBase const* gbtValue) const
 /**
  * @brief Decodes the received application settings from the LPP message buffer.
  * 
+ * A downlink may hold requests only (the dictionary request), they are not persisted and need no restart.
+ * 
  * @param data A pointer to the received data buffer.
  * @param size The size of the received data buffer.
  * @param config The AppConfig object to store the decoded application settings.
+ * @return true if the downlink holds settings which have to be persisted, false if it holds requests only.
  */
-void SmCayenne::smDecodeReceivedAppSettings(uint8_t const* data, size_t size, AppConfig& config)
+bool SmCayenne::smDecodeReceivedAppSettings(uint8_t const* data, size_t size, AppConfig& config)
 {
 	size_t index = 0;
+	bool persisted = false;
 
 	while (index < size)
 	{
 		uint8_t channel = data[index++];
 		uint8_t type = data[index++];
 
+		// every other channel (unknown ones included) is a setting
+		if (channel != SMDECODE_CHANNEL_DICTIONARYREQUEST)
+		{
+			persisted = true;
+		}
+
 		if (channel == SMDECODE_CHANNEL_MEASUREINTERVAL)
 		{
 			if (type == SMDECODE_UINT32)
@@ -320,6 +872,17 @@ void SmCayenne::smDecodeReceivedAppSettings(uint8_t const* data, size_t size, Ap
 			}
 		}
 
+		if (channel == SMDECODE_CHANNEL_METERPROFILE)
+		{
+			if (type == SMDECODE_UINT8)
+			{
+				config.meterProfile = getUint8FromByteArray(data, index);
+
+				// the serial settings of the profile apply (0 detects them again)
+				config.serialBaudRate = 0;
+			}
+		}
+
 		if (channel == SMDECODE_CHANNEL_SENDDATATYPE)
 		{
 			if (type == SMDECODE_UINT8)
@@ -336,6 +899,110 @@ void SmCayenne::smDecodeReceivedAppSettings(uint8_t const* data, size_t size, Ap
 			}
 		}
 
+		if (channel == SMDECODE_CHANNEL_PUSHSCHEDULE)
+		{
+			if (type == SMDECODE_BOOL)
+			{
+				config.pushSchedule = getBoolFromByteArray(data, index);
+			}
+		}
+
+		if (channel == SMDECODE_CHANNEL_AGGREGATIONWINDOW)
+		{
+			if (type == SMDECODE_UINT32)
+			{
+				config.aggregationWindow = getUint32FromByteArray(data, index);
+			}
+		}
+
+		if (channel == SMDECODE_CHANNEL_EVENTUPLINKS)
+		{
+			if (type == SMDECODE_BOOL)
+			{
+				config.eventUplinks = getBoolFromByteArray(data, index);
+			}
+		}
+
+		if (channel == SMDECODE_CHANNEL_EVENTPOWER)
+		{
+			if (type == SMDECODE_UINT32)
+			{
+				config.eventPowerThreshold = getUint32FromByteArray(data, index);
+			}
+		}
+
+		if (channel == SMDECODE_CHANNEL_EVENTENERGY)
+		{
+			if (type == SMDECODE_UINT32)
+			{
+				config.eventEnergyDelta = getUint32FromByteArray(data, index);
+			}
+		}
+
+		if (channel == SMDECODE_CHANNEL_EVENTSTATUS)
+		{
+			if (type == SMDECODE_BOOL)
+			{
+				config.eventStatusChange = getBoolFromByteArray(data, index);
+			}
+		}
+
+		if (channel == SMDECODE_CHANNEL_EVENTHEARTBEAT)
+		{
+			if (type == SMDECODE_UINT32)
+			{
+				config.eventHeartbeat = getUint32FromByteArray(data, index);
+			}
+		}
+
+		if (channel == SMDECODE_CHANNEL_DELTAKEYFRAME)
+		{
+			if (type == SMDECODE_UINT8)
+			{
+				config.deltaKeyframeInterval = getUint8FromByteArray(data, index);
+			}
+		}
+
+		if (channel == SMDECODE_CHANNEL_DICTIONARYREQUEST)
+		{
+			if (type == SMDECODE_BOOL)
+			{
+				config.dictionaryRequest = getBoolFromByteArray(data, index);
+			}
+		}
+
+		if (channel == SMDECODE_CHANNEL_PRIORITYTRUNCATION)
+		{
+			if (type == SMDECODE_BOOL)
+			{
+				config.priorityTruncation = getBoolFromByteArray(data, index);
+			}
+		}
+
+		// number of OBIS codes followed by the six fields of each code, 0 sends all registers, an invalid list ends the downlink
+		if (channel == SMDECODE_CHANNEL_REGISTERFILTER)
+		{
+			if (type == SMDECODE_BYTEARRAY)
+			{
+				uint8_t count = getUint8FromByteArray(data, index);
+
+				if (count > AppConfig::SM_MAX_REGISTERFILTER || index + count * sizeof(config.registerFilter[0]) > size)
+				{
+					return persisted;
+				}
+
+				for (uint8_t i = 0; i < count; i++)
+				{
+					for (uint8_t j = 0; j < sizeof(config.registerFilter[i]); j++)
+					{
+						config.registerFilter[i][j] = data[index++];
+					}
+				}
+
+				config.registerFilterCount = count;
+			}
+		}
+
 		if (channel == SMDECODE_CHANNEL_AUTHENTICATIONKEY)
 		{
 			if (type == SMDECODE_BYTEARRAY)
@@ -369,6 +1036,8 @@ void SmCayenne::smDecodeReceivedAppSettings(uint8_t const* data, size_t size, Ap
 			}
 		}
 	}
+
+	return persisted;
 }
 
 /**
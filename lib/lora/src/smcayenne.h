@@ -2,6 +2,7 @@
  * @file smcayenne.h
  * @brief This file contains the declaration of the SmCayenne class, which is a subclass of CayenneLPP.
  *        It provides additional functionality for encoding and decoding data in the Cayenne Low Power Payload (LPP) format.
+ *        It is the record sink of the push extraction (SmPushExtractor).
  * 
  * @version 1.0
  * @author MFA Informatik AG, Andreas Schneider
@@ -11,9 +12,16 @@
 #include <CayenneLPP.h>
 
 #include "gbtvaluebase.h"
+#include "smscaler.h"
+#include "smaggregator.h"
+#include "smderived.h"
+#include "smdeltaencoder.h"
+#include "smdictionarysession.h"
+#include "smfixedencoder.h"
+#include "smrecordsink.h"
 #include "appconfig.h"
 
-class SmCayenne : public CayenneLPP
+class SmCayenne : public CayenneLPP, public SmRecordSink
 {
     private:
         static uint8_t const SMDECODE_CHANNEL_MEASUREINTERVAL = 0x0a;                               // identifier for the measure interval 
@@ -23,6 +31,18 @@ class SmCayenne : public CayenneLPP
         static uint8_t const SMDECODE_CHANNEL_AESKEY = 0x0e;                                        // identifier for the AES key
         static uint8_t const SMDECODE_CHANNEL_AESIV = 0x0f;                                         // identifier for the AES IV 
         static uint8_t const SMDECODE_CHANNEL_CYCLETIMEOUT = 0x10;                                  // identifier for the cycle timeout
+        static uint8_t const SMDECODE_CHANNEL_METERPROFILE = 0x11;                                  // identifier for the meter profile
+        static uint8_t const SMDECODE_CHANNEL_PUSHSCHEDULE = 0x12;                                  // identifier for the push schedule flag
+        static uint8_t const SMDECODE_CHANNEL_AGGREGATIONWINDOW = 0x13;                             // identifier for the aggregation window
+        static uint8_t const SMDECODE_CHANNEL_EVENTUPLINKS = 0x14;                                  // identifier for the event uplinks flag
+        static uint8_t const SMDECODE_CHANNEL_EVENTPOWER = 0x15;                                    // identifier for the power threshold of the events
+        static uint8_t const SMDECODE_CHANNEL_EVENTENERGY = 0x16;                                   // identifier for the energy delta of the events
+        static uint8_t const SMDECODE_CHANNEL_EVENTSTATUS = 0x17;                                   // identifier for the status change flag of the events
+        static uint8_t const SMDECODE_CHANNEL_EVENTHEARTBEAT = 0x18;                                // identifier for the heartbeat of the events
+        static uint8_t const SMDECODE_CHANNEL_DELTAKEYFRAME = 0x19;                                 // identifier for the keyframe interval of the delta frames
+        static uint8_t const SMDECODE_CHANNEL_DICTIONARYREQUEST = 0x1a;                             // identifier for the request of the dictionary of the push
+        static uint8_t const SMDECODE_CHANNEL_PRIORITYTRUNCATION = 0x1b;                            // identifier for the priority truncation flag
+        static uint8_t const SMDECODE_CHANNEL_REGISTERFILTER = 0x1c;                                // identifier for the OBIS codes of the register filter
 
         static uint8_t const SMDECODE_UINT8 = 1;                                                    // identifier for the uint8_t data type when receiving application settings
         static uint8_t const SMDECODE_UINT32 = 4;                                                   // identifier for the uint32_t data type when receiving application settings
@@ -32,22 +52,48 @@ class SmCayenne : public CayenneLPP
         static uint8_t const SMLPP_BATTERYVOLTAGE = 200;                                            // identifier for the battery voltage
         static uint8_t const SMLPP_READLOOPS = 201;                                                 // identifier for the read loops
         static uint8_t const SMLPP_SENDFAILURES = 202;                                              // identifier for the send failures
+        static uint8_t const SMLPP_PUSHSCHEDULE = 203;                                              // identifier for the push schedule statistics
+        static uint8_t const SMLPP_AGGREGATIONWINDOW = 204;                                         // identifier for the aggregation window (first and last push, number of pushes)
+        static uint8_t const SMLPP_EVENTS = 205;                                                    // identifier for the events which triggered the uplink
+        static uint8_t const SMLPP_DERIVEDINTERVAL = 206;                                           // identifier for the interval of the derived values
+        static uint8_t const SMLPP_BALANCE = 207;                                                   // identifier for the balance of the active energy import and export
+        static uint8_t const SMLPP_DELTAFRAME = 208;                                                // identifier for a delta frame of the push (see SmDeltaEncoder)
+        static uint8_t const SMLPP_DICTIONARY = 209;                                                // identifier for the dictionary of the push (see SmDictionarySession)
+        static uint8_t const SMLPP_DICTIONARYVALUES = 210;                                          // identifier for the values of the push in the order of the dictionary
+        static uint8_t const SMLPP_FIXEDLAYOUT = 211;                                               // identifier for the fixed payload of the profile (see SmFixedLayout)
 
         static uint8_t const SMLPP_UNKNOWN_VALUETYPE = 0;                                           // identifier for the LPP unknown data type
         static uint8_t const SMLPP_UINT8_VALUETYPE = 1;                                             // identifier for the LPP uint8_t data type
         static uint8_t const SMLPP_UINT16_VALUETYPE = 2;                                            // identifier for the LPP uint16_t data type
         static uint8_t const SMLPP_UINT32_VALUETYPE = 3;                                            // identifier for the LPP uint32_t data type
         static uint8_t const SMLPP_OCTETESTRING_VALUETYPE = 4;                                      // identifier for the LPP octet string data type
+        static uint8_t const SMLPP_SCALED_VALUETYPE = 5;                                            // identifier for the LPP fixed-point data type (int32 mantissa, int8 exponent, uint8 unit)
+        static uint8_t const SMLPP_AGGREGATE_VALUETYPE = 6;                                         // identifier for the LPP aggregated instantaneous value (int32 min, max, mean, int8 exponent, uint8 unit)
+        static uint8_t const SMLPP_COUNTER_VALUETYPE = 7;                                           // identifier for the LPP aggregated energy counter (int32 first, last, int8 exponent, uint8 unit)
+        static uint8_t const SMLPP_DERIVED_VALUETYPE = 8;                                           // identifier for the LPP derived counter (consumption and average power, each int32, int8 exponent, uint8 unit)
 
         static uint8_t const SMLPP_UINT8_SIZE = 1;                                                  // size of the LPP uint8_t data type in bytes
         static uint8_t const SMLPP_UINT16_SIZE = 2;                                                 // size of the LPP uint16_t data type in bytes
         static uint8_t const SMLPP_UINT32_SIZE = 4;                                                 // size of the LPP uint32_t data type in bytes
+        static uint8_t const SMLPP_SCALED_SIZE = 6;                                                 // size of the LPP fixed-point data type in bytes
+        static uint8_t const SMLPP_PUSHSCHEDULE_SIZE = 12;                                          // size of the LPP push schedule statistics in bytes (uint32, int32, uint32)
+        static uint8_t const SMLPP_AGGREGATIONWINDOW_SIZE = 10;                                     // size of the LPP aggregation window in bytes (uint32, uint32, uint16)
+        static uint8_t const SMLPP_AGGREGATE_SIZE = 14;                                             // size of the LPP aggregated instantaneous value in bytes
+        static uint8_t const SMLPP_COUNTER_SIZE = 10;                                               // size of the LPP aggregated energy counter in bytes
+        static uint8_t const SMLPP_DERIVED_SIZE = 12;                                               // size of the LPP derived counter in bytes
         static uint8_t const SMLPP_HEADER_SIZE = 3;                                                 // size of the LPP header in bytes (channel, type, size)
+        static uint8_t const SMLPP_MAX_RECORDS = 64;                                                // record boundaries kept for the frame planning (smallest record 4 bytes)
 
         uint8_t m_lppIndex;                                                                         // index of the next LPP value to be added
+        uint16_t m_recordEnds[SMLPP_MAX_RECORDS];                                                   // end offset of each record in the buffer
+        uint8_t m_recordCount = 0;                                                                  // number of records in the buffer
+        uint8_t closeRecord();                                                                      // keeps the end of the record just added
         uint8_t getLppSize(GbtValueBase const* gbtValue) const;                                     // get the size of the LPP value
         uint8_t getLppValueType(GbtValueBase const* gbtValue) const;                                // get the type of the LPP value
         bool appendLppValue(GbtValueBase const* gbtValue);                                          // append the LPP value to the buffer
+        void appendUint32(uint32_t value);                                                          // append a uint32_t to the buffer (big endian)
+        void appendScaled(SmScaledValue const& scaledValue);                                        // append a fixed-point value to the buffer (int32 mantissa, int8 exponent, uint8 unit)
+        uint8_t addEncodedRecord(uint8_t channel, uint8_t identifier, size_t size);                 // complete a record encoded behind its header
         uint32_t getUint32FromByteArray(uint8_t const* data, size_t& offset);                       // get a uint32_t from the byte array, offset is incremented
         uint8_t getUint8FromByteArray(uint8_t const* data, size_t& offset);                         // get a uint8_t from the byte array, offset is incremented
         bool getBoolFromByteArray(uint8_t const* data, size_t& offset);                             // get a bool from the byte array, offset is incremented
@@ -55,9 +101,28 @@ class SmCayenne : public CayenneLPP
     public:
 	    SmCayenne(uint8_t size) : CayenneLPP(size) {}                                               // constructor exeted by the base class
         void reset();                                                                               // reset the LPP buffer
+        uint8_t addUnixTime(uint8_t channel, uint32_t unixtime);                                    // add the unix time to the LPP buffer (keeps the record boundary)
+        uint16_t const* getRecordEnds() const;                                                      // end offset of each record, the frames are split at these boundaries
+        uint8_t getRecordCount() const;                                                             // number of records in the buffer
+        uint8_t removeRecords(uint8_t first, uint8_t count, uint32_t keep);                         // remove records (e.g. deferred values), the others are moved up
         uint8_t addSmData(uint8_t channel, GbtValueBase const* gbtValue);                           // add a GbtValueBase to the LPP buffer
+        uint8_t addSmScaledData(uint8_t channel, SmScaledValue const& scaledValue);                 // add a fixed-point value with unit to the LPP buffer
         uint8_t addBatteryVoltage(uint8_t channel, uint16_t value);                                 // add the battery voltage to the LPP buffer
         uint8_t addSendFailures(uint8_t channel, uint16_t value);                                   // add the send failures to the LPP buffer
         uint8_t addSendReadLoops(uint8_t channel, uint32_t value);                                  // add the read loops to the LPP buffer
-        void smDecodeReceivedAppSettings(uint8_t const* data, size_t size, AppConfig& config);      // decode the received application settings
+        uint8_t addPushSchedule(uint8_t channel, uint32_t onTime, int32_t arrivalError, uint32_t savedOnTime); // add the push schedule statistics to the LPP buffer
+        uint8_t addAggregationWindow(uint8_t channel, uint32_t firstTime, uint32_t lastTime, uint16_t pushCount); // add the window of the aggregated pushes to the LPP buffer
+        uint8_t addAggregate(SmAggregate const& aggregate);                                         // add the statistics of one register to the LPP buffer
+        uint8_t addEvents(uint8_t channel, uint8_t events);                                         // add the events which triggered the uplink to the LPP buffer
+        uint8_t addDerivedInterval(uint8_t channel, uint32_t interval);                             // add the interval of the derived values to the LPP buffer
+        uint8_t addDerived(SmDerivedValue const& derivedValue);                                     // add the derived values of one counter to the LPP buffer
+        uint8_t addBalance(uint8_t channel, SmScaledValue const& balance);                          // add the balance of the active energy to the LPP buffer
+        uint8_t addDeltaFrame(uint8_t channel, SmDeltaEncoder& encoder);                            // add the delta frame of the push to the LPP buffer
+        uint8_t addDictionary(uint8_t channel, SmDictionarySession const& session);                 // add the dictionary of the push to the LPP buffer
+        uint8_t addDictionaryValues(uint8_t channel, SmDictionarySession const& session);           // add the values of the push in the order of the dictionary to the LPP buffer
+        uint8_t addFixedLayout(uint8_t channel, SmFixedEncoder const& encoder);                     // add the fixed payload of the push to the LPP buffer
+        bool smDecodeReceivedAppSettings(uint8_t const* data, size_t size, AppConfig& config);      // decode the received application settings, false if there are requests only
+        bool addRecordTime(uint8_t const channel, uint32_t const unixTime) override;                // SmRecordSink, adds the unix time
+        bool addRecordValue(uint8_t const channel, GbtValueBase const* gbtValue) override;          // SmRecordSink, adds the raw value (addSmData)
+        bool addRecordScaled(uint8_t const channel, SmScaledValue const& scaledValue) override;     // SmRecordSink, adds the fixed-point value (addSmScaledData)
 };
@@ -0,0 +1,316 @@
+/**
+ * @file smautodetect.cpp
+ * @brief Implementation of the SmAutoDetect class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include "hdlcheader.h"
+#include "mylog.h"
+#include "smautodetect.h"
+
+/**
+ * @brief Serial settings tried by the detection, the most common first (M-Bus customer interface, then P1).
+ */
+static constexpr SmSerialSetting SM_SERIAL_SETTINGS[] = {
+    { 2400,   SmSerialFormat::SMSERIAL_8E1 },
+    { 2400,   SmSerialFormat::SMSERIAL_8N1 },
+    { 9600,   SmSerialFormat::SMSERIAL_8E1 },
+    { 9600,   SmSerialFormat::SMSERIAL_8N1 },
+    { 115200, SmSerialFormat::SMSERIAL_8N1 }
+};
+
+static uint8_t const SM_SERIAL_SETTING_COUNT = sizeof(SM_SERIAL_SETTINGS) / sizeof(SmSerialSetting);
+
+/**
+ * @brief Restarts the detection with the first serial setting.
+ */
+void SmAutoDetect::start()
+{
+    m_settingIndex = 0;
+    m_validFrames = 0;
+    m_invalidFrames = 0;
+    m_fingerprinted = false;
+    m_profileId = NO_PROFILE;
+
+    m_pushLayout.reset();
+}
+
+/**
+ * @brief Continues with the next serial setting, the fingerprint of the current setting is dropped.
+ *
+ * @return true if there is a next setting, false if all settings were tried.
+ */
+bool SmAutoDetect::nextSetting()
+{
+    if(m_settingIndex + 1 >= SM_SERIAL_SETTING_COUNT)
+    {
+        return false;
+    }
+
+    m_settingIndex++;
+    m_validFrames = 0;
+    m_invalidFrames = 0;
+    m_fingerprinted = false;
+    m_profileId = NO_PROFILE;
+
+    return true;
+}
+
+/**
+ * @brief Gets the serial setting to try.
+ *
+ * @return The serial setting, the detected one once isDetected is true.
+ */
+SmSerialSetting const& SmAutoDetect::getSetting() const
+{
+    return SM_SERIAL_SETTINGS[m_settingIndex];
+}
+
+/**
+ * @brief Checks an hdlc frame and fingerprints the first valid one.
+ *
+ * @param data The content of the hdlc frame (starting with the frame format).
+ * @param size The size of the content.
+ * @param valid true if the frame check sequence is correct.
+ */
+void SmAutoDetect::hdlcFrameReceived(uint8_t const* data, size_t const size, bool const valid)
+{
+    HdlcHeader header;
+
+    if(!valid || !header.parse(data, size) || header.getSize() >= size)
+    {
+        if(m_invalidFrames < 0xff)
+        {
+            m_invalidFrames++;
+        }
+
+        return;
+    }
+
+    if(m_validFrames < 0xff)
+    {
+        m_validFrames++;
+    }
+
+    if(m_fingerprinted)
+    {
+        return;
+    }
+
+    uint8_t const* information = data + header.getSize();
+    size_t informationSize = size - header.getSize();
+
+    m_destination = header.getDestination();
+    m_source = header.getSource();
+    m_llcHeader = informationSize > LLC_HEADER_SIZE && information[0] == 0xe6 && information[1] == 0xe7;
+    m_apduTag = information[m_llcHeader ? LLC_HEADER_SIZE : 0];
+    m_fingerprinted = true;
+
+    MyLog::log("SMDETECT", "Frame with %lu baud: destination %lu, source %lu, LLC header %d, APDU tag 0x%02x", (unsigned long) getSetting().baudRate,
+        (unsigned long) m_destination, (unsigned long) m_source, m_llcHeader, m_apduTag);
+}
+
+/**
+ * @brief Selects the profile which matches the joined push best.
+ *
+ * @param gbtData The GbtData object to parse the push into.
+ * @param data The joined GBT frame.
+ * @param size The size of the frame.
+ * @return true if a profile matches, false otherwise.
+ */
+bool SmAutoDetect::pushReceived(GbtData& gbtData, uint8_t const* data, size_t const size)
+{
+    if(!m_fingerprinted)
+    {
+        return false;
+    }
+
+    // unknown identifiers are skipped as by the read cycle (see Wmb::parseFrame)
+    int result = gbtData.parse(data, size);
+
+    if(result == GbtParser::GBTPARSE_MALFORMED || result == GbtDataBase::GBTPARSE_VALUEDROPPED)
+    {
+        MyLog::log("SMDETECT", "Push rejected (%d)", result);
+
+        return false;
+    }
+
+    uint16_t bestScore = 0;
+
+    for(uint8_t i = 0; i < SmProfiles::getCount(); i++)
+    {
+        SmProfile const& profile = SmProfiles::getAt(i);
+
+        uint16_t score = scoreProfile(gbtData, profile);
+
+        MyLog::log("SMDETECT", "Profile %d (%s) scores %d", profile.id, profile.name, score);
+
+        if(score > bestScore)
+        {
+            bestScore = score;
+
+            m_profileId = profile.id;
+        }
+    }
+
+    return m_profileId != NO_PROFILE;
+}
+
+/**
+ * @brief Rates how well the push matches a profile.
+ *
+ * The push has to have the APDU form of the profile and at least one register of the profile. Each register
+ * found counts most, the fingerprint, the serial setting and the device name break ties.
+ *
+ * @param gbtData The parsed push.
+ * @param profile The profile.
+ * @return The score, 0 if the push does not match.
+ */
+uint16_t SmAutoDetect::scoreProfile(GbtData const& gbtData, SmProfile const& profile)
+{
+    if(m_apduTag != getApduTag(profile.apduForm))
+    {
+        return 0;
+    }
+
+    m_pushLayout.reset();
+
+    if(!m_pushLayout.update(gbtData, profile))
+    {
+        return 0;
+    }
+
+    uint16_t registers = 0;
+
+    for(uint8_t i = 0; i < m_pushLayout.getValueCount(); i++)
+    {
+        if(m_pushLayout.getRegister(i) != nullptr)
+        {
+            registers++;
+        }
+    }
+
+    if(registers == 0)
+    {
+        return 0;
+    }
+
+    uint16_t score = registers * 4;
+
+    if(profile.fingerprint.llcHeader == m_llcHeader)
+    {
+        score++;
+    }
+
+    if(profile.fingerprint.destination == 0 || profile.fingerprint.destination == m_destination)
+    {
+        score++;
+    }
+
+    if(profile.baudRate == getSetting().baudRate && profile.serialFormat == getSetting().serialFormat)
+    {
+        score++;
+    }
+
+    uint8_t deviceNameIndex = m_pushLayout.getDeviceNameIndex();
+
+    if(deviceNameIndex < m_pushLayout.getValueCount())
+    {
+        GbtValueBase const* deviceName = gbtData.getValue(m_pushLayout.getValueIndex(deviceNameIndex));
+
+        if(deviceName != nullptr && deviceName->getValueType() == GbtValueBase::GbtValueType::GBTVALUETYPE_OCTETESTRING)
+        {
+            score++;
+        }
+    }
+
+    return score;
+}
+
+/**
+ * @brief Gets the APDU tag of an APDU form.
+ *
+ * @param apduForm The APDU form of a profile.
+ * @return The first byte of the application data.
+ */
+uint8_t SmAutoDetect::getApduTag(SmApduForm const apduForm)
+{
+    switch(apduForm)
+    {
+        case SmApduForm::SMAPDU_GBT_PUSH:
+        default:
+            return APDU_GBT;
+    }
+}
+
+/**
+ * @brief Checks if the serial setting receives invalid frames only.
+ *
+ * @return true if MAX_INVALID_FRAMES invalid frames and no valid frame were received.
+ */
+bool SmAutoDetect::isRejected() const
+{
+    return m_validFrames == 0 && m_invalidFrames >= MAX_INVALID_FRAMES;
+}
+
+/**
+ * @brief Checks if the serial setting and the profile are detected.
+ *
+ * @return true if a push matched a profile.
+ */
+bool SmAutoDetect::isDetected() const
+{
+    return m_profileId != NO_PROFILE;
+}
+
+/**
+ * @brief Gets the detected profile.
+ *
+ * @return The profile identifier, NO_PROFILE if none is detected.
+ */
+uint8_t SmAutoDetect::getProfileId() const
+{
+    return m_profileId;
+}
+
+/**
+ * @brief Gets the hdlc destination address of the first valid frame.
+ *
+ * @return The destination address.
+ */
+uint32_t SmAutoDetect::getDestination() const
+{
+    return m_destination;
+}
+
+/**
+ * @brief Gets the hdlc source address of the first valid frame.
+ *
+ * @return The source address.
+ */
+uint32_t SmAutoDetect::getSource() const
+{
+    return m_source;
+}
+
+/**
+ * @brief Checks if the first valid frame has the LLC header.
+ *
+ * @return true if the information field starts with the LLC header.
+ */
+bool SmAutoDetect::hasLlcHeader() const
+{
+    return m_llcHeader;
+}
+
+/**
+ * @brief Gets the APDU tag of the first valid frame.
+ *
+ * @return The first byte of the information field behind the LLC header.
+ */
+uint8_t SmAutoDetect::getApduTag() const
+{
+    return m_apduTag;
+}
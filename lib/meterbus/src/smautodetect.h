@@ -0,0 +1,69 @@
+/**
+ * @file smautodetect.h
+ * @brief This file contains the declaration of the SmAutoDetect class and the SmSerialSetting.
+ *
+ * Detects the serial settings and the profile of an unknown meter. The common serial settings are tried one
+ * after the other, a setting is taken as soon as a valid HDLC frame (frame check sequence) is received and
+ * rejected after some invalid frames. The first valid frame is fingerprinted (addresses, LLC header, APDU
+ * tag), the first joined push selects the profile whose registers and fingerprint match best. The result is
+ * persisted by the caller, later boots start with it.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "gbtdata.h"
+#include "smprofile.h"
+#include "smpushlayout.h"
+
+/**
+ * @brief Baud rate, data bits, parity and stop bits of the serial interface.
+ */
+struct SmSerialSetting
+{
+    uint32_t baudRate;                                                                              // baud rate
+    SmSerialFormat serialFormat;                                                                    // data bits, parity and stop bits
+};
+
+class SmAutoDetect
+{
+    public:
+        static uint8_t const MAX_INVALID_FRAMES = 3;                                                // invalid frames without a valid frame reject a serial setting
+        static uint8_t const NO_PROFILE = 0;                                                        // no profile detected
+        static uint8_t const APDU_GBT = 0xe0;                                                       // APDU tag of a general block transfer
+
+        void start();                                                                               // restarts the detection with the first serial setting
+        bool nextSetting();                                                                         // continues with the next serial setting, false if all were tried
+        SmSerialSetting const& getSetting() const;                                                  // serial setting to try (or the detected one)
+        void hdlcFrameReceived(uint8_t const* data, size_t const size, bool const valid);           // checks and fingerprints an hdlc frame
+        bool pushReceived(GbtData& gbtData, uint8_t const* data, size_t const size);                // selects the profile of a joined push, false if none matches
+        bool isRejected() const;                                                                    // checks if the serial setting receives invalid frames only
+        bool isDetected() const;                                                                    // checks if the serial setting and the profile are detected
+        uint8_t getProfileId() const;                                                               // detected profile, NO_PROFILE if none
+        uint32_t getDestination() const;                                                            // hdlc destination address of the first valid frame
+        uint32_t getSource() const;                                                                 // hdlc source address of the first valid frame
+        bool hasLlcHeader() const;                                                                  // checks if the first valid frame has the LLC header
+        uint8_t getApduTag() const;                                                                 // first byte of the information field behind the LLC header
+
+    private:
+        static uint8_t const LLC_HEADER_SIZE = 3;                                                   // destination and source LSAP, quality
+
+        uint8_t m_settingIndex = 0;                                                                 // index of the serial setting in the table
+        uint8_t m_validFrames = 0;                                                                  // valid frames received with the serial setting
+        uint8_t m_invalidFrames = 0;                                                                // invalid frames received with the serial setting
+        bool m_fingerprinted = false;                                                               // flag indicating if a valid frame has been fingerprinted
+        bool m_llcHeader = false;                                                                   // the information field starts with the LLC header
+        uint32_t m_destination = 0;                                                                 // hdlc destination address
+        uint32_t m_source = 0;                                                                      // hdlc source address
+        uint8_t m_apduTag = 0;                                                                      // first byte of the application data
+        uint8_t m_profileId = NO_PROFILE;                                                           // detected profile
+        SmPushLayout m_pushLayout;                                                                  // layout of the push, resolved for each profile
+
+        uint16_t scoreProfile(GbtData const& gbtData, SmProfile const& profile);                    // rates how well the push matches the profile, 0 if not at all
+        static uint8_t getApduTag(SmApduForm const apduForm);                                       // APDU tag of the form
+};
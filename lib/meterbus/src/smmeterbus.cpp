@@ -0,0 +1,212 @@
+/**
+ * @file smmeterbus.cpp
+ * @brief Implementation of the SmMeterBus class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include "hdlcheader.h"
+#include "mylog.h"
+#include "smmeterbus.h"
+
+/**
+ * @brief Constructor for the SmMeterBus class.
+ *
+ * All slots report their joined GBT frames to the same handler, the handler forwards them to gbtFrameReceived
+ * which stores them in the slot the frame belongs to.
+ *
+ * @param gbtHandler The handler function for GBT frames.
+ */
+SmMeterBus::SmMeterBus(gbt_handler_type gbtHandler)
+{
+    for(uint8_t i = 0; i < MAX_METERS; i++)
+    {
+        m_slots[i].setFrameHandler(gbtHandler);
+    }
+}
+
+/**
+ * @brief Sets the number of meters in use.
+ *
+ * @param meterCount The number of meters, 1 to MAX_METERS.
+ * @return true if the number is valid, false otherwise (the number is not changed).
+ */
+bool SmMeterBus::setMeterCount(uint8_t const meterCount)
+{
+    if(meterCount == 0 || meterCount > MAX_METERS)
+    {
+        MyLog::log("SMBUS", "Invalid meter count %d, max is %d", meterCount, MAX_METERS);
+
+        return false;
+    }
+
+    m_meterCount = meterCount;
+
+    return true;
+}
+
+/**
+ * @brief Gets the number of meters in use.
+ *
+ * @return The number of meters.
+ */
+uint8_t SmMeterBus::getMeterCount() const
+{
+    return m_meterCount;
+}
+
+/**
+ * @brief Configures the slot of a meter.
+ *
+ * @param index The index of the meter.
+ * @param address The hdlc source address of the meter, SmMeterSlot::ADDRESS_ANY for any address.
+ * @param timeout The time in ms the read cycle waits for the push of the meter.
+ * @return true if the index is valid, false otherwise.
+ */
+bool SmMeterBus::configure(uint8_t const index, uint32_t const address, uint32_t const timeout)
+{
+    if(index >= MAX_METERS)
+    {
+        return false;
+    }
+
+    m_slots[index].configure(address, timeout);
+
+    return true;
+}
+
+/**
+ * @brief Resets all slots for a new read cycle.
+ */
+void SmMeterBus::reset()
+{
+    for(uint8_t i = 0; i < MAX_METERS; i++)
+    {
+        m_slots[i].reset();
+    }
+
+    m_activeSlot = NO_SLOT;
+}
+
+/**
+ * @brief Finds the slot of a source address.
+ *
+ * The slots in use are searched in order, a slot with ADDRESS_ANY takes the frames no other slot before it takes.
+ *
+ * @param source The hdlc source address.
+ * @return The index of the slot, NO_SLOT if no slot accepts the address.
+ */
+uint8_t SmMeterBus::findSlot(uint32_t const source) const
+{
+    for(uint8_t i = 0; i < m_meterCount; i++)
+    {
+        if(m_slots[i].accepts(source))
+        {
+            return i;
+        }
+    }
+
+    return NO_SLOT;
+}
+
+/**
+ * @brief Demultiplexes an hdlc frame into the slot of its meter.
+ *
+ * The header is read to find the source address, the information field is added to the GBT reassembly
+ * of the meter. An invalid frame drops the GBT blocks the meter has sent so far.
+ *
+ * @param data Pointer to the frame content (see Hdlc frame handler).
+ * @param size Size of the frame content.
+ * @param valid Flag indicating whether the frame check sequence is valid.
+ * @return true if the frame was added as GBT block, false otherwise.
+ */
+bool SmMeterBus::hdlcFrameReceived(uint8_t const* data, size_t const size, bool const valid)
+{
+    HdlcHeader header;
+
+    if(!header.parse(data, size))
+    {
+        MyLog::log("SMBUS", "Frame with %d bytes has no complete header, frame dropped", size);
+
+        return false;
+    }
+
+    uint8_t slot = findSlot(header.getSource());
+
+    if(slot == NO_SLOT)
+    {
+        MyLog::log("SMBUS", "Frame of unknown source address %lu, frame dropped", (unsigned long) header.getSource());
+
+        return false;
+    }
+
+    if(!valid)
+    {
+        MyLog::log("SMBUS", "Invalid frame of meter %d, reset its receive buffer", slot);
+
+        m_slots[slot].resetBlocks();
+
+        return false;
+    }
+
+    // the joined GBT frame is reported synchronously while the block is added
+    m_activeSlot = slot;
+
+    bool added = m_slots[slot].hdlcDataReceived(data + header.getSize(), size - header.getSize());
+
+    m_activeSlot = NO_SLOT;
+
+    return added;
+}
+
+/**
+ * @brief Stores a joined GBT frame in the slot of the hdlc frame in process.
+ *
+ * @param data Pointer to the GBT frame.
+ * @param size Size of the GBT frame.
+ * @return true if the frame is stored, false otherwise.
+ */
+bool SmMeterBus::gbtFrameReceived(uint8_t const* data, size_t const size)
+{
+    if(m_activeSlot == NO_SLOT)
+    {
+        MyLog::log("SMBUS", "GBT frame outside of an hdlc frame, frame dropped");
+
+        return false;
+    }
+
+    MyLog::log("SMBUS", "GBT frame of meter %d received", m_activeSlot);
+
+    return m_slots[m_activeSlot].storeFrame(data, size);
+}
+
+/**
+ * @brief Checks if the read cycle is complete.
+ *
+ * @param elapsed Time in ms since the start of the read cycle.
+ * @return true if each meter in use has pushed or its timeout has expired, false otherwise.
+ */
+bool SmMeterBus::isCycleComplete(uint32_t const elapsed) const
+{
+    for(uint8_t i = 0; i < m_meterCount; i++)
+    {
+        if(!m_slots[i].isDone(elapsed))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Gets the slot of a meter.
+ *
+ * @param index The index of the meter, less than MAX_METERS.
+ * @return The slot of the meter.
+ */
+SmMeterSlot const& SmMeterBus::getSlot(uint8_t const index) const
+{
+    return m_slots[index < MAX_METERS ? index : 0];
+}
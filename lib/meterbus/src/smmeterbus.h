@@ -0,0 +1,45 @@
+/**
+ * @file smmeterbus.h
+ * @brief This file contains the declaration of the SmMeterBus class.
+ *
+ * Several meters can push on the bus of one adapter. The HDLC frames are decoded once (Hdlc) and then
+ * demultiplexed by their source address into the slot of the meter, each slot has its own GBT reassembly.
+ * The number of slots is fixed at build time (SM_MAX_METERS), the number of meters in use is configured.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "appconfig.h"
+#include "gbt.h"
+#include "smmeterslot.h"
+
+class SmMeterBus
+{
+    public:
+        static uint8_t const MAX_METERS = SM_MAX_METERS;                                            // slots reserved for the meters
+
+        SmMeterBus(gbt_handler_type gbtHandler);                                                    // constructor with the handler of the joined GBT frames
+        bool setMeterCount(uint8_t const meterCount);                                               // sets the number of meters in use, false if out of range
+        uint8_t getMeterCount() const;                                                              // number of meters in use
+        bool configure(uint8_t const index, uint32_t const address, uint32_t const timeout);        // configures the slot of a meter
+        void reset();                                                                               // resets all slots, required for a new read cycle
+        bool hdlcFrameReceived(uint8_t const* data, size_t const size, bool const valid);           // demultiplexes an hdlc frame into the slot of its meter
+        bool gbtFrameReceived(uint8_t const* data, size_t const size);                              // stores a joined GBT frame in the slot it belongs to
+        bool isCycleComplete(uint32_t const elapsed) const;                                         // checks if all meters have pushed or timed out
+        SmMeterSlot const& getSlot(uint8_t const index) const;                                      // slot of a meter
+
+    private:
+        static uint8_t const NO_SLOT = 0xff;                                                        // no slot found or active
+
+        uint8_t m_meterCount = 1;                                                                   // number of meters in use
+        uint8_t m_activeSlot = NO_SLOT;                                                             // slot of the hdlc frame in process
+        SmMeterSlot m_slots[MAX_METERS];                                                            // receive state of each meter
+
+        uint8_t findSlot(uint32_t const source) const;                                              // finds the slot of a source address
+};
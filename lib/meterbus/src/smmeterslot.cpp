@@ -0,0 +1,175 @@
+/**
+ * @file smmeterslot.cpp
+ * @brief Implementation of the SmMeterSlot class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include <string.h>
+
+#include "mylog.h"
+#include "smmeterslot.h"
+
+/**
+ * @brief Constructor for the SmMeterSlot class.
+ *
+ * The slot accepts any source address until it is configured, the joined GBT frames are dropped until a
+ * frame handler is set.
+ */
+SmMeterSlot::SmMeterSlot() : m_gbt(nullptr), m_dlms(m_gbt)
+{
+}
+
+/**
+ * @brief Sets the handler for the joined GBT frames of the meter.
+ *
+ * @param gbtHandler The handler function for GBT frames.
+ */
+void SmMeterSlot::setFrameHandler(gbt_handler_type gbtHandler)
+{
+    m_gbt.setFrameHandler(gbtHandler);
+}
+
+/**
+ * @brief Configures the slot for a meter.
+ *
+ * @param address The hdlc source address of the meter, ADDRESS_ANY for any address.
+ * @param timeout The time in ms the read cycle waits for the push of the meter.
+ */
+void SmMeterSlot::configure(uint32_t const address, uint32_t const timeout)
+{
+    m_address = address;
+    m_timeout = timeout;
+}
+
+/**
+ * @brief Resets the slot for a new read cycle.
+ */
+void SmMeterSlot::reset()
+{
+    m_dlms.reset();
+
+    m_frameReceived = false;
+    m_frameSize = 0;
+    m_frameCount = 0;
+}
+
+/**
+ * @brief Drops the GBT blocks received so far, a frame already received is kept.
+ */
+void SmMeterSlot::resetBlocks()
+{
+    m_dlms.reset();
+}
+
+/**
+ * @brief Checks if a frame of the source address belongs to the slot.
+ *
+ * @param source The hdlc source address of the frame.
+ * @return true if the slot accepts the frame, false otherwise.
+ */
+bool SmMeterSlot::accepts(uint32_t const source) const
+{
+    return m_address == ADDRESS_ANY || m_address == source;
+}
+
+/**
+ * @brief Adds the information field of an hdlc frame to the GBT reassembly of the meter.
+ *
+ * @param data Pointer to the information field.
+ * @param size Size of the information field.
+ * @return true if the data was added as GBT block, false otherwise.
+ */
+bool SmMeterSlot::hdlcDataReceived(uint8_t const* data, size_t const size)
+{
+    return m_dlms.hdlcDataReceived(data, size, nullptr);
+}
+
+/**
+ * @brief Stores the joined GBT frame of the meter.
+ *
+ * @param data Pointer to the GBT frame.
+ * @param size Size of the GBT frame.
+ * @return true if the frame is stored, false if it is larger than MAX_FRAMESIZE.
+ */
+bool SmMeterSlot::storeFrame(uint8_t const* data, size_t const size)
+{
+    if(size > MAX_FRAMESIZE)
+    {
+        MyLog::log("SMSLOT", "GBT frame received with %d bytes, max size is %d, frame dropped", size, MAX_FRAMESIZE);
+
+        return false;
+    }
+
+    memcpy(m_frame, data, size);
+
+    m_frameSize = size;
+    m_frameReceived = true;
+    m_frameCount++;
+
+    return true;
+}
+
+/**
+ * @brief Checks if the meter has pushed in this read cycle.
+ *
+ * @return true if a GBT frame has been stored since the last reset.
+ */
+bool SmMeterSlot::isFrameReceived() const
+{
+    return m_frameReceived;
+}
+
+/**
+ * @brief Gets the number of frames stored in this read cycle.
+ *
+ * The frame is replaced by each push, a changed count tells that getFrame holds a new push.
+ *
+ * @return The number of frames since the last reset (wraps around).
+ */
+uint16_t SmMeterSlot::getFrameCount() const
+{
+    return m_frameCount;
+}
+
+/**
+ * @brief Checks if the read cycle has to wait for the meter any longer.
+ *
+ * @param elapsed Time in ms since the start of the read cycle.
+ * @return true if the meter has pushed or its timeout has expired, false otherwise.
+ */
+bool SmMeterSlot::isDone(uint32_t const elapsed) const
+{
+    return m_frameReceived || elapsed > m_timeout;
+}
+
+/**
+ * @brief Gets the last joined GBT frame.
+ *
+ * @return Pointer to the frame, valid for getFrameSize bytes.
+ */
+uint8_t const* SmMeterSlot::getFrame() const
+{
+    return m_frame;
+}
+
+/**
+ * @brief Gets the size of the last joined GBT frame.
+ *
+ * @return The size of the frame, 0 if no frame has been received.
+ */
+size_t SmMeterSlot::getFrameSize() const
+{
+    return m_frameSize;
+}
+
+/**
+ * @brief Gets the hdlc source address of the meter.
+ *
+ * @return The address, ADDRESS_ANY if the slot accepts any address.
+ */
+uint32_t SmMeterSlot::getAddress() const
+{
+    return m_address;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file smmeterslot.h
+ * @brief This file contains the declaration of the SmMeterSlot class.
+ *
+ * A slot holds the receive state of one meter on the bus: the GBT reassembly of its HDLC frames, the last
+ * joined GBT frame and the timeout of the meter within a read cycle. The memory of a slot is fixed, there is
+ * one slot for each meter the adapter is built for (see SmMeterBus).
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "gbt.h"
+#include "dlms.h"
+
+class SmMeterSlot
+{
+    public:
+        static uint32_t const ADDRESS_ANY = 0;                                                      // the slot accepts frames of any source address
+        static size_t const MAX_FRAMESIZE = 1024;                                                   // maximum size of a joined GBT frame
+
+        SmMeterSlot();
+        void setFrameHandler(gbt_handler_type gbtHandler);                                          // sets the handler called with the joined GBT frames
+        void configure(uint32_t const address, uint32_t const timeout);                             // sets the hdlc source address and the timeout in ms
+        void reset();                                                                               // drops the reassembly and the frame, required for a new read cycle
+        void resetBlocks();                                                                         // drops the GBT blocks received so far
+        bool accepts(uint32_t const source) const;                                                  // checks if a frame of the source address belongs to the slot
+        bool hdlcDataReceived(uint8_t const* data, size_t const size);                              // adds the information field of an hdlc frame
+        bool storeFrame(uint8_t const* data, size_t const size);                                    // stores the joined GBT frame of the meter
+        bool isFrameReceived() const;                                                               // checks if the meter has pushed in this read cycle
+        uint16_t getFrameCount() const;                                                             // number of frames stored in this read cycle, changes with each push
+        bool isDone(uint32_t const elapsed) const;                                                  // checks if the meter has pushed or its timeout has expired
+        uint8_t const* getFrame() const;                                                            // last joined GBT frame
+        size_t getFrameSize() const;                                                                // size of the last joined GBT frame
+        uint32_t getAddress() const;                                                                // hdlc source address of the meter
+
+    private:
+        Gbt m_gbt;                                                                                  // gbt reassembly of the meter
+        Dlms m_dlms;                                                                                // dlms handler of the meter (forwards to m_gbt)
+        uint32_t m_address = ADDRESS_ANY;                                                           // hdlc source address of the meter
+        uint32_t m_timeout = 0;                                                                     // timeout of the meter within a read cycle in ms
+        bool m_frameReceived = false;                                                               // flag indicating if the meter has pushed in this read cycle
+        uint16_t m_frameCount = 0;                                                                  // number of frames stored in this read cycle
+        size_t m_frameSize = 0;                                                                     // size of the last joined GBT frame
+        uint8_t m_frame[MAX_FRAMESIZE];                                                             // last joined GBT frame
+};
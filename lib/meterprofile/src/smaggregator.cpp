@@ -0,0 +1,263 @@
+/**
+ * @file smaggregator.cpp
+ * @brief Implementation of the SmAggregator class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include "mylog.h"
+#include "smaggregator.h"
+
+/**
+ * @brief Gets the mean of the values of the window.
+ *
+ * @return The mean, rounded half away from zero, 0 if there is no value.
+ */
+int64_t SmAggregate::getMean() const
+{
+    if(count == 0)
+    {
+        return 0;
+    }
+
+    int64_t const half = count / 2;
+
+    return sum >= 0 ? (sum + half) / count : (sum - half) / count;
+}
+
+/**
+ * @brief Starts a new window, the statistics of the previous window are dropped.
+ */
+void SmAggregator::reset()
+{
+    m_count = 0;
+    m_recordIndex = 0;
+    m_pushCount = 0;
+    m_firstTime = 0;
+    m_lastTime = 0;
+}
+
+/**
+ * @brief Starts the next push of the window (the time stamp is the first record of each push).
+ *
+ * @param channel The channel of the meter (unused).
+ * @param unixTime The time stamp of the push.
+ * @return true, the time stamp is always taken.
+ */
+bool SmAggregator::addRecordTime(uint8_t const channel, uint32_t const unixTime)
+{
+    if(m_pushCount == 0)
+    {
+        m_firstTime = unixTime;
+    }
+
+    m_lastTime = unixTime;
+
+    if(m_pushCount < UINT16_MAX)
+    {
+        m_pushCount++;
+    }
+
+    m_recordIndex = 0;
+
+    return true;
+}
+
+/**
+ * @brief Folds a raw value, used if the push is not extracted scaled.
+ *
+ * @param channel The channel of the register.
+ * @param gbtValue The raw value.
+ * @return true if the value is folded or not numeric (skipped), false if there are too many registers.
+ */
+bool SmAggregator::addRecordValue(uint8_t const channel, GbtValueBase const* gbtValue)
+{
+    int64_t raw;
+
+    // octet strings (e.g. the device name) are not aggregated
+    if(!SmScaler::getRawValue(gbtValue, raw))
+    {
+        return true;
+    }
+
+    return fold(channel, raw, 0, SmUnit::SMUNIT_NONE);
+}
+
+/**
+ * @brief Folds a fixed-point value.
+ *
+ * @param channel The channel of the register.
+ * @param scaledValue The fixed-point value.
+ * @return true if the value is folded, false if there are too many registers.
+ */
+bool SmAggregator::addRecordScaled(uint8_t const channel, SmScaledValue const& scaledValue)
+{
+    return fold(channel, scaledValue.mantissa, scaledValue.exponent, scaledValue.unit);
+}
+
+/**
+ * @brief Folds one value into the statistics of its register.
+ *
+ * The registers are identified by their position within the push (several registers share a channel). A
+ * register with another channel or unit at the position starts its statistics again. Values with a coarser
+ * exponent coarsen the statistics, finer values are rounded to the exponent of the statistics.
+ *
+ * @param channel The channel of the register.
+ * @param value The mantissa of the value.
+ * @param exponent The decimal exponent of the value.
+ * @param unit The unit of the value.
+ * @return true if the value is folded, false if there are too many registers.
+ */
+bool SmAggregator::fold(uint8_t const channel, int64_t const value, int8_t const exponent, SmUnit const unit)
+{
+    uint8_t const index = m_recordIndex;
+
+    if(index >= MAX_AGGREGATES)
+    {
+        return false;
+    }
+
+    m_recordIndex++;
+
+    SmAggregate& aggregate = m_aggregates[index];
+
+    if(index >= m_count)
+    {
+        start(aggregate, channel, exponent, unit);
+
+        m_count = index + 1;
+    }
+    else if(aggregate.channel != channel || aggregate.unit != unit)
+    {
+        MyLog::log("SMAGGREGATOR", "Register %d changed channel or unit, statistics started again", index);
+
+        start(aggregate, channel, exponent, unit);
+    }
+
+    if(exponent > aggregate.exponent)
+    {
+        coarsen(aggregate, exponent);
+    }
+
+    int64_t const scaled = SmScaler::rescale(value, exponent, aggregate.exponent);
+
+    if(aggregate.count == 0)
+    {
+        aggregate.first = scaled;
+        aggregate.min = scaled;
+        aggregate.max = scaled;
+    }
+
+    aggregate.last = scaled;
+    aggregate.min = scaled < aggregate.min ? scaled : aggregate.min;
+    aggregate.max = scaled > aggregate.max ? scaled : aggregate.max;
+    aggregate.sum += scaled;
+
+    if(aggregate.count < UINT16_MAX)
+    {
+        aggregate.count++;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Starts the statistics of a register.
+ *
+ * @param aggregate The statistics.
+ * @param channel The channel of the register.
+ * @param exponent The exponent of the first value.
+ * @param unit The unit of the register.
+ */
+void SmAggregator::start(SmAggregate& aggregate, uint8_t const channel, int8_t const exponent, SmUnit const unit)
+{
+    aggregate.channel = channel;
+    aggregate.unit = unit;
+    aggregate.exponent = exponent;
+    aggregate.counter = isCounter(unit);
+    aggregate.count = 0;
+    aggregate.first = 0;
+    aggregate.last = 0;
+    aggregate.min = 0;
+    aggregate.max = 0;
+    aggregate.sum = 0;
+}
+
+/**
+ * @brief Rescales the statistics to a coarser exponent, the values keep fitting into 32 bit mantissas.
+ *
+ * @param aggregate The statistics.
+ * @param exponent The coarser exponent.
+ */
+void SmAggregator::coarsen(SmAggregate& aggregate, int8_t const exponent)
+{
+    aggregate.first = SmScaler::rescale(aggregate.first, aggregate.exponent, exponent);
+    aggregate.last = SmScaler::rescale(aggregate.last, aggregate.exponent, exponent);
+    aggregate.min = SmScaler::rescale(aggregate.min, aggregate.exponent, exponent);
+    aggregate.max = SmScaler::rescale(aggregate.max, aggregate.exponent, exponent);
+    aggregate.sum = SmScaler::rescale(aggregate.sum, aggregate.exponent, exponent);
+    aggregate.exponent = exponent;
+}
+
+/**
+ * @brief Checks if the unit is the one of an energy counter.
+ *
+ * @param unit The unit of the register.
+ * @return true for energy units (Wh, VAh, varh), false for instantaneous values.
+ */
+bool SmAggregator::isCounter(SmUnit const unit)
+{
+    return unit == SmUnit::SMUNIT_WATTHOUR || unit == SmUnit::SMUNIT_VOLTAMPEREHOUR || unit == SmUnit::SMUNIT_VARHOUR;
+}
+
+/**
+ * @brief Gets the number of pushes folded into the window.
+ *
+ * @return The number of pushes.
+ */
+uint16_t SmAggregator::getPushCount() const
+{
+    return m_pushCount;
+}
+
+/**
+ * @brief Gets the time stamp of the first push of the window.
+ *
+ * @return The unix time stamp, 0 if there is no push.
+ */
+uint32_t SmAggregator::getFirstTime() const
+{
+    return m_firstTime;
+}
+
+/**
+ * @brief Gets the time stamp of the last push of the window.
+ *
+ * @return The unix time stamp, 0 if there is no push.
+ */
+uint32_t SmAggregator::getLastTime() const
+{
+    return m_lastTime;
+}
+
+/**
+ * @brief Gets the number of aggregated registers.
+ *
+ * @return The number of registers.
+ */
+uint8_t SmAggregator::getCount() const
+{
+    return m_count;
+}
+
+/**
+ * @brief Gets the statistics of a register.
+ *
+ * @param index The index of the register in the order of the push, less than getCount().
+ * @return The statistics.
+ */
+SmAggregate const& SmAggregator::getAt(uint8_t const index) const
+{
+    return m_aggregates[index < MAX_AGGREGATES ? index : 0];
+}
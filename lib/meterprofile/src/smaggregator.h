@@ -0,0 +1,67 @@
+/**
+ * @file smaggregator.h
+ * @brief This file contains the declaration of the SmAggregator class and the SmAggregate statistics.
+ *
+ * The aggregation folds every push of a window into running statistics of each register: minimum, maximum
+ * and mean of the instantaneous values and the first and last value of the energy counters. The aggregator
+ * is a record sink (see SmRecordSink), the push is extracted into it like into the uplink encoder. The memory
+ * is one SmAggregate per register, the pushes are not stored.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "smrecordsink.h"
+
+/**
+ * @brief Running statistics of one register, all values are mantissas with the same exponent.
+ */
+struct SmAggregate
+{
+    uint8_t channel;                                                                                // uplink channel of the register
+    SmUnit unit;                                                                                    // unit of the register
+    int8_t exponent;                                                                                // decimal exponent of the values (coarsest exponent of the window)
+    bool counter;                                                                                   // energy counter (first and last value), otherwise instantaneous value (min, max, mean)
+    uint16_t count;                                                                                 // number of folded values
+    int64_t first;                                                                                  // first value of the window
+    int64_t last;                                                                                   // last value of the window
+    int64_t min;                                                                                    // smallest value of the window
+    int64_t max;                                                                                    // largest value of the window
+    int64_t sum;                                                                                    // sum of the values of the window
+
+    int64_t getMean() const;                                                                        // mean of the values, rounded half away from zero
+};
+
+class SmAggregator : public SmRecordSink
+{
+    public:
+        static uint8_t const MAX_AGGREGATES = 16;                                                   // numeric registers of a push which are aggregated
+
+        void reset();                                                                               // starts a new window
+        bool addRecordTime(uint8_t const channel, uint32_t const unixTime) override;                // starts the next push of the window
+        bool addRecordValue(uint8_t const channel, GbtValueBase const* gbtValue) override;          // folds a raw numeric value (exponent 0, no unit), strings are skipped
+        bool addRecordScaled(uint8_t const channel, SmScaledValue const& scaledValue) override;     // folds a fixed-point value
+        uint16_t getPushCount() const;                                                              // number of pushes folded into the window
+        uint32_t getFirstTime() const;                                                              // time stamp of the first push of the window
+        uint32_t getLastTime() const;                                                               // time stamp of the last push of the window
+        uint8_t getCount() const;                                                                   // number of aggregated registers
+        SmAggregate const& getAt(uint8_t const index) const;                                        // statistics of the register at the index (index < getCount())
+        static bool isCounter(SmUnit const unit);                                                   // checks if the unit is the one of an energy counter
+
+    private:
+        SmAggregate m_aggregates[MAX_AGGREGATES];                                                   // statistics in the order of the push
+        uint8_t m_count = 0;                                                                        // number of aggregated registers
+        uint8_t m_recordIndex = 0;                                                                  // index of the next numeric record within the push
+        uint16_t m_pushCount = 0;                                                                   // number of pushes of the window
+        uint32_t m_firstTime = 0;                                                                   // time stamp of the first push
+        uint32_t m_lastTime = 0;                                                                    // time stamp of the last push
+
+        bool fold(uint8_t const channel, int64_t const value, int8_t const exponent, SmUnit const unit);  // folds one value into the statistics of its register
+        static void start(SmAggregate& aggregate, uint8_t const channel, int8_t const exponent, SmUnit const unit);  // starts the statistics of a register
+        static void coarsen(SmAggregate& aggregate, int8_t const exponent);                         // rescales the statistics to a coarser exponent
+};
@@ -0,0 +1,269 @@
+/**
+ * @file smderived.cpp
+ * @brief Implementation of the SmDerived class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include "mylog.h"
+#include "smaggregator.h"
+#include "smderived.h"
+
+/**
+ * @brief Drops the reference and the derived push, the next sent push is the new reference.
+ */
+void SmDerived::reset()
+{
+    m_counterCount = 0;
+    m_time = 0;
+    m_hasPrevious = false;
+    m_pendingCount = 0;
+    m_pendingTime = 0;
+    m_hasPending = false;
+    m_valueCount = 0;
+    m_interval = 0;
+    m_hasBalance = false;
+}
+
+/**
+ * @brief Derives the interval values from the push against the reference and keeps its counters until it is sent.
+ *
+ * The counters of the push become the reference with uplinkSent(), a push which is not sent does not move the
+ * reference. A counter is derived if the reference has the same register. A counter which went backwards (e.g. a
+ * replaced meter) is not derived. The balance is derived if the push has the total active energy import
+ * (C=1, D=8, E=0) and export (C=2, D=8, E=0).
+ *
+ * @param gbtData The parsed push.
+ * @param layout The resolved layout of the push.
+ * @param channelOffset The offset of the meter channel to the profile channel, applied to the register channels.
+ * @return true if values were derived, false without reference or for a push without time advance.
+ */
+bool SmDerived::update(GbtDataBase const& gbtData, SmPushLayout const& layout, uint8_t const channelOffset)
+{
+    uint32_t time = (uint32_t) gbtData.getDateTime().asUnixTimeStamp();
+
+    bool derive = m_hasPrevious && time > m_time;
+
+    m_interval = derive ? time - m_time : 0;
+    m_valueCount = 0;
+    m_hasBalance = false;
+
+    SmCounterState* counters = m_pendingCounters;
+    uint8_t counterCount = 0;
+
+    bool hasImport = false;
+    bool hasExport = false;
+    int64_t importDelta = 0;
+    int64_t exportDelta = 0;
+    int8_t importScaler = 0;
+    int8_t exportScaler = 0;
+
+    for(uint8_t i = 0; i < layout.getValueCount() && counterCount < MAX_COUNTERS; i++)
+    {
+        SmRegister const* smRegister = layout.getRegister(i);
+
+        int64_t raw;
+
+        if(smRegister == nullptr || !SmAggregator::isCounter(layout.getUnit(i)))
+        {
+            continue;
+        }
+
+        GbtValueBase const* gbtValue = gbtData.getValue(layout.getValueIndex(i));
+
+        if(gbtValue == nullptr || !SmScaler::getRawValue(gbtValue, raw))
+        {
+            continue;
+        }
+
+        SmCounterState& counter = counters[counterCount++];
+
+        counter.smRegister = smRegister;
+        counter.raw = raw;
+        counter.scaler = layout.getScaler(i);
+
+        SmCounterState const* previous = derive ? findPrevious(smRegister) : nullptr;
+
+        if(previous == nullptr)
+        {
+            continue;
+        }
+
+        // the delta with the scaler of this push
+        int64_t delta = raw - SmScaler::rescale(previous->raw, previous->scaler, counter.scaler);
+
+        if(delta < 0)
+        {
+            MyLog::log("SMDERIVED", "Counter %s went backwards, not derived", smRegister->obis);
+
+            continue;
+        }
+
+        SmUnit unit = layout.getUnit(i);
+
+        SmDerivedValue& value = m_values[m_valueCount++];
+
+        value.channel = smRegister->channel + channelOffset;
+        value.delta = SmScaler::scale(delta, counter.scaler, unit);
+
+        // energy per hour, with additional decimals (rounded), fitted into 32 bit by scale
+        int64_t power = (delta * SECONDS_PER_HOUR * 1000 + m_interval / 2) / m_interval;
+
+        value.averagePower = SmScaler::scale(power, counter.scaler - POWER_DECIMALS, getPowerUnit(unit));
+
+        uint8_t obis[6];
+
+        if(unit != SmUnit::SMUNIT_WATTHOUR || !SmProfiles::parseObis(smRegister->obis, obis) || obis[3] != 8 || obis[4] != 0)
+        {
+            continue;
+        }
+
+        if(obis[2] == 1 && !hasImport)
+        {
+            hasImport = true;
+            importDelta = delta;
+            importScaler = counter.scaler;
+        }
+        else if(obis[2] == 2 && !hasExport)
+        {
+            hasExport = true;
+            exportDelta = delta;
+            exportScaler = counter.scaler;
+        }
+    }
+
+    if(hasImport && hasExport)
+    {
+        // the finer scaler of both counters
+        int8_t scaler = importScaler < exportScaler ? importScaler : exportScaler;
+
+        int64_t balance = SmScaler::rescale(importDelta, importScaler, scaler) - SmScaler::rescale(exportDelta, exportScaler, scaler);
+
+        m_hasBalance = true;
+        m_balance = SmScaler::scale(balance, scaler, SmUnit::SMUNIT_WATTHOUR);
+    }
+
+    m_pendingCount = counterCount;
+    m_pendingTime = time;
+    m_hasPending = true;
+
+    return derive;
+}
+
+/**
+ * @brief Marks the derived push as sent, the following pushes are derived against its counters.
+ *
+ * Without a derived push since the last uplink the reference is kept.
+ */
+void SmDerived::uplinkSent()
+{
+    if(!m_hasPending)
+    {
+        return;
+    }
+
+    for(uint8_t i = 0; i < m_pendingCount; i++)
+    {
+        m_counters[i] = m_pendingCounters[i];
+    }
+
+    m_counterCount = m_pendingCount;
+    m_time = m_pendingTime;
+    m_hasPrevious = true;
+    m_hasPending = false;
+}
+
+/**
+ * @brief Finds the counter of the reference with the register.
+ *
+ * @param smRegister The register of the counter.
+ * @return The counter, nullptr if the reference does not have the register.
+ */
+SmDerived::SmCounterState const* SmDerived::findPrevious(SmRegister const* smRegister) const
+{
+    for(uint8_t i = 0; i < m_counterCount; i++)
+    {
+        if(m_counters[i].smRegister == smRegister)
+        {
+            return &m_counters[i];
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Gets the unit of the average power of an energy unit.
+ *
+ * @param energyUnit The unit of the counter.
+ * @return W for Wh, VA for VAh, var for varh, no unit otherwise.
+ */
+SmUnit SmDerived::getPowerUnit(SmUnit const energyUnit)
+{
+    switch(energyUnit)
+    {
+        case SmUnit::SMUNIT_WATTHOUR:
+            return SmUnit::SMUNIT_WATT;
+
+        case SmUnit::SMUNIT_VOLTAMPEREHOUR:
+            return SmUnit::SMUNIT_VOLTAMPERE;
+
+        case SmUnit::SMUNIT_VARHOUR:
+            return SmUnit::SMUNIT_VAR;
+
+        default:
+            return SmUnit::SMUNIT_NONE;
+    }
+}
+
+/**
+ * @brief Gets the time between the reference and the last push.
+ *
+ * @return The interval in s, 0 if nothing was derived.
+ */
+uint32_t SmDerived::getInterval() const
+{
+    return m_interval;
+}
+
+/**
+ * @brief Gets the number of derived counters of the last push.
+ *
+ * @return The number of counters.
+ */
+uint8_t SmDerived::getCount() const
+{
+    return m_valueCount;
+}
+
+/**
+ * @brief Gets the derived values of a counter.
+ *
+ * @param index The index of the counter, less than getCount().
+ * @return The derived values.
+ */
+SmDerivedValue const& SmDerived::getAt(uint8_t const index) const
+{
+    return m_values[index < MAX_COUNTERS ? index : 0];
+}
+
+/**
+ * @brief Checks if the balance of the active energy is derived.
+ *
+ * @return true if the last push has the import and the export counter and both were derived.
+ */
+bool SmDerived::hasBalance() const
+{
+    return m_hasBalance;
+}
+
+/**
+ * @brief Gets the balance of the active energy over the interval.
+ *
+ * @return Import minus export, negative if more energy was exported.
+ */
+SmScaledValue const& SmDerived::getBalance() const
+{
+    return m_balance;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file smderived.h
+ * @brief This file contains the declaration of the SmDerived class and the SmDerivedValue.
+ *
+ * Derives interval quantities from the cumulative energy counters of two pushes: the consumption of each
+ * counter (also per tariff) and its average power over the interval, and the balance of the active energy
+ * import and export. The counter values and the time stamp of the last sent push are the reference, the counters
+ * of a derived push only become the reference once its uplink is sent (a failed uplink keeps the old reference, the
+ * server receives the consumption since its last values). The arithmetic is integer only.
+ * The uplink can carry the derived values in place of the full register set.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "gbtdata.h"
+#include "smpushlayout.h"
+#include "smscaler.h"
+
+/**
+ * @brief Derived values of one energy counter over the interval.
+ */
+struct SmDerivedValue
+{
+    uint8_t channel;                                                                                // uplink channel of the counter
+    SmScaledValue delta;                                                                            // consumption over the interval (e.g. Wh)
+    SmScaledValue averagePower;                                                                     // average power over the interval (e.g. W)
+};
+
+class SmDerived
+{
+    public:
+        static uint8_t const MAX_COUNTERS = 12;                                                     // energy counters of a push which are derived
+
+        void reset();                                                                               // drops the reference and the derived push
+        bool update(GbtDataBase const& gbtData, SmPushLayout const& layout, uint8_t const channelOffset);   // derives from the push against the reference, false if there is no reference
+        void uplinkSent();                                                                          // the derived push was sent, its counters are the new reference
+        uint32_t getInterval() const;                                                               // time between the reference and the last push in s
+        uint8_t getCount() const;                                                                   // number of derived counters
+        SmDerivedValue const& getAt(uint8_t const index) const;                                     // derived values of the counter at the index (index < getCount())
+        bool hasBalance() const;                                                                    // checks if the push has the active energy import and export
+        SmScaledValue const& getBalance() const;                                                    // import minus export over the interval (e.g. Wh)
+        static SmUnit getPowerUnit(SmUnit const energyUnit);                                        // unit of the average power of an energy unit
+
+    private:
+        static uint32_t const SECONDS_PER_HOUR = 3600;                                              // energy per hour is power
+        static int8_t const POWER_DECIMALS = 3;                                                     // additional decimals of the average power before it is fitted into 32 bit
+
+        /**
+         * @brief Counter value of a push.
+         */
+        struct SmCounterState
+        {
+            SmRegister const* smRegister;                                                           // register of the counter (identifies it within the push)
+            int64_t raw;                                                                            // raw value
+            int8_t scaler;                                                                          // scaler of the raw value
+        };
+
+        SmCounterState m_counters[MAX_COUNTERS];                                                    // counters of the last sent push (reference)
+        uint8_t m_counterCount = 0;                                                                 // number of counters of the reference
+        uint32_t m_time = 0;                                                                        // time stamp of the reference
+        bool m_hasPrevious = false;                                                                 // a reference is known
+        SmCounterState m_pendingCounters[MAX_COUNTERS];                                             // counters of the derived push, not sent yet
+        uint8_t m_pendingCount = 0;                                                                 // number of counters of the derived push
+        uint32_t m_pendingTime = 0;                                                                 // time stamp of the derived push
+        bool m_hasPending = false;                                                                  // a derived push waits for its uplink
+
+        SmDerivedValue m_values[MAX_COUNTERS];                                                      // derived values of the last push
+        uint8_t m_valueCount = 0;                                                                   // number of derived values
+        uint32_t m_interval = 0;                                                                    // interval of the derived values in s
+        bool m_hasBalance = false;                                                                  // the balance is derived
+        SmScaledValue m_balance = { 0, 0, SmUnit::SMUNIT_WATTHOUR };                                // import minus export
+
+        SmCounterState const* findPrevious(SmRegister const* smRegister) const;                     // counter of the reference with the register, nullptr if none
+};
@@ -0,0 +1,215 @@
+/**
+ * @file smeventrules.cpp
+ * @brief Implementation of the SmEventRules class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include "mylog.h"
+#include "smaggregator.h"
+#include "smeventrules.h"
+
+/**
+ * @brief Sets the rules.
+ *
+ * @param powerThreshold Send if a power rises above the threshold in W (VA, var), 0 for off.
+ * @param energyDelta Send if an energy counter has moved by the delta in Wh (VAh, varh) since the last uplink, 0 for off.
+ * @param statusChange Send if a status register (no unit) has changed since the last uplink.
+ * @param heartbeat Send at least once in the interval in s (time stamps of the meter), 0 for off.
+ */
+void SmEventRules::configure(uint32_t const powerThreshold, uint32_t const energyDelta, bool const statusChange, uint32_t const heartbeat)
+{
+    m_powerThreshold = powerThreshold;
+    m_energyDelta = energyDelta;
+    m_statusChange = statusChange;
+    m_heartbeat = heartbeat;
+}
+
+/**
+ * @brief Drops the state of the registers, the next push is sent.
+ */
+void SmEventRules::reset()
+{
+    m_count = 0;
+    m_recordIndex = 0;
+    m_events = EVENT_FIRST;
+    m_sent = false;
+    m_pushTime = 0;
+    m_sentTime = 0;
+}
+
+/**
+ * @brief Starts the evaluation of a push (the time stamp is the first record of each push).
+ *
+ * @param channel The channel of the meter (unused).
+ * @param unixTime The time stamp of the push.
+ * @return true, the time stamp is always taken.
+ */
+bool SmEventRules::addRecordTime(uint8_t const channel, uint32_t const unixTime)
+{
+    m_pushTime = unixTime;
+    m_recordIndex = 0;
+    m_events = m_sent ? EVENT_NONE : EVENT_FIRST;
+
+    if(m_sent && m_heartbeat > 0 && m_pushTime - m_sentTime >= m_heartbeat)
+    {
+        m_events |= EVENT_HEARTBEAT;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Checks a raw value, used if the push is not extracted scaled.
+ *
+ * @param channel The channel of the register.
+ * @param gbtValue The raw value.
+ * @return true if the value is checked or not numeric (skipped), false if there are too many registers.
+ */
+bool SmEventRules::addRecordValue(uint8_t const channel, GbtValueBase const* gbtValue)
+{
+    int64_t raw;
+
+    if(!SmScaler::getRawValue(gbtValue, raw))
+    {
+        return true;
+    }
+
+    return check(channel, raw, 0, SmUnit::SMUNIT_NONE);
+}
+
+/**
+ * @brief Checks a fixed-point value.
+ *
+ * @param channel The channel of the register.
+ * @param scaledValue The fixed-point value.
+ * @return true if the value is checked, false if there are too many registers.
+ */
+bool SmEventRules::addRecordScaled(uint8_t const channel, SmScaledValue const& scaledValue)
+{
+    return check(channel, scaledValue.mantissa, scaledValue.exponent, scaledValue.unit);
+}
+
+/**
+ * @brief Checks one value against the rules.
+ *
+ * The registers are identified by their position within the push (several registers share a channel). A
+ * register with another channel or unit at the position is an event of its own (EVENT_FIRST).
+ *
+ * @param channel The channel of the register.
+ * @param value The mantissa of the value.
+ * @param exponent The decimal exponent of the value.
+ * @param unit The unit of the value.
+ * @return true if the value is checked, false if there are too many registers.
+ */
+bool SmEventRules::check(uint8_t const channel, int64_t const value, int8_t const exponent, SmUnit const unit)
+{
+    uint8_t const index = m_recordIndex;
+
+    if(index >= MAX_REGISTERS)
+    {
+        return false;
+    }
+
+    m_recordIndex++;
+
+    SmRegisterState& state = m_registers[index];
+
+    if(index >= m_count || state.channel != channel || state.unit != unit)
+    {
+        if(m_sent)
+        {
+            MyLog::log("SMEVENTRULES", "Register %d is new or has changed", index);
+        }
+
+        state.channel = channel;
+        state.unit = unit;
+        state.exponent = exponent;
+        state.above = false;
+        state.sent = value;
+
+        m_count = index >= m_count ? index + 1 : m_count;
+        m_events |= EVENT_FIRST;
+    }
+
+    state.current = SmScaler::rescale(value, exponent, state.exponent);
+
+    // the power rises above the threshold (sent once until it falls below again)
+    if(m_powerThreshold > 0 && isPower(unit))
+    {
+        bool above = SmScaler::rescale(state.current, state.exponent, 0) > (int64_t) m_powerThreshold;
+
+        if(above && !state.above)
+        {
+            m_events |= EVENT_POWER;
+        }
+
+        state.above = above;
+    }
+
+    // the counter has moved by the delta since the last uplink
+    if(m_energyDelta > 0 && SmAggregator::isCounter(unit))
+    {
+        int64_t delta = SmScaler::rescale(state.current - state.sent, state.exponent, 0);
+
+        if(delta >= (int64_t) m_energyDelta || -delta >= (int64_t) m_energyDelta)
+        {
+            m_events |= EVENT_ENERGY;
+        }
+    }
+
+    // status registers have no unit
+    if(m_statusChange && unit == SmUnit::SMUNIT_NONE && state.current != state.sent)
+    {
+        m_events |= EVENT_STATUS;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Checks if the unit is the one of a power.
+ *
+ * @param unit The unit of the register.
+ * @return true for W, VA and var.
+ */
+bool SmEventRules::isPower(SmUnit const unit)
+{
+    return unit == SmUnit::SMUNIT_WATT || unit == SmUnit::SMUNIT_VOLTAMPERE || unit == SmUnit::SMUNIT_VAR;
+}
+
+/**
+ * @brief Gets the events of the evaluated push.
+ *
+ * @return The events (EVENT_* flags), EVENT_NONE if the push is not worth an uplink.
+ */
+uint8_t SmEventRules::getEvents() const
+{
+    return m_events;
+}
+
+/**
+ * @brief Checks if the evaluated push has to be sent.
+ *
+ * @return true if there is an event or the heartbeat is due.
+ */
+bool SmEventRules::isUplinkDue() const
+{
+    return m_events != EVENT_NONE;
+}
+
+/**
+ * @brief Marks the evaluated push as sent, the deltas are measured against its values from now on.
+ */
+void SmEventRules::uplinkSent()
+{
+    for(uint8_t i = 0; i < m_count; i++)
+    {
+        m_registers[i].sent = m_registers[i].current;
+    }
+
+    m_sent = true;
+    m_sentTime = m_pushTime;
+    m_events = EVENT_NONE;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file smeventrules.h
+ * @brief This file contains the declaration of the SmEventRules class.
+ *
+ * The rules decide if the push of a cycle is worth an uplink: the power rises above a threshold, an energy
+ * counter has moved by a delta since the last uplink or a status register has changed. Without such an event
+ * only a sparse heartbeat is sent. The rules are a record sink (see SmRecordSink), the push is extracted into
+ * them. The state is the value at the last uplink and the current value of each numeric register.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "smrecordsink.h"
+
+class SmEventRules : public SmRecordSink
+{
+    public:
+        static uint8_t const MAX_REGISTERS = 16;                                                    // numeric registers of a push which are checked
+
+        static uint8_t const EVENT_NONE = 0x00;                                                     // nothing to send
+        static uint8_t const EVENT_FIRST = 0x01;                                                    // no uplink sent yet, or the registers of the push have changed
+        static uint8_t const EVENT_POWER = 0x02;                                                    // a power has risen above the threshold
+        static uint8_t const EVENT_ENERGY = 0x04;                                                   // an energy counter has moved by the delta since the last uplink
+        static uint8_t const EVENT_STATUS = 0x08;                                                   // a status register (no unit) has changed since the last uplink
+        static uint8_t const EVENT_HEARTBEAT = 0x10;                                                // the heartbeat interval has expired
+
+        void configure(uint32_t const powerThreshold, uint32_t const energyDelta, bool const statusChange, uint32_t const heartbeat);  // sets the rules, 0 disables a threshold
+        void reset();                                                                               // drops the state, the next push is sent
+        bool addRecordTime(uint8_t const channel, uint32_t const unixTime) override;                // starts the evaluation of a push
+        bool addRecordValue(uint8_t const channel, GbtValueBase const* gbtValue) override;          // checks a raw numeric value (exponent 0, no unit), strings are skipped
+        bool addRecordScaled(uint8_t const channel, SmScaledValue const& scaledValue) override;     // checks a fixed-point value
+        uint8_t getEvents() const;                                                                  // events of the evaluated push (EVENT_*), including the heartbeat
+        bool isUplinkDue() const;                                                                   // checks if the evaluated push has to be sent
+        void uplinkSent();                                                                          // the evaluated push was sent, its values are the new reference
+
+    private:
+        /**
+         * @brief State of one numeric register, the values are mantissas with the exponent of the register.
+         */
+        struct SmRegisterState
+        {
+            uint8_t channel;                                                                        // uplink channel of the register
+            SmUnit unit;                                                                            // unit of the register
+            int8_t exponent;                                                                        // exponent of the values
+            bool above;                                                                             // the power was above the threshold at the last push
+            int64_t sent;                                                                           // value at the last uplink
+            int64_t current;                                                                        // value of the evaluated push
+        };
+
+        SmRegisterState m_registers[MAX_REGISTERS];                                                 // state in the order of the push
+        uint8_t m_count = 0;                                                                        // number of registers with state
+        uint8_t m_recordIndex = 0;                                                                  // index of the next numeric record within the push
+        uint8_t m_events = EVENT_FIRST;                                                             // events of the evaluated push
+        bool m_sent = false;                                                                        // an uplink was sent since the reset
+        uint32_t m_pushTime = 0;                                                                    // time stamp of the evaluated push
+        uint32_t m_sentTime = 0;                                                                    // time stamp of the last uplink
+
+        uint32_t m_powerThreshold = 0;                                                              // power threshold in W, 0 for off
+        uint32_t m_energyDelta = 0;                                                                 // energy delta in Wh (VAh, varh), 0 for off
+        bool m_statusChange = false;                                                                // send if a status register changes
+        uint32_t m_heartbeat = 0;                                                                   // heartbeat interval in s, 0 for off
+
+        bool check(uint8_t const channel, int64_t const value, int8_t const exponent, SmUnit const unit);  // checks one value against the rules
+        static bool isPower(SmUnit const unit);                                                     // checks if the unit is the one of a power
+};
@@ -0,0 +1,162 @@
+/**
+ * @file smpriorityplan.cpp
+ * @brief Implementation of the SmPriorityPlan class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include "mylog.h"
+#include "smpriorityplan.h"
+
+/**
+ * @brief Forgets the deferred registers, the next plan starts with the priorities of the profile.
+ */
+void SmPriorityPlan::reset()
+{
+    m_layoutHash = 0;
+    m_deferred = 0;
+
+    for(uint8_t i = 0; i < SmPushLayout::MAX_PUSHVALUES; i++)
+    {
+        m_deferredCount[i] = 0;
+    }
+}
+
+/**
+ * @brief Selects the records of a push which fit into the payload budget.
+ *
+ * The records are taken in the order of their rank (priority less deferrals, then the longest deferred, then
+ * the order of the push). A record which does not fit is deferred, a smaller one of a lower rank may still fit.
+ *
+ * @param layout The push layout of the records.
+ * @param recordValues The index of the value within the push layout of each record.
+ * @param recordSizes The size of each record in bytes.
+ * @param recordCount The number of records, at most SmPushLayout::MAX_PUSHVALUES.
+ * @param budget The bytes available for the records.
+ * @return The records which are kept, bit i for record i.
+ */
+uint32_t SmPriorityPlan::plan(SmPushLayout const& layout, uint8_t const* recordValues, uint16_t const* recordSizes, uint8_t const recordCount, size_t const budget)
+{
+    if(layout.getHash() != m_layoutHash)
+    {
+        reset();
+
+        m_layoutHash = layout.getHash();
+    }
+
+    uint8_t order[SmPushLayout::MAX_PUSHVALUES];
+    uint8_t count = recordCount < SmPushLayout::MAX_PUSHVALUES ? recordCount : SmPushLayout::MAX_PUSHVALUES;
+
+    // insertion sort of the records by rank, a push has few records
+    for(uint8_t i = 0; i < count; i++)
+    {
+        uint8_t j = i;
+
+        while(j > 0 && isBefore(layout, recordValues[i], recordValues[order[j - 1]]))
+        {
+            order[j] = order[j - 1];
+            j--;
+        }
+
+        order[j] = i;
+    }
+
+    uint32_t kept = 0;
+    size_t remaining = budget;
+
+    m_deferred = 0;
+
+    for(uint8_t i = 0; i < count; i++)
+    {
+        uint8_t record = order[i];
+        uint8_t valueIndex = recordValues[record];
+
+        if(recordSizes[record] <= remaining)
+        {
+            remaining -= recordSizes[record];
+            kept |= 1UL << record;
+
+            m_deferredCount[valueIndex] = 0;
+        }
+        else
+        {
+            m_deferred |= 1UL << valueIndex;
+
+            if(m_deferredCount[valueIndex] < UINT8_MAX)
+            {
+                m_deferredCount[valueIndex]++;
+            }
+        }
+    }
+
+    if(m_deferred != 0)
+    {
+        MyLog::log("SMPRIORITY", "Deferred values %08lx, %d bytes of %d used", (unsigned long) m_deferred, (int) (budget - remaining), (int) budget);
+    }
+
+    return kept;
+}
+
+/**
+ * @brief Gets the values deferred by the last plan.
+ *
+ * @return The deferred values, bit i for value i of the push layout.
+ */
+uint32_t SmPriorityPlan::getDeferred() const
+{
+    return m_deferred;
+}
+
+/**
+ * @brief Gets the number of uplinks a value was deferred in a row.
+ *
+ * @param valueIndex The index of the value within the push layout.
+ * @return The number of uplinks, 0 if the value was sent with the last uplink.
+ */
+uint8_t SmPriorityPlan::getDeferredCount(uint8_t const valueIndex) const
+{
+    return valueIndex < SmPushLayout::MAX_PUSHVALUES ? m_deferredCount[valueIndex] : 0;
+}
+
+/**
+ * @brief Gets the rank of a value, its priority less the uplinks it was deferred in a row.
+ *
+ * @param layout The push layout.
+ * @param valueIndex The index of the value within the push layout.
+ * @return The rank, the lowest rank is kept first.
+ */
+int16_t SmPriorityPlan::getRank(SmPushLayout const& layout, uint8_t const valueIndex) const
+{
+    SmRegister const* smRegister = layout.getRegister(valueIndex);
+
+    int16_t priority = smRegister != nullptr ? smRegister->priority : UINT8_MAX;
+
+    return priority - m_deferredCount[valueIndex];
+}
+
+/**
+ * @brief Checks if a value is kept before another one.
+ *
+ * @param layout The push layout.
+ * @param first The index of the first value within the push layout.
+ * @param second The index of the second value within the push layout.
+ * @return true if the first value has a lower rank, or the same rank and was deferred longer or comes first in the push.
+ */
+bool SmPriorityPlan::isBefore(SmPushLayout const& layout, uint8_t const first, uint8_t const second) const
+{
+    int16_t firstRank = getRank(layout, first);
+    int16_t secondRank = getRank(layout, second);
+
+    if(firstRank != secondRank)
+    {
+        return firstRank < secondRank;
+    }
+
+    if(m_deferredCount[first] != m_deferredCount[second])
+    {
+        return m_deferredCount[first] > m_deferredCount[second];
+    }
+
+    return first < second;
+}
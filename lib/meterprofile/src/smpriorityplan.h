@@ -0,0 +1,37 @@
+/**
+ * @file smpriorityplan.h
+ * @brief This file contains the declaration of the SmPriorityPlan class.
+ *
+ * At a low data rate the records of a push may not fit into one frame. The plan keeps the records in the
+ * priority of their registers (see SmRegister::priority, 0 is the most important) as long as they fit into the
+ * payload budget, the others are deferred. A deferred register gains one priority level for each uplink it is
+ * deferred in a row, so it rotates into a later uplink and every register eventually gets through. The state is
+ * the number of uplinks each value of the push layout was deferred in a row.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "smpushlayout.h"
+
+class SmPriorityPlan
+{
+    public:
+        void reset();                                                                               // forgets the deferred registers
+        uint32_t plan(SmPushLayout const& layout, uint8_t const* recordValues, uint16_t const* recordSizes, uint8_t const recordCount, size_t const budget);    // selects the records which fit into the budget, returns the kept records (bit per record)
+        uint32_t getDeferred() const;                                                               // values of the push layout deferred by the last plan (bit per value)
+        uint8_t getDeferredCount(uint8_t const valueIndex) const;                                   // uplinks the value was deferred in a row
+
+    private:
+        uint32_t m_layoutHash = 0;                                                                  // hash of the push layout the state belongs to
+        uint32_t m_deferred = 0;                                                                    // values deferred by the last plan
+        uint8_t m_deferredCount[SmPushLayout::MAX_PUSHVALUES] = {};                                 // uplinks each value was deferred in a row
+
+        int16_t getRank(SmPushLayout const& layout, uint8_t const valueIndex) const;                // priority of the value less its deferrals, the lowest is kept first
+        bool isBefore(SmPushLayout const& layout, uint8_t const first, uint8_t const second) const; // checks if the first value is kept before the second
+};
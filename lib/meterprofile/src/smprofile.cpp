@@ -0,0 +1,188 @@
+/**
+ * @file smprofile.cpp
+ * @brief Implementation of the meter profile table.
+ *
+ * The tables are constexpr, they are placed in flash and do not use any RAM. To support a new meter add
+ * a register table and an entry in SM_PROFILES.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "smprofile.h"
+
+/**
+ * @brief Registers of the Landis+Gyr E450 push (customer interface), all of them on channel 10.
+ *
+ * The uplink keeps the order of the push, the table order does not matter.
+ */
+static constexpr SmRegister SM_REGISTERS_LG_E450[] = {
+    { "0.8.25.9.0.255",  10, 3,  0, SmUnit::SMUNIT_NONE,     SmRegisterRole::SMREGISTER_VALUE },      // push setup, logical name
+    { "0.0.96.1.0.255",  10, 1,  0, SmUnit::SMUNIT_NONE,     SmRegisterRole::SMREGISTER_DEVICENAME }, // device identifier
+    { "1.0.1.7.0.255",   10, 1,  0, SmUnit::SMUNIT_WATT,     SmRegisterRole::SMREGISTER_VALUE },      // active power +P (W)
+    { "1.0.2.7.0.255",   10, 1,  0, SmUnit::SMUNIT_WATT,     SmRegisterRole::SMREGISTER_VALUE },      // active power -P (W)
+    { "1.1.1.8.0.255",   10, 0,  0, SmUnit::SMUNIT_WATTHOUR, SmRegisterRole::SMREGISTER_VALUE },      // active energy +A (Wh)
+    { "1.1.2.8.0.255",   10, 0,  0, SmUnit::SMUNIT_WATTHOUR, SmRegisterRole::SMREGISTER_VALUE },      // active energy -A (Wh)
+    { "1.1.5.8.0.255",   10, 2,  0, SmUnit::SMUNIT_VARHOUR,  SmRegisterRole::SMREGISTER_VALUE },      // reactive energy QI (varh)
+    { "1.1.6.8.0.255",   10, 2,  0, SmUnit::SMUNIT_VARHOUR,  SmRegisterRole::SMREGISTER_VALUE },      // reactive energy QII (varh)
+    { "1.1.7.8.0.255",   10, 2,  0, SmUnit::SMUNIT_VARHOUR,  SmRegisterRole::SMREGISTER_VALUE },      // reactive energy QIII (varh)
+    { "1.1.8.8.0.255",   10, 2,  0, SmUnit::SMUNIT_VARHOUR,  SmRegisterRole::SMREGISTER_VALUE },      // reactive energy QIV (varh)
+    { "1.0.130.7.0.255", 10, 2,  0, SmUnit::SMUNIT_NONE,     SmRegisterRole::SMREGISTER_VALUE },      // manufacturer specific instantaneous value
+    { "1.0.31.7.0.255",  10, 2, -2, SmUnit::SMUNIT_AMPERE,   SmRegisterRole::SMREGISTER_VALUE },      // current L1 (0.01 A)
+    { "1.0.51.7.0.255",  10, 2, -2, SmUnit::SMUNIT_AMPERE,   SmRegisterRole::SMREGISTER_VALUE },      // current L2 (0.01 A)
+    { "1.0.71.7.0.255",  10, 2, -2, SmUnit::SMUNIT_AMPERE,   SmRegisterRole::SMREGISTER_VALUE }       // current L3 (0.01 A)
+};
+
+/**
+ * @brief All known meter profiles.
+ */
+static constexpr SmProfile SM_PROFILES[] = {
+    {
+        SmProfiles::SMPROFILE_LG_E450, "LG E450", 2400, SmSerialFormat::SMSERIAL_8E1, SmApduForm::SMAPDU_GBT_PUSH, 10,
+        SM_REGISTERS_LG_E450, sizeof(SM_REGISTERS_LG_E450) / sizeof(SmRegister),
+        { true, 0x33ff }                                                                            // the push frames carry the LLC header (e6 e7 00)
+    }
+};
+
+static_assert(sizeof(SM_PROFILES) / sizeof(SmProfile) < 256, "profile count must fit into uint8_t");
+
+/**
+ * @brief Looks up the register of an OBIS code.
+ *
+ * @param obis The OBIS code as formatted by GbtOctetString.
+ * @return The register, nullptr if the OBIS code is not sent by this profile.
+ */
+SmRegister const* SmProfile::findRegister(char const* obis) const
+{
+    for(uint8_t i = 0; i < registerCount; i++)
+    {
+        if(strcmp(registers[i].obis, obis) == 0)
+        {
+            return &registers[i];
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Looks up a profile by its identifier.
+ *
+ * @param id The profile identifier.
+ * @return The profile, nullptr if the identifier is unknown.
+ */
+SmProfile const* SmProfiles::find(uint8_t const id)
+{
+    for(uint8_t i = 0; i < getCount(); i++)
+    {
+        if(SM_PROFILES[i].id == id)
+        {
+            return &SM_PROFILES[i];
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Gets the default profile.
+ *
+ * @return The profile with the identifier SMPROFILE_DEFAULT.
+ */
+SmProfile const& SmProfiles::getDefault()
+{
+    return *find(SMPROFILE_DEFAULT);
+}
+
+/**
+ * @brief Gets the number of profiles.
+ *
+ * @return The number of entries in the profile table.
+ */
+uint8_t SmProfiles::getCount()
+{
+    return sizeof(SM_PROFILES) / sizeof(SmProfile);
+}
+
+/**
+ * @brief Gets a profile by its table index (e.g. to list all profiles).
+ *
+ * @param index The table index, must be smaller than getCount().
+ * @return The profile.
+ */
+SmProfile const& SmProfiles::getAt(uint8_t const index)
+{
+    return SM_PROFILES[index];
+}
+
+/**
+ * @brief Splits an OBIS code into its fields.
+ *
+ * @param obis The OBIS code as formatted by GbtOctetString (e.g. "1.1.1.8.0.255").
+ * @param fields The fields A to F.
+ * @return true if the code has six numeric fields, false otherwise.
+ */
+bool SmProfiles::parseObis(char const* obis, uint8_t (&fields)[6])
+{
+    uint8_t field = 0;
+    uint16_t value = 0;
+    bool digit = false;
+
+    for(char const* c = obis; ; c++)
+    {
+        if(*c >= '0' && *c <= '9')
+        {
+            value = value * 10 + (*c - '0');
+            digit = true;
+
+            if(value > UINT8_MAX)
+            {
+                return false;
+            }
+
+            continue;
+        }
+
+        if((*c != '.' && *c != '\0') || !digit || field >= 6)
+        {
+            return false;
+        }
+
+        fields[field++] = (uint8_t) value;
+        value = 0;
+        digit = false;
+
+        if(*c == '\0')
+        {
+            return field == 6;
+        }
+    }
+}
+
+/**
+ * @brief Formats the fields of an OBIS code as formatted by GbtOctetString (e.g. "1.1.1.8.0.255").
+ *
+ * @param fields The fields A to F.
+ * @param buffer The buffer for the code, OBIS_STRING_SIZE characters hold any code.
+ * @param size The size of the buffer.
+ * @return The length of the code, 0 if it does not fit into the buffer.
+ */
+size_t SmProfiles::formatObis(uint8_t const (&fields)[6], char* buffer, size_t const size)
+{
+    int length = snprintf(buffer, size, "%d.%d.%d.%d.%d.%d", fields[0], fields[1], fields[2], fields[3], fields[4], fields[5]);
+
+    if(length < 0 || (size_t) length >= size)
+    {
+        if(size > 0)
+        {
+            buffer[0] = 0;
+        }
+
+        return 0;
+    }
+
+    return length;
+}
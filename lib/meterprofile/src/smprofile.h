@@ -0,0 +1,117 @@
+/**
+ * @file smprofile.h
+ * @brief This file contains the meter profile table (SmProfile) and its lookup (SmProfiles).
+ *
+ * A meter profile describes everything which is specific to a smart meter model: the serial settings of the
+ * M-Bus/P1 interface, the expected APDU form and the registers (OBIS codes) which are sent in the uplink with
+ * their channel, priority, scaler and unit. The profiles are constexpr tables and stay in flash.
+ *
+ * Supporting a new meter is a new entry in the table of smprofile.cpp, the pipeline selects the profile
+ * at runtime (AT+SMPROFILE or downlink) by its identifier or detects it from the pushed frames.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Data bits, parity and stop bits of the serial interface (mapped to the framework constants by the meter).
+ */
+enum class SmSerialFormat : uint8_t
+{
+    SMSERIAL_8N1 = 0,
+    SMSERIAL_8E1 = 1
+};
+
+/**
+ * @brief Form of the application data pushed by the meter.
+ */
+enum class SmApduForm : uint8_t
+{
+    SMAPDU_GBT_PUSH = 0                                                                             // general block transfer, structure with the push object list (descriptors) followed by the values
+};
+
+/**
+ * @brief Unit of a register, the values are the DLMS unit enumeration (scaler_unit attribute).
+ */
+enum class SmUnit : uint8_t
+{
+    SMUNIT_WATT = 27,                                                                               // active power (W)
+    SMUNIT_VOLTAMPERE = 28,                                                                         // apparent power (VA)
+    SMUNIT_VAR = 29,                                                                                // reactive power (var)
+    SMUNIT_WATTHOUR = 30,                                                                           // active energy (Wh)
+    SMUNIT_VOLTAMPEREHOUR = 31,                                                                     // apparent energy (VAh)
+    SMUNIT_VARHOUR = 32,                                                                            // reactive energy (varh)
+    SMUNIT_AMPERE = 33,                                                                             // current (A)
+    SMUNIT_VOLT = 35,                                                                               // voltage (V)
+    SMUNIT_HERTZ = 44,                                                                              // frequency (Hz)
+    SMUNIT_NONE = 255                                                                               // no unit (count, identifiers)
+};
+
+/**
+ * @brief Role of a register within the push.
+ */
+enum class SmRegisterRole : uint8_t
+{
+    SMREGISTER_VALUE = 0,                                                                           // value sent in the uplink
+    SMREGISTER_DEVICENAME = 1                                                                       // logical device name of the meter (sent in the uplink as well)
+};
+
+/**
+ * @brief Mapping of one OBIS code to the uplink.
+ */
+struct SmRegister
+{
+    char const* obis;                                                                               // OBIS code as formatted by GbtOctetString (e.g. "1.1.1.8.0.255")
+    uint8_t channel;                                                                                // uplink channel
+    uint8_t priority;                                                                               // 0 is the most important register
+    int8_t scaler;                                                                                  // value = raw value * 10^scaler (overridden by a pushed scaler_unit)
+    SmUnit unit;                                                                                    // unit of the scaled value
+    SmRegisterRole role;                                                                            // role of the register
+};
+
+/**
+ * @brief Fingerprint of the HDLC frames of a meter model, used by the auto-detection (see SmAutoDetect).
+ */
+struct SmFingerprint
+{
+    bool llcHeader;                                                                                 // the information field starts with the LLC header (e6 e7 00)
+    uint32_t destination;                                                                           // hdlc destination address of the push, 0 for any
+};
+
+/**
+ * @brief Profile of one meter model.
+ */
+struct SmProfile
+{
+    uint8_t id;                                                                                     // identifier used by the AT command, the downlink and the settings
+    char const* name;                                                                               // human readable name
+    uint32_t baudRate;                                                                              // baud rate of the serial interface
+    SmSerialFormat serialFormat;                                                                    // data bits, parity and stop bits
+    SmApduForm apduForm;                                                                            // expected form of the pushed data
+    uint8_t channel;                                                                                // channel of the meter (date time and adapter states)
+    SmRegister const* registers;                                                                    // registers sent in the uplink, in flash
+    uint8_t registerCount;                                                                          // number of registers
+    SmFingerprint fingerprint;                                                                      // fingerprint of the frames for the auto-detection
+
+    SmRegister const* findRegister(char const* obis) const;                                         // returns the register of the OBIS code, nullptr if it is not sent
+};
+
+class SmProfiles
+{
+    public:
+        static uint8_t const SMPROFILE_LG_E450 = 1;                                                 // Landis+Gyr E450 (GBT push on the customer interface)
+        static uint8_t const SMPROFILE_DEFAULT = SMPROFILE_LG_E450;                                 // profile used if the configured one is unknown
+        static uint8_t const OBIS_STRING_SIZE = 24;                                                 // buffer for any formatted OBIS code (A.B.C.D.E.F)
+
+        static SmProfile const* find(uint8_t const id);                                             // returns the profile with the identifier, nullptr if it is unknown
+        static SmProfile const& getDefault();                                                       // returns the default profile
+        static uint8_t getCount();                                                                  // number of profiles in the table
+        static SmProfile const& getAt(uint8_t const index);                                         // returns the profile at the table index (index < getCount())
+        static bool parseObis(char const* obis, uint8_t (&fields)[6]);                              // splits an OBIS code (A.B.C.D.E.F) into its fields
+        static size_t formatObis(uint8_t const (&fields)[6], char* buffer, size_t const size);      // formats the fields as OBIS code (A.B.C.D.E.F)
+};
@@ -0,0 +1,246 @@
+/**
+ * @file smpushextractor.cpp
+ * @brief Implementation of the SmPushExtractor class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include <string.h>
+
+#include "gbtoctetstring.h"
+#include "mylog.h"
+#include "smscaler.h"
+#include "smpushextractor.h"
+
+/**
+ * @brief Parses the push, the values filtered out by the register filter are skipped.
+ *
+ * With an active filter and a cached layout of the profile the values which are not sent are skipped by the parse
+ * (not stored, octet strings not formatted), the device name is always kept. If the descriptors of the push
+ * changed the skipped values do not belong to the filtered registers, the push is parsed completely and the layout
+ * is resolved by the next extract. Without filter or layout the push is parsed completely.
+ *
+ * @param gbtData The values of the push.
+ * @param data The GBT data of the push.
+ * @param size The size of the GBT data.
+ * @param profile The profile of the meter.
+ * @return The result of GbtDataBase::parse, < 0 on failure.
+ */
+int SmPushExtractor::parse(GbtDataBase& gbtData, uint8_t const* data, size_t const size, SmProfile const& profile)
+{
+    if(m_filter.isActive() && m_pushLayout.getValueCount() > 0)
+    {
+        compileSkipMask();
+
+        int result = gbtData.parse(data, size, m_skipMask);
+
+        if(result < 0 || m_pushLayout.matches(gbtData, profile))
+        {
+            return result;
+        }
+
+        MyLog::log("SMEXTRACT", "Push layout changed, parse the push completely");
+    }
+
+    return gbtData.parse(data, size);
+}
+
+/**
+ * @brief Marks the values of the cached layout which are not sent, except the device name.
+ */
+void SmPushExtractor::compileSkipMask()
+{
+    uint32_t allowed = m_filter.getAllowed(m_pushLayout);
+    uint8_t deviceNameIndex = m_pushLayout.getDeviceNameIndex();
+
+    m_skipMask.clear();
+
+    for(uint8_t i = 0; i < m_pushLayout.getValueCount(); i++)
+    {
+        if((allowed & (1UL << i)) == 0 && i != deviceNameIndex)
+        {
+            m_skipMask.set(m_pushLayout.getValueIndex(i));
+        }
+    }
+}
+
+/**
+ * @brief Extracts the push in one pass over its values.
+ *
+ * The time stamp is emitted first, then the values in the order of the push on the channel of their register
+ * (moved by the offset of the meter channel to the profile channel). Values without register are not emitted,
+ * the value with the device name role is emitted and its name is kept. A push without layout emits the time
+ * stamp only.
+ *
+ * @param gbtData The parsed push.
+ * @param profile The profile of the meter.
+ * @param channel The uplink channel of the meter.
+ * @param scaled true to emit numeric values as fixed-point values with unit, false to emit the raw values.
+ * @param sink The sink of the records.
+ * @return true if the push has a layout and all records were emitted, false otherwise.
+ */
+bool SmPushExtractor::extract(GbtDataBase const& gbtData, SmProfile const& profile, uint8_t const channel, bool const scaled, SmRecordSink& sink)
+{
+    m_recordCount = 0;
+
+    bool complete = sink.addRecordTime(channel, gbtData.getDateTime().asUnixTimeStamp());
+
+    if(!m_pushLayout.update(gbtData, profile))
+    {
+        return false;
+    }
+
+    // offset of the meter channel to the profile channel, applied to the register channels
+    uint8_t channelOffset = channel - profile.channel;
+
+    uint8_t valueCount = m_pushLayout.getValueCount();
+    uint8_t deviceNameIndex = m_pushLayout.getDeviceNameIndex();
+    uint32_t allowed = m_filter.getAllowed(m_pushLayout);
+
+    for(uint8_t i = 0; i < valueCount; i++)
+    {
+        bool isAllowed = (allowed & (1UL << i)) != 0;
+
+        // a filtered value is not read (it may have been skipped by the parse), the device name is kept even if it is not sent
+        if(!isAllowed && i != deviceNameIndex)
+        {
+            continue;
+        }
+
+        GbtValueBase const* gbtValue = gbtData.getValue(m_pushLayout.getValueIndex(i));
+
+        if(gbtValue == nullptr)
+        {
+            MyLog::log("SMEXTRACT", "Push ends before value %d", i);
+
+            return false;
+        }
+
+        if(i == deviceNameIndex)
+        {
+            copyDeviceName(gbtValue);
+        }
+
+        SmRegister const* smRegister = m_pushLayout.getRegister(i);
+
+        if(smRegister == nullptr || !isAllowed)
+        {
+            continue;
+        }
+
+        uint8_t registerChannel = smRegister->channel + channelOffset;
+
+        int64_t raw;
+
+        if(scaled && SmScaler::getRawValue(gbtValue, raw))
+        {
+            complete &= sink.addRecordScaled(registerChannel, SmScaler::scale(raw, m_pushLayout.getScaler(i), m_pushLayout.getUnit(i)));
+        }
+        else
+        {
+            complete &= sink.addRecordValue(registerChannel, gbtValue);
+        }
+
+        m_recordValues[m_recordCount++] = i;
+    }
+
+    return complete;
+}
+
+/**
+ * @brief Resolves the layout of the push without extracting it (e.g. for the derived values).
+ *
+ * @param gbtData The parsed push.
+ * @param profile The profile of the meter.
+ * @return true if the push has a layout, false otherwise.
+ */
+bool SmPushExtractor::updateLayout(GbtDataBase const& gbtData, SmProfile const& profile)
+{
+    return m_pushLayout.update(gbtData, profile);
+}
+
+/**
+ * @brief Takes the device name from a value.
+ *
+ * @param gbtValue The value with the device name role, an octet string.
+ */
+void SmPushExtractor::copyDeviceName(GbtValueBase const* gbtValue)
+{
+    if(gbtValue->getValueType() != GbtValueBase::GbtValueType::GBTVALUETYPE_OCTETESTRING)
+    {
+        MyLog::log("SMEXTRACT", "Invalid GBT value for the device name, expected string");
+
+        return;
+    }
+
+    strncpy(m_deviceName, static_cast<GbtOctetString const*>(gbtValue)->getStringValue(), MAX_DEVICENAME - 1);
+
+    m_deviceName[MAX_DEVICENAME - 1] = 0;
+}
+
+/**
+ * @brief Forgets the cached layout and the device name (e.g. if the profile changes).
+ */
+void SmPushExtractor::reset()
+{
+    m_pushLayout.reset();
+    m_filter.invalidate();
+
+    m_deviceName[0] = 0;
+    m_recordCount = 0;
+}
+
+/**
+ * @brief Sets the allow-list of the registers which are sent, the others are skipped by the parse.
+ *
+ * @param codes The OBIS codes of the registers.
+ * @param count The number of OBIS codes, 0 sends all registers of the profile.
+ * @return true if the allow-list was taken, false if it is too long (all registers are sent).
+ */
+bool SmPushExtractor::selectFilter(uint8_t const (*codes)[SmRegisterFilter::OBIS_SIZE], uint8_t const count)
+{
+    return m_filter.select(codes, count);
+}
+
+/**
+ * @brief Gets the layout of the last push.
+ *
+ * @return The cached push layout.
+ */
+SmPushLayout const& SmPushExtractor::getLayout() const
+{
+    return m_pushLayout;
+}
+
+/**
+ * @brief Gets the device name.
+ *
+ * @return The device name of the last push with a device name, empty if there was none.
+ */
+char const* SmPushExtractor::getDeviceName() const
+{
+    return m_deviceName;
+}
+
+/**
+ * @brief Gets the number of value records of the last push.
+ *
+ * @return The number of records (without the time stamp).
+ */
+uint8_t SmPushExtractor::getRecordCount() const
+{
+    return m_recordCount;
+}
+
+/**
+ * @brief Gets the value of the push layout of each value record emitted for the last push.
+ *
+ * The records follow the time stamp in the order of the push (see getRecordCount).
+ *
+ * @return The index of the value within the push layout for each record.
+ */
+uint8_t const* SmPushExtractor::getRecordValues() const
+{
+    return m_recordValues;
+}
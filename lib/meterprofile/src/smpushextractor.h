@@ -0,0 +1,52 @@
+/**
+ * @file smpushextractor.h
+ * @brief This file contains the declaration of the SmPushExtractor class.
+ *
+ * Extracts a parsed push in one pass over the values of the cached push layout: the device name and the time
+ * stamp are taken while the uplink records of the profile registers are emitted into a record sink. Each value
+ * is visited once, the work per push is linear in the number of values (at most SmPushLayout::MAX_PUSHVALUES).
+ * The layout is only resolved again if the descriptors or the profile change. Values filtered by the register
+ * filter (see SmRegisterFilter) are skipped by the parse of the push (see parse), they are neither stored nor
+ * formatted.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "gbtdata.h"
+#include "smprofile.h"
+#include "smpushlayout.h"
+#include "smrecordsink.h"
+#include "smregisterfilter.h"
+
+class SmPushExtractor
+{
+    public:
+        static uint8_t const MAX_DEVICENAME = 64;                                                   // maximum length of the device name
+
+        int parse(GbtDataBase& gbtData, uint8_t const* data, size_t const size, SmProfile const& profile);  // parses the push, the values filtered out are skipped
+        bool extract(GbtDataBase const& gbtData, SmProfile const& profile, uint8_t const channel, bool const scaled, SmRecordSink& sink);    // one pass over the push, false if it has no layout or a record failed
+        bool updateLayout(GbtDataBase const& gbtData, SmProfile const& profile);                    // resolves the layout of the push if it changed, false if it has no layout
+        void reset();                                                                               // forgets the cached layout and the device name
+        bool selectFilter(uint8_t const (*codes)[SmRegisterFilter::OBIS_SIZE], uint8_t const count);    // sets the OBIS codes of the registers which are sent, 0 for all
+        SmPushLayout const& getLayout() const;                                                      // layout of the last push
+        char const* getDeviceName() const;                                                          // device name of the last push with a device name
+        uint8_t getRecordCount() const;                                                             // number of value records emitted for the last push
+        uint8_t const* getRecordValues() const;                                                     // index of the value within the push layout of each value record
+
+    private:
+        SmPushLayout m_pushLayout;                                                                  // cached layout of the push
+        SmRegisterFilter m_filter;                                                                  // allow-list of the registers, compiled over the cached layout
+        GbtValueMask m_skipMask;                                                                    // values of the GbtData filtered out, skipped by the parse
+        char m_deviceName[MAX_DEVICENAME] = "";                                                     // logical device name of the meter
+        uint8_t m_recordCount = 0;                                                                  // value records of the last push
+        uint8_t m_recordValues[SmPushLayout::MAX_PUSHVALUES];                                       // value of the push layout of each value record
+
+        void copyDeviceName(GbtValueBase const* gbtValue);                                          // takes the device name from an octet string value
+        void compileSkipMask();                                                                     // marks the values of the cached layout which are filtered out
+};
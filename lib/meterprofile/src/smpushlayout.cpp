@@ -0,0 +1,562 @@
+/**
+ * @file smpushlayout.cpp
+ * @brief Implementation of the SmPushLayout class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include <string.h>
+
+#include "gbtuint8.h"
+#include "gbtuint16.h"
+#include "gbtoctetstring.h"
+#include "mylog.h"
+#include "smpushlayout.h"
+
+/**
+ * @brief Forgets the cached layout, the next update resolves the descriptors again.
+ */
+void SmPushLayout::reset()
+{
+    m_profile = nullptr;
+    m_hash = 0;
+    m_firstValueIndex = 0;
+    m_valueCount = 0;
+    m_deviceNameIndex = MAX_PUSHVALUES;
+    m_descriptorOffset = 0;
+    m_descriptorSize = 0;
+}
+
+/**
+ * @brief Adds a word to the hash (FNV-1a step on 32 bit words instead of octets).
+ *
+ * @param hash The current hash.
+ * @param word The word to add.
+ * @return The new hash.
+ */
+uint32_t SmPushLayout::hashAdd(uint32_t hash, uint32_t const word)
+{
+    return (hash ^ word) * FNV_PRIME;
+}
+
+/**
+ * @brief Adds a string to the hash, four characters per step.
+ *
+ * The descriptors are hashed if their raw octets changed, processing words keeps this cheaper than the byte wise loop.
+ *
+ * @param hash The current hash.
+ * @param data The characters to add.
+ * @param length The number of characters.
+ * @return The new hash.
+ */
+uint32_t SmPushLayout::hashAdd(uint32_t hash, char const* data, size_t const length)
+{
+    size_t offset = 0;
+
+    for(; offset + sizeof(uint32_t) <= length; offset += sizeof(uint32_t))
+    {
+        uint32_t word;
+
+        memcpy(&word, data + offset, sizeof(word));
+
+        hash = hashAdd(hash, word);
+    }
+
+    uint32_t tail = length;
+
+    for(; offset < length; offset++)
+    {
+        tail = (tail << 8) | (uint8_t) data[offset];
+    }
+
+    return hashAdd(hash, tail);
+}
+
+/**
+ * @brief Checks if the four values at index form a complete descriptor of the push object list.
+ *
+ * @param gbtData The parsed push.
+ * @param index Index of the first value (class id).
+ * @return true if the values are class id (uint16), OBIS code (octet string), attribute index (uint8) and data index (uint16).
+ */
+bool SmPushLayout::isDescriptor(GbtDataBase const& gbtData, uint8_t const index) const
+{
+    if(index + DESCRIPTOR_VALUES > gbtData.getValueCount())
+    {
+        return false;
+    }
+
+    for(uint8_t i = 0; i < DESCRIPTOR_VALUES; i++)
+    {
+        if(gbtData.getValue(index + i) == nullptr)
+        {
+            return false;
+        }
+    }
+
+    auto const* classId = gbtData.getValue(index);
+
+    return classId->getStructureIdent() == DESCRIPTOR_STRUCTURE_IDENT
+        && classId->getValueType() == GbtValueBase::GbtValueType::GBTVALUETYPE_UINT16
+        && gbtData.getValue(index + 1)->getValueType() == GbtValueBase::GbtValueType::GBTVALUETYPE_OCTETESTRING
+        && gbtData.getValue(index + 2)->getValueType() == GbtValueBase::GbtValueType::GBTVALUETYPE_UINT8
+        && gbtData.getValue(index + 3)->getValueType() == GbtValueBase::GbtValueType::GBTVALUETYPE_UINT16;
+}
+
+/**
+ * @brief Hashes the class ids, OBIS codes and attributes of the descriptors at the start of the push.
+ *
+ * The hash stops at the first value which is not part of a descriptor (or was skipped by the parse).
+ *
+ * @param gbtData The parsed push.
+ * @param firstValueIndex Set to the index of the first value after the descriptors.
+ * @return The hash of the descriptors.
+ */
+uint32_t SmPushLayout::hashDescriptors(GbtDataBase const& gbtData, uint8_t& firstValueIndex)
+{
+    uint8_t valueCount = gbtData.getValueCount();
+    uint32_t hash = FNV_OFFSET_BASIS;
+    uint8_t index = 0;
+
+    for(; index + DESCRIPTOR_VALUES <= valueCount; index += DESCRIPTOR_VALUES)
+    {
+        auto const* classId = gbtData.getValue(index);
+        auto const* obis = gbtData.getValue(index + 1);
+        auto const* attribute = gbtData.getValue(index + 2);
+
+        if(classId == nullptr || obis == nullptr || attribute == nullptr
+            || classId->getStructureIdent() != DESCRIPTOR_STRUCTURE_IDENT
+            || classId->getValueType() != GbtValueBase::GbtValueType::GBTVALUETYPE_UINT16
+            || obis->getValueType() != GbtValueBase::GbtValueType::GBTVALUETYPE_OCTETESTRING
+            || attribute->getValueType() != GbtValueBase::GbtValueType::GBTVALUETYPE_UINT8)
+        {
+            break;
+        }
+
+        auto const* obisString = static_cast<GbtOctetString const*>(obis);
+
+        // the class id and the attribute decide how the value is resolved (scaler_unit, push object list)
+        hash = hashAdd(hash, ((uint32_t) static_cast<GbtUint16 const*>(classId)->getValue() << 8)
+            | static_cast<GbtUint8 const*>(attribute)->getValue());
+        hash = hashAdd(hash, obisString->getStringValue(), obisString->getStringLength());
+    }
+
+    firstValueIndex = index;
+
+    return hash;
+}
+
+/**
+ * @brief Gets the number of octets of the PDU header (long invoke id and date time) in front of the descriptors.
+ *
+ * The same header elements as GbtParser::parse, the long invoke id is only recognised as first octet.
+ *
+ * @param pdu The parsed PDU.
+ * @param size The size of the PDU.
+ * @return The offset of the first descriptor octet.
+ */
+size_t SmPushLayout::getHeaderSize(uint8_t const* pdu, size_t const size)
+{
+    size_t offset = 0;
+
+    if(size >= PDU_LONGINVOKEID_SIZE && pdu[0] == PDU_LONGINVOKEID)
+    {
+        offset = PDU_LONGINVOKEID_SIZE;
+    }
+
+    if(offset + PDU_DATETIME_SIZE <= size && pdu[offset] == PDU_DATETIME)
+    {
+        offset += PDU_DATETIME_SIZE;
+    }
+
+    return offset;
+}
+
+/**
+ * @brief Keeps the raw octets of the descriptors of the resolved push for the cache check.
+ *
+ * The elements are walked with the sizes of GbtParser::parse until the first value after the descriptors. Any other
+ * element (e.g. an unknown identifier) or descriptors larger than MAX_DESCRIPTOR_BYTES keep nothing, the push is
+ * then checked by the hash only.
+ *
+ * @param gbtData The parsed push, its PDU is still unchanged.
+ */
+void SmPushLayout::keepDescriptorBytes(GbtDataBase const& gbtData)
+{
+    uint8_t const* pdu = gbtData.getPdu();
+    size_t size = gbtData.getPduSize();
+
+    m_descriptorSize = 0;
+
+    if(pdu == nullptr)
+    {
+        return;
+    }
+
+    size_t start = getHeaderSize(pdu, size);
+    size_t offset = start;
+    uint8_t valueCount = 0;
+
+    while(valueCount < m_firstValueIndex && offset < size)
+    {
+        uint8_t identifier = pdu[offset];
+
+        // structure and array (no value), uint16, uint8 and enum, uint32, octet string
+        if(identifier == 0x02 || identifier == 0x01)
+        {
+            offset += 2;
+
+            continue;
+        }
+
+        if(identifier == 0x12)
+        {
+            offset += 3;
+        }
+        else if(identifier == 0x0f || identifier == 0x16)
+        {
+            offset += 2;
+        }
+        else if(identifier == 0x06)
+        {
+            offset += 5;
+        }
+        else if(identifier == 0x09 && offset + 1 < size)
+        {
+            offset += 2 + pdu[offset + 1];
+        }
+        else
+        {
+            return;
+        }
+
+        valueCount++;
+    }
+
+    if(valueCount != m_firstValueIndex || offset > size || offset - start > MAX_DESCRIPTOR_BYTES)
+    {
+        return;
+    }
+
+    memcpy(m_descriptorBytes, pdu + start, offset - start);
+
+    m_descriptorOffset = (uint16_t) start;
+    m_descriptorSize = (uint16_t) (offset - start);
+}
+
+/**
+ * @brief Compares the raw descriptors of the push with the octets kept for the cached layout.
+ *
+ * Same profile, same header size and the same descriptor octets parse into the same descriptor values, the cached
+ * layout is valid without hashing the formatted OBIS codes.
+ *
+ * @param gbtData The parsed push, its PDU is still unchanged.
+ * @param profile The profile of the meter.
+ * @return true if the raw descriptors are the kept ones, false if they differ or none are kept.
+ */
+bool SmPushLayout::isCached(GbtDataBase const& gbtData, SmProfile const& profile) const
+{
+    uint8_t const* pdu = gbtData.getPdu();
+    size_t size = gbtData.getPduSize();
+
+    return m_descriptorSize > 0 && m_profile == &profile && pdu != nullptr
+        && (size_t) m_descriptorOffset + m_descriptorSize <= size
+        && gbtData.getValueCount() >= m_firstValueIndex
+        && getHeaderSize(pdu, size) == m_descriptorOffset
+        && memcmp(pdu + m_descriptorOffset, m_descriptorBytes, m_descriptorSize) == 0;
+}
+
+/**
+ * @brief Checks if the cached layout describes the push, without resolving it.
+ *
+ * Used for a push parsed with skipped values, which cannot be resolved: if the descriptors changed the push has
+ * to be parsed completely.
+ *
+ * @param gbtData The parsed push.
+ * @param profile The profile of the meter.
+ * @return true if the descriptors and the profile are the ones of the cached layout, false otherwise.
+ */
+bool SmPushLayout::matches(GbtDataBase const& gbtData, SmProfile const& profile) const
+{
+    if(isCached(gbtData, profile))
+    {
+        return true;
+    }
+
+    uint8_t index;
+    uint32_t hash = hashDescriptors(gbtData, index);
+
+    return index > 0 && hash == m_hash && m_profile == &profile && m_firstValueIndex == index;
+}
+
+/**
+ * @brief Resolves the layout of the push against the profile.
+ *
+ * Every push is checked against the raw descriptor octets of the cached layout, only if they differ the hash over
+ * the class ids, OBIS codes and attributes of the descriptors is computed. The descriptors are only validated and resolved (data indexes, profile registers and scaler_unit) if the hash or the
+ * profile changed. The descriptor of the push object list itself (push setup, attribute 2) has no value, it is the
+ * descriptor array.
+ *
+ * @param gbtData The parsed push.
+ * @param profile The profile of the meter.
+ * @return true if the push has a layout, false if there are no descriptors (nothing is sent).
+ */
+bool SmPushLayout::update(GbtDataBase const& gbtData, SmProfile const& profile)
+{
+    if(isCached(gbtData, profile))
+    {
+        return true;
+    }
+
+    uint8_t index;
+    uint32_t hash = hashDescriptors(gbtData, index);
+
+    // same descriptors and profile, the cached layout is still valid (e.g. only the data indexes changed)
+    if(index > 0 && hash == m_hash && m_profile == &profile && m_firstValueIndex == index)
+    {
+        keepDescriptorBytes(gbtData);
+
+        return true;
+    }
+
+    reset();
+
+    // validate the descriptors before they are used
+    while(isDescriptor(gbtData, m_firstValueIndex))
+    {
+        m_firstValueIndex += DESCRIPTOR_VALUES;
+    }
+
+    if(m_firstValueIndex == 0 || m_firstValueIndex != index)
+    {
+        MyLog::log("SMLAYOUT", "Push without valid descriptors");
+
+        reset();
+
+        return false;
+    }
+
+    MyLog::log("SMLAYOUT", "Resolve push layout for profile %s, hash %lu", profile.name, (unsigned long) hash);
+
+    m_profile = &profile;
+    m_hash = hash;
+
+    resolve(gbtData, profile);
+    keepDescriptorBytes(gbtData);
+
+    return true;
+}
+
+/**
+ * @brief Checks if the attribute of the interface class is a scaler_unit.
+ *
+ * @param classId The interface class.
+ * @param attribute The attribute index.
+ * @return true for the scaler_unit of the register, extended register and demand register.
+ */
+bool SmPushLayout::isScalerUnit(uint16_t const classId, uint8_t const attribute)
+{
+    return ((classId == CLASSID_REGISTER || classId == CLASSID_EXTENDEDREGISTER) && attribute == ATTRIBUTE_SCALERUNIT)
+        || (classId == CLASSID_DEMANDREGISTER && attribute == ATTRIBUTE_DEMANDSCALERUNIT);
+}
+
+/**
+ * @brief Resolves the registers, scalers and units of the validated descriptors.
+ *
+ * Scalar values take one value of the GbtData, a pushed scaler_unit is a structure and takes two values. It is
+ * not sent, it overrides the scaler and the unit of the value with the same OBIS code.
+ *
+ * @param gbtData The parsed push.
+ * @param profile The profile of the meter.
+ */
+void SmPushLayout::resolve(GbtDataBase const& gbtData, SmProfile const& profile)
+{
+    uint8_t gbtValueIndex = m_firstValueIndex;
+
+    for(uint8_t descriptor = 0; descriptor < m_firstValueIndex && m_valueCount < MAX_PUSHVALUES; descriptor += DESCRIPTOR_VALUES)
+    {
+        uint16_t classId = static_cast<GbtUint16 const*>(gbtData.getValue(descriptor))->getValue();
+        uint8_t attribute = static_cast<GbtUint8 const*>(gbtData.getValue(descriptor + 2))->getValue();
+
+        if(classId == CLASSID_PUSHSETUP && attribute == ATTRIBUTE_PUSHOBJECTLIST)
+        {
+            continue;
+        }
+
+        if(isScalerUnit(classId, attribute))
+        {
+            gbtValueIndex += SCALERUNIT_VALUES;
+
+            continue;
+        }
+
+        auto const* obis = static_cast<GbtOctetString const*>(gbtData.getValue(descriptor + 1));
+        SmRegister const* smRegister = profile.findRegister(obis->getStringValue());
+
+        if(smRegister != nullptr && smRegister->role == SmRegisterRole::SMREGISTER_DEVICENAME)
+        {
+            m_deviceNameIndex = m_valueCount;
+        }
+
+        m_registerIndex[m_valueCount] = smRegister != nullptr ? (uint8_t) (smRegister - profile.registers) : NO_REGISTER;
+        m_gbtValueIndex[m_valueCount] = gbtValueIndex++;
+        m_descriptorIndex[m_valueCount] = descriptor;
+        m_scaler[m_valueCount] = smRegister != nullptr ? smRegister->scaler : 0;
+        m_unit[m_valueCount] = smRegister != nullptr ? smRegister->unit : SmUnit::SMUNIT_NONE;
+
+        m_valueCount++;
+    }
+
+    // second pass, the scaler_unit may be pushed before or after its value
+    gbtValueIndex = m_firstValueIndex;
+
+    for(uint8_t descriptor = 0; descriptor < m_firstValueIndex; descriptor += DESCRIPTOR_VALUES)
+    {
+        uint16_t classId = static_cast<GbtUint16 const*>(gbtData.getValue(descriptor))->getValue();
+        uint8_t attribute = static_cast<GbtUint8 const*>(gbtData.getValue(descriptor + 2))->getValue();
+
+        if(classId == CLASSID_PUSHSETUP && attribute == ATTRIBUTE_PUSHOBJECTLIST)
+        {
+            continue;
+        }
+
+        if(!isScalerUnit(classId, attribute))
+        {
+            gbtValueIndex++;
+
+            continue;
+        }
+
+        applyScalerUnit(gbtData, static_cast<GbtOctetString const*>(gbtData.getValue(descriptor + 1))->getStringValue(), gbtValueIndex);
+
+        gbtValueIndex += SCALERUNIT_VALUES;
+    }
+}
+
+/**
+ * @brief Overrides the scaler and the unit of the value with the OBIS code by the pushed scaler_unit.
+ *
+ * @param gbtData The parsed push.
+ * @param obis The OBIS code of the scaler_unit descriptor.
+ * @param gbtValueIndex Index of the scaler within the GbtData, the unit follows.
+ */
+void SmPushLayout::applyScalerUnit(GbtDataBase const& gbtData, char const* obis, uint8_t const gbtValueIndex)
+{
+    GbtValueBase const* scaler = gbtData.getValue(gbtValueIndex);
+    GbtValueBase const* unit = gbtData.getValue(gbtValueIndex + 1);
+
+    if(scaler == nullptr || unit == nullptr
+        || scaler->getValueType() != GbtValueBase::GbtValueType::GBTVALUETYPE_UINT8
+        || unit->getValueType() != GbtValueBase::GbtValueType::GBTVALUETYPE_UINT8)
+    {
+        MyLog::log("SMLAYOUT", "Invalid scaler_unit for %s", obis);
+
+        return;
+    }
+
+    for(uint8_t i = 0; i < m_valueCount; i++)
+    {
+        auto const* valueObis = static_cast<GbtOctetString const*>(gbtData.getValue(m_descriptorIndex[i] + 1));
+
+        if(strcmp(valueObis->getStringValue(), obis) != 0)
+        {
+            continue;
+        }
+
+        // the scaler is a signed integer, the parser delivers it as uint8
+        m_scaler[i] = static_cast<int8_t>(static_cast<GbtUint8 const*>(scaler)->getValue());
+        m_unit[i] = static_cast<SmUnit>(static_cast<GbtUint8 const*>(unit)->getValue());
+
+        MyLog::log("SMLAYOUT", "Pushed scaler %d, unit %d for %s", m_scaler[i], (int) m_unit[i], obis);
+    }
+}
+
+/**
+ * @brief Gets the hash over the descriptors of the push (changes if the meter sends another layout).
+ *
+ * @return The FNV-1a hash of the resolved descriptors.
+ */
+uint32_t SmPushLayout::getHash() const
+{
+    return m_hash;
+}
+
+/**
+ * @brief Gets the index of the first value within the GbtData.
+ *
+ * @return The number of descriptor values in front of the values.
+ */
+uint8_t SmPushLayout::getFirstValueIndex() const
+{
+    return m_firstValueIndex;
+}
+
+/**
+ * @brief Gets the number of values described by the layout.
+ *
+ * @return The number of values.
+ */
+uint8_t SmPushLayout::getValueCount() const
+{
+    return m_valueCount;
+}
+
+/**
+ * @brief Gets the index of the value with the device name (resolved with the layout).
+ *
+ * @return The value index, MAX_PUSHVALUES if the push has no device name.
+ */
+uint8_t SmPushLayout::getDeviceNameIndex() const
+{
+    return m_deviceNameIndex;
+}
+
+/**
+ * @brief Gets the index of a value within the GbtData.
+ *
+ * @param valueIndex Index of the value (0 is the first value after the descriptors), must be smaller than getValueCount().
+ * @return The index for GbtDataBase::getValue.
+ */
+uint8_t SmPushLayout::getValueIndex(uint8_t const valueIndex) const
+{
+    return m_gbtValueIndex[valueIndex];
+}
+
+/**
+ * @brief Gets the scaler of a value, from the profile or the pushed scaler_unit.
+ *
+ * @param valueIndex Index of the value, must be smaller than getValueCount().
+ * @return The scaler (value = raw * 10^scaler).
+ */
+int8_t SmPushLayout::getScaler(uint8_t const valueIndex) const
+{
+    return m_scaler[valueIndex];
+}
+
+/**
+ * @brief Gets the unit of a value, from the profile or the pushed scaler_unit.
+ *
+ * @param valueIndex Index of the value, must be smaller than getValueCount().
+ * @return The unit.
+ */
+SmUnit SmPushLayout::getUnit(uint8_t const valueIndex) const
+{
+    return m_unit[valueIndex];
+}
+
+/**
+ * @brief Gets the register of a value.
+ *
+ * @param valueIndex Index of the value (0 is the first value after the descriptors).
+ * @return The register, nullptr if the value is not sent or the index is out of range.
+ */
+SmRegister const* SmPushLayout::getRegister(uint8_t const valueIndex) const
+{
+    if(valueIndex >= m_valueCount || m_registerIndex[valueIndex] == NO_REGISTER)
+    {
+        return nullptr;
+    }
+
+    return &m_profile->registers[m_registerIndex[valueIndex]];
+}
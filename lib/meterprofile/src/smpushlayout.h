@@ -0,0 +1,86 @@
+/**
+ * @file smpushlayout.h
+ * @brief This file contains the declaration of the SmPushLayout class.
+ *
+ * A GBT push starts with the push object list, one descriptor (class id, OBIS code, attribute index,
+ * data index) for each element of the push, followed by the values in the same order. The SmPushLayout
+ * resolves the descriptors once against the meter profile and keeps the register, the scaler and the unit of
+ * every value. A pushed scaler_unit attribute overrides the scaler and unit of the profile.
+ * The layout is cached, it is only resolved again if the descriptors (layout hash) or the profile change.
+ * The raw octets of the resolved descriptors are kept as well, a push with the same octets is checked by a memcmp
+ * instead of hashing its formatted OBIS codes again. The hash is the fallback if the octets differ or do not fit.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "gbtdata.h"
+#include "smprofile.h"
+
+class SmPushLayout
+{
+    public:
+        static uint8_t const MAX_PUSHVALUES = 32;                                                   // maximum number of values in a push
+
+        bool update(GbtDataBase const& gbtData, SmProfile const& profile);                          // resolves the layout of the push if it changed, false if the push has no descriptors
+        bool matches(GbtDataBase const& gbtData, SmProfile const& profile) const;                   // checks if the cached layout describes the push
+        void reset();                                                                               // forgets the cached layout
+        uint32_t getHash() const;                                                                   // hash over the descriptors of the push
+        uint8_t getFirstValueIndex() const;                                                         // index of the first value (after the descriptors) within the GbtData
+        uint8_t getValueCount() const;                                                              // number of values described by the layout
+        SmRegister const* getRegister(uint8_t const valueIndex) const;                              // register of the value, nullptr if the value is not sent
+        uint8_t getValueIndex(uint8_t const valueIndex) const;                                      // index of the value within the GbtData
+        int8_t getScaler(uint8_t const valueIndex) const;                                           // scaler of the value (value = raw * 10^scaler)
+        SmUnit getUnit(uint8_t const valueIndex) const;                                             // unit of the value
+        uint8_t getDeviceNameIndex() const;                                                         // index of the device name value, MAX_PUSHVALUES if the push has none
+
+    private:
+        static uint8_t const NO_REGISTER = 0xff;                                                    // value without register in the profile
+        static uint8_t const DESCRIPTOR_VALUES = 4;                                                 // class id, OBIS code, attribute index, data index
+        static uint8_t const DESCRIPTOR_STRUCTURE_IDENT = 4;                                        // structure identifier of the first descriptor value
+        static uint16_t const CLASSID_PUSHSETUP = 40;                                               // interface class of the push setup
+        static uint8_t const ATTRIBUTE_PUSHOBJECTLIST = 2;                                          // attribute of the push object list (the descriptor array itself)
+        static uint16_t const CLASSID_REGISTER = 3;                                                 // interface class of the register
+        static uint16_t const CLASSID_EXTENDEDREGISTER = 4;                                         // interface class of the extended register
+        static uint16_t const CLASSID_DEMANDREGISTER = 5;                                           // interface class of the demand register
+        static uint8_t const ATTRIBUTE_SCALERUNIT = 3;                                              // scaler_unit attribute of the (extended) register
+        static uint8_t const ATTRIBUTE_DEMANDSCALERUNIT = 4;                                        // scaler_unit attribute of the demand register
+        static uint8_t const SCALERUNIT_VALUES = 2;                                                 // a scaler_unit is a structure of scaler and unit
+        static uint32_t const FNV_OFFSET_BASIS = 2166136261u;                                       // FNV-1a constants (word wise hash of the descriptors)
+        static uint32_t const FNV_PRIME = 16777619u;
+        static size_t const MAX_DESCRIPTOR_BYTES = 320;                                             // raw descriptor octets kept for the cache check (E450: 274)
+        static uint8_t const PDU_LONGINVOKEID = 0x0f;                                               // PDU header: long invoke id and priority (first octet only)
+        static size_t const PDU_LONGINVOKEID_SIZE = 5;
+        static uint8_t const PDU_DATETIME = 0x0c;                                                   // PDU header: date and time
+        static size_t const PDU_DATETIME_SIZE = 13;
+
+        SmProfile const* m_profile = nullptr;                                                       // profile the layout was resolved for
+        uint32_t m_hash = 0;                                                                        // hash of the resolved descriptors
+        uint8_t m_firstValueIndex = 0;                                                              // index of the first value within the GbtData
+        uint8_t m_valueCount = 0;                                                                   // number of values described
+        uint8_t m_deviceNameIndex = MAX_PUSHVALUES;                                                 // index of the value with the device name role
+        uint16_t m_descriptorOffset = 0;                                                            // offset of the raw descriptors within the PDU
+        uint16_t m_descriptorSize = 0;                                                              // number of raw descriptor octets kept, 0 if only the hash is checked
+        uint8_t m_descriptorBytes[MAX_DESCRIPTOR_BYTES];                                            // raw descriptor octets of the resolved push
+        uint8_t m_registerIndex[MAX_PUSHVALUES];                                                    // register index in the profile for each value (NO_REGISTER if not sent)
+        uint8_t m_gbtValueIndex[MAX_PUSHVALUES];                                                    // index of each value within the GbtData
+        uint8_t m_descriptorIndex[MAX_PUSHVALUES];                                                  // index of the descriptor (class id) of each value within the GbtData
+        int8_t m_scaler[MAX_PUSHVALUES];                                                            // scaler of each value
+        SmUnit m_unit[MAX_PUSHVALUES];                                                              // unit of each value
+
+        bool isDescriptor(GbtDataBase const& gbtData, uint8_t const index) const;                   // checks if the values at index form a descriptor
+        bool isCached(GbtDataBase const& gbtData, SmProfile const& profile) const;                  // compares the raw descriptors of the push with the kept ones
+        void keepDescriptorBytes(GbtDataBase const& gbtData);                                       // keeps the raw descriptor octets of the resolved push
+        void resolve(GbtDataBase const& gbtData, SmProfile const& profile);                         // resolves the registers, scalers and units of the descriptors
+        void applyScalerUnit(GbtDataBase const& gbtData, char const* obis, uint8_t const gbtValueIndex);   // overrides scaler and unit of the value with the OBIS code
+        static bool isScalerUnit(uint16_t const classId, uint8_t const attribute);                  // checks if the attribute is a scaler_unit
+        static uint32_t hashDescriptors(GbtDataBase const& gbtData, uint8_t& firstValueIndex);      // hash of the descriptors and the index of the first value
+        static size_t getHeaderSize(uint8_t const* pdu, size_t const size);                         // number of octets in front of the descriptors
+        static uint32_t hashAdd(uint32_t hash, uint32_t const word);                                // adds a word to the hash
+        static uint32_t hashAdd(uint32_t hash, char const* data, size_t const length);              // adds a string to the hash
+};
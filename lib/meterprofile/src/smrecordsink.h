@@ -0,0 +1,27 @@
+/**
+ * @file smrecordsink.h
+ * @brief This file contains the declaration of the SmRecordSink interface.
+ *
+ * The uplink records of a push are emitted into a sink while the push is extracted (see SmPushExtractor).
+ * The uplink encoder implements the sink (e.g. SmCayenne), the host tests count or collect the records.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "gbtvaluebase.h"
+#include "smscaler.h"
+
+class SmRecordSink
+{
+    public:
+        virtual ~SmRecordSink() = default;
+        virtual bool addRecordTime(uint8_t const channel, uint32_t const unixTime) = 0;             // adds the time stamp of the push, false if it does not fit
+        virtual bool addRecordValue(uint8_t const channel, GbtValueBase const* gbtValue) = 0;       // adds a raw value, false if it does not fit or is not supported
+        virtual bool addRecordScaled(uint8_t const channel, SmScaledValue const& scaledValue) = 0;  // adds a fixed-point value with unit, false if it does not fit
+};
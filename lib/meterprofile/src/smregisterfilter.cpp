@@ -0,0 +1,140 @@
+/**
+ * @file smregisterfilter.cpp
+ * @brief Implementation of the SmRegisterFilter class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include <string.h>
+
+#include "mylog.h"
+#include "smregisterfilter.h"
+
+/**
+ * @brief Sets the allow-list of OBIS codes.
+ *
+ * @param codes The OBIS codes of the registers which are sent.
+ * @param count The number of OBIS codes, 0 allows all registers.
+ * @return true if the allow-list was taken, false if it has more than MAX_CODES codes (all registers are allowed).
+ */
+bool SmRegisterFilter::select(uint8_t const (*codes)[OBIS_SIZE], uint8_t const count)
+{
+    invalidate();
+
+    if(count > MAX_CODES)
+    {
+        MyLog::log("SMFILTER", "Register filter of %d codes exceeds %d, all registers are sent", count, MAX_CODES);
+
+        m_count = 0;
+
+        return false;
+    }
+
+    for(uint8_t i = 0; i < count; i++)
+    {
+        memcpy(m_codes[i], codes[i], OBIS_SIZE);
+    }
+
+    m_count = count;
+
+    return true;
+}
+
+/**
+ * @brief Checks if the filter has an allow-list.
+ *
+ * @return true if only the registers of the allow-list are sent, false if all registers are sent.
+ */
+bool SmRegisterFilter::isActive() const
+{
+    return m_count > 0;
+}
+
+/**
+ * @brief Gets the number of OBIS codes of the allow-list.
+ *
+ * @return The number of OBIS codes, 0 if all registers are allowed.
+ */
+uint8_t SmRegisterFilter::getCount() const
+{
+    return m_count;
+}
+
+/**
+ * @brief Gets the values of the layout which pass the filter, the bitmap is compiled once per layout.
+ *
+ * @param layout The resolved push layout.
+ * @return The allowed values, bit i for value i of the layout, all bits if the filter is not active.
+ */
+uint32_t SmRegisterFilter::getAllowed(SmPushLayout const& layout)
+{
+    if(!isActive())
+    {
+        return UINT32_MAX;
+    }
+
+    if(!m_compiled || m_layoutHash != layout.getHash())
+    {
+        compile(layout);
+    }
+
+    return m_allowed;
+}
+
+/**
+ * @brief Compiles the bitmap again with the next layout (e.g. if the profile changes).
+ */
+void SmRegisterFilter::invalidate()
+{
+    m_compiled = false;
+    m_allowed = UINT32_MAX;
+}
+
+/**
+ * @brief Resolves the allow-list against the registers of the layout.
+ *
+ * Values without a register are not sent in any case, their bit is cleared.
+ *
+ * @param layout The resolved push layout.
+ */
+void SmRegisterFilter::compile(SmPushLayout const& layout)
+{
+    m_allowed = 0;
+
+    for(uint8_t i = 0; i < layout.getValueCount(); i++)
+    {
+        SmRegister const* smRegister = layout.getRegister(i);
+
+        uint8_t obis[OBIS_SIZE];
+
+        if(smRegister != nullptr && SmProfiles::parseObis(smRegister->obis, obis) && contains(obis))
+        {
+            m_allowed |= 1UL << i;
+        }
+    }
+
+    m_layoutHash = layout.getHash();
+    m_compiled = true;
+
+    MyLog::log("SMFILTER", "Register filter of %d codes allows values %08lx", m_count, (unsigned long) m_allowed);
+}
+
+/**
+ * @brief Checks if an OBIS code is in the allow-list.
+ *
+ * @param obis The fields A to F of the OBIS code.
+ * @return true if the code is in the allow-list, false otherwise.
+ */
+bool SmRegisterFilter::contains(uint8_t const (&obis)[OBIS_SIZE]) const
+{
+    for(uint8_t i = 0; i < m_count; i++)
+    {
+        if(memcmp(m_codes[i], obis, OBIS_SIZE) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
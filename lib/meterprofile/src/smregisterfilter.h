@@ -0,0 +1,42 @@
+/**
+ * @file smregisterfilter.h
+ * @brief This file contains the declaration of the SmRegisterFilter class.
+ *
+ * Most sites need a few of the registers of a push. The filter is an allow-list of OBIS codes, it is compiled
+ * into a bitmap over the values of the cached push layout, so a push is checked with one bit test per value and
+ * a filtered value is skipped by the parse (see SmPushExtractor::parse). The bitmap is only compiled again if
+ * the layout changes. An empty filter allows all registers of the profile.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "smpushlayout.h"
+
+class SmRegisterFilter
+{
+    public:
+        static uint8_t const MAX_CODES = 8;                                                         // maximum number of OBIS codes of the allow-list
+        static uint8_t const OBIS_SIZE = 6;                                                         // fields A to F of an OBIS code
+
+        bool select(uint8_t const (*codes)[OBIS_SIZE], uint8_t const count);                        // sets the allow-list, false if it is too long (all registers are allowed)
+        bool isActive() const;                                                                      // checks if the filter has an allow-list
+        uint8_t getCount() const;                                                                   // number of OBIS codes of the allow-list
+        uint32_t getAllowed(SmPushLayout const& layout);                                            // values of the layout which pass the filter (bit per value)
+        void invalidate();                                                                          // compiles the bitmap again with the next layout
+
+    private:
+        uint8_t m_codes[MAX_CODES][OBIS_SIZE];                                                      // OBIS codes of the allow-list
+        uint8_t m_count = 0;                                                                        // number of OBIS codes, 0 allows all registers
+        bool m_compiled = false;                                                                    // flag indicating if the bitmap belongs to the layout hash
+        uint32_t m_layoutHash = 0;                                                                  // hash of the layout the bitmap was compiled for
+        uint32_t m_allowed = UINT32_MAX;                                                            // compiled bitmap over the values of the layout
+
+        void compile(SmPushLayout const& layout);                                                   // resolves the allow-list against the registers of the layout
+        bool contains(uint8_t const (&obis)[OBIS_SIZE]) const;                                      // checks if the OBIS code is in the allow-list
+};
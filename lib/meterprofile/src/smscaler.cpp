@@ -0,0 +1,154 @@
+/**
+ * @file smscaler.cpp
+ * @brief Implementation of the SmScaler class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include "gbtuint8.h"
+#include "gbtuint16.h"
+#include "gbtuint32.h"
+#include "smscaler.h"
+
+/**
+ * @brief Powers of ten up to 10^MAX_EXPONENT.
+ */
+static constexpr int64_t SM_POW10[] = {
+    1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL, 1000000000LL
+};
+
+static_assert(sizeof(SM_POW10) / sizeof(int64_t) == SmScaler::MAX_EXPONENT + 1, "one power of ten for each exponent");
+
+/**
+ * @brief Reads the raw numeric value of a GBT value.
+ *
+ * @param gbtValue The GBT value.
+ * @param raw The raw value (unsigned values are extended to 64 bit).
+ * @return true if the value is numeric, false otherwise (e.g. octet strings).
+ */
+bool SmScaler::getRawValue(GbtValueBase const* gbtValue, int64_t& raw)
+{
+    switch(gbtValue->getValueType())
+    {
+        case GbtValueBase::GbtValueType::GBTVALUETYPE_UINT8:
+            raw = static_cast<GbtUint8 const*>(gbtValue)->getValue();
+            return true;
+
+        case GbtValueBase::GbtValueType::GBTVALUETYPE_UINT16:
+            raw = static_cast<GbtUint16 const*>(gbtValue)->getValue();
+            return true;
+
+        case GbtValueBase::GbtValueType::GBTVALUETYPE_UINT32:
+            raw = static_cast<GbtUint32 const*>(gbtValue)->getValue();
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Multiplies with a power of ten.
+ *
+ * @param value The value (raw values are at most 32 bit, the product fits into 64 bit).
+ * @param exponent The exponent, at most MAX_EXPONENT.
+ * @return value * 10^exponent.
+ */
+int64_t SmScaler::multiplyPow10(int64_t const value, uint8_t const exponent)
+{
+    return value * SM_POW10[exponent];
+}
+
+/**
+ * @brief Divides by a power of ten, rounded half away from zero.
+ *
+ * @param value The value.
+ * @param exponent The exponent, at most MAX_EXPONENT.
+ * @return value / 10^exponent.
+ */
+int64_t SmScaler::dividePow10(int64_t const value, uint8_t const exponent)
+{
+    int64_t const half = SM_POW10[exponent] / 2;
+
+    return value >= 0 ? (value + half) / SM_POW10[exponent] : (value - half) / SM_POW10[exponent];
+}
+
+/**
+ * @brief Converts a raw value into a fixed-point value with the given number of decimals.
+ *
+ * E.g. raw 1234 with scaler -2 (12.34 A) and 3 decimals is 12340 (mA). Exponents beyond MAX_EXPONENT are
+ * limited, the result of such a conversion is not meaningful.
+ *
+ * @param raw The raw value.
+ * @param scaler The scaler of the register (value = raw * 10^scaler).
+ * @param decimals Number of decimals of the result.
+ * @return The value in units of 10^-decimals.
+ */
+int64_t SmScaler::toFixedPoint(int64_t const raw, int8_t const scaler, uint8_t const decimals)
+{
+    int16_t exponent = scaler + decimals;
+
+    if(exponent >= 0)
+    {
+        return multiplyPow10(raw, exponent > MAX_EXPONENT ? MAX_EXPONENT : exponent);
+    }
+
+    return dividePow10(raw, -exponent > MAX_EXPONENT ? MAX_EXPONENT : -exponent);
+}
+
+/**
+ * @brief Converts a mantissa to another exponent.
+ *
+ * E.g. 1234 with exponent -2 is 12 with exponent 0. Exponent differences beyond MAX_EXPONENT are limited.
+ *
+ * @param value The mantissa.
+ * @param fromExponent The exponent of the mantissa.
+ * @param toExponent The exponent of the result.
+ * @return The mantissa with the exponent toExponent, rounded half away from zero.
+ */
+int64_t SmScaler::rescale(int64_t const value, int8_t const fromExponent, int8_t const toExponent)
+{
+    int16_t difference = toExponent - fromExponent;
+
+    if(difference >= 0)
+    {
+        return dividePow10(value, difference > MAX_EXPONENT ? MAX_EXPONENT : difference);
+    }
+
+    return multiplyPow10(value, -difference > MAX_EXPONENT ? MAX_EXPONENT : -difference);
+}
+
+/**
+ * @brief Scales a raw value into a fixed-point value with a 32 bit mantissa.
+ *
+ * A positive scaler is multiplied out as long as the mantissa fits, a negative scaler becomes the number of
+ * decimals. The value is exact unless the mantissa does not fit into 32 bit, then decimals are dropped
+ * (rounded) until it does.
+ *
+ * @param raw The raw value.
+ * @param scaler The scaler of the register (value = raw * 10^scaler).
+ * @param unit The unit of the register.
+ * @return The fixed-point value.
+ */
+SmScaledValue SmScaler::scale(int64_t const raw, int8_t const scaler, SmUnit const unit)
+{
+    int64_t mantissa = raw;
+    int8_t exponent = scaler;
+
+    while(exponent > 0 && mantissa <= INT32_MAX / 10 && mantissa >= INT32_MIN / 10)
+    {
+        mantissa = multiplyPow10(mantissa, 1);
+        exponent--;
+    }
+
+    while(mantissa > INT32_MAX || mantissa < INT32_MIN)
+    {
+        mantissa = dividePow10(mantissa, 1);
+        exponent++;
+    }
+
+    SmScaledValue scaledValue = { static_cast<int32_t>(mantissa), exponent, unit };
+
+    return scaledValue;
+}
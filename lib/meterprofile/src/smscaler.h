@@ -0,0 +1,43 @@
+/**
+ * @file smscaler.h
+ * @brief This file contains the declaration of the SmScaler class and the SmScaledValue.
+ *
+ * Converts the raw register values with the scaler and unit of the push layout into fixed-point values.
+ * The conversion uses integer multiplications with powers of ten only, there is no floating point on the device.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "gbtvaluebase.h"
+#include "smprofile.h"
+
+/**
+ * @brief Fixed-point value, value = mantissa * 10^exponent in the unit.
+ */
+struct SmScaledValue
+{
+    int32_t mantissa;                                                                               // fixed-point mantissa
+    int8_t exponent;                                                                                // decimal exponent, -2 means two decimals
+    SmUnit unit;                                                                                    // unit of the value
+};
+
+class SmScaler
+{
+    public:
+        static uint8_t const MAX_EXPONENT = 9;                                                      // largest power of ten applied in one step
+
+        static bool getRawValue(GbtValueBase const* gbtValue, int64_t& raw);                        // reads the raw numeric value, false for strings
+        static int64_t toFixedPoint(int64_t const raw, int8_t const scaler, uint8_t const decimals); // raw * 10^scaler in units of 10^-decimals (rounded)
+        static SmScaledValue scale(int64_t const raw, int8_t const scaler, SmUnit const unit);      // exact fixed-point value which fits into 32 bits
+        static int64_t rescale(int64_t const value, int8_t const fromExponent, int8_t const toExponent);  // mantissa of the same value with another exponent (rounded)
+
+    private:
+        static int64_t multiplyPow10(int64_t const value, uint8_t const exponent);                  // value * 10^exponent
+        static int64_t dividePow10(int64_t const value, uint8_t const exponent);                    // value / 10^exponent, rounded half away from zero
+};
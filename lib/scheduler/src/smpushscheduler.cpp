@@ -0,0 +1,369 @@
+/**
+ * @file smpushscheduler.cpp
+ * @brief Implementation of the SmPushScheduler class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include "mylog.h"
+#include "smpushscheduler.h"
+
+/**
+ * @brief Configures the scheduler.
+ *
+ * @param interval The measure interval, the cycles are scheduled close to it.
+ * @param maxWindow The receive window without prediction (read cycle timeout).
+ * @param leadTime The time from the wake-up till the receive window starts (warm-up of the adapter).
+ */
+void SmPushScheduler::configure(uint32_t const interval, uint32_t const maxWindow, uint32_t const leadTime)
+{
+    m_interval = interval;
+    m_maxWindow = maxWindow;
+    m_leadTime = leadTime;
+}
+
+/**
+ * @brief Forgets the learned period and phase and resets the statistics.
+ */
+void SmPushScheduler::reset()
+{
+    m_period = 0;
+    m_hasArrival = false;
+    m_hasPrediction = false;
+    m_confidence = 0;
+    m_lastError = 0;
+    m_meanError = 0;
+    m_lastOnTime = 0;
+    m_savedOnTime = 0;
+}
+
+/**
+ * @brief Calculates the greatest common divisor.
+ *
+ * @param a The first value.
+ * @param b The second value.
+ * @return The greatest common divisor, the other value if one is 0.
+ */
+uint32_t SmPushScheduler::gcd(uint32_t a, uint32_t b)
+{
+    while(b != 0)
+    {
+        uint32_t remainder = a % b;
+
+        a = b;
+        b = remainder;
+    }
+
+    return a;
+}
+
+/**
+ * @brief Records the start of a read cycle (the adapter is switched on).
+ *
+ * @param now The local time.
+ */
+void SmPushScheduler::cycleStarted(uint32_t const now)
+{
+    m_cycleStart = now;
+}
+
+/**
+ * @brief Learns from a received push.
+ *
+ * The arrival is compared with the closest push of the prediction (the read cycle takes the first push in the
+ * window, not necessarily the predicted one), a close arrival raises the confidence. The difference of the
+ * meter times to the last push is a multiple of the push period, the period is the greatest common divisor
+ * of these differences. A divisor below MIN_PERIOD means the timestamps are not periodic (e.g. jitter), the
+ * learning starts over with the last difference.
+ *
+ * @param arrival The local time the push was received.
+ * @param meterTime The time stamp of the push in s (meter time), 0 if the push has no time stamp.
+ */
+void SmPushScheduler::pushReceived(uint32_t const arrival, uint32_t const meterTime)
+{
+    if(m_hasPrediction)
+    {
+        int32_t period = m_period * 1000;
+
+        // error to the closest push, between -period/2 and period/2
+        int32_t error = static_cast<int32_t>(arrival - m_predicted) % period;
+
+        if(error > period / 2)
+        {
+            error -= period;
+        }
+        else if(error < -period / 2)
+        {
+            error += period;
+        }
+
+        m_lastError = error;
+
+        uint32_t absoluteError = m_lastError < 0 ? -static_cast<int64_t>(m_lastError) : m_lastError;
+
+        m_meanError = (3 * static_cast<uint64_t>(m_meanError) + absoluteError) / 4;
+
+        if(absoluteError <= getReceiveWindow() / 4)
+        {
+            if(m_confidence < MAX_CONFIDENCE)
+            {
+                m_confidence++;
+            }
+        }
+        else if(m_confidence > 0)
+        {
+            m_confidence--;
+        }
+
+        MyLog::log("SCHEDULER", "Push arrived %ld ms after the prediction, confidence %d", (long) m_lastError, m_confidence);
+    }
+
+    if(m_hasArrival && m_lastMeterTime != 0 && meterTime > m_lastMeterTime)
+    {
+        uint32_t period = gcd(m_period, meterTime - m_lastMeterTime);
+
+        if(period < MIN_PERIOD)
+        {
+            MyLog::log("SCHEDULER", "Push times not periodic, restart learning");
+
+            period = meterTime - m_lastMeterTime;
+
+            m_confidence = 0;
+        }
+
+        // the errors against another period are not comparable
+        if(period != m_period)
+        {
+            MyLog::log("SCHEDULER", "Push period learned %lu s", (unsigned long) period);
+
+            m_meanError = 0;
+        }
+
+        m_period = period;
+    }
+
+    m_hasArrival = true;
+    m_lastArrival = arrival;
+    m_lastMeterTime = meterTime;
+}
+
+/**
+ * @brief Records a cycle without push, the window is opened to the full read cycle timeout.
+ */
+void SmPushScheduler::pushMissed()
+{
+    MyLog::log("SCHEDULER", "Push missed, confidence reset");
+
+    m_confidence = 0;
+}
+
+/**
+ * @brief Records the end of a read cycle (the adapter is switched off).
+ *
+ * The saved on time is estimated against a cycle which wakes without knowing the phase, it waits half a period
+ * on average (at most the read cycle timeout) after the warm-up.
+ *
+ * @param now The local time.
+ */
+void SmPushScheduler::cycleEnded(uint32_t const now)
+{
+    m_lastOnTime = now - m_cycleStart;
+
+    if(!isLearned())
+    {
+        return;
+    }
+
+    uint32_t halfPeriod = m_period * 500;
+
+    uint32_t unscheduledOnTime = m_leadTime + (halfPeriod < m_maxWindow ? halfPeriod : m_maxWindow);
+
+    if(unscheduledOnTime > m_lastOnTime)
+    {
+        m_savedOnTime += unscheduledOnTime - m_lastOnTime;
+    }
+}
+
+/**
+ * @brief Predicts the next push and calculates the wake-up.
+ *
+ * The predicted push is the push of the learned period closest to one measure interval from now. The wake-up
+ * is the warm-up and half the receive window (at most half a period) before it. Without a learned period (or if the predicted push is
+ * more than MAX_INTERVALS measure intervals away) the next wake-up is one measure interval from now.
+ *
+ * @param now The local time.
+ * @return The delay from now to the next wake-up.
+ */
+uint32_t SmPushScheduler::scheduleNextWake(uint32_t const now)
+{
+    if(!isLearned() || !m_hasArrival)
+    {
+        m_hasPrediction = false;
+
+        return m_interval;
+    }
+
+    uint32_t period = m_period * 1000;
+    uint32_t beforeArrival = m_leadTime + getWaitBeforePush();
+
+    // pushes since the last arrival, rounded to the push closest to the measure interval
+    uint32_t periods = (now + m_interval - m_lastArrival + period / 2) / period;
+
+    if(periods == 0)
+    {
+        periods = 1;
+    }
+
+    uint32_t predicted = m_lastArrival + periods * period;
+
+    // the wake-up has to be in the future, else the next push is taken
+    while(static_cast<int32_t>(predicted - beforeArrival - now) < static_cast<int32_t>(MIN_SLEEP))
+    {
+        predicted += period;
+    }
+
+    uint32_t delay = predicted - beforeArrival - now;
+
+    // the watchdog expires after a few measure intervals, a push beyond is not waited for
+    if(delay > MAX_INTERVALS * m_interval)
+    {
+        MyLog::log("SCHEDULER", "Next push beyond %d measure intervals, wake-up unscheduled", MAX_INTERVALS);
+
+        m_hasPrediction = false;
+
+        return m_interval;
+    }
+
+    m_predicted = predicted;
+    m_hasPrediction = true;
+
+    MyLog::log("SCHEDULER", "Next push predicted in %lu ms, wake-up in %lu ms, window %lu ms", (unsigned long) (predicted - now), (unsigned long) delay, (unsigned long) getReceiveWindow());
+
+    return delay;
+}
+
+/**
+ * @brief Gets the time to wait for the push after the warm-up.
+ *
+ * The window halves with each confirmed prediction, it is at least MIN_WINDOW and four times the mean error.
+ *
+ * @return The receive window, the full read cycle timeout without a prediction.
+ */
+uint32_t SmPushScheduler::getReceiveWindow() const
+{
+    if(!m_hasPrediction || m_confidence == 0)
+    {
+        return m_maxWindow;
+    }
+
+    uint32_t window = m_maxWindow >> m_confidence;
+    uint32_t errorWindow = MIN_WINDOW + 4 * m_meanError;
+
+    if(window < errorWindow)
+    {
+        window = errorWindow;
+    }
+
+    return window < m_maxWindow ? window : m_maxWindow;
+}
+
+/**
+ * @brief Gets the time the receive window opens before the predicted push.
+ *
+ * The window is centered on the predicted push. A window longer than the period contains a push anyway, it
+ * opens half a period before the predicted push.
+ *
+ * @return The time in ms, half the receive window without a learned period.
+ */
+uint32_t SmPushScheduler::getWaitBeforePush() const
+{
+    uint32_t window = getReceiveWindow();
+
+    if(isLearned() && window > m_period * 1000)
+    {
+        window = m_period * 1000;
+    }
+
+    return window / 2;
+}
+
+/**
+ * @brief Checks if the push period is known.
+ *
+ * @return true if the period has been learned, false otherwise.
+ */
+bool SmPushScheduler::isLearned() const
+{
+    return m_period != 0;
+}
+
+/**
+ * @brief Gets the learned push period.
+ *
+ * @return The period in s, a multiple of the real period until enough pushes are seen, 0 if unknown.
+ */
+uint32_t SmPushScheduler::getPeriod() const
+{
+    return m_period;
+}
+
+/**
+ * @brief Gets the number of confirmed predictions.
+ *
+ * @return The confidence, 0 to MAX_CONFIDENCE.
+ */
+uint8_t SmPushScheduler::getConfidence() const
+{
+    return m_confidence;
+}
+
+/**
+ * @brief Gets the arrival error of the last push.
+ *
+ * @return The arrival minus the predicted arrival in ms, negative if the push was early.
+ */
+int32_t SmPushScheduler::getLastError() const
+{
+    return m_lastError;
+}
+
+/**
+ * @brief Gets the running mean of the absolute arrival error.
+ *
+ * @return The mean error in ms.
+ */
+uint32_t SmPushScheduler::getMeanError() const
+{
+    return m_meanError;
+}
+
+/**
+ * @brief Gets the expected adapter on time of the next cycle.
+ *
+ * @return The warm-up and the expected wait for the push.
+ */
+uint32_t SmPushScheduler::getExpectedOnTime() const
+{
+    return m_leadTime + getWaitBeforePush();
+}
+
+/**
+ * @brief Gets the adapter on time of the last cycle.
+ *
+ * @return The on time in ms.
+ */
+uint32_t SmPushScheduler::getLastOnTime() const
+{
+    return m_lastOnTime;
+}
+
+/**
+ * @brief Gets the adapter on time saved in total.
+ *
+ * @return The saved on time in s.
+ */
+uint32_t SmPushScheduler::getSavedOnTime() const
+{
+    return static_cast<uint32_t>(m_savedOnTime / 1000);
+}
@@ -0,0 +1,70 @@
+/**
+ * @file smpushscheduler.h
+ * @brief This file contains the declaration of the SmPushScheduler class.
+ *
+ * The meter pushes on a fixed period, the adapter only has to be powered while a push arrives. The scheduler
+ * learns the push period from the meter timestamps (greatest common divisor of their differences) and the
+ * phase from the local arrival time (millis). The next wake-up is placed just before the predicted push and
+ * the receive window shrinks with every confirmed prediction. A missed push widens the window again.
+ * Any push of the meter is as good as the predicted one, the arrival error is the error of the phase.
+ * All times are local milliseconds unless noted, the arithmetic is safe for the wrap-around of millis.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+class SmPushScheduler
+{
+    public:
+        static uint32_t const MIN_WINDOW = 6000;                                                    // smallest receive window in ms (a push takes about 2 s at 2400 baud)
+        static uint32_t const MIN_SLEEP = 5000;                                                     // shortest sleep between two read cycles in ms
+        static uint8_t const MAX_INTERVALS = 2;                                                     // longest sleep in measure intervals (watchdog)
+        static uint32_t const MIN_PERIOD = 2;                                                       // shortest push period in s, a shorter divisor is jitter of the meter time
+        static uint8_t const MAX_CONFIDENCE = 5;                                                    // each confirmed prediction halves the window down to MIN_WINDOW
+
+        void configure(uint32_t const interval, uint32_t const maxWindow, uint32_t const leadTime); // measure interval, full receive window and warm-up time in ms
+        void reset();                                                                               // forgets the learned period and phase and the statistics
+        void cycleStarted(uint32_t const now);                                                      // the adapter is switched on
+        void pushReceived(uint32_t const arrival, uint32_t const meterTime);                        // a push arrived at the local time, with the meter time in s
+        void pushMissed();                                                                          // no push arrived within the receive window
+        void cycleEnded(uint32_t const now);                                                        // the adapter is switched off
+        uint32_t scheduleNextWake(uint32_t const now);                                              // predicts the next push, returns the delay to the wake-up
+
+        uint32_t getReceiveWindow() const;                                                          // time to wait for the push after the warm-up
+        bool isLearned() const;                                                                     // checks if the push period is known
+        uint32_t getPeriod() const;                                                                 // learned push period in s (a multiple of the real period), 0 if unknown
+        uint8_t getConfidence() const;                                                              // number of confirmed predictions, up to MAX_CONFIDENCE
+        int32_t getLastError() const;                                                               // arrival minus predicted arrival of the last push (phase error)
+        uint32_t getMeanError() const;                                                              // running mean of the absolute arrival error
+        uint32_t getExpectedOnTime() const;                                                         // expected adapter on time of the next cycle
+        uint32_t getLastOnTime() const;                                                             // adapter on time of the last cycle
+        uint32_t getSavedOnTime() const;                                                            // adapter on time saved in total in s (estimate, see cycleEnded)
+
+    private:
+        uint32_t m_interval = 0;                                                                    // measure interval
+        uint32_t m_maxWindow = 0;                                                                   // receive window without prediction
+        uint32_t m_leadTime = 0;                                                                    // time from the wake-up till the receive window starts
+
+        uint32_t m_period = 0;                                                                      // learned push period in s, 0 if unknown
+        bool m_hasArrival = false;                                                                  // flag indicating if a push has been received
+        uint32_t m_lastArrival = 0;                                                                 // local time of the last push
+        uint32_t m_lastMeterTime = 0;                                                               // meter time of the last push in s
+
+        bool m_hasPrediction = false;                                                               // flag indicating if the current cycle has a predicted push
+        uint32_t m_predicted = 0;                                                                   // local time of the predicted push
+        uint8_t m_confidence = 0;                                                                   // number of confirmed predictions
+        int32_t m_lastError = 0;                                                                    // arrival minus predicted arrival
+        uint32_t m_meanError = 0;                                                                   // running mean of the absolute arrival error
+
+        uint32_t m_cycleStart = 0;                                                                  // local time the adapter was switched on
+        uint32_t m_lastOnTime = 0;                                                                  // adapter on time of the last cycle
+        uint64_t m_savedOnTime = 0;                                                                 // adapter on time saved in total
+
+        uint32_t getWaitBeforePush() const;                                                         // time the window opens before the predicted push
+        static uint32_t gcd(uint32_t a, uint32_t b);                                                // greatest common divisor
+};
@@ -5,7 +5,9 @@
  * This file contains the implementation of the AppSettings class for the NRF52 series. 
  * It provides functions for initializing and saving configuration settings to flash memory, 
  * as well as loading and resetting the configuration. The configuration settings include 
- * parameters such as measure interval, send data type, decryption flag, cycle timeout, 
+ * parameters such as measure interval, send data type, decryption flag, cycle timeout, meter profile, 
+ * the detected serial settings,
+ * the meters on the bus (count, addresses and channels), the push schedule flag, the register filter,
  * AES key, AES initialization vector, and authentication key.
  * 
  * @version 1.0
@@ -18,6 +20,7 @@
 
 #include "appsettings-nrf52.h"
 #include "mylog.h"
+#include "smprofile.h"
 
 /**
  * @brief Initializes the flash memory for storing configuration settings.
@@ -53,6 +56,26 @@ void AppSettings::resetConfiguration(AppConfig& config)
     config.sendDataType = AppConfig::SM_SENDDATATYPE_GBTPARSED;
     config.decryptData = false;
     config.smCycleTimeout = AppConfig::SM_CYCLE_TIMEOUT;
+    config.meterProfile = AppConfig::SM_METERPROFILE;
+    config.serialBaudRate = 0;
+    config.serialFormat = 0;
+    config.meterCount = 1;
+    config.pushSchedule = true;
+    config.aggregationWindow = 0;
+    config.eventUplinks = false;
+    config.eventPowerThreshold = 0;
+    config.eventEnergyDelta = 0;
+    config.eventStatusChange = true;
+    config.eventHeartbeat = AppConfig::SM_EVENT_HEARTBEAT;
+    config.deltaKeyframeInterval = AppConfig::SM_DELTA_KEYFRAME_INTERVAL;
+    config.priorityTruncation = false;
+    config.registerFilterCount = 0;
+
+    for (size_t i = 0; i < SM_MAX_METERS; i++)
+    {
+        config.meterAddress[i] = AppConfig::SM_METERADDRESS_ANY;
+        config.meterChannel[i] = 0;
+    }
 
     InternalFS.remove(AppSettings::SETTINGSFILENAME);
 
@@ -81,7 +104,7 @@ bool AppSettings::saveConfiguration(AppConfig const& config)
 
     uint8_t flash_buffer[1024];
     
-    StaticJsonDocument<1024> doc;
+    StaticJsonDocument<SETTINGSDOCUMENTSIZE> doc;
 
     MyLog::log("APPSETTINGS", "Save data to flash");
 
@@ -89,6 +112,40 @@ bool AppSettings::saveConfiguration(AppConfig const& config)
     doc["decryptData"] = config.decryptData;
     doc["sendDataType"] = config.sendDataType;
     doc["smCycleTimeout"] = config.smCycleTimeout;
+    doc["meterProfile"] = config.meterProfile;
+    doc["serialBaudRate"] = config.serialBaudRate;
+    doc["serialFormat"] = config.serialFormat;
+    doc["meterCount"] = config.meterCount;
+    doc["pushSchedule"] = config.pushSchedule;
+    doc["aggregationWindow"] = config.aggregationWindow;
+    doc["eventUplinks"] = config.eventUplinks;
+    doc["eventPowerThreshold"] = config.eventPowerThreshold;
+    doc["eventEnergyDelta"] = config.eventEnergyDelta;
+    doc["eventStatusChange"] = config.eventStatusChange;
+    doc["eventHeartbeat"] = config.eventHeartbeat;
+    doc["deltaKeyframeInterval"] = config.deltaKeyframeInterval;
+    doc["priorityTruncation"] = config.priorityTruncation;
+
+    JsonArray meterAddress = doc.createNestedArray("meterAddress");
+    JsonArray meterChannel = doc.createNestedArray("meterChannel");
+
+    for (size_t i = 0; i < SM_MAX_METERS; i++)
+    {
+        meterAddress.add(config.meterAddress[i]);
+        meterChannel.add(config.meterChannel[i]);
+    }
+
+    // the register filter as OBIS codes (e.g. "1.1.1.8.0.255"), copied into the document
+    JsonArray registerFilter = doc.createNestedArray("registerFilter");
+
+    for (size_t i = 0; i < config.registerFilterCount && i < AppConfig::SM_MAX_REGISTERFILTER; i++)
+    {
+        char obis[SmProfiles::OBIS_STRING_SIZE];
+
+        SmProfiles::formatObis(config.registerFilter[i], obis, sizeof(obis));
+
+        registerFilter.add((char*) obis);
+    }
 
     JsonArray aeskey = doc.createNestedArray("aes_key");
 
@@ -182,7 +239,7 @@ bool AppSettings::loadConfiguration(AppConfig& config)
     lora_file.read(flash_buffer, sizeof(flash_buffer));
     lora_file.close();
 
-    StaticJsonDocument<1024> doc;
+    StaticJsonDocument<SETTINGSDOCUMENTSIZE> doc;
 
     DeserializationError error = deserializeJson(doc, flash_buffer, sizeof(flash_buffer));
 
@@ -201,6 +258,40 @@ bool AppSettings::loadConfiguration(AppConfig& config)
     config.sendDataType = doc["sendDataType"];
     config.decryptData = doc["decryptData"];
     config.smCycleTimeout = doc["smCycleTimeout"];
+    config.meterProfile = doc["meterProfile"] | AppConfig::SM_METERPROFILE;
+    config.serialBaudRate = doc["serialBaudRate"] | 0;
+    config.serialFormat = doc["serialFormat"] | 0;
+    config.meterCount = doc["meterCount"] | 1;
+    config.pushSchedule = doc["pushSchedule"] | true;
+    config.aggregationWindow = doc["aggregationWindow"] | 0;
+    config.eventUplinks = doc["eventUplinks"] | false;
+    config.eventPowerThreshold = doc["eventPowerThreshold"] | 0;
+    config.eventEnergyDelta = doc["eventEnergyDelta"] | 0;
+    config.eventStatusChange = doc["eventStatusChange"] | true;
+    config.eventHeartbeat = doc["eventHeartbeat"] | AppConfig::SM_EVENT_HEARTBEAT;
+    config.deltaKeyframeInterval = doc["deltaKeyframeInterval"] | AppConfig::SM_DELTA_KEYFRAME_INTERVAL;
+    config.priorityTruncation = doc["priorityTruncation"] | false;
+
+    for (size_t i = 0; i < SM_MAX_METERS; i++)
+    {
+        config.meterAddress[i] = doc["meterAddress"][i] | AppConfig::SM_METERADDRESS_ANY;
+        config.meterChannel[i] = doc["meterChannel"][i] | 0;
+    }
+
+    // a missing or invalid OBIS code ends the register filter
+    config.registerFilterCount = 0;
+
+    for (size_t i = 0; i < AppConfig::SM_MAX_REGISTERFILTER; i++)
+    {
+        char const* obis = doc["registerFilter"][i] | "";
+
+        if (!SmProfiles::parseObis(obis, config.registerFilter[i]))
+        {
+            break;
+        }
+
+        config.registerFilterCount++;
+    }
 
     for (size_t i = 0; i < sizeof(config.aes_iv); i++)
     {
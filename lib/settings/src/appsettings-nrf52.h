@@ -20,6 +20,7 @@ class AppSettings
 {
     private:
         static constexpr const char* SETTINGSFILENAME = "WMB_SETTINGS";
+        static const size_t SETTINGSDOCUMENTSIZE = 1536;          // capacity of the json document (values, arrays and the OBIS codes of the register filter)
         static bool initFlash();
 
     public:
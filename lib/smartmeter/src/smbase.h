@@ -3,8 +3,8 @@
  * @brief Defines the SmBase class, which is a base class for smart meter communication.
  * 
  * This file contains the declaration of the SmBase class, which provides an interface for parsing
- * smart meter data, retrieving date and time information, copying data to a Cayenne object,
- * opening and closing a serial port, and reading data from the serial port.
+ * smart meter data, retrieving date and time information, extracting data into a record sink,
+ * opening and closing a serial port, and reading data in chunks from the serial port.
  * 
  * @version 1.0
  * @author MFA Informatik AG, Andreas Schneider
@@ -12,21 +12,24 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 #include <stdbool.h>
 
 #include "gbtdata.h"
-#include "smcayenne.h"
+#include "smprofile.h"
+#include "smrecordsink.h"
 
 class SmBase 
 {
     public:
         virtual ~SmBase() = default;
-        virtual bool const parse(GbtData const& gbtData) = 0;                                       // parse the smart meter data from the GbtData object
+        virtual bool selectProfile(uint8_t const profileId) = 0;                                    // select the meter profile (serial settings and registers), false if unknown
+        virtual void selectChannel(uint8_t const channel) = 0;                                      // select the uplink channel of the meter, 0 for the channel of the profile
+        virtual void selectSerialSetting(uint32_t const baudRate, SmSerialFormat const serialFormat) = 0;  // select the serial settings, baud rate 0 for the settings of the profile
+        virtual bool extract(GbtDataBase const& gbtData, SmRecordSink& sink, bool const scaled) = 0; // extract device name, date and time and the values (raw or fixed-point with unit) into the sink in one pass
         virtual GbtDateTime const& getDateTime() = 0;                                               // get the date and time information
-        virtual void copyData(GbtData const& gbtData, SmCayenne& cayenne) = 0;                      // copy the smart meter data to the Cayenne object
         virtual void openSerialPort() = 0;                                                          // open the serial port for reading on the smart meter
-        virtual int available() = 0;                                                                // check if data is available on the serial port
-        virtual int read() = 0;                                                                     // read a byte from the serial port
+        virtual size_t readInto(uint8_t* buffer, size_t const maxSize, uint32_t const timeoutMs) = 0; // read the received bytes (at most maxSize) from the serial port, waits up to timeoutMs for the first byte
         virtual void closeSerialPort() = 0;                                                         // close the serial port
         virtual uint8_t getChannel() = 0;                                                           // get the channel number of the smart meter (identifies the device)
         virtual char const* getLogicalDeviceName() = 0;                                             // get the logical device name of the smart meter
@@ -0,0 +1,308 @@
+/**
+ * @file smmeter.cpp
+ * @brief Implementation of the SmMeter class.
+ *
+ * This file contains the implementation of the SmMeter class, which is responsible for handling the communication
+ * with a smart meter described by a meter profile. It provides functions for opening and closing the serial port,
+ * reading data in chunks from the serial port and extracting the received data into a record sink.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include "mylog.h"
+#include "smmeter.h"
+
+/**
+ * @brief Selects the profile of the connected meter.
+ *
+ * An unknown identifier selects the default profile. The cached push layout is dropped.
+ *
+ * @param profileId The identifier of the profile (see SmProfiles).
+ * @return true if the profile is known, false if the default profile is used.
+ */
+bool SmMeter::selectProfile(uint8_t const profileId)
+{
+    SmProfile const* profile = SmProfiles::find(profileId);
+
+    bool found = profile != nullptr;
+
+    if(!found)
+    {
+        MyLog::log("SMMETER", "Unknown meter profile %d, using default profile", profileId);
+
+        profile = &SmProfiles::getDefault();
+    }
+
+    MyLog::log("SMMETER", "Select meter profile %d (%s)", profile->id, profile->name);
+
+    m_profile = profile;
+
+    m_extractor.reset();
+
+    return found;
+}
+
+/**
+ * @brief Selects the uplink channel of the meter.
+ *
+ * The channels of the registers are moved by the same offset as the channel of the meter, so the registers
+ * of several meters with the same profile do not share a channel.
+ *
+ * @param channel The channel of the meter, 0 for the channel of the profile.
+ */
+void SmMeter::selectChannel(uint8_t const channel)
+{
+    MyLog::log("SMMETER", "Select uplink channel %d", channel);
+
+    m_channel = channel;
+}
+
+/**
+ * @brief Selects the serial settings of the meter (e.g. detected or persisted).
+ *
+ * @param baudRate The baud rate, 0 for the settings of the profile.
+ * @param serialFormat The data bits, parity and stop bits, used if the baud rate is not 0.
+ */
+void SmMeter::selectSerialSetting(uint32_t const baudRate, SmSerialFormat const serialFormat)
+{
+    MyLog::log("SMMETER", "Select serial setting %lu baud, format %d", (unsigned long) baudRate, (int) serialFormat);
+
+    m_baudRate = baudRate;
+    m_serialFormat = serialFormat;
+}
+
+/**
+ * @brief Selects the registers which are sent, the other values of the push are skipped by the parse.
+ *
+ * @param codes The OBIS codes of the registers (allow-list).
+ * @param count The number of OBIS codes, 0 sends all registers of the profile.
+ * @return true if the allow-list was taken, false if it is too long (all registers are sent).
+ */
+bool SmMeter::selectRegisterFilter(uint8_t const (*codes)[SmRegisterFilter::OBIS_SIZE], uint8_t const count)
+{
+    MyLog::log("SMMETER", "Select register filter of %d OBIS codes", count);
+
+    return m_extractor.selectFilter(codes, count);
+}
+
+/**
+ * @brief Gets the baud rate of the serial interface.
+ *
+ * @return The selected baud rate, the baud rate of the profile if none is selected.
+ */
+uint32_t SmMeter::getBaudRate() const
+{
+    return m_baudRate != 0 ? m_baudRate : m_profile->baudRate;
+}
+
+/**
+ * @brief Maps the serial format (selected or of the profile) to the framework constant.
+ *
+ * @return The serial configuration for Serial1.begin.
+ */
+uint32_t SmMeter::getSerialConfig() const
+{
+    switch(m_baudRate != 0 ? m_serialFormat : m_profile->serialFormat)
+    {
+        case SmSerialFormat::SMSERIAL_8N1:
+            return SERIAL_8N1;
+
+        case SmSerialFormat::SMSERIAL_8E1:
+        default:
+            return SERIAL_8E1;
+    }
+}
+
+/**
+ * @brief Closes the serial port.
+ *
+ * This function closes the serial port used for communication with the smart meter.
+ */
+void SmMeter::closeSerialPort()
+{
+    MyLog::log("SMMETER", "closeSerialPort");
+
+    Serial1.end();
+}
+
+/**
+ * @brief Reads the received bytes from the serial port with one bulk read.
+ *
+ * Waits up to the timeout for the first byte, then takes all bytes already received by the UART (at most
+ * maxSize) without waiting for further bytes.
+ *
+ * @param buffer The buffer for the received bytes.
+ * @param maxSize The size of the buffer.
+ * @param timeoutMs The time in ms to wait for the first byte.
+ * @return The number of bytes read, 0 if nothing was received within the timeout.
+ */
+size_t SmMeter::readInto(uint8_t* buffer, size_t const maxSize, uint32_t const timeoutMs)
+{
+    uint32_t start = millis();
+
+    int received = Serial1.available();
+
+    while(received <= 0 && millis() - start < timeoutMs)
+    {
+        delay(SM_READ_POLL_TIME);
+
+        received = Serial1.available();
+    }
+
+    if(received <= 0)
+    {
+        return 0;
+    }
+
+    return Serial1.readBytes(buffer, (size_t) received < maxSize ? (size_t) received : maxSize);
+}
+
+/**
+ * @brief Opens the serial port.
+ *
+ * This function opens the serial port with the selected baud rate and format, or with those of the profile.
+ */
+void SmMeter::openSerialPort()
+{
+    MyLog::log("SMMETER", "openSerialPort with %lu baud for %s", (unsigned long) getBaudRate(), m_profile->name);
+
+    // open and flush serial port
+    Serial1.begin(getBaudRate(), getSerialConfig());
+
+    Serial1.flush();
+}
+
+/**
+ * @brief Parses the push of the meter, the registers filtered out by the register filter are skipped.
+ *
+ * The skipped values are not decoded, the push is parsed completely if it has no cached layout yet or if its
+ * layout changed (see SmPushExtractor::parse). Only extract may be used on the values, not derive.
+ *
+ * @param gbtData The values of the push.
+ * @param data The GBT data of the push.
+ * @param size The size of the GBT data.
+ * @return The result of GbtDataBase::parse, < 0 on failure.
+ */
+int SmMeter::parse(GbtDataBase& gbtData, uint8_t const* data, size_t const size)
+{
+    return m_extractor.parse(gbtData, data, size, *m_profile);
+}
+
+/**
+ * @brief Extracts the push into a record sink (e.g. the SmCayenne object or an SmAggregator) in one pass.
+ *
+ * Takes the date and time and the device name of the push and adds the values in the order of the push on the
+ * channel of their register (moved with the channel of the meter), values without register in the profile are
+ * not sent. The push layout is resolved once and cached (see SmPushExtractor).
+ *
+ * @param gbtData The parsed push.
+ * @param sink The sink to which the records will be added.
+ * @param scaled true to add numeric values as fixed-point values with unit, false to add the raw values.
+ * @return true if the push has a layout and all values were added, false otherwise.
+ */
+bool SmMeter::extract(GbtDataBase const& gbtData, SmRecordSink& sink, bool const scaled)
+{
+    MyLog::log("SMMETER", "Extract GBT data for %s", m_profile->name);
+
+    // copy the date and time into the member variable
+    m_gdbdateTime.clone(gbtData.getDateTime());
+
+    bool extracted = m_extractor.extract(gbtData, *m_profile, getChannel(), scaled, sink);
+
+    MyLog::log("SMMETER", "Extracted %d values, device name %s", m_extractor.getRecordCount(), m_extractor.getDeviceName());
+
+    return extracted;
+}
+
+/**
+ * @brief Derives the consumption and the average power of the energy counters since the previous push.
+ *
+ * @param gbtData The parsed push.
+ * @param derived The derived values of the meter, keeps the counters of the push for the next one.
+ * @return true if values were derived, false for the first push or if the push has no layout.
+ */
+bool SmMeter::derive(GbtDataBase const& gbtData, SmDerived& derived)
+{
+    if(!m_extractor.updateLayout(gbtData, *m_profile))
+    {
+        return false;
+    }
+
+    bool updated = derived.update(gbtData, m_extractor.getLayout(), getChannel() - m_profile->channel);
+
+    MyLog::log("SMMETER", "Derived %d counters over %lu s", derived.getCount(), (unsigned long) derived.getInterval());
+
+    return updated;
+}
+
+/**
+ * @brief Resolves the push layout, it is resolved again only if the push changed (see SmPushExtractor).
+ *
+ * @param gbtData The parsed push.
+ * @return true if the push has a layout, false otherwise.
+ */
+bool SmMeter::updateLayout(GbtDataBase const& gbtData)
+{
+    return m_extractor.updateLayout(gbtData, *m_profile);
+}
+
+/**
+ * @brief Gets the cached layout of the last push.
+ *
+ * @return The push layout, valid after updateLayout returned true.
+ */
+SmPushLayout const& SmMeter::getLayout() const
+{
+    return m_extractor.getLayout();
+}
+
+/**
+ * @brief Gets the number of value records of the last extract, they follow the time stamp.
+ *
+ * @return The number of value records.
+ */
+uint8_t SmMeter::getRecordCount() const
+{
+    return m_extractor.getRecordCount();
+}
+
+/**
+ * @brief Gets the value of the push layout of each value record of the last extract.
+ *
+ * @return The index of the value within the push layout for each record.
+ */
+uint8_t const* SmMeter::getRecordValues() const
+{
+    return m_extractor.getRecordValues();
+}
+
+/**
+ * @brief Gets the date and time from the GbtData object.
+ *
+ * @return The GbtDateTime object representing the date and time.
+ */
+GbtDateTime const& SmMeter::getDateTime()
+{
+    return m_gdbdateTime;
+}
+
+/**
+ * @brief Get the channel number of the meter (selected or from the profile).
+ *
+ * @return The channel number.
+ */
+uint8_t SmMeter::getChannel()
+{
+    return m_channel != 0 ? m_channel : m_profile->channel;
+}
+
+/**
+ * @brief Get the logical device name.
+ *
+ * @return The logical device name.
+ */
+char const* SmMeter::getLogicalDeviceName()
+{
+    return m_extractor.getDeviceName();
+}
@@ -0,0 +1,55 @@
+/**
+ * @file smmeter.h
+ * @brief The SmMeter class handles any smart meter described by a meter profile (SmProfile).
+ *
+ * This class inherits from the SmBase class. The serial settings, the expected push and the registers sent
+ * in the uplink are taken from the selected profile, a new meter model is a new profile table entry.
+ * The push layout is resolved once and cached, the push is extracted in one pass in the order of the push.
+ * With several meters on one adapter there is one SmMeter for each meter, each on its own uplink channel.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#include "smbase.h"
+#include "smderived.h"
+#include "smprofile.h"
+#include "smpushextractor.h"
+
+class SmMeter : public SmBase
+{
+    private:
+        static uint32_t const SM_READ_POLL_TIME = 10;                                               // time in ms between two checks of the serial port while waiting for data
+
+        SmProfile const* m_profile = &SmProfiles::getDefault();                                     // profile of the connected meter
+        uint8_t m_channel = 0;                                                                      // uplink channel of the meter, 0 for the channel of the profile
+        uint32_t m_baudRate = 0;                                                                    // baud rate of the serial interface, 0 for the settings of the profile
+        SmSerialFormat m_serialFormat = SmSerialFormat::SMSERIAL_8E1;                               // serial format, used if the baud rate is selected
+        SmPushExtractor m_extractor;                                                                // cached layout of the push and the device name
+        GbtDateTime m_gdbdateTime;                                                                  // date and time information
+
+        uint32_t getBaudRate() const;                                                               // baud rate selected or of the profile
+        uint32_t getSerialConfig() const;                                                           // maps the serial format (selected or of the profile) to the framework constant
+
+    public:
+        bool selectProfile(uint8_t const profileId) override;
+        void selectChannel(uint8_t const channel) override;
+        void selectSerialSetting(uint32_t const baudRate, SmSerialFormat const serialFormat) override;
+        bool selectRegisterFilter(uint8_t const (*codes)[SmRegisterFilter::OBIS_SIZE], uint8_t const count);    // sets the OBIS codes of the registers which are sent, 0 for all
+        int parse(GbtDataBase& gbtData, uint8_t const* data, size_t const size);                    // parses the push, the registers filtered out are skipped
+        bool extract(GbtDataBase const& gbtData, SmRecordSink& sink, bool const scaled) override;
+        bool derive(GbtDataBase const& gbtData, SmDerived& derived);                                // derives the interval values of the energy counters, false for the first push
+        bool updateLayout(GbtDataBase const& gbtData);                                              // resolves the push layout if the push changed, false if the push has none
+        SmPushLayout const& getLayout() const;                                                      // cached layout of the last push
+        uint8_t getRecordCount() const;                                                             // number of value records of the last extract
+        uint8_t const* getRecordValues() const;                                                     // value of the push layout of each value record
+        GbtDateTime const& getDateTime() override;
+        void openSerialPort() override;
+        size_t readInto(uint8_t* buffer, size_t const maxSize, uint32_t const timeoutMs) override;
+        void closeSerialPort() override;
+        uint8_t getChannel() override;
+        char const* getLogicalDeviceName() override;
+};
@@ -0,0 +1,316 @@
+/**
+ * @file smdeltadecoder.cpp
+ * @brief Implementation of the SmDeltaDecoder class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include "smdeltadecoder.h"
+#include "smdeltaencoder.h"
+#include "smvarint.h"
+
+/**
+ * @brief Drops the decoded frames, the next delta frames are rejected till a keyframe is received.
+ */
+void SmDeltaDecoder::reset()
+{
+    m_count = 0;
+    m_next = 0;
+    m_keyframe = false;
+}
+
+/**
+ * @brief Decodes a keyframe or a delta frame.
+ *
+ * @param data The frame.
+ * @param size The size of the frame.
+ * @param frame The values of the push.
+ * @return true if the frame was decoded, false if it is truncated or invalid or its reference was not received.
+ */
+bool SmDeltaDecoder::decode(uint8_t const* data, size_t const size, SmDeltaFrame& frame)
+{
+    ByteCursor cursor(data, size);
+
+    if(!cursor.has(1))
+    {
+        return false;
+    }
+
+    uint8_t const header = cursor.peekUint8(0);
+
+    cursor.skip(1);
+
+    bool const keyframe = (header & SmDeltaEncoder::HEADER_KEYFRAME) != 0;
+    uint8_t const sequence = header & SmDeltaEncoder::SEQUENCE_MASK;
+
+    bool decoded;
+
+    if(keyframe)
+    {
+        decoded = decodeKeyframe(cursor, frame);
+    }
+    else
+    {
+        if(!cursor.has(1))
+        {
+            return false;
+        }
+
+        SmDeltaFrame const* reference = findReference(cursor.peekUint8(0));
+
+        cursor.skip(1);
+
+        decoded = reference != nullptr && decodeDelta(cursor, *reference, frame);
+    }
+
+    // the whole frame is used, trailing bytes are a format error
+    if(!decoded || cursor.remaining() != 0)
+    {
+        return false;
+    }
+
+    m_sequence = sequence;
+    m_keyframe = keyframe;
+
+    keep(sequence, frame);
+
+    return true;
+}
+
+/**
+ * @brief Checks if the last decoded frame was a keyframe.
+ *
+ * @return true for a keyframe, false for a delta frame.
+ */
+bool SmDeltaDecoder::isKeyframe() const
+{
+    return m_keyframe;
+}
+
+/**
+ * @brief Gets the sequence number of the last decoded frame.
+ *
+ * @return The sequence number.
+ */
+uint8_t SmDeltaDecoder::getSequence() const
+{
+    return m_sequence;
+}
+
+/**
+ * @brief Reads the full values of a keyframe.
+ *
+ * @param cursor The read position behind the header.
+ * @param frame The values of the push.
+ * @return true if the values were read, false if the frame is truncated or invalid.
+ */
+bool SmDeltaDecoder::decodeKeyframe(ByteCursor& cursor, SmDeltaFrame& frame)
+{
+    uint64_t time;
+
+    if(!cursor.has(1))
+    {
+        return false;
+    }
+
+    uint8_t const count = cursor.peekUint8(0);
+
+    cursor.skip(1);
+
+    if(!SmVarint::read(cursor, time) || time > UINT32_MAX)
+    {
+        return false;
+    }
+
+    frame.clear(static_cast<uint32_t>(time));
+
+    for(uint8_t i = 0; i < count; i++)
+    {
+        if(!cursor.has(2))
+        {
+            return false;
+        }
+
+        uint8_t const channel = cursor.peekUint8(0);
+        SmDeltaKind const kind = static_cast<SmDeltaKind>(cursor.peekUint8(1));
+        int8_t exponent = 0;
+        SmUnit unit = SmUnit::SMUNIT_NONE;
+        uint64_t value;
+
+        cursor.skip(2);
+
+        switch(kind)
+        {
+            case SmDeltaKind::SMDELTAKIND_TEXT:
+                if(!readText(cursor, channel, frame))
+                {
+                    return false;
+                }
+                continue;
+
+            case SmDeltaKind::SMDELTAKIND_SCALED:
+                if(!cursor.has(2))
+                {
+                    return false;
+                }
+
+                exponent = static_cast<int8_t>(cursor.peekUint8(0));
+                unit = static_cast<SmUnit>(cursor.peekUint8(1));
+
+                cursor.skip(2);
+                break;
+
+            case SmDeltaKind::SMDELTAKIND_RAW:
+                break;
+
+            default:
+                return false;
+        }
+
+        if(!SmVarint::read(cursor, value) || !frame.addNumeric(channel, kind, SmVarint::unzigzag(value), exponent, unit))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Reads the differences of a delta frame and applies them to the reference.
+ *
+ * @param cursor The read position behind the reference sequence.
+ * @param reference The frame of the reference sequence.
+ * @param frame The values of the push.
+ * @return true if the values were read, false if the frame is truncated.
+ */
+bool SmDeltaDecoder::decodeDelta(ByteCursor& cursor, SmDeltaFrame const& reference, SmDeltaFrame& frame)
+{
+    uint64_t timeDifference;
+
+    if(!SmVarint::read(cursor, timeDifference))
+    {
+        return false;
+    }
+
+    uint8_t const count = reference.getCount();
+    size_t const bitmapSize = (count + 7) / 8;
+
+    if(!cursor.has(bitmapSize))
+    {
+        return false;
+    }
+
+    uint8_t const* bitmap = cursor.current();
+
+    cursor.skip(bitmapSize);
+
+    frame.clear(static_cast<uint32_t>(reference.getTime() + SmVarint::unzigzag(timeDifference)));
+
+    for(uint8_t i = 0; i < count; i++)
+    {
+        SmDeltaValue const& value = reference.getAt(i);
+
+        bool const changed = (bitmap[i / 8] & (1 << (i % 8))) != 0;
+
+        if(value.kind == SmDeltaKind::SMDELTAKIND_TEXT)
+        {
+            if(!(changed ? readText(cursor, value.channel, frame) : frame.addText(value.channel, reference.getText(i), value.length)))
+            {
+                return false;
+            }
+
+            continue;
+        }
+
+        uint64_t difference = 0;
+
+        if(changed && !SmVarint::read(cursor, difference))
+        {
+            return false;
+        }
+
+        frame.addNumeric(value.channel, value.kind, value.value + SmVarint::unzigzag(difference), value.exponent, value.unit);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Finds a decoded frame by its sequence number.
+ *
+ * @param sequence The sequence number.
+ * @return The frame, nullptr if it was not received or is too old.
+ */
+SmDeltaFrame const* SmDeltaDecoder::findReference(uint8_t const sequence) const
+{
+    for(uint8_t i = 0; i < m_count; i++)
+    {
+        if(m_sequences[i] == sequence)
+        {
+            return &m_frames[i];
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Keeps a decoded frame as reference of the next delta frames, the oldest frame is replaced.
+ *
+ * @param sequence The sequence number of the frame.
+ * @param frame The frame.
+ */
+void SmDeltaDecoder::keep(uint8_t const sequence, SmDeltaFrame const& frame)
+{
+    // a repeated frame replaces the kept one with the same sequence number
+    for(uint8_t i = 0; i < m_count; i++)
+    {
+        if(m_sequences[i] == sequence)
+        {
+            m_frames[i] = frame;
+
+            return;
+        }
+    }
+
+    m_frames[m_next] = frame;
+    m_sequences[m_next] = sequence;
+
+    m_next = (m_next + 1) % HISTORY;
+
+    if(m_count < HISTORY)
+    {
+        m_count++;
+    }
+}
+
+/**
+ * @brief Reads the length and the octets of a string into a frame.
+ *
+ * @param cursor The read position.
+ * @param channel The channel of the register.
+ * @param frame The frame.
+ * @return true if the string was read, false if it is truncated or does not fit into the frame.
+ */
+bool SmDeltaDecoder::readText(ByteCursor& cursor, uint8_t const channel, SmDeltaFrame& frame)
+{
+    if(!cursor.has(1))
+    {
+        return false;
+    }
+
+    uint8_t const length = cursor.peekUint8(0);
+
+    if(!cursor.has(1 + length))
+    {
+        return false;
+    }
+
+    bool added = frame.addText(channel, reinterpret_cast<char const*>(cursor.current() + 1), length);
+
+    cursor.skip(1 + length);
+
+    return added;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file smdeltadecoder.h
+ * @brief This file contains the declaration of the SmDeltaDecoder class.
+ *
+ * Server side counterpart of the SmDeltaEncoder, used by the host tests and the benchmarks. The decoder keeps
+ * the last decoded frames, a delta frame is rebuilt from the frame of its reference sequence. A delta frame
+ * whose reference was not received is rejected, the values are available again with the next keyframe.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "bytecursor.h"
+#include "smdeltaframe.h"
+
+class SmDeltaDecoder
+{
+    public:
+        static uint8_t const HISTORY = 8;                                                           // decoded frames kept as reference (see SmDeltaEncoder::MAX_REFERENCE_AGE)
+
+        void reset();                                                                               // drops the decoded frames
+        bool decode(uint8_t const* data, size_t const size, SmDeltaFrame& frame);                   // decodes a keyframe or a delta frame, false if it is invalid or its reference is missing
+        bool isKeyframe() const;                                                                    // checks if the last decoded frame was a keyframe
+        uint8_t getSequence() const;                                                                // sequence number of the last decoded frame
+
+    private:
+        SmDeltaFrame m_frames[HISTORY];                                                             // last decoded frames
+        uint8_t m_sequences[HISTORY];                                                               // sequence number of each decoded frame
+        uint8_t m_count = 0;                                                                        // number of decoded frames kept
+        uint8_t m_next = 0;                                                                         // index of the next frame to be replaced
+        uint8_t m_sequence = 0;                                                                     // sequence number of the last decoded frame
+        bool m_keyframe = false;                                                                    // flag indicating if the last decoded frame was a keyframe
+
+        bool decodeKeyframe(ByteCursor& cursor, SmDeltaFrame& frame);                               // reads the full values
+        bool decodeDelta(ByteCursor& cursor, SmDeltaFrame const& reference, SmDeltaFrame& frame);   // reads the differences to the reference
+        SmDeltaFrame const* findReference(uint8_t const sequence) const;                            // decoded frame with the sequence number, nullptr if not kept
+        void keep(uint8_t const sequence, SmDeltaFrame const& frame);                               // keeps a decoded frame as reference
+        static bool readText(ByteCursor& cursor, uint8_t const channel, SmDeltaFrame& frame);       // reads the length and the octets of a string into the frame
+};
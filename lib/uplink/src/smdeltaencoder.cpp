@@ -0,0 +1,335 @@
+/**
+ * @file smdeltaencoder.cpp
+ * @brief Implementation of the SmDeltaEncoder class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include <string.h>
+
+#include "gbtoctetstring.h"
+#include "mylog.h"
+#include "smdeltaencoder.h"
+#include "smvarint.h"
+
+/**
+ * @brief Appends one byte to a buffer.
+ *
+ * @param buffer The buffer.
+ * @param size The size of the buffer.
+ * @param position The write position, moved behind the byte if it fits.
+ * @param value The byte.
+ * @return true if the byte was appended, false if the buffer is full.
+ */
+static bool putByte(uint8_t* buffer, size_t const size, size_t& position, uint8_t const value)
+{
+    if(position >= size)
+    {
+        return false;
+    }
+
+    buffer[position++] = value;
+
+    return true;
+}
+
+/**
+ * @brief Appends the length and the octets of a string to a buffer.
+ *
+ * @param buffer The buffer.
+ * @param size The size of the buffer.
+ * @param position The write position, moved behind the string if it fits.
+ * @param text The octets.
+ * @param length The number of octets.
+ * @return true if the string was appended, false if it does not fit.
+ */
+static bool putText(uint8_t* buffer, size_t const size, size_t& position, char const* text, uint8_t const length)
+{
+    if(!putByte(buffer, size, position, length) || length > size - position)
+    {
+        return false;
+    }
+
+    memcpy(buffer + position, text, length);
+
+    position += length;
+
+    return true;
+}
+
+/**
+ * @brief Drops the acknowledged and the pending frame, the next frame is a keyframe (e.g. after a rejoin).
+ */
+void SmDeltaEncoder::reset()
+{
+    m_hasPending = false;
+    m_hasReference = false;
+    m_overflow = false;
+    m_sinceKeyframe = 0;
+    m_referenceAge = 0;
+}
+
+/**
+ * @brief Sets the keyframe interval.
+ *
+ * @param interval Every interval-th frame is a keyframe (1 for keyframes only), 0 for keyframes only without
+ * acknowledged frame or if the registers change.
+ */
+void SmDeltaEncoder::setKeyframeInterval(uint8_t const interval)
+{
+    m_keyframeInterval = interval;
+}
+
+/**
+ * @brief Starts the frame of the next push (the time stamp is the first record of each push).
+ *
+ * @param channel The channel of the meter (unused).
+ * @param unixTime The time stamp of the push.
+ * @return true, the time stamp is always taken.
+ */
+bool SmDeltaEncoder::addRecordTime(uint8_t const channel, uint32_t const unixTime)
+{
+    m_current.clear(unixTime);
+
+    m_overflow = false;
+
+    return true;
+}
+
+/**
+ * @brief Adds a raw value, numeric values and octet strings are kept, other values are skipped.
+ *
+ * @param channel The channel of the register.
+ * @param gbtValue The raw value.
+ * @return true if the value is added or skipped, false if the frame is full.
+ */
+bool SmDeltaEncoder::addRecordValue(uint8_t const channel, GbtValueBase const* gbtValue)
+{
+    int64_t raw;
+
+    bool added = true;
+
+    if(SmScaler::getRawValue(gbtValue, raw))
+    {
+        added = m_current.addNumeric(channel, SmDeltaKind::SMDELTAKIND_RAW, raw, 0, SmUnit::SMUNIT_NONE);
+    }
+    else if(gbtValue->getValueType() == GbtValueBase::GbtValueType::GBTVALUETYPE_OCTETESTRING)
+    {
+        auto gbt = static_cast<GbtOctetString const*>(gbtValue);
+
+        added = m_current.addText(channel, gbt->getStringValue(), static_cast<uint8_t>(gbt->getStringLength()));
+    }
+
+    m_overflow |= !added;
+
+    return added;
+}
+
+/**
+ * @brief Adds a fixed-point value.
+ *
+ * @param channel The channel of the register.
+ * @param scaledValue The fixed-point value.
+ * @return true if the value is added, false if the frame is full.
+ */
+bool SmDeltaEncoder::addRecordScaled(uint8_t const channel, SmScaledValue const& scaledValue)
+{
+    bool added = m_current.addNumeric(channel, SmDeltaKind::SMDELTAKIND_SCALED, scaledValue.mantissa, scaledValue.exponent, scaledValue.unit);
+
+    m_overflow |= !added;
+
+    return added;
+}
+
+/**
+ * @brief Checks if the next frame is a keyframe.
+ *
+ * A keyframe is sent without acknowledged frame, if the registers of the push differ from the ones of the
+ * acknowledged frame and every keyframe interval.
+ *
+ * @return true if the frame of the push is encoded as keyframe.
+ */
+bool SmDeltaEncoder::isKeyframeDue() const
+{
+    if(!m_hasReference || !m_current.hasSameLayout(m_reference))
+    {
+        return true;
+    }
+
+    return m_keyframeInterval != 0 && m_sinceKeyframe + 1 >= m_keyframeInterval;
+}
+
+/**
+ * @brief Encodes the frame of the push, it waits for the acknowledgement afterwards.
+ *
+ * The frame replaces a frame which is still waiting, only the last encoded frame can be acknowledged.
+ *
+ * @param buffer The buffer for the frame.
+ * @param size The size of the buffer.
+ * @return The size of the frame, 0 if it does not fit into the buffer or a value of the push did not fit.
+ */
+size_t SmDeltaEncoder::encode(uint8_t* buffer, size_t const size)
+{
+    if(m_overflow)
+    {
+        MyLog::log("SMDELTA", "Push has more than %d values, frame not encoded", SmDeltaFrame::MAX_VALUES);
+
+        return 0;
+    }
+
+    bool keyframe = isKeyframeDue();
+
+    size_t frameSize = keyframe ? encodeKeyframe(buffer, size) : encodeDelta(buffer, size);
+
+    if(frameSize == 0)
+    {
+        MyLog::log("SMDELTA", "Frame does not fit into %d bytes", size);
+
+        return 0;
+    }
+
+    MyLog::log("SMDELTA", "Encoded %s %d with %d values in %d bytes", keyframe ? "keyframe" : "delta frame", m_sequence, m_current.getCount(), frameSize);
+
+    m_sinceKeyframe = keyframe ? 0 : m_sinceKeyframe + 1;
+
+    m_pending = m_current;
+    m_pendingSequence = m_sequence;
+    m_hasPending = true;
+
+    m_sequence = (m_sequence + 1) & SEQUENCE_MASK;
+
+    // the decoder keeps a few frames only, an older reference is not used any more
+    if(m_hasReference && ++m_referenceAge >= MAX_REFERENCE_AGE)
+    {
+        MyLog::log("SMDELTA", "No acknowledgement for %d frames, reference dropped", m_referenceAge);
+
+        m_hasReference = false;
+    }
+
+    return frameSize;
+}
+
+/**
+ * @brief The last encoded frame was acknowledged by the network, the next frames are sent as its difference.
+ */
+void SmDeltaEncoder::acknowledged()
+{
+    if(!m_hasPending)
+    {
+        return;
+    }
+
+    m_reference = m_pending;
+    m_referenceSequence = m_pendingSequence;
+    m_hasReference = true;
+    m_hasPending = false;
+    m_referenceAge = 0;
+}
+
+/**
+ * @brief Gets the sequence number of the last encoded frame.
+ *
+ * @return The sequence number (7 bit).
+ */
+uint8_t SmDeltaEncoder::getSequence() const
+{
+    return (m_sequence - 1) & SEQUENCE_MASK;
+}
+
+/**
+ * @brief Encodes the full values of the push.
+ *
+ * @param buffer The buffer for the frame.
+ * @param size The size of the buffer.
+ * @return The size of the frame, 0 if it does not fit.
+ */
+size_t SmDeltaEncoder::encodeKeyframe(uint8_t* buffer, size_t const size) const
+{
+    size_t position = 0;
+
+    bool fits = putByte(buffer, size, position, HEADER_KEYFRAME | m_sequence)
+        && putByte(buffer, size, position, m_current.getCount())
+        && SmVarint::write(buffer, size, position, m_current.getTime());
+
+    for(uint8_t i = 0; fits && i < m_current.getCount(); i++)
+    {
+        SmDeltaValue const& value = m_current.getAt(i);
+
+        fits = putByte(buffer, size, position, value.channel) && putByte(buffer, size, position, static_cast<uint8_t>(value.kind));
+
+        switch(value.kind)
+        {
+            case SmDeltaKind::SMDELTAKIND_SCALED:
+                fits = fits && putByte(buffer, size, position, static_cast<uint8_t>(value.exponent))
+                    && putByte(buffer, size, position, static_cast<uint8_t>(value.unit))
+                    && SmVarint::write(buffer, size, position, SmVarint::zigzag(value.value));
+                break;
+
+            case SmDeltaKind::SMDELTAKIND_TEXT:
+                fits = fits && putText(buffer, size, position, m_current.getText(i), value.length);
+                break;
+
+            default:
+                fits = fits && SmVarint::write(buffer, size, position, SmVarint::zigzag(value.value));
+                break;
+        }
+    }
+
+    return fits ? position : 0;
+}
+
+/**
+ * @brief Encodes the differences of the push to the acknowledged frame (same layout).
+ *
+ * @param buffer The buffer for the frame.
+ * @param size The size of the buffer.
+ * @return The size of the frame, 0 if it does not fit.
+ */
+size_t SmDeltaEncoder::encodeDelta(uint8_t* buffer, size_t const size) const
+{
+    size_t position = 0;
+
+    uint8_t const count = m_current.getCount();
+    size_t const bitmapSize = (count + 7) / 8;
+    int64_t const timeDifference = static_cast<int64_t>(m_current.getTime()) - m_reference.getTime();
+
+    bool fits = putByte(buffer, size, position, m_sequence)
+        && putByte(buffer, size, position, m_referenceSequence)
+        && SmVarint::write(buffer, size, position, SmVarint::zigzag(timeDifference))
+        && bitmapSize <= size - position;
+
+    if(!fits)
+    {
+        return 0;
+    }
+
+    uint8_t* bitmap = buffer + position;
+
+    memset(bitmap, 0, bitmapSize);
+
+    position += bitmapSize;
+
+    for(uint8_t i = 0; fits && i < count; i++)
+    {
+        if(m_current.isEqual(i, m_reference))
+        {
+            continue;
+        }
+
+        bitmap[i / 8] |= 1 << (i % 8);
+
+        SmDeltaValue const& value = m_current.getAt(i);
+
+        if(value.kind == SmDeltaKind::SMDELTAKIND_TEXT)
+        {
+            fits = putText(buffer, size, position, m_current.getText(i), value.length);
+        }
+        else
+        {
+            fits = SmVarint::write(buffer, size, position, SmVarint::zigzag(value.value - m_reference.getAt(i).value));
+        }
+    }
+
+    return fits ? position : 0;
+}
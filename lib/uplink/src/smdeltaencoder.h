@@ -0,0 +1,64 @@
+/**
+ * @file smdeltaencoder.h
+ * @brief This file contains the declaration of the SmDeltaEncoder class.
+ *
+ * Compact uplink of a push as the difference to the last frame acknowledged by the network. A delta frame
+ * has a presence bitmap with one bit for each value of the push, only the changed values follow as zigzag
+ * varints of their difference (see SmVarint). The channel, kind, exponent and unit of the values are sent
+ * with the keyframes only, a keyframe carries the full values. A keyframe is sent without acknowledged
+ * frame, if the registers of the push change and every keyframe interval for the resync.
+ *
+ * Keyframe: 0x80 | sequence, value count, time (varint), each value: channel, kind and
+ *           raw: value (zigzag varint), scaled: exponent, unit, mantissa (zigzag varint), text: length, octets
+ * Delta frame: sequence, reference sequence, time difference (zigzag varint), presence bitmap (bit 0 of the
+ *           first byte is the first value), each changed value: difference (zigzag varint) or length, octets
+ *
+ * The encoder is a record sink (see SmRecordSink), the push is extracted into it like into the uplink encoder.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "smdeltaframe.h"
+#include "smrecordsink.h"
+
+class SmDeltaEncoder : public SmRecordSink
+{
+    public:
+        static uint8_t const HEADER_KEYFRAME = 0x80;                                                // flag of the first byte, the frame is a keyframe
+        static uint8_t const SEQUENCE_MASK = 0x7f;                                                  // sequence number of the frame in the first byte
+        static uint8_t const KEYFRAME_INTERVAL = 16;                                                // default, every 16th frame is a keyframe
+        static uint8_t const MAX_REFERENCE_AGE = 8;                                                 // frames sent since the reference, an older reference is dropped (see SmDeltaDecoder::HISTORY)
+
+        void reset();                                                                               // drops the acknowledged frame, the next frame is a keyframe
+        void setKeyframeInterval(uint8_t const interval);                                           // every interval-th frame is a keyframe, 0 for keyframes on resync only
+        bool addRecordTime(uint8_t const channel, uint32_t const unixTime) override;                // starts the frame of the next push
+        bool addRecordValue(uint8_t const channel, GbtValueBase const* gbtValue) override;          // adds a raw numeric value or an octet string
+        bool addRecordScaled(uint8_t const channel, SmScaledValue const& scaledValue) override;     // adds a fixed-point value
+        size_t encode(uint8_t* buffer, size_t const size);                                          // encodes the frame of the push, 0 if it does not fit
+        void acknowledged();                                                                        // the last encoded frame was acknowledged, it is the reference of the next frames
+        bool isKeyframeDue() const;                                                                 // checks if the next frame is a keyframe
+        uint8_t getSequence() const;                                                                // sequence number of the last encoded frame
+
+    private:
+        SmDeltaFrame m_current;                                                                     // frame of the push
+        SmDeltaFrame m_pending;                                                                     // last encoded frame, not acknowledged yet
+        SmDeltaFrame m_reference;                                                                   // last acknowledged frame
+        bool m_hasPending = false;                                                                  // flag indicating if a frame waits for the acknowledgement
+        bool m_hasReference = false;                                                                // flag indicating if there is an acknowledged frame
+        bool m_overflow = false;                                                                    // flag indicating if a value of the push did not fit into the frame
+        uint8_t m_keyframeInterval = KEYFRAME_INTERVAL;                                             // every interval-th frame is a keyframe, 0 for off
+        uint8_t m_sequence = 0;                                                                     // sequence number of the next frame
+        uint8_t m_pendingSequence = 0;                                                              // sequence number of the pending frame
+        uint8_t m_referenceSequence = 0;                                                            // sequence number of the reference
+        uint8_t m_sinceKeyframe = 0;                                                                // frames encoded since the last keyframe
+        uint8_t m_referenceAge = 0;                                                                 // frames encoded since the reference
+
+        size_t encodeKeyframe(uint8_t* buffer, size_t const size) const;                            // encodes the full values
+        size_t encodeDelta(uint8_t* buffer, size_t const size) const;                               // encodes the differences to the reference
+};
@@ -0,0 +1,172 @@
+/**
+ * @file smdeltaframe.cpp
+ * @brief Implementation of the SmDeltaFrame class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include <string.h>
+
+#include "smdeltaframe.h"
+
+/**
+ * @brief Starts the frame of a push, the values of the previous push are dropped.
+ *
+ * @param unixTime The time stamp of the push.
+ */
+void SmDeltaFrame::clear(uint32_t const unixTime)
+{
+    m_time = unixTime;
+    m_count = 0;
+    m_textSize = 0;
+}
+
+/**
+ * @brief Appends a raw or fixed-point value.
+ *
+ * @param channel The channel of the register.
+ * @param kind SMDELTAKIND_RAW or SMDELTAKIND_SCALED.
+ * @param value The raw value or the mantissa.
+ * @param exponent The decimal exponent (0 for raw values).
+ * @param unit The unit (SMUNIT_NONE for raw values).
+ * @return true if the value was appended, false if the frame is full.
+ */
+bool SmDeltaFrame::addNumeric(uint8_t const channel, SmDeltaKind const kind, int64_t const value, int8_t const exponent, SmUnit const unit)
+{
+    if(m_count >= MAX_VALUES)
+    {
+        return false;
+    }
+
+    SmDeltaValue& entry = m_values[m_count++];
+
+    entry.channel = channel;
+    entry.kind = kind;
+    entry.exponent = exponent;
+    entry.unit = unit;
+    entry.length = 0;
+    entry.value = value;
+
+    return true;
+}
+
+/**
+ * @brief Appends an octet string, the octets are copied into the text of the frame.
+ *
+ * @param channel The channel of the register.
+ * @param text The octets of the string.
+ * @param length The number of octets.
+ * @return true if the string was appended, false if the frame or its text is full.
+ */
+bool SmDeltaFrame::addText(uint8_t const channel, char const* text, uint8_t const length)
+{
+    if(m_count >= MAX_VALUES || length > MAX_TEXT_SIZE - m_textSize)
+    {
+        return false;
+    }
+
+    SmDeltaValue& entry = m_values[m_count++];
+
+    entry.channel = channel;
+    entry.kind = SmDeltaKind::SMDELTAKIND_TEXT;
+    entry.exponent = 0;
+    entry.unit = SmUnit::SMUNIT_NONE;
+    entry.length = length;
+    entry.value = m_textSize;
+
+    memcpy(m_text + m_textSize, text, length);
+
+    m_textSize += length;
+
+    return true;
+}
+
+/**
+ * @brief Gets the time stamp of the push.
+ *
+ * @return The unix time stamp.
+ */
+uint32_t SmDeltaFrame::getTime() const
+{
+    return m_time;
+}
+
+/**
+ * @brief Gets the number of values.
+ *
+ * @return The number of values.
+ */
+uint8_t SmDeltaFrame::getCount() const
+{
+    return m_count;
+}
+
+/**
+ * @brief Gets the value at an index.
+ *
+ * @param index The index within the push (index < getCount()).
+ * @return The value.
+ */
+SmDeltaValue const& SmDeltaFrame::getAt(uint8_t const index) const
+{
+    return m_values[index];
+}
+
+/**
+ * @brief Gets the octets of the string at an index.
+ *
+ * @param index The index of an SMDELTAKIND_TEXT value.
+ * @return The octets, the length is the one of the value.
+ */
+char const* SmDeltaFrame::getText(uint8_t const index) const
+{
+    return m_text + m_values[index].value;
+}
+
+/**
+ * @brief Checks if the frames have the same registers, the values of such frames can be sent as differences.
+ *
+ * @param other The other frame.
+ * @return true if the number of values and the channel, kind, exponent and unit of each value are the same.
+ */
+bool SmDeltaFrame::hasSameLayout(SmDeltaFrame const& other) const
+{
+    if(m_count != other.m_count)
+    {
+        return false;
+    }
+
+    for(uint8_t i = 0; i < m_count; i++)
+    {
+        SmDeltaValue const& value = m_values[i];
+        SmDeltaValue const& otherValue = other.m_values[i];
+
+        if(value.channel != otherValue.channel || value.kind != otherValue.kind || value.exponent != otherValue.exponent || value.unit != otherValue.unit)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Checks if the value at an index is the same in both frames (same layout assumed).
+ *
+ * @param index The index within the push.
+ * @param other The other frame.
+ * @return true if the value (or the octets of the string) are the same.
+ */
+bool SmDeltaFrame::isEqual(uint8_t const index, SmDeltaFrame const& other) const
+{
+    SmDeltaValue const& value = m_values[index];
+    SmDeltaValue const& otherValue = other.m_values[index];
+
+    if(value.kind != SmDeltaKind::SMDELTAKIND_TEXT)
+    {
+        return value.value == otherValue.value;
+    }
+
+    return value.length == otherValue.length && memcmp(getText(index), other.getText(index), value.length) == 0;
+}
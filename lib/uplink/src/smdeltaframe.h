@@ -0,0 +1,66 @@
+/**
+ * @file smdeltaframe.h
+ * @brief This file contains the declaration of the SmDeltaFrame class and the SmDeltaValue.
+ *
+ * A delta frame holds the records of one push in the order of the push: the time stamp and the raw values,
+ * fixed-point values and octet strings of the registers. The encoder keeps the frame of the last push and the
+ * last acknowledged one and sends the differences (see SmDeltaEncoder), the decoder rebuilds the frames from
+ * the uplinks (see SmDeltaDecoder).
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "smprofile.h"
+
+/**
+ * @brief Kind of a value of a delta frame.
+ */
+enum class SmDeltaKind : uint8_t
+{
+    SMDELTAKIND_RAW = 0,                                                                            // raw numeric value
+    SMDELTAKIND_SCALED = 1,                                                                         // fixed-point value with unit
+    SMDELTAKIND_TEXT = 2                                                                            // octet string (e.g. the device name)
+};
+
+/**
+ * @brief One value of a delta frame.
+ */
+struct SmDeltaValue
+{
+    uint8_t channel;                                                                                // uplink channel of the register
+    SmDeltaKind kind;                                                                               // kind of the value
+    int8_t exponent;                                                                                // decimal exponent of a fixed-point value, 0 otherwise
+    SmUnit unit;                                                                                    // unit of a fixed-point value, SMUNIT_NONE otherwise
+    uint8_t length;                                                                                 // length of an octet string, 0 otherwise
+    int64_t value;                                                                                  // raw value or mantissa, offset into the text of the frame for octet strings
+};
+
+class SmDeltaFrame
+{
+    public:
+        static uint8_t const MAX_VALUES = 16;                                                       // values of a push which are kept
+        static uint8_t const MAX_TEXT_SIZE = 48;                                                    // octet strings of a push (e.g. push setup and device name)
+
+        void clear(uint32_t const unixTime);                                                        // starts the frame of a push
+        bool addNumeric(uint8_t const channel, SmDeltaKind const kind, int64_t const value, int8_t const exponent, SmUnit const unit);  // appends a raw or fixed-point value, false if it does not fit
+        bool addText(uint8_t const channel, char const* text, uint8_t const length);                // appends an octet string, false if it does not fit
+        uint32_t getTime() const;                                                                   // time stamp of the push
+        uint8_t getCount() const;                                                                   // number of values
+        SmDeltaValue const& getAt(uint8_t const index) const;                                       // value at the index (index < getCount())
+        char const* getText(uint8_t const index) const;                                             // octets of the string at the index (not terminated, see SmDeltaValue::length)
+        bool hasSameLayout(SmDeltaFrame const& other) const;                                        // checks if the registers (channel, kind, exponent and unit) are the same
+        bool isEqual(uint8_t const index, SmDeltaFrame const& other) const;                         // checks if the value at the index is the same in both frames
+
+    private:
+        SmDeltaValue m_values[MAX_VALUES];                                                          // values in the order of the push
+        char m_text[MAX_TEXT_SIZE];                                                                 // octets of the strings, one after the other
+        uint32_t m_time = 0;                                                                        // time stamp of the push
+        uint8_t m_count = 0;                                                                        // number of values
+        uint8_t m_textSize = 0;                                                                     // used octets of the text
+};
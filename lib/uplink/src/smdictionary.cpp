@@ -0,0 +1,333 @@
+/**
+ * @file smdictionary.cpp
+ * @brief Implementation of the SmDictionary class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include <string.h>
+
+#include "smdictionary.h"
+
+/**
+ * @brief Drops the entries.
+ */
+void SmDictionary::clear()
+{
+    m_count = 0;
+    m_textSize = 0;
+}
+
+/**
+ * @brief Appends a numeric value.
+ *
+ * @param obis The OBIS code of the register.
+ * @param type The value type (TYPE_UINT8, TYPE_UINT16 or TYPE_UINT32).
+ * @param scaler The scaler of the register.
+ * @param unit The unit of the register.
+ * @return true if the entry was appended, false if the dictionary is full.
+ */
+bool SmDictionary::addNumeric(uint8_t const (&obis)[6], uint8_t const type, int8_t const scaler, SmUnit const unit)
+{
+    if(m_count >= MAX_ENTRIES)
+    {
+        return false;
+    }
+
+    SmDictionaryEntry& entry = m_entries[m_count++];
+
+    memcpy(entry.obis, obis, sizeof(entry.obis));
+
+    entry.type = type;
+    entry.scaler = scaler;
+    entry.unit = unit;
+    entry.textOffset = 0;
+    entry.textLength = 0;
+
+    return true;
+}
+
+/**
+ * @brief Appends an octet string, the octets are copied into the text of the dictionary.
+ *
+ * @param obis The OBIS code of the register.
+ * @param text The octets of the string.
+ * @param length The number of octets.
+ * @return true if the entry was appended, false if the dictionary or its text is full.
+ */
+bool SmDictionary::addText(uint8_t const (&obis)[6], char const* text, uint8_t const length)
+{
+    if(m_count >= MAX_ENTRIES || length > MAX_TEXT_SIZE - m_textSize)
+    {
+        return false;
+    }
+
+    SmDictionaryEntry& entry = m_entries[m_count++];
+
+    memcpy(entry.obis, obis, sizeof(entry.obis));
+
+    entry.type = TYPE_TEXT;
+    entry.scaler = 0;
+    entry.unit = SmUnit::SMUNIT_NONE;
+    entry.textOffset = m_textSize;
+    entry.textLength = length;
+
+    memcpy(m_text + m_textSize, text, length);
+
+    m_textSize += length;
+
+    return true;
+}
+
+/**
+ * @brief Adds a byte to the hash (FNV-1a step).
+ *
+ * @param hash The current hash.
+ * @param value The byte to add.
+ * @return The new hash.
+ */
+uint32_t SmDictionary::hashAdd(uint32_t hash, uint8_t const value)
+{
+    return (hash ^ value) * FNV_PRIME;
+}
+
+/**
+ * @brief Computes the hash over the entries, it is the hash of the encoded entries (without the hash itself).
+ *
+ * The hash only depends on the content, the server keeps the dictionary across restarts of the adapter.
+ *
+ * @return The FNV-1a hash.
+ */
+uint32_t SmDictionary::computeHash() const
+{
+    uint32_t hash = hashAdd(FNV_OFFSET_BASIS, m_count);
+
+    for(uint8_t i = 0; i < m_count; i++)
+    {
+        SmDictionaryEntry const& entry = m_entries[i];
+
+        for(uint8_t field = 0; field < sizeof(entry.obis); field++)
+        {
+            hash = hashAdd(hash, entry.obis[field]);
+        }
+
+        hash = hashAdd(hash, entry.type);
+
+        if(entry.type != TYPE_TEXT)
+        {
+            hash = hashAdd(hash, static_cast<uint8_t>(entry.scaler));
+            hash = hashAdd(hash, static_cast<uint8_t>(entry.unit));
+
+            continue;
+        }
+
+        hash = hashAdd(hash, entry.textLength);
+
+        for(uint8_t octet = 0; octet < entry.textLength; octet++)
+        {
+            hash = hashAdd(hash, static_cast<uint8_t>(m_text[entry.textOffset + octet]));
+        }
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Gets the number of entries.
+ *
+ * @return The number of entries.
+ */
+uint8_t SmDictionary::getCount() const
+{
+    return m_count;
+}
+
+/**
+ * @brief Gets an entry.
+ *
+ * @param index The index within the push (index < getCount()).
+ * @return The entry.
+ */
+SmDictionaryEntry const& SmDictionary::getAt(uint8_t const index) const
+{
+    return m_entries[index];
+}
+
+/**
+ * @brief Gets the octets of the string of an entry.
+ *
+ * @param index The index of a TYPE_TEXT entry.
+ * @return The octets, the length is the one of the entry.
+ */
+char const* SmDictionary::getText(uint8_t const index) const
+{
+    return m_text + m_entries[index].textOffset;
+}
+
+/**
+ * @brief Gets the size of a value uplink of the dictionary.
+ *
+ * @return Hash, time and the numeric values.
+ */
+size_t SmDictionary::getValuesSize() const
+{
+    size_t size = VALUES_HEADER_SIZE;
+
+    for(uint8_t i = 0; i < m_count; i++)
+    {
+        size += getTypeSize(m_entries[i].type);
+    }
+
+    return size;
+}
+
+/**
+ * @brief Gets the size of a numeric value.
+ *
+ * @param type The value type.
+ * @return The bytes of the value, 0 for octet strings and unknown types.
+ */
+uint8_t SmDictionary::getTypeSize(uint8_t const type)
+{
+    switch(type)
+    {
+        case TYPE_UINT8:
+            return 1;
+
+        case TYPE_UINT16:
+            return 2;
+
+        case TYPE_UINT32:
+            return 4;
+
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Encodes the dictionary.
+ *
+ * @param buffer The buffer for the dictionary.
+ * @param size The size of the buffer.
+ * @return The size of the dictionary, 0 if it does not fit.
+ */
+size_t SmDictionary::encode(uint8_t* buffer, size_t const size) const
+{
+    size_t required = sizeof(uint32_t) + 1;
+
+    for(uint8_t i = 0; i < m_count; i++)
+    {
+        required += sizeof(m_entries[i].obis) + 1 + (m_entries[i].type == TYPE_TEXT ? 1 + m_entries[i].textLength : 2);
+    }
+
+    if(required > size)
+    {
+        return 0;
+    }
+
+    uint32_t const hash = computeHash();
+    size_t position = 0;
+
+    buffer[position++] = (hash >> 24) & 0xff;
+    buffer[position++] = (hash >> 16) & 0xff;
+    buffer[position++] = (hash >> 8) & 0xff;
+    buffer[position++] = hash & 0xff;
+    buffer[position++] = m_count;
+
+    for(uint8_t i = 0; i < m_count; i++)
+    {
+        SmDictionaryEntry const& entry = m_entries[i];
+
+        memcpy(buffer + position, entry.obis, sizeof(entry.obis));
+
+        position += sizeof(entry.obis);
+
+        buffer[position++] = entry.type;
+
+        if(entry.type != TYPE_TEXT)
+        {
+            buffer[position++] = static_cast<uint8_t>(entry.scaler);
+            buffer[position++] = static_cast<uint8_t>(entry.unit);
+
+            continue;
+        }
+
+        buffer[position++] = entry.textLength;
+
+        memcpy(buffer + position, m_text + entry.textOffset, entry.textLength);
+
+        position += entry.textLength;
+    }
+
+    return position;
+}
+
+/**
+ * @brief Reads a dictionary (server side).
+ *
+ * @param cursor The read position, moved behind the dictionary.
+ * @param hash The hash sent with the dictionary.
+ * @return true if the dictionary was read and matches its hash, false if it is truncated or invalid.
+ */
+bool SmDictionary::decode(ByteCursor& cursor, uint32_t& hash)
+{
+    clear();
+
+    if(!cursor.has(sizeof(uint32_t) + 1))
+    {
+        return false;
+    }
+
+    hash = cursor.peekUint32(0);
+
+    uint8_t const count = cursor.peekUint8(sizeof(uint32_t));
+
+    cursor.skip(sizeof(uint32_t) + 1);
+
+    for(uint8_t i = 0; i < count; i++)
+    {
+        uint8_t obis[6];
+
+        if(!cursor.has(sizeof(obis) + 2))
+        {
+            return false;
+        }
+
+        memcpy(obis, cursor.current(), sizeof(obis));
+
+        uint8_t const type = cursor.peekUint8(sizeof(obis));
+        uint8_t const second = cursor.peekUint8(sizeof(obis) + 1);
+
+        cursor.skip(sizeof(obis) + 2);
+
+        bool added;
+
+        if(type == TYPE_TEXT)
+        {
+            added = cursor.has(second) && addText(obis, reinterpret_cast<char const*>(cursor.current()), second);
+
+            if(added)
+            {
+                cursor.skip(second);
+            }
+        }
+        else
+        {
+            added = getTypeSize(type) != 0 && cursor.has(1) && addNumeric(obis, type, static_cast<int8_t>(second), static_cast<SmUnit>(cursor.peekUint8(0)));
+
+            if(added)
+            {
+                cursor.skip(1);
+            }
+        }
+
+        if(!added)
+        {
+            return false;
+        }
+    }
+
+    return computeHash() == hash;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file smdictionary.h
+ * @brief This file contains the declaration of the SmDictionary class and the SmDictionaryEntry.
+ *
+ * The dictionary describes the values of a push once: OBIS code, value type, scaler and unit of each register
+ * in the order of the push. Octet strings (e.g. the device name) do not change from push to push, they are sent
+ * with the dictionary and not with the values. The dictionary is identified by a hash over its content, the
+ * value uplinks carry the hash and the numeric values in the order of the dictionary only.
+ *
+ * Dictionary: hash (uint32), entry count, each entry: OBIS code (6 bytes), value type and
+ *             numeric: scaler, unit, octet string: length, octets
+ * Values:     hash (uint32), time (uint32), each numeric value with the size of its type (all big endian)
+ *
+ * The value types are the ones of the meter data records of SmCayenne (1 uint8, 2 uint16, 3 uint32, 4 octet
+ * string).
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "bytecursor.h"
+#include "smprofile.h"
+
+/**
+ * @brief Description of one value of the push.
+ */
+struct SmDictionaryEntry
+{
+    uint8_t obis[6];                                                                                // OBIS code, fields A to F
+    uint8_t type;                                                                                   // value type (SmDictionary::TYPE_*)
+    int8_t scaler;                                                                                  // scaler of a numeric value (value = raw * 10^scaler)
+    SmUnit unit;                                                                                    // unit of a numeric value
+    uint8_t textOffset;                                                                             // offset of the octet string within the text of the dictionary
+    uint8_t textLength;                                                                             // length of the octet string, 0 for numeric values
+};
+
+class SmDictionary
+{
+    public:
+        static uint8_t const TYPE_UINT8 = 1;                                                        // numeric value, 1 byte
+        static uint8_t const TYPE_UINT16 = 2;                                                       // numeric value, 2 bytes
+        static uint8_t const TYPE_UINT32 = 3;                                                       // numeric value, 4 bytes
+        static uint8_t const TYPE_TEXT = 4;                                                         // octet string, sent with the dictionary
+        static uint8_t const MAX_ENTRIES = 24;                                                      // values of a push which are described
+        static uint8_t const MAX_TEXT_SIZE = 48;                                                    // octet strings of a push (e.g. push setup and device name)
+        static uint8_t const VALUES_HEADER_SIZE = 8;                                                // hash and time of the value uplink
+
+        void clear();                                                                               // drops the entries
+        bool addNumeric(uint8_t const (&obis)[6], uint8_t const type, int8_t const scaler, SmUnit const unit);  // appends a numeric value, false if it does not fit
+        bool addText(uint8_t const (&obis)[6], char const* text, uint8_t const length);             // appends an octet string, false if it does not fit
+        uint32_t computeHash() const;                                                               // hash over the entries (FNV-1a)
+        uint8_t getCount() const;                                                                   // number of entries
+        SmDictionaryEntry const& getAt(uint8_t const index) const;                                  // entry at the index (index < getCount())
+        char const* getText(uint8_t const index) const;                                             // octets of the string of the entry (not terminated)
+        size_t getValuesSize() const;                                                               // size of the value uplink
+        size_t encode(uint8_t* buffer, size_t const size) const;                                    // encodes the dictionary, 0 if it does not fit
+        bool decode(ByteCursor& cursor, uint32_t& hash);                                            // reads a dictionary, false if it is truncated or invalid
+        static uint8_t getTypeSize(uint8_t const type);                                             // bytes of a numeric value, 0 for octet strings
+
+    private:
+        static uint32_t const FNV_OFFSET_BASIS = 2166136261u;                                       // FNV-1a constants (byte wise hash of the encoded entries)
+        static uint32_t const FNV_PRIME = 16777619u;
+
+        SmDictionaryEntry m_entries[MAX_ENTRIES];                                                   // entries in the order of the push
+        char m_text[MAX_TEXT_SIZE];                                                                 // octets of the strings, one after the other
+        uint8_t m_count = 0;                                                                        // number of entries
+        uint8_t m_textSize = 0;                                                                     // used octets of the text
+
+        static uint32_t hashAdd(uint32_t hash, uint8_t const value);                                // adds a byte to the hash
+};
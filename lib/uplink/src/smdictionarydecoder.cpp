@@ -0,0 +1,132 @@
+/**
+ * @file smdictionarydecoder.cpp
+ * @brief Implementation of the SmDictionaryDecoder class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include "bytecursor.h"
+#include "smdictionarydecoder.h"
+
+/**
+ * @brief Drops the dictionaries, the next value uplinks are rejected till their dictionary is received.
+ */
+void SmDictionaryDecoder::reset()
+{
+    m_count = 0;
+    m_next = 0;
+}
+
+/**
+ * @brief Keeps a received dictionary, the oldest one is replaced.
+ *
+ * @param data The dictionary.
+ * @param size The size of the dictionary.
+ * @return true if the dictionary is valid (complete and matching its hash), false otherwise.
+ */
+bool SmDictionaryDecoder::addDictionary(uint8_t const* data, size_t const size)
+{
+    ByteCursor cursor(data, size);
+    SmDictionary dictionary;
+    uint32_t hash;
+
+    if(!dictionary.decode(cursor, hash) || cursor.remaining() != 0)
+    {
+        return false;
+    }
+
+    // a repeated dictionary is kept once
+    if(find(hash) != nullptr)
+    {
+        return true;
+    }
+
+    m_dictionaries[m_next] = dictionary;
+    m_hashes[m_next] = hash;
+
+    m_next = (m_next + 1) % MAX_DICTIONARIES;
+
+    if(m_count < MAX_DICTIONARIES)
+    {
+        m_count++;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Decodes a value uplink with its dictionary.
+ *
+ * @param data The value uplink.
+ * @param size The size of the value uplink.
+ * @param values The values of the push.
+ * @return true if the values were decoded, false if the dictionary is unknown or the size does not match it.
+ */
+bool SmDictionaryDecoder::decodeValues(uint8_t const* data, size_t const size, SmDictionaryValues& values) const
+{
+    ByteCursor cursor(data, size);
+
+    if(!cursor.has(SmDictionary::VALUES_HEADER_SIZE))
+    {
+        return false;
+    }
+
+    SmDictionary const* dictionary = find(cursor.peekUint32(0));
+
+    if(dictionary == nullptr || dictionary->getValuesSize() != size)
+    {
+        return false;
+    }
+
+    values.dictionary = dictionary;
+    values.unixTime = cursor.peekUint32(sizeof(uint32_t));
+
+    cursor.skip(SmDictionary::VALUES_HEADER_SIZE);
+
+    for(uint8_t i = 0; i < dictionary->getCount(); i++)
+    {
+        uint32_t value = 0;
+
+        for(uint8_t byte = SmDictionary::getTypeSize(dictionary->getAt(i).type); byte > 0; byte--)
+        {
+            value = (value << 8) | cursor.peekUint8(0);
+
+            cursor.skip(1);
+        }
+
+        values.values[i] = value;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Checks if a dictionary was received.
+ *
+ * @param hash The hash of the dictionary.
+ * @return true if the dictionary is kept.
+ */
+bool SmDictionaryDecoder::isKnown(uint32_t const hash) const
+{
+    return find(hash) != nullptr;
+}
+
+/**
+ * @brief Finds a dictionary by its hash.
+ *
+ * @param hash The hash of the dictionary.
+ * @return The dictionary, nullptr if it was not received or was replaced.
+ */
+SmDictionary const* SmDictionaryDecoder::find(uint32_t const hash) const
+{
+    for(uint8_t i = 0; i < m_count; i++)
+    {
+        if(m_hashes[i] == hash)
+        {
+            return &m_dictionaries[i];
+        }
+    }
+
+    return nullptr;
+}
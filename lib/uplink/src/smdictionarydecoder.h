@@ -0,0 +1,47 @@
+/**
+ * @file smdictionarydecoder.h
+ * @brief This file contains the declaration of the SmDictionaryDecoder class and the SmDictionaryValues.
+ *
+ * Server side counterpart of the SmDictionarySession, used by the host tests. The decoder keeps the last
+ * received dictionaries by their hash, a value uplink with an unknown hash is rejected and the server requests
+ * the dictionary by downlink.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "smdictionary.h"
+
+/**
+ * @brief Values of a push decoded with their dictionary.
+ */
+struct SmDictionaryValues
+{
+    SmDictionary const* dictionary;                                                                 // dictionary of the values (OBIS code, scaler, unit and the octet strings)
+    uint32_t unixTime;                                                                              // time stamp of the push
+    uint32_t values[SmDictionary::MAX_ENTRIES];                                                     // raw value of each numeric entry (0 for octet strings)
+};
+
+class SmDictionaryDecoder
+{
+    public:
+        static uint8_t const MAX_DICTIONARIES = 4;                                                  // dictionaries kept (e.g. of several meters)
+
+        void reset();                                                                               // drops the dictionaries
+        bool addDictionary(uint8_t const* data, size_t const size);                                 // keeps a received dictionary, false if it is invalid
+        bool decodeValues(uint8_t const* data, size_t const size, SmDictionaryValues& values) const;    // decodes a value uplink, false if its dictionary is unknown or the size does not match
+        bool isKnown(uint32_t const hash) const;                                                    // checks if the dictionary with the hash was received
+
+    private:
+        SmDictionary m_dictionaries[MAX_DICTIONARIES];                                              // received dictionaries
+        uint32_t m_hashes[MAX_DICTIONARIES];                                                        // hash of each dictionary
+        uint8_t m_count = 0;                                                                        // number of dictionaries kept
+        uint8_t m_next = 0;                                                                         // index of the next dictionary to be replaced
+
+        SmDictionary const* find(uint32_t const hash) const;                                        // dictionary with the hash, nullptr if unknown
+};
@@ -0,0 +1,201 @@
+/**
+ * @file smdictionarysession.cpp
+ * @brief Implementation of the SmDictionarySession class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include "gbtoctetstring.h"
+#include "mylog.h"
+#include "smdictionarysession.h"
+#include "smscaler.h"
+
+static_assert(static_cast<uint8_t>(GbtValueBase::GbtValueType::GBTVALUETYPE_UINT8) == SmDictionary::TYPE_UINT8
+    && static_cast<uint8_t>(GbtValueBase::GbtValueType::GBTVALUETYPE_UINT16) == SmDictionary::TYPE_UINT16
+    && static_cast<uint8_t>(GbtValueBase::GbtValueType::GBTVALUETYPE_UINT32) == SmDictionary::TYPE_UINT32, "numeric value types of the dictionary and the parser");
+
+/**
+ * @brief Forgets the sent dictionary (e.g. after a profile change), it is sent with the next push.
+ */
+void SmDictionarySession::reset()
+{
+    m_dictionary.clear();
+
+    m_hash = 0;
+    m_sent = false;
+    m_requested = false;
+}
+
+/**
+ * @brief Takes the dictionary and the values of a push.
+ *
+ * The values are taken in the order of the push like the records of the extraction (see SmPushExtractor),
+ * values without register in the profile are not sent. The dictionary is built for every push, its hash
+ * tells if it changed.
+ *
+ * @param gbtData The parsed push.
+ * @param layout The resolved layout of the push.
+ * @return true if the values were taken, false if the push ends early or has too many values.
+ */
+bool SmDictionarySession::update(GbtDataBase const& gbtData, SmPushLayout const& layout)
+{
+    m_dictionary.clear();
+
+    m_time = gbtData.getDateTime().asUnixTimeStamp();
+
+    for(uint8_t i = 0; i < layout.getValueCount(); i++)
+    {
+        SmRegister const* smRegister = layout.getRegister(i);
+        GbtValueBase const* gbtValue = gbtData.getValue(layout.getValueIndex(i));
+
+        if(smRegister == nullptr)
+        {
+            continue;
+        }
+
+        uint8_t obis[6];
+
+        if(gbtValue == nullptr || !SmProfiles::parseObis(smRegister->obis, obis))
+        {
+            MyLog::log("SMDICT", "Value %d missing or invalid OBIS code", i);
+
+            return false;
+        }
+
+        bool added;
+
+        if(gbtValue->getValueType() == GbtValueBase::GbtValueType::GBTVALUETYPE_OCTETESTRING)
+        {
+            auto gbt = static_cast<GbtOctetString const*>(gbtValue);
+
+            added = m_dictionary.addText(obis, gbt->getStringValue(), static_cast<uint8_t>(gbt->getStringLength()));
+        }
+        else
+        {
+            int64_t raw;
+
+            // the value types of the dictionary are the ones of the parser
+            added = SmScaler::getRawValue(gbtValue, raw)
+                && m_dictionary.addNumeric(obis, static_cast<uint8_t>(gbtValue->getValueType()), layout.getScaler(i), layout.getUnit(i));
+
+            if(added)
+            {
+                m_values[m_dictionary.getCount() - 1] = static_cast<uint32_t>(raw);
+            }
+        }
+
+        if(!added)
+        {
+            MyLog::log("SMDICT", "Value %d does not fit into the dictionary", i);
+
+            return false;
+        }
+    }
+
+    m_hash = m_dictionary.computeHash();
+
+    return true;
+}
+
+/**
+ * @brief Checks if the dictionary has to be sent with the values.
+ *
+ * @return true if no dictionary was sent, if it changed or if the server requested it.
+ */
+bool SmDictionarySession::isDictionaryDue() const
+{
+    return !m_sent || m_sentHash != m_hash || m_requested;
+}
+
+/**
+ * @brief The server requests the dictionary, it is sent with the next push.
+ */
+void SmDictionarySession::requestDictionary()
+{
+    m_requested = true;
+}
+
+/**
+ * @brief The dictionary of the last push was sent, the next uplinks carry its hash.
+ */
+void SmDictionarySession::dictionarySent()
+{
+    MyLog::log("SMDICT", "Dictionary %08lx with %d entries sent", (unsigned long) m_hash, m_dictionary.getCount());
+
+    m_sentHash = m_hash;
+    m_sent = true;
+    m_requested = false;
+}
+
+/**
+ * @brief Gets the hash of the dictionary of the last push.
+ *
+ * @return The hash.
+ */
+uint32_t SmDictionarySession::getHash() const
+{
+    return m_hash;
+}
+
+/**
+ * @brief Gets the dictionary of the last push.
+ *
+ * @return The dictionary.
+ */
+SmDictionary const& SmDictionarySession::getDictionary() const
+{
+    return m_dictionary;
+}
+
+/**
+ * @brief Encodes the dictionary of the last push.
+ *
+ * @param buffer The buffer for the dictionary.
+ * @param size The size of the buffer.
+ * @return The size of the dictionary, 0 if it does not fit.
+ */
+size_t SmDictionarySession::encodeDictionary(uint8_t* buffer, size_t const size) const
+{
+    return m_dictionary.encode(buffer, size);
+}
+
+/**
+ * @brief Encodes the hash of the dictionary, the time stamp and the numeric values of the last push.
+ *
+ * @param buffer The buffer for the values.
+ * @param size The size of the buffer.
+ * @return The size of the values, 0 if they do not fit.
+ */
+size_t SmDictionarySession::encodeValues(uint8_t* buffer, size_t const size) const
+{
+    if(m_dictionary.getValuesSize() > size)
+    {
+        return 0;
+    }
+
+    size_t position = 0;
+
+    uint32_t const header[2] = { m_hash, m_time };
+
+    for(uint8_t i = 0; i < 2; i++)
+    {
+        buffer[position++] = (header[i] >> 24) & 0xff;
+        buffer[position++] = (header[i] >> 16) & 0xff;
+        buffer[position++] = (header[i] >> 8) & 0xff;
+        buffer[position++] = header[i] & 0xff;
+    }
+
+    for(uint8_t i = 0; i < m_dictionary.getCount(); i++)
+    {
+        uint8_t const typeSize = SmDictionary::getTypeSize(m_dictionary.getAt(i).type);
+
+        // big endian, the low bytes of the value
+        for(uint8_t byte = typeSize; byte > 0; byte--)
+        {
+            buffer[position++] = (m_values[i] >> (8 * (byte - 1))) & 0xff;
+        }
+    }
+
+    return position;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file smdictionarysession.h
+ * @brief This file contains the declaration of the SmDictionarySession class.
+ *
+ * Device side of the dictionary session: the dictionary of the push (see SmDictionary) is sent once, the
+ * following uplinks carry the hash of the dictionary and the values in its order only. The dictionary is
+ * sent again if its hash changes (another push layout, profile or device name) or if the server requests it
+ * (e.g. after it lost its copy).
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "gbtdata.h"
+#include "smdictionary.h"
+#include "smpushlayout.h"
+
+class SmDictionarySession
+{
+    public:
+        void reset();                                                                               // forgets the sent dictionary, it is sent with the next push
+        bool update(GbtDataBase const& gbtData, SmPushLayout const& layout);                        // takes the dictionary and the values of the push, false if they do not fit
+        bool isDictionaryDue() const;                                                               // checks if the dictionary has to be sent with the values
+        void requestDictionary();                                                                   // the server requests the dictionary
+        void dictionarySent();                                                                      // the dictionary was sent
+        uint32_t getHash() const;                                                                   // hash of the dictionary of the last push
+        SmDictionary const& getDictionary() const;                                                  // dictionary of the last push
+        size_t encodeDictionary(uint8_t* buffer, size_t const size) const;                          // encodes the dictionary, 0 if it does not fit
+        size_t encodeValues(uint8_t* buffer, size_t const size) const;                              // encodes hash, time and values of the push, 0 if they do not fit
+
+    private:
+        SmDictionary m_dictionary;                                                                  // dictionary of the last push
+        uint32_t m_values[SmDictionary::MAX_ENTRIES];                                               // numeric values of the last push in the order of the dictionary
+        uint32_t m_time = 0;                                                                        // time stamp of the last push
+        uint32_t m_hash = 0;                                                                        // hash of the dictionary of the last push
+        uint32_t m_sentHash = 0;                                                                    // hash of the last sent dictionary
+        bool m_sent = false;                                                                        // flag indicating if a dictionary was sent
+        bool m_requested = false;                                                                   // flag indicating if the server requested the dictionary
+};
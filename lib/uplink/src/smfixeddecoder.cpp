@@ -0,0 +1,41 @@
+/**
+ * @file smfixeddecoder.cpp
+ * @brief Implementation of the SmFixedDecoder class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include "smfixeddecoder.h"
+
+/**
+ * @brief Reads a fixed payload.
+ *
+ * @param layout The layout of the profile of the meter.
+ * @param data The payload.
+ * @param size The size of the payload.
+ * @param values The time stamp, the presence flags and the values of the fields.
+ * @return true if the payload was read, false if its size does not match the layout.
+ */
+bool SmFixedDecoder::decode(SmFixedLayout const& layout, uint8_t const* data, size_t const size, SmFixedValues& values)
+{
+    if(data == nullptr || size != layout.getSize())
+    {
+        return false;
+    }
+
+    values.unixTime = SmFixedLayout::readBits(data, 0, SmFixedLayout::TIME_BITS);
+    values.present = 0;
+
+    for(uint8_t i = 0; i < layout.fieldCount; i++)
+    {
+        values.values[i] = SmFixedLayout::readBits(data, layout.getBitOffset(i), layout.fields[i].bits);
+
+        if(SmFixedLayout::readBits(data, layout.getFlagOffset(i), 1) != 0)
+        {
+            values.present |= 1UL << i;
+        }
+    }
+
+    return true;
+}
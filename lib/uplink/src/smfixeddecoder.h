@@ -0,0 +1,33 @@
+/**
+ * @file smfixeddecoder.h
+ * @brief This file contains the declaration of the SmFixedDecoder class and the SmFixedValues.
+ *
+ * Server side counterpart of the SmFixedEncoder, used by the host tests. The fields are read with the offsets
+ * of the same layout table (see SmFixedLayout) the device packs them with.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "smfixedlayout.h"
+
+/**
+ * @brief Values of a fixed payload.
+ */
+struct SmFixedValues
+{
+    uint32_t unixTime;                                                                              // time stamp of the push
+    uint32_t present;                                                                               // presence flag of each field (bit 0 is the first field)
+    uint32_t values[SmFixedLayout::MAX_FIELDS];                                                     // raw value of each field, 0 if not present
+};
+
+class SmFixedDecoder
+{
+    public:
+        static bool decode(SmFixedLayout const& layout, uint8_t const* data, size_t const size, SmFixedValues& values);  // reads a payload, false if the size does not match the layout
+};
@@ -0,0 +1,154 @@
+/**
+ * @file smfixedencoder.cpp
+ * @brief Implementation of the SmFixedEncoder class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include <string.h>
+
+#include "mylog.h"
+#include "smfixedencoder.h"
+#include "smscaler.h"
+
+/**
+ * @brief Selects the layout of a profile, the cached fields are dropped.
+ *
+ * @param profileId The identifier of the profile (see SmProfiles).
+ * @return true if the profile has a fixed layout, false otherwise.
+ */
+bool SmFixedEncoder::select(uint8_t const profileId)
+{
+    m_layout = SmFixedLayouts::find(profileId);
+    m_mapped = false;
+
+    return m_layout != nullptr;
+}
+
+/**
+ * @brief Looks up the field of each value of the push.
+ *
+ * @param pushLayout The resolved layout of the push.
+ */
+void SmFixedEncoder::mapFields(SmPushLayout const& pushLayout)
+{
+    for(uint8_t i = 0; i < pushLayout.getValueCount(); i++)
+    {
+        SmRegister const* smRegister = pushLayout.getRegister(i);
+
+        int8_t field = smRegister != nullptr ? m_layout->findField(smRegister->obis) : -1;
+
+        m_fieldIndex[i] = field >= 0 ? static_cast<uint8_t>(field) : NO_FIELD;
+    }
+
+    m_pushHash = pushLayout.getHash();
+    m_mapped = true;
+}
+
+/**
+ * @brief Takes the values of a push into the fields of the layout.
+ *
+ * A field without value in the push or whose value does not fit into its width is not present.
+ *
+ * @param gbtData The parsed push.
+ * @param pushLayout The resolved layout of the push.
+ * @return true if the values were taken, false if no layout is selected.
+ */
+bool SmFixedEncoder::update(GbtDataBase const& gbtData, SmPushLayout const& pushLayout)
+{
+    if(m_layout == nullptr)
+    {
+        return false;
+    }
+
+    if(!m_mapped || m_pushHash != pushLayout.getHash())
+    {
+        mapFields(pushLayout);
+    }
+
+    m_time = gbtData.getDateTime().asUnixTimeStamp();
+    m_present = 0;
+
+    for(uint8_t i = 0; i < pushLayout.getValueCount(); i++)
+    {
+        uint8_t const field = m_fieldIndex[i];
+
+        int64_t raw;
+
+        if(field == NO_FIELD || !SmScaler::getRawValue(gbtData.getValue(pushLayout.getValueIndex(i)), raw))
+        {
+            continue;
+        }
+
+        uint8_t const bits = m_layout->fields[field].bits;
+
+        if(raw < 0 || (raw >> bits) != 0)
+        {
+            MyLog::log("SMFIXED", "Value of %s does not fit into %d bits", m_layout->fields[field].obis, bits);
+
+            continue;
+        }
+
+        m_values[field] = static_cast<uint32_t>(raw);
+        m_present |= 1UL << field;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Packs the time stamp, the presence flags and the fields.
+ *
+ * @param buffer The buffer for the payload.
+ * @param size The size of the buffer.
+ * @return The size of the payload, 0 if no layout is selected or the payload does not fit.
+ */
+size_t SmFixedEncoder::encode(uint8_t* buffer, size_t const size) const
+{
+    if(m_layout == nullptr || m_layout->getSize() > size)
+    {
+        return 0;
+    }
+
+    memset(buffer, 0, m_layout->getSize());
+
+    SmFixedLayout::writeBits(buffer, 0, SmFixedLayout::TIME_BITS, m_time);
+
+    uint16_t offset = m_layout->getBitOffset(0);
+
+    for(uint8_t i = 0; i < m_layout->fieldCount; i++)
+    {
+        uint8_t const bits = m_layout->fields[i].bits;
+
+        if(m_present & (1UL << i))
+        {
+            SmFixedLayout::writeBits(buffer, m_layout->getFlagOffset(i), 1, 1);
+            SmFixedLayout::writeBits(buffer, offset, bits, m_values[i]);
+        }
+
+        offset += bits;
+    }
+
+    return m_layout->getSize();
+}
+
+/**
+ * @brief Gets the selected layout.
+ *
+ * @return The layout, nullptr if the profile has none.
+ */
+SmFixedLayout const* SmFixedEncoder::getLayout() const
+{
+    return m_layout;
+}
+
+/**
+ * @brief Gets the presence flags of the last push.
+ *
+ * @return One bit for each field, bit 0 is the first field.
+ */
+uint32_t SmFixedEncoder::getPresentFlags() const
+{
+    return m_present;
+}
@@ -0,0 +1,43 @@
+/**
+ * @file smfixedencoder.h
+ * @brief This file contains the declaration of the SmFixedEncoder class.
+ *
+ * Device side of the fixed payload (see SmFixedLayout): takes the numeric values of the push into the fields
+ * of the layout of the profile and packs them without headers. The field of each value of the push is looked up
+ * once per push layout (layout hash) and cached.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "gbtdata.h"
+#include "smfixedlayout.h"
+#include "smpushlayout.h"
+
+class SmFixedEncoder
+{
+    public:
+        bool select(uint8_t const profileId);                                                       // selects the layout of the profile, false if the profile has none
+        bool update(GbtDataBase const& gbtData, SmPushLayout const& pushLayout);                    // takes the values of the push into the fields, false without layout
+        size_t encode(uint8_t* buffer, size_t const size) const;                                    // packs the fields, 0 if they do not fit
+        SmFixedLayout const* getLayout() const;                                                     // selected layout, nullptr if none
+        uint32_t getPresentFlags() const;                                                           // presence flag of each field (bit 0 is the first field)
+
+    private:
+        static uint8_t const NO_FIELD = 0xff;                                                       // value of the push without field in the layout
+
+        SmFixedLayout const* m_layout = nullptr;                                                    // layout of the selected profile
+        uint32_t m_time = 0;                                                                        // time stamp of the push
+        uint32_t m_values[SmFixedLayout::MAX_FIELDS];                                               // raw value of each field
+        uint32_t m_present = 0;                                                                     // presence flag of each field
+        uint32_t m_pushHash = 0;                                                                    // hash of the push layout of the cached fields
+        bool m_mapped = false;                                                                      // flag indicating if the fields of the push layout are cached
+        uint8_t m_fieldIndex[SmPushLayout::MAX_PUSHVALUES];                                         // field of each value of the push (NO_FIELD if not sent)
+
+        void mapFields(SmPushLayout const& pushLayout);                                             // looks up the field of each value of the push
+};
@@ -0,0 +1,153 @@
+/**
+ * @file smfixedlayout.cpp
+ * @brief Implementation of the fixed payload layouts.
+ *
+ * The tables are constexpr, they are placed in flash and do not use any RAM. The layouts are checked at build
+ * time, the OBIS codes against the registers of the profile by the unit test (isInProfile). To send a fixed payload
+ * for a new meter add a field table and an entry in SM_FIXED_LAYOUTS.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include <string.h>
+
+#include "smfixedlayout.h"
+#include "smprofile.h"
+
+/**
+ * @brief Fields of the Landis+Gyr E450 push, the widths cover the range of a household meter.
+ */
+static constexpr SmFixedField SM_FIXED_FIELDS_LG_E450[] = {
+    { "1.0.1.7.0.255",   20 },                                                                      // active power +P (W, up to 1 MW)
+    { "1.0.2.7.0.255",   20 },                                                                      // active power -P (W, up to 1 MW)
+    { "1.1.1.8.0.255",   32 },                                                                      // active energy +A (Wh)
+    { "1.1.2.8.0.255",   32 },                                                                      // active energy -A (Wh)
+    { "1.1.5.8.0.255",   32 },                                                                      // reactive energy QI (varh)
+    { "1.1.6.8.0.255",   32 },                                                                      // reactive energy QII (varh)
+    { "1.1.7.8.0.255",   32 },                                                                      // reactive energy QIII (varh)
+    { "1.1.8.8.0.255",   32 },                                                                      // reactive energy QIV (varh)
+    { "1.0.130.7.0.255", 32 },                                                                      // manufacturer specific instantaneous value
+    { "1.0.31.7.0.255",  16 },                                                                      // current L1 (0.01 A)
+    { "1.0.51.7.0.255",  16 },                                                                      // current L2 (0.01 A)
+    { "1.0.71.7.0.255",  16 }                                                                       // current L3 (0.01 A)
+};
+
+/**
+ * @brief Fixed layouts of the profiles, a profile without layout sends the full push instead.
+ */
+static constexpr SmFixedLayout SM_FIXED_LAYOUTS[] = {
+    { SmProfiles::SMPROFILE_LG_E450, SM_FIXED_FIELDS_LG_E450, sizeof(SM_FIXED_FIELDS_LG_E450) / sizeof(SmFixedField) }
+};
+
+static_assert(SM_FIXED_LAYOUTS[0].isValid(), "E450 layout: at most 32 fields of 1 to 32 bits");
+static_assert(SM_FIXED_LAYOUTS[0].getSize() == 45, "E450 layout: 32 bits time, 12 flags and 312 bits of values in 45 bytes");
+
+/**
+ * @brief Looks up the field of an OBIS code.
+ *
+ * @param obis The OBIS code as formatted by GbtOctetString.
+ * @return The index of the field, -1 if the OBIS code is not in the layout.
+ */
+int8_t SmFixedLayout::findField(char const* obis) const
+{
+    for(uint8_t i = 0; i < fieldCount; i++)
+    {
+        if(strcmp(fields[i].obis, obis) == 0)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Checks if every field of the layout is a register of its profile.
+ *
+ * The OBIS codes of the fields are compared with the register table of the profile, a field whose code is not
+ * there (e.g. a typo) would never be present in the payload.
+ *
+ * @return true if the profile is known and has a register for each field, false otherwise.
+ */
+bool SmFixedLayout::isInProfile() const
+{
+    SmProfile const* profile = SmProfiles::find(profileId);
+
+    if(profile == nullptr)
+    {
+        return false;
+    }
+
+    for(uint8_t i = 0; i < fieldCount; i++)
+    {
+        if(profile->findRegister(fields[i].obis) == nullptr)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Sets the bits of a value, most significant bit first.
+ *
+ * @param buffer The payload, cleared before the first value is written.
+ * @param offset The bit offset of the value.
+ * @param bits The bit width of the value.
+ * @param value The value, the bits above the width are ignored.
+ */
+void SmFixedLayout::writeBits(uint8_t* buffer, uint16_t const offset, uint8_t const bits, uint32_t const value)
+{
+    for(uint8_t i = 0; i < bits; i++)
+    {
+        if((value >> (bits - 1 - i)) & 1)
+        {
+            uint16_t const bit = offset + i;
+
+            buffer[bit / 8] |= 0x80 >> (bit % 8);
+        }
+    }
+}
+
+/**
+ * @brief Gets the bits of a value, most significant bit first.
+ *
+ * @param buffer The payload.
+ * @param offset The bit offset of the value.
+ * @param bits The bit width of the value.
+ * @return The value.
+ */
+uint32_t SmFixedLayout::readBits(uint8_t const* buffer, uint16_t const offset, uint8_t const bits)
+{
+    uint32_t value = 0;
+
+    for(uint8_t i = 0; i < bits; i++)
+    {
+        uint16_t const bit = offset + i;
+
+        value = (value << 1) | ((buffer[bit / 8] >> (7 - bit % 8)) & 1);
+    }
+
+    return value;
+}
+
+/**
+ * @brief Looks up the fixed layout of a profile.
+ *
+ * @param profileId The identifier of the profile.
+ * @return The layout, nullptr if the profile has none.
+ */
+SmFixedLayout const* SmFixedLayouts::find(uint8_t const profileId)
+{
+    for(size_t i = 0; i < sizeof(SM_FIXED_LAYOUTS) / sizeof(SmFixedLayout); i++)
+    {
+        if(SM_FIXED_LAYOUTS[i].profileId == profileId)
+        {
+            return &SM_FIXED_LAYOUTS[i];
+        }
+    }
+
+    return nullptr;
+}
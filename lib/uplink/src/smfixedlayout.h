@@ -0,0 +1,105 @@
+/**
+ * @file smfixedlayout.h
+ * @brief This file contains the fixed payload layouts (SmFixedLayout) of the meter profiles and their lookup.
+ *
+ * A fixed layout describes the payload of a profile as a constexpr table: the OBIS code and the bit width of
+ * each field. The payload has no headers, the offset of every field is known at build time:
+ *
+ * Payload: time (32 bits), presence flags (one bit per field), each field with its bit width (raw value)
+ *
+ * All fields are packed one after the other, most significant bit first. A field which is not in the push or
+ * whose value does not fit into its width has its presence flag cleared and is 0. The device encoder
+ * (SmFixedEncoder) and the server decoder (SmFixedDecoder) use the same table, they cannot drift apart.
+ * The OBIS codes of the fields repeat the registers of the profile (SmProfiles), isInProfile() checks them
+ * (unit test), a field which is not a register of the profile would never be present.
+ * Octet strings (e.g. the device name) are not part of a fixed layout.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Field of a fixed layout.
+ */
+struct SmFixedField
+{
+    char const* obis;                                                                               // OBIS code as formatted by GbtOctetString (e.g. "1.1.1.8.0.255")
+    uint8_t bits;                                                                                   // bit width of the raw value, 1 to 32
+};
+
+/**
+ * @brief Fixed payload layout of one meter profile.
+ */
+struct SmFixedLayout
+{
+    static uint8_t const TIME_BITS = 32;                                                            // bit width of the time stamp at the start of the payload
+    static uint8_t const MAX_FIELDS = 32;                                                           // fields of a layout (presence flags in one uint32_t)
+
+    uint8_t profileId;                                                                              // identifier of the profile (see SmProfiles)
+    SmFixedField const* fields;                                                                     // fields in the order of the payload, in flash
+    uint8_t fieldCount;                                                                             // number of fields
+
+    constexpr uint16_t getFlagOffset(uint8_t const index) const;                                    // bit offset of the presence flag of the field
+    constexpr uint16_t getBitOffset(uint8_t const index) const;                                     // bit offset of the field, of the end for index fieldCount
+    constexpr size_t getSize() const;                                                               // size of the payload in bytes
+    constexpr bool isValid(uint8_t const index = 0) const;                                          // checks the field count and the bit widths from index on
+
+    int8_t findField(char const* obis) const;                                                       // index of the field of the OBIS code, -1 if it is not in the layout
+    bool isInProfile() const;                                                                       // checks if every field is a register of the profile
+    static void writeBits(uint8_t* buffer, uint16_t const offset, uint8_t const bits, uint32_t const value);  // sets the bits of a value, the buffer is cleared before
+    static uint32_t readBits(uint8_t const* buffer, uint16_t const offset, uint8_t const bits);     // gets the bits of a value
+};
+
+class SmFixedLayouts
+{
+    public:
+        static SmFixedLayout const* find(uint8_t const profileId);                                  // returns the layout of the profile, nullptr if the profile has none
+};
+
+/**
+ * @brief Gets the bit offset of the presence flag of a field, the flags follow the time stamp.
+ *
+ * @param index The index of the field.
+ * @return The bit offset within the payload.
+ */
+constexpr uint16_t SmFixedLayout::getFlagOffset(uint8_t const index) const
+{
+    return TIME_BITS + index;
+}
+
+/**
+ * @brief Gets the bit offset of a field, the fields follow the presence flags.
+ *
+ * @param index The index of the field, fieldCount for the end of the payload.
+ * @return The bit offset within the payload.
+ */
+constexpr uint16_t SmFixedLayout::getBitOffset(uint8_t const index) const
+{
+    return index == 0 ? TIME_BITS + fieldCount : getBitOffset(index - 1) + fields[index - 1].bits;
+}
+
+/**
+ * @brief Gets the size of the payload.
+ *
+ * @return The size in bytes, the last byte is padded with 0 bits.
+ */
+constexpr size_t SmFixedLayout::getSize() const
+{
+    return (getBitOffset(fieldCount) + 7) / 8;
+}
+
+/**
+ * @brief Checks the layout, used by the static_assert of the layout table.
+ *
+ * @param index The first field to check.
+ * @return true if the field count fits the presence flags and all widths are 1 to 32 bits.
+ */
+constexpr bool SmFixedLayout::isValid(uint8_t const index) const
+{
+    return fieldCount <= MAX_FIELDS && (index >= fieldCount || (fields[index].bits >= 1 && fields[index].bits <= 32 && isValid(index + 1)));
+}
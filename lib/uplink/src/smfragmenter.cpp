@@ -0,0 +1,149 @@
+/**
+ * @file smfragmenter.cpp
+ * @brief Implementation of the SmFragmenter class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include <string.h>
+
+#include "smfragmenter.h"
+
+/**
+ * @brief Plans the frames of an uplink, as fragments with header if it needs more than one frame.
+ *
+ * @param recordEnds The end offset of each record, ascending, the last one is the size of the uplink.
+ * @param recordCount The number of records.
+ * @param maxPayloadSize The maximum payload of a frame at the current data rate.
+ * @return true if the frames were planned, false if the payload is too small or the uplink needs too many frames.
+ */
+bool SmFragmenter::plan(uint16_t const* recordEnds, uint8_t const recordCount, size_t const maxPayloadSize)
+{
+    m_fragmented = false;
+
+    if(!m_plan.plan(recordEnds, recordCount, maxPayloadSize))
+    {
+        return false;
+    }
+
+    if(m_plan.getFrameCount() <= 1)
+    {
+        return true;
+    }
+
+    // each fragment carries the header
+    if(maxPayloadSize <= HEADER_SIZE || !m_plan.plan(recordEnds, recordCount, maxPayloadSize - HEADER_SIZE))
+    {
+        return false;
+    }
+
+    m_fragmented = true;
+    m_messageId = (m_messageId + 1) & MESSAGE_ID_MASK;
+
+    return true;
+}
+
+/**
+ * @brief Checks if the uplink is sent as fragments.
+ *
+ * @return true if the frames have a fragment header, false for an uplink of one frame.
+ */
+bool SmFragmenter::isFragmented() const
+{
+    return m_fragmented;
+}
+
+/**
+ * @brief Gets the number of frames.
+ *
+ * @return The number of frames (fragments) of the uplink.
+ */
+uint8_t SmFragmenter::getFrameCount() const
+{
+    return m_plan.getFrameCount();
+}
+
+/**
+ * @brief Gets the message id of the last fragmented uplink.
+ *
+ * @return The message id.
+ */
+uint8_t SmFragmenter::getMessageId() const
+{
+    return m_messageId;
+}
+
+/**
+ * @brief Gets the frames of the uplink.
+ *
+ * @return The plan, the frames without the fragment headers.
+ */
+SmFramePlan const& SmFragmenter::getPlan() const
+{
+    return m_plan;
+}
+
+/**
+ * @brief Writes a frame, a fragment with its header.
+ *
+ * A frame is written again unchanged for its retransmission.
+ *
+ * @param index The index of the frame (index < getFrameCount()).
+ * @param message The uplink.
+ * @param buffer The buffer for the frame.
+ * @param size The size of the buffer.
+ * @return The size of the frame, 0 if it does not fit.
+ */
+size_t SmFragmenter::writeFrame(uint8_t const index, uint8_t const* message, uint8_t* buffer, size_t const size) const
+{
+    size_t const headerSize = m_fragmented ? HEADER_SIZE : 0;
+    size_t const frameSize = m_plan.getFrameSize(index);
+
+    if(headerSize + frameSize > size)
+    {
+        return 0;
+    }
+
+    if(m_fragmented)
+    {
+        writeHeader(buffer, m_messageId, index, m_plan.getFrameCount());
+    }
+
+    memcpy(buffer + headerSize, message + m_plan.getFrameStart(index), frameSize);
+
+    return headerSize + frameSize;
+}
+
+/**
+ * @brief Writes a fragment header.
+ *
+ * @param buffer The buffer, at least HEADER_SIZE bytes.
+ * @param messageId The message id (6 bits).
+ * @param index The index of the fragment (index < count).
+ * @param count The number of fragments, 1 to MAX_FRAGMENTS.
+ */
+void SmFragmenter::writeHeader(uint8_t* buffer, uint8_t const messageId, uint8_t const index, uint8_t const count)
+{
+    uint16_t const header = ((messageId & MESSAGE_ID_MASK) << 10) | ((index & 0x1f) << 5) | ((count - 1) & 0x1f);
+
+    buffer[0] = (header >> 8) & 0xff;
+    buffer[1] = header & 0xff;
+}
+
+/**
+ * @brief Reads a fragment header.
+ *
+ * @param buffer The fragment, at least HEADER_SIZE bytes.
+ * @param messageId The message id.
+ * @param index The index of the fragment.
+ * @param count The number of fragments of the message.
+ */
+void SmFragmenter::readHeader(uint8_t const* buffer, uint8_t& messageId, uint8_t& index, uint8_t& count)
+{
+    uint16_t const header = (buffer[0] << 8) | buffer[1];
+
+    messageId = (header >> 10) & MESSAGE_ID_MASK;
+    index = (header >> 5) & 0x1f;
+    count = (header & 0x1f) + 1;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file smfragmenter.h
+ * @brief This file contains the declaration of the SmFragmenter class.
+ *
+ * Device side of the fragmentation: an uplink which needs more than one frame at the current data rate is sent
+ * as fragments, each with a header of two bytes (big endian):
+ *
+ * Header: message id (6 bits), fragment index (5 bits), fragment count - 1 (5 bits)
+ *
+ * The fragments are planned like the frames of an uplink (see SmFramePlan), less the header, so they still end
+ * at record boundaries. The server reassembles the message by its id (see SmReassembler), fragments may be lost,
+ * reordered or duplicated by several gateways. An uplink which fits into one frame is sent without header.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "smframeplan.h"
+
+class SmFragmenter
+{
+    public:
+        static uint8_t const HEADER_SIZE = 2;                                                       // size of the fragment header
+        static uint8_t const MESSAGE_ID_MASK = 0x3f;                                                // message ids 0 to 63, the id wraps
+        static uint8_t const MAX_FRAGMENTS = 32;                                                    // fragments of one message (5 bits)
+
+        bool plan(uint16_t const* recordEnds, uint8_t const recordCount, size_t const maxPayloadSize);  // plans the frames or fragments, false if the uplink does not fit
+        bool isFragmented() const;                                                                  // checks if the uplink is sent as fragments
+        uint8_t getFrameCount() const;                                                              // number of frames (fragments)
+        uint8_t getMessageId() const;                                                               // message id of the fragments
+        size_t writeFrame(uint8_t const index, uint8_t const* message, uint8_t* buffer, size_t const size) const;   // writes the frame with its header, 0 if it does not fit
+        SmFramePlan const& getPlan() const;                                                         // frames of the uplink (without headers)
+
+        static void writeHeader(uint8_t* buffer, uint8_t const messageId, uint8_t const index, uint8_t const count);   // writes a fragment header
+        static void readHeader(uint8_t const* buffer, uint8_t& messageId, uint8_t& index, uint8_t& count);       // reads a fragment header
+
+    private:
+        SmFramePlan m_plan;                                                                         // frames of the uplink
+        bool m_fragmented = false;                                                                  // flag indicating if the frames have a header
+        uint8_t m_messageId = MESSAGE_ID_MASK;                                                      // message id of the last fragmented uplink
+};
+
+static_assert(SmFramePlan::MAX_FRAMES <= SmFragmenter::MAX_FRAGMENTS, "the fragment index has 5 bits");
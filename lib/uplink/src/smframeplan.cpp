@@ -0,0 +1,133 @@
+/**
+ * @file smframeplan.cpp
+ * @brief Implementation of the SmFramePlan class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include "smframeplan.h"
+
+/**
+ * @brief Plans the frames of an uplink.
+ *
+ * @param recordEnds The end offset of each record, ascending, the last one is the size of the uplink.
+ * @param recordCount The number of records.
+ * @param maxFrameSize The maximum payload of a frame (e.g. of the current data rate).
+ * @return true if the frames were planned, false if the maximum size is 0 or the uplink needs too many frames.
+ */
+bool SmFramePlan::plan(uint16_t const* recordEnds, uint8_t const recordCount, size_t const maxFrameSize)
+{
+    m_frameCount = 0;
+    m_splitRecord = false;
+
+    if(maxFrameSize == 0)
+    {
+        return false;
+    }
+
+    uint16_t frameStart = 0;
+    uint16_t frameEnd = 0;
+
+    for(uint8_t i = 0; i < recordCount; i++)
+    {
+        uint16_t const recordEnd = recordEnds[i];
+
+        if((size_t) (recordEnd - frameStart) <= maxFrameSize)
+        {
+            frameEnd = recordEnd;
+
+            continue;
+        }
+
+        // the record starts the next frame
+        if(frameEnd > frameStart)
+        {
+            if(!addFrame(frameEnd))
+            {
+                return false;
+            }
+
+            frameStart = frameEnd;
+        }
+
+        // a record larger than a frame is split
+        while((size_t) (recordEnd - frameStart) > maxFrameSize)
+        {
+            frameStart += maxFrameSize;
+
+            m_splitRecord = true;
+
+            if(!addFrame(frameStart))
+            {
+                return false;
+            }
+        }
+
+        frameEnd = recordEnd;
+    }
+
+    return frameEnd <= frameStart || addFrame(frameEnd);
+}
+
+/**
+ * @brief Appends a frame.
+ *
+ * @param end The end offset of the frame.
+ * @return true if the frame was appended, false if the plan is full.
+ */
+bool SmFramePlan::addFrame(uint16_t const end)
+{
+    if(m_frameCount >= MAX_FRAMES)
+    {
+        m_frameCount = 0;
+
+        return false;
+    }
+
+    m_frameEnds[m_frameCount++] = end;
+
+    return true;
+}
+
+/**
+ * @brief Gets the number of planned frames.
+ *
+ * @return The number of frames, 0 for an empty uplink.
+ */
+uint8_t SmFramePlan::getFrameCount() const
+{
+    return m_frameCount;
+}
+
+/**
+ * @brief Gets the offset of a frame.
+ *
+ * @param index The index of the frame (index < getFrameCount()).
+ * @return The offset within the uplink.
+ */
+size_t SmFramePlan::getFrameStart(uint8_t const index) const
+{
+    return index == 0 ? 0 : m_frameEnds[index - 1];
+}
+
+/**
+ * @brief Gets the size of a frame.
+ *
+ * @param index The index of the frame (index < getFrameCount()).
+ * @return The size in bytes.
+ */
+size_t SmFramePlan::getFrameSize(uint8_t const index) const
+{
+    return m_frameEnds[index] - getFrameStart(index);
+}
+
+/**
+ * @brief Checks if a record is larger than a frame and was split.
+ *
+ * @return true if the server has to concatenate frames to decode a record.
+ */
+bool SmFramePlan::hasSplitRecord() const
+{
+    return m_splitRecord;
+}
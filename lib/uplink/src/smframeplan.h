@@ -0,0 +1,37 @@
+/**
+ * @file smframeplan.h
+ * @brief This file contains the declaration of the SmFramePlan class.
+ *
+ * Splits an uplink into the fewest LoRaWAN frames which fit into the payload of the current data rate. The
+ * records of the uplink (e.g. the records of SmCayenne) are kept in order and a frame ends at a record boundary,
+ * so each frame can be decoded on its own. Taking as many records as fit into each frame is the fewest frames for
+ * records in order. A record larger than a frame is split into frames of the maximum size, the server
+ * concatenates them.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+class SmFramePlan
+{
+    public:
+        static uint8_t const MAX_FRAMES = 32;                                                       // frames of one uplink (e.g. 250 bytes at 11 bytes per frame)
+
+        bool plan(uint16_t const* recordEnds, uint8_t const recordCount, size_t const maxFrameSize);    // plans the frames, false if the size is 0 or the frames exceed MAX_FRAMES
+        uint8_t getFrameCount() const;                                                              // number of planned frames
+        size_t getFrameStart(uint8_t const index) const;                                            // offset of the frame within the uplink
+        size_t getFrameSize(uint8_t const index) const;                                             // size of the frame
+        bool hasSplitRecord() const;                                                                // checks if a record is split across frames
+
+    private:
+        uint16_t m_frameEnds[MAX_FRAMES];                                                           // end offset of each frame
+        uint8_t m_frameCount = 0;                                                                   // number of planned frames
+        bool m_splitRecord = false;                                                                 // flag indicating if a record is larger than a frame
+
+        bool addFrame(uint16_t const end);                                                          // appends a frame, false if the plan is full
+};
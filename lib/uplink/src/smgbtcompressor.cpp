@@ -0,0 +1,254 @@
+/**
+ * @file smgbtcompressor.cpp
+ * @brief Implementation of the SmGbtCompressor class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include "smgbtcompressor.h"
+
+/**
+ * @brief Selects the dictionary of the profile.
+ *
+ * @param profileId The identifier of the profile (see SmProfiles).
+ * @return true if the profile has a dictionary, false otherwise (the push is not compressed).
+ */
+bool SmGbtCompressor::select(uint8_t const profileId)
+{
+    m_dictionary = SmGbtDictionaries::find(profileId);
+
+    return m_dictionary != nullptr;
+}
+
+/**
+ * @brief Gets the selected dictionary.
+ *
+ * @return The dictionary, nullptr if the profile has none.
+ */
+SmGbtDictionary const* SmGbtCompressor::getDictionary() const
+{
+    return m_dictionary;
+}
+
+/**
+ * @brief Compresses a push against the dictionary.
+ *
+ * The dictionary is hashed first, so the push refers to it like to its own earlier bytes.
+ *
+ * @param data The joined GBT push.
+ * @param size The size of the push.
+ * @return The size of the compressed push (see getOutput), 0 if no dictionary is selected or the push is too large.
+ */
+size_t SmGbtCompressor::compress(uint8_t const* data, size_t const size)
+{
+    m_outputSize = 0;
+
+    if(m_dictionary == nullptr || size > MAX_INPUT_SIZE)
+    {
+        return 0;
+    }
+
+    m_data = data;
+
+    for(uint16_t i = 0; i < HASH_SIZE; i++)
+    {
+        m_head[i] = NO_POSITION;
+    }
+
+    size_t const start = m_dictionary->size;
+    size_t const end = start + size;
+
+    for(size_t position = 0; position < start; position++)
+    {
+        insert(position, end);
+    }
+
+    m_output[m_outputSize++] = m_dictionary->profileId;
+
+    size_t position = start;
+    size_t literalStart = start;
+
+    while(position < end)
+    {
+        size_t distance = 0;
+        size_t length = findMatch(position, end, distance);
+
+        if(length < SmGbtDictionary::MIN_MATCH)
+        {
+            insert(position++, end);
+
+            continue;
+        }
+
+        addLiterals(literalStart, position);
+        addMatch(length, distance);
+
+        for(size_t i = 0; i < length; i++)
+        {
+            insert(position++, end);
+        }
+
+        literalStart = position;
+    }
+
+    addLiterals(literalStart, end);
+
+    m_data = nullptr;
+
+    return m_outputSize;
+}
+
+/**
+ * @brief Gets the compressed push.
+ *
+ * @return The output of the last compress, the profile id followed by the tokens.
+ */
+uint8_t const* SmGbtCompressor::getOutput() const
+{
+    return m_output;
+}
+
+/**
+ * @brief Gets a byte of the dictionary followed by the push.
+ *
+ * @param position The position, below the dictionary size for the dictionary.
+ * @return The byte.
+ */
+uint8_t SmGbtCompressor::getByte(size_t const position) const
+{
+    return position < m_dictionary->size ? m_dictionary->data[position] : m_data[position - m_dictionary->size];
+}
+
+/**
+ * @brief Hashes the MIN_MATCH bytes at a position.
+ *
+ * @param position The position, at least MIN_MATCH bytes before the end.
+ * @return The hash, below HASH_SIZE.
+ */
+uint16_t SmGbtCompressor::getHash(size_t const position) const
+{
+    uint32_t const bytes = (getByte(position) << 16) | (getByte(position + 1) << 8) | getByte(position + 2);
+
+    return static_cast<uint16_t>((bytes * 2654435761UL) >> (32 - HASH_BITS)) & (HASH_SIZE - 1);
+}
+
+/**
+ * @brief Adds a position to the head of its hash chain.
+ *
+ * @param position The position.
+ * @param end The end of the push, the last MIN_MATCH - 1 positions have no hash.
+ */
+void SmGbtCompressor::insert(size_t const position, size_t const end)
+{
+    if(position + SmGbtDictionary::MIN_MATCH > end)
+    {
+        return;
+    }
+
+    uint16_t const hash = getHash(position);
+
+    m_previous[position] = m_head[hash];
+    m_head[hash] = static_cast<uint16_t>(position);
+}
+
+/**
+ * @brief Finds the longest match at a position among the candidates of its hash chain.
+ *
+ * @param position The position in the push, not yet added to the hash chains.
+ * @param end The end of the push.
+ * @param distance The distance of the longest match.
+ * @return The length of the longest match, 0 if there is none of at least MIN_MATCH bytes.
+ */
+size_t SmGbtCompressor::findMatch(size_t const position, size_t const end, size_t& distance) const
+{
+    if(position + SmGbtDictionary::MIN_MATCH > end)
+    {
+        return 0;
+    }
+
+    size_t bestLength = 0;
+    uint16_t candidate = m_head[getHash(position)];
+
+    for(uint8_t chain = 0; candidate != NO_POSITION && chain < MAX_CHAIN; chain++)
+    {
+        if(position - candidate > SmGbtDictionary::MAX_DISTANCE)
+        {
+            break;
+        }
+
+        size_t length = 0;
+
+        while(position + length < end && getByte(candidate + length) == getByte(position + length))
+        {
+            length++;
+        }
+
+        if(length > bestLength)
+        {
+            bestLength = length;
+            distance = position - candidate;
+        }
+
+        candidate = m_previous[candidate];
+    }
+
+    return bestLength >= SmGbtDictionary::MIN_MATCH ? bestLength : 0;
+}
+
+/**
+ * @brief Writes the bytes of the push between two positions as literal tokens.
+ *
+ * @param start The first position.
+ * @param end The position after the last literal.
+ */
+void SmGbtCompressor::addLiterals(size_t const start, size_t const end)
+{
+    size_t position = start;
+
+    while(position < end)
+    {
+        size_t count = end - position < SmGbtDictionary::MAX_LITERALS ? end - position : SmGbtDictionary::MAX_LITERALS;
+
+        m_output[m_outputSize++] = static_cast<uint8_t>(count - 1);
+
+        for(size_t i = 0; i < count; i++)
+        {
+            m_output[m_outputSize++] = getByte(position++);
+        }
+    }
+}
+
+/**
+ * @brief Writes a back-reference token.
+ *
+ * A match takes at least MIN_MATCH bytes of the push and at most 3 bytes of output plus one extension byte for
+ * each further 255 bytes, the output stays within the size of the push as literals.
+ *
+ * @param length The length of the match, at least MIN_MATCH.
+ * @param distance The distance back, 1 to MAX_DISTANCE.
+ */
+void SmGbtCompressor::addMatch(size_t const length, size_t const distance)
+{
+    size_t code = length - SmGbtDictionary::MIN_MATCH;
+    uint8_t const lengthCode = code < SmGbtDictionary::LENGTH_EXTENDED ? code : SmGbtDictionary::LENGTH_EXTENDED;
+
+    m_output[m_outputSize++] = SmGbtDictionary::MATCH_FLAG | (lengthCode << 3) | (((distance - 1) >> 8) & 0x07);
+    m_output[m_outputSize++] = (distance - 1) & 0xff;
+
+    if(lengthCode < SmGbtDictionary::LENGTH_EXTENDED)
+    {
+        return;
+    }
+
+    code -= SmGbtDictionary::LENGTH_EXTENDED;
+
+    while(code >= 255)
+    {
+        m_output[m_outputSize++] = 255;
+
+        code -= 255;
+    }
+
+    m_output[m_outputSize++] = static_cast<uint8_t>(code);
+}
@@ -0,0 +1,54 @@
+/**
+ * @file smgbtcompressor.h
+ * @brief This file contains the declaration of the SmGbtCompressor class.
+ *
+ * Compresses the raw GBT push of a meter against the pre-shared dictionary of its profile (see SmGbtDictionary).
+ * The back-references are found with hash chains over the dictionary and the push, the longest match of a
+ * bounded number of candidates is taken. The output is never larger than the literals of the whole push, the
+ * buffer is sized for it.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "smgbtdictionary.h"
+
+class SmGbtCompressor
+{
+    public:
+        static size_t const MAX_INPUT_SIZE = 1024;                                                  // size of a push (SmMeterSlot::MAX_FRAMESIZE)
+        static size_t const MAX_OUTPUT_SIZE = 1 + MAX_INPUT_SIZE + (MAX_INPUT_SIZE + SmGbtDictionary::MAX_LITERALS - 1) / SmGbtDictionary::MAX_LITERALS;    // profile id and the push as literals
+
+        bool select(uint8_t const profileId);                                                       // selects the dictionary of the profile, false if it has none
+        SmGbtDictionary const* getDictionary() const;                                               // selected dictionary, nullptr if none
+        size_t compress(uint8_t const* data, size_t const size);                                    // compresses a push, 0 if no dictionary is selected or the push is too large
+        uint8_t const* getOutput() const;                                                           // compressed push
+
+    private:
+        static uint8_t const HASH_BITS = 9;                                                         // bits of the hash of MIN_MATCH bytes
+        static uint16_t const HASH_SIZE = 1 << HASH_BITS;                                           // heads of the hash chains
+        static uint8_t const MAX_CHAIN = 32;                                                        // candidates compared for each position
+        static uint16_t const NO_POSITION = 0xffff;                                                 // end of a hash chain
+        static size_t const MAX_WINDOW = SmGbtDictionary::MAX_SIZE + MAX_INPUT_SIZE;                // positions of the dictionary followed by the push
+
+        SmGbtDictionary const* m_dictionary = nullptr;                                              // dictionary of the profile
+        uint8_t const* m_data = nullptr;                                                            // push in process
+        uint16_t m_head[HASH_SIZE];                                                                 // last position of each hash
+        uint16_t m_previous[MAX_WINDOW];                                                            // previous position with the same hash
+        uint8_t m_output[MAX_OUTPUT_SIZE];                                                          // compressed push
+        size_t m_outputSize = 0;                                                                    // size of the compressed push
+
+        uint8_t getByte(size_t const position) const;                                               // byte of the dictionary followed by the push
+        uint16_t getHash(size_t const position) const;                                              // hash of the MIN_MATCH bytes at the position
+        void insert(size_t const position, size_t const end);                                       // adds a position to its hash chain
+        size_t findMatch(size_t const position, size_t const end, size_t& distance) const;          // longest match at the position, 0 if none
+        void addLiterals(size_t const start, size_t const end);                                     // writes literal tokens
+        void addMatch(size_t const length, size_t const distance);                                  // writes a back-reference token
+};
+
+static_assert(SmGbtCompressor::MAX_INPUT_SIZE + SmGbtDictionary::MAX_SIZE <= 0xffff, "the positions of the hash chains have 16 bits");
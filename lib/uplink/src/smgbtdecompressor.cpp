@@ -0,0 +1,100 @@
+/**
+ * @file smgbtdecompressor.cpp
+ * @brief Implementation of the SmGbtDecompressor class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include <string.h>
+
+#include "smgbtdecompressor.h"
+
+/**
+ * @brief Restores a compressed push.
+ *
+ * @param data The compressed push, the profile id followed by the tokens.
+ * @param size The size of the compressed push.
+ * @param buffer The buffer for the push.
+ * @param bufferSize The size of the buffer.
+ * @return The size of the push, 0 if the profile has no dictionary, a token is truncated, a back-reference
+ * reaches before the dictionary or the push does not fit into the buffer.
+ */
+size_t SmGbtDecompressor::decompress(uint8_t const* data, size_t const size, uint8_t* buffer, size_t const bufferSize)
+{
+    if(size < 1)
+    {
+        return 0;
+    }
+
+    SmGbtDictionary const* dictionary = SmGbtDictionaries::find(data[0]);
+
+    if(dictionary == nullptr)
+    {
+        return 0;
+    }
+
+    size_t index = 1;
+    size_t decoded = 0;
+
+    while(index < size)
+    {
+        uint8_t const token = data[index++];
+
+        if((token & SmGbtDictionary::MATCH_FLAG) == 0)
+        {
+            size_t const count = token + 1;
+
+            if(index + count > size || decoded + count > bufferSize)
+            {
+                return 0;
+            }
+
+            memcpy(buffer + decoded, data + index, count);
+
+            index += count;
+            decoded += count;
+
+            continue;
+        }
+
+        if(index >= size)
+        {
+            return 0;
+        }
+
+        size_t const distance = (((token & 0x07) << 8) | data[index++]) + 1;
+        size_t length = ((token >> 3) & 0x0f) + SmGbtDictionary::MIN_MATCH;
+
+        if(((token >> 3) & 0x0f) == SmGbtDictionary::LENGTH_EXTENDED)
+        {
+            uint8_t extension = 255;
+
+            while(extension == 255)
+            {
+                if(index >= size)
+                {
+                    return 0;
+                }
+
+                extension = data[index++];
+                length += extension;
+            }
+        }
+
+        if(distance > dictionary->size + decoded || decoded + length > bufferSize)
+        {
+            return 0;
+        }
+
+        // the position in the dictionary followed by the push, the copy may overlap the bytes it produces
+        size_t position = dictionary->size + decoded - distance;
+
+        for(size_t i = 0; i < length; i++, position++)
+        {
+            buffer[decoded++] = position < dictionary->size ? dictionary->data[position] : buffer[position - dictionary->size];
+        }
+    }
+
+    return decoded;
+}
@@ -0,0 +1,23 @@
+/**
+ * @file smgbtdecompressor.h
+ * @brief This file contains the declaration of the SmGbtDecompressor class.
+ *
+ * Server side counterpart of the SmGbtCompressor, used by the host tests. The push is restored byte for byte
+ * with the dictionary of the profile sent in the first byte (see SmGbtDictionary).
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "smgbtdictionary.h"
+
+class SmGbtDecompressor
+{
+    public:
+        static size_t decompress(uint8_t const* data, size_t const size, uint8_t* buffer, size_t const bufferSize);   // restores the push, 0 if the profile is unknown or the data is invalid
+};
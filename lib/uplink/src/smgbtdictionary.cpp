@@ -0,0 +1,89 @@
+/**
+ * @file smgbtdictionary.cpp
+ * @brief Implementation of the pre-shared dictionaries of the raw GBT uplink.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include "smgbtdictionary.h"
+#include "smprofile.h"
+
+/**
+ * @brief Static bytes of the Landis+Gyr E450 push: the push structure, the 15 capture objects (class, OBIS code,
+ * attribute and data index) in the order of the push and the headers of the values.
+ */
+static uint8_t const SM_GBT_DICTIONARY_LG_E450[] = {
+    // date time octet string, year 2xxx
+    0x0c, 0x07,
+    // deviation not specified, clock status
+    0xff, 0x80, 0x00, 0x00,
+    // push structure, capture object list of 15 entries
+    0x02, 0x0f, 0x01, 0x0f,
+    // push setup 0-8:25.9.0.255, push object list
+    0x02, 0x04, 0x12, 0x00, 0x28, 0x09, 0x06, 0x00, 0x08, 0x19, 0x09, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00,
+    // push setup 0-8:25.9.0.255, logical name
+    0x02, 0x04, 0x12, 0x00, 0x28, 0x09, 0x06, 0x00, 0x08, 0x19, 0x09, 0x00, 0xff, 0x0f, 0x01, 0x12, 0x00, 0x00,
+    // data 0-0:96.1.0.255, device name
+    0x02, 0x04, 0x12, 0x00, 0x01, 0x09, 0x06, 0x00, 0x00, 0x60, 0x01, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00,
+    // register 1-0:1.7.0.255, active power +P
+    0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x00, 0x01, 0x07, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00,
+    // register 1-0:2.7.0.255, active power -P
+    0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x00, 0x02, 0x07, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00,
+    // register 1-1:1.8.0.255, active energy +A
+    0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x01, 0x01, 0x08, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00,
+    // register 1-1:2.8.0.255, active energy -A
+    0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x01, 0x02, 0x08, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00,
+    // register 1-1:5.8.0.255, reactive energy QI
+    0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x01, 0x05, 0x08, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00,
+    // register 1-1:6.8.0.255, reactive energy QII
+    0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x01, 0x06, 0x08, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00,
+    // register 1-1:7.8.0.255, reactive energy QIII
+    0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x01, 0x07, 0x08, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00,
+    // register 1-1:8.8.0.255, reactive energy QIV
+    0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x01, 0x08, 0x08, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00,
+    // register 1-0:130.7.0.255, manufacturer specific
+    0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x00, 0x82, 0x07, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00,
+    // register 1-0:31.7.0.255, current L1
+    0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x00, 0x1f, 0x07, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00,
+    // register 1-0:51.7.0.255, current L2
+    0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x00, 0x33, 0x07, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00,
+    // register 1-0:71.7.0.255, current L3
+    0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x00, 0x47, 0x07, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00,
+    // value of the push setup (its logical name)
+    0x09, 0x06, 0x00, 0x08, 0x19, 0x09, 0x00, 0xff,
+    // device name, octet string of 8 characters
+    0x09, 0x08,
+    // uint32 value
+    0x06, 0x00, 0x00, 0x00, 0x00,
+    // uint16 value
+    0x12, 0x00, 0x00
+};
+
+/**
+ * @brief The dictionaries, one for each profile with a raw GBT push.
+ */
+static SmGbtDictionary const SM_GBT_DICTIONARIES[] = {
+    { SmProfiles::SMPROFILE_LG_E450, SM_GBT_DICTIONARY_LG_E450, sizeof(SM_GBT_DICTIONARY_LG_E450) }
+};
+
+static_assert(sizeof(SM_GBT_DICTIONARY_LG_E450) <= SmGbtDictionary::MAX_SIZE, "E450 dictionary exceeds its size");
+
+/**
+ * @brief Looks up the dictionary of a profile.
+ *
+ * @param profileId The identifier of the profile (see SmProfiles).
+ * @return The dictionary, nullptr if the profile has none.
+ */
+SmGbtDictionary const* SmGbtDictionaries::find(uint8_t const profileId)
+{
+    for(size_t i = 0; i < sizeof(SM_GBT_DICTIONARIES) / sizeof(SmGbtDictionary); i++)
+    {
+        if(SM_GBT_DICTIONARIES[i].profileId == profileId)
+        {
+            return &SM_GBT_DICTIONARIES[i];
+        }
+    }
+
+    return nullptr;
+}
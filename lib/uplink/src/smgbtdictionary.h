@@ -0,0 +1,48 @@
+/**
+ * @file smgbtdictionary.h
+ * @brief This file contains the pre-shared dictionaries (SmGbtDictionary) of the raw GBT uplink and their lookup.
+ *
+ * Most of a raw GBT push is static: the structure of the push and the capture object list with the class,
+ * OBIS code and attribute of each value. The dictionary of a profile holds these bytes in flash on the device and
+ * on the server. The compressed push refers to them with LZ back-references, only the values are sent as literals:
+ *
+ * Compressed: profile id (1 byte), tokens
+ * Literals:   0LLLLLLL, L + 1 bytes follow (1 to 128)
+ * Match:      1LLLLDDD DDDDDDDD [extension], copy L + MIN_MATCH bytes from D + 1 bytes back (1 to MAX_DISTANCE)
+ *
+ * A match of length code 15 is followed by extension bytes which are added to the length, a byte of 255 is
+ * followed by a further one. The distance counts back into the dictionary followed by the push decoded so far,
+ * a match may overlap the bytes it produces. The device compressor (SmGbtCompressor) and the server
+ * decompressor (SmGbtDecompressor) use the same table, they cannot drift apart.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Pre-shared dictionary of one meter profile.
+ */
+struct SmGbtDictionary
+{
+    static size_t const MAX_SIZE = 512;                                                             // size of a dictionary
+    static uint8_t const MIN_MATCH = 3;                                                             // shortest back-reference
+    static size_t const MAX_DISTANCE = 2048;                                                        // farthest back-reference (11 bits)
+    static uint8_t const MAX_LITERALS = 128;                                                        // literals of one token
+    static uint8_t const MATCH_FLAG = 0x80;                                                         // token flag of a back-reference
+    static uint8_t const LENGTH_EXTENDED = 15;                                                      // length code followed by extension bytes
+
+    uint8_t profileId;                                                                              // profile of the push, sent as first byte
+    uint8_t const* data;                                                                            // static bytes of the push, in flash
+    uint16_t size;                                                                                  // size of the dictionary
+};
+
+class SmGbtDictionaries
+{
+    public:
+        static SmGbtDictionary const* find(uint8_t const profileId);                                // returns the dictionary of the profile, nullptr if the profile has none
+};
@@ -0,0 +1,235 @@
+/**
+ * @file smreassembler.cpp
+ * @brief Implementation of the SmReassembler class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include <string.h>
+
+#include "smreassembler.h"
+
+/**
+ * @brief Drops the collected messages.
+ */
+void SmReassembler::reset()
+{
+    for(uint8_t i = 0; i < MAX_MESSAGES; i++)
+    {
+        m_slots[i].used = false;
+    }
+
+    m_messageSize = 0;
+}
+
+/**
+ * @brief Adds a received fragment.
+ *
+ * @param data The fragment with its header.
+ * @param size The size of the fragment.
+ * @return The result, SMFRAGMENT_COMPLETE if the fragment completed its message (see getMessage).
+ */
+SmReassembler::SmFragmentResult SmReassembler::addFragment(uint8_t const* data, size_t const size)
+{
+    if(size <= SmFragmenter::HEADER_SIZE)
+    {
+        return SmFragmentResult::SMFRAGMENT_INVALID;
+    }
+
+    uint8_t messageId;
+    uint8_t index;
+    uint8_t count;
+
+    SmFragmenter::readHeader(data, messageId, index, count);
+
+    if(index >= count)
+    {
+        return SmFragmentResult::SMFRAGMENT_INVALID;
+    }
+
+    uint8_t const* fragment = data + SmFragmenter::HEADER_SIZE;
+    size_t const fragmentSize = size - SmFragmenter::HEADER_SIZE;
+
+    SmMessageSlot* slot = find(messageId);
+
+    if(slot != nullptr && slot->count == count && (slot->received & (1UL << index)) != 0)
+    {
+        // the same fragment again (e.g. from a second gateway), or the first fragment of a new message with the id
+        if(slot->sizes[index] == fragmentSize && memcmp(slot->buffer + slot->offsets[index], fragment, fragmentSize) == 0)
+        {
+            return SmFragmentResult::SMFRAGMENT_DUPLICATE;
+        }
+
+        slot = nullptr;
+    }
+
+    if(slot == nullptr || slot->count != count)
+    {
+        slot = &allocate(messageId, count);
+    }
+
+    if(slot->usedSize + fragmentSize > MAX_MESSAGE_SIZE)
+    {
+        return SmFragmentResult::SMFRAGMENT_INVALID;
+    }
+
+    memcpy(slot->buffer + slot->usedSize, fragment, fragmentSize);
+
+    slot->offsets[index] = slot->usedSize;
+    slot->sizes[index] = static_cast<uint16_t>(fragmentSize);
+    slot->usedSize += static_cast<uint16_t>(fragmentSize);
+    slot->received |= 1UL << index;
+    slot->sequence = ++m_sequence;
+
+    if(slot->received != getAllMask(slot->count))
+    {
+        return SmFragmentResult::SMFRAGMENT_INCOMPLETE;
+    }
+
+    // the slot is kept to detect duplicates of the completed message
+    assemble(*slot);
+
+    return SmFragmentResult::SMFRAGMENT_COMPLETE;
+}
+
+/**
+ * @brief Gets the last completed message.
+ *
+ * @return The message, the fragments concatenated in the order of their index.
+ */
+uint8_t const* SmReassembler::getMessage() const
+{
+    return m_message;
+}
+
+/**
+ * @brief Gets the size of the last completed message.
+ *
+ * @return The size of the message, 0 if no message was completed.
+ */
+size_t SmReassembler::getMessageSize() const
+{
+    return m_messageSize;
+}
+
+/**
+ * @brief Gets the id of the last completed message.
+ *
+ * @return The message id.
+ */
+uint8_t SmReassembler::getMessageId() const
+{
+    return m_messageId;
+}
+
+/**
+ * @brief Gets the missing fragments of a message.
+ *
+ * @param messageId The message id.
+ * @return The bitmap of the missing fragments (bit i for index i), 0 if the message is unknown or complete.
+ */
+uint32_t SmReassembler::getMissing(uint8_t const messageId) const
+{
+    for(uint8_t i = 0; i < MAX_MESSAGES; i++)
+    {
+        if(m_slots[i].used && m_slots[i].messageId == messageId)
+        {
+            return getAllMask(m_slots[i].count) & ~m_slots[i].received;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Finds the slot of a message.
+ *
+ * @param messageId The message id.
+ * @return The slot, nullptr if no fragment of the message was received.
+ */
+SmReassembler::SmMessageSlot* SmReassembler::find(uint8_t const messageId)
+{
+    for(uint8_t i = 0; i < MAX_MESSAGES; i++)
+    {
+        if(m_slots[i].used && m_slots[i].messageId == messageId)
+        {
+            return &m_slots[i];
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Allocates the slot for a new message.
+ *
+ * An old message with the same id is replaced, otherwise a free slot or the slot with the oldest fragment.
+ *
+ * @param messageId The message id.
+ * @param count The number of fragments.
+ * @return The empty slot.
+ */
+SmReassembler::SmMessageSlot& SmReassembler::allocate(uint8_t const messageId, uint8_t const count)
+{
+    SmMessageSlot* slot = find(messageId);
+
+    for(uint8_t i = 0; slot == nullptr && i < MAX_MESSAGES; i++)
+    {
+        if(!m_slots[i].used)
+        {
+            slot = &m_slots[i];
+        }
+    }
+
+    if(slot == nullptr)
+    {
+        slot = &m_slots[0];
+
+        for(uint8_t i = 1; i < MAX_MESSAGES; i++)
+        {
+            if(m_slots[i].sequence < slot->sequence)
+            {
+                slot = &m_slots[i];
+            }
+        }
+    }
+
+    slot->used = true;
+    slot->messageId = messageId;
+    slot->count = count;
+    slot->received = 0;
+    slot->usedSize = 0;
+
+    return *slot;
+}
+
+/**
+ * @brief Copies the fragments of a complete message in the order of their index into the message.
+ *
+ * @param slot The slot of the complete message.
+ */
+void SmReassembler::assemble(SmMessageSlot const& slot)
+{
+    m_messageSize = 0;
+
+    for(uint8_t i = 0; i < slot.count; i++)
+    {
+        memcpy(m_message + m_messageSize, slot.buffer + slot.offsets[i], slot.sizes[i]);
+
+        m_messageSize += slot.sizes[i];
+    }
+
+    m_messageId = slot.messageId;
+}
+
+/**
+ * @brief Gets the bitmap of all fragments of a message.
+ *
+ * @param count The number of fragments, 1 to MAX_FRAGMENTS.
+ * @return The bitmap with the bits 0 to count - 1 set.
+ */
+uint32_t SmReassembler::getAllMask(uint8_t const count)
+{
+    return count >= 32 ? 0xffffffffUL : (1UL << count) - 1;
+}
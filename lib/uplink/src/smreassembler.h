@@ -0,0 +1,70 @@
+/**
+ * @file smreassembler.h
+ * @brief This file contains the declaration of the SmReassembler class.
+ *
+ * Server side counterpart of the SmFragmenter, used by the host tests. The fragments of a device are collected
+ * by their message id until all fragments of the message arrived, in any order. A fragment received again (e.g.
+ * by a second gateway or retransmitted) is reported as duplicate, a fragment which differs from the one already
+ * received with the same id and index belongs to a new message (the id wrapped) and replaces the old one.
+ * The missing fragments of a message are reported as bitmap, so only these are requested again.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "smfragmenter.h"
+
+class SmReassembler
+{
+    public:
+        static uint8_t const MAX_MESSAGES = 4;                                                      // messages collected at the same time
+        static size_t const MAX_MESSAGE_SIZE = 2048;                                                // size of a message
+
+        enum class SmFragmentResult
+        {
+            SMFRAGMENT_INCOMPLETE,                                                                  // fragment added, fragments missing
+            SMFRAGMENT_COMPLETE,                                                                    // fragment added, the message is complete
+            SMFRAGMENT_DUPLICATE,                                                                   // fragment already received
+            SMFRAGMENT_INVALID                                                                      // no valid fragment or the message is too large
+        };
+
+        void reset();                                                                               // drops the collected messages
+        SmFragmentResult addFragment(uint8_t const* data, size_t const size);                       // adds a received fragment (with header)
+        uint8_t const* getMessage() const;                                                          // last completed message
+        size_t getMessageSize() const;                                                              // size of the last completed message
+        uint8_t getMessageId() const;                                                               // id of the last completed message
+        uint32_t getMissing(uint8_t const messageId) const;                                         // missing fragments of a message as bitmap, 0 if unknown or complete
+
+    private:
+        /**
+         * @brief Fragments of one message, stored in the order of their arrival.
+         */
+        struct SmMessageSlot
+        {
+            bool used;                                                                              // flag indicating if the slot holds a message
+            uint8_t messageId;                                                                      // message id
+            uint8_t count;                                                                          // number of fragments
+            uint32_t received;                                                                      // bitmap of the received fragments
+            uint32_t sequence;                                                                      // sequence of the last fragment, the oldest slot is replaced
+            uint16_t offsets[SmFragmenter::MAX_FRAGMENTS];                                          // offset of each fragment in the buffer
+            uint16_t sizes[SmFragmenter::MAX_FRAGMENTS];                                            // size of each fragment
+            uint16_t usedSize;                                                                      // bytes used in the buffer
+            uint8_t buffer[MAX_MESSAGE_SIZE];                                                       // fragments without their headers
+        };
+
+        SmMessageSlot m_slots[MAX_MESSAGES] = {};                                                   // messages being collected
+        uint32_t m_sequence = 0;                                                                    // sequence of the received fragments
+        uint8_t m_message[MAX_MESSAGE_SIZE];                                                        // last completed message
+        size_t m_messageSize = 0;                                                                   // size of the last completed message
+        uint8_t m_messageId = 0;                                                                    // id of the last completed message
+
+        SmMessageSlot* find(uint8_t const messageId);                                               // slot of the message, nullptr if unknown
+        SmMessageSlot& allocate(uint8_t const messageId, uint8_t const count);                      // free or oldest slot for a new message
+        void assemble(SmMessageSlot const& slot);                                                   // copies the fragments in order into the message
+        static uint32_t getAllMask(uint8_t const count);                                            // bitmap of all fragments
+};
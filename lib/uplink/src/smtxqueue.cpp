@@ -0,0 +1,671 @@
+/**
+ * @file smtxqueue.cpp
+ * @brief Implementation of the SmTxQueue class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include <string.h>
+
+#include "mylog.h"
+#include "smtxqueue.h"
+
+/**
+ * @brief Constructor.
+ *
+ * @param radio The radio the packets are handed to.
+ */
+SmTxQueue::SmTxQueue(SmTxRadio& radio) :
+    m_radio(radio)
+{
+}
+
+/**
+ * @brief Starts the next message of a stream, the packets committed after it belong to the message.
+ *
+ * The message supersedes the older ones of the stream: their waiting packets are dropped (stale data), the packet
+ * on air is kept. An uplink planned again (e.g. for a lower data rate) opens a new message as well.
+ *
+ * @param stream The stream (e.g. the index of the meter), less than MAX_STREAMS.
+ * @return The message, NO_MESSAGE if the stream is invalid (the packets are committed without message).
+ */
+uint32_t SmTxQueue::openMessage(uint8_t const stream)
+{
+    if(stream >= MAX_STREAMS)
+    {
+        m_openStream = NO_STREAM;
+        m_openMessage = NO_MESSAGE;
+
+        return NO_MESSAGE;
+    }
+
+    dropStale(stream);
+
+    if(++m_lastMessage == NO_MESSAGE)
+    {
+        m_lastMessage++;
+    }
+
+    m_streams[stream].latest = m_lastMessage;
+
+    m_openStream = stream;
+    m_openMessage = m_lastMessage;
+
+    return m_openMessage;
+}
+
+/**
+ * @brief Gets the buffer for the next packet at the end of the queue.
+ *
+ * The buffer is valid till the next call of the queue, the packet is queued with commit.
+ *
+ * @return The buffer of MAX_PACKET_SIZE bytes, nullptr if the queue is full.
+ */
+uint8_t* SmTxQueue::reserve()
+{
+    if(m_count >= MAX_PACKETS || m_poolUsed + MAX_PACKET_SIZE > POOL_SIZE)
+    {
+        return nullptr;
+    }
+
+    return m_pool + m_poolUsed;
+}
+
+/**
+ * @brief Queues the packet written into the reserved buffer, it is sent at once if the queue is idle.
+ *
+ * The packet belongs to the message opened last (see openMessage).
+ *
+ * @param size The size of the packet.
+ * @param fport The LoRaWAN port of the packet.
+ * @param now The current time in ms.
+ * @return true if the packet was queued, false if the queue is full or the size is invalid.
+ */
+bool SmTxQueue::commit(size_t const size, uint8_t const fport, uint32_t const now)
+{
+    if(size == 0 || size > MAX_PACKET_SIZE || reserve() == nullptr)
+    {
+        return false;
+    }
+
+    SmTxPacket& packet = m_packets[m_count++];
+
+    packet.offset = m_poolUsed;
+    packet.size = size;
+    packet.fport = fport;
+    packet.attempts = 0;
+    packet.stream = m_openStream;
+    packet.message = m_openMessage;
+
+    m_poolUsed += size;
+
+    if(m_state == SmTxState::SMTXSTATE_IDLE)
+    {
+        sendHead(now);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Drops the waiting packets of the open message, e.g. the queue was full before its last packet.
+ *
+ * The fragments of a message cannot be reassembled without the missing ones, they are not sent. The packet on
+ * air is kept, its end of the TX cycle is still handled. The packets committed after the call have no message.
+ */
+void SmTxQueue::abortMessage()
+{
+    if(m_openMessage != NO_MESSAGE)
+    {
+        uint8_t i = m_state == SmTxState::SMTXSTATE_SENDING ? 1 : 0;
+        uint8_t aborted = 0;
+
+        while(i < m_count)
+        {
+            if(m_packets[i].message == m_openMessage)
+            {
+                removePacket(i);
+
+                aborted++;
+            }
+            else
+            {
+                i++;
+            }
+        }
+
+        if(aborted > 0)
+        {
+            MyLog::log("SMTXQUEUE", "%d packets of the incomplete message dropped", aborted);
+
+            m_droppedCount += aborted;
+        }
+
+        if(m_count == 0)
+        {
+            m_state = SmTxState::SMTXSTATE_IDLE;
+        }
+    }
+
+    m_openStream = NO_STREAM;
+    m_openMessage = NO_MESSAGE;
+}
+
+/**
+ * @brief Handles the end of the TX cycle of the sent packet.
+ *
+ * An acknowledged packet is removed and the next one is sent, a packet which was not acknowledged is sent again
+ * after the backoff. The end of a TX cycle while a packet waits for the timer means the transceiver is free: if it
+ * is the late end of the head (after TXFIN_TIMEOUT) an acknowledged head is removed and the next packet is sent, in
+ * all other cases the head is sent without waiting for the timer.
+ *
+ * @param acknowledged true if the uplink was acknowledged (or unconfirmed), false otherwise.
+ * @param now The current time in ms.
+ */
+void SmTxQueue::txFinished(bool const acknowledged, uint32_t const now)
+{
+    switch(m_state)
+    {
+        case SmTxState::SMTXSTATE_SENDING:
+            m_headOnAir = false;
+
+            if(acknowledged)
+            {
+                acknowledgeHead();
+                sendHead(now);
+            }
+            else
+            {
+                retryHead(now);
+            }
+            break;
+
+        case SmTxState::SMTXSTATE_WAITING:
+            // the head was delivered after all, it is not sent twice
+            if(m_headOnAir && acknowledged)
+            {
+                MyLog::log("SMTXQUEUE", "Late acknowledgement of the packet on air");
+
+                acknowledgeHead();
+            }
+
+            m_headOnAir = false;
+
+            sendHead(now);
+            break;
+
+        case SmTxState::SMTXSTATE_IDLE:
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Handles the expired timer.
+ *
+ * A waiting packet is sent again, a sent packet without end of its TX cycle is handled as not acknowledged.
+ * The timer may expire before the time of the queue (e.g. it was armed for an earlier event), then it is ignored.
+ *
+ * @param now The current time in ms.
+ */
+void SmTxQueue::timerExpired(uint32_t const now)
+{
+    if(m_state == SmTxState::SMTXSTATE_IDLE || (int32_t) (m_deadline - now) > 0)
+    {
+        return;
+    }
+
+    if(m_state == SmTxState::SMTXSTATE_SENDING)
+    {
+        MyLog::log("SMTXQUEUE", "No end of the TX cycle within %lu ms", (unsigned long) TXFIN_TIMEOUT);
+
+        retryHead(now);
+
+        return;
+    }
+
+    sendHead(now);
+}
+
+/**
+ * @brief Gets the time till timerExpired is due, the caller arms its timer with it after each event.
+ *
+ * @param now The current time in ms.
+ * @return The time in ms (at least 1), NO_TIMER if the queue is idle.
+ */
+uint32_t SmTxQueue::getTimerDelay(uint32_t const now) const
+{
+    if(m_state == SmTxState::SMTXSTATE_IDLE)
+    {
+        return NO_TIMER;
+    }
+
+    int32_t remaining = (int32_t) (m_deadline - now);
+
+    return remaining > 0 ? (uint32_t) remaining : 1;
+}
+
+/**
+ * @brief Gets the state of the packet at the head of the queue.
+ *
+ * @return The state, SMTXSTATE_IDLE if no packet is waiting.
+ */
+SmTxQueue::SmTxState SmTxQueue::getState() const
+{
+    return m_state;
+}
+
+/**
+ * @brief Gets the number of waiting packets.
+ *
+ * @return The number of packets, including the sent one.
+ */
+uint8_t SmTxQueue::getCount() const
+{
+    return m_count;
+}
+
+/**
+ * @brief Checks if a message was delivered.
+ *
+ * Only the latest message of a stream is delivered, a superseded message is not (even if its packet on air is
+ * acknowledged). The check is meaningful after all packets of the message were committed.
+ *
+ * @param stream The stream of the message.
+ * @param message The message (see openMessage).
+ * @return true if all packets of the message were acknowledged, false otherwise.
+ */
+bool SmTxQueue::isDelivered(uint8_t const stream, uint32_t const message) const
+{
+    return stream < MAX_STREAMS && message != NO_MESSAGE && m_streams[stream].delivered == message;
+}
+
+/**
+ * @brief Gets the number of acknowledged packets.
+ *
+ * @return The number of packets.
+ */
+uint32_t SmTxQueue::getDeliveredCount() const
+{
+    return m_deliveredCount;
+}
+
+/**
+ * @brief Gets the number of repeated attempts.
+ *
+ * @return The number of attempts after a busy transceiver, a rejected or a not acknowledged packet.
+ */
+uint32_t SmTxQueue::getRetryCount() const
+{
+    return m_retryCount;
+}
+
+/**
+ * @brief Gets the number of dropped packets.
+ *
+ * @return The number of packets dropped after MAX_ATTEMPTS attempts, including the other packets of their message.
+ */
+uint32_t SmTxQueue::getDroppedCount() const
+{
+    return m_droppedCount;
+}
+
+/**
+ * @brief Gets the number of superseded packets.
+ *
+ * @return The number of waiting packets dropped as a newer message of their stream was opened.
+ */
+uint32_t SmTxQueue::getSupersededCount() const
+{
+    return m_supersededCount;
+}
+
+/**
+ * @brief Gets the number of packets dropped as too large for the data rate.
+ *
+ * @return The number of packets, including the other packets of their message.
+ */
+uint32_t SmTxQueue::getOversizedCount() const
+{
+    return m_oversizedCount;
+}
+
+/**
+ * @brief Takes a message which was dropped as a packet exceeded the payload of the current data rate.
+ *
+ * Each message is reported once, the caller plans its uplink again with the payload of the current data rate.
+ *
+ * @param stream The stream of the message.
+ * @param message The message (see openMessage).
+ * @return true if a message was taken, false if there is none.
+ */
+bool SmTxQueue::takeOversized(uint8_t& stream, uint32_t& message)
+{
+    for(uint8_t i = 0; i < MAX_STREAMS; i++)
+    {
+        if(m_streams[i].oversized != NO_MESSAGE)
+        {
+            stream = i;
+            message = m_streams[i].oversized;
+
+            m_streams[i].oversized = NO_MESSAGE;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Hands the packet at the head of the queue to the radio.
+ *
+ * A rejected packet is retried after the backoff, a busy transceiver after BUSY_RETRY_DELAY. Only the attempts
+ * which were rejected or went on air count towards MAX_ATTEMPTS. A head which exceeds the payload of the current
+ * data rate would be rejected on each attempt, its message is dropped without attempt (see dropOversized).
+ *
+ * @param now The current time in ms.
+ */
+void SmTxQueue::sendHead(uint32_t const now)
+{
+    while(dropOversized())
+    {
+        // the next head is checked as well
+    }
+
+    if(m_count == 0)
+    {
+        m_state = SmTxState::SMTXSTATE_IDLE;
+
+        return;
+    }
+
+    SmTxPacket& packet = m_packets[0];
+
+    switch(m_radio.send(m_pool + packet.offset, packet.size, packet.fport))
+    {
+        case SmTxResult::SMTX_SUCCESS:
+            packet.attempts++;
+
+            m_headOnAir = true;
+            m_state = SmTxState::SMTXSTATE_SENDING;
+            m_deadline = now + TXFIN_TIMEOUT;
+            break;
+
+        case SmTxResult::SMTX_BUSY:
+            MyLog::log("SMTXQUEUE", "Transceiver busy, retry in %lu ms", (unsigned long) BUSY_RETRY_DELAY);
+
+            waitBusy(now);
+            break;
+
+        case SmTxResult::SMTX_ERROR:
+        default:
+            packet.attempts++;
+
+            MyLog::log("SMTXQUEUE", "Packet of %d bytes rejected, attempt %d of %d", packet.size, packet.attempts, MAX_ATTEMPTS);
+
+            retryHead(now);
+            break;
+    }
+}
+
+/**
+ * @brief Sends the packet at the head of the queue again after the backoff.
+ *
+ * Each failure in a row doubles the backoff (up to MAX_RETRY_DELAY), a link which is down is not flooded and
+ * recovers without reset. After MAX_ATTEMPTS attempts the packet is dropped with the rest of its message, the next
+ * packet waits for the backoff as well.
+ *
+ * @param now The current time in ms.
+ */
+void SmTxQueue::retryHead(uint32_t const now)
+{
+    if(m_failures < UINT8_MAX)
+    {
+        m_failures++;
+    }
+
+    if(m_packets[0].attempts >= MAX_ATTEMPTS)
+    {
+        MyLog::log("SMTXQUEUE", "Packet dropped after %d attempts", MAX_ATTEMPTS);
+
+        m_droppedCount += dropHead();
+    }
+    else
+    {
+        m_retryCount++;
+    }
+
+    if(m_count == 0)
+    {
+        m_state = SmTxState::SMTXSTATE_IDLE;
+
+        return;
+    }
+
+    m_state = SmTxState::SMTXSTATE_WAITING;
+    m_deadline = now + getBackoff();
+}
+
+/**
+ * @brief Sends the packet at the head of the queue again after BUSY_RETRY_DELAY.
+ *
+ * The transceiver is busy with another TX cycle (e.g. a MAC uplink or a packet whose end of the TX cycle did not
+ * come yet), this is no failure of the packet: the backoff and the attempts are kept. The end of that TX cycle
+ * sends the packet even before the timer (see txFinished).
+ *
+ * @param now The current time in ms.
+ */
+void SmTxQueue::waitBusy(uint32_t const now)
+{
+    m_retryCount++;
+
+    m_state = SmTxState::SMTXSTATE_WAITING;
+    m_deadline = now + BUSY_RETRY_DELAY;
+}
+
+/**
+ * @brief Removes the acknowledged packet at the head of the queue.
+ *
+ * The message of the packet is delivered if it is the latest one of its stream and no other packet of it waits.
+ */
+void SmTxQueue::acknowledgeHead()
+{
+    SmTxPacket const packet = m_packets[0];
+
+    m_deliveredCount++;
+    m_failures = 0;
+
+    removePacket(0);
+
+    m_state = SmTxState::SMTXSTATE_IDLE;
+
+    if(packet.stream < MAX_STREAMS && m_streams[packet.stream].latest == packet.message && !hasMessage(packet.message))
+    {
+        m_streams[packet.stream].delivered = packet.message;
+    }
+}
+
+/**
+ * @brief Removes the packet at the head of the queue and the other packets of its message.
+ *
+ * The fragments of a message cannot be reassembled without the dropped one, they are not sent.
+ *
+ * @return The number of packets removed.
+ */
+uint8_t SmTxQueue::dropHead()
+{
+    uint32_t message = m_packets[0].message;
+
+    removePacket(0);
+
+    uint8_t dropped = 1;
+
+    if(message == NO_MESSAGE)
+    {
+        return dropped;
+    }
+
+    uint8_t i = 0;
+
+    while(i < m_count)
+    {
+        if(m_packets[i].message == message)
+        {
+            removePacket(i);
+
+            dropped++;
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    return dropped;
+}
+
+/**
+ * @brief Drops the message of the head if the head exceeds the payload of the current data rate.
+ *
+ * The packet was planned for a larger payload (e.g. the data rate dropped by ADR since), the radio would reject it
+ * on each attempt and block the packets behind it. The message is reported to be planned again (see takeOversized),
+ * it is no send failure. A payload of 0 (e.g. pending MAC commands) is not known, the head is sent as is.
+ *
+ * @return true if the head was dropped, false otherwise.
+ */
+bool SmTxQueue::dropOversized()
+{
+    if(m_count == 0)
+    {
+        return false;
+    }
+
+    SmTxPacket const packet = m_packets[0];
+    size_t maxPayloadSize = m_radio.getMaxPayloadSize();
+
+    if(maxPayloadSize == 0 || packet.size <= maxPayloadSize)
+    {
+        return false;
+    }
+
+    MyLog::log("SMTXQUEUE", "Packet of %d bytes exceeds the payload of %d bytes, message dropped", packet.size, maxPayloadSize);
+
+    m_oversizedCount += dropHead();
+
+    if(packet.stream < MAX_STREAMS && m_streams[packet.stream].latest == packet.message)
+    {
+        m_streams[packet.stream].oversized = packet.message;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Removes the waiting packets of a stream, their data is superseded by the next message.
+ *
+ * The packet on air is kept, its end of the TX cycle is still handled. A waiting head is replaced by the next
+ * packet, it keeps the time of the timer.
+ *
+ * @param stream The stream.
+ */
+void SmTxQueue::dropStale(uint8_t const stream)
+{
+    uint8_t i = m_state == SmTxState::SMTXSTATE_SENDING ? 1 : 0;
+    uint8_t superseded = 0;
+
+    while(i < m_count)
+    {
+        if(m_packets[i].stream == stream)
+        {
+            removePacket(i);
+
+            superseded++;
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    if(superseded > 0)
+    {
+        MyLog::log("SMTXQUEUE", "%d stale packets of stream %d superseded", superseded, stream);
+
+        m_supersededCount += superseded;
+    }
+
+    if(m_count == 0)
+    {
+        m_state = SmTxState::SMTXSTATE_IDLE;
+    }
+}
+
+/**
+ * @brief Gets the backoff after the failures in a row.
+ *
+ * @return RETRY_DELAY doubled with each further failure, at most MAX_RETRY_DELAY.
+ */
+uint32_t SmTxQueue::getBackoff() const
+{
+    uint32_t delay = RETRY_DELAY;
+
+    for(uint8_t i = 1; i < m_failures && delay < MAX_RETRY_DELAY; i++)
+    {
+        delay *= 2;
+    }
+
+    return delay < MAX_RETRY_DELAY ? delay : MAX_RETRY_DELAY;
+}
+
+/**
+ * @brief Checks if a packet of a message is waiting.
+ *
+ * @param message The message.
+ * @return true if a packet of the message is in the queue, false otherwise.
+ */
+bool SmTxQueue::hasMessage(uint32_t const message) const
+{
+    for(uint8_t i = 0; i < m_count; i++)
+    {
+        if(m_packets[i].message == message)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Removes a packet, the data of the packets behind it is moved up in the pool.
+ *
+ * @param index The index of the packet in the queue.
+ */
+void SmTxQueue::removePacket(uint8_t const index)
+{
+    if(index >= m_count)
+    {
+        return;
+    }
+
+    if(index == 0)
+    {
+        m_headOnAir = false;
+    }
+
+    size_t offset = m_packets[index].offset;
+    size_t size = m_packets[index].size;
+
+    memmove(m_pool + offset, m_pool + offset + size, m_poolUsed - offset - size);
+
+    m_poolUsed -= size;
+    m_count--;
+
+    for(uint8_t i = index; i < m_count; i++)
+    {
+        m_packets[i] = m_packets[i + 1];
+        m_packets[i].offset -= size;
+    }
+}
@@ -0,0 +1,129 @@
+/**
+ * @file smtxqueue.h
+ * @brief This file contains the declaration of the SmTxQueue class.
+ *
+ * Non-blocking transmit queue of the uplink frames. The frames are written straight into the queue and handed
+ * to the radio one at a time (see SmTxRadio). The queue is driven by events instead of waiting: the end of the
+ * TX cycle of a packet (LORA_TX_FIN) sends the next one, a busy transceiver or a rejected packet is retried when
+ * the timer expires. The caller arms its timer with getTimerDelay after each event, so the MCU sleeps between the
+ * attempts and the read cycle continues while the uplinks drain. The queue keeps no time of its own, each event
+ * gets the current time in ms (e.g. millis()).
+ *
+ * Each packet (frame or fragment) is tracked on its own, only the packet which failed is sent again. The retries
+ * back off exponentially while the failures go on, the link is not reset. A busy transceiver is no failure, the
+ * packet is tried again shortly without backoff and without counting the attempt. The packets of an uplink form a message
+ * of a stream (e.g. a meter): a new message of the stream supersedes its waiting packets (newer data), a message
+ * which lost a packet is dropped as a whole (the fragments cannot be reassembled). A packet which exceeds the payload
+ * of the current data rate when its turn comes (e.g. the data rate dropped by ADR since it was planned) is not
+ * retried: its message is dropped at once and reported (see takeOversized), the caller plans the uplink again.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "smtxradio.h"
+
+class SmTxQueue
+{
+    public:
+        static size_t const MAX_PACKET_SIZE = 222;                                                  // largest LoRaWAN payload (data rate with the largest payload)
+        static uint8_t const MAX_PACKETS = 16;                                                      // packets waiting in the queue
+        static size_t const POOL_SIZE = 1024;                                                       // bytes of the waiting packets
+        static uint8_t const MAX_ATTEMPTS = 10;                                                     // attempts of a packet (rejected or not acknowledged) before it is dropped
+        static uint32_t const RETRY_DELAY = 5000;                                                   // time in ms till a packet is sent again after the first failure, doubled with each further failure
+        static uint32_t const BUSY_RETRY_DELAY = 1000;                                              // time in ms till a packet is sent again if the transceiver was busy (no failure)
+        static uint32_t const MAX_RETRY_DELAY = 320000;                                             // longest time in ms between two attempts
+        static uint32_t const TXFIN_TIMEOUT = 60000;                                                // time in ms till a packet without end of its TX cycle is not acknowledged
+        static uint32_t const NO_TIMER = 0;                                                         // the queue needs no timer
+        static uint8_t const MAX_STREAMS = 8;                                                       // streams with their own messages (e.g. the meters)
+        static uint8_t const NO_STREAM = 0xff;                                                      // packets without message, they are never superseded
+        static uint32_t const NO_MESSAGE = 0;                                                       // message of the packets without stream
+
+        /**
+         * @brief State of the packet at the head of the queue.
+         */
+        enum class SmTxState
+        {
+            SMTXSTATE_IDLE,                                                                         // no packet is waiting
+            SMTXSTATE_SENDING,                                                                      // the packet is sent, waiting for the end of its TX cycle
+            SMTXSTATE_WAITING                                                                       // the packet is sent again when the timer expires
+        };
+
+        explicit SmTxQueue(SmTxRadio& radio);
+
+        uint32_t openMessage(uint8_t const stream);                                                 // starts the next message of a stream, its waiting packets are superseded
+        uint8_t* reserve();                                                                         // buffer for the next packet (MAX_PACKET_SIZE bytes), nullptr if the queue is full
+        bool commit(size_t const size, uint8_t const fport, uint32_t const now);                    // queues the packet of the open message and sends it if the queue is idle
+        void abortMessage();                                                                        // drops the waiting packets of the open message, it could not be queued as a whole
+        void txFinished(bool const acknowledged, uint32_t const now);                               // end of the TX cycle of the sent packet
+        void timerExpired(uint32_t const now);                                                      // retries the waiting packet, or gives up on the end of the TX cycle
+        uint32_t getTimerDelay(uint32_t const now) const;                                           // time in ms till timerExpired is due, NO_TIMER if the queue is idle
+        SmTxState getState() const;                                                                 // state of the packet at the head of the queue
+        uint8_t getCount() const;                                                                   // number of waiting packets (including the sent one)
+        bool isDelivered(uint8_t const stream, uint32_t const message) const;                       // true if all packets of the latest message of the stream were acknowledged
+        uint32_t getDeliveredCount() const;                                                         // packets acknowledged
+        uint32_t getRetryCount() const;                                                             // attempts repeated (busy, rejected or not acknowledged)
+        uint32_t getDroppedCount() const;                                                           // packets dropped after MAX_ATTEMPTS attempts, with the rest of their message
+        uint32_t getSupersededCount() const;                                                        // packets dropped as a newer message of their stream was opened
+        uint32_t getOversizedCount() const;                                                         // packets dropped as their message exceeded the payload of the data rate
+        bool takeOversized(uint8_t& stream, uint32_t& message);                                     // takes a message dropped as too large for the data rate, false if there is none
+
+    private:
+        /**
+         * @brief Packet waiting in the queue, its data is in the pool.
+         */
+        struct SmTxPacket
+        {
+            uint16_t offset;                                                                        // offset of the data in the pool
+            uint8_t size;                                                                           // size of the data
+            uint8_t fport;                                                                          // LoRaWAN port
+            uint8_t attempts;                                                                       // attempts so far (rejected or on air, not busy)
+            uint8_t stream;                                                                         // stream of the message, NO_STREAM without message
+            uint32_t message;                                                                       // message of the packet, NO_MESSAGE without stream
+        };
+
+        /**
+         * @brief Messages of a stream.
+         */
+        struct SmTxStream
+        {
+            uint32_t latest;                                                                        // latest message, it supersedes the older ones
+            uint32_t delivered;                                                                     // latest message whose packets were all acknowledged
+            uint32_t oversized;                                                                     // message dropped as too large for the data rate, NO_MESSAGE once taken
+        };
+
+        SmTxRadio& m_radio;                                                                         // radio the packets are handed to
+        uint8_t m_pool[POOL_SIZE];                                                                  // data of the waiting packets, in the order of the queue
+        size_t m_poolUsed = 0;                                                                      // bytes used in the pool
+        SmTxPacket m_packets[MAX_PACKETS];                                                          // waiting packets, the head is sent first
+        uint8_t m_count = 0;                                                                        // number of waiting packets
+        SmTxState m_state = SmTxState::SMTXSTATE_IDLE;                                              // state of the head
+        uint32_t m_deadline = 0;                                                                    // time the timer of the head expires
+        bool m_headOnAir = false;                                                                   // the head was handed to the radio and its end of the TX cycle did not come yet
+        uint8_t m_failures = 0;                                                                     // failed attempts in a row (not busy), sets the backoff
+        SmTxStream m_streams[MAX_STREAMS] = {};                                                     // messages of each stream
+        uint8_t m_openStream = NO_STREAM;                                                           // stream of the committed packets
+        uint32_t m_openMessage = NO_MESSAGE;                                                        // message of the committed packets
+        uint32_t m_lastMessage = NO_MESSAGE;                                                        // last message opened (of any stream)
+        uint32_t m_deliveredCount = 0;                                                              // packets acknowledged
+        uint32_t m_retryCount = 0;                                                                  // attempts repeated
+        uint32_t m_droppedCount = 0;                                                                // packets dropped after MAX_ATTEMPTS attempts
+        uint32_t m_supersededCount = 0;                                                             // packets dropped by a newer message
+        uint32_t m_oversizedCount = 0;                                                              // packets dropped as too large for the data rate
+
+        void sendHead(uint32_t const now);                                                          // hands the head to the radio
+        void retryHead(uint32_t const now);                                                         // sends the head again after the backoff, drops its message after MAX_ATTEMPTS
+        void waitBusy(uint32_t const now);                                                          // sends the head again after BUSY_RETRY_DELAY, the attempt does not count
+        void acknowledgeHead();                                                                     // removes the acknowledged head, completes its message
+        uint8_t dropHead();                                                                         // removes the head and the other packets of its message, returns their number
+        bool dropOversized();                                                                       // drops the message of the head if the head exceeds the payload of the data rate
+        void dropStale(uint8_t const stream);                                                       // removes the waiting packets of the stream, not the one on air
+        uint32_t getBackoff() const;                                                                // time till the next attempt after the failures in a row
+        bool hasMessage(uint32_t const message) const;                                              // true if a packet of the message is waiting
+        void removePacket(uint8_t const index);                                                     // removes a packet and its data from the pool
+};
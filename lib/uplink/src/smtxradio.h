@@ -0,0 +1,35 @@
+/**
+ * @file smtxradio.h
+ * @brief This file contains the declaration of the SmTxRadio interface.
+ *
+ * The transmit queue (see SmTxQueue) hands its packets to the radio one at a time. The LoRaWAN transport
+ * implements the radio (e.g. WmbNrf52), the host tests inject BUSY, ERROR and NAK patterns with a fake radio.
+ * The result of a confirmed uplink is reported later by the transport (LORA_TX_FIN), not by the send call. The
+ * queue checks each packet against the payload of the current data rate before it is sent (e.g. after an ADR drop).
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Result of handing a packet to the radio.
+ */
+enum class SmTxResult
+{
+    SMTX_SUCCESS,                                                                                   // the packet is sent, its result follows with the end of the TX cycle
+    SMTX_BUSY,                                                                                      // the transceiver is busy, the packet is sent again later
+    SMTX_ERROR                                                                                      // the packet was rejected (e.g. not joined or too large for the data rate)
+};
+
+class SmTxRadio
+{
+    public:
+        virtual ~SmTxRadio() = default;
+        virtual SmTxResult send(uint8_t const* data, size_t const size, uint8_t const fport) = 0;   // hands a packet to the radio without waiting for its TX cycle
+        virtual size_t getMaxPayloadSize() = 0;                                                     // maximum payload of the next uplink at the current data rate, 0 if unknown
+};
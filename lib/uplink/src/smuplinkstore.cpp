@@ -0,0 +1,95 @@
+/**
+ * @file smuplinkstore.cpp
+ * @brief Implementation of the SmUplinkStore class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include <string.h>
+
+#include "smuplinkstore.h"
+
+/**
+ * @brief Keeps a copy of an uplink.
+ *
+ * The uplink kept is planned again from its own copy, then it is not copied.
+ *
+ * @param data The uplink.
+ * @param recordEnds The end offset of each record, the last one is the size of the uplink.
+ * @param recordCount The number of records.
+ * @return true if the uplink was kept, false if it is empty or too large (the copy is cleared).
+ */
+bool SmUplinkStore::keep(uint8_t const* data, uint16_t const* recordEnds, uint8_t const recordCount)
+{
+    m_message = 0;
+
+    if(data == m_data)
+    {
+        return m_recordCount > 0;
+    }
+
+    m_recordCount = 0;
+
+    if(recordCount == 0 || recordCount > MAX_RECORDS || recordEnds[recordCount - 1] > MAX_SIZE)
+    {
+        return false;
+    }
+
+    memcpy(m_data, data, recordEnds[recordCount - 1]);
+    memcpy(m_recordEnds, recordEnds, recordCount * sizeof(uint16_t));
+
+    m_recordCount = recordCount;
+
+    return true;
+}
+
+/**
+ * @brief Sets the message of the transmit queue the uplink was sent as.
+ *
+ * @param message The message (see SmTxQueue::openMessage).
+ */
+void SmUplinkStore::setMessage(uint32_t const message)
+{
+    m_message = message;
+}
+
+/**
+ * @brief Gets the message of the transmit queue the uplink was sent as.
+ *
+ * @return The message, 0 if the uplink was not queued.
+ */
+uint32_t SmUplinkStore::getMessage() const
+{
+    return m_message;
+}
+
+/**
+ * @brief Gets the data of the uplink.
+ *
+ * @return The data.
+ */
+uint8_t const* SmUplinkStore::getData() const
+{
+    return m_data;
+}
+
+/**
+ * @brief Gets the end offset of each record.
+ *
+ * @return The record ends, the last one is the size of the uplink.
+ */
+uint16_t const* SmUplinkStore::getRecordEnds() const
+{
+    return m_recordEnds;
+}
+
+/**
+ * @brief Gets the number of records.
+ *
+ * @return The number of records, 0 if no uplink is kept.
+ */
+uint8_t SmUplinkStore::getRecordCount() const
+{
+    return m_recordCount;
+}
@@ -0,0 +1,36 @@
+/**
+ * @file smuplinkstore.h
+ * @brief This file contains the declaration of the SmUplinkStore class.
+ *
+ * Keeps the last uplink of a stream with its record boundaries, so it can be planned again once its frames no
+ * longer fit into the payload of the current data rate (see SmTxQueue::takeOversized). The encoder buffer (e.g.
+ * SmCayenne) is reused by the next uplink, the transmit queue only keeps the planned frames.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+class SmUplinkStore
+{
+    public:
+        static size_t const MAX_SIZE = 255;                                                         // largest uplink (the size of SmCayenne is a uint8_t)
+        static uint8_t const MAX_RECORDS = 64;                                                      // record boundaries of one uplink (see SmCayenne)
+
+        bool keep(uint8_t const* data, uint16_t const* recordEnds, uint8_t const recordCount);      // keeps a copy of the uplink, false if it is too large
+        void setMessage(uint32_t const message);                                                    // sets the message of the transmit queue the uplink was sent as
+        uint32_t getMessage() const;                                                                // message of the transmit queue the uplink was sent as
+        uint8_t const* getData() const;                                                             // data of the uplink
+        uint16_t const* getRecordEnds() const;                                                      // end offset of each record
+        uint8_t getRecordCount() const;                                                             // number of records, 0 if no uplink is kept
+
+    private:
+        uint8_t m_data[MAX_SIZE];                                                                   // data of the uplink
+        uint16_t m_recordEnds[MAX_RECORDS];                                                         // end offset of each record
+        uint8_t m_recordCount = 0;                                                                  // number of records
+        uint32_t m_message = 0;                                                                     // message of the transmit queue, 0 if it was not queued
+};
@@ -0,0 +1,112 @@
+/**
+ * @file smvarint.cpp
+ * @brief Implementation of the SmVarint class.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+
+#include "smvarint.h"
+
+/**
+ * @brief Maps a signed value to an unsigned one (zigzag).
+ *
+ * @param value The signed value.
+ * @return 2 * value for positive values, -2 * value - 1 for negative values.
+ */
+uint64_t SmVarint::zigzag(int64_t const value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ (value < 0 ? UINT64_MAX : 0);
+}
+
+/**
+ * @brief Maps a zigzag value back to the signed value.
+ *
+ * @param value The zigzag value.
+ * @return The signed value.
+ */
+int64_t SmVarint::unzigzag(uint64_t const value)
+{
+    return static_cast<int64_t>((value >> 1) ^ (0 - (value & 1)));
+}
+
+/**
+ * @brief Gets the number of bytes of an encoded value.
+ *
+ * @param value The value.
+ * @return 1 to MAX_SIZE bytes.
+ */
+uint8_t SmVarint::getSize(uint64_t const value)
+{
+    uint8_t size = 1;
+
+    for(uint64_t rest = value >> 7; rest != 0; rest >>= 7)
+    {
+        size++;
+    }
+
+    return size;
+}
+
+/**
+ * @brief Appends an encoded value to a buffer.
+ *
+ * @param buffer The buffer.
+ * @param size The size of the buffer.
+ * @param position The write position, moved behind the value if it fits.
+ * @param value The value.
+ * @return true if the value was appended, false if it does not fit (nothing is written).
+ */
+bool SmVarint::write(uint8_t* buffer, size_t const size, size_t& position, uint64_t const value)
+{
+    if(position > size || getSize(value) > size - position)
+    {
+        return false;
+    }
+
+    uint64_t rest = value;
+
+    while(rest >= 0x80)
+    {
+        buffer[position++] = static_cast<uint8_t>(rest | 0x80);
+
+        rest >>= 7;
+    }
+
+    buffer[position++] = static_cast<uint8_t>(rest);
+
+    return true;
+}
+
+/**
+ * @brief Reads an encoded value.
+ *
+ * @param cursor The read position, moved behind the value.
+ * @param value The value.
+ * @return true if the value was read, false if it is truncated or longer than MAX_SIZE bytes.
+ */
+bool SmVarint::read(ByteCursor& cursor, uint64_t& value)
+{
+    value = 0;
+
+    for(uint8_t i = 0; i < MAX_SIZE; i++)
+    {
+        if(!cursor.has(1))
+        {
+            return false;
+        }
+
+        uint8_t const byte = cursor.peekUint8(0);
+
+        cursor.skip(1);
+
+        value |= static_cast<uint64_t>(byte & 0x7f) << (7 * i);
+
+        if((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,30 @@
+/**
+ * @file smvarint.h
+ * @brief This file contains the declaration of the SmVarint class.
+ *
+ * Variable length integers of the compact uplink encodings: 7 bits per byte, least significant group first,
+ * the high bit marks a following byte. Signed values are zigzag mapped first (0, -1, 1, -2, ... become
+ * 0, 1, 2, 3, ...), so small deltas of either sign take one byte.
+ *
+ * @version 1.0
+ * @author MFA Informatik AG, Andreas Schneider
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "bytecursor.h"
+
+class SmVarint
+{
+    public:
+        static uint8_t const MAX_SIZE = 10;                                                         // bytes of the largest 64 bit value
+
+        static uint64_t zigzag(int64_t const value);                                                // maps a signed value to an unsigned one, small magnitudes stay small
+        static int64_t unzigzag(uint64_t const value);                                              // inverse of zigzag
+        static uint8_t getSize(uint64_t const value);                                               // number of bytes of the encoded value
+        static bool write(uint8_t* buffer, size_t const size, size_t& position, uint64_t const value);  // appends the value at the position, false if it does not fit
+        static bool read(ByteCursor& cursor, uint64_t& value);                                      // reads a value, false if it is truncated or too long
+};
@@ -22,7 +22,16 @@ class WbMcuBase
         virtual void startWatchDog() = 0;                                                                       // start the watch dog timer
         virtual void resetWatchDog() = 0;                                                                       // reset the watch dog timer
         virtual void delayWithLed(time_t delayWithLedTimeOut) = 0;                                              // delay with LED indication
-        virtual lmh_error_status enqueueDataPacket(const uint8_t *data, size_t size, uint8_t fport) = 0;        // enqueue a data packet to be sent over WAN
+        virtual void setActivityLed(bool active) = 0;                                                           // blink the LED by timer while data is received
+        virtual uint8_t* getTxBuffer() = 0;                                                                     // transmit buffer of the next packet (getMaxPayloadSize() bytes), nullptr if the transmit queue is full
+        virtual lmh_error_status sendTxBuffer(size_t size, uint8_t fport) = 0;                                  // queues the packet written into the transmit buffer, it is sent over WAN without waiting
+        virtual void setWakeUpTimer(uint32_t wakeUpDelay) = 0;                                                  // sets the time in ms till the next read cycle
+        virtual uint32_t openUplink(uint8_t stream) = 0;                                                        // starts the next uplink of a stream (e.g. a meter), the waiting packets of its older uplinks are dropped
+        virtual void abortUplink() = 0;                                                                         // drops the waiting packets of the uplink started last, it could not be queued as a whole
+        virtual bool isUplinkDelivered(uint8_t stream, uint32_t uplink) = 0;                                    // true if all packets of the latest uplink of the stream were acknowledged
+        virtual uint16_t getSendFailures() = 0;                                                                 // number of packets given up after all attempts since the start
+        virtual size_t getMaxPayloadSize() = 0;                                                                 // maximum payload of the next uplink at the current data rate
+        virtual bool takeOversizedUplink(uint8_t& stream, uint32_t& uplink) = 0;                                // takes an uplink dropped as its packets exceed the current data rate, it is planned again
         virtual bool loadConfiguration(AppConfig& appConfig);                                                   // load flash stored settings
         virtual bool saveConfiguration(AppConfig const& appConfig);                                             // save settings to flash
 
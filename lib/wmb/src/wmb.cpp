@@ -22,18 +22,16 @@
  * @brief Constructor for the Wmb class.
  * 
  * @param wbMcu Reference to the WbMcuBase object.
- * @param smartmeter Reference to the SmBase object.
- * @param gbt Reference to the Gbt object.
- * @param dlms Reference to the Dlms object.
+ * @param smartmeters Reference to the SmMeter object of each meter.
+ * @param meterBus Reference to the SmMeterBus object (receive state of each meter).
  * @param hdlc Reference to the Hdlc object.
  * @param smCayenne Reference to the SmCayenne object.
  * @param appConfig Reference to the AppConfig object.
  */
-Wmb::Wmb(WbMcuBase& wbMcu, SmBase& smartmeter, Gbt& gbt, Dlms& dlms, Hdlc& Hdlc, SmCayenne &smCayenne, AppConfig &appConfig) : 
+Wmb::Wmb(WbMcuBase& wbMcu, SmMeter (&smartmeters)[SM_MAX_METERS], SmMeterBus& meterBus, Hdlc& Hdlc, SmCayenne &smCayenne, AppConfig &appConfig) : 
      m_wbMcu(wbMcu), 
-	 m_smartmeter(smartmeter),
-	 m_gbt(gbt),
-	 m_dlms(dlms),
+	 m_smartmeters(smartmeters),
+	 m_meterBus(meterBus),
 	 m_hdlc(Hdlc),
      m_smCayenne(smCayenne), 
      m_appConfig(appConfig)
@@ -43,7 +41,8 @@ Wmb::Wmb(WbMcuBase& wbMcu, SmBase& smartmeter, Gbt& gbt, Dlms& dlms, Hdlc& Hdlc,
 /**
  * @brief Handles the data for the Wmb class.
  *
- * This function is responsible for handling the data based on the event type (forwards it to the MCU)
+ * This function is responsible for handling the data based on the event type (forwards it to the MCU). The
+ * uplinks which the transmit queue dropped as too large for the current data rate are planned again.
  *
  * @param event_type The type of event to be handled.
  */
@@ -51,6 +50,8 @@ void Wmb::dataHandler(uint16_t event_type)
 {
     m_wbMcu.dataHandler(event_type);
 
+    replanUplinks();
+
     m_wbMcu.resetWatchDog();
 }
 
@@ -64,190 +65,1048 @@ void Wmb::setupApp()
 
 
 /**
- * @brief Initializes the WMB application.
- * 
- * This function initializes the WMB application 
- * 
- * @return true if the initialization is successful, false otherwise.
+ * @brief Initializes the WMB application.
+ * 
+ * This function initializes the WMB application 
+ * 
+ * @return true if the initialization is successful, false otherwise.
+ */
+bool Wmb::initApp()
+{
+    mbusAdapterOff();
+
+	MyLog::log("WMB", "Load application config");
+
+	m_wbMcu.loadConfiguration(m_appConfig);
+
+	MyLog::log("APPSETTINGS", "...measureInterval: %d", m_appConfig.measureInterval);
+    MyLog::log("APPSETTINGS", "...sendDataType: %d", m_appConfig.sendDataType);
+    MyLog::log("APPSETTINGS", "...decryptData: %d", m_appConfig.decryptData);
+    MyLog::log("APPSETTINGS", "...smCycleTimeout: %d", m_appConfig.smCycleTimeout);
+    MyLog::log("APPSETTINGS", "...meterProfile: %d", m_appConfig.meterProfile);
+    MyLog::log("APPSETTINGS", "...meterCount: %d", m_appConfig.meterCount);
+    MyLog::log("APPSETTINGS", "...pushSchedule: %d", m_appConfig.pushSchedule);
+    MyLog::log("APPSETTINGS", "...aggregationWindow: %d", m_appConfig.aggregationWindow);
+    MyLog::log("APPSETTINGS", "...eventUplinks: %d", m_appConfig.eventUplinks);
+    MyLog::log("APPSETTINGS", "...deltaKeyframeInterval: %d", m_appConfig.deltaKeyframeInterval);
+    MyLog::log("APPSETTINGS", "...priorityTruncation: %d", m_appConfig.priorityTruncation);
+    MyLog::log("APPSETTINGS", "...registerFilterCount: %d", m_appConfig.registerFilterCount);
+    MyLog::log("APPSETTINGS", "...dictionaryRequest: %d", m_appConfig.dictionaryRequest);
+
+	if(m_appConfig.decryptData)
+	{
+		MyLog::log("APPSETTINGS", "...sizeof aes_iv: %d", sizeof(m_appConfig.aes_iv));
+		MyLog::log("APPSETTINGS", "...sizeof aes_key: %d", sizeof(m_appConfig.aes_key));
+		MyLog::log("APPSETTINGS", "...sizeof authenticationKey: %d", sizeof(m_appConfig.authenticationKey));
+	}
+
+	MyLog::log("WMB", "...reading global values for WisBlock timer");
+
+	g_appTimer = m_appConfig.measureInterval;
+
+	initMeters();
+
+	// the receive window starts after the two warm-ups of the read cycle
+	m_pushScheduler.configure(m_appConfig.measureInterval, m_appConfig.smCycleTimeout, 2 * SM_WARMUP_TIME);
+
+    m_wbMcu.initApp();
+
+    return true;
+}
+
+/**
+ * @brief Applies the meter configuration to the meters and the bus.
+ *
+ * All meters on the bus use the configured profile (they share the serial settings), each meter has its own
+ * hdlc source address, uplink channel and the read cycle timeout.
+ */
+void Wmb::initMeters()
+{
+	if(!m_meterBus.setMeterCount(m_appConfig.meterCount))
+	{
+		MyLog::log("WMB", "...meter count %d not supported, using %d meter(s)", m_appConfig.meterCount, m_meterBus.getMeterCount());
+	}
+
+	for(uint8_t i = 0; i < SM_MAX_METERS; i++)
+	{
+		m_smartmeters[i].selectProfile(m_appConfig.meterProfile);
+		m_smartmeters[i].selectChannel(m_appConfig.meterChannel[i]);
+		m_smartmeters[i].selectSerialSetting(m_appConfig.serialBaudRate, (SmSerialFormat) m_appConfig.serialFormat);
+		m_smartmeters[i].selectRegisterFilter(m_appConfig.registerFilter, m_appConfig.registerFilterCount);
+
+		m_meterBus.configure(i, m_appConfig.meterAddress[i], m_appConfig.smCycleTimeout);
+
+		// the first push with the new configuration is sent (in full)
+		m_eventRules[i].reset();
+		m_derived[i].reset();
+		m_deltaEncoders[i].reset();
+		m_deltaEncoders[i].setKeyframeInterval(m_appConfig.deltaKeyframeInterval);
+		m_deltaUplink[i] = 0;
+		m_dictionarySessions[i].reset();
+		m_priorityPlans[i].reset();
+	}
+
+	if(!m_fixedEncoder.select(m_appConfig.meterProfile))
+	{
+		MyLog::log("WMB", "...profile %d has no fixed layout, the fixed payload sends the full push", m_appConfig.meterProfile);
+	}
+
+	if(!m_gbtCompressor.select(m_appConfig.meterProfile))
+	{
+		MyLog::log("WMB", "...profile %d has no GBT dictionary, the compressed GBT block is sent as is", m_appConfig.meterProfile);
+	}
+
+	for(uint8_t i = 0; i < m_meterBus.getMeterCount(); i++)
+	{
+		MyLog::log("WMB", "...meter %d with address %lu on channel %d", i, (unsigned long) m_appConfig.meterAddress[i], m_smartmeters[i].getChannel());
+	}
+}
+
+/**
+ * @brief Reads and sends data from the smart meter.
+ * 
+ * This function reads and sends data from the smart meter.
+ */
+void Wmb::smReadSendcycle()
+{
+	MyLog::log("WMB", "Execute Smartmeter read and send cycle");
+
+	time_t readSendCycleTimeStart = millis();
+
+	// the read cycles start with the next wake-up once the meter is detected
+	if(m_appConfig.meterProfile == AppConfig::SM_METERPROFILE_AUTODETECT)
+	{
+		smDetectcycle();
+
+		m_wbMcu.resetWatchDog();
+
+		return;
+	}
+
+	smReadcycle();
+
+	if(!m_wbMcu.isWlanConnected())
+	{
+		MyLog::log("WMB", "WLAN not connected, skip sending");
+
+		return;
+	}
+
+	// application setting how to send the data via WAN
+	uint8_t sendDataType = m_appConfig.sendDataType;
+
+	bool statesAdded = false;
+	bool uplinkSkipped = false;
+
+	// the dictionaries requested by the server are sent with the next push of each meter
+	if(m_appConfig.dictionaryRequest)
+	{
+		for(uint8_t i = 0; i < m_meterBus.getMeterCount(); i++)
+		{
+			m_dictionarySessions[i].requestDictionary();
+		}
+
+		m_appConfig.dictionaryRequest = false;
+	}
+
+	// one uplink for each meter which has pushed in this cycle
+	for(uint8_t i = 0; i < m_meterBus.getMeterCount(); i++)
+	{
+		SmMeterSlot const& slot = m_meterBus.getSlot(i);
+
+		if(!slot.isFrameReceived())
+		{
+			MyLog::log("WMB", "...no GBT frame of meter %d, nothing to send", i);
+
+			continue;
+		}
+
+		// with event uplinks, a push without event is only sent with the heartbeat
+		if(m_appConfig.eventUplinks && !isUplinkDue(i))
+		{
+			MyLog::log("WMB", "...no event of meter %d, uplink skipped", i);
+
+			uplinkSkipped = true;
+
+			continue;
+		}
+
+		// raw way, send the GBT frame as is or compressed, decoding has to be done on the server side
+		if(isRawUplink())
+		{
+			// a failed uplink keeps its events and the references of the event rules
+			if(sendGbtBlock(i))
+			{
+				m_eventRules[i].uplinkSent();
+			}
+
+			continue;
+		}
+
+		bool dictionaryAdded = false;
+		bool encoded = false;
+
+		// default way via Cayenne LPP (decoded, raw or scaled values), or the statistics of the aggregation window
+		if(isAggregating())
+		{
+			encoded = encodeAggregate(i);
+		}
+		else if(sendDataType == AppConfig::SM_SENDDATATYPE_DERIVED)
+		{
+			encoded = encodeDerived(i);
+		}
+		else if(sendDataType == AppConfig::SM_SENDDATATYPE_DELTA)
+		{
+			encoded = encodeDelta(i);
+		}
+		else if(sendDataType == AppConfig::SM_SENDDATATYPE_DICTIONARY)
+		{
+			encoded = encodeDictionary(i, dictionaryAdded);
+		}
+		else if(sendDataType == AppConfig::SM_SENDDATATYPE_FIXED)
+		{
+			encoded = encodeFixed(i);
+		}
+		else
+		{
+			encoded = decodeFrame(i);
+		}
+
+		// a push which could not be encoded is not sent (the cayenne buffer may hold a part of it)
+		if(!encoded)
+		{
+			MyLog::log("WMB", "...push of meter %d not encoded, nothing to send", i);
+
+			continue;
+		}
+
+		if(m_appConfig.eventUplinks)
+		{
+			m_smCayenne.addEvents(m_smartmeters[i].getChannel(), m_eventRules[i].getEvents());
+		}
+
+		// adds the adapter states into the cayenne buffer of the first uplink
+		if(!statesAdded)
+		{
+			wmbadaper_addStates(m_smCayenne);
+
+			statesAdded = true;
+		}
+
+		// the values of the decoded push which do not fit into one frame are deferred to a later uplink
+		if(m_appConfig.priorityTruncation && !isAggregating() && (sendDataType == AppConfig::SM_SENDDATATYPE_GBTPARSED || sendDataType == AppConfig::SM_SENDDATATYPE_GBTSCALED))
+		{
+			truncateByPriority(i);
+		}
+
+		bool sent = sendCayenne(i);
+
+		if(sent)
+		{
+			// the delta frame of the meter is confirmed once all frames of this uplink are acknowledged
+			m_deltaUplink[i] = m_sentUplink;
+
+			if(dictionaryAdded)
+			{
+				m_dictionarySessions[i].dictionarySent();
+			}
+
+			// the derived push is the reference of the next one only if it was sent
+			if(!isAggregating() && sendDataType == AppConfig::SM_SENDDATATYPE_DERIVED)
+			{
+				m_derived[i].uplinkSent();
+			}
+
+			m_eventRules[i].uplinkSent();
+		}
+	}
+
+	// the adapter states are sent even if no meter has pushed (not if the uplinks are skipped for lack of events)
+	if(!statesAdded && !uplinkSkipped && !isRawUplink())
+	{
+		m_smCayenne.reset();
+
+		wmbadaper_addStates(m_smCayenne);
+
+		sendCayenne(SM_STREAM_ADAPTER);
+	}
+
+	time_t readSendCycleTimeRun = millis() - readSendCycleTimeStart;
+
+	MyLog::log("WMB", "SM read and send cycle completed in %ld ms", readSendCycleTimeRun);
+
+    m_wbMcu.resetWatchDog();
+}
+
+/**
+ * @brief Sends the cayenne buffer via WAN.
+ *
+ * The buffer is not sent if it is empty or has an error.
+ *
+ * @param stream The uplink stream, the index of the meter or SM_STREAM_ADAPTER.
+ * @return true if the buffer was enqueued, false otherwise.
+ */
+bool Wmb::sendCayenne(uint8_t const stream)
+{
+	uint8_t gbtSize = m_smCayenne.getSize();
+
+	if(gbtSize == 0)
+	{
+		MyLog::log("WMB", "...no GBT packet to send (size 0)");
+
+		return false;
+	}
+
+	MyLog::log("WMB", "...send %d bytes via WAN", gbtSize);
+
+	uint8_t cayenneError = m_smCayenne.getError();
+
+	if(cayenneError != 0)
+	{
+		MyLog::log("WMB", "...send GBT packed aborted with Cayenne LPP error %d", cayenneError);
+
+		return false;
+	}
+
+	return sendFrames(stream, m_smCayenne.getBuffer(), m_smCayenne.getRecordEnds(), m_smCayenne.getRecordCount());
+}
+
+/**
+ * @brief Sends an uplink in the fewest frames which fit into the payload of the current data rate.
+ *
+ * The frames end at the record boundaries (see SmFramePlan), the size of each frame is known before it is
+ * enqueued. An uplink of several frames is sent as fragments with a header (see SmFragmenter) on the fragment
+ * port, the server reassembles them. Each frame is written straight into the transmit queue of the transport, the
+ * frames are sent while the read cycle continues. A frame is copied once from the encoded uplink, also a single
+ * frame: the uplink is encoded (and truncated by priority) before the data rate and the frame plan are known, and it
+ * stays in the store for the replan after its frames are queued. The frames form one uplink of the stream in the transmit queue,
+ * it supersedes the frames of the older uplinks of the stream which still wait. If not all frames can be queued
+ * (e.g. the queue is full), the frames queued so far are dropped again. The uplink is kept in m_sentUplink
+ * and its data in the store of the stream: if the data rate drops before its frames are sent, the transmit queue
+ * drops them and the uplink is planned again (see replanUplinks).
+ *
+ * @param stream The uplink stream, the index of the meter or SM_STREAM_ADAPTER.
+ * @param data The uplink.
+ * @param recordEnds The end offset of each record, the last one is the size of the uplink.
+ * @param recordCount The number of records.
+ * @return true if all frames were queued, false otherwise.
+ */
+bool Wmb::sendFrames(uint8_t const stream, uint8_t const* data, uint16_t const* recordEnds, uint8_t const recordCount)
+{
+	m_sentUplink = 0;
+
+	size_t maxPayloadSize = m_wbMcu.getMaxPayloadSize();
+
+	// the pending MAC commands take the whole payload, the uplink is a send failure
+	if(maxPayloadSize == 0)
+	{
+		MyLog::log("WMB", "...no payload left at the current data rate, uplink of stream %d not sent", stream);
+
+		if(m_unsentUplinks < UINT16_MAX)
+		{
+			m_unsentUplinks++;
+		}
+
+		return false;
+	}
+
+	if(!planFrames(recordEnds, recordCount, maxPayloadSize))
+	{
+		return false;
+	}
+
+	// an uplink larger than the store (e.g. a raw GBT block) is not planned again, the next push follows
+	bool kept = stream <= SM_STREAM_ADAPTER && m_uplinkStores[stream].keep(data, recordEnds, recordCount);
+
+	m_sentUplink = m_wbMcu.openUplink(stream);
+
+	// an uplink of several frames is sent as fragments of one message on their own port
+	uint8_t fport = m_fragmenter.isFragmented() ? SM_FPORT_FRAGMENT : SM_FPORT_UPLINK;
+	uint8_t queued = 0;
+
+	for(uint8_t i = 0; i < m_fragmenter.getFrameCount(); i++)
+	{
+		uint8_t* txBuffer = m_wbMcu.getTxBuffer();
+
+		if(txBuffer == nullptr)
+		{
+			MyLog::log("WMB", "...transmit queue full, %d of %d frames queued", i, m_fragmenter.getFrameCount());
+
+			break;
+		}
+
+		size_t frameSize = m_fragmenter.writeFrame(i, data, txBuffer, maxPayloadSize);
+
+		if(m_wbMcu.sendTxBuffer(frameSize, fport) != lmh_error_status::LMH_SUCCESS)
+		{
+			MyLog::log("WMB", "...frame %d of %d (message %d) not queued", i + 1, m_fragmenter.getFrameCount(), m_fragmenter.getMessageId());
+
+			break;
+		}
+
+		queued++;
+	}
+
+	// the frames queued of an incomplete uplink cannot be reassembled, they are not sent
+	if(queued < m_fragmenter.getFrameCount())
+	{
+		m_wbMcu.abortUplink();
+
+		m_sentUplink = 0;
+
+		return false;
+	}
+
+	if(kept)
+	{
+		m_uplinkStores[stream].setMessage(m_sentUplink);
+	}
+
+	return true;
+}
+
+/**
+ * @brief Plans the uplinks again which the transmit queue dropped as too large for the current data rate.
+ *
+ * The frames of an uplink are planned with the payload of the data rate when it is sent. If the data rate drops
+ * (ADR) before its frames are on air, the radio would reject them on each attempt. The transmit queue drops them
+ * instead and reports the uplink, it is planned again from the store of its stream with the current payload. An
+ * uplink superseded in the meantime or not kept in the store is not sent again. A delta frame waiting for the
+ * delivery of the dropped uplink waits for the new one.
+ */
+void Wmb::replanUplinks()
+{
+	uint8_t stream = 0;
+	uint32_t uplink = 0;
+
+	while(m_wbMcu.takeOversizedUplink(stream, uplink))
+	{
+		if(stream > SM_STREAM_ADAPTER || m_uplinkStores[stream].getMessage() != uplink)
+		{
+			MyLog::log("WMB", "...uplink %lu of stream %d too large for the data rate, not kept to be planned again", (unsigned long) uplink, stream);
+
+			continue;
+		}
+
+		MyLog::log("WMB", "...uplink %lu of stream %d too large for the data rate, planned again", (unsigned long) uplink, stream);
+
+		SmUplinkStore const& store = m_uplinkStores[stream];
+
+		bool sent = sendFrames(stream, store.getData(), store.getRecordEnds(), store.getRecordCount());
+
+		if(stream < SM_MAX_METERS && m_deltaUplink[stream] == uplink)
+		{
+			m_deltaUplink[stream] = sent ? m_sentUplink : 0;
+		}
+	}
+}
+
+/**
+ * @brief Plans the frames or fragments of an uplink.
+ *
+ * @param recordEnds The end offset of each record, the last one is the size of the uplink.
+ * @param recordCount The number of records.
+ * @param maxPayloadSize The maximum payload of a frame.
+ * @return true if the frames were planned, false if the uplink does not fit.
+ */
+bool Wmb::planFrames(uint16_t const* recordEnds, uint8_t const recordCount, size_t const maxPayloadSize)
+{
+	if(!m_fragmenter.plan(recordEnds, recordCount, maxPayloadSize))
+	{
+		MyLog::log("WMB", "...no frames planned with a payload of %d bytes", maxPayloadSize);
+
+		return false;
+	}
+
+	SmFramePlan const& plan = m_fragmenter.getPlan();
+
+	MyLog::log("WMB", "...%d frame(s) with a payload of %d bytes%s", plan.getFrameCount(), maxPayloadSize, plan.hasSplitRecord() ? ", record split" : "");
+
+	return true;
+}
+
+/**
+ * @brief Switches off the M-BUS adapter.
+ */
+void Wmb::mbusAdapterOff()
+{
+    MyLog::log("WMB", "...enable M-BUS adapter");
+
+	pinMode(WB_IO2, OUTPUT);
+	digitalWrite(WB_IO2, LOW);
+}
+
+/**
+ * @brief Switches on the M-BUS adapter.
+ */
+void Wmb::mbusAdapterOn()
+{
+    MyLog::log("WMB", "...enable M-BUS adapter");
+
+	pinMode(WB_IO2, OUTPUT);
+	digitalWrite(WB_IO2, HIGH);
+}
+
+/**
+ * @brief Handles the GBT frame received from the smart meter.
+ * 
+ * This function stores the GBT frame in the slot of the meter which has sent it, the frame is decoded
+ * when the data is sent.
+ * 
+ * @param data Pointer to the GBT frame data.
+ * @param size The size of the GBT frame data.
+ */
+void Wmb::gbtFrameHandler(uint8_t const* data, size_t const size) 
+{
+	MyLog::log("WMB", "GBT frame received");
+
+	// the frame replaces the stored one of its meter (or is parsed by the detection)
+	m_gbtDataMeter = SM_NO_METER;
+
+	if(m_detecting && m_autoDetect.pushReceived(m_gbtData, data, size))
+	{
+		MyLog::log("WMB", "GBT frame matches profile %d", m_autoDetect.getProfileId());
+	}
+
+	if(!m_meterBus.gbtFrameReceived(data, size))
+	{
+		MyLog::log("WMB", "GBT frame could not be stored, frame dropped");
+	}
+}
+
+/**
+ * @brief Parses the GBT frame of a meter into m_gbtData.
+ *
+ * The frame is parsed once per push, the push schedule and the uplink use the same values. Unknown identifiers
+ * are skipped (as by decodeFrame), only a malformed frame or a value which could not be stored rejects the push.
+ * A filtered parse skips the registers filtered out by the register filter of the meter, it serves the uplinks
+ * which extract the push. The derived, dictionary and fixed uplinks take all values and need the complete parse,
+ * a filtered frame is parsed again for them.
+ *
+ * @param meter The index of the meter.
+ * @param filtered true if the registers filtered out may be skipped, false for all values.
+ * @return true if the frame was parsed, false if it is malformed or its values are incomplete.
+ */
+bool Wmb::parseFrame(uint8_t const meter, bool const filtered)
+{
+	if(m_gbtDataMeter == meter && (filtered || !m_gbtDataFiltered))
+	{
+		return true;
+	}
+
+	SmMeterSlot const& slot = m_meterBus.getSlot(meter);
+
+	// parse resets the values of the previous frame
+	int result = filtered
+		? m_smartmeters[meter].parse(m_gbtData, slot.getFrame(), slot.getFrameSize())
+		: m_gbtData.parse(slot.getFrame(), slot.getFrameSize());
+
+	if(result == GbtParser::GBTPARSE_MALFORMED || result == GbtDataBase::GBTPARSE_VALUEDROPPED)
+	{
+		MyLog::log("WMB", "...GBT frame of meter %d rejected (%d)", meter, result);
+
+		m_gbtDataMeter = SM_NO_METER;
+
+		return false;
+	}
+
+	if(result > 0)
+	{
+		MyLog::log("WMB", "...GBT frame of meter %d with %d unknown identifiers", meter, result);
+	}
+
+	m_gbtDataMeter = meter;
+	m_gbtDataFiltered = filtered;
+
+	return true;
+}
+
+/**
+ * @brief Decodes the GBT frame of a meter into the cayenne buffer.
+ *
+ * @param meter The index of the meter.
+ * @return true if the frame was copied into cayenne without error, false otherwise.
+ */
+bool Wmb::decodeFrame(uint8_t const meter)
+{
+	SmMeterSlot const& slot = m_meterBus.getSlot(meter);
+
+	SmMeter& smartmeter = m_smartmeters[meter];
+
+	MyLog::log("WMB", "GBT frame of meter %d parse data", meter);
+
+	m_smCayenne.reset();
+
+	// a malformed push or one with values which could not be stored is not sent in part
+	if(!parseFrame(meter, true))
+	{
+		MyLog::log("WMB", "GBT frame parse failed");	
+
+		return false;
+	}
+
+	MyLog::log("WMB", "GBT frame parse %d block of data successfull", slot.getFrameSize());
+
+	MyLog::log("WMB", "GBT extract into cayenne");
+
+	// device name, date and time and the values in one pass
+	smartmeter.extract(m_gbtData, m_smCayenne, m_appConfig.sendDataType == AppConfig::SM_SENDDATATYPE_GBTSCALED || m_appConfig.sendDataType == AppConfig::SM_SENDDATATYPE_DERIVED);
+
+	if(m_smCayenne.getError() != LPP_ERROR_OK)
+	{
+		MyLog::log("WMB", "GBT copy into cayenne failed");
+
+		return false;
+	}
+
+	MyLog::log("WMB", "GBT copy into cayenne sucessfull");
+
+	return true;
+}
+
+/**
+ * @brief Keeps the values of a meter which fit into one frame of the current data rate in the priority of their
+ * registers, the others are removed from the cayenne buffer and deferred (see SmPriorityPlan).
+ *
+ * The time stamp, the events and the adapter states are always kept, the values get the rest of the frame. The
+ * kept values keep their LPP index, the server knows which registers were deferred. A deferred register gains
+ * priority with each uplink it is deferred and rotates into a later uplink.
+ *
+ * @param meter The index of the meter, its values are the records after the time stamp.
+ */
+void Wmb::truncateByPriority(uint8_t const meter)
+{
+	SmMeter const& smartmeter = m_smartmeters[meter];
+
+	uint8_t valueCount = smartmeter.getRecordCount();
+	uint16_t const* recordEnds = m_smCayenne.getRecordEnds();
+
+	if(m_smCayenne.getError() != LPP_ERROR_OK || valueCount == 0 || valueCount >= m_smCayenne.getRecordCount())
+	{
+		return;
+	}
+
+	// the values are the records 1..valueCount, record 0 is the time stamp
+	uint16_t recordSizes[SmPushLayout::MAX_PUSHVALUES];
+	size_t valueSize = 0;
+
+	for(uint8_t i = 0; i < valueCount; i++)
+	{
+		recordSizes[i] = recordEnds[i + 1] - recordEnds[i];
+		valueSize += recordSizes[i];
+	}
+
+	// a push which fits keeps all values, the plan forgets their deferrals
+	size_t maxPayloadSize = m_wbMcu.getMaxPayloadSize();
+	size_t otherSize = m_smCayenne.getSize() - valueSize;
+	size_t budget = maxPayloadSize > otherSize ? maxPayloadSize - otherSize : 0;
+
+	uint32_t kept = m_priorityPlans[meter].plan(smartmeter.getLayout(), smartmeter.getRecordValues(), recordSizes, valueCount, budget);
+
+	if(m_priorityPlans[meter].getDeferred() == 0)
+	{
+		return;
+	}
+
+	m_smCayenne.removeRecords(1, valueCount, kept);
+
+	MyLog::log("WMB", "...meter %d sent %d bytes in one frame, deferred values %08lx", meter, m_smCayenne.getSize(), (unsigned long) m_priorityPlans[meter].getDeferred());
+}
+
+/**
+ * @brief Checks if the pushes of the aggregation window are sent as statistics.
+ *
+ * The raw GBT block is always sent as is, it is not aggregated.
+ *
+ * @return true if an aggregation window is configured, false for one push per read cycle.
+ */
+bool Wmb::isAggregating() const
+{
+	return m_appConfig.aggregationWindow > 0 && !isRawUplink();
+}
+
+/**
+ * @brief Checks if the GBT block is sent as is (raw or compressed) instead of cayenne.
+ *
+ * @return true for the raw or compressed GBT block, false for the cayenne uplinks.
+ */
+bool Wmb::isRawUplink() const
+{
+	return m_appConfig.sendDataType == AppConfig::SM_SENDDATATYPE_GBTLASTBLOCK || m_appConfig.sendDataType == AppConfig::SM_SENDDATATYPE_GBTCOMPRESSED;
+}
+
+/**
+ * @brief Sends the last GBT block of a meter, compressed against the dictionary of the profile if configured.
+ *
+ * The block has no records, it is split into frames of the maximum payload. A profile without dictionary sends
+ * the block as is.
+ *
+ * @param meter The index of the meter.
+ * @return true if all frames were enqueued, false otherwise.
+ */
+bool Wmb::sendGbtBlock(uint8_t const meter)
+{
+	SmMeterSlot const& slot = m_meterBus.getSlot(meter);
+
+	uint8_t const* block = slot.getFrame();
+	size_t blockSize = slot.getFrameSize();
+
+	if(m_appConfig.sendDataType == AppConfig::SM_SENDDATATYPE_GBTCOMPRESSED)
+	{
+		size_t compressedSize = m_gbtCompressor.compress(block, blockSize);
+
+		if(compressedSize > 0)
+		{
+			MyLog::log("WMB", "...GBT block of meter %d compressed from %d to %d bytes", meter, blockSize, compressedSize);
+
+			block = m_gbtCompressor.getOutput();
+			blockSize = compressedSize;
+		}
+	}
+
+	MyLog::log("WMB", "...send last GBT block of meter %d via WAN", meter);
+
+	uint16_t const frameEnd = static_cast<uint16_t>(blockSize);
+
+	return sendFrames(meter, block, &frameEnd, 1);
+}
+
+/**
+ * @brief Folds the pushes of the aggregation window into the statistics of each meter.
+ *
+ * The adapter keeps listening after the read cycle, each push is extracted (scaled) into the aggregator of its
+ * meter as soon as it is stored and is then dropped. The window is limited to half the measure interval.
+ */
+void Wmb::aggregateWindow()
+{
+	uint32_t window = m_appConfig.aggregationWindow;
+
+	if(window > m_appConfig.measureInterval / 2)
+	{
+		window = m_appConfig.measureInterval / 2;
+	}
+
+	MyLog::log("WMB", "...aggregate the pushes for %lu ms", (unsigned long) window);
+
+	uint16_t folded[SM_MAX_METERS];
+
+	for(uint8_t i = 0; i < SM_MAX_METERS; i++)
+	{
+		m_aggregators[i].reset();
+
+		folded[i] = 0;
+	}
+
+	// the pushes of the read cycle
+	foldPushes(folded);
+
+	uint8_t chunk[SM_READ_CHUNK_SIZE];
+
+	time_t windowStartTime = millis();
+
+	while(millis() - windowStartTime < window)
+	{
+		size_t received = m_smartmeters[0].readInto(chunk, sizeof(chunk), SM_READ_TIMEOUT);
+
+		m_wbMcu.setActivityLed(received > 0);
+
+		m_hdlc.bytesReceiver(chunk, received);
+
+		foldPushes(folded);
+	}
+
+	m_wbMcu.setActivityLed(false);
+
+	for(uint8_t i = 0; i < m_meterBus.getMeterCount(); i++)
+	{
+		MyLog::log("WMB", "...meter %d aggregated %d pushes", i, m_aggregators[i].getPushCount());
+	}
+}
+
+/**
+ * @brief Folds the new push of each meter into its statistics.
+ *
+ * A push is new if the frame count of the slot has changed since the last fold. The pushes of the meter are
+ * seconds apart, at most one push of a meter is stored between two folds.
+ *
+ * @param folded The frame count of each slot at the last fold, updated.
+ */
+void Wmb::foldPushes(uint16_t (&folded)[SM_MAX_METERS])
+{
+	for(uint8_t i = 0; i < m_meterBus.getMeterCount(); i++)
+	{
+		SmMeterSlot const& slot = m_meterBus.getSlot(i);
+
+		if(slot.getFrameCount() == folded[i])
+		{
+			continue;
+		}
+
+		folded[i] = slot.getFrameCount();
+
+		if(parseFrame(i, true))
+		{
+			m_smartmeters[i].extract(m_gbtData, m_aggregators[i], true);
+		}
+		else
+		{
+			MyLog::log("WMB", "...push of meter %d not parsed, not aggregated", i);
+		}
+	}
+}
+
+/**
+ * @brief Encodes the statistics of the aggregation window of a meter into the cayenne buffer.
+ *
+ * The uplink holds the time stamp of the last push, the window and the statistics of each numeric register.
+ *
+ * @param meter The index of the meter.
+ * @return true if the statistics were encoded without error, false otherwise.
+ */
+bool Wmb::encodeAggregate(uint8_t const meter)
+{
+	SmAggregator const& aggregator = m_aggregators[meter];
+
+	uint8_t channel = m_smartmeters[meter].getChannel();
+
+	MyLog::log("WMB", "Encode the statistics of %d pushes of meter %d into cayenne", aggregator.getPushCount(), meter);
+
+	m_smCayenne.reset();
+
+	m_smCayenne.addUnixTime(channel, aggregator.getLastTime());
+	m_smCayenne.addAggregationWindow(channel, aggregator.getFirstTime(), aggregator.getLastTime(), aggregator.getPushCount());
+
+	for(uint8_t i = 0; i < aggregator.getCount(); i++)
+	{
+		m_smCayenne.addAggregate(aggregator.getAt(i));
+	}
+
+	if(m_smCayenne.getError() != LPP_ERROR_OK)
+	{
+		MyLog::log("WMB", "Statistics into cayenne failed");
+
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Encodes the values derived from the energy counters of a meter into the cayenne buffer.
+ *
+ * The values are derived against the push of the last uplink: the consumption and the average power of each
+ * counter and the balance of the active energy. The first push has no reference and is sent in full (scaled),
+ * the server keeps its counters as the base of the following deltas.
+ *
+ * @param meter The index of the meter.
+ * @return true if the values were encoded without error, false otherwise.
  */
-bool Wmb::initApp()
+bool Wmb::encodeDerived(uint8_t const meter)
 {
-    mbusAdapterOff();
+	SmDerived& derived = m_derived[meter];
 
-	MyLog::log("WMB", "Load application config");
+	SmMeter& smartmeter = m_smartmeters[meter];
 
-	m_wbMcu.loadConfiguration(m_appConfig);
+	if(!parseFrame(meter, false) || !smartmeter.derive(m_gbtData, derived))
+	{
+		MyLog::log("WMB", "...no values derived for meter %d, send the full push", meter);
 
-	MyLog::log("APPSETTINGS", "...measureInterval: %d", m_appConfig.measureInterval);
-    MyLog::log("APPSETTINGS", "...sendDataType: %d", m_appConfig.sendDataType);
-    MyLog::log("APPSETTINGS", "...decryptData: %d", m_appConfig.decryptData);
-    MyLog::log("APPSETTINGS", "...smCycleTimeout: %d", m_appConfig.smCycleTimeout);
+		return decodeFrame(meter);
+	}
 
-	if(m_appConfig.decryptData)
+	uint8_t channel = smartmeter.getChannel();
+
+	m_smCayenne.reset();
+
+	m_smCayenne.addUnixTime(channel, m_gbtData.getDateTime().asUnixTimeStamp());
+	m_smCayenne.addDerivedInterval(channel, derived.getInterval());
+
+	for(uint8_t i = 0; i < derived.getCount(); i++)
 	{
-		MyLog::log("APPSETTINGS", "...sizeof aes_iv: %d", sizeof(m_appConfig.aes_iv));
-		MyLog::log("APPSETTINGS", "...sizeof aes_key: %d", sizeof(m_appConfig.aes_key));
-		MyLog::log("APPSETTINGS", "...sizeof authenticationKey: %d", sizeof(m_appConfig.authenticationKey));
+		m_smCayenne.addDerived(derived.getAt(i));
 	}
 
-	MyLog::log("WMB", "...reading global values for WisBlock timer");
+	if(derived.hasBalance())
+	{
+		m_smCayenne.addBalance(channel, derived.getBalance());
+	}
 
-	g_appTimer = m_appConfig.measureInterval;
+	if(m_smCayenne.getError() != LPP_ERROR_OK)
+	{
+		MyLog::log("WMB", "Derived values into cayenne failed");
 
-    m_wbMcu.initApp();
+		return false;
+	}
 
-    return true;
+	return true;
 }
 
 /**
- * @brief Reads and sends data from the smart meter.
- * 
- * This function reads and sends data from the smart meter.
+ * @brief Encodes the push of a meter as delta frame into cayenne.
+ *
+ * The frame carries the changed values against the last frame acknowledged by the network (see
+ * SmDeltaEncoder). The last frame is acknowledged once all frames of its uplink are acknowledged (see
+ * WbMcuBase::isUplinkDelivered), a frame without acknowledgement is not used as reference.
+ *
+ * @param meter The index of the meter.
+ * @return true if the frame was encoded into cayenne, false if the push could not be parsed or does not fit.
  */
-void Wmb::smReadSendcycle()
+bool Wmb::encodeDelta(uint8_t const meter)
 {
-	MyLog::log("WMB", "Execute Smartmeter read and send cycle");
-
-	time_t readSendCycleTimeStart = millis();
-
-	smReadcycle();
+	SmDeltaEncoder& encoder = m_deltaEncoders[meter];
 
-	// adds the adapter states into the cayenne buffer
-	wmbadaper_addStates(m_smCayenne);
+	SmMeter& smartmeter = m_smartmeters[meter];
 
-	if(!m_wbMcu.isWlanConnected())
+	if(m_deltaUplink[meter] != 0 && m_wbMcu.isUplinkDelivered(meter, m_deltaUplink[meter]))
 	{
-		MyLog::log("WMB", "WLAN not connected, skip sending");
-
-		return;
+		encoder.acknowledged();
 	}
 
-	// application setting how to send the data via WAN
-	uint8_t sendDataType = m_appConfig.sendDataType;
-
-	// default way via Cayenne LPP (decoded)
-	if(sendDataType == AppConfig::SM_SENDDATATYPE_GBTPARSED)
-	{
-		uint8_t gbtSize = m_smCayenne.getSize();
+	m_deltaUplink[meter] = 0;
 
-		if(gbtSize > 0)
-		{
-			MyLog::log("WMB", "...send %d bytes via WAN", gbtSize);
+	m_smCayenne.reset();
 
-			uint8_t cayenneError = m_smCayenne.getError();
+	if(!parseFrame(meter, true) || !smartmeter.extract(m_gbtData, encoder, true))
+	{
+		MyLog::log("WMB", "...push of meter %d not extracted, no delta frame", meter);
 
-			if(cayenneError == 0)
-			{
-				m_wbMcu.enqueueDataPacket(m_smCayenne.getBuffer(), gbtSize, 0);
-			}
-			else	
-			{
-				MyLog::log("WMB", "...send GBT packed aborted with Cayenne LPP error %d", cayenneError);
-			}
-		}
-		else
-		{
-			MyLog::log("WMB", "...no GBT packet to send (size 0)");
-		}
+		return false;
 	}
-	// raw way, send the GBT block as is, decoding has to be done on the server side
-	else if(sendDataType == AppConfig::SM_SENDDATATYPE_GBTLASTBLOCK)
+
+	if(m_smCayenne.addDeltaFrame(smartmeter.getChannel(), encoder) == 0)
 	{
-		MyLog::log("WMB", "...send full last GBT block via WAN");
+		MyLog::log("WMB", "Delta frame into cayenne failed");
 
-		m_wbMcu.enqueueDataPacket(m_lastGbtFrameReceived, m_lastGbtFrameReceivedSize, 0);
+		return false;
 	}
 
-	time_t readSendCycleTimeRun = millis() - readSendCycleTimeStart;
-
-	MyLog::log("WMB", "SM read and send cycle completed in %ld ms", readSendCycleTimeRun);
+	MyLog::log("WMB", "Delta frame %d of meter %d into cayenne", encoder.getSequence(), meter);
 
-    m_wbMcu.resetWatchDog();
+	return true;
 }
 
 /**
- * @brief Switches off the M-BUS adapter.
+ * @brief Encodes the values of the push of a meter in the order of its dictionary into cayenne.
+ *
+ * The values carry the hash of the dictionary instead of the register descriptions (see SmDictionarySession).
+ * The dictionary is added in front of the values if it was not sent yet, if it changed or if the server
+ * requested it.
+ *
+ * @param meter The index of the meter.
+ * @param dictionaryAdded Set to true if the dictionary was added, it is sent once the uplink is enqueued.
+ * @return true if the values were encoded into cayenne, false if the push could not be parsed or does not fit.
  */
-void Wmb::mbusAdapterOff()
+bool Wmb::encodeDictionary(uint8_t const meter, bool& dictionaryAdded)
 {
-    MyLog::log("WMB", "...enable M-BUS adapter");
+	SmDictionarySession& session = m_dictionarySessions[meter];
 
-	pinMode(WB_IO2, OUTPUT);
-	digitalWrite(WB_IO2, LOW);
-}
+	SmMeter& smartmeter = m_smartmeters[meter];
 
-/**
- * @brief Switches on the M-BUS adapter.
- */
-void Wmb::mbusAdapterOn()
-{
-    MyLog::log("WMB", "...enable M-BUS adapter");
+	uint8_t channel = smartmeter.getChannel();
 
-	pinMode(WB_IO2, OUTPUT);
-	digitalWrite(WB_IO2, HIGH);
+	m_smCayenne.reset();
+
+	if(!parseFrame(meter, false) || !smartmeter.updateLayout(m_gbtData) || !session.update(m_gbtData, smartmeter.getLayout()))
+	{
+		MyLog::log("WMB", "...push of meter %d not taken, no dictionary values", meter);
+
+		return false;
+	}
+
+	if(session.isDictionaryDue())
+	{
+		MyLog::log("WMB", "Dictionary %08lx of meter %d into cayenne", (unsigned long) session.getHash(), meter);
+
+		m_smCayenne.addDictionary(channel, session);
+
+		dictionaryAdded = true;
+	}
+
+	m_smCayenne.addDictionaryValues(channel, session);
+
+	if(m_smCayenne.getError() != LPP_ERROR_OK)
+	{
+		MyLog::log("WMB", "Dictionary values into cayenne failed");
+
+		dictionaryAdded = false;
+
+		return false;
+	}
+
+	return true;
 }
 
 /**
- * @brief Handles the GBT frame received from the smart meter.
- * 
- * This function handles the GBT frame received from the smart meter.
- * 
- * @param data Pointer to the GBT frame data.
- * @param size The size of the GBT frame data.
+ * @brief Encodes the values of the push of a meter in the fixed layout of the profile into cayenne.
+ *
+ * The offsets of the fields are known from the profile (see SmFixedLayout), the payload has no headers. A profile
+ * without fixed layout sends the full push.
+ *
+ * @param meter The index of the meter.
+ * @return true if the payload was encoded into cayenne, false if the push could not be parsed or does not fit.
  */
-void Wmb::gbtFrameHandler(uint8_t const* data, size_t const size) 
+bool Wmb::encodeFixed(uint8_t const meter)
 {
-	// store the last gbt frame received
-	if(size > SM_GBT_MAXFRAMESIZE)
-	{
-		MyLog::log("WMB", "GBT frame received with %d bytes, max size is %d, frame dropped", size, SM_GBT_MAXFRAMESIZE);
+	SmMeter& smartmeter = m_smartmeters[meter];
 
-		return;
+	if(m_fixedEncoder.getLayout() == nullptr)
+	{
+		return decodeFrame(meter);
 	}
 
-	// save the last received gbt frame
-	memcpy(m_lastGbtFrameReceived, data, size);
-
-	m_lastGbtFrameReceivedSize = size;
+	m_smCayenne.reset();
 
-	MyLog::log("WMB", "GBT frame received");
-
-    GbtData gbtData;
+	if(!parseFrame(meter, false) || !smartmeter.updateLayout(m_gbtData) || !m_fixedEncoder.update(m_gbtData, smartmeter.getLayout()))
+	{
+		MyLog::log("WMB", "...push of meter %d not taken, no fixed payload", meter);
 
-	MyLog::log("WMB", "GBT frame parse data");
+		return false;
+	}
 
-    if(gbtData.parse(data, size) == 0)
+	if(m_smCayenne.addFixedLayout(smartmeter.getChannel(), m_fixedEncoder) == 0)
 	{
-		MyLog::log("WMB", "GBT frame parse %d block of data successfull", size);
+		MyLog::log("WMB", "Fixed payload into cayenne failed");
+
+		return false;
 	}
-	else
-    {
-		MyLog::log("WMB", "GBT frame parse failed");	
-    }
 
-	MyLog::log("WMB", "GBT allow process smartmeter specifics   cayenne");
+	MyLog::log("WMB", "Fixed payload of meter %d into cayenne, present flags %08lx", meter, (unsigned long) m_fixedEncoder.getPresentFlags());
 
-	// additional and specific smart meter data to be parsed 
-	m_smartmeter.parse(gbtData);
+	return true;
+}
 
-	MyLog::log("WMB", "GBT copy block into cayenne");
+/**
+ * @brief Checks the last push of a meter against the event rules.
+ *
+ * The push is extracted (scaled) into the rules of the meter, the rules are taken from the configuration
+ * every cycle so a downlink applies without restart.
+ *
+ * @param meter The index of the meter.
+ * @return true if the push has an event or the heartbeat is due, or if it can not be parsed.
+ */
+bool Wmb::isUplinkDue(uint8_t const meter)
+{
+	SmEventRules& rules = m_eventRules[meter];
 
-	m_smartmeter.copyData(gbtData, m_smCayenne);
+	rules.configure(m_appConfig.eventPowerThreshold, m_appConfig.eventEnergyDelta, m_appConfig.eventStatusChange, m_appConfig.eventHeartbeat);
 
-	if(m_smCayenne.getError() == LPP_ERROR_OK)
+	if(!parseFrame(meter, true))
 	{
-		MyLog::log("WMB", "GBT copy into cayenne sucessfull");
+		return true;
 	}
-	else
-	{
-		MyLog::log("WMB", "GBT copy into cayenne failed");
-	}	
+
+	m_smartmeters[meter].extract(m_gbtData, rules, true);
+
+	MyLog::log("WMB", "...events of meter %d: 0x%02x", meter, rules.getEvents());
+
+	return rules.isUplinkDue();
 }
 
 /**
  * @brief Handles the HDLC frame received from the smart meter.
  * 
- * This function handles the HDLC frame received from the smart meter.
+ * This function forwards the HDLC frame to the bus, which adds it to the receive state of the meter with
+ * the source address of the frame.
  * 
  * @param data Pointer to the HDLC frame data.
  * @param size The size of the HDLC frame data.
@@ -258,29 +1117,22 @@ void Wmb::hdlcFrameHandler(const uint8_t *data, size_t const size, bool const va
 	if(!valid)
 	{
 		MyLog::logHex("WMB", "Invalid frame content received with: ", data, size);
-
-		MyLog::log("WMB", "Reset dlsm receive buffer");
-
-		m_dlms.reset();
-
-		return;
 	}
+	else
+	{
+		MyLog::log("WMB", "Valid frame received with %d bytes", size);
 
-	MyLog::log("WMB", "Valid frame received with %d bytes", size);
-
-	MyLog::logHex("WMB", "Frame content: ", data, size);
-
-	// remove the m_hdlc header and footer
-    uint8_t hdlcData[size];
-    size_t hdlcDataSize = size - 8;
-
-    memcpy(hdlcData, data + 8, hdlcDataSize);
+		MyLog::logHex("WMB", "Frame content: ", data, size);
+	}
 
-    GbtBlock const* addedBlock;
+	if(m_detecting)
+	{
+		m_autoDetect.hdlcFrameReceived(data, size, valid);
+	}
 
 	MyLog::log("WMB", "Parse HDLC frame content");
 
-    if(m_dlms.hdlcDataReceived(hdlcData, hdlcDataSize, addedBlock))
+    if(m_meterBus.hdlcFrameReceived(data, size, valid))
     {
 		MyLog::log("WMB", "Frame content detected as GBT, add GBT frame block");
     }
@@ -301,78 +1153,103 @@ void Wmb::smReadcycle()
 
 	MyLog::log("WMB", "Start read cycle %u", m_sm_readLoops);
 
+	m_pushScheduler.cycleStarted(millis());
+
 	MyLog::log("WMB", "...turn on wired m-bus adapter");
 
 	// turn the m-bus slave card on
 	mbusAdapterOn();
 
 	// some time to warm-up and signal that something is going on
-    m_wbMcu.delayWithLed(500);
+    m_wbMcu.delayWithLed(SM_WARMUP_TIME);
 
 	MyLog::log("WMB", "...wired m-bus adapter enabled");
 	MyLog::log("WMB", "...open serial port for smartmeter reading");
 
-	m_smartmeter.openSerialPort();
+	// the meters share the bus and the serial settings
+	m_smartmeters[0].openSerialPort();
 
 	// some time to warm-up and signal that something is going on
-	m_wbMcu.delayWithLed(500);
+	m_wbMcu.delayWithLed(SM_WARMUP_TIME);
 
 	MyLog::log("WMB", "...serial port opened");
 
-	MyLog::log("WMB", "...reset the m_hdlc protocol handler");
+	MyLog::log("WMB", "...reset the receive state of the meters");
+
+	// reset the dlms receive buffer of each meter
+	m_meterBus.reset();
+
+	m_gbtDataMeter = SM_NO_METER;
 
-	// reset the m_dlms receive buffer
-	m_dlms.reset();
+	MyLog::log("WMB", "...receive state of the meters reset");
 
-	MyLog::log("WMB", "...m_hdlc protocol handler reset");
+	uint32_t receiveWindow = m_appConfig.smCycleTimeout;
 
-	MyLog::log("WMB", "...set the receive cycle with timeout %u", m_appConfig.smCycleTimeout);
+	// the first meter is only waited for during the receive window around its predicted push
+	if(m_appConfig.pushSchedule)
+	{
+		receiveWindow = m_pushScheduler.getReceiveWindow();
 
-	time_t cycleTimeOut = m_appConfig.smCycleTimeout;
+		m_meterBus.configure(0, m_appConfig.meterAddress[0], receiveWindow);
+	}
 
-	MyLog::log("WMB", "...start the receive cycle with timeout %u", cycleTimeOut);
+	MyLog::log("WMB", "...start the receive cycle for %d meter(s) with timeout %u", m_meterBus.getMeterCount(), receiveWindow);
 
 	time_t readCycleStartTime = millis();
 
-	// start the receive cycle for the smart meter data
-	while(!m_dlms.gbtFrameReceived())
+	bool pushReceived = false;
+	uint32_t pushArrival = 0;
+
+	// start the receive cycle for the smart meter data, till each meter has pushed or timed out
+	uint8_t chunk[SM_READ_CHUNK_SIZE];
+
+	while(!m_meterBus.isCycleComplete(millis() - readCycleStartTime))
 	{
-		if((millis() - readCycleStartTime) > cycleTimeOut)
-		{
-			MyLog::log("WMB", "...read cycle timeout of %d reached, breaking read cycle", cycleTimeOut);
+		// read the bytes received from the smart meter
+		size_t received = m_smartmeters[0].readInto(chunk, sizeof(chunk), SM_READ_TIMEOUT);
 
-			break;
-		}
+		m_wbMcu.setActivityLed(received > 0);
 
-		if(m_smartmeter.available() > 0)
+		if(received == 0)
 		{
-			// read the next byte from the smart meter
-			int number = m_smartmeter.read();
-
-			if(number >=0)
-			{
-				int newState = !digitalRead(LED_BUILTIN);   
+			continue;
+		}
 
-				digitalWrite(LED_BUILTIN, newState);
+		// enqueue the chunk into the m_hdlc protocol handler
+		m_hdlc.bytesReceiver(chunk, received);
 
-				// enqueue the byte into the m_hdlc protocol handler
-				m_hdlc.charReceiver((uint8_t) number);
-			}
-		}
-		else
+		if(!pushReceived && m_meterBus.getSlot(0).isFrameReceived())
 		{
-			digitalWrite(LED_BUILTIN, LOW);
+			pushReceived = true;
+			pushArrival = millis();
+		}
+	}
+
+	m_wbMcu.setActivityLed(false);
 
-			delay(100);
+	for(uint8_t i = 0; i < m_meterBus.getMeterCount(); i++)
+	{
+		if(!m_meterBus.getSlot(i).isFrameReceived())
+		{
+			MyLog::log("WMB", "...read cycle timeout reached for meter %d", i);
 		}
 	}
 
+	if(m_appConfig.pushSchedule)
+	{
+		pushCompleted(pushReceived, pushArrival);
+	}
+
+	if(isAggregating())
+	{
+		aggregateWindow();
+	}
 
 	MyLog::log("WMB", "...read cycle completed");
 
 	MyLog::log("WMB", "...close serial port");
 
-	m_smartmeter.closeSerialPort();
+	m_smartmeters[0].closeSerialPort();
 
 	MyLog::log("WMB", "...serial port closed");
 
@@ -380,13 +1257,146 @@ void Wmb::smReadcycle()
 
 	mbusAdapterOff();
 
-	m_wbMcu.delayWithLed(500);
+	m_wbMcu.delayWithLed(SM_WARMUP_TIME);
 
 	MyLog::log("WMB", "...wired m-bus adapter disabled");
 
+	m_pushScheduler.cycleEnded(millis());
+
+	if(m_appConfig.pushSchedule)
+	{
+		scheduleNextCycle();
+	}
+
 	MyLog::log("WMB", "Read cycle completed");
 }
 
+/**
+ * @brief Detects the serial settings and the profile of the meters.
+ *
+ * The serial settings are tried one after the other till a push matches a profile. The detected settings and
+ * the profile are persisted, the following read cycles (and boots) use them.
+ *
+ * @return true if the meter is detected, false otherwise (the next cycle detects again).
+ */
+bool Wmb::smDetectcycle()
+{
+	MyLog::log("WMB", "Start detect cycle");
+
+	mbusAdapterOn();
+
+	m_wbMcu.delayWithLed(SM_WARMUP_TIME);
+
+	m_autoDetect.start();
+
+	m_detecting = true;
+
+	do
+	{
+		detectWithSetting(m_autoDetect.getSetting());
+
+		// each serial setting may take a read cycle timeout
+		m_wbMcu.resetWatchDog();
+	}
+	while(!m_autoDetect.isDetected() && m_autoDetect.nextSetting());
+
+	m_detecting = false;
+
+	mbusAdapterOff();
+
+	if(!m_autoDetect.isDetected())
+	{
+		MyLog::log("WMB", "Detect cycle completed, no meter detected");
+
+		return false;
+	}
+
+	SmSerialSetting const& setting = m_autoDetect.getSetting();
+
+	MyLog::log("WMB", "Detect cycle completed, profile %d with %lu baud, format %d", m_autoDetect.getProfileId(), (unsigned long) setting.baudRate, (int) setting.serialFormat);
+
+	m_appConfig.meterProfile = m_autoDetect.getProfileId();
+	m_appConfig.serialBaudRate = setting.baudRate;
+	m_appConfig.serialFormat = (uint8_t) setting.serialFormat;
+
+	save_appConfig(m_appConfig);
+
+	initMeters();
+
+	return true;
+}
+
+/**
+ * @brief Receives with one serial setting till the meter is detected, the setting is rejected or the read cycle
+ * timeout is reached.
+ *
+ * @param setting The serial setting.
+ */
+void Wmb::detectWithSetting(SmSerialSetting const& setting)
+{
+	MyLog::log("WMB", "...try %lu baud, format %d", (unsigned long) setting.baudRate, (int) setting.serialFormat);
+
+	m_smartmeters[0].selectSerialSetting(setting.baudRate, setting.serialFormat);
+	m_smartmeters[0].openSerialPort();
+
+	m_wbMcu.delayWithLed(SM_WARMUP_TIME);
+
+	m_meterBus.reset();
+
+	time_t detectStartTime = millis();
+
+	uint8_t chunk[SM_READ_CHUNK_SIZE];
+
+	while(!m_autoDetect.isDetected() && !m_autoDetect.isRejected() && millis() - detectStartTime < m_appConfig.smCycleTimeout)
+	{
+		size_t received = m_smartmeters[0].readInto(chunk, sizeof(chunk), SM_READ_TIMEOUT);
+
+		m_hdlc.bytesReceiver(chunk, received);
+	}
+
+	m_smartmeters[0].closeSerialPort();
+}
+
+/**
+ * @brief Learns the push period and phase from the push of the first meter.
+ *
+ * The frame is parsed for the time stamp of the meter, the uplink uses the parsed values.
+ *
+ * @param received true if the first meter has pushed in this read cycle.
+ * @param arrival The local time (millis) the push was completed.
+ */
+void Wmb::pushCompleted(bool const received, uint32_t const arrival)
+{
+	if(!received)
+	{
+		m_pushScheduler.pushMissed();
+
+		return;
+	}
+
+	uint32_t meterTime = 0;
+
+	if(parseFrame(0, true))
+	{
+		meterTime = (uint32_t) m_gbtData.getDateTime().asUnixTimeStamp();
+	}
+
+	m_pushScheduler.pushReceived(arrival, meterTime);
+}
+
+/**
+ * @brief Sets the wake-up for the next read cycle, just before the predicted push of the first meter.
+ */
+void Wmb::scheduleNextCycle()
+{
+	uint32_t wakeUpDelay = m_pushScheduler.scheduleNextWake(millis());
+
+	MyLog::log("WMB", "...adapter on for %lu ms, next expected %lu ms, saved %lu s in total", (unsigned long) m_pushScheduler.getLastOnTime(), 
+		(unsigned long) m_pushScheduler.getExpectedOnTime(), (unsigned long) m_pushScheduler.getSavedOnTime());
+
+	m_wbMcu.setWakeUpTimer(wakeUpDelay);
+}
+
 /**
  * @brief Saves the application configuration.
  * 
@@ -421,7 +1431,7 @@ void Wmb::wmbadaper_battery(SmCayenne& cayenne)
 
 	MyLog::log("WMB", "..add battery voltage %d", battstate);
 
-	cayenne.addBatteryVoltage(m_smartmeter.getChannel(), battstate);
+	cayenne.addBatteryVoltage(m_smartmeters[0].getChannel(), battstate);
 }
 
 /**
@@ -435,13 +1445,14 @@ void Wmb::wmbadapter_addSendReadLoopsCounter(SmCayenne& cayenne)
 {
 	MyLog::log("WMB", "..add send loop counter to cayenne");
 
-	cayenne.addSendReadLoops(m_smartmeter.getChannel(), m_sm_readLoops);
+	cayenne.addSendReadLoops(m_smartmeters[0].getChannel(), m_sm_readLoops);
 }
 
 /**
  * @brief Stores the send fails counter to Cayenne.
  * 
- * This function stores the send fails counter to Cayenne.
+ * This function stores the number of packets the transmit queue gave up after all attempts and the uplinks which
+ * had no payload at the current data rate to Cayenne.
  * 
  * @param cayenne Reference to the SmCayenne object.
  */
@@ -449,7 +1460,23 @@ void Wmb::wmbadapter_addSendFailuresCounter(SmCayenne& cayenne)
 {
 	MyLog::log("WMB", "..add send failed counter to cayenne");
 
-	cayenne.addSendFailures(m_smartmeter.getChannel(), m_send_fail);
+	uint32_t failures = (uint32_t) m_wbMcu.getSendFailures() + m_unsentUplinks;
+
+	cayenne.addSendFailures(m_smartmeters[0].getChannel(), failures < UINT16_MAX ? failures : UINT16_MAX);
+}
+
+/**
+ * @brief Stores the push schedule statistics to Cayenne.
+ * 
+ * This function stores the expected adapter on time, the arrival error of the last push and the saved on time to Cayenne.
+ * 
+ * @param cayenne Reference to the SmCayenne object.
+ */
+void Wmb::wmbadapter_addPushSchedule(SmCayenne& cayenne)
+{
+	MyLog::log("WMB", "..add push schedule statistics to cayenne");
+
+	cayenne.addPushSchedule(m_smartmeters[0].getChannel(), m_pushScheduler.getExpectedOnTime(), m_pushScheduler.getLastError(), m_pushScheduler.getSavedOnTime());
 }
 
 /**
@@ -466,4 +1493,9 @@ void Wmb::wmbadaper_addStates(SmCayenne& cayenne)
 	wmbadaper_battery(cayenne);
 	wmbadapter_addSendReadLoopsCounter(cayenne);
 	wmbadapter_addSendFailuresCounter(cayenne);
+
+	if(m_appConfig.pushSchedule)
+	{
+		wmbadapter_addPushSchedule(cayenne);
+	}
 }
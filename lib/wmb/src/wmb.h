@@ -15,16 +15,27 @@
 
 #include "smcayenne.h"
 #include "appconfig.h"
-#include "gbt.h"
-#include "dlms.h"
 #include "hdlc.h"
-#include "smbase.h"    
+#include "smaggregator.h"
+#include "smeventrules.h"
+#include "smdeltaencoder.h"
+#include "smdictionarysession.h"
+#include "smfixedencoder.h"
+#include "smfragmenter.h"
+#include "smgbtcompressor.h"
+#include "smautodetect.h"
+#include "smmeter.h"
+#include "smmeterbus.h"
+#include "smpriorityplan.h"
+#include "smpushscheduler.h"
+#include "smtxqueue.h"
+#include "smuplinkstore.h"
 #include "wbmcubase.h"
 
 class Wmb 
 {
     public:
-        Wmb(WbMcuBase& wbMcu, SmBase& smartmeter, Gbt& gbt, Dlms& dlms, Hdlc& hdlc, SmCayenne& smCayenne, AppConfig& appConfig);    
+        Wmb(WbMcuBase& wbMcu, SmMeter (&smartmeters)[SM_MAX_METERS], SmMeterBus& meterBus, Hdlc& hdlc, SmCayenne& smCayenne, AppConfig& appConfig);
         bool initApp();                                                                                                             // initialize the application                            
         void setupApp();                                                                                                            // setup the application                    
         void smReadSendcycle();                                                                                                     // read and send data from the smart meter
@@ -33,20 +44,41 @@ class Wmb
         void hdlcFrameHandler(uint8_t const* data, size_t const size, bool const valid);                                            // handle HDLC frames received from the smart meter
 
     private:
-        static const int SM_GBT_MAXFRAMESIZE = 1024;            // maximum size of the GBT frame
+        static const uint32_t SM_WARMUP_TIME = 500;             // warm-up of the m-bus adapter and of the serial port in ms
+        static const uint8_t SM_NO_METER = 0xff;                // m_gbtData holds no frame
+        static const size_t SM_READ_CHUNK_SIZE = 64;            // bytes taken from the serial port with one read
+        static const uint32_t SM_READ_TIMEOUT = 100;            // wait for data in ms before the read cycle timeout is checked again
+        static const uint8_t SM_FPORT_UPLINK = 2;               // port of the uplinks sent in one frame (the former default app_port, 0 is the MAC port)
+        static const uint8_t SM_FPORT_FRAGMENT = 3;             // port of the fragments of an uplink sent in several frames
+        static const uint8_t SM_STREAM_ADAPTER = SM_MAX_METERS; // uplink stream of the adapter states, the meters use their index
 
         uint32_t g_appTimer = AppConfig::SM_MEASURE_INTERVAL;	// measurement intervall (=wakeup timer in ms)
-        uint16_t m_send_fail = 0;								// counter, WAN send fails
         uint32_t m_sm_readLoops = 0;							// counter, total of read loops
 
-        uint8_t m_lastGbtFrameReceived[SM_GBT_MAXFRAMESIZE];	// last gbt frame received from smartmeter
-        size_t m_lastGbtFrameReceivedSize;						// last gbt frame received length
+        GbtData m_gbtData;                                      // values of the gbt frame in process (reused for every frame and meter)
+        uint8_t m_gbtDataMeter = SM_NO_METER;                   // meter of the frame parsed into m_gbtData
+        bool m_gbtDataFiltered = false;                         // flag indicating if the registers filtered out were skipped by the parse
+        SmPushScheduler m_pushScheduler;                        // wake-up before the push of the first meter
+        SmAutoDetect m_autoDetect;                              // detection of the serial settings and the profile
+        bool m_detecting = false;                               // flag indicating if the frames are passed to the detection
+        SmAggregator m_aggregators[SM_MAX_METERS];              // statistics of the pushes of the aggregation window of each meter
+        SmEventRules m_eventRules[SM_MAX_METERS];               // decides if the push of each meter is worth an uplink
+        SmDerived m_derived[SM_MAX_METERS];                     // counters of the last sent push of each meter and the values derived from them
+        SmDeltaEncoder m_deltaEncoders[SM_MAX_METERS];          // last sent and last acknowledged push of each meter for the delta frames
+        uint32_t m_deltaUplink[SM_MAX_METERS];                  // uplink whose delivery confirms the last delta frame of each meter
+        SmDictionarySession m_dictionarySessions[SM_MAX_METERS];    // dictionary of the push of each meter and the hash of the sent one
+        SmPriorityPlan m_priorityPlans[SM_MAX_METERS];          // registers of each meter deferred by the priority truncation
+        SmFixedEncoder m_fixedEncoder;                          // fixed payload of the profile (shared, the meters use the same profile)
+        SmGbtCompressor m_gbtCompressor;                        // raw GBT block compressed against the dictionary of the profile (shared)
+        SmFragmenter m_fragmenter;                              // frames or fragments of the uplink in process
+        uint32_t m_sentUplink = 0;                              // uplink (message of the transmit queue) of the last send
+        SmUplinkStore m_uplinkStores[SM_STREAM_ADAPTER + 1];    // last uplink of each stream, planned again if the data rate drops before it is sent
+        uint16_t m_unsentUplinks = 0;                           // uplinks not sent as the current data rate had no payload left, counted as send failures
 
         WbMcuBase& m_wbMcu;                                     // wisblock mcu
-        SmBase& m_smartmeter;                                   // smartmeter handler
-        Gbt &m_gbt;                                             // gbt protocol handler
-        Dlms &m_dlms;								            // dlsm protocol handler
-        Hdlc &m_hdlc;                                           // hdlc protocol handler
+        SmMeter (&m_smartmeters)[SM_MAX_METERS];                // smartmeter handler of each meter
+        SmMeterBus& m_meterBus;                                 // receive state of each meter (gbt and dlms protocol handler)
+        Hdlc &m_hdlc;                                           // hdlc protocol handler (shared by the meters of the bus)
         SmCayenne& m_smCayenne;                                 // cayenne data handler
         AppConfig& m_appConfig;									// application settings handler
 
@@ -54,10 +86,64 @@ class Wmb
         void wmbadaper_battery(SmCayenne& cayenne);             // stores battery status to cayenne
         void wmbadapter_addSendReadLoopsCounter(SmCayenne& cayenne);          // stores send loops to cayenne
         void wmbadapter_addSendFailuresCounter(SmCayenne& cayenne);           // stores send fails counter to cayenne
+        void wmbadapter_addPushSchedule(SmCayenne& cayenne);    // stores push schedule statistics to cayenne
         void save_appConfig(AppConfig& appConfig);              // stores application settings to flash
 
         void mbusAdapterOff();                                  // switch off mbus adapter
         void mbusAdapterOn();                                   // switch on mbus adapter
 
-        void smReadcycle();                                     // read data from the smart meter
+        void initMeters();                                      // applies the meter configuration to the meters and the bus
+        bool parseFrame(uint8_t const meter, bool const filtered);  // parses the gbt frame of a meter into m_gbtData (once per push), filtered skips the registers not sent
+        bool decodeFrame(uint8_t const meter);                  // decodes the gbt frame of a meter into cayenne
+        bool isAggregating() const;                             // checks if the pushes of the aggregation window are sent as statistics
+        bool isRawUplink() const;                               // checks if the GBT block is sent as is (raw or compressed)
+        bool sendGbtBlock(uint8_t const meter);                 // sends the last GBT block of a meter, compressed if configured
+        void aggregateWindow();                                 // folds the pushes of the aggregation window into the statistics of each meter
+        void foldPushes(uint16_t (&folded)[SM_MAX_METERS]);     // folds the new push of each meter into its statistics
+        bool encodeAggregate(uint8_t const meter);              // encodes the statistics of a meter into cayenne
+        bool isUplinkDue(uint8_t const meter);                  // checks the push of a meter against the event rules
+        bool encodeDerived(uint8_t const meter);                // encodes the values derived from the energy counters of a meter into cayenne
+        bool encodeDelta(uint8_t const meter);                  // encodes the push of a meter as delta frame into cayenne
+        bool encodeDictionary(uint8_t const meter, bool& dictionaryAdded);    // encodes the values of a meter in the order of its dictionary into cayenne
+        bool encodeFixed(uint8_t const meter);                  // encodes the values of a meter in the fixed layout of the profile into cayenne
+        void truncateByPriority(uint8_t const meter);           // keeps the values of a meter which fit into one frame in the priority of their registers
+        bool sendCayenne(uint8_t const stream);                 // sends the cayenne buffer via WAN as uplink of a stream
+        bool sendFrames(uint8_t const stream, uint8_t const* data, uint16_t const* recordEnds, uint8_t const recordCount);    // sends an uplink in the fewest frames of the current data rate
+        bool planFrames(uint16_t const* recordEnds, uint8_t const recordCount, size_t const maxPayloadSize);    // plans the frames or fragments of an uplink
+        void replanUplinks();                                   // plans the uplinks again which the transmit queue dropped as too large for the data rate
+
+        void pushCompleted(bool const received, uint32_t const arrival);      // learns from the push of the first meter
+        void scheduleNextCycle();                               // sets the wake-up for the next read cycle
+
+        void smReadcycle();                                     // read data from the smart meters
+        bool smDetectcycle();                                   // detects the serial settings and the profile of the meters
+        void detectWithSetting(SmSerialSetting const& setting); // receives with one serial setting till it is detected or rejected
 };
+
+// each meter and the adapter states have their own uplink stream, a newer uplink supersedes the waiting one of its stream
+static_assert(SM_MAX_METERS < SmTxQueue::MAX_STREAMS, "uplink streams exceed SmTxQueue::MAX_STREAMS");
+
+// the register filter of the settings is taken by the filter of each meter
+static_assert(AppConfig::SM_MAX_REGISTERFILTER <= SmRegisterFilter::MAX_CODES, "register filter of the settings exceeds SmRegisterFilter::MAX_CODES");
+
+// memory used by the parsed gbt values (Wmb::m_gbtData, shared), the receive state (SmMeterSlot), the aggregation
+// statistics (SmAggregator), the event state (SmEventRules), the delta frames (SmDeltaEncoder) and the dictionary
+// (SmDictionarySession) of each meter and the compression of the GBT block (SmGbtCompressor, shared), checked at
+// build time for each target
+#if defined(NRF52_SERIES)
+static_assert(sizeof(GbtData) <= 2560, "GbtData exceeds its budget of 2560 bytes RAM on the nRF52 target");
+static_assert(sizeof(SmMeterSlot) <= 1536, "SmMeterSlot exceeds its budget of 1536 bytes RAM per meter on the nRF52 target");
+static_assert(sizeof(SmAggregator) <= 1024, "SmAggregator exceeds its budget of 1024 bytes RAM per meter on the nRF52 target");
+static_assert(sizeof(SmEventRules) <= 512, "SmEventRules exceeds its budget of 512 bytes RAM per meter on the nRF52 target");
+static_assert(sizeof(SmDeltaEncoder) <= 1024, "SmDeltaEncoder exceeds its budget of 1024 bytes RAM per meter on the nRF52 target");
+static_assert(sizeof(SmDictionarySession) <= 512, "SmDictionarySession exceeds its budget of 512 bytes RAM per meter on the nRF52 target");
+static_assert(sizeof(SmGbtCompressor) <= 6144, "SmGbtCompressor exceeds its budget of 6144 bytes RAM on the nRF52 target");
+#elif defined(ARDUINO_ARCH_ESP32)
+static_assert(sizeof(GbtData) <= 2560, "GbtData exceeds its budget of 2560 bytes RAM on the ESP32 target");
+static_assert(sizeof(SmMeterSlot) <= 1536, "SmMeterSlot exceeds its budget of 1536 bytes RAM per meter on the ESP32 target");
+static_assert(sizeof(SmAggregator) <= 1024, "SmAggregator exceeds its budget of 1024 bytes RAM per meter on the ESP32 target");
+static_assert(sizeof(SmEventRules) <= 512, "SmEventRules exceeds its budget of 512 bytes RAM per meter on the ESP32 target");
+static_assert(sizeof(SmDeltaEncoder) <= 1024, "SmDeltaEncoder exceeds its budget of 1024 bytes RAM per meter on the ESP32 target");
+static_assert(sizeof(SmDictionarySession) <= 512, "SmDictionarySession exceeds its budget of 512 bytes RAM per meter on the ESP32 target");
+static_assert(sizeof(SmGbtCompressor) <= 6144, "SmGbtCompressor exceeds its budget of 6144 bytes RAM on the ESP32 target");
+#endif
@@ -4,7 +4,7 @@
  * 
  * This file contains the implementation of the WmbNrf52 class, which is responsible for managing the WmbNrf52 module.
  * The class provides methods for loading and saving configuration, controlling the watchdog, initializing the application,
- * checking WLAN connectivity, handling data events, and sending LoRaWAN packets.
+ * checking WLAN connectivity, handling data events, and sending LoRaWAN packets through the transmit queue.
  * 
  * @version 1.0
  * @author MFA Informatik AG, Andreas Schneider
@@ -23,6 +23,7 @@
  * 
 */
 WmbNrf52::WmbNrf52(SmCayenne &smCayenne, AppConfig &appConfig) : 
+	m_txQueue(*this),
 	m_smCayenne(smCayenne), 
 	m_appConfig(appConfig)
 {
@@ -78,6 +79,108 @@ void WmbNrf52::delayWithLed(time_t delayWithLedTimeOut)
 	digitalWrite(LED_BUILTIN, LOW);
 }
 
+/**
+ * 
+ * @brief Activity LED helper
+ * 
+ * Blinks the LED by a timer while data is received, so the receive loop does not touch the LED for each chunk.
+ * The LED is turned off when the activity ends.
+ * 
+ * @param active true while data is received
+ * 
+*/
+void WmbNrf52::setActivityLed(bool active)
+{
+	if(active == m_activityLed)
+	{
+		return;
+	}
+
+	m_activityLed = active;
+
+	if(!m_activityTimerStarted)
+	{
+		m_activityTimer.begin(SM_ACTIVITY_BLINK_TIME, activityLedHandler);
+
+		m_activityTimerStarted = true;
+	}
+
+	if(active)
+	{
+		m_activityTimer.start();
+	}
+	else
+	{
+		m_activityTimer.stop();
+
+		digitalWrite(LED_BUILTIN, LOW);
+	}
+}
+
+/**
+ * 
+ * @brief Toggles the LED, called by the activity timer
+ * 
+ * @param timer The timer handle (unused)
+ * 
+*/
+void WmbNrf52::activityLedHandler(TimerHandle_t timer)
+{
+	digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+}
+
+/**
+ * 
+ * @brief Wakes the application loop for the transmit queue, called by the transmit timer
+ * 
+ * The queue is only touched by the application loop (see dataHandler), the timer task raises the event.
+ * 
+ * @param timer The timer handle (unused)
+ * 
+*/
+void WmbNrf52::txTimerHandler(TimerHandle_t timer)
+{
+	api_wake_loop(SM_LORA_TX_TIMER);
+}
+
+/**
+ * 
+ * @brief Arm the transmit timer
+ * 
+ * The timer is armed for the next event of the transmit queue (retry of a failed packet after the backoff, or the
+ * end of the TX cycle which did not come), it is stopped if the queue is idle. Called after each event of the queue.
+ * 
+*/
+void WmbNrf52::armTxTimer()
+{
+	uint32_t delay = m_txQueue.getTimerDelay(millis());
+
+	if(!m_txTimerStarted)
+	{
+		m_txTimer.begin(SmTxQueue::TXFIN_TIMEOUT, txTimerHandler, nullptr, false);
+
+		m_txTimerStarted = true;
+	}
+
+	m_txTimer.stop();
+
+	if(delay != SmTxQueue::NO_TIMER)
+	{
+		m_txTimer.setPeriod(delay);
+		m_txTimer.start();
+	}
+}
+
+/**
+ * 
+ * @brief Log the state and the counters of the transmit queue
+ * 
+*/
+void WmbNrf52::logTxQueue()
+{
+	MyLog::log("NRF52", "LoRaWAN transmit queue %d packets, delivered %lu, retries %lu, dropped %lu, superseded %lu, oversized %lu", m_txQueue.getCount(), (unsigned long) m_txQueue.getDeliveredCount(), (unsigned long) m_txQueue.getRetryCount(), (unsigned long) m_txQueue.getDroppedCount(), (unsigned long) m_txQueue.getSupersededCount(), (unsigned long) m_txQueue.getOversizedCount());
+}
+
 /**
  * 
  * @brief Set the Watch Dog object
@@ -124,6 +227,81 @@ void WmbNrf52::initApp(void)
     g_lorawan_settings.confirmed_msg_enabled = LMH_CONFIRMED_MSG;
 }
 
+/**
+ * 
+ * @brief Set the wake-up timer
+ * 
+ * Restarts the application timer, the next read cycle starts after the delay (and then every delay until it is
+ * set again). The watchdog timeout is three measure intervals, the delay must stay below it.
+ * 
+ * @param wakeUpDelay Time till the next read cycle in ms
+ * 
+*/
+void WmbNrf52::setWakeUpTimer(uint32_t wakeUpDelay)
+{
+	MyLog::log("NRF52", "Set wake-up timer to %lu ms", (unsigned long) wakeUpDelay);
+
+	api_timer_restart(wakeUpDelay);
+}
+
+/**
+ * 
+ * @brief Start the next uplink of a stream
+ * 
+ * The packets queued after the call belong to the uplink (a message of the transmit queue). The waiting packets
+ * of the older uplinks of the stream are dropped, their data is stale.
+ * 
+ * @param stream Stream of the uplink (e.g. the index of the meter)
+ * @return The uplink, SmTxQueue::NO_MESSAGE if the stream is invalid
+*/
+uint32_t WmbNrf52::openUplink(uint8_t stream)
+{
+	return m_txQueue.openMessage(stream);
+}
+
+/**
+ * 
+ * @brief Drop the uplink started last
+ * 
+ * The uplink could not be queued as a whole (e.g. the transmit queue is full), its fragments which wait are
+ * dropped, the server cannot reassemble them without the missing ones.
+*/
+void WmbNrf52::abortUplink()
+{
+	m_txQueue.abortMessage();
+
+	armTxTimer();
+}
+
+/**
+ * 
+ * @brief Check if an uplink was delivered
+ * 
+ * An uplink is delivered once each of its packets was acknowledged (confirmed messages), the delta frames use it
+ * to confirm their reference frame.
+ * 
+ * @param stream Stream of the uplink
+ * @param uplink The uplink (see openUplink)
+ * @return true if it is the latest uplink of the stream and all its packets were acknowledged
+*/
+bool WmbNrf52::isUplinkDelivered(uint8_t stream, uint32_t uplink)
+{
+	return m_txQueue.isDelivered(stream, uplink);
+}
+
+/**
+ * 
+ * @brief Get the number of packets given up
+ * 
+ * @return Number of packets dropped after all attempts (with the other fragments of their uplink), at most 0xffff
+*/
+uint16_t WmbNrf52::getSendFailures()
+{
+	uint32_t dropped = m_txQueue.getDroppedCount();
+
+	return dropped < UINT16_MAX ? dropped : UINT16_MAX;
+}
+
 /**
  * 
  * @brief Check if WLAN is connected
@@ -144,7 +322,8 @@ bool WmbNrf52::isWlanConnected()
  * 
  * @brief Data handler
  * 
- * This function is used to handle data. It handles LoRa data received, LoRa TX finished, and LoRa join finished.
+ * This function is used to handle data. It handles LoRa data received, LoRa TX finished, LoRa join finished and
+ * the transmit timer. The end of the TX cycle and the timer drive the transmit queue, they do not wait.
  * 
  * @param event_type Event type
  * 
@@ -162,10 +341,19 @@ void WmbNrf52::dataHandler(uint16_t& event_type)
 		SmCayenne smReceived(g_rx_data_len);
 
         // store the settings into the current configuration
-		smReceived.smDecodeReceivedAppSettings(g_rx_lora_data, g_rx_data_len, m_appConfig);
+		if (smReceived.smDecodeReceivedAppSettings(g_rx_lora_data, g_rx_data_len, m_appConfig))
+		{
+			// persist the settings, they are loaded again after the restart
+			saveConfiguration(m_appConfig);
 
-		// restart the board
-		api_reset();
+			// restart the board
+			api_reset();
+		}
+		else
+		{
+			// requests only (e.g. the dictionary), they are served by the next read cycle and would be lost by the restart
+			MyLog::log("NRF52", "LoRaWAN downlink with requests only, no restart");
+		}
 	}
 
 	// LoRa TX finished handling
@@ -176,38 +364,29 @@ void WmbNrf52::dataHandler(uint16_t& event_type)
 
 		MyLog::log("NRF52", "LoRaWAN  TX cycle %s", g_rx_fin_result ? "finished ACK" : "failed NAK");
 
-		if (g_rx_fin_result)
-		{
-			// reset fail send counter
-			m_send_fail = 0;
-		}
-		else
-		{
-			// increase fail send counter
-			m_send_fail++;
-
-			MyLog::log("NRF52", "LoRaWAN failed NAK counter %d", m_send_fail);
-
-			if (m_send_fail < SM_LORA_SEND_REPEATER)
-			{
-				if(m_smCayenne.getSize() > 0)
-				{
-					MyLog::log("NRF52", "LoRaWAN failed sending, repeat enqueue last packet");
-
-					enqueueDataPacket(m_smCayenne.getBuffer(), m_smCayenne.getSize(), 0);
-				}
-			}
-			else
-			{
-				MyLog::log("NRF52", "LoRaWAN to many failed sendings, reset node");
-
-				api_reset();
-			}
-		}
+		// the acknowledged packet makes way for the next one, the packet which was not acknowledged is sent again
+		// after the backoff (no reset of the node, the backoff grows while the failures go on)
+		m_txQueue.txFinished(g_rx_fin_result, millis());
+
+		logTxQueue();
+
+		armTxTimer();
 
 		resetWatchDog();
 	}
 
+	// transmit timer handling
+	if ((g_task_event_type & SM_LORA_TX_TIMER) == SM_LORA_TX_TIMER)
+	{
+		g_task_event_type &= SM_N_LORA_TX_TIMER;
+
+		m_txQueue.timerExpired(millis());
+
+		logTxQueue();
+
+		armTxTimer();
+	}
+
 	// LoRa Join finished handling
 	if ((g_task_event_type & LORA_JOIN_FIN) == LORA_JOIN_FIN)
 	{
@@ -234,81 +413,115 @@ void WmbNrf52::dataHandler(uint16_t& event_type)
 
 /**
  * 
- * @brief Send LoRaWAN packet helper
+ * @brief Get the maximum payload of the next uplink
  * 
- * This helper is used to send a LoRaWAN packet. The packet is sent in chunks if required. The chunks are
- * sent one after the other. If the LoRaWAN transceiver is busy the sending is repeated after a delay.
+ * The LoRaWAN stack reports the payload of the current data rate, less the pending MAC commands which are sent
+ * with the next uplink. The uplinks are planned with this size (see SmFramePlan), there is no trial and error.
  * 
+ * @return Maximum payload in bytes, 0 if the pending MAC commands need an uplink of their own
 */
-lmh_error_status WmbNrf52::enqueueDataPacket(const uint8_t *data, size_t size, uint8_t fport)
+size_t WmbNrf52::getMaxPayloadSize()
 {
-	MyLog::log("NRF52", "LoRaWAN send %d bytes to port %d", size, fport);
+	LoRaMacTxInfo_t txInfo;
 
-	MyLog::logHex("NRF52", "..enqueue Lora packet: ", data, size);
-
-	// https://lora-developers.semtech.com/documentation/tech-papers-and-guides/the-book/packet-size-considerations
-	size_t loraPayloadSize = min((size_t) SM_LORA_MAXPAYLOAD, size); 
-	size_t remainingBytes = size;
-	size_t offset = 0;
-	uint8_t repeatBusy = 0;
-	uint8_t errorCount = 0;
-
-	while(offset < size)
+	// an empty payload always fits, the stack fills in the limits of the current data rate
+	if (LoRaMacQueryTxPossible(0, &txInfo) != LORAMAC_STATUS_OK)
 	{
-		size_t loraPacketSize = min(loraPayloadSize, remainingBytes);
+		MyLog::log("NRF52", "LoRaWAN pending MAC commands exceed the payload of the current datarate");
+
+		return 0;
+	}
 
-		MyLog::log("NRF52", ".. queue Lora packet, maxLoraPayload %d, remainingBytes %d", loraPayloadSize, remainingBytes);
+	return min((size_t) SM_LORA_MAXPAYLOAD, (size_t) txInfo.MaxPossiblePayload);
+}
 
-		uint8_t sendData[loraPacketSize];
+/**
+ * 
+ * @brief Take an uplink dropped as too large for the current data rate
+ * 
+ * The transmit queue checks each packet against the payload of the current data rate when its turn comes. The
+ * packets planned before an ADR drop would be rejected on each attempt, their uplink is dropped at once and
+ * planned again by the application (see Wmb::replanUplinks).
+ * 
+ * @param stream Stream of the uplink
+ * @param uplink The uplink (see openUplink)
+ * @return true if an uplink was taken, false if there is none
+*/
+bool WmbNrf52::takeOversizedUplink(uint8_t& stream, uint32_t& uplink)
+{
+	return m_txQueue.takeOversized(stream, uplink);
+}
 
-		memcpy(sendData, data + offset, loraPacketSize);
+/**
+ * 
+ * @brief Get the transmit buffer
+ * 
+ * The uplinks are written straight into the transmit queue (see Wmb::sendFrames), the queue keeps the sent
+ * packet for its repetition if it is not acknowledged.
+ * 
+ * @return Buffer of SM_LORA_MAXPAYLOAD bytes at the end of the transmit queue, nullptr if the queue is full
+*/
+uint8_t* WmbNrf52::getTxBuffer()
+{
+	return m_txQueue.reserve();
+}
 
-		lmh_error_status result = send_lora_packet(sendData, loraPacketSize, fport);
+/**
+ * 
+ * @brief Queue the packet of the transmit buffer
+ * 
+ * The packet is sent at once if the transmit queue is idle, otherwise after the packets before it. A busy
+ * transceiver or a rejected packet is retried by the transmit timer, the application loop does not wait.
+ * 
+ * @param size Size of the packet written into the transmit buffer
+ * @param fport LoRaWAN port of the packet
+ * @return LMH_SUCCESS if the packet was queued, LMH_ERROR if the queue is full or the size is invalid
+*/
+lmh_error_status WmbNrf52::sendTxBuffer(size_t size, uint8_t fport)
+{
+	MyLog::log("NRF52", "LoRaWAN queue %d bytes to port %d", size, fport);
 
-		MyLog::log("NRF52", ".. Lora packet, offset %d, size %d, repeatBusy %d", offset, loraPacketSize, repeatBusy);
+	if(size == 0 || size > SM_LORA_MAXPAYLOAD || !m_txQueue.commit(size, fport, millis()))
+	{
+		MyLog::log("NRF52", "LoRaWAN packet of %d bytes not queued (%d packets waiting)", size, m_txQueue.getCount());
 
-		switch (result)
-		{
-			case LMH_SUCCESS:
-				MyLog::log("NRF52", "LoRaWAN packet enqueued");
-				offset += loraPacketSize;
-				remainingBytes -= loraPacketSize;
-				repeatBusy = 0;
-				break;
-			case LMH_BUSY:
-				MyLog::log("NRF52", "LoRaWAN transceiver is busy, repeat send");
-				delay(SM_LORA_PACKET_DELAY_MS);
-				repeatBusy++;
-				break;
-			case LMH_ERROR:
-				errorCount++;
-				MyLog::log("NRF52", "LoRaWAN packet error count %d, maybe too big with %d bytes to send with current datarate", errorCount, loraPayloadSize);
-				if(errorCount > 2)
-				{
-					loraPayloadSize -= SM_LORA_PACKET_SIZESTEP;
-
-					MyLog::log("NRF52", "..try to reduce packet size to %d bytes", loraPayloadSize);
-				}
-				delay(SM_LORA_PACKET_DELAY_MS);
-				break;
-		}
+		return lmh_error_status::LMH_ERROR;
+	}
 
-		if(loraPayloadSize < SM_LORA_PACKET_SIZESTEP)
-		{
-			MyLog::log("NRF52", "LoRaWAN packet size could not be determined");
+	armTxTimer();
 
-			return lmh_error_status::LMH_ERROR;
-		}	
+	return lmh_error_status::LMH_SUCCESS;
+}
 
-		if(repeatBusy > SM_LORA_SEND_REPEATER)
-		{
-			MyLog::log("NRF52", "LoRaWAN packet could not be send after %d retries", repeatBusy);
+/**
+ * 
+ * @brief Hand a packet of the transmit queue to the LoRaWAN stack
+ * 
+ * Called by the transmit queue, the result of the confirmed uplink follows with the end of the TX cycle.
+ * 
+ * @param data The packet
+ * @param size Size of the packet
+ * @param fport LoRaWAN port of the packet
+ * @return SMTX_SUCCESS if the packet was enqueued, SMTX_BUSY if the transceiver is busy, SMTX_ERROR otherwise
+*/
+SmTxResult WmbNrf52::send(uint8_t const* data, size_t const size, uint8_t const fport)
+{
+	MyLog::logHex("NRF52", "..enqueue Lora packet: ", data, size);
 
-			return lmh_error_status::LMH_ERROR;
-		}
+	// https://lora-developers.semtech.com/documentation/tech-papers-and-guides/the-book/packet-size-considerations
+	switch (send_lora_packet((uint8_t*) data, size, fport))
+	{
+		case LMH_SUCCESS:
+			MyLog::log("NRF52", "LoRaWAN packet enqueued");
+			return SmTxResult::SMTX_SUCCESS;
+		case LMH_BUSY:
+			MyLog::log("NRF52", "LoRaWAN transceiver is busy");
+			return SmTxResult::SMTX_BUSY;
+		case LMH_ERROR:
+		default:
+			MyLog::log("NRF52", "LoRaWAN packet error with %d bytes", size);
+			return SmTxResult::SMTX_ERROR;
 	}
-
-	return lmh_error_status::LMH_SUCCESS;
 }
 
 
@@ -3,8 +3,9 @@
  * @brief This class represents the WmbNrf52 module, which is a subclass of WbMcuBase.
  * 
  * It provides functionality for handling data, initializing the application, starting and resetting the watchdog,
- * delaying with LED, and enqueueing data packets. It also contains constants for maximum payload size, packet delay,
- * packet size step, and send repeater.
+ * delaying with LED, and sending data packets through its transmit queue (see SmTxQueue). The queue is driven by
+ * the end of the TX cycles and by the transmit timer, the application loop does not wait for the transceiver.
+ * It also contains the constant for the maximum payload size.
  * 
  * @version 1.0
  * @author MFA Informatik AG, Andreas Schneider
@@ -12,10 +13,14 @@
 #pragma once
 
 #include "smcayenne.h"
+#include "smtxqueue.h"
 #include "appsettings-nrf52.h"
 #include "wbmcubase.h"
 
-class WmbNrf52 : public WbMcuBase
+#define SM_LORA_TX_TIMER 0b0100000000000000             // event of the transmit timer, the transmit queue retries or gives up a packet
+#define SM_N_LORA_TX_TIMER 0b1011111111111111           // reset event of the transmit timer
+
+class WmbNrf52 : public WbMcuBase, public SmTxRadio
 {
     public:
         WmbNrf52(SmCayenne& smCayenne, AppConfig& appConfig);
@@ -25,17 +30,38 @@ class WmbNrf52 : public WbMcuBase
         void startWatchDog() override;
         void resetWatchDog() override;
         void delayWithLed(time_t delayWithLedTimeOut) override;
-        lmh_error_status enqueueDataPacket(const uint8_t *data, size_t size, uint8_t fport) override;
+        void setActivityLed(bool active) override;
+        uint8_t* getTxBuffer() override;
+        lmh_error_status sendTxBuffer(size_t size, uint8_t fport) override;
+        void setWakeUpTimer(uint32_t wakeUpDelay) override;
+        uint32_t openUplink(uint8_t stream) override;
+        void abortUplink() override;
+        bool isUplinkDelivered(uint8_t stream, uint32_t uplink) override;
+        uint16_t getSendFailures() override;
+        size_t getMaxPayloadSize() override;
+        bool takeOversizedUplink(uint8_t& stream, uint32_t& uplink) override;
         bool loadConfiguration(AppConfig& appConfig) override;
         bool saveConfiguration(AppConfig const& appConfig) override;
+        SmTxResult send(uint8_t const* data, size_t const size, uint8_t const fport) override;
 
     private:
         static const int SM_LORA_MAXPAYLOAD = 222;
-        static const int SM_LORA_PACKET_DELAY_MS = 5000;
-        static const int SM_LORA_PACKET_SIZESTEP = 10;
-        static const int SM_LORA_SEND_REPEATER = 10;
+        static const uint32_t SM_ACTIVITY_BLINK_TIME = 50;
+
+        static_assert(SmTxQueue::MAX_PACKET_SIZE >= SM_LORA_MAXPAYLOAD, "the transmit queue holds the largest LoRaWAN payload");
+
+        static void activityLedHandler(TimerHandle_t timer);     // toggles the LED, called by the activity timer
+        static void txTimerHandler(TimerHandle_t timer);         // wakes the application loop for the transmit queue, called by the transmit timer
+
+        void armTxTimer();                                      // arms the transmit timer for the next event of the transmit queue
+        void logTxQueue();                                      // logs the counters of the transmit queue
 
-        uint16_t m_send_fail = 0;								// counter, lora send fails
+        SoftwareTimer m_activityTimer;                          // blinks the LED while data is received
+        bool m_activityTimerStarted = false;                    // the activity timer is created
+        bool m_activityLed = false;                             // the activity timer is running
+        SmTxQueue m_txQueue;                                    // packets waiting for the transceiver, each one is retried on its own
+        SoftwareTimer m_txTimer;                                // one-shot timer of the transmit queue (retry or end of the TX cycle)
+        bool m_txTimerStarted = false;                          // the transmit timer is created
 
         SmCayenne &m_smCayenne;
         AppConfig &m_appConfig;
@@ -17,10 +17,9 @@
 #include "mylog.h"
 #include "smat.h"
 #include "wmb.h"
-#include "gbt.h"
-#include "dlms.h"
 #include "hdlc.h"
-#include "smlg450.h"
+#include "smmeter.h"
+#include "smmeterbus.h"
 #include "wmbnrf52.h"
 
 #include "main.h"
@@ -29,10 +28,9 @@ char g_ble_dev_name[10] = SM_BLE_DEVICENAME;										// device name for BLE (va
 
 AppConfig m_appConfig;																// application config
 SmCayenne m_smCayenne(CAYENNEPAYLOAD);												// cayenne data handler		
-Gbt m_gbt(gbt_frame_handler);    													// gbt protocol handler
-Dlms m_dlms(m_gbt);																	// sort of dlsm protocol handler but only used for gbt
-Hdlc m_hdlc(hdlc_frame_handler);													// m_hdlc protocol handler
-SmLg450 m_lg450;																	// smartmeter handler
+SmMeterBus m_meterBus(gbt_frame_handler);											// gbt and dlms protocol handler of each meter on the bus
+Hdlc m_hdlc(hdlc_frame_handler);													// m_hdlc protocol handler (shared by the meters of the bus)
+SmMeter m_smMeters[SM_MAX_METERS];													// smartmeter handler of each meter (profile selected by the configuration)
 
 #ifdef NRF52_SERIES
 WmbNrf52 m_wmbnrf52(m_smCayenne, m_appConfig);										// wisblock nr52 mcu
@@ -43,7 +41,7 @@ WbMcuBase& m_wmb = m_wmbnrf52;
 //todo: add esp32 mcu
 #endif
 
-Wmb wmb(m_wmb, m_lg450, m_gbt, m_dlms, m_hdlc, m_smCayenne, m_appConfig);			// wmb controller 
+Wmb wmb(m_wmb, m_smMeters, m_meterBus, m_hdlc, m_smCayenne, m_appConfig);			// wmb controller 
 
 /**
  * 
@@ -168,6 +166,12 @@ void app_event_handler()
 		
 		wmb.smReadSendcycle();
 	}
+
+	// transmit timer events, handled with the LoRaWAN events (the flag is reset by the handler)
+	if((g_task_event_type & SM_LORA_TX_TIMER) == SM_LORA_TX_TIMER)
+	{
+		wmb.dataHandler(g_task_event_type);
+	}
 }
 
 
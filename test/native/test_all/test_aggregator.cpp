@@ -0,0 +1,137 @@
+#include "unity.h"
+
+#include "test_aggregator.h"
+#include "test_fixtures.h"
+
+#include "gbtdata.h"
+#include "smaggregator.h"
+#include "smprofile.h"
+#include "smpushextractor.h"
+
+// one push with the active power and the active energy
+static void foldPush(SmAggregator& aggregator, uint32_t const time, int32_t const power, int32_t const energy)
+{
+    aggregator.addRecordTime(10, time);
+    aggregator.addRecordScaled(10, scaledValue(power, 0, SmUnit::SMUNIT_WATT));
+    aggregator.addRecordScaled(10, scaledValue(energy, 0, SmUnit::SMUNIT_WATTHOUR));
+}
+
+void test_aggregator_statistics(void)
+{
+    SmAggregator aggregator;
+
+    aggregator.reset();
+
+    foldPush(aggregator, 1000, 120, 5000);
+    foldPush(aggregator, 1005, 80, 5001);
+    foldPush(aggregator, 1010, 101, 5003);
+
+    TEST_ASSERT_EQUAL_UINT16(3, aggregator.getPushCount());
+    TEST_ASSERT_EQUAL_UINT32(1000, aggregator.getFirstTime());
+    TEST_ASSERT_EQUAL_UINT32(1010, aggregator.getLastTime());
+    TEST_ASSERT_EQUAL_UINT8(2, aggregator.getCount());
+
+    // instantaneous power: minimum, maximum and mean (301 / 3 rounded)
+    SmAggregate const& power = aggregator.getAt(0);
+
+    TEST_ASSERT_FALSE(power.counter);
+    TEST_ASSERT_EQUAL_UINT16(3, power.count);
+    TEST_ASSERT_EQUAL_INT64(80, power.min);
+    TEST_ASSERT_EQUAL_INT64(120, power.max);
+    TEST_ASSERT_EQUAL_INT64(100, power.getMean());
+
+    // energy counter: first and last value
+    SmAggregate const& energy = aggregator.getAt(1);
+
+    TEST_ASSERT_TRUE(energy.counter);
+    TEST_ASSERT_EQUAL_INT64(5000, energy.first);
+    TEST_ASSERT_EQUAL_INT64(5003, energy.last);
+
+    // a new window drops the statistics
+    aggregator.reset();
+
+    TEST_ASSERT_EQUAL_UINT16(0, aggregator.getPushCount());
+    TEST_ASSERT_EQUAL_UINT8(0, aggregator.getCount());
+}
+
+void test_aggregator_exponent(void)
+{
+    SmAggregator aggregator;
+
+    aggregator.reset();
+
+    // 12.34 A, then 15 A with a coarser exponent, then 9.87 A with the finer exponent again
+    aggregator.addRecordTime(10, 1000);
+    aggregator.addRecordScaled(10, scaledValue(1234, -2, SmUnit::SMUNIT_AMPERE));
+    aggregator.addRecordTime(10, 1005);
+    aggregator.addRecordScaled(10, scaledValue(15, 0, SmUnit::SMUNIT_AMPERE));
+    aggregator.addRecordTime(10, 1010);
+    aggregator.addRecordScaled(10, scaledValue(987, -2, SmUnit::SMUNIT_AMPERE));
+
+    SmAggregate const& current = aggregator.getAt(0);
+
+    TEST_ASSERT_EQUAL_INT8(0, current.exponent);
+    TEST_ASSERT_EQUAL_INT64(10, current.min);
+    TEST_ASSERT_EQUAL_INT64(15, current.max);
+    TEST_ASSERT_EQUAL_INT64(12, current.getMean());
+}
+
+void test_aggregator_register_changed(void)
+{
+    SmAggregator aggregator;
+
+    aggregator.reset();
+
+    foldPush(aggregator, 1000, 120, 5000);
+
+    // the register at the position of the power is now a voltage, its statistics start again
+    aggregator.addRecordTime(10, 1005);
+    aggregator.addRecordScaled(10, scaledValue(230, 0, SmUnit::SMUNIT_VOLT));
+    aggregator.addRecordScaled(10, scaledValue(5002, 0, SmUnit::SMUNIT_WATTHOUR));
+
+    TEST_ASSERT_EQUAL_UINT8(2, aggregator.getCount());
+    TEST_ASSERT_EQUAL_UINT16(1, aggregator.getAt(0).count);
+    TEST_ASSERT_EQUAL_INT64(230, aggregator.getAt(0).min);
+    TEST_ASSERT_EQUAL_UINT16(2, aggregator.getAt(1).count);
+    TEST_ASSERT_EQUAL_INT64(5000, aggregator.getAt(1).first);
+    TEST_ASSERT_EQUAL_INT64(5002, aggregator.getAt(1).last);
+}
+
+static GbtData gbtDataAggregator;
+
+void test_aggregator_e450(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, gbtDataAggregator.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+
+    SmProfile const& e450 = SmProfiles::getDefault();
+    SmPushExtractor extractor;
+    SmAggregator aggregator;
+
+    aggregator.reset();
+
+    for(uint8_t i = 0; i < 3; i++)
+    {
+        TEST_ASSERT_TRUE(extractor.extract(gbtDataAggregator, e450, e450.channel, true, aggregator));
+    }
+
+    // the 12 numeric registers of the push, the octet strings are not aggregated
+    TEST_ASSERT_EQUAL_UINT16(3, aggregator.getPushCount());
+    TEST_ASSERT_EQUAL_UINT8(12, aggregator.getCount());
+
+    uint8_t counters = 0;
+
+    for(uint8_t i = 0; i < aggregator.getCount(); i++)
+    {
+        SmAggregate const& aggregate = aggregator.getAt(i);
+
+        TEST_ASSERT_EQUAL_UINT16(3, aggregate.count);
+        TEST_ASSERT_EQUAL_INT64(aggregate.min, aggregate.max);
+        TEST_ASSERT_EQUAL_INT64(aggregate.min, aggregate.getMean());
+        TEST_ASSERT_EQUAL_INT64(aggregate.first, aggregate.last);
+
+        counters += aggregate.counter ? 1 : 0;
+    }
+
+    // active energy +A/-A and reactive energy QI to QIV
+    TEST_ASSERT_EQUAL_UINT8(6, counters);
+}
@@ -0,0 +1,4 @@
+void test_aggregator_statistics(void);
+void test_aggregator_exponent(void);
+void test_aggregator_register_changed(void);
+void test_aggregator_e450(void);
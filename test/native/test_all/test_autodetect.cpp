@@ -0,0 +1,181 @@
+#include "unity.h"
+
+#include <string.h>
+
+#include "test_autodetect.h"
+#include "test_fixtures.h"
+
+#include "hdlc.h"
+#include "smautodetect.h"
+
+static SmAutoDetect autoDetect;
+static GbtData gbtDataAutoDetect;
+
+// content of an hdlc frame of the E450 (destination 0x33ff, source 0x01) with the first GBT block of the push
+static size_t buildE450Frame(uint8_t* frame, bool const llcHeader)
+{
+    uint8_t const header[] = { 0xa0, 0x84, 0xce, 0xff, 0x03, 0x13, 0x00, 0x00 };
+    uint8_t const llc[] = { 0xe6, 0xe7, 0x00 };
+    uint8_t const block[] = { 0xe0, 0x40, 0x00, 0x01, 0x00, 0x00, 0x20 };
+
+    size_t size = 0;
+
+    memcpy(frame, header, sizeof(header));
+    size += sizeof(header);
+
+    if(llcHeader)
+    {
+        memcpy(frame + size, llc, sizeof(llc));
+        size += sizeof(llc);
+    }
+
+    memcpy(frame + size, block, sizeof(block));
+    size += sizeof(block);
+
+    memcpy(frame + size, e450GbtPdu, 0x20);
+
+    return size + 0x20;
+}
+
+// passes the frames of the hdlc receiver to the detection
+static void autoDetectFrameHandler(uint8_t const* data, size_t const size, bool const valid)
+{
+    autoDetect.hdlcFrameReceived(data, size, valid);
+}
+
+static Hdlc hdlcAutoDetect(&autoDetectFrameHandler);
+
+// receives the recorded frames of a real E450 push (with the LLC header)
+static void receiveE450Frames(void)
+{
+    hdlcAutoDetect.bytesReceiver(e450HdlcFrames, E450_HDLC_SIZE);
+}
+
+void test_autodetect_reject_settings(void)
+{
+    uint8_t garbage[] = { 0x12, 0x34, 0x56, 0x78, 0x9a };
+
+    autoDetect.start();
+
+    TEST_ASSERT_EQUAL_UINT32(2400, autoDetect.getSetting().baudRate);
+    TEST_ASSERT_TRUE(autoDetect.getSetting().serialFormat == SmSerialFormat::SMSERIAL_8E1);
+
+    // invalid frames only reject the serial setting
+    for(uint8_t i = 0; i < SmAutoDetect::MAX_INVALID_FRAMES; i++)
+    {
+        TEST_ASSERT_FALSE(autoDetect.isRejected());
+
+        autoDetect.hdlcFrameReceived(garbage, sizeof(garbage), false);
+    }
+
+    TEST_ASSERT_TRUE(autoDetect.isRejected());
+
+    // all settings are tried once
+    uint8_t settings = 1;
+
+    while(autoDetect.nextSetting())
+    {
+        TEST_ASSERT_FALSE(autoDetect.isRejected());
+
+        settings++;
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(5, settings);
+    TEST_ASSERT_EQUAL_UINT32(115200, autoDetect.getSetting().baudRate);
+    TEST_ASSERT_FALSE(autoDetect.isDetected());
+}
+
+void test_autodetect_fingerprint(void)
+{
+    uint8_t frame[64];
+
+    autoDetect.start();
+
+    // a valid frame keeps the setting even with invalid frames around it
+    autoDetect.hdlcFrameReceived(frame, buildE450Frame(frame, false), true);
+
+    for(uint8_t i = 0; i < SmAutoDetect::MAX_INVALID_FRAMES; i++)
+    {
+        autoDetect.hdlcFrameReceived(frame, 4, false);
+    }
+
+    TEST_ASSERT_FALSE(autoDetect.isRejected());
+    TEST_ASSERT_EQUAL_UINT32(0x33ff, autoDetect.getDestination());
+    TEST_ASSERT_EQUAL_UINT32(0x01, autoDetect.getSource());
+    TEST_ASSERT_FALSE(autoDetect.hasLlcHeader());
+    TEST_ASSERT_EQUAL_UINT8(SmAutoDetect::APDU_GBT, autoDetect.getApduTag());
+
+    // the LLC header is skipped for the APDU tag
+    autoDetect.nextSetting();
+
+    autoDetect.hdlcFrameReceived(frame, buildE450Frame(frame, true), true);
+
+    TEST_ASSERT_TRUE(autoDetect.hasLlcHeader());
+    TEST_ASSERT_EQUAL_UINT8(SmAutoDetect::APDU_GBT, autoDetect.getApduTag());
+
+    // the frames of a real E450 match the fingerprint of its profile
+    SmProfile const& e450 = SmProfiles::getDefault();
+
+    autoDetect.start();
+
+    receiveE450Frames();
+
+    TEST_ASSERT_FALSE(autoDetect.isRejected());
+    TEST_ASSERT_EQUAL_UINT32(e450.fingerprint.destination, autoDetect.getDestination());
+    TEST_ASSERT_EQUAL(e450.fingerprint.llcHeader, autoDetect.hasLlcHeader());
+    TEST_ASSERT_TRUE(autoDetect.hasLlcHeader());
+    TEST_ASSERT_EQUAL_UINT8(SmAutoDetect::APDU_GBT, autoDetect.getApduTag());
+}
+
+void test_autodetect_profile(void)
+{
+    autoDetect.start();
+
+    // a push without fingerprint (no valid frame with this setting) is not taken
+    TEST_ASSERT_FALSE(autoDetect.pushReceived(gbtDataAutoDetect, e450GbtPdu, E450_GBTPDU_SIZE));
+
+    receiveE450Frames();
+
+    TEST_ASSERT_TRUE(autoDetect.pushReceived(gbtDataAutoDetect, e450GbtPdu, E450_GBTPDU_SIZE));
+    TEST_ASSERT_TRUE(autoDetect.isDetected());
+    TEST_ASSERT_EQUAL_UINT8(SmProfiles::SMPROFILE_LG_E450, autoDetect.getProfileId());
+    TEST_ASSERT_EQUAL_UINT32(2400, autoDetect.getSetting().baudRate);
+
+    // an unknown identifier is skipped as by the read cycle, a truncated push is rejected
+    uint8_t pdu[E450_GBTPDU_SIZE + 1];
+
+    memcpy(pdu, e450GbtPdu, E450_GBTPDU_SIZE);
+    pdu[E450_GBTPDU_SIZE] = 0xff;
+
+    autoDetect.start();
+
+    receiveE450Frames();
+
+    TEST_ASSERT_FALSE(autoDetect.pushReceived(gbtDataAutoDetect, e450GbtPdu, E450_GBTPDU_SIZE - 2));
+    TEST_ASSERT_FALSE(autoDetect.isDetected());
+    TEST_ASSERT_TRUE(autoDetect.pushReceived(gbtDataAutoDetect, pdu, sizeof(pdu)));
+    TEST_ASSERT_EQUAL_UINT8(SmProfiles::SMPROFILE_LG_E450, autoDetect.getProfileId());
+}
+
+void test_autodetect_unknown_push(void)
+{
+    uint8_t pdu[E450_GBTPDU_SIZE];
+
+    autoDetect.start();
+
+    receiveE450Frames();
+
+    // the push parses, but no OBIS code of the push is known to a profile (medium 9 instead of 0 and 1)
+    memcpy(pdu, e450GbtPdu, sizeof(pdu));
+
+    for(size_t i = 0; i + 2 < sizeof(pdu); i++)
+    {
+        if(pdu[i] == 0x09 && pdu[i + 1] == 0x06)
+        {
+            pdu[i + 2] = 0x09;
+        }
+    }
+
+    TEST_ASSERT_FALSE(autoDetect.pushReceived(gbtDataAutoDetect, pdu, sizeof(pdu)));
+    TEST_ASSERT_FALSE(autoDetect.isDetected());
+}
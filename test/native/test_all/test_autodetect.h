@@ -0,0 +1,4 @@
+void test_autodetect_reject_settings(void);
+void test_autodetect_fingerprint(void);
+void test_autodetect_profile(void);
+void test_autodetect_unknown_push(void);
@@ -0,0 +1,103 @@
+#include "unity.h"
+
+#include <string.h>
+
+#include "test_bytecursor.h"
+#include "test_fixtures.h"
+
+#include "bytecursor.h"
+#include "gbtblock.h"
+#include "gbtdata.h"
+#include "gbtuint32.h"
+#include "gbtoctetstring.h"
+
+void test_bytecursor_big_endian(void)
+{
+    uint8_t const data[] = { 0x06, 0x12, 0x34, 0x56, 0x78, 0x9a };
+
+    ByteCursor cursor(data, sizeof(data));
+
+    TEST_ASSERT_TRUE(cursor.has(6));
+    TEST_ASSERT_FALSE(cursor.has(7));
+    TEST_ASSERT_EQUAL_HEX16(0x1234, cursor.peekUint16(1));
+    TEST_ASSERT_EQUAL_HEX32(0x12345678, cursor.peekUint32(1));
+
+    // unaligned fetch
+    TEST_ASSERT_EQUAL_HEX32(0x3456789a, ByteCursor::loadUint32(data + 2));
+
+    GbtUint32 gbtUint32;
+
+    TEST_ASSERT_TRUE(gbtUint32.parse(cursor, 0, 0));
+    TEST_ASSERT_EQUAL_HEX32(0x12345678, gbtUint32.getValue());
+    TEST_ASSERT_EQUAL_INT(5, cursor.position());
+    TEST_ASSERT_EQUAL_INT(1, cursor.remaining());
+
+    // one byte left, the value is truncated and the cursor stays
+    TEST_ASSERT_FALSE(gbtUint32.parse(cursor, 0, 0));
+    TEST_ASSERT_EQUAL_INT(5, cursor.position());
+
+    // octet string announcing more octets than available
+    uint8_t const string[] = { 0x09, 0x08, 0x36, 0x30, 0x32 };
+    ByteCursor stringCursor(string, sizeof(string));
+    GbtOctetString gbtOctetString;
+
+    TEST_ASSERT_FALSE(gbtOctetString.parse(stringCursor, 0, 0));
+    TEST_ASSERT_EQUAL_INT(0, stringCursor.position());
+}
+
+void test_bytecursor_truncated_pdu(void)
+{
+    GbtData gbtData;
+    uint16_t malformedCount = 0;
+
+    // every truncation of the push, each one in a buffer of the exact size (sanitizers catch reads past the end)
+    for(size_t size = 1; size < E450_GBTPDU_SIZE; size++)
+    {
+        uint8_t* truncated = new uint8_t[size];
+
+        memcpy(truncated, e450GbtPdu, size);
+
+        int result = gbtData.parse(truncated, size);
+
+        delete[] truncated;
+
+        // cut between two elements the parsing succeeds with less values
+        TEST_ASSERT_TRUE(result == GbtParser::GBTPARSE_MALFORMED || result == 0);
+        TEST_ASSERT_TRUE(gbtData.getValueCount() <= 74);
+
+        if(result == GbtParser::GBTPARSE_MALFORMED)
+        {
+            malformedCount++;
+        }
+    }
+
+    // only the cuts between the 93 elements (long invoke id, date time, 16 structures, 1 array, 74 values) parse
+    TEST_ASSERT_EQUAL_UINT16(E450_GBTPDU_SIZE - 1 - 92, malformedCount);
+
+    TEST_ASSERT_EQUAL_INT(0, gbtData.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+    TEST_ASSERT_EQUAL_UINT8(74, gbtData.getValueCount());
+}
+
+void test_bytecursor_truncated_gbtblock(void)
+{
+    // last block 1, announces 4 bytes of content but carries 2
+    uint8_t const block[] = { 0xe0, 0x80, 0x00, 0x01, 0x00, 0x00, 0x04, 0x0f, 0x00 };
+
+    GbtBlock truncated(block, sizeof(block));
+
+    TEST_ASSERT_FALSE(truncated.isComplete());
+
+    GbtBlock complete(block, 7 + 0);
+    GbtBlock header(block, 6);
+
+    TEST_ASSERT_FALSE(header.isComplete());
+    TEST_ASSERT_FALSE(complete.isComplete());
+
+    uint8_t const full[] = { 0xe0, 0x80, 0x00, 0x01, 0x00, 0x00, 0x02, 0x0f, 0x00 };
+
+    GbtBlock fullBlock(full, sizeof(full));
+
+    TEST_ASSERT_TRUE(fullBlock.isComplete());
+    TEST_ASSERT_EQUAL_UINT16(1, fullBlock.getBlockNumber());
+    TEST_ASSERT_TRUE(fullBlock.isLastBlock());
+}
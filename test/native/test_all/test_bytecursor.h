@@ -0,0 +1,3 @@
+void test_bytecursor_big_endian(void);
+void test_bytecursor_truncated_pdu(void);
+void test_bytecursor_truncated_gbtblock(void);
@@ -0,0 +1,289 @@
+#include "unity.h"
+
+#include "test_deltacodec.h"
+#include "test_fixtures.h"
+
+#include "gbtdata.h"
+#include "smdeltadecoder.h"
+#include "smdeltaencoder.h"
+#include "smprofile.h"
+#include "smpushextractor.h"
+#include "smvarint.h"
+
+// one push with the active power, the active energy and the voltage L1
+static void addPush(SmDeltaEncoder& encoder, uint32_t const time, int32_t const power, int32_t const energy, int32_t const voltage)
+{
+    encoder.addRecordTime(10, time);
+    encoder.addRecordScaled(10, scaledValue(power, 0, SmUnit::SMUNIT_WATT));
+    encoder.addRecordScaled(10, scaledValue(energy, 0, SmUnit::SMUNIT_WATTHOUR));
+    encoder.addRecordScaled(10, scaledValue(voltage, -1, SmUnit::SMUNIT_VOLT));
+}
+
+// the decoded frame has the values of the push
+static void assertFrame(SmDeltaFrame const& frame, uint32_t const time, int32_t const power, int32_t const energy, int32_t const voltage)
+{
+    TEST_ASSERT_EQUAL_UINT32(time, frame.getTime());
+    TEST_ASSERT_EQUAL_UINT8(3, frame.getCount());
+    TEST_ASSERT_EQUAL_INT64(power, frame.getAt(0).value);
+    TEST_ASSERT_EQUAL_INT64(energy, frame.getAt(1).value);
+    TEST_ASSERT_EQUAL_INT64(voltage, frame.getAt(2).value);
+    TEST_ASSERT_EQUAL_INT8(-1, frame.getAt(2).exponent);
+    TEST_ASSERT_TRUE(frame.getAt(2).unit == SmUnit::SMUNIT_VOLT);
+}
+
+void test_deltacodec_varint(void)
+{
+    TEST_ASSERT_EQUAL_UINT64(0, SmVarint::zigzag(0));
+    TEST_ASSERT_EQUAL_UINT64(1, SmVarint::zigzag(-1));
+    TEST_ASSERT_EQUAL_UINT64(2, SmVarint::zigzag(1));
+    TEST_ASSERT_EQUAL_UINT64(UINT64_MAX, SmVarint::zigzag(INT64_MIN));
+    TEST_ASSERT_EQUAL_INT64(INT64_MIN, SmVarint::unzigzag(UINT64_MAX));
+    TEST_ASSERT_EQUAL_INT64(-64, SmVarint::unzigzag(SmVarint::zigzag(-64)));
+
+    TEST_ASSERT_EQUAL_UINT8(1, SmVarint::getSize(127));
+    TEST_ASSERT_EQUAL_UINT8(2, SmVarint::getSize(128));
+    TEST_ASSERT_EQUAL_UINT8(SmVarint::MAX_SIZE, SmVarint::getSize(UINT64_MAX));
+
+    uint8_t buffer[SmVarint::MAX_SIZE];
+    size_t position = 0;
+
+    // 300 is 0xac 0x02, the low group first
+    TEST_ASSERT_TRUE(SmVarint::write(buffer, sizeof(buffer), position, 300));
+    TEST_ASSERT_EQUAL_size_t(2, position);
+    TEST_ASSERT_EQUAL_HEX8(0xac, buffer[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x02, buffer[1]);
+
+    ByteCursor cursor(buffer, position);
+    uint64_t value;
+
+    TEST_ASSERT_TRUE(SmVarint::read(cursor, value));
+    TEST_ASSERT_EQUAL_UINT64(300, value);
+
+    // a value which does not fit is not written, a truncated value is not read
+    position = sizeof(buffer) - 1;
+
+    TEST_ASSERT_FALSE(SmVarint::write(buffer, sizeof(buffer), position, 300));
+    TEST_ASSERT_EQUAL_size_t(sizeof(buffer) - 1, position);
+
+    ByteCursor truncated(buffer, 1);
+
+    TEST_ASSERT_FALSE(SmVarint::read(truncated, value));
+}
+
+static GbtData gbtDataDelta;
+
+void test_deltacodec_e450_keyframe(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, gbtDataDelta.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+
+    SmPushExtractor extractor;
+    SmDeltaEncoder encoder;
+    SmDeltaDecoder decoder;
+    SmDeltaFrame frame;
+    uint8_t buffer[222];
+
+    TEST_ASSERT_TRUE(extractor.extract(gbtDataDelta, SmProfiles::getDefault(), 10, true, encoder));
+
+    size_t size = encoder.encode(buffer, sizeof(buffer));
+
+    // the first frame is a keyframe with the 14 values of the push
+    TEST_ASSERT_TRUE(size > 0);
+    TEST_ASSERT_EQUAL_HEX8(SmDeltaEncoder::HEADER_KEYFRAME, buffer[0]);
+    TEST_ASSERT_EQUAL_UINT8(14, buffer[1]);
+
+    TEST_ASSERT_TRUE(decoder.decode(buffer, size, frame));
+    TEST_ASSERT_TRUE(decoder.isKeyframe());
+    TEST_ASSERT_EQUAL_UINT32(gbtDataDelta.getDateTime().asUnixTimeStamp(), frame.getTime());
+    TEST_ASSERT_EQUAL_UINT8(14, frame.getCount());
+
+    // the device name is sent as octet string, the registers as fixed-point values
+    uint8_t texts = 0;
+
+    for(uint8_t i = 0; i < frame.getCount(); i++)
+    {
+        SmDeltaValue const& value = frame.getAt(i);
+
+        TEST_ASSERT_EQUAL_UINT8(10, value.channel);
+
+        if(value.kind == SmDeltaKind::SMDELTAKIND_TEXT)
+        {
+            texts++;
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(2, texts);
+
+    // the same push once acknowledged is a delta frame without changed value: header, reference, time, bitmap
+    encoder.acknowledged();
+
+    TEST_ASSERT_TRUE(extractor.extract(gbtDataDelta, SmProfiles::getDefault(), 10, true, encoder));
+
+    size = encoder.encode(buffer, sizeof(buffer));
+
+    TEST_ASSERT_EQUAL_size_t(5, size);
+    TEST_ASSERT_EQUAL_HEX8(0x01, buffer[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, buffer[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, buffer[3]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, buffer[4]);
+
+    SmDeltaFrame again;
+
+    TEST_ASSERT_TRUE(decoder.decode(buffer, size, again));
+    TEST_ASSERT_FALSE(decoder.isKeyframe());
+    TEST_ASSERT_TRUE(again.hasSameLayout(frame));
+
+    for(uint8_t i = 0; i < frame.getCount(); i++)
+    {
+        TEST_ASSERT_TRUE(again.isEqual(i, frame));
+    }
+}
+
+void test_deltacodec_delta_frame(void)
+{
+    SmDeltaEncoder encoder;
+    SmDeltaDecoder decoder;
+    SmDeltaFrame frame;
+    uint8_t buffer[64];
+
+    addPush(encoder, 1000, 1500, 2000000, 2301);
+
+    size_t size = encoder.encode(buffer, sizeof(buffer));
+
+    TEST_ASSERT_TRUE(decoder.decode(buffer, size, frame));
+    assertFrame(frame, 1000, 1500, 2000000, 2301);
+
+    encoder.acknowledged();
+
+    // the voltage is unchanged, the power falls and the energy rises by a few Wh
+    addPush(encoder, 1900, 1400, 2000350, 2301);
+
+    size = encoder.encode(buffer, sizeof(buffer));
+
+    // sequence 1 against 0, time +900 (2 bytes), bitmap 0b011, power -100 (2 bytes), energy +350 (2 bytes)
+    TEST_ASSERT_EQUAL_size_t(9, size);
+    TEST_ASSERT_EQUAL_HEX8(0x01, buffer[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, buffer[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x03, buffer[4]);
+
+    TEST_ASSERT_TRUE(decoder.decode(buffer, size, frame));
+    TEST_ASSERT_EQUAL_UINT8(1, decoder.getSequence());
+    assertFrame(frame, 1900, 1400, 2000350, 2301);
+}
+
+void test_deltacodec_unacknowledged(void)
+{
+    SmDeltaEncoder encoder;
+    SmDeltaDecoder decoder;
+    SmDeltaFrame frame;
+    uint8_t buffer[64];
+
+    addPush(encoder, 1000, 1500, 2000000, 2301);
+
+    size_t size = encoder.encode(buffer, sizeof(buffer));
+
+    TEST_ASSERT_TRUE(decoder.decode(buffer, size, frame));
+
+    encoder.acknowledged();
+
+    // frame 1 is lost and not acknowledged
+    addPush(encoder, 1900, 1400, 2000350, 2301);
+
+    TEST_ASSERT_TRUE(encoder.encode(buffer, sizeof(buffer)) > 0);
+
+    // frame 2 is still the difference to frame 0, the decoder does not need frame 1
+    addPush(encoder, 2800, 1600, 2000700, 2299);
+
+    size = encoder.encode(buffer, sizeof(buffer));
+
+    TEST_ASSERT_EQUAL_HEX8(0x02, buffer[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, buffer[1]);
+
+    TEST_ASSERT_TRUE(decoder.decode(buffer, size, frame));
+    assertFrame(frame, 2800, 1600, 2000700, 2299);
+
+    // without acknowledgement for MAX_REFERENCE_AGE frames the reference is dropped, the next frame is a keyframe
+    for(uint8_t i = 0; i < SmDeltaEncoder::MAX_REFERENCE_AGE - 2; i++)
+    {
+        TEST_ASSERT_FALSE(encoder.isKeyframeDue());
+
+        addPush(encoder, 3700 + i * 900, 1600, 2000700, 2299);
+
+        TEST_ASSERT_TRUE(encoder.encode(buffer, sizeof(buffer)) > 0);
+    }
+
+    addPush(encoder, 20000, 1600, 2000700, 2299);
+
+    TEST_ASSERT_TRUE(encoder.isKeyframeDue());
+}
+
+void test_deltacodec_keyframe_interval(void)
+{
+    SmDeltaEncoder encoder;
+    uint8_t buffer[64];
+
+    encoder.setKeyframeInterval(4);
+
+    // every 4th frame is a keyframe although all frames are acknowledged
+    for(uint8_t i = 0; i < 9; i++)
+    {
+        addPush(encoder, 1000 + i * 900, 1500, 2000000 + i, 2301);
+
+        TEST_ASSERT_TRUE(encoder.encode(buffer, sizeof(buffer)) > 0);
+        TEST_ASSERT_EQUAL(i % 4 == 0, (buffer[0] & SmDeltaEncoder::HEADER_KEYFRAME) != 0);
+        TEST_ASSERT_EQUAL_UINT8(i, encoder.getSequence());
+
+        encoder.acknowledged();
+    }
+
+    // another register (the exponent of the voltage changes) needs a keyframe
+    encoder.addRecordTime(10, 10000);
+    encoder.addRecordScaled(10, scaledValue(1500, 0, SmUnit::SMUNIT_WATT));
+    encoder.addRecordScaled(10, scaledValue(2000009, 0, SmUnit::SMUNIT_WATTHOUR));
+    encoder.addRecordScaled(10, scaledValue(230, 0, SmUnit::SMUNIT_VOLT));
+
+    TEST_ASSERT_TRUE(encoder.isKeyframeDue());
+
+    // after a reset there is no reference
+    encoder.acknowledged();
+    encoder.reset();
+
+    addPush(encoder, 11000, 1500, 2000010, 2301);
+
+    TEST_ASSERT_TRUE(encoder.isKeyframeDue());
+}
+
+void test_deltacodec_invalid_frame(void)
+{
+    SmDeltaEncoder encoder;
+    SmDeltaDecoder decoder;
+    SmDeltaFrame frame;
+    uint8_t keyframe[64];
+    uint8_t delta[64];
+
+    addPush(encoder, 1000, 1500, 2000000, 2301);
+
+    size_t keyframeSize = encoder.encode(keyframe, sizeof(keyframe));
+
+    encoder.acknowledged();
+
+    addPush(encoder, 1900, 1400, 2000350, 2301);
+
+    size_t deltaSize = encoder.encode(delta, sizeof(delta));
+
+    // the reference of the delta frame was not received
+    TEST_ASSERT_FALSE(decoder.decode(delta, deltaSize, frame));
+
+    // truncated and too long frames are rejected
+    TEST_ASSERT_FALSE(decoder.decode(keyframe, keyframeSize - 1, frame));
+    TEST_ASSERT_FALSE(decoder.decode(keyframe, keyframeSize + 1, frame));
+    TEST_ASSERT_FALSE(decoder.decode(keyframe, 0, frame));
+
+    TEST_ASSERT_TRUE(decoder.decode(keyframe, keyframeSize, frame));
+    TEST_ASSERT_FALSE(decoder.decode(delta, deltaSize - 1, frame));
+    TEST_ASSERT_TRUE(decoder.decode(delta, deltaSize, frame));
+
+    // a frame which does not fit into the buffer is not encoded
+    addPush(encoder, 2800, 1600, 2000700, 2299);
+
+    TEST_ASSERT_EQUAL_size_t(0, encoder.encode(delta, 4));
+}
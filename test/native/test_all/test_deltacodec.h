@@ -0,0 +1,6 @@
+void test_deltacodec_varint(void);
+void test_deltacodec_e450_keyframe(void);
+void test_deltacodec_delta_frame(void);
+void test_deltacodec_unacknowledged(void);
+void test_deltacodec_keyframe_interval(void);
+void test_deltacodec_invalid_frame(void);
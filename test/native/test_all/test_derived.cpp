@@ -0,0 +1,144 @@
+#include "unity.h"
+
+#include <string.h>
+
+#include "test_derived.h"
+#include "test_fixtures.h"
+
+#include "gbtdata.h"
+#include "smderived.h"
+#include "smprofile.h"
+#include "smpushlayout.h"
+#include "smscaler.h"
+
+static ParsedPush pushDerived;
+
+// parses the push and derives from it, the uplink of the push is sent unless sent is false
+static bool derivePush(SmDerived& derived, uint8_t const minute, uint32_t const energyImport, uint32_t const energyExport, bool const sent = true)
+{
+    uint8_t pdu[128];
+
+    size_t size = buildE450Push(pdu, minute, 500, energyImport, energyExport);
+
+    pushDerived.parse(pdu, size);
+
+    bool updated = derived.update(pushDerived.gbtData, pushDerived.layout, 0);
+
+    if(sent)
+    {
+        derived.uplinkSent();
+    }
+
+    return updated;
+}
+
+// value of a fixed-point value in units of 10^exponent
+static int64_t valueAt(SmScaledValue const& value, int8_t const exponent)
+{
+    return SmScaler::rescale(value.mantissa, value.exponent, exponent);
+}
+
+void test_derived_first_push(void)
+{
+    SmDerived derived;
+
+    derived.reset();
+
+    // no previous push, nothing derived
+    TEST_ASSERT_FALSE(derivePush(derived, 30, 10000, 2000));
+    TEST_ASSERT_EQUAL_UINT8(0, derived.getCount());
+    TEST_ASSERT_EQUAL_UINT32(0, derived.getInterval());
+    TEST_ASSERT_FALSE(derived.hasBalance());
+}
+
+void test_derived_interval(void)
+{
+    SmDerived derived;
+
+    derived.reset();
+
+    derivePush(derived, 30, 10000, 2000);
+
+    // 15 minutes later, 1000 Wh imported and 250 Wh exported
+    TEST_ASSERT_TRUE(derivePush(derived, 45, 11000, 2250));
+    TEST_ASSERT_EQUAL_UINT32(900, derived.getInterval());
+
+    // the power register is not a counter
+    TEST_ASSERT_EQUAL_UINT8(2, derived.getCount());
+
+    SmDerivedValue const& energyImport = derived.getAt(0);
+
+    TEST_ASSERT_EQUAL_UINT8(10, energyImport.channel);
+    TEST_ASSERT_EQUAL_UINT8((uint8_t) SmUnit::SMUNIT_WATTHOUR, (uint8_t) energyImport.delta.unit);
+    TEST_ASSERT_EQUAL_INT64(1000, valueAt(energyImport.delta, 0));
+    TEST_ASSERT_EQUAL_UINT8((uint8_t) SmUnit::SMUNIT_WATT, (uint8_t) energyImport.averagePower.unit);
+    TEST_ASSERT_EQUAL_INT64(4000, valueAt(energyImport.averagePower, 0));
+
+    SmDerivedValue const& energyExport = derived.getAt(1);
+
+    TEST_ASSERT_EQUAL_INT64(250, valueAt(energyExport.delta, 0));
+    TEST_ASSERT_EQUAL_INT64(1000, valueAt(energyExport.averagePower, 0));
+
+    TEST_ASSERT_TRUE(derived.hasBalance());
+    TEST_ASSERT_EQUAL_INT64(750, valueAt(derived.getBalance(), 0));
+
+    // 1 Wh in 15 minutes keeps its decimals: 4 W
+    TEST_ASSERT_TRUE(derivePush(derived, 59, 11001, 2251));
+    TEST_ASSERT_EQUAL_UINT32(840, derived.getInterval());
+    TEST_ASSERT_EQUAL_INT64(4286, valueAt(derived.getAt(0).averagePower, -3));
+    TEST_ASSERT_EQUAL_INT64(0, valueAt(derived.getBalance(), 0));
+}
+
+void test_derived_counter_backwards(void)
+{
+    SmDerived derived;
+
+    derived.reset();
+
+    derivePush(derived, 30, 10000, 2000);
+
+    // the import counter went backwards (e.g. a replaced meter), only the export is derived
+    TEST_ASSERT_TRUE(derivePush(derived, 45, 500, 2100));
+    TEST_ASSERT_EQUAL_UINT8(1, derived.getCount());
+    TEST_ASSERT_EQUAL_INT64(100, valueAt(derived.getAt(0).delta, 0));
+    TEST_ASSERT_FALSE(derived.hasBalance());
+
+    // the counter is the new reference
+    TEST_ASSERT_TRUE(derivePush(derived, 50, 600, 2100));
+    TEST_ASSERT_EQUAL_UINT8(2, derived.getCount());
+    TEST_ASSERT_EQUAL_INT64(100, valueAt(derived.getAt(0).delta, 0));
+}
+
+void test_derived_no_time_advance(void)
+{
+    SmDerived derived;
+
+    derived.reset();
+
+    derivePush(derived, 30, 10000, 2000);
+
+    // the same time stamp has no interval
+    TEST_ASSERT_FALSE(derivePush(derived, 30, 10100, 2000));
+    TEST_ASSERT_EQUAL_UINT8(0, derived.getCount());
+}
+
+void test_derived_uplink_failed(void)
+{
+    SmDerived derived;
+
+    derived.reset();
+
+    // the first push is not sent, it is no reference
+    TEST_ASSERT_FALSE(derivePush(derived, 15, 9000, 1900, false));
+    TEST_ASSERT_FALSE(derivePush(derived, 30, 10000, 2000));
+
+    // the uplink of this push fails, the reference stays at the sent push
+    TEST_ASSERT_TRUE(derivePush(derived, 45, 11000, 2250, false));
+    TEST_ASSERT_EQUAL_INT64(1000, valueAt(derived.getAt(0).delta, 0));
+
+    // the next push carries the consumption since the sent push
+    TEST_ASSERT_TRUE(derivePush(derived, 59, 12000, 2300));
+    TEST_ASSERT_EQUAL_UINT32(1740, derived.getInterval());
+    TEST_ASSERT_EQUAL_INT64(2000, valueAt(derived.getAt(0).delta, 0));
+    TEST_ASSERT_EQUAL_INT64(300, valueAt(derived.getAt(1).delta, 0));
+}
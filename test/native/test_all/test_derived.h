@@ -0,0 +1,5 @@
+void test_derived_first_push(void);
+void test_derived_interval(void);
+void test_derived_counter_backwards(void);
+void test_derived_no_time_advance(void);
+void test_derived_uplink_failed(void);
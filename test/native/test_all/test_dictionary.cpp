@@ -0,0 +1,243 @@
+#include <string.h>
+
+#include "unity.h"
+
+#include "test_dictionary.h"
+#include "test_fixtures.h"
+
+#include "gbtdata.h"
+#include "smdictionarydecoder.h"
+#include "smdictionarysession.h"
+#include "smprofile.h"
+#include "smpushextractor.h"
+
+static GbtData gbtDataDictionary;
+
+// takes the push into the session with the layout of the default profile
+static void updateSession(SmDictionarySession& session, uint8_t const* pdu, size_t const size)
+{
+    SmPushExtractor extractor;
+
+    TEST_ASSERT_EQUAL_INT(0, gbtDataDictionary.parse(pdu, size));
+    TEST_ASSERT_TRUE(extractor.updateLayout(gbtDataDictionary, SmProfiles::getDefault()));
+    TEST_ASSERT_TRUE(session.update(gbtDataDictionary, extractor.getLayout()));
+}
+
+void test_dictionary_e450_roundtrip(void)
+{
+    SmDictionarySession session;
+    SmDictionaryDecoder decoder;
+    SmDictionaryValues values;
+    uint8_t dictionary[222];
+    uint8_t buffer[222];
+
+    updateSession(session, e450GbtPdu, E450_GBTPDU_SIZE);
+
+    size_t dictionarySize = session.encodeDictionary(dictionary, sizeof(dictionary));
+    size_t valuesSize = session.encodeValues(buffer, sizeof(buffer));
+
+    TEST_ASSERT_TRUE(dictionarySize > 0);
+    TEST_ASSERT_EQUAL_size_t(session.getDictionary().getValuesSize(), valuesSize);
+
+    // the values are rejected till the dictionary is received
+    TEST_ASSERT_FALSE(decoder.decodeValues(buffer, valuesSize, values));
+    TEST_ASSERT_TRUE(decoder.addDictionary(dictionary, dictionarySize));
+    TEST_ASSERT_TRUE(decoder.isKnown(session.getHash()));
+    TEST_ASSERT_TRUE(decoder.decodeValues(buffer, valuesSize, values));
+
+    TEST_ASSERT_EQUAL_UINT32(gbtDataDictionary.getDateTime().asUnixTimeStamp(), values.unixTime);
+
+    // the 14 values of the push, the push setup and the device name travel with the dictionary
+    SmDictionary const& received = *values.dictionary;
+    uint8_t texts = 0;
+
+    TEST_ASSERT_EQUAL_UINT8(14, received.getCount());
+
+    for(uint8_t i = 0; i < received.getCount(); i++)
+    {
+        SmDictionaryEntry const& entry = received.getAt(i);
+        SmDictionaryEntry const& sent = session.getDictionary().getAt(i);
+
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(sent.obis, entry.obis, 6);
+        TEST_ASSERT_EQUAL_UINT8(sent.type, entry.type);
+        TEST_ASSERT_EQUAL_INT8(sent.scaler, entry.scaler);
+        TEST_ASSERT_TRUE(sent.unit == entry.unit);
+
+        if(entry.type == SmDictionary::TYPE_TEXT)
+        {
+            texts++;
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(2, texts);
+
+    // the device name is the text of the logical device name register
+    uint8_t deviceName = 0;
+
+    while(deviceName < received.getCount() && received.getAt(deviceName).textLength != 8)
+    {
+        deviceName++;
+    }
+
+    TEST_ASSERT_TRUE(deviceName < received.getCount());
+    TEST_ASSERT_EQUAL_UINT8(SmDictionary::TYPE_TEXT, received.getAt(deviceName).type);
+    TEST_ASSERT_EQUAL_MEMORY("60222999", received.getText(deviceName), 8);
+
+    // the value uplink has the numeric values only, far less than the values with their descriptions
+    TEST_ASSERT_TRUE(valuesSize < dictionarySize / 2);
+}
+
+void test_dictionary_session(void)
+{
+    SmDictionarySession session;
+
+    updateSession(session, e450GbtPdu, E450_GBTPDU_SIZE);
+
+    // the first push sends the dictionary, the next ones only the values
+    TEST_ASSERT_TRUE(session.isDictionaryDue());
+
+    session.dictionarySent();
+
+    updateSession(session, e450GbtPdu, E450_GBTPDU_SIZE);
+
+    TEST_ASSERT_FALSE(session.isDictionaryDue());
+
+    // the server lost the dictionary
+    session.requestDictionary();
+
+    TEST_ASSERT_TRUE(session.isDictionaryDue());
+
+    session.dictionarySent();
+
+    TEST_ASSERT_FALSE(session.isDictionaryDue());
+
+    // after a reset (e.g. another profile) the dictionary is sent again
+    session.reset();
+
+    updateSession(session, e450GbtPdu, E450_GBTPDU_SIZE);
+
+    TEST_ASSERT_TRUE(session.isDictionaryDue());
+}
+
+void test_dictionary_hash_changed(void)
+{
+    SmDictionarySession session;
+
+    updateSession(session, e450GbtPdu, E450_GBTPDU_SIZE);
+
+    uint32_t hash = session.getHash();
+
+    session.dictionarySent();
+
+    // another meter on the bus: the same layout with another device name
+    uint8_t pdu[E450_GBTPDU_SIZE];
+
+    memcpy(pdu, e450GbtPdu, sizeof(pdu));
+
+    uint8_t* deviceName = nullptr;
+
+    for(size_t i = 0; i + 8 <= sizeof(pdu); i++)
+    {
+        if(memcmp(pdu + i, "60222999", 8) == 0)
+        {
+            deviceName = pdu + i;
+        }
+    }
+
+    TEST_ASSERT_NOT_NULL(deviceName);
+
+    deviceName[7] = '8';
+
+    updateSession(session, pdu, sizeof(pdu));
+
+    TEST_ASSERT_TRUE(hash != session.getHash());
+    TEST_ASSERT_TRUE(session.isDictionaryDue());
+
+    // another scaler changes the hash as well
+    SmDictionary dictionary;
+    uint8_t const obis[6] = { 1, 1, 1, 8, 0, 255 };
+
+    TEST_ASSERT_TRUE(dictionary.addNumeric(obis, SmDictionary::TYPE_UINT32, 0, SmUnit::SMUNIT_WATTHOUR));
+
+    hash = dictionary.computeHash();
+
+    dictionary.clear();
+
+    TEST_ASSERT_TRUE(dictionary.addNumeric(obis, SmDictionary::TYPE_UINT32, 3, SmUnit::SMUNIT_WATTHOUR));
+    TEST_ASSERT_TRUE(hash != dictionary.computeHash());
+}
+
+void test_dictionary_unknown_hash(void)
+{
+    SmDictionarySession session;
+    SmDictionaryDecoder decoder;
+    SmDictionaryValues values;
+    uint8_t dictionary[222];
+    uint8_t buffer[222];
+
+    updateSession(session, e450GbtPdu, E450_GBTPDU_SIZE);
+
+    size_t dictionarySize = session.encodeDictionary(dictionary, sizeof(dictionary));
+    size_t valuesSize = session.encodeValues(buffer, sizeof(buffer));
+
+    TEST_ASSERT_TRUE(decoder.addDictionary(dictionary, dictionarySize));
+
+    // another hash is unknown, the server requests the dictionary
+    buffer[0] ^= 0xff;
+
+    TEST_ASSERT_FALSE(decoder.decodeValues(buffer, valuesSize, values));
+
+    buffer[0] ^= 0xff;
+
+    // the size has to match the dictionary
+    TEST_ASSERT_FALSE(decoder.decodeValues(buffer, valuesSize - 1, values));
+    TEST_ASSERT_TRUE(decoder.decodeValues(buffer, valuesSize, values));
+
+    // the dictionary is dropped with the reset
+    decoder.reset();
+
+    TEST_ASSERT_FALSE(decoder.decodeValues(buffer, valuesSize, values));
+}
+
+void test_dictionary_invalid(void)
+{
+    SmDictionarySession session;
+    SmDictionaryDecoder decoder;
+    uint8_t dictionary[222];
+
+    updateSession(session, e450GbtPdu, E450_GBTPDU_SIZE);
+
+    size_t size = session.encodeDictionary(dictionary, sizeof(dictionary));
+
+    // too small buffers are not written
+    TEST_ASSERT_EQUAL_size_t(0, session.encodeDictionary(dictionary, size - 1));
+    TEST_ASSERT_EQUAL_size_t(0, session.encodeValues(dictionary, session.getDictionary().getValuesSize() - 1));
+
+    // truncated, trailing bytes or a corrupted entry are rejected
+    for(size_t length = 0; length < size; length++)
+    {
+        TEST_ASSERT_FALSE(decoder.addDictionary(dictionary, length));
+    }
+
+    TEST_ASSERT_FALSE(decoder.addDictionary(dictionary, size + 1));
+
+    dictionary[sizeof(uint32_t) + 1] ^= 0x01;
+
+    TEST_ASSERT_FALSE(decoder.addDictionary(dictionary, size));
+    TEST_ASSERT_FALSE(decoder.addDictionary(nullptr, size));
+}
+
+void test_dictionary_parse_obis(void)
+{
+    uint8_t obis[6];
+
+    TEST_ASSERT_TRUE(SmProfiles::parseObis("1.1.1.8.0.255", obis));
+
+    uint8_t const expected[6] = { 1, 1, 1, 8, 0, 255 };
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, obis, 6);
+
+    TEST_ASSERT_FALSE(SmProfiles::parseObis("1.1.1.8.0", obis));
+    TEST_ASSERT_FALSE(SmProfiles::parseObis("1.1.1.8.0.256", obis));
+    TEST_ASSERT_FALSE(SmProfiles::parseObis("1.1.1.8.0.255.1", obis));
+}
@@ -0,0 +1,6 @@
+void test_dictionary_e450_roundtrip(void);
+void test_dictionary_session(void);
+void test_dictionary_hash_changed(void);
+void test_dictionary_unknown_hash(void);
+void test_dictionary_invalid(void);
+void test_dictionary_parse_obis(void);
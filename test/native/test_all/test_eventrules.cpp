@@ -0,0 +1,165 @@
+#include "unity.h"
+
+#include "test_eventrules.h"
+#include "test_fixtures.h"
+
+#include "gbtdata.h"
+#include "smeventrules.h"
+#include "smprofile.h"
+#include "smpushextractor.h"
+
+// one push with the active power (0.1 W), the active energy (Wh) and a status register
+static void evaluatePush(SmEventRules& rules, uint32_t const time, int32_t const power, int32_t const energy, int32_t const status)
+{
+    rules.addRecordTime(10, time);
+    rules.addRecordScaled(10, scaledValue(power, -1, SmUnit::SMUNIT_WATT));
+    rules.addRecordScaled(10, scaledValue(energy, 0, SmUnit::SMUNIT_WATTHOUR));
+    rules.addRecordScaled(10, scaledValue(status, 0, SmUnit::SMUNIT_NONE));
+}
+
+void test_eventrules_first_push(void)
+{
+    SmEventRules rules;
+
+    rules.configure(0, 0, false, 0);
+    rules.reset();
+
+    evaluatePush(rules, 1000, 1000, 5000, 0);
+
+    TEST_ASSERT_TRUE(rules.isUplinkDue());
+    TEST_ASSERT_EQUAL_HEX8(SmEventRules::EVENT_FIRST, rules.getEvents());
+
+    rules.uplinkSent();
+
+    // nothing configured, nothing to send
+    evaluatePush(rules, 1900, 2000, 6000, 1);
+
+    TEST_ASSERT_FALSE(rules.isUplinkDue());
+}
+
+void test_eventrules_power_threshold(void)
+{
+    SmEventRules rules;
+
+    rules.configure(500, 0, false, 0);
+    rules.reset();
+
+    evaluatePush(rules, 1000, 1000, 5000, 0);
+    rules.uplinkSent();
+
+    // 400.0 W, below the threshold
+    evaluatePush(rules, 1900, 4000, 5000, 0);
+    TEST_ASSERT_FALSE(rules.isUplinkDue());
+
+    // 600.0 W, rises above the threshold
+    evaluatePush(rules, 2800, 6000, 5000, 0);
+    TEST_ASSERT_EQUAL_HEX8(SmEventRules::EVENT_POWER, rules.getEvents());
+    rules.uplinkSent();
+
+    // stays above, sent once only
+    evaluatePush(rules, 3700, 7000, 5000, 0);
+    TEST_ASSERT_FALSE(rules.isUplinkDue());
+
+    // falls below and rises again
+    evaluatePush(rules, 4600, 1000, 5000, 0);
+    TEST_ASSERT_FALSE(rules.isUplinkDue());
+    evaluatePush(rules, 5500, 5010, 5000, 0);
+    TEST_ASSERT_EQUAL_HEX8(SmEventRules::EVENT_POWER, rules.getEvents());
+}
+
+void test_eventrules_energy_delta(void)
+{
+    SmEventRules rules;
+
+    rules.configure(0, 100, false, 0);
+    rules.reset();
+
+    evaluatePush(rules, 1000, 1000, 5000, 0);
+    rules.uplinkSent();
+
+    // the delta is measured against the last uplink, not against the last push
+    evaluatePush(rules, 1900, 1000, 5060, 0);
+    TEST_ASSERT_FALSE(rules.isUplinkDue());
+
+    evaluatePush(rules, 2800, 1000, 5099, 0);
+    TEST_ASSERT_FALSE(rules.isUplinkDue());
+
+    evaluatePush(rules, 3700, 1000, 5100, 0);
+    TEST_ASSERT_EQUAL_HEX8(SmEventRules::EVENT_ENERGY, rules.getEvents());
+    rules.uplinkSent();
+
+    evaluatePush(rules, 4600, 1000, 5150, 0);
+    TEST_ASSERT_FALSE(rules.isUplinkDue());
+}
+
+void test_eventrules_status_change(void)
+{
+    SmEventRules rules;
+
+    rules.configure(0, 0, true, 0);
+    rules.reset();
+
+    evaluatePush(rules, 1000, 1000, 5000, 3);
+    rules.uplinkSent();
+
+    evaluatePush(rules, 1900, 9000, 9000, 3);
+    TEST_ASSERT_FALSE(rules.isUplinkDue());
+
+    evaluatePush(rules, 2800, 1000, 5000, 4);
+    TEST_ASSERT_EQUAL_HEX8(SmEventRules::EVENT_STATUS, rules.getEvents());
+
+    // a register with another unit at the position of the status is an event of its own
+    rules.uplinkSent();
+
+    rules.addRecordTime(10, 3700);
+    rules.addRecordScaled(10, scaledValue(1000, -1, SmUnit::SMUNIT_WATT));
+    rules.addRecordScaled(10, scaledValue(5000, 0, SmUnit::SMUNIT_WATTHOUR));
+    rules.addRecordScaled(10, scaledValue(230, 0, SmUnit::SMUNIT_VOLT));
+
+    TEST_ASSERT_EQUAL_HEX8(SmEventRules::EVENT_FIRST, rules.getEvents());
+}
+
+void test_eventrules_heartbeat(void)
+{
+    SmEventRules rules;
+
+    rules.configure(0, 0, false, 3600);
+    rules.reset();
+
+    evaluatePush(rules, 1000, 1000, 5000, 0);
+    rules.uplinkSent();
+
+    evaluatePush(rules, 4599, 1000, 5000, 0);
+    TEST_ASSERT_FALSE(rules.isUplinkDue());
+
+    evaluatePush(rules, 4600, 1000, 5000, 0);
+    TEST_ASSERT_EQUAL_HEX8(SmEventRules::EVENT_HEARTBEAT, rules.getEvents());
+    rules.uplinkSent();
+
+    // the heartbeat starts again with the uplink
+    evaluatePush(rules, 5500, 1000, 5000, 0);
+    TEST_ASSERT_FALSE(rules.isUplinkDue());
+}
+
+static GbtData gbtDataEventRules;
+
+void test_eventrules_e450(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, gbtDataEventRules.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+
+    SmProfile const& e450 = SmProfiles::getDefault();
+    SmPushExtractor extractor;
+    SmEventRules rules;
+
+    rules.configure(1, 1, true, 3600);
+    rules.reset();
+
+    TEST_ASSERT_TRUE(extractor.extract(gbtDataEventRules, e450, e450.channel, true, rules));
+    TEST_ASSERT_TRUE(rules.isUplinkDue());
+
+    rules.uplinkSent();
+
+    // the same push again: no delta, no change and the power has not risen
+    TEST_ASSERT_TRUE(extractor.extract(gbtDataEventRules, e450, e450.channel, true, rules));
+    TEST_ASSERT_FALSE(rules.isUplinkDue());
+}
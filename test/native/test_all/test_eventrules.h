@@ -0,0 +1,6 @@
+void test_eventrules_first_push(void);
+void test_eventrules_power_threshold(void);
+void test_eventrules_energy_delta(void);
+void test_eventrules_status_change(void);
+void test_eventrules_heartbeat(void);
+void test_eventrules_e450(void);
@@ -0,0 +1,195 @@
+#include "unity.h"
+
+#include <string.h>
+
+#include "test_fixedlayout.h"
+#include "test_fixtures.h"
+
+#include "gbtdata.h"
+#include "smfixeddecoder.h"
+#include "smfixedencoder.h"
+#include "smprofile.h"
+#include "smpushlayout.h"
+#include "smscaler.h"
+
+// a layout with a status flag, the offsets are known at build time
+static constexpr SmFixedField TEST_FIXED_FIELDS[] = {
+    { "1.0.1.7.0.255", 20 }, { "0.0.96.3.10.255", 1 }, { "1.1.1.8.0.255", 32 }
+};
+
+static constexpr SmFixedLayout TEST_FIXED_LAYOUT = { 0, TEST_FIXED_FIELDS, 3 };
+
+static_assert(TEST_FIXED_LAYOUT.isValid(), "test layout is valid");
+static_assert(TEST_FIXED_LAYOUT.getBitOffset(0) == 35, "the fields follow the time and three flags");
+static_assert(TEST_FIXED_LAYOUT.getBitOffset(2) == 56, "the flag takes one bit");
+static_assert(TEST_FIXED_LAYOUT.getSize() == 11, "88 bits");
+
+static ParsedPush pushFixed;
+
+void test_fixedlayout_offsets(void)
+{
+    SmFixedLayout const* layout = SmFixedLayouts::find(SmProfiles::SMPROFILE_LG_E450);
+
+    TEST_ASSERT_NOT_NULL(layout);
+    TEST_ASSERT_NULL(SmFixedLayouts::find(0));
+
+    // time, 12 presence flags, two powers of 20 bits, eight counters of 32 bits and three currents of 16 bits
+    TEST_ASSERT_EQUAL_UINT8(12, layout->fieldCount);
+    TEST_ASSERT_EQUAL_UINT16(32, layout->getFlagOffset(0));
+    TEST_ASSERT_EQUAL_UINT16(44, layout->getBitOffset(0));
+    TEST_ASSERT_EQUAL_UINT16(84, layout->getBitOffset(2));
+    TEST_ASSERT_EQUAL_UINT16(308, layout->getBitOffset(9));
+    TEST_ASSERT_EQUAL_UINT16(356, layout->getBitOffset(12));
+    TEST_ASSERT_EQUAL_size_t(45, layout->getSize());
+
+    TEST_ASSERT_EQUAL_INT8(2, layout->findField("1.1.1.8.0.255"));
+    TEST_ASSERT_EQUAL_INT8(-1, layout->findField("0.0.96.1.0.255"));
+}
+
+void test_fixedlayout_profile_registers(void)
+{
+    uint8_t layoutCount = 0;
+
+    // every field of a fixed layout is a register of its profile
+    for(uint8_t i = 0; i < SmProfiles::getCount(); i++)
+    {
+        SmFixedLayout const* layout = SmFixedLayouts::find(SmProfiles::getAt(i).id);
+
+        if(layout == nullptr)
+        {
+            continue;
+        }
+
+        TEST_ASSERT_TRUE_MESSAGE(layout->isInProfile(), SmProfiles::getAt(i).name);
+
+        layoutCount++;
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(1, layoutCount);
+
+    // the status flag of the test layout is not a register of the E450, the test layout has no profile
+    SmFixedLayout const layoutE450 = { SmProfiles::SMPROFILE_LG_E450, TEST_FIXED_FIELDS, 3 };
+
+    TEST_ASSERT_FALSE(layoutE450.isInProfile());
+    TEST_ASSERT_FALSE(TEST_FIXED_LAYOUT.isInProfile());
+}
+
+void test_fixedlayout_bits(void)
+{
+    uint8_t buffer[8] = { 0 };
+
+    // fields across byte boundaries, most significant bit first
+    SmFixedLayout::writeBits(buffer, 3, 1, 1);
+    SmFixedLayout::writeBits(buffer, 4, 20, 0xabcde);
+    SmFixedLayout::writeBits(buffer, 24, 32, 0x12345678);
+
+    TEST_ASSERT_EQUAL_HEX8(0x1a, buffer[0]);
+    TEST_ASSERT_EQUAL_HEX8(0xbc, buffer[1]);
+    TEST_ASSERT_EQUAL_HEX8(0xde, buffer[2]);
+    TEST_ASSERT_EQUAL_HEX8(0x12, buffer[3]);
+    TEST_ASSERT_EQUAL_HEX8(0x78, buffer[6]);
+
+    TEST_ASSERT_EQUAL_UINT32(1, SmFixedLayout::readBits(buffer, 3, 1));
+    TEST_ASSERT_EQUAL_UINT32(0xabcde, SmFixedLayout::readBits(buffer, 4, 20));
+    TEST_ASSERT_EQUAL_UINT32(0x12345678, SmFixedLayout::readBits(buffer, 24, 32));
+}
+
+void test_fixedlayout_e450_roundtrip(void)
+{
+    SmFixedEncoder encoder;
+    SmFixedValues values;
+    uint8_t buffer[222];
+
+    pushFixed.parse(e450GbtPdu, E450_GBTPDU_SIZE);
+
+    // no layout selected
+    TEST_ASSERT_FALSE(encoder.update(pushFixed.gbtData, pushFixed.layout));
+    TEST_ASSERT_EQUAL_size_t(0, encoder.encode(buffer, sizeof(buffer)));
+
+    TEST_ASSERT_TRUE(encoder.select(SmProfiles::SMPROFILE_LG_E450));
+    TEST_ASSERT_TRUE(encoder.update(pushFixed.gbtData, pushFixed.layout));
+
+    SmFixedLayout const& layout = *encoder.getLayout();
+
+    size_t size = encoder.encode(buffer, sizeof(buffer));
+
+    // 45 bytes for the 12 numeric values, the cayenne uplink of the push has 144 bytes
+    TEST_ASSERT_EQUAL_size_t(45, size);
+    TEST_ASSERT_EQUAL_size_t(0, encoder.encode(buffer, size - 1));
+
+    TEST_ASSERT_TRUE(SmFixedDecoder::decode(layout, buffer, size, values));
+    TEST_ASSERT_EQUAL_UINT32(pushFixed.gbtData.getDateTime().asUnixTimeStamp(), values.unixTime);
+    TEST_ASSERT_EQUAL_HEX32(0xfff, values.present);
+
+    // each field has the raw value of its register
+    for(uint8_t i = 0; i < pushFixed.layout.getValueCount(); i++)
+    {
+        SmRegister const* smRegister = pushFixed.layout.getRegister(i);
+        int64_t raw;
+
+        if(smRegister == nullptr || !SmScaler::getRawValue(pushFixed.gbtData.getValue(pushFixed.layout.getValueIndex(i)), raw))
+        {
+            continue;
+        }
+
+        int8_t field = layout.findField(smRegister->obis);
+
+        TEST_ASSERT_TRUE(field >= 0);
+        TEST_ASSERT_EQUAL_UINT32((uint32_t) raw, values.values[field]);
+    }
+}
+
+void test_fixedlayout_missing_and_overflow(void)
+{
+    SmFixedEncoder encoder;
+    SmFixedValues values;
+    uint8_t pdu[128];
+    uint8_t buffer[64];
+
+    // the power does not fit into its 20 bits, the other registers are not pushed
+    size_t pduSize = buildE450Push(pdu, 15, 2000000, 123456789, 42);
+
+    pushFixed.parse(pdu, pduSize);
+    TEST_ASSERT_TRUE(encoder.select(SmProfiles::SMPROFILE_LG_E450));
+    TEST_ASSERT_TRUE(encoder.update(pushFixed.gbtData, pushFixed.layout));
+
+    size_t size = encoder.encode(buffer, sizeof(buffer));
+
+    TEST_ASSERT_TRUE(SmFixedDecoder::decode(*encoder.getLayout(), buffer, size, values));
+    TEST_ASSERT_EQUAL_HEX32(0x00c, values.present);
+    TEST_ASSERT_EQUAL_UINT32(0, values.values[0]);
+    TEST_ASSERT_EQUAL_UINT32(123456789, values.values[2]);
+    TEST_ASSERT_EQUAL_UINT32(42, values.values[3]);
+    TEST_ASSERT_EQUAL_UINT32(0, values.values[11]);
+
+    // the same push layout with a power which fits
+    pduSize = buildE450Push(pdu, 15, 1048575, 123456790, 42);
+
+    pushFixed.parse(pdu, pduSize);
+    TEST_ASSERT_TRUE(encoder.update(pushFixed.gbtData, pushFixed.layout));
+
+    size = encoder.encode(buffer, sizeof(buffer));
+
+    TEST_ASSERT_TRUE(SmFixedDecoder::decode(*encoder.getLayout(), buffer, size, values));
+    TEST_ASSERT_EQUAL_HEX32(0x00d, values.present);
+    TEST_ASSERT_EQUAL_UINT32(1048575, values.values[0]);
+    TEST_ASSERT_EQUAL_UINT32(123456790, values.values[2]);
+}
+
+void test_fixedlayout_invalid(void)
+{
+    SmFixedValues values;
+    uint8_t buffer[64] = { 0 };
+
+    SmFixedLayout const& layout = *SmFixedLayouts::find(SmProfiles::SMPROFILE_LG_E450);
+
+    // the size has to match the layout
+    TEST_ASSERT_FALSE(SmFixedDecoder::decode(layout, buffer, layout.getSize() - 1, values));
+    TEST_ASSERT_FALSE(SmFixedDecoder::decode(layout, buffer, layout.getSize() + 1, values));
+    TEST_ASSERT_FALSE(SmFixedDecoder::decode(layout, nullptr, layout.getSize(), values));
+    TEST_ASSERT_TRUE(SmFixedDecoder::decode(layout, buffer, layout.getSize(), values));
+    TEST_ASSERT_EQUAL_HEX32(0, values.present);
+
+    // the test layout checks at build time as well
+    TEST_ASSERT_EQUAL_size_t(11, TEST_FIXED_LAYOUT.getSize());
+}
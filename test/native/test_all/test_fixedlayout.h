@@ -0,0 +1,6 @@
+void test_fixedlayout_offsets(void);
+void test_fixedlayout_bits(void);
+void test_fixedlayout_e450_roundtrip(void);
+void test_fixedlayout_missing_and_overflow(void);
+void test_fixedlayout_invalid(void);
+void test_fixedlayout_profile_registers(void);
@@ -0,0 +1,236 @@
+/**
+ * @file test_fixtures.h
+ * @brief Recorded L&G E450 push data, push builders and helpers shared by the native tests.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "gbtdata.h"
+#include "smprofile.h"
+#include "smpushlayout.h"
+#include "smrecordsink.h"
+#include "smscaler.h"
+
+#define E450_GBTPDU_SIZE 364
+
+// joined GBT PDU of an E450 push (26.12.2022 01:30:35)
+const uint8_t e450GbtPdu[E450_GBTPDU_SIZE] = {
+    0x0f, 0x00, 0x08, 0x3d, 0x65, 0x0c, 0x07, 0xe6, 
+    0x0c, 0x1a, 0x01, 0x01, 0x1e, 0x23, 0xff, 0x80, 
+    0x00, 0x00, 0x02, 0x0f, 0x01, 0x0f, 0x02, 0x04, 
+    0x12, 0x00, 0x28, 0x09, 0x06, 0x00, 0x08, 0x19, 
+    0x09, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00, 
+    0x02, 0x04, 0x12, 0x00, 0x28, 0x09, 0x06, 0x00, 
+    0x08, 0x19, 0x09, 0x00, 0xff, 0x0f, 0x01, 0x12, 
+    0x00, 0x00, 0x02, 0x04, 0x12, 0x00, 0x01, 0x09, 
+    0x06, 0x00, 0x00, 0x60, 0x01, 0x00, 0xff, 0x0f, 
+    0x02, 0x12, 0x00, 0x00, 0x02, 0x04, 0x12, 0x00, 
+    0x03, 0x09, 0x06, 0x01, 0x00, 0x01, 0x07, 0x00, 
+    0xff, 0x0f, 0x02, 0x12, 0x00, 0x00, 0x02, 0x04, 
+    0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x00, 0x02, 
+    0x07, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00, 
+    0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 
+    0x01, 0x01, 0x08, 0x00, 0xff, 0x0f, 0x02, 0x12, 
+    0x00, 0x00, 0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 
+    0x06, 0x01, 0x01, 0x02, 0x08, 0x00, 0xff, 0x0f, 
+    0x02, 0x12, 0x00, 0x00, 0x02, 0x04, 0x12, 0x00, 
+    0x03, 0x09, 0x06, 0x01, 0x01, 0x05, 0x08, 0x00, 
+    0xff, 0x0f, 0x02, 0x12, 0x00, 0x00, 0x02, 0x04, 
+    0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x01, 0x06, 
+    0x08, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00, 
+    0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 
+    0x01, 0x07, 0x08, 0x00, 0xff, 0x0f, 0x02, 0x12, 
+    0x00, 0x00, 0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 
+    0x06, 0x01, 0x01, 0x08, 0x08, 0x00, 0xff, 0x0f, 
+    0x02, 0x12, 0x00, 0x00, 0x02, 0x04, 0x12, 0x00, 
+    0x03, 0x09, 0x06, 0x01, 0x00, 0x82, 0x07, 0x00, 
+    0xff, 0x0f, 0x02, 0x12, 0x00, 0x00, 0x02, 0x04, 
+    0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x00, 0x1f, 
+    0x07, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00, 
+    0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 
+    0x00, 0x33, 0x07, 0x00, 0xff, 0x0f, 0x02, 0x12, 
+    0x00, 0x00, 0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 
+    0x06, 0x01, 0x00, 0x47, 0x07, 0x00, 0xff, 0x0f, 
+    0x02, 0x12, 0x00, 0x00, 0x09, 0x06, 0x00, 0x08, 
+    0x19, 0x09, 0x00, 0xff, 0x09, 0x08, 0x36, 0x30, 
+    0x32, 0x32, 0x32, 0x39, 0x39, 0x39, 0x06, 0x00, 
+    0x00, 0x00, 0x13, 0x06, 0x00, 0x00, 0x00, 0x00, 
+    0x06, 0x00, 0x00, 0x00, 0x95, 0x06, 0x00, 0x00, 
+    0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x06, 
+    0x00, 0x00, 0x00, 0x01, 0x06, 0x00, 0x00, 0x00, 
+    0x00, 0x06, 0x00, 0x00, 0x00, 0x52, 0x06, 0x00, 
+    0x00, 0x00, 0x0b, 0x12, 0x00, 0x0b, 0x12, 0x00, 
+    0x00, 0x12, 0x00, 0x00
+};
+
+#define E450_HDLC_SIZE 443
+
+// recorded hdlc frames of an E450 push with the LLC header (e6 e7 00), flags and frame check sequences included
+const uint8_t e450HdlcFrames[E450_HDLC_SIZE] = {
+      0x7e, 0xa0, 0x84, 0xce, 0xff, 0x03, 0x13, 0x12, 
+      0x8b, 0xe6, 0xe7, 0x00, 0xe0, 0x40, 0x00, 0x01, 
+      0x00, 0x00, 0x70, 0x0f, 0x00, 0x02, 0x32, 0x24, 
+      0x0c, 0x07, 0xe6, 0x0b, 0x0b, 0x05, 0x14, 0x25, 
+      0x1e, 0xff, 0x80, 0x00, 0x00, 0x02, 0x0f, 0x01, 
+      0x0f, 0x02, 0x04, 0x12, 0x00, 0x28, 0x09, 0x06, 
+      0x00, 0x08, 0x19, 0x09, 0x00, 0xff, 0x0f, 0x02, 
+      0x12, 0x00, 0x00, 0x02, 0x04, 0x12, 0x00, 0x28, 
+      0x09, 0x06, 0x00, 0x08, 0x19, 0x09, 0x00, 0xff, 
+      0x0f, 0x01, 0x12, 0x00, 0x00, 0x02, 0x04, 0x12, 
+      0x00, 0x01, 0x09, 0x06, 0x00, 0x00, 0x60, 0x01, 
+      0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00, 0x02, 
+      0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x00, 
+      0x01, 0x07, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 
+      0x00, 0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 
+      0x01, 0x00, 0x02, 0x07, 0x00, 0xff, 0x0f, 0x02, 
+      0x12, 0x00, 0x00, 0xb3, 0xf2, 0x7e, 0x7e, 0xa0, 
+      0x7d, 0xce, 0xff, 0x03, 0x13, 0xd0, 0x45, 0xe0, 
+      0x40, 0x00, 0x02, 0x00, 0x00, 0x6c, 0x02, 0x04, 
+      0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x01, 0x01, 
+      0x08, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00, 
+      0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 
+      0x01, 0x02, 0x08, 0x00, 0xff, 0x0f, 0x02, 0x12, 
+      0x00, 0x00, 0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 
+      0x06, 0x01, 0x01, 0x05, 0x08, 0x00, 0xff, 0x0f, 
+      0x02, 0x12, 0x00, 0x00, 0x02, 0x04, 0x12, 0x00, 
+      0x03, 0x09, 0x06, 0x01, 0x01, 0x06, 0x08, 0x00, 
+      0xff, 0x0f, 0x02, 0x12, 0x00, 0x00, 0x02, 0x04, 
+      0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x01, 0x07, 
+      0x08, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00, 
+      0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 
+      0x01, 0x08, 0x08, 0x00, 0xff, 0x0f, 0x02, 0x12, 
+      0x00, 0x00, 0xc1, 0x95, 0x7e, 0x7e, 0xa0, 0x84, 
+      0xce, 0xff, 0x03, 0x13, 0x12, 0x8b, 0xe0, 0x40, 
+      0x00, 0x03, 0x00, 0x00, 0x73, 0x02, 0x04, 0x12, 
+      0x00, 0x03, 0x09, 0x06, 0x01, 0x00, 0x82, 0x07, 
+      0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00, 0x02, 
+      0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x00, 
+      0x1f, 0x07, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 
+      0x00, 0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 
+      0x01, 0x00, 0x33, 0x07, 0x00, 0xff, 0x0f, 0x02, 
+      0x12, 0x00, 0x00, 0x02, 0x04, 0x12, 0x00, 0x03, 
+      0x09, 0x06, 0x01, 0x00, 0x47, 0x07, 0x00, 0xff, 
+      0x0f, 0x02, 0x12, 0x00, 0x00, 0x09, 0x06, 0x00, 
+      0x08, 0x19, 0x09, 0x00, 0xff, 0x09, 0x08, 0x36, 
+      0x30, 0x32, 0x32, 0x32, 0x39, 0x39, 0x39, 0x06, 
+      0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 
+      0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 
+      0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 
+      0x66, 0xaa, 0x7e, 0x7e, 0xa0, 0x2e, 0xce, 0xff, 
+      0x03, 0x13, 0x7e, 0x2d, 0xe0, 0xc0, 0x00, 0x04, 
+      0x00, 0x00, 0x1d, 0x06, 0x00, 0x00, 0x00, 0x01, 
+      0x06, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 
+      0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x12, 
+      0x00, 0x00, 0x12, 0x00, 0x00, 0x12, 0x00, 0x00, 
+      0x61, 0x14, 0x7e
+};
+
+// active power +P, active energy +A and -A of the E450 profile, the registers of buildE450Push
+const uint8_t e450PushObis[3][6] = {
+    { 0x01, 0x00, 0x01, 0x07, 0x00, 0xff }, { 0x01, 0x01, 0x01, 0x08, 0x00, 0xff }, { 0x01, 0x01, 0x02, 0x08, 0x00, 0xff }
+};
+
+// builds an E450 like push with the three registers, pushed at 01:<minute>:35 (at most 128 bytes)
+inline size_t buildE450Push(uint8_t* pdu, uint8_t const minute, uint32_t const power, uint32_t const energyImport, uint32_t const energyExport)
+{
+    uint8_t const head[] = {
+        0x0f, 0x00, 0x00, 0x00, 0x01,
+        0x0c, 0x07, 0xe6, 0x0c, 0x1a, 0x01, 0x01, minute, 0x23, 0xff, 0x80, 0x00, 0x00,
+        0x02, 0x05, 0x01, 0x04,
+        0x02, 0x04, 0x12, 0x00, 0x28, 0x09, 0x06, 0x00, 0x08, 0x19, 0x09, 0x00, 0xff, 0x0f, 0x01, 0x12, 0x00, 0x00
+    };
+
+    size_t size = sizeof(head);
+
+    memcpy(pdu, head, size);
+
+    for(uint8_t i = 0; i < 3; i++)
+    {
+        uint8_t const descriptor[] = { 0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06 };
+        uint8_t const attribute[] = { 0x0f, 0x02, 0x12, 0x00, 0x00 };
+
+        memcpy(pdu + size, descriptor, sizeof(descriptor));
+        size += sizeof(descriptor);
+        memcpy(pdu + size, e450PushObis[i], 6);
+        size += 6;
+        memcpy(pdu + size, attribute, sizeof(attribute));
+        size += sizeof(attribute);
+    }
+
+    uint8_t const pushSetup[] = { 0x09, 0x06, 0x00, 0x08, 0x19, 0x09, 0x00, 0xff };
+
+    memcpy(pdu + size, pushSetup, sizeof(pushSetup));
+    size += sizeof(pushSetup);
+
+    uint32_t const values[3] = { power, energyImport, energyExport };
+
+    for(uint8_t i = 0; i < 3; i++)
+    {
+        pdu[size++] = 0x06;
+        pdu[size++] = (values[i] >> 24) & 0xff;
+        pdu[size++] = (values[i] >> 16) & 0xff;
+        pdu[size++] = (values[i] >> 8) & 0xff;
+        pdu[size++] = values[i] & 0xff;
+    }
+
+    return size;
+}
+
+// fixed-point value with unit as a sink or a decoder sees it
+inline SmScaledValue scaledValue(int32_t const mantissa, int8_t const exponent, SmUnit const unit)
+{
+    SmScaledValue value = { mantissa, exponent, unit };
+
+    return value;
+}
+
+// a push parsed into GbtData together with its layout in the default profile
+struct ParsedPush
+{
+    GbtData gbtData;
+    SmPushLayout layout;
+
+    void parse(uint8_t const* pdu, size_t const size)
+    {
+        TEST_ASSERT_EQUAL_INT(0, gbtData.parse(pdu, size));
+        TEST_ASSERT_TRUE(layout.update(gbtData, SmProfiles::getDefault()));
+    }
+};
+
+// counts the records of an extraction, the work of an encoder is not part of it
+class CountingSink : public SmRecordSink
+{
+    public:
+        uint32_t timeCount = 0;                                                                     // time stamps
+        uint32_t valueCount = 0;                                                                    // raw and scaled values
+        uint32_t records = 0;                                                                       // all records
+
+        bool addRecordTime(uint8_t const channel, uint32_t const unixTime) override
+        {
+            timeCount++;
+            records++;
+
+            return true;
+        }
+
+        bool addRecordValue(uint8_t const channel, GbtValueBase const* gbtValue) override
+        {
+            valueCount++;
+            records++;
+
+            return true;
+        }
+
+        bool addRecordScaled(uint8_t const channel, SmScaledValue const& scaledValue) override
+        {
+            valueCount++;
+            records++;
+
+            return true;
+        }
+};
@@ -0,0 +1,243 @@
+#include <string.h>
+
+#include "unity.h"
+
+#include "test_fragment.h"
+#include "test_fixtures.h"
+
+#include "smfragmenter.h"
+#include "smreassembler.h"
+
+static uint8_t const FRAME_SIZE = 51;                                                               // payload of DR0 (EU868)
+
+static uint8_t g_frames[SmFragmenter::MAX_FRAGMENTS][FRAME_SIZE];
+static size_t g_frameSizes[SmFragmenter::MAX_FRAGMENTS];
+
+// fragments the raw E450 push (one record) into g_frames, returns the number of fragments
+static uint8_t fragmentE450(SmFragmenter& fragmenter)
+{
+    uint16_t const recordEnd = E450_GBTPDU_SIZE;
+
+    TEST_ASSERT_TRUE(fragmenter.plan(&recordEnd, 1, FRAME_SIZE));
+    TEST_ASSERT_TRUE(fragmenter.isFragmented());
+
+    for(uint8_t i = 0; i < fragmenter.getFrameCount(); i++)
+    {
+        g_frameSizes[i] = fragmenter.writeFrame(i, e450GbtPdu, g_frames[i], FRAME_SIZE);
+
+        TEST_ASSERT_TRUE(g_frameSizes[i] > SmFragmenter::HEADER_SIZE);
+    }
+
+    return fragmenter.getFrameCount();
+}
+
+static void assertE450(SmReassembler const& reassembler)
+{
+    TEST_ASSERT_EQUAL_size_t(E450_GBTPDU_SIZE, reassembler.getMessageSize());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(e450GbtPdu, reassembler.getMessage(), E450_GBTPDU_SIZE);
+}
+
+void test_fragment_single_frame(void)
+{
+    SmFragmenter fragmenter;
+    uint8_t const message[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 };
+    uint16_t const recordEnds[] = { 2, 6 };
+    uint8_t frame[FRAME_SIZE];
+
+    // an uplink of one frame is sent without header
+    TEST_ASSERT_TRUE(fragmenter.plan(recordEnds, 2, FRAME_SIZE));
+    TEST_ASSERT_FALSE(fragmenter.isFragmented());
+    TEST_ASSERT_EQUAL_UINT8(1, fragmenter.getFrameCount());
+    TEST_ASSERT_EQUAL_size_t(6, fragmenter.writeFrame(0, message, frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(message, frame, 6);
+
+    // the frame does not fit into the buffer
+    TEST_ASSERT_EQUAL_size_t(0, fragmenter.writeFrame(0, message, frame, 5));
+
+    // the header round trip
+    uint8_t messageId;
+    uint8_t index;
+    uint8_t count;
+
+    SmFragmenter::writeHeader(frame, 0x2a, 31, 32);
+    SmFragmenter::readHeader(frame, messageId, index, count);
+
+    TEST_ASSERT_EQUAL_UINT8(0x2a, messageId);
+    TEST_ASSERT_EQUAL_UINT8(31, index);
+    TEST_ASSERT_EQUAL_UINT8(32, count);
+}
+
+void test_fragment_e450_reorder(void)
+{
+    SmFragmenter fragmenter;
+    SmReassembler reassembler;
+
+    // 364 bytes at 49 bytes per fragment (51 less the header)
+    uint8_t count = fragmentE450(fragmenter);
+
+    TEST_ASSERT_EQUAL_UINT8(8, count);
+    TEST_ASSERT_EQUAL_size_t(FRAME_SIZE, g_frameSizes[0]);
+
+    // the fragments arrive in reverse order
+    for(uint8_t i = count; i > 1; i--)
+    {
+        TEST_ASSERT_TRUE(reassembler.addFragment(g_frames[i - 1], g_frameSizes[i - 1]) == SmReassembler::SmFragmentResult::SMFRAGMENT_INCOMPLETE);
+    }
+
+    TEST_ASSERT_EQUAL_HEX32(0x01, reassembler.getMissing(fragmenter.getMessageId()));
+    TEST_ASSERT_TRUE(reassembler.addFragment(g_frames[0], g_frameSizes[0]) == SmReassembler::SmFragmentResult::SMFRAGMENT_COMPLETE);
+    TEST_ASSERT_EQUAL_UINT8(fragmenter.getMessageId(), reassembler.getMessageId());
+    TEST_ASSERT_EQUAL_HEX32(0, reassembler.getMissing(fragmenter.getMessageId()));
+
+    assertE450(reassembler);
+
+    // the fragments of two messages interleaved
+    uint8_t second[SmFragmenter::MAX_FRAGMENTS][FRAME_SIZE];
+    size_t secondSizes[SmFragmenter::MAX_FRAGMENTS];
+
+    memcpy(second, g_frames, sizeof(second));
+    memcpy(secondSizes, g_frameSizes, sizeof(secondSizes));
+
+    fragmentE450(fragmenter);
+
+    for(uint8_t i = 0; i < count - 1; i++)
+    {
+        TEST_ASSERT_TRUE(reassembler.addFragment(g_frames[i], g_frameSizes[i]) == SmReassembler::SmFragmentResult::SMFRAGMENT_INCOMPLETE);
+        TEST_ASSERT_TRUE(reassembler.addFragment(second[i], secondSizes[i]) == SmReassembler::SmFragmentResult::SMFRAGMENT_DUPLICATE);
+    }
+
+    TEST_ASSERT_TRUE(reassembler.addFragment(g_frames[count - 1], g_frameSizes[count - 1]) == SmReassembler::SmFragmentResult::SMFRAGMENT_COMPLETE);
+
+    assertE450(reassembler);
+}
+
+void test_fragment_duplicates(void)
+{
+    SmFragmenter fragmenter;
+    SmReassembler reassembler;
+
+    uint8_t count = fragmentE450(fragmenter);
+
+    // each fragment is received by two gateways
+    for(uint8_t i = 0; i < count; i++)
+    {
+        SmReassembler::SmFragmentResult expected = i < count - 1 ? SmReassembler::SmFragmentResult::SMFRAGMENT_INCOMPLETE : SmReassembler::SmFragmentResult::SMFRAGMENT_COMPLETE;
+
+        TEST_ASSERT_TRUE(reassembler.addFragment(g_frames[i], g_frameSizes[i]) == expected);
+        TEST_ASSERT_TRUE(reassembler.addFragment(g_frames[i], g_frameSizes[i]) == SmReassembler::SmFragmentResult::SMFRAGMENT_DUPLICATE);
+    }
+
+    assertE450(reassembler);
+
+    // a late duplicate does not complete the message again
+    TEST_ASSERT_TRUE(reassembler.addFragment(g_frames[3], g_frameSizes[3]) == SmReassembler::SmFragmentResult::SMFRAGMENT_DUPLICATE);
+}
+
+void test_fragment_loss(void)
+{
+    SmFragmenter fragmenter;
+    SmReassembler reassembler;
+
+    uint8_t count = fragmentE450(fragmenter);
+
+    // fragments 2 and 5 are lost
+    for(uint8_t i = 0; i < count; i++)
+    {
+        if(i != 2 && i != 5)
+        {
+            TEST_ASSERT_TRUE(reassembler.addFragment(g_frames[i], g_frameSizes[i]) == SmReassembler::SmFragmentResult::SMFRAGMENT_INCOMPLETE);
+        }
+    }
+
+    TEST_ASSERT_EQUAL_HEX32((1UL << 2) | (1UL << 5), reassembler.getMissing(fragmenter.getMessageId()));
+    TEST_ASSERT_EQUAL_size_t(0, reassembler.getMessageSize());
+
+    // only the missing fragments are sent again
+    TEST_ASSERT_TRUE(reassembler.addFragment(g_frames[5], g_frameSizes[5]) == SmReassembler::SmFragmentResult::SMFRAGMENT_INCOMPLETE);
+    TEST_ASSERT_EQUAL_HEX32(1UL << 2, reassembler.getMissing(fragmenter.getMessageId()));
+    TEST_ASSERT_TRUE(reassembler.addFragment(g_frames[2], g_frameSizes[2]) == SmReassembler::SmFragmentResult::SMFRAGMENT_COMPLETE);
+
+    assertE450(reassembler);
+
+    // an unknown message has no missing fragments
+    TEST_ASSERT_EQUAL_HEX32(0, reassembler.getMissing((fragmenter.getMessageId() + 1) & SmFragmenter::MESSAGE_ID_MASK));
+}
+
+void test_fragment_id_reuse(void)
+{
+    SmFragmenter fragmenter;
+    SmReassembler reassembler;
+
+    uint8_t count = fragmentE450(fragmenter);
+    uint8_t messageId = fragmenter.getMessageId();
+
+    for(uint8_t i = 0; i < count; i++)
+    {
+        reassembler.addFragment(g_frames[i], g_frameSizes[i]);
+    }
+
+    assertE450(reassembler);
+
+    // the id wraps after 64 fragmented uplinks
+    for(uint8_t i = 0; i <= SmFragmenter::MESSAGE_ID_MASK; i++)
+    {
+        fragmentE450(fragmenter);
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(messageId, fragmenter.getMessageId());
+
+    // a new message with the same id but other content replaces the completed one
+    uint8_t frame[FRAME_SIZE];
+
+    memcpy(frame, g_frames[0], g_frameSizes[0]);
+    frame[SmFragmenter::HEADER_SIZE] ^= 0xff;
+
+    TEST_ASSERT_TRUE(reassembler.addFragment(frame, g_frameSizes[0]) == SmReassembler::SmFragmentResult::SMFRAGMENT_INCOMPLETE);
+    TEST_ASSERT_EQUAL_HEX32(0xfe, reassembler.getMissing(messageId));
+
+    for(uint8_t i = 1; i < count; i++)
+    {
+        reassembler.addFragment(g_frames[i], g_frameSizes[i]);
+    }
+
+    TEST_ASSERT_EQUAL_size_t(E450_GBTPDU_SIZE, reassembler.getMessageSize());
+    TEST_ASSERT_EQUAL_HEX8(e450GbtPdu[0] ^ 0xff, reassembler.getMessage()[0]);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(e450GbtPdu + 1, reassembler.getMessage() + 1, E450_GBTPDU_SIZE - 1);
+
+    // more messages than slots, the oldest incomplete message is dropped
+    SmReassembler limited;
+
+    for(uint8_t id = 0; id <= SmReassembler::MAX_MESSAGES; id++)
+    {
+        SmFragmenter::writeHeader(frame, id, 0, 2);
+
+        TEST_ASSERT_TRUE(limited.addFragment(frame, 10) == SmReassembler::SmFragmentResult::SMFRAGMENT_INCOMPLETE);
+    }
+
+    TEST_ASSERT_EQUAL_HEX32(0, limited.getMissing(0));
+    TEST_ASSERT_EQUAL_HEX32(0x02, limited.getMissing(1));
+    TEST_ASSERT_EQUAL_HEX32(0x02, limited.getMissing(SmReassembler::MAX_MESSAGES));
+}
+
+void test_fragment_invalid(void)
+{
+    SmFragmenter fragmenter;
+    SmReassembler reassembler;
+    uint8_t frame[FRAME_SIZE] = { 0 };
+
+    // no payload after the header
+    TEST_ASSERT_TRUE(reassembler.addFragment(frame, SmFragmenter::HEADER_SIZE) == SmReassembler::SmFragmentResult::SMFRAGMENT_INVALID);
+
+    // the index is beyond the count
+    SmFragmenter::writeHeader(frame, 1, 4, 4);
+
+    TEST_ASSERT_TRUE(reassembler.addFragment(frame, sizeof(frame)) == SmReassembler::SmFragmentResult::SMFRAGMENT_INVALID);
+
+    // the payload is not larger than the header
+    uint16_t const recordEnd = 100;
+
+    TEST_ASSERT_FALSE(fragmenter.plan(&recordEnd, 1, SmFragmenter::HEADER_SIZE));
+
+    // more fragments than the header can count
+    TEST_ASSERT_FALSE(fragmenter.plan(&recordEnd, 1, 4));
+}
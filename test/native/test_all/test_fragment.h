@@ -0,0 +1,6 @@
+void test_fragment_single_frame(void);
+void test_fragment_e450_reorder(void);
+void test_fragment_duplicates(void);
+void test_fragment_loss(void);
+void test_fragment_id_reuse(void);
+void test_fragment_invalid(void);
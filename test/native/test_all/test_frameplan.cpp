@@ -0,0 +1,134 @@
+#include "unity.h"
+
+#include "test_frameplan.h"
+
+#include "smframeplan.h"
+
+// the frames cover the uplink without gaps, none exceeds the maximum size
+static void assertCovered(SmFramePlan const& plan, size_t const size, size_t const maxFrameSize)
+{
+    size_t end = 0;
+
+    for(uint8_t i = 0; i < plan.getFrameCount(); i++)
+    {
+        TEST_ASSERT_EQUAL_size_t(end, plan.getFrameStart(i));
+        TEST_ASSERT_TRUE(plan.getFrameSize(i) > 0);
+        TEST_ASSERT_TRUE(plan.getFrameSize(i) <= maxFrameSize);
+
+        end += plan.getFrameSize(i);
+    }
+
+    TEST_ASSERT_EQUAL_size_t(size, end);
+}
+
+void test_frameplan_single_frame(void)
+{
+    SmFramePlan plan;
+    uint16_t const recordEnds[] = { 6, 11, 20, 51 };
+
+    TEST_ASSERT_TRUE(plan.plan(recordEnds, 4, 51));
+    TEST_ASSERT_EQUAL_UINT8(1, plan.getFrameCount());
+    TEST_ASSERT_EQUAL_size_t(51, plan.getFrameSize(0));
+    TEST_ASSERT_FALSE(plan.hasSplitRecord());
+
+    // an empty uplink has no frames
+    TEST_ASSERT_TRUE(plan.plan(recordEnds, 0, 51));
+    TEST_ASSERT_EQUAL_UINT8(0, plan.getFrameCount());
+}
+
+void test_frameplan_record_boundaries(void)
+{
+    SmFramePlan plan;
+
+    // records of 10, 20, 30 and 15 bytes: 10 + 20 | 30 | 15, two frames cannot hold them in order
+    uint16_t const recordEnds[] = { 10, 30, 60, 75 };
+
+    TEST_ASSERT_TRUE(plan.plan(recordEnds, 4, 40));
+    TEST_ASSERT_EQUAL_UINT8(3, plan.getFrameCount());
+    TEST_ASSERT_EQUAL_size_t(30, plan.getFrameSize(0));
+    TEST_ASSERT_EQUAL_size_t(30, plan.getFrameSize(1));
+    TEST_ASSERT_EQUAL_size_t(15, plan.getFrameSize(2));
+    TEST_ASSERT_FALSE(plan.hasSplitRecord());
+
+    assertCovered(plan, 75, 40);
+
+    // a record which ends exactly at the maximum size stays in the frame
+    TEST_ASSERT_TRUE(plan.plan(recordEnds, 4, 60));
+    TEST_ASSERT_EQUAL_UINT8(2, plan.getFrameCount());
+    TEST_ASSERT_EQUAL_size_t(60, plan.getFrameSize(0));
+
+    assertCovered(plan, 75, 60);
+}
+
+void test_frameplan_split_record(void)
+{
+    SmFramePlan plan;
+
+    // a record of 100 bytes does not fit into a frame of 40 bytes, it is split after the record before it
+    uint16_t const recordEnds[] = { 5, 105, 110 };
+
+    TEST_ASSERT_TRUE(plan.plan(recordEnds, 3, 40));
+    TEST_ASSERT_TRUE(plan.hasSplitRecord());
+    TEST_ASSERT_EQUAL_UINT8(4, plan.getFrameCount());
+    TEST_ASSERT_EQUAL_size_t(5, plan.getFrameSize(0));
+    TEST_ASSERT_EQUAL_size_t(40, plan.getFrameSize(1));
+    TEST_ASSERT_EQUAL_size_t(40, plan.getFrameSize(2));
+
+    // the rest of the split record and the next record share the last frame
+    TEST_ASSERT_EQUAL_size_t(25, plan.getFrameSize(3));
+
+    assertCovered(plan, 110, 40);
+
+    // a block without records (e.g. the raw GBT block) is split into frames of the maximum size
+    uint16_t const blockEnd = 364;
+
+    TEST_ASSERT_TRUE(plan.plan(&blockEnd, 1, 222));
+    TEST_ASSERT_EQUAL_UINT8(2, plan.getFrameCount());
+
+    assertCovered(plan, 364, 222);
+}
+
+void test_frameplan_data_rates(void)
+{
+    SmFramePlan plan;
+    uint16_t recordEnds[24];
+
+    // an uplink like the cayenne uplink of the E450 push: time, 12 values of 7 bytes and 2 strings
+    uint16_t end = 0;
+    uint8_t count = 0;
+
+    recordEnds[count++] = end += 6;
+    recordEnds[count++] = end += 3 + 15;
+    recordEnds[count++] = end += 3 + 9;
+
+    for(uint8_t i = 0; i < 12; i++)
+    {
+        recordEnds[count++] = end += 7;
+    }
+
+    // the payload of EU868 DR0 to DR5 and of US915 DR0
+    size_t const payloads[] = { 51, 115, 222, 11 };
+    uint8_t const frames[] = { 3, 2, 1, 16 };
+
+    for(uint8_t i = 0; i < sizeof(payloads) / sizeof(payloads[0]); i++)
+    {
+        TEST_ASSERT_TRUE(plan.plan(recordEnds, count, payloads[i]));
+        TEST_ASSERT_EQUAL_UINT8(frames[i], plan.getFrameCount());
+
+        assertCovered(plan, end, payloads[i]);
+    }
+}
+
+void test_frameplan_invalid(void)
+{
+    SmFramePlan plan;
+    uint16_t const recordEnds[] = { 10, 1000 };
+
+    // no payload possible (pending MAC commands)
+    TEST_ASSERT_FALSE(plan.plan(recordEnds, 2, 0));
+    TEST_ASSERT_EQUAL_UINT8(0, plan.getFrameCount());
+
+    // more than MAX_FRAMES frames
+    TEST_ASSERT_FALSE(plan.plan(recordEnds, 2, 11));
+    TEST_ASSERT_EQUAL_UINT8(0, plan.getFrameCount());
+}
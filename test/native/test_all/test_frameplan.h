@@ -0,0 +1,5 @@
+void test_frameplan_single_frame(void);
+void test_frameplan_record_boundaries(void);
+void test_frameplan_split_record(void);
+void test_frameplan_data_rates(void);
+void test_frameplan_invalid(void);
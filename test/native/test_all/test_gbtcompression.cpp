@@ -0,0 +1,129 @@
+#include <string.h>
+
+#include "unity.h"
+
+#include "test_gbtcompression.h"
+#include "test_fixtures.h"
+
+#include "smgbtcompressor.h"
+#include "smgbtdecompressor.h"
+#include "smprofile.h"
+
+static SmGbtCompressor g_compressor;
+static uint8_t g_restored[SmGbtCompressor::MAX_INPUT_SIZE];
+
+static void assertRoundtrip(uint8_t const* data, size_t const size)
+{
+    size_t compressed = g_compressor.compress(data, size);
+
+    TEST_ASSERT_TRUE(compressed > 0);
+    TEST_ASSERT_TRUE(compressed <= SmGbtCompressor::MAX_OUTPUT_SIZE);
+    TEST_ASSERT_EQUAL_size_t(size, SmGbtDecompressor::decompress(g_compressor.getOutput(), compressed, g_restored, sizeof(g_restored)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data, g_restored, size);
+}
+
+void test_gbtcompression_e450_roundtrip(void)
+{
+    TEST_ASSERT_TRUE(g_compressor.select(SmProfiles::SMPROFILE_LG_E450));
+
+    size_t compressed = g_compressor.compress(e450GbtPdu, E450_GBTPDU_SIZE);
+
+    // the capture object list is in the dictionary, the header, the device name and the values remain
+    TEST_ASSERT_TRUE(compressed < E450_GBTPDU_SIZE / 4);
+    TEST_ASSERT_EQUAL_UINT8(SmProfiles::SMPROFILE_LG_E450, g_compressor.getOutput()[0]);
+
+    assertRoundtrip(e450GbtPdu, E450_GBTPDU_SIZE);
+
+    // other values with the same layout
+    uint8_t push[E450_GBTPDU_SIZE];
+
+    memcpy(push, e450GbtPdu, sizeof(push));
+
+    for(size_t i = 310; i < sizeof(push); i += 3)
+    {
+        push[i] ^= 0x5a;
+    }
+
+    assertRoundtrip(push, sizeof(push));
+}
+
+void test_gbtcompression_long_match(void)
+{
+    TEST_ASSERT_TRUE(g_compressor.select(SmProfiles::SMPROFILE_LG_E450));
+
+    // a run which overlaps the bytes it produces and needs several extension bytes
+    uint8_t run[700];
+
+    memset(run, 0x42, sizeof(run));
+
+    assertRoundtrip(run, sizeof(run));
+
+    TEST_ASSERT_TRUE(g_compressor.compress(run, sizeof(run)) < 16);
+
+    // the push twice, the second one refers back to the first
+    static uint8_t twice[2 * E450_GBTPDU_SIZE];
+
+    memcpy(twice, e450GbtPdu, E450_GBTPDU_SIZE);
+    memcpy(twice + E450_GBTPDU_SIZE, e450GbtPdu, E450_GBTPDU_SIZE);
+
+    assertRoundtrip(twice, sizeof(twice));
+}
+
+void test_gbtcompression_incompressible(void)
+{
+    TEST_ASSERT_TRUE(g_compressor.select(SmProfiles::SMPROFILE_LG_E450));
+
+    // pseudo random bytes, the output stays within the size of the literals
+    uint8_t noise[SmGbtCompressor::MAX_INPUT_SIZE];
+    uint32_t random = 1;
+
+    for(size_t i = 0; i < sizeof(noise); i++)
+    {
+        random = random * 1103515245UL + 12345UL;
+        noise[i] = (random >> 16) & 0xff;
+    }
+
+    assertRoundtrip(noise, sizeof(noise));
+
+    // an empty push is the profile id only
+    TEST_ASSERT_EQUAL_size_t(1, g_compressor.compress(noise, 0));
+
+    // too large
+    TEST_ASSERT_EQUAL_size_t(0, g_compressor.compress(noise, SmGbtCompressor::MAX_INPUT_SIZE + 1));
+}
+
+void test_gbtcompression_invalid(void)
+{
+    SmGbtCompressor compressor;
+
+    // no dictionary selected or the profile has none
+    TEST_ASSERT_EQUAL_size_t(0, compressor.compress(e450GbtPdu, E450_GBTPDU_SIZE));
+    TEST_ASSERT_FALSE(compressor.select(0xee));
+    TEST_ASSERT_NULL(compressor.getDictionary());
+
+    uint8_t buffer[16];
+
+    // unknown profile
+    uint8_t const unknown[] = { 0xee, 0x00, 0x01 };
+
+    TEST_ASSERT_EQUAL_size_t(0, SmGbtDecompressor::decompress(unknown, sizeof(unknown), buffer, sizeof(buffer)));
+
+    // truncated literals and back-reference
+    uint8_t const truncatedLiterals[] = { SmProfiles::SMPROFILE_LG_E450, 0x03, 0x01, 0x02 };
+    uint8_t const truncatedMatch[] = { SmProfiles::SMPROFILE_LG_E450, 0x80 };
+
+    TEST_ASSERT_EQUAL_size_t(0, SmGbtDecompressor::decompress(truncatedLiterals, sizeof(truncatedLiterals), buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_size_t(0, SmGbtDecompressor::decompress(truncatedMatch, sizeof(truncatedMatch), buffer, sizeof(buffer)));
+
+    // a back-reference before the dictionary
+    uint8_t const beforeDictionary[] = { SmProfiles::SMPROFILE_LG_E450, 0x87, 0xff };
+
+    TEST_ASSERT_EQUAL_size_t(0, SmGbtDecompressor::decompress(beforeDictionary, sizeof(beforeDictionary), buffer, sizeof(buffer)));
+
+    // the push does not fit into the buffer
+    TEST_ASSERT_TRUE(compressor.select(SmProfiles::SMPROFILE_LG_E450));
+
+    size_t compressed = compressor.compress(e450GbtPdu, E450_GBTPDU_SIZE);
+
+    TEST_ASSERT_EQUAL_size_t(0, SmGbtDecompressor::decompress(compressor.getOutput(), compressed, buffer, sizeof(buffer)));
+}
@@ -0,0 +1,4 @@
+void test_gbtcompression_e450_roundtrip(void);
+void test_gbtcompression_long_match(void);
+void test_gbtcompression_incompressible(void);
+void test_gbtcompression_invalid(void);
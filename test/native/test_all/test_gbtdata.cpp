@@ -0,0 +1,150 @@
+#include "unity.h"
+
+#include <string.h>
+
+#include "test_gbtdata.h"
+#include "test_fixtures.h"
+
+#include "gbtdata.h"
+#include "gbtoctetstring.h"
+#include "gbtuint16.h"
+#include "gbtuint32.h"
+#include "gbtvaluemask.h"
+
+static GbtData gbtDataLongLived;                                    // one instance for all frames, as in the Wmb controller
+
+void test_gbtdata_reuse(void)
+{
+    char firstValues[74][32];
+
+    TEST_ASSERT_EQUAL_INT(0, gbtDataLongLived.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+    TEST_ASSERT_EQUAL_UINT8(74, gbtDataLongLived.getValueCount());
+
+    for(uint8_t i = 0; i < 74; i++)
+    {
+        gbtDataLongLived.getValue(i)->asString(firstValues[i], sizeof(firstValues[i]));
+    }
+
+    gbtDataLongLived.reset();
+
+    TEST_ASSERT_EQUAL_UINT8(0, gbtDataLongLived.getValueCount());
+    TEST_ASSERT_NULL(gbtDataLongLived.getValue(0));
+    TEST_ASSERT_EQUAL_UINT16(0, gbtDataLongLived.getDateTime().getYear());
+
+    // parse the same frame several times, the values must not accumulate
+    for(uint8_t loop = 0; loop < 3; loop++)
+    {
+        TEST_ASSERT_EQUAL_INT(0, gbtDataLongLived.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+        TEST_ASSERT_EQUAL_UINT8(74, gbtDataLongLived.getValueCount());
+        TEST_ASSERT_EQUAL_UINT16(2022, gbtDataLongLived.getDateTime().getYear());
+
+        for(uint8_t i = 0; i < 74; i++)
+        {
+            char value[32];
+
+            gbtDataLongLived.getValue(i)->asString(value, sizeof(value));
+
+            TEST_ASSERT_EQUAL_STRING(firstValues[i], value);
+        }
+    }
+}
+
+void test_gbtdata_capacity(void)
+{
+    GbtDataStore<10, 2> gbtDataSmall;
+
+    // the value which does not fit stops the parse, the values before it are kept at their index
+    TEST_ASSERT_EQUAL_INT(GbtDataBase::GBTPARSE_VALUEDROPPED, gbtDataSmall.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+    TEST_ASSERT_EQUAL_UINT8(10, gbtDataSmall.getMaxValues());
+    TEST_ASSERT_EQUAL_UINT8(9, gbtDataSmall.getValueCount());
+
+    uint8_t stringCount = 0;
+
+    for(uint8_t i = 0; i < gbtDataSmall.getValueCount(); i++)
+    {
+        if(gbtDataSmall.getValue(i)->getValueType() == GbtValueBase::GbtValueType::GBTVALUETYPE_OCTETESTRING)
+        {
+            stringCount++;
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(2, stringCount);
+    TEST_ASSERT_EQUAL_STRING("0.8.25.9.0.255", static_cast<GbtOctetString const*>(gbtDataSmall.getValue(1))->getStringValue());
+
+    // the numeric values are limited as well
+    GbtDataStore<8, 8> gbtDataFew;
+
+    TEST_ASSERT_EQUAL_INT(GbtDataBase::GBTPARSE_VALUEDROPPED, gbtDataFew.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+    TEST_ASSERT_EQUAL_UINT8(8, gbtDataFew.getValueCount());
+
+    // an octet string longer than the string buffer stops the parse as well, a new parse starts over
+    uint8_t const longString[] = { 0x02, 0x02, 0x12, 0x00, 0x01, 0x09, 0x20,
+        0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41,
+        0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x12, 0x00, 0x02 };
+
+    TEST_ASSERT_EQUAL_INT(GbtDataBase::GBTPARSE_VALUEDROPPED, gbtDataLongLived.parse(longString, sizeof(longString)));
+    TEST_ASSERT_EQUAL_UINT8(1, gbtDataLongLived.getValueCount());
+
+    TEST_ASSERT_EQUAL_INT(0, gbtDataLongLived.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+    TEST_ASSERT_EQUAL_UINT8(74, gbtDataLongLived.getValueCount());
+}
+
+void test_gbtdata_skip(void)
+{
+    GbtValueMask skipMask;
+
+    // a skipped octet string is not formatted, even if it is too long for the string buffer
+    uint8_t const longString[] = { 0x02, 0x02, 0x12, 0x00, 0x01, 0x09, 0x20,
+        0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41,
+        0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x12, 0x00, 0x02 };
+
+    TEST_ASSERT_TRUE(skipMask.isEmpty());
+
+    skipMask.set(1);
+
+    TEST_ASSERT_FALSE(skipMask.isEmpty());
+    TEST_ASSERT_TRUE(skipMask.isSet(1));
+    TEST_ASSERT_FALSE(skipMask.isSet(0));
+
+    TEST_ASSERT_EQUAL_INT(0, gbtDataLongLived.parse(longString, sizeof(longString), skipMask));
+    TEST_ASSERT_EQUAL_UINT8(3, gbtDataLongLived.getValueCount());
+    TEST_ASSERT_NOT_NULL(gbtDataLongLived.getValue(0));
+    TEST_ASSERT_NULL(gbtDataLongLived.getValue(1));
+    TEST_ASSERT_EQUAL_UINT16(2, static_cast<GbtUint16 const*>(gbtDataLongLived.getValue(2))->getValue());
+
+    // the skipped values keep their index and use no slot (the E450 push has 17 strings), the other values are the same as without mask
+    GbtDataStore<74, 16> gbtDataSkipped;
+
+    skipMask.clear();
+
+    for(uint8_t i = 56; i < 74; i++)
+    {
+        skipMask.set(i);
+    }
+
+    TEST_ASSERT_EQUAL_INT(GbtDataBase::GBTPARSE_VALUEDROPPED, gbtDataSkipped.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+    TEST_ASSERT_EQUAL_INT(0, gbtDataSkipped.parse(e450GbtPdu, E450_GBTPDU_SIZE, skipMask));
+    TEST_ASSERT_EQUAL_UINT8(74, gbtDataSkipped.getValueCount());
+    TEST_ASSERT_EQUAL_INT(0, gbtDataLongLived.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+
+    for(uint8_t i = 0; i < 74; i++)
+    {
+        if(skipMask.isSet(i))
+        {
+            TEST_ASSERT_NULL(gbtDataSkipped.getValue(i));
+
+            continue;
+        }
+
+        char expected[32];
+        char value[32];
+
+        gbtDataLongLived.getValue(i)->asString(expected, sizeof(expected));
+        gbtDataSkipped.getValue(i)->asString(value, sizeof(value));
+
+        TEST_ASSERT_EQUAL_STRING(expected, value);
+    }
+
+    // the mask only applies to the parse it was given to
+    TEST_ASSERT_EQUAL_INT(GbtDataBase::GBTPARSE_VALUEDROPPED, gbtDataLongLived.parse(longString, sizeof(longString)));
+}
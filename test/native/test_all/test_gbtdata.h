@@ -0,0 +1,3 @@
+void test_gbtdata_reuse(void);
+void test_gbtdata_capacity(void);
+void test_gbtdata_skip(void);
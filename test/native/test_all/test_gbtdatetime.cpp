@@ -0,0 +1,155 @@
+#include "unity.h"
+
+#include <time.h>
+
+#include "test_gbtdatetime.h"
+#include "test_fixtures.h"
+
+#include "gbtddatetime.h"
+#include "gbtdata.h"
+
+static_assert(GbtDateTime::daysFromCivil(1970, 1, 1) == 0, "epoch");
+static_assert(GbtDateTime::daysFromCivil(2000, 3, 1) == 11017, "leap year 2000");
+static_assert(GbtDateTime::daysFromCivil(1969, 12, 31) == -1, "before epoch");
+
+// encodes a GBT date time element (0x0c identifier followed by the 12 date time bytes)
+static void encodeDateTime(uint8_t* buffer, uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second, int16_t deviation, uint8_t clockStatus)
+{
+    buffer[0] = 0x0c;
+    buffer[1] = year >> 8;
+    buffer[2] = year & 0xff;
+    buffer[3] = month;
+    buffer[4] = day;
+    buffer[5] = 0xff;
+    buffer[6] = hour;
+    buffer[7] = minute;
+    buffer[8] = second;
+    buffer[9] = 0xff;
+    buffer[10] = ((uint16_t) deviation) >> 8;
+    buffer[11] = ((uint16_t) deviation) & 0xff;
+    buffer[12] = clockStatus;
+}
+
+static uint8_t daysInMonth(int year, int month)
+{
+    static uint8_t const DAYS[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+    bool leapYear = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+
+    return (month == 2 && leapYear) ? 29 : DAYS[month - 1];
+}
+
+void test_gbtdatetime_days_from_civil(void)
+{
+    TEST_ASSERT_EQUAL_INT32(19352, GbtDateTime::daysFromCivil(2022, 12, 26));
+    TEST_ASSERT_EQUAL_INT32(47482, GbtDateTime::daysFromCivil(2100, 1, 1));
+}
+
+void test_gbtdatetime_against_timegm(void)
+{
+    uint8_t buffer[13];
+    uint32_t dayCount = 0;
+
+    // every day from 1970 to 2100, the time of the day varies with the day
+    for(int year = 1970; year <= 2100; year++)
+    {
+        for(int month = 1; month <= 12; month++)
+        {
+            for(int day = 1; day <= daysInMonth(year, month); day++)
+            {
+                uint8_t hour = dayCount % 24;
+                uint8_t minute = (dayCount * 7) % 60;
+                uint8_t second = (dayCount * 13) % 60;
+
+                encodeDateTime(buffer, year, month, day, hour, minute, second, GbtDateTime::DEVIATION_NOT_SPECIFIED, 0x00);
+
+                GbtDateTime dateTime;
+                ByteCursor cursor(buffer, sizeof(buffer));
+
+                dateTime.parse(cursor, 0, 0);
+
+                struct tm timeinfo = {};
+
+                timeinfo.tm_year = year - 1900;
+                timeinfo.tm_mon = month - 1;
+                timeinfo.tm_mday = day;
+                timeinfo.tm_hour = hour;
+                timeinfo.tm_min = minute;
+                timeinfo.tm_sec = second;
+
+                if((int64_t) timegm(&timeinfo) != (int64_t) dateTime.asUnixTimeStamp())
+                {
+                    char message[64];
+
+                    snprintf(message, sizeof(message), "Mismatch for %04d-%02d-%02d", year, month, day);
+
+                    TEST_FAIL_MESSAGE(message);
+
+                    return;
+                }
+
+                dayCount++;
+            }
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(47847, dayCount);
+}
+
+void test_gbtdatetime_deviation_and_status(void)
+{
+    uint8_t buffer[13];
+    // 26.06.2023 14:00:00 CEST (UTC+2, DLMS deviation -120), daylight saving active
+    encodeDateTime(buffer, 2023, 6, 26, 14, 0, 0, -120, GbtDateTime::CLOCKSTATUS_DAYLIGHT_SAVING);
+
+    GbtDateTime dateTime;
+    ByteCursor cursor(buffer, sizeof(buffer));
+
+    TEST_ASSERT_TRUE(dateTime.parse(cursor, 0, 0));
+    TEST_ASSERT_EQUAL_INT(13, cursor.position());
+    TEST_ASSERT_EQUAL_INT16(-120, dateTime.getDeviation());
+    TEST_ASSERT_TRUE(dateTime.isDaylightSavingActive());
+    TEST_ASSERT_FALSE(dateTime.isInvalidValue());
+
+    // 26.06.2023 12:00:00 UTC
+    TEST_ASSERT_EQUAL_INT64(1687780800, (int64_t) dateTime.asUnixTimeStamp());
+
+    encodeDateTime(buffer, 2023, 6, 26, 14, 0, 0, -60, GbtDateTime::CLOCKSTATUS_INVALID_VALUE);
+
+    ByteCursor invalidCursor(buffer, sizeof(buffer));
+
+    dateTime.parse(invalidCursor, 0, 0);
+
+    TEST_ASSERT_TRUE(dateTime.isInvalidValue());
+    TEST_ASSERT_FALSE(dateTime.isDaylightSavingActive());
+    TEST_ASSERT_EQUAL_INT64(1687784400, (int64_t) dateTime.asUnixTimeStamp());
+}
+
+void test_gbtdatetime_not_specified(void)
+{
+    GbtData gbtData;
+
+    gbtData.parse(e450GbtPdu, E450_GBTPDU_SIZE);
+
+    auto const& dateTime = gbtData.getDateTime();
+
+    // the E450 does not send deviation and clock status, the fields are taken as UTC
+    TEST_ASSERT_EQUAL_INT16(GbtDateTime::DEVIATION_NOT_SPECIFIED, dateTime.getDeviation());
+    TEST_ASSERT_FALSE(dateTime.isInvalidValue());
+    TEST_ASSERT_FALSE(dateTime.isDaylightSavingActive());
+
+    // 26.12.2022 01:30:35
+    TEST_ASSERT_EQUAL_INT64(1672018235, (int64_t) dateTime.asUnixTimeStamp());
+
+    uint8_t buffer[13];
+    encodeDateTime(buffer, 0xffff, 0xff, 0xff, 0xff, 0xff, 0xff, GbtDateTime::DEVIATION_NOT_SPECIFIED, GbtDateTime::CLOCKSTATUS_NOT_SPECIFIED);
+
+    GbtDateTime notSpecified;
+
+    ByteCursor cursor(buffer, sizeof(buffer));
+
+    notSpecified.parse(cursor, 0, 0);
+
+    TEST_ASSERT_FALSE(notSpecified.isSpecified());
+    TEST_ASSERT_EQUAL_INT64(0, (int64_t) notSpecified.asUnixTimeStamp());
+}
@@ -0,0 +1,4 @@
+void test_gbtdatetime_days_from_civil(void);
+void test_gbtdatetime_against_timegm(void);
+void test_gbtdatetime_deviation_and_status(void);
+void test_gbtdatetime_not_specified(void);
@@ -0,0 +1,92 @@
+#include "unity.h"
+
+#include <string.h>
+
+#include "test_gbtparser.h"
+#include "test_fixtures.h"
+
+#include "gbtparser.h"
+#include "gbtdata.h"
+
+// counts all the values of a PDU without materialising them
+class CountingVisitor : public GbtVisitor
+{
+    public:
+        uint8_t valueCount = 0;
+        uint8_t structureCount = 0;
+        uint8_t arrayCount = 0;
+        uint16_t year = 0;
+
+        GbtVisitResult onDateTime(GbtDateTime const& dateTime) { year = dateTime.getYear(); return GbtVisitResult::GBTVISIT_CONTINUE; }
+        GbtVisitResult onStructureBegin(uint8_t const elementCount) { structureCount++; return GbtVisitResult::GBTVISIT_CONTINUE; }
+        GbtVisitResult onArrayBegin(uint8_t const elementCount) { arrayCount++; return GbtVisitResult::GBTVISIT_CONTINUE; }
+        GbtVisitResult onUint8(uint8_t const value, uint8_t const structureIdent, uint8_t const arrayIdent) { valueCount++; return GbtVisitResult::GBTVISIT_CONTINUE; }
+        GbtVisitResult onUint16(uint16_t const value, uint8_t const structureIdent, uint8_t const arrayIdent) { valueCount++; return GbtVisitResult::GBTVISIT_CONTINUE; }
+        GbtVisitResult onUint32(uint32_t const value, uint8_t const structureIdent, uint8_t const arrayIdent) { valueCount++; return GbtVisitResult::GBTVISIT_CONTINUE; }
+        GbtVisitResult onOctetString(uint8_t const* data, uint8_t const length, uint8_t const structureIdent, uint8_t const arrayIdent) { valueCount++; return GbtVisitResult::GBTVISIT_CONTINUE; }
+};
+
+// looks for the logical device name (octet string following the 0.8.25.9.0.255 OBIS code) and stops
+class DeviceNameVisitor : public GbtVisitor
+{
+    public:
+        char deviceName[32] = "";
+        uint8_t valueCount = 0;
+
+        GbtVisitResult onUint8(uint8_t const value, uint8_t const structureIdent, uint8_t const arrayIdent) { return next(); }
+        GbtVisitResult onUint16(uint16_t const value, uint8_t const structureIdent, uint8_t const arrayIdent) { return next(); }
+        GbtVisitResult onUint32(uint32_t const value, uint8_t const structureIdent, uint8_t const arrayIdent) { return next(); }
+
+        GbtVisitResult onOctetString(uint8_t const* data, uint8_t const length, uint8_t const structureIdent, uint8_t const arrayIdent)
+        {
+            static uint8_t const DEVICENAME_OBIS[6] = { 0, 8, 25, 9, 0, 255 };
+
+            valueCount++;
+
+            if(m_deviceNameFollows && length < sizeof(deviceName))
+            {
+                memcpy(deviceName, data, length);
+                deviceName[length] = 0;
+
+                return GbtVisitResult::GBTVISIT_STOP;
+            }
+
+            m_deviceNameFollows = GbtParser::isObis(data, length, DEVICENAME_OBIS);
+
+            return GbtVisitResult::GBTVISIT_CONTINUE;
+        }
+
+    private:
+        bool m_deviceNameFollows = false;
+
+        GbtVisitResult next() { valueCount++; m_deviceNameFollows = false; return GbtVisitResult::GBTVISIT_CONTINUE; }
+};
+
+void test_gbtparser_value_count(void)
+{
+    CountingVisitor visitor;
+
+    TEST_ASSERT_EQUAL_INT(0, GbtParser::parse(e450GbtPdu, E450_GBTPDU_SIZE, visitor));
+
+    GbtData gbtData;
+
+    TEST_ASSERT_EQUAL_INT(0, gbtData.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+
+    TEST_ASSERT_EQUAL_INT8(74, visitor.valueCount);
+    TEST_ASSERT_EQUAL_INT8(gbtData.getValueCount(), visitor.valueCount);
+    TEST_ASSERT_EQUAL_INT8(16, visitor.structureCount);
+    TEST_ASSERT_EQUAL_INT8(1, visitor.arrayCount);
+    TEST_ASSERT_EQUAL_INT16(2022, visitor.year);
+}
+
+void test_gbtparser_device_name_early_exit(void)
+{
+    DeviceNameVisitor visitor;
+
+    TEST_ASSERT_EQUAL_INT(0, GbtParser::parse(e450GbtPdu, E450_GBTPDU_SIZE, visitor));
+
+    TEST_ASSERT_EQUAL_STRING("60222999", visitor.deviceName);
+
+    // the device name is the 62nd value, the values behind it are not visited
+    TEST_ASSERT_EQUAL_INT8(62, visitor.valueCount);
+}
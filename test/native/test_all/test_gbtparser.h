@@ -0,0 +1,2 @@
+void test_gbtparser_value_count(void);
+void test_gbtparser_device_name_early_exit(void);
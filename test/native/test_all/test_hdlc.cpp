@@ -3,73 +3,12 @@
 #include <string.h>
 
 #include "test_hdlc.h"
+#include "test_fixtures.h"
 
 #include "hdlc.h"
 #include "dlms.h"
 #include "gbtdata.h"
 
-#define HDLC_ARRAY_SIZE  443
-
-const uint8_t hdlcArray[HDLC_ARRAY_SIZE] = {
-      0x7e, 0xa0, 0x84, 0xce, 0xff, 0x03, 0x13, 0x12, 
-      0x8b, 0xe6, 0xe7, 0x00, 0xe0, 0x40, 0x00, 0x01, 
-      0x00, 0x00, 0x70, 0x0f, 0x00, 0x02, 0x32, 0x24, 
-      0x0c, 0x07, 0xe6, 0x0b, 0x0b, 0x05, 0x14, 0x25, 
-      0x1e, 0xff, 0x80, 0x00, 0x00, 0x02, 0x0f, 0x01, 
-      0x0f, 0x02, 0x04, 0x12, 0x00, 0x28, 0x09, 0x06, 
-      0x00, 0x08, 0x19, 0x09, 0x00, 0xff, 0x0f, 0x02, 
-      0x12, 0x00, 0x00, 0x02, 0x04, 0x12, 0x00, 0x28, 
-      0x09, 0x06, 0x00, 0x08, 0x19, 0x09, 0x00, 0xff, 
-      0x0f, 0x01, 0x12, 0x00, 0x00, 0x02, 0x04, 0x12, 
-      0x00, 0x01, 0x09, 0x06, 0x00, 0x00, 0x60, 0x01, 
-      0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00, 0x02, 
-      0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x00, 
-      0x01, 0x07, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 
-      0x00, 0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 
-      0x01, 0x00, 0x02, 0x07, 0x00, 0xff, 0x0f, 0x02, 
-      0x12, 0x00, 0x00, 0xb3, 0xf2, 0x7e, 0x7e, 0xa0, 
-      0x7d, 0xce, 0xff, 0x03, 0x13, 0xd0, 0x45, 0xe0, 
-      0x40, 0x00, 0x02, 0x00, 0x00, 0x6c, 0x02, 0x04, 
-      0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x01, 0x01, 
-      0x08, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00, 
-      0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 
-      0x01, 0x02, 0x08, 0x00, 0xff, 0x0f, 0x02, 0x12, 
-      0x00, 0x00, 0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 
-      0x06, 0x01, 0x01, 0x05, 0x08, 0x00, 0xff, 0x0f, 
-      0x02, 0x12, 0x00, 0x00, 0x02, 0x04, 0x12, 0x00, 
-      0x03, 0x09, 0x06, 0x01, 0x01, 0x06, 0x08, 0x00, 
-      0xff, 0x0f, 0x02, 0x12, 0x00, 0x00, 0x02, 0x04, 
-      0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x01, 0x07, 
-      0x08, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00, 
-      0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 
-      0x01, 0x08, 0x08, 0x00, 0xff, 0x0f, 0x02, 0x12, 
-      0x00, 0x00, 0xc1, 0x95, 0x7e, 0x7e, 0xa0, 0x84, 
-      0xce, 0xff, 0x03, 0x13, 0x12, 0x8b, 0xe0, 0x40, 
-      0x00, 0x03, 0x00, 0x00, 0x73, 0x02, 0x04, 0x12, 
-      0x00, 0x03, 0x09, 0x06, 0x01, 0x00, 0x82, 0x07, 
-      0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00, 0x02, 
-      0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x00, 
-      0x1f, 0x07, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 
-      0x00, 0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 
-      0x01, 0x00, 0x33, 0x07, 0x00, 0xff, 0x0f, 0x02, 
-      0x12, 0x00, 0x00, 0x02, 0x04, 0x12, 0x00, 0x03, 
-      0x09, 0x06, 0x01, 0x00, 0x47, 0x07, 0x00, 0xff, 
-      0x0f, 0x02, 0x12, 0x00, 0x00, 0x09, 0x06, 0x00, 
-      0x08, 0x19, 0x09, 0x00, 0xff, 0x09, 0x08, 0x36, 
-      0x30, 0x32, 0x32, 0x32, 0x39, 0x39, 0x39, 0x06, 
-      0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 
-      0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 
-      0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 
-      0x66, 0xaa, 0x7e, 0x7e, 0xa0, 0x2e, 0xce, 0xff, 
-      0x03, 0x13, 0x7e, 0x2d, 0xe0, 0xc0, 0x00, 0x04, 
-      0x00, 0x00, 0x1d, 0x06, 0x00, 0x00, 0x00, 0x01, 
-      0x06, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 
-      0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x12, 
-      0x00, 0x00, 0x12, 0x00, 0x00, 0x12, 0x00, 0x00, 
-      0x61, 0x14, 0x7e
-};
-
-
 #define GBT_MYARRAY_SIZE 364
 
 const uint8_t gbtArray[GBT_MYARRAY_SIZE] = {
@@ -240,9 +179,67 @@ void test_full_hdlc(void)
 {
     dlms.reset();
 
-    for(size_t i = 0; i<HDLC_ARRAY_SIZE; i++)
+    for(size_t i = 0; i<E450_HDLC_SIZE; i++)
+    {
+      hdlc.charReceiver(e450HdlcFrames[i]);    
+    }
+}
+
+static size_t validFrameCount = 0;
+static size_t invalidFrameCount = 0;
+static size_t frameSizeSum = 0;
+
+void counting_frame_handler(uint8_t const* data, size_t const length, bool const frameValid) {
+
+    if(frameValid)
+    {
+      validFrameCount++;
+    }
+    else
+    {
+      invalidFrameCount++;
+    }
+
+    frameSizeSum += length;
+}
+
+Hdlc countingHdlc(&counting_frame_handler);
+
+void test_chunked_hdlc(void)
+{
+    // the frames received byte by byte
+    validFrameCount = 0;
+    invalidFrameCount = 0;
+    frameSizeSum = 0;
+
+    for(size_t i = 0; i<E450_HDLC_SIZE; i++)
+    {
+      countingHdlc.charReceiver(e450HdlcFrames[i]);
+    }
+
+    size_t const expectedValid = validFrameCount;
+    size_t const expectedSizeSum = frameSizeSum;
+
+    TEST_ASSERT_EQUAL_size_t(4, expectedValid);
+    TEST_ASSERT_EQUAL_size_t(0, invalidFrameCount);
+
+    // the same frames received in chunks, the chunks split the frames at any position
+    size_t const chunkSizes[] = { 1, 5, 64, E450_HDLC_SIZE };
+
+    for(size_t chunkSize : chunkSizes)
     {
-      hdlc.charReceiver(hdlcArray[i]);    
+      validFrameCount = 0;
+      invalidFrameCount = 0;
+      frameSizeSum = 0;
+
+      for(size_t pos = 0; pos < E450_HDLC_SIZE; pos += chunkSize)
+      {
+        countingHdlc.bytesReceiver(e450HdlcFrames + pos, pos + chunkSize <= E450_HDLC_SIZE ? chunkSize : E450_HDLC_SIZE - pos);
+      }
+
+      TEST_ASSERT_EQUAL_size_t(expectedValid, validFrameCount);
+      TEST_ASSERT_EQUAL_size_t(0, invalidFrameCount);
+      TEST_ASSERT_EQUAL_size_t(expectedSizeSum, frameSizeSum);
     }
 }
 
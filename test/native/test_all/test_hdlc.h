@@ -1,2 +1,3 @@
 void test_full_hdlc(void);
+void test_chunked_hdlc(void);
 void test_gbt_array2(void);
\ No newline at end of file
@@ -2,6 +2,28 @@
 #include "test_hdlc.h"
 #include "test_decrypt.h"
 #include "test_memory.h"
+#include "test_gbtparser.h"
+#include "test_gbtdatetime.h"
+#include "test_gbtdata.h"
+#include "test_bytecursor.h"
+#include "test_smprofile.h"
+#include "test_smscaler.h"
+#include "test_meterbus.h"
+#include "test_pushscheduler.h"
+#include "test_autodetect.h"
+#include "test_pushextractor.h"
+#include "test_aggregator.h"
+#include "test_eventrules.h"
+#include "test_derived.h"
+#include "test_deltacodec.h"
+#include "test_dictionary.h"
+#include "test_fixedlayout.h"
+#include "test_frameplan.h"
+#include "test_fragment.h"
+#include "test_gbtcompression.h"
+#include "test_priorityplan.h"
+#include "test_registerfilter.h"
+#include "test_txqueue.h"
 
 // runt tests in a PlatformIO Terminal window using 
 // pio test -e testnative -v
@@ -25,8 +47,112 @@ int runUnityTests(void) {
   for (size_t i = 0; i < minloops; i++)
   {
     RUN_TEST(test_full_hdlc);
+    RUN_TEST(test_chunked_hdlc);
     RUN_TEST(test_gbt_array2);
     RUN_TEST(test_decript_hdlc);
+    RUN_TEST(test_gbtparser_value_count);
+    RUN_TEST(test_gbtparser_device_name_early_exit);
+    RUN_TEST(test_gbtdatetime_days_from_civil);
+    RUN_TEST(test_gbtdatetime_against_timegm);
+    RUN_TEST(test_gbtdatetime_deviation_and_status);
+    RUN_TEST(test_gbtdatetime_not_specified);
+    RUN_TEST(test_gbtdata_reuse);
+    RUN_TEST(test_gbtdata_capacity);
+    RUN_TEST(test_gbtdata_skip);
+    RUN_TEST(test_bytecursor_big_endian);
+    RUN_TEST(test_bytecursor_truncated_pdu);
+    RUN_TEST(test_bytecursor_truncated_gbtblock);
+    RUN_TEST(test_smprofile_lookup);
+    RUN_TEST(test_smprofile_e450_layout);
+    RUN_TEST(test_smprofile_layout_cache);
+    RUN_TEST(test_smscaler_fixed_point);
+    RUN_TEST(test_smscaler_scale);
+    RUN_TEST(test_smscaler_profile_units);
+    RUN_TEST(test_smscaler_pushed_scaler_unit);
+    RUN_TEST(test_meterbus_hdlc_header);
+    RUN_TEST(test_meterbus_demux);
+    RUN_TEST(test_meterbus_timeout);
+    RUN_TEST(test_meterbus_invalid_frame);
+    RUN_TEST(test_pushscheduler_unlearned);
+    RUN_TEST(test_pushscheduler_learn);
+    RUN_TEST(test_pushscheduler_missed);
+    RUN_TEST(test_pushscheduler_not_periodic);
+    RUN_TEST(test_autodetect_reject_settings);
+    RUN_TEST(test_autodetect_fingerprint);
+    RUN_TEST(test_autodetect_profile);
+    RUN_TEST(test_autodetect_unknown_push);
+    RUN_TEST(test_pushextractor_e450);
+    RUN_TEST(test_pushextractor_channel_offset);
+    RUN_TEST(test_pushextractor_scaled);
+    RUN_TEST(test_pushextractor_sink_full);
+    RUN_TEST(test_aggregator_statistics);
+    RUN_TEST(test_aggregator_exponent);
+    RUN_TEST(test_aggregator_register_changed);
+    RUN_TEST(test_aggregator_e450);
+    RUN_TEST(test_eventrules_first_push);
+    RUN_TEST(test_eventrules_power_threshold);
+    RUN_TEST(test_eventrules_energy_delta);
+    RUN_TEST(test_eventrules_status_change);
+    RUN_TEST(test_eventrules_heartbeat);
+    RUN_TEST(test_eventrules_e450);
+    RUN_TEST(test_derived_first_push);
+    RUN_TEST(test_derived_interval);
+    RUN_TEST(test_derived_counter_backwards);
+    RUN_TEST(test_derived_no_time_advance);
+    RUN_TEST(test_derived_uplink_failed);
+    RUN_TEST(test_deltacodec_varint);
+    RUN_TEST(test_deltacodec_e450_keyframe);
+    RUN_TEST(test_deltacodec_delta_frame);
+    RUN_TEST(test_deltacodec_unacknowledged);
+    RUN_TEST(test_deltacodec_keyframe_interval);
+    RUN_TEST(test_deltacodec_invalid_frame);
+    RUN_TEST(test_dictionary_e450_roundtrip);
+    RUN_TEST(test_dictionary_session);
+    RUN_TEST(test_dictionary_hash_changed);
+    RUN_TEST(test_dictionary_unknown_hash);
+    RUN_TEST(test_dictionary_invalid);
+    RUN_TEST(test_dictionary_parse_obis);
+    RUN_TEST(test_fixedlayout_offsets);
+    RUN_TEST(test_fixedlayout_bits);
+    RUN_TEST(test_fixedlayout_e450_roundtrip);
+    RUN_TEST(test_fixedlayout_missing_and_overflow);
+    RUN_TEST(test_fixedlayout_invalid);
+    RUN_TEST(test_fixedlayout_profile_registers);
+    RUN_TEST(test_frameplan_single_frame);
+    RUN_TEST(test_frameplan_record_boundaries);
+    RUN_TEST(test_frameplan_split_record);
+    RUN_TEST(test_frameplan_data_rates);
+    RUN_TEST(test_frameplan_invalid);
+    RUN_TEST(test_fragment_single_frame);
+    RUN_TEST(test_fragment_e450_reorder);
+    RUN_TEST(test_fragment_duplicates);
+    RUN_TEST(test_fragment_loss);
+    RUN_TEST(test_fragment_id_reuse);
+    RUN_TEST(test_fragment_invalid);
+    RUN_TEST(test_gbtcompression_e450_roundtrip);
+    RUN_TEST(test_gbtcompression_long_match);
+    RUN_TEST(test_gbtcompression_incompressible);
+    RUN_TEST(test_gbtcompression_invalid);
+    RUN_TEST(test_priorityplan_e450_order);
+    RUN_TEST(test_priorityplan_rotation);
+    RUN_TEST(test_priorityplan_smaller_record);
+    RUN_TEST(test_priorityplan_layout_change);
+    RUN_TEST(test_registerfilter_compile);
+    RUN_TEST(test_registerfilter_extract);
+    RUN_TEST(test_registerfilter_layout_change);
+    RUN_TEST(test_registerfilter_skip_parse);
+    RUN_TEST(test_registerfilter_obis_format);
+    RUN_TEST(test_txqueue_drain_in_order);
+    RUN_TEST(test_txqueue_busy);
+    RUN_TEST(test_txqueue_error_drop);
+    RUN_TEST(test_txqueue_nak);
+    RUN_TEST(test_txqueue_txfin_timeout);
+    RUN_TEST(test_txqueue_late_ack);
+    RUN_TEST(test_txqueue_full);
+    RUN_TEST(test_txqueue_fragments);
+    RUN_TEST(test_txqueue_supersede);
+    RUN_TEST(test_txqueue_oversized);
+    RUN_TEST(test_txqueue_abort);
   }
 
   // RUN_TEST(test_memory_leaks);
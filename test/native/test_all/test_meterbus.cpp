@@ -0,0 +1,177 @@
+#include "unity.h"
+
+#include <string.h>
+
+#include "test_meterbus.h"
+#include "test_fixtures.h"
+
+#include "hdlcheader.h"
+#include "smmeterbus.h"
+
+#define METERBUS_BLOCK_SIZE 120
+#define METERBUS_BLOCK_COUNT 4
+
+static uint32_t const METER_A = 0x01;                                   // source address 0x03 (as sent by the E450)
+static uint32_t const METER_B = 0x02;                                   // source address 0x05
+static uint32_t const METER_UNKNOWN = 0x03;                             // source address 0x07
+
+static void meterbus_gbt_frame_handler(uint8_t const* data, size_t const size);
+
+static SmMeterBus meterBus(meterbus_gbt_frame_handler);
+
+static void meterbus_gbt_frame_handler(uint8_t const* data, size_t const size)
+{
+    meterBus.gbtFrameReceived(data, size);
+}
+
+// builds the content of an hdlc frame (as passed to the frame handler) with one GBT block of the E450 push
+static size_t buildFrame(uint8_t* frame, uint32_t const source, uint8_t const block)
+{
+    size_t offset = (block - 1) * METERBUS_BLOCK_SIZE;
+    size_t length = E450_GBTPDU_SIZE - offset < METERBUS_BLOCK_SIZE ? E450_GBTPDU_SIZE - offset : METERBUS_BLOCK_SIZE;
+    bool last = offset + length == E450_GBTPDU_SIZE;
+
+    uint8_t const header[] = {
+        0xa0, 0x00, 0xce, 0xff, (uint8_t) ((source << 1) | 0x01), 0x13, 0x00, 0x00,
+        0xe0, (uint8_t) (last ? 0xc0 : 0x40), 0x00, block, 0x00, 0x00, (uint8_t) length
+    };
+
+    memcpy(frame, header, sizeof(header));
+    memcpy(frame + sizeof(header), e450GbtPdu + offset, length);
+
+    return sizeof(header) + length;
+}
+
+static bool sendBlock(uint32_t const source, uint8_t const block, bool const valid)
+{
+    uint8_t frame[160];
+
+    size_t size = buildFrame(frame, source, block);
+
+    return meterBus.hdlcFrameReceived(frame, size, valid);
+}
+
+static void configureBus(uint8_t const meterCount, uint32_t const addressA, uint32_t const addressB)
+{
+    TEST_ASSERT_TRUE(meterBus.setMeterCount(meterCount));
+    TEST_ASSERT_TRUE(meterBus.configure(0, addressA, 1000));
+    TEST_ASSERT_TRUE(meterBus.configure(1, addressB, 1000));
+
+    meterBus.reset();
+}
+
+void test_meterbus_hdlc_header(void)
+{
+    HdlcHeader header;
+
+    // header of the first E450 frame, 2 byte destination, 1 byte source address
+    uint8_t const e450[] = { 0xa0, 0x84, 0xce, 0xff, 0x03, 0x13, 0x12, 0x8b, 0xe6, 0xe7, 0x00 };
+
+    TEST_ASSERT_TRUE(header.parse(e450, sizeof(e450)));
+    TEST_ASSERT_EQUAL_HEX32(0x33ff, header.getDestination());
+    TEST_ASSERT_EQUAL_HEX32(METER_A, header.getSource());
+    TEST_ASSERT_EQUAL_HEX8(0x13, header.getControl());
+    TEST_ASSERT_EQUAL_UINT32(8, header.getSize());
+
+    // 4 byte destination, 1 byte source address
+    uint8_t const longAddress[] = { 0xa0, 0x0a, 0x00, 0x02, 0x00, 0x21, 0x03, 0x13, 0x00, 0x00 };
+
+    TEST_ASSERT_TRUE(header.parse(longAddress, sizeof(longAddress)));
+    TEST_ASSERT_EQUAL_HEX32(0x4010, header.getDestination());
+    TEST_ASSERT_EQUAL_HEX32(0x01, header.getSource());
+    TEST_ASSERT_EQUAL_UINT32(10, header.getSize());
+
+    // truncated header and address without end bit
+    TEST_ASSERT_FALSE(header.parse(e450, 7));
+    TEST_ASSERT_EQUAL_UINT32(0, header.getSize());
+
+    uint8_t const noEnd[] = { 0xa0, 0x0a, 0x00, 0x02, 0x04, 0x06, 0x08, 0x13, 0x00, 0x00 };
+
+    TEST_ASSERT_FALSE(header.parse(noEnd, sizeof(noEnd)));
+}
+
+void test_meterbus_demux(void)
+{
+    configureBus(2, METER_A, METER_B);
+
+    // the pushes of both meters interleaved, with a frame of a meter which is not configured
+    for(uint8_t block = 1; block <= METERBUS_BLOCK_COUNT; block++)
+    {
+        TEST_ASSERT_TRUE(sendBlock(METER_A, block, true));
+        TEST_ASSERT_FALSE(sendBlock(METER_UNKNOWN, block, true));
+        TEST_ASSERT_TRUE(sendBlock(METER_B, block, true));
+    }
+
+    TEST_ASSERT_TRUE(meterBus.isCycleComplete(0));
+
+    for(uint8_t i = 0; i < meterBus.getMeterCount(); i++)
+    {
+        SmMeterSlot const& slot = meterBus.getSlot(i);
+
+        TEST_ASSERT_TRUE(slot.isFrameReceived());
+        TEST_ASSERT_EQUAL_UINT32(E450_GBTPDU_SIZE, slot.getFrameSize());
+        TEST_ASSERT_EQUAL_INT8_ARRAY(e450GbtPdu, slot.getFrame(), E450_GBTPDU_SIZE);
+    }
+
+    // a joined frame outside of an hdlc frame has no meter
+    TEST_ASSERT_FALSE(meterBus.gbtFrameReceived(e450GbtPdu, E450_GBTPDU_SIZE));
+
+    // a new read cycle drops the frames
+    meterBus.reset();
+
+    TEST_ASSERT_FALSE(meterBus.getSlot(0).isFrameReceived());
+    TEST_ASSERT_FALSE(meterBus.getSlot(1).isFrameReceived());
+}
+
+void test_meterbus_timeout(void)
+{
+    configureBus(2, METER_A, METER_B);
+
+    for(uint8_t block = 1; block <= METERBUS_BLOCK_COUNT; block++)
+    {
+        TEST_ASSERT_TRUE(sendBlock(METER_A, block, true));
+    }
+
+    // meter B has not pushed, the cycle waits for it till its timeout
+    TEST_ASSERT_TRUE(meterBus.getSlot(0).isFrameReceived());
+    TEST_ASSERT_FALSE(meterBus.getSlot(1).isFrameReceived());
+    TEST_ASSERT_FALSE(meterBus.isCycleComplete(500));
+    TEST_ASSERT_TRUE(meterBus.isCycleComplete(1001));
+
+    // a single meter accepts any source address, the second slot is not in use
+    configureBus(1, SmMeterSlot::ADDRESS_ANY, METER_B);
+
+    TEST_ASSERT_FALSE(meterBus.isCycleComplete(500));
+
+    for(uint8_t block = 1; block <= METERBUS_BLOCK_COUNT; block++)
+    {
+        TEST_ASSERT_TRUE(sendBlock(METER_UNKNOWN, block, true));
+    }
+
+    TEST_ASSERT_TRUE(meterBus.isCycleComplete(0));
+
+    TEST_ASSERT_FALSE(meterBus.setMeterCount(0));
+    TEST_ASSERT_FALSE(meterBus.setMeterCount(SmMeterBus::MAX_METERS + 1));
+    TEST_ASSERT_EQUAL_UINT8(1, meterBus.getMeterCount());
+}
+
+void test_meterbus_invalid_frame(void)
+{
+    configureBus(2, METER_A, METER_B);
+
+    TEST_ASSERT_TRUE(sendBlock(METER_A, 1, true));
+    TEST_ASSERT_TRUE(sendBlock(METER_B, 1, true));
+
+    // the invalid frame only drops the blocks of meter A
+    TEST_ASSERT_FALSE(sendBlock(METER_A, 2, false));
+
+    for(uint8_t block = 2; block <= METERBUS_BLOCK_COUNT; block++)
+    {
+        sendBlock(METER_A, block, true);
+        TEST_ASSERT_TRUE(sendBlock(METER_B, block, true));
+    }
+
+    TEST_ASSERT_FALSE(meterBus.getSlot(0).isFrameReceived());
+    TEST_ASSERT_TRUE(meterBus.getSlot(1).isFrameReceived());
+    TEST_ASSERT_EQUAL_INT8_ARRAY(e450GbtPdu, meterBus.getSlot(1).getFrame(), E450_GBTPDU_SIZE);
+}
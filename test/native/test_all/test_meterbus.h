@@ -0,0 +1,4 @@
+void test_meterbus_hdlc_header(void);
+void test_meterbus_demux(void);
+void test_meterbus_timeout(void);
+void test_meterbus_invalid_frame(void);
@@ -0,0 +1,217 @@
+#include "unity.h"
+
+#include <string.h>
+
+#include "test_priorityplan.h"
+#include "test_fixtures.h"
+
+#include "gbtdata.h"
+#include "smpriorityplan.h"
+#include "smprofile.h"
+#include "smpushlayout.h"
+
+static ParsedPush pushPriority;
+
+// the records of a push are the values with a register, in the order of the push
+static uint8_t const PRIORITY_RECORD_SIZE = 8;
+
+static uint8_t recordValues[SmPushLayout::MAX_PUSHVALUES];
+static uint16_t recordSizes[SmPushLayout::MAX_PUSHVALUES];
+
+// parses the push and takes the values with a register as records of the same size
+static uint8_t preparePriorityRecords(uint8_t const* pdu, size_t const size)
+{
+    pushPriority.parse(pdu, size);
+
+    uint8_t recordCount = 0;
+
+    for(uint8_t i = 0; i < pushPriority.layout.getValueCount(); i++)
+    {
+        if(pushPriority.layout.getRegister(i) != nullptr)
+        {
+            recordValues[recordCount] = i;
+            recordSizes[recordCount] = PRIORITY_RECORD_SIZE;
+            recordCount++;
+        }
+    }
+
+    return recordCount;
+}
+
+// priority of the register of a record
+static uint8_t recordPriority(uint8_t const record)
+{
+    return pushPriority.layout.getRegister(recordValues[record])->priority;
+}
+
+void test_priorityplan_e450_order(void)
+{
+    SmPriorityPlan plan;
+
+    uint8_t recordCount = preparePriorityRecords(e450GbtPdu, E450_GBTPDU_SIZE);
+
+    TEST_ASSERT_TRUE(recordCount > 6);
+
+    // all records fit, nothing is deferred
+    uint32_t kept = plan.plan(pushPriority.layout, recordValues, recordSizes, recordCount, recordCount * PRIORITY_RECORD_SIZE);
+
+    TEST_ASSERT_EQUAL_HEX32((1UL << recordCount) - 1, kept);
+    TEST_ASSERT_EQUAL_HEX32(0, plan.getDeferred());
+
+    // two records fit, the energy counters (priority 0) are kept
+    kept = plan.plan(pushPriority.layout, recordValues, recordSizes, recordCount, 2 * PRIORITY_RECORD_SIZE + PRIORITY_RECORD_SIZE - 1);
+
+    uint8_t keptCount = 0;
+
+    for(uint8_t i = 0; i < recordCount; i++)
+    {
+        if(kept & (1UL << i))
+        {
+            TEST_ASSERT_EQUAL_UINT8(0, recordPriority(i));
+            TEST_ASSERT_EQUAL_UINT8(0, plan.getDeferredCount(recordValues[i]));
+
+            keptCount++;
+        }
+        else
+        {
+            TEST_ASSERT_TRUE(plan.getDeferred() & (1UL << recordValues[i]));
+            TEST_ASSERT_EQUAL_UINT8(1, plan.getDeferredCount(recordValues[i]));
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(2, keptCount);
+
+    // no budget, all records are deferred
+    kept = plan.plan(pushPriority.layout, recordValues, recordSizes, recordCount, 0);
+
+    TEST_ASSERT_EQUAL_HEX32(0, kept);
+}
+
+void test_priorityplan_rotation(void)
+{
+    SmPriorityPlan plan;
+
+    uint8_t recordCount = preparePriorityRecords(e450GbtPdu, E450_GBTPDU_SIZE);
+
+    uint8_t lastSent[SmPushLayout::MAX_PUSHVALUES];
+
+    memset(lastSent, 0, sizeof(lastSent));
+
+    // three records per uplink, every register gets through and none waits longer than the lowest priority allows
+    uint8_t const uplinks = 24;
+
+    for(uint8_t uplink = 1; uplink <= uplinks; uplink++)
+    {
+        uint32_t kept = plan.plan(pushPriority.layout, recordValues, recordSizes, recordCount, 3 * PRIORITY_RECORD_SIZE);
+
+        uint8_t keptCount = 0;
+
+        for(uint8_t i = 0; i < recordCount; i++)
+        {
+            if(kept & (1UL << i))
+            {
+                lastSent[i] = uplink;
+                keptCount++;
+            }
+        }
+
+        TEST_ASSERT_EQUAL_UINT8(3, keptCount);
+
+        // the energy counters are sent with the first uplink
+        if(uplink == 1)
+        {
+            for(uint8_t i = 0; i < recordCount; i++)
+            {
+                TEST_ASSERT_TRUE(recordPriority(i) != 0 || lastSent[i] == 1);
+            }
+        }
+    }
+
+    for(uint8_t i = 0; i < recordCount; i++)
+    {
+        TEST_ASSERT_TRUE_MESSAGE(uplinks - lastSent[i] < recordCount, "register starves");
+        TEST_ASSERT_TRUE(plan.getDeferredCount(recordValues[i]) < recordCount);
+    }
+}
+
+void test_priorityplan_smaller_record(void)
+{
+    SmPriorityPlan plan;
+
+    uint8_t recordCount = preparePriorityRecords(e450GbtPdu, E450_GBTPDU_SIZE);
+
+    // the energy counters do not fit, a smaller record of a lower priority still does
+    for(uint8_t i = 0; i < recordCount; i++)
+    {
+        recordSizes[i] = recordPriority(i) == 0 ? 2 * PRIORITY_RECORD_SIZE : PRIORITY_RECORD_SIZE;
+    }
+
+    uint32_t kept = plan.plan(pushPriority.layout, recordValues, recordSizes, recordCount, 2 * PRIORITY_RECORD_SIZE + PRIORITY_RECORD_SIZE);
+
+    uint8_t keptCount = 0;
+    uint8_t keptEnergy = 0;
+
+    for(uint8_t i = 0; i < recordCount; i++)
+    {
+        if(kept & (1UL << i))
+        {
+            keptCount++;
+            keptEnergy += recordPriority(i) == 0 ? 1 : 0;
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(2, keptCount);
+    TEST_ASSERT_EQUAL_UINT8(1, keptEnergy);
+}
+
+void test_priorityplan_layout_change(void)
+{
+    SmPriorityPlan plan;
+
+    uint8_t recordCount = preparePriorityRecords(e450GbtPdu, E450_GBTPDU_SIZE);
+
+    plan.plan(pushPriority.layout, recordValues, recordSizes, recordCount, 0);
+
+    TEST_ASSERT_EQUAL_UINT8(1, plan.getDeferredCount(recordValues[0]));
+
+    // another register in the push (reactive energy QIV becomes QIII of another tariff) changes the layout
+    uint8_t pdu[E450_GBTPDU_SIZE];
+    uint8_t const obis[] = { 0x01, 0x01, 0x08, 0x08, 0x00, 0xff };
+
+    memcpy(pdu, e450GbtPdu, E450_GBTPDU_SIZE);
+
+    uint8_t* descriptor = nullptr;
+
+    for(size_t i = 0; i + sizeof(obis) <= E450_GBTPDU_SIZE && descriptor == nullptr; i++)
+    {
+        if(memcmp(pdu + i, obis, sizeof(obis)) == 0)
+        {
+            descriptor = pdu + i;
+        }
+    }
+
+    TEST_ASSERT_NOT_NULL(descriptor);
+
+    descriptor[4] = 0x02;
+
+    uint32_t hash = pushPriority.layout.getHash();
+
+    recordCount = preparePriorityRecords(pdu, E450_GBTPDU_SIZE);
+
+    TEST_ASSERT_TRUE(hash != pushPriority.layout.getHash());
+
+    // the deferrals of the previous layout are forgotten
+    plan.plan(pushPriority.layout, recordValues, recordSizes, recordCount, 0);
+
+    TEST_ASSERT_EQUAL_UINT8(1, plan.getDeferredCount(recordValues[0]));
+
+    // the same layout again keeps the deferrals
+    plan.plan(pushPriority.layout, recordValues, recordSizes, recordCount, 0);
+
+    TEST_ASSERT_EQUAL_UINT8(2, plan.getDeferredCount(recordValues[0]));
+
+    plan.reset();
+
+    TEST_ASSERT_EQUAL_UINT8(0, plan.getDeferredCount(recordValues[0]));
+    TEST_ASSERT_EQUAL_HEX32(0, plan.getDeferred());
+}
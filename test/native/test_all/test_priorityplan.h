@@ -0,0 +1,4 @@
+void test_priorityplan_e450_order(void);
+void test_priorityplan_rotation(void);
+void test_priorityplan_smaller_record(void);
+void test_priorityplan_layout_change(void);
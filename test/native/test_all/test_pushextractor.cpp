@@ -0,0 +1,148 @@
+#include "unity.h"
+
+#include "test_pushextractor.h"
+#include "test_fixtures.h"
+
+#include "gbtdata.h"
+#include "smprofile.h"
+#include "smpushextractor.h"
+
+#define PUSHEXTRACTOR_MAX_RECORDS 40
+
+// collects the records of the extraction
+class CollectingSink : public SmRecordSink
+{
+    public:
+        uint8_t capacity = PUSHEXTRACTOR_MAX_RECORDS;
+        uint8_t calls = 0;
+        uint32_t unixTime = 0;
+        uint8_t timeChannel = 0;
+        uint8_t valueCount = 0;
+        uint8_t scaledCount = 0;
+        uint8_t channels[PUSHEXTRACTOR_MAX_RECORDS];
+        SmScaledValue scaled[PUSHEXTRACTOR_MAX_RECORDS];
+
+        bool addRecordTime(uint8_t const channel, uint32_t const time) override
+        {
+            calls++;
+            timeChannel = channel;
+            unixTime = time;
+
+            return true;
+        }
+
+        bool addRecordValue(uint8_t const channel, GbtValueBase const* gbtValue) override
+        {
+            return add(channel);
+        }
+
+        bool addRecordScaled(uint8_t const channel, SmScaledValue const& scaledValue) override
+        {
+            scaled[scaledCount++] = scaledValue;
+
+            return add(channel);
+        }
+
+    private:
+        bool add(uint8_t const channel)
+        {
+            calls++;
+
+            if(valueCount >= capacity)
+            {
+                return false;
+            }
+
+            channels[valueCount++] = channel;
+
+            return true;
+        }
+};
+
+static GbtData gbtDataExtractor;
+
+void test_pushextractor_e450(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, gbtDataExtractor.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+
+    SmProfile const& e450 = SmProfiles::getDefault();
+    SmPushExtractor extractor;
+    CollectingSink sink;
+
+    TEST_ASSERT_TRUE(extractor.extract(gbtDataExtractor, e450, e450.channel, false, sink));
+
+    // time stamp first, then each register of the push once (the device name is sent as well)
+    TEST_ASSERT_EQUAL_UINT32(gbtDataExtractor.getDateTime().asUnixTimeStamp(), sink.unixTime);
+    TEST_ASSERT_EQUAL_UINT8(10, sink.timeChannel);
+    TEST_ASSERT_EQUAL_UINT8(14, extractor.getRecordCount());
+    TEST_ASSERT_EQUAL_UINT8(14, sink.valueCount);
+    TEST_ASSERT_EQUAL_UINT8(15, sink.calls);
+    TEST_ASSERT_EQUAL_STRING("60222999", extractor.getDeviceName());
+
+    for(uint8_t i = 0; i < sink.valueCount; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(10, sink.channels[i]);
+    }
+
+    // the cached layout gives the same records
+    CollectingSink again;
+
+    TEST_ASSERT_TRUE(extractor.extract(gbtDataExtractor, e450, e450.channel, false, again));
+    TEST_ASSERT_EQUAL_UINT8(15, again.calls);
+
+    extractor.reset();
+
+    TEST_ASSERT_EQUAL_STRING("", extractor.getDeviceName());
+}
+
+void test_pushextractor_channel_offset(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, gbtDataExtractor.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+
+    SmPushExtractor extractor;
+    CollectingSink sink;
+
+    // a second meter on channel 20, the registers move by the same offset
+    TEST_ASSERT_TRUE(extractor.extract(gbtDataExtractor, SmProfiles::getDefault(), 20, false, sink));
+
+    TEST_ASSERT_EQUAL_UINT8(20, sink.timeChannel);
+
+    for(uint8_t i = 0; i < sink.valueCount; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(20, sink.channels[i]);
+    }
+}
+
+void test_pushextractor_scaled(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, gbtDataExtractor.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+
+    SmPushExtractor extractor;
+    CollectingSink sink;
+
+    TEST_ASSERT_TRUE(extractor.extract(gbtDataExtractor, SmProfiles::getDefault(), 10, true, sink));
+
+    // the octet strings (push setup and device name) stay raw
+    TEST_ASSERT_EQUAL_UINT8(14, sink.valueCount);
+    TEST_ASSERT_EQUAL_UINT8(12, sink.scaledCount);
+
+    // current L3 is the last register, 0.01 A
+    TEST_ASSERT_EQUAL_INT8(-2, sink.scaled[11].exponent);
+    TEST_ASSERT_TRUE(sink.scaled[11].unit == SmUnit::SMUNIT_AMPERE);
+}
+
+void test_pushextractor_sink_full(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, gbtDataExtractor.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+
+    SmPushExtractor extractor;
+    CollectingSink sink;
+
+    sink.capacity = 4;
+
+    // a failed record fails the extraction, the pass still visits each value once
+    TEST_ASSERT_FALSE(extractor.extract(gbtDataExtractor, SmProfiles::getDefault(), 10, false, sink));
+    TEST_ASSERT_EQUAL_UINT8(15, sink.calls);
+    TEST_ASSERT_EQUAL_UINT8(4, sink.valueCount);
+    TEST_ASSERT_EQUAL_STRING("60222999", extractor.getDeviceName());
+}
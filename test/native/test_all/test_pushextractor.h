@@ -0,0 +1,4 @@
+void test_pushextractor_e450(void);
+void test_pushextractor_channel_offset(void);
+void test_pushextractor_scaled(void);
+void test_pushextractor_sink_full(void);
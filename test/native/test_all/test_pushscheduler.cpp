@@ -0,0 +1,166 @@
+#include "unity.h"
+
+#include "test_pushscheduler.h"
+
+#include "smpushscheduler.h"
+
+#define PUSHSCHEDULER_INTERVAL 60000
+#define PUSHSCHEDULER_WINDOW 90000
+#define PUSHSCHEDULER_LEAD 1000
+#define PUSHSCHEDULER_PERIOD 10                                         // push period of the simulated meter in s
+#define PUSHSCHEDULER_PHASE 3700                                        // local time of the first push in ms
+#define PUSHSCHEDULER_METERTIME 1700000000                              // meter time of the first push in s
+
+static SmPushScheduler scheduler;
+
+// local time of the next read cycle
+static uint32_t wakeUp;
+
+// local arrival of push n, with a small jitter of the transmission
+static uint32_t pushArrival(uint32_t const n)
+{
+    int32_t jitter = (int32_t) ((n * 7919) % 400) - 200;
+
+    return PUSHSCHEDULER_PHASE + n * PUSHSCHEDULER_PERIOD * 1000 + jitter;
+}
+
+static void setUpScheduler(void)
+{
+    scheduler.configure(PUSHSCHEDULER_INTERVAL, PUSHSCHEDULER_WINDOW, PUSHSCHEDULER_LEAD);
+    scheduler.reset();
+
+    wakeUp = 0;
+}
+
+// runs one read cycle of the adapter against the simulated meter, returns true if the push was received
+static bool runCycle(bool const meterPushes)
+{
+    scheduler.cycleStarted(wakeUp);
+
+    uint32_t windowStart = wakeUp + PUSHSCHEDULER_LEAD;
+    uint32_t windowEnd = windowStart + scheduler.getReceiveWindow();
+
+    // first push completed within the receive window
+    uint32_t n = 0;
+
+    while(pushArrival(n) < windowStart)
+    {
+        n++;
+    }
+
+    bool received = meterPushes && pushArrival(n) <= windowEnd;
+
+    uint32_t cycleEnd = windowEnd;
+
+    if(received)
+    {
+        cycleEnd = pushArrival(n);
+
+        scheduler.pushReceived(cycleEnd, PUSHSCHEDULER_METERTIME + n * PUSHSCHEDULER_PERIOD);
+    }
+    else
+    {
+        scheduler.pushMissed();
+    }
+
+    cycleEnd += 500;
+
+    scheduler.cycleEnded(cycleEnd);
+
+    wakeUp = cycleEnd + scheduler.scheduleNextWake(cycleEnd);
+
+    return received;
+}
+
+void test_pushscheduler_unlearned(void)
+{
+    setUpScheduler();
+
+    TEST_ASSERT_FALSE(scheduler.isLearned());
+    TEST_ASSERT_EQUAL_UINT32(PUSHSCHEDULER_WINDOW, scheduler.getReceiveWindow());
+    TEST_ASSERT_EQUAL_UINT32(PUSHSCHEDULER_INTERVAL, scheduler.scheduleNextWake(0));
+
+    // one push is no period
+    TEST_ASSERT_TRUE(runCycle(true));
+    TEST_ASSERT_FALSE(scheduler.isLearned());
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getSavedOnTime());
+}
+
+void test_pushscheduler_learn(void)
+{
+    setUpScheduler();
+
+    for(uint8_t i = 0; i < 12; i++)
+    {
+        TEST_ASSERT_TRUE(runCycle(true));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(PUSHSCHEDULER_PERIOD, scheduler.getPeriod());
+    TEST_ASSERT_EQUAL_UINT8(SmPushScheduler::MAX_CONFIDENCE, scheduler.getConfidence());
+
+    // the window shrinks to the minimum and the error of the prediction
+    TEST_ASSERT_TRUE(scheduler.getReceiveWindow() < 2 * SmPushScheduler::MIN_WINDOW);
+    TEST_ASSERT_TRUE(scheduler.getLastError() < 500 && scheduler.getLastError() > -500);
+    TEST_ASSERT_TRUE(scheduler.getMeanError() < 500);
+
+    // the push arrives in the middle of the window instead of after half a period
+    TEST_ASSERT_TRUE(scheduler.getExpectedOnTime() < PUSHSCHEDULER_LEAD + SmPushScheduler::MIN_WINDOW);
+    TEST_ASSERT_TRUE(scheduler.getLastOnTime() < PUSHSCHEDULER_LEAD + SmPushScheduler::MIN_WINDOW);
+
+    // the cycles stay close to the measure interval
+    uint32_t lastWakeUp = wakeUp;
+
+    TEST_ASSERT_TRUE(runCycle(true));
+    TEST_ASSERT_UINT32_WITHIN(PUSHSCHEDULER_PERIOD * 1000, PUSHSCHEDULER_INTERVAL, wakeUp - lastWakeUp);
+}
+
+void test_pushscheduler_missed(void)
+{
+    setUpScheduler();
+
+    for(uint8_t i = 0; i < 12; i++)
+    {
+        runCycle(true);
+    }
+
+    uint32_t savedOnTime = scheduler.getSavedOnTime();
+
+    TEST_ASSERT_TRUE(savedOnTime > 0);
+
+    // a missed push opens the full window, the period is kept
+    TEST_ASSERT_FALSE(runCycle(false));
+    TEST_ASSERT_EQUAL_UINT8(0, scheduler.getConfidence());
+    TEST_ASSERT_EQUAL_UINT32(PUSHSCHEDULER_WINDOW, scheduler.getReceiveWindow());
+    TEST_ASSERT_EQUAL_UINT32(PUSHSCHEDULER_PERIOD, scheduler.getPeriod());
+
+    // the next pushes are received again and the window shrinks
+    for(uint8_t i = 0; i < 8; i++)
+    {
+        TEST_ASSERT_TRUE(runCycle(true));
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(SmPushScheduler::MAX_CONFIDENCE, scheduler.getConfidence());
+    TEST_ASSERT_TRUE(scheduler.getSavedOnTime() > savedOnTime);
+}
+
+void test_pushscheduler_not_periodic(void)
+{
+    setUpScheduler();
+
+    scheduler.pushReceived(1000, PUSHSCHEDULER_METERTIME);
+    scheduler.pushReceived(61000, PUSHSCHEDULER_METERTIME + 60);
+
+    TEST_ASSERT_EQUAL_UINT32(60, scheduler.getPeriod());
+
+    scheduler.pushReceived(122000, PUSHSCHEDULER_METERTIME + 121);
+
+    // a divisor of 1 s is jitter, the learning starts over
+    TEST_ASSERT_EQUAL_UINT32(61, scheduler.getPeriod());
+    TEST_ASSERT_EQUAL_UINT8(0, scheduler.getConfidence());
+
+    // a push without time stamp keeps the period
+    scheduler.pushReceived(183000, 0);
+    scheduler.pushReceived(244000, PUSHSCHEDULER_METERTIME + 243);
+
+    TEST_ASSERT_EQUAL_UINT32(61, scheduler.getPeriod());
+}
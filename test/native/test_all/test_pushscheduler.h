@@ -0,0 +1,4 @@
+void test_pushscheduler_unlearned(void);
+void test_pushscheduler_learn(void);
+void test_pushscheduler_missed(void);
+void test_pushscheduler_not_periodic(void);
@@ -0,0 +1,256 @@
+#include "unity.h"
+
+#include <string.h>
+
+#include "test_registerfilter.h"
+#include "test_fixtures.h"
+
+#include "gbtdata.h"
+#include "smprofile.h"
+#include "smpushextractor.h"
+#include "smpushlayout.h"
+#include "smregisterfilter.h"
+
+// active energy +A and -A and active power +P of the E450 profile, and a code the E450 does not push
+static uint8_t const FILTER_CODES[4][SmRegisterFilter::OBIS_SIZE] = {
+    { 0x01, 0x01, 0x01, 0x08, 0x00, 0xff }, { 0x01, 0x01, 0x02, 0x08, 0x00, 0xff }, { 0x01, 0x00, 0x01, 0x07, 0x00, 0xff },
+    { 0x01, 0x00, 0x20, 0x07, 0x00, 0xff }
+};
+
+static ParsedPush pushFilter;
+
+// number of set bits of a bitmap
+static uint8_t countBits(uint32_t bitmap)
+{
+    uint8_t count = 0;
+
+    for(; bitmap != 0; bitmap &= bitmap - 1)
+    {
+        count++;
+    }
+
+    return count;
+}
+
+// checks that the allowed values are the registers of the filter codes
+static void assertAllowedCodes(SmPushLayout const& layout, uint32_t const allowed, uint8_t const codeCount)
+{
+    for(uint8_t i = 0; i < layout.getValueCount(); i++)
+    {
+        SmRegister const* smRegister = layout.getRegister(i);
+
+        bool listed = false;
+        uint8_t obis[SmRegisterFilter::OBIS_SIZE];
+
+        if(smRegister != nullptr && SmProfiles::parseObis(smRegister->obis, obis))
+        {
+            for(uint8_t j = 0; j < codeCount; j++)
+            {
+                listed |= memcmp(obis, FILTER_CODES[j], SmRegisterFilter::OBIS_SIZE) == 0;
+            }
+        }
+
+        TEST_ASSERT_EQUAL(listed, (allowed & (1UL << i)) != 0);
+    }
+}
+
+void test_registerfilter_compile(void)
+{
+    pushFilter.parse(e450GbtPdu, E450_GBTPDU_SIZE);
+
+    SmRegisterFilter filter;
+
+    // an empty filter allows all values
+    TEST_ASSERT_FALSE(filter.isActive());
+    TEST_ASSERT_EQUAL_HEX32(UINT32_MAX, filter.getAllowed(pushFilter.layout));
+
+    // three of the codes are pushed, the fourth is not
+    TEST_ASSERT_TRUE(filter.select(FILTER_CODES, 4));
+    TEST_ASSERT_TRUE(filter.isActive());
+    TEST_ASSERT_EQUAL_UINT8(4, filter.getCount());
+
+    uint32_t allowed = filter.getAllowed(pushFilter.layout);
+
+    TEST_ASSERT_EQUAL_UINT8(3, countBits(allowed));
+    assertAllowedCodes(pushFilter.layout, allowed, 4);
+
+    // the compiled bitmap is kept for the same layout
+    TEST_ASSERT_EQUAL_HEX32(allowed, filter.getAllowed(pushFilter.layout));
+
+    // a filter longer than MAX_CODES is rejected, all values are allowed
+    uint8_t codes[SmRegisterFilter::MAX_CODES + 1][SmRegisterFilter::OBIS_SIZE];
+
+    memset(codes, 0, sizeof(codes));
+
+    TEST_ASSERT_FALSE(filter.select(codes, SmRegisterFilter::MAX_CODES + 1));
+    TEST_ASSERT_FALSE(filter.isActive());
+    TEST_ASSERT_EQUAL_HEX32(UINT32_MAX, filter.getAllowed(pushFilter.layout));
+
+    TEST_ASSERT_TRUE(filter.select(nullptr, 0));
+    TEST_ASSERT_FALSE(filter.isActive());
+}
+
+void test_registerfilter_extract(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, pushFilter.gbtData.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+
+    SmProfile const& e450 = SmProfiles::getDefault();
+    SmPushExtractor extractor;
+    CountingSink sink;
+
+    TEST_ASSERT_TRUE(extractor.selectFilter(FILTER_CODES, 2));
+    TEST_ASSERT_TRUE(extractor.extract(pushFilter.gbtData, e450, e450.channel, true, sink));
+
+    // only the energy counters are sent, the device name is still taken from the push
+    TEST_ASSERT_EQUAL_UINT8(2, sink.valueCount);
+    TEST_ASSERT_EQUAL_UINT8(2, extractor.getRecordCount());
+    TEST_ASSERT_EQUAL_STRING("60222999", extractor.getDeviceName());
+
+    for(uint8_t i = 0; i < extractor.getRecordCount(); i++)
+    {
+        SmRegister const* smRegister = extractor.getLayout().getRegister(extractor.getRecordValues()[i]);
+
+        uint8_t obis[SmRegisterFilter::OBIS_SIZE];
+
+        TEST_ASSERT_NOT_NULL(smRegister);
+        TEST_ASSERT_TRUE(SmProfiles::parseObis(smRegister->obis, obis));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(FILTER_CODES[i], obis, SmRegisterFilter::OBIS_SIZE);
+    }
+
+    // without filter all registers are sent again
+    CountingSink allSink;
+
+    TEST_ASSERT_TRUE(extractor.selectFilter(nullptr, 0));
+    TEST_ASSERT_TRUE(extractor.extract(pushFilter.gbtData, e450, e450.channel, true, allSink));
+    TEST_ASSERT_EQUAL_UINT8(14, allSink.valueCount);
+}
+
+void test_registerfilter_layout_change(void)
+{
+    pushFilter.parse(e450GbtPdu, E450_GBTPDU_SIZE);
+
+    SmRegisterFilter filter;
+
+    TEST_ASSERT_TRUE(filter.select(FILTER_CODES, 3));
+    TEST_ASSERT_EQUAL_UINT8(3, countBits(filter.getAllowed(pushFilter.layout)));
+
+    // the push no longer has the active energy +A (1.1.1.8.0.255 becomes 1.1.1.8.1.255)
+    uint8_t pdu[E450_GBTPDU_SIZE];
+
+    memcpy(pdu, e450GbtPdu, E450_GBTPDU_SIZE);
+
+    uint8_t* descriptor = nullptr;
+
+    for(size_t i = 0; i + SmRegisterFilter::OBIS_SIZE <= E450_GBTPDU_SIZE && descriptor == nullptr; i++)
+    {
+        if(memcmp(pdu + i, FILTER_CODES[0], SmRegisterFilter::OBIS_SIZE) == 0)
+        {
+            descriptor = pdu + i;
+        }
+    }
+
+    TEST_ASSERT_NOT_NULL(descriptor);
+
+    descriptor[4] = 0x01;
+
+    pushFilter.parse(pdu, E450_GBTPDU_SIZE);
+
+    // the bitmap is compiled again for the new layout
+    uint32_t allowed = filter.getAllowed(pushFilter.layout);
+
+    TEST_ASSERT_EQUAL_UINT8(2, countBits(allowed));
+    assertAllowedCodes(pushFilter.layout, allowed, 3);
+}
+
+void test_registerfilter_skip_parse(void)
+{
+    SmProfile const& e450 = SmProfiles::getDefault();
+    SmPushExtractor extractor;
+    CountingSink sink;
+
+    TEST_ASSERT_TRUE(extractor.selectFilter(FILTER_CODES, 2));
+
+    // without cached layout the push is parsed completely
+    TEST_ASSERT_EQUAL_INT(0, extractor.parse(pushFilter.gbtData, e450GbtPdu, E450_GBTPDU_SIZE, e450));
+
+    for(uint8_t i = 0; i < pushFilter.gbtData.getValueCount(); i++)
+    {
+        TEST_ASSERT_NOT_NULL(pushFilter.gbtData.getValue(i));
+    }
+
+    TEST_ASSERT_TRUE(extractor.extract(pushFilter.gbtData, e450, e450.channel, true, sink));
+
+    // the next push skips the values which are not sent, their indexes and the device name are kept
+    CountingSink filteredSink;
+    SmPushLayout const& layout = extractor.getLayout();
+
+    TEST_ASSERT_EQUAL_INT(0, extractor.parse(pushFilter.gbtData, e450GbtPdu, E450_GBTPDU_SIZE, e450));
+    TEST_ASSERT_EQUAL_UINT8(74, pushFilter.gbtData.getValueCount());
+
+    uint8_t skipped = 0;
+
+    for(uint8_t i = 0; i < layout.getValueCount(); i++)
+    {
+        if(pushFilter.gbtData.getValue(layout.getValueIndex(i)) == nullptr)
+        {
+            skipped++;
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(layout.getValueCount() - 3, skipped);
+    TEST_ASSERT_NOT_NULL(pushFilter.gbtData.getValue(layout.getValueIndex(layout.getDeviceNameIndex())));
+
+    TEST_ASSERT_TRUE(extractor.extract(pushFilter.gbtData, e450, e450.channel, true, filteredSink));
+    TEST_ASSERT_EQUAL_UINT8(2, filteredSink.valueCount);
+    TEST_ASSERT_EQUAL_STRING("60222999", extractor.getDeviceName());
+
+    // a push with other descriptors does not match the skipped values, it is parsed completely again
+    uint8_t pdu[E450_GBTPDU_SIZE];
+
+    memcpy(pdu, e450GbtPdu, E450_GBTPDU_SIZE);
+
+    for(size_t i = 0; i + SmRegisterFilter::OBIS_SIZE <= E450_GBTPDU_SIZE; i++)
+    {
+        if(memcmp(pdu + i, FILTER_CODES[0], SmRegisterFilter::OBIS_SIZE) == 0)
+        {
+            pdu[i + 4] = 0x01;
+
+            break;
+        }
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, extractor.parse(pushFilter.gbtData, pdu, E450_GBTPDU_SIZE, e450));
+
+    for(uint8_t i = 0; i < pushFilter.gbtData.getValueCount(); i++)
+    {
+        TEST_ASSERT_NOT_NULL(pushFilter.gbtData.getValue(i));
+    }
+
+    // without filter nothing is skipped
+    TEST_ASSERT_TRUE(extractor.selectFilter(nullptr, 0));
+    TEST_ASSERT_EQUAL_INT(0, extractor.parse(pushFilter.gbtData, e450GbtPdu, E450_GBTPDU_SIZE, e450));
+
+    for(uint8_t i = 0; i < pushFilter.gbtData.getValueCount(); i++)
+    {
+        TEST_ASSERT_NOT_NULL(pushFilter.gbtData.getValue(i));
+    }
+}
+
+void test_registerfilter_obis_format(void)
+{
+    char obis[SmProfiles::OBIS_STRING_SIZE];
+    uint8_t fields[SmRegisterFilter::OBIS_SIZE];
+    uint8_t const largest[SmRegisterFilter::OBIS_SIZE] = { 255, 255, 255, 255, 255, 255 };
+
+    TEST_ASSERT_EQUAL_size_t(13, SmProfiles::formatObis(FILTER_CODES[0], obis, sizeof(obis)));
+    TEST_ASSERT_EQUAL_STRING("1.1.1.8.0.255", obis);
+    TEST_ASSERT_TRUE(SmProfiles::parseObis(obis, fields));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(FILTER_CODES[0], fields, SmRegisterFilter::OBIS_SIZE);
+
+    // the largest code fits into OBIS_STRING_SIZE
+    TEST_ASSERT_EQUAL_size_t(23, SmProfiles::formatObis(largest, obis, sizeof(obis)));
+
+    // a code which does not fit is not truncated
+    TEST_ASSERT_EQUAL_size_t(0, SmProfiles::formatObis(FILTER_CODES[0], obis, 13));
+    TEST_ASSERT_EQUAL_STRING("", obis);
+}
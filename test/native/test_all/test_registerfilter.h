@@ -0,0 +1,5 @@
+void test_registerfilter_compile(void);
+void test_registerfilter_extract(void);
+void test_registerfilter_layout_change(void);
+void test_registerfilter_skip_parse(void);
+void test_registerfilter_obis_format(void);
@@ -0,0 +1,204 @@
+#include "unity.h"
+
+#include <string.h>
+
+#include "test_smprofile.h"
+#include "test_fixtures.h"
+
+#include "gbtdata.h"
+#include "gbtoctetstring.h"
+#include "gbtuint16.h"
+#include "smprofile.h"
+#include "smpushlayout.h"
+
+static GbtData gbtDataProfile;
+
+// a meter which only sends the energy registers, added as a table in the same way as in smprofile.cpp
+static constexpr SmRegister TEST_REGISTERS_ENERGY[] = {
+    { "1.1.1.8.0.255", 20, 0, 0, SmUnit::SMUNIT_WATTHOUR, SmRegisterRole::SMREGISTER_VALUE },
+    { "1.1.2.8.0.255", 21, 0, 0, SmUnit::SMUNIT_WATTHOUR, SmRegisterRole::SMREGISTER_VALUE }
+};
+
+static constexpr SmProfile TEST_PROFILE_ENERGY = {
+    200, "Energy only", 9600, SmSerialFormat::SMSERIAL_8N1, SmApduForm::SMAPDU_GBT_PUSH, 20, TEST_REGISTERS_ENERGY, 2, { false, 0 }
+};
+
+// offset of a descriptor in the recorded E450 push
+static size_t findPattern(uint8_t const* pattern, size_t const length)
+{
+    size_t offset = 0;
+
+    while(offset + length <= E450_GBTPDU_SIZE && memcmp(e450GbtPdu + offset, pattern, length) != 0)
+    {
+        offset++;
+    }
+
+    TEST_ASSERT_TRUE(offset + length <= E450_GBTPDU_SIZE);
+
+    return offset;
+}
+
+void test_smprofile_lookup(void)
+{
+    TEST_ASSERT_GREATER_OR_EQUAL(1, SmProfiles::getCount());
+    TEST_ASSERT_NULL(SmProfiles::find(0));
+    TEST_ASSERT_NULL(SmProfiles::find(0xff));
+
+    SmProfile const* e450 = SmProfiles::find(SmProfiles::SMPROFILE_LG_E450);
+
+    TEST_ASSERT_NOT_NULL(e450);
+    TEST_ASSERT_TRUE(e450 == &SmProfiles::getDefault());
+    TEST_ASSERT_EQUAL_UINT32(2400, e450->baudRate);
+    TEST_ASSERT_TRUE(e450->serialFormat == SmSerialFormat::SMSERIAL_8E1);
+    TEST_ASSERT_EQUAL_UINT8(10, e450->channel);
+    TEST_ASSERT_EQUAL_UINT8(14, e450->registerCount);
+
+    // all identifiers are unique
+    for(uint8_t i = 0; i < SmProfiles::getCount(); i++)
+    {
+        TEST_ASSERT_TRUE(SmProfiles::find(SmProfiles::getAt(i).id) == &SmProfiles::getAt(i));
+    }
+
+    TEST_ASSERT_NOT_NULL(e450->findRegister("1.0.31.7.0.255"));
+    TEST_ASSERT_EQUAL_INT8(-2, e450->findRegister("1.0.31.7.0.255")->scaler);
+    TEST_ASSERT_NULL(e450->findRegister("1.0.32.7.0.255"));
+}
+
+void test_smprofile_e450_layout(void)
+{
+    SmPushLayout layout;
+
+    TEST_ASSERT_EQUAL_INT(0, gbtDataProfile.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+
+    SmProfile const& e450 = *SmProfiles::find(SmProfiles::SMPROFILE_LG_E450);
+
+    TEST_ASSERT_TRUE(layout.update(gbtDataProfile, e450));
+
+    // 15 descriptors, the first one is the push object list itself
+    TEST_ASSERT_EQUAL_UINT8(60, layout.getFirstValueIndex());
+    TEST_ASSERT_EQUAL_UINT8(14, layout.getValueCount());
+    TEST_ASSERT_NULL(layout.getRegister(14));
+
+    uint8_t deviceNameCount = 0;
+
+    for(uint8_t i = 0; i < layout.getValueCount(); i++)
+    {
+        SmRegister const* smRegister = layout.getRegister(i);
+
+        TEST_ASSERT_NOT_NULL(smRegister);
+        TEST_ASSERT_EQUAL_UINT8(10, smRegister->channel);
+
+        if(smRegister->role == SmRegisterRole::SMREGISTER_DEVICENAME)
+        {
+            deviceNameCount++;
+
+            auto const* deviceName = static_cast<GbtOctetString const*>(gbtDataProfile.getValue(layout.getValueIndex(i)));
+
+            TEST_ASSERT_EQUAL_UINT8(1, i);
+            TEST_ASSERT_EQUAL_STRING("60222999", deviceName->getStringValue());
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(1, deviceNameCount);
+    TEST_ASSERT_EQUAL_UINT8(1, layout.getDeviceNameIndex());
+
+    // the currents are the last three values
+    TEST_ASSERT_EQUAL_STRING("1.0.31.7.0.255", layout.getRegister(11)->obis);
+    TEST_ASSERT_EQUAL_UINT16(11, static_cast<GbtUint16 const*>(gbtDataProfile.getValue(60 + 11))->getValue());
+}
+
+void test_smprofile_layout_cache(void)
+{
+    SmPushLayout layout;
+
+    TEST_ASSERT_EQUAL_INT(0, gbtDataProfile.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+
+    SmProfile const& e450 = *SmProfiles::find(SmProfiles::SMPROFILE_LG_E450);
+
+    TEST_ASSERT_TRUE(layout.update(gbtDataProfile, e450));
+
+    uint32_t hash = layout.getHash();
+    SmRegister const* deviceName = layout.getRegister(1);
+
+    // same push again, the layout stays the same
+    TEST_ASSERT_EQUAL_INT(0, gbtDataProfile.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+    TEST_ASSERT_TRUE(layout.update(gbtDataProfile, e450));
+    TEST_ASSERT_EQUAL_UINT32(hash, layout.getHash());
+    TEST_ASSERT_TRUE(deviceName == layout.getRegister(1));
+
+    // another profile resolves the same push again, values without register are skipped
+    TEST_ASSERT_TRUE(layout.update(gbtDataProfile, TEST_PROFILE_ENERGY));
+    TEST_ASSERT_EQUAL_UINT32(hash, layout.getHash());
+    TEST_ASSERT_EQUAL_UINT8(14, layout.getValueCount());
+
+    uint8_t sentCount = 0;
+
+    for(uint8_t i = 0; i < layout.getValueCount(); i++)
+    {
+        if(layout.getRegister(i) != nullptr)
+        {
+            sentCount++;
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(2, sentCount);
+    TEST_ASSERT_EQUAL_UINT8(20, layout.getRegister(4)->channel);
+    TEST_ASSERT_EQUAL_UINT8(21, layout.getRegister(5)->channel);
+
+    // a changed class id or attribute resolves the layout again, the OBIS codes are the same
+    uint8_t const activePower[] = { 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x00, 0x01, 0x07, 0x00, 0xff, 0x0f, 0x02 };
+    uint8_t const serialNumber[] = { 0x12, 0x00, 0x01, 0x09, 0x06, 0x00, 0x00, 0x60, 0x01, 0x00, 0xff, 0x0f, 0x02 };
+    uint8_t changedPdu[E450_GBTPDU_SIZE];
+
+    memcpy(changedPdu, e450GbtPdu, E450_GBTPDU_SIZE);
+    changedPdu[findPattern(activePower, sizeof(activePower)) + 2] = 0x04;                           // extended register
+
+    TEST_ASSERT_EQUAL_INT(0, gbtDataProfile.parse(changedPdu, E450_GBTPDU_SIZE));
+    TEST_ASSERT_TRUE(layout.update(gbtDataProfile, e450));
+    TEST_ASSERT_TRUE(hash != layout.getHash());
+    TEST_ASSERT_EQUAL_UINT8(14, layout.getValueCount());
+
+    memcpy(changedPdu, e450GbtPdu, E450_GBTPDU_SIZE);
+    changedPdu[findPattern(serialNumber, sizeof(serialNumber)) + 12] = 0x03;                        // attribute 3
+
+    TEST_ASSERT_EQUAL_INT(0, gbtDataProfile.parse(changedPdu, E450_GBTPDU_SIZE));
+    TEST_ASSERT_TRUE(layout.update(gbtDataProfile, e450));
+    TEST_ASSERT_TRUE(hash != layout.getHash());
+    TEST_ASSERT_EQUAL_UINT8(14, layout.getValueCount());
+
+    TEST_ASSERT_EQUAL_INT(0, gbtDataProfile.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+    TEST_ASSERT_TRUE(layout.update(gbtDataProfile, e450));
+    TEST_ASSERT_EQUAL_UINT32(hash, layout.getHash());
+
+    // the next push in the same buffer: a new invoke id, time and values keep the raw descriptors of the cache
+    memcpy(changedPdu, e450GbtPdu, E450_GBTPDU_SIZE);
+    changedPdu[4] ^= 0x01;                                                                          // long invoke id
+    changedPdu[13] ^= 0x01;                                                                         // minute
+    changedPdu[E450_GBTPDU_SIZE - 1] ^= 0x01;                                                       // last current
+
+    TEST_ASSERT_EQUAL_INT(0, gbtDataProfile.parse(changedPdu, E450_GBTPDU_SIZE));
+    TEST_ASSERT_TRUE(layout.matches(gbtDataProfile, e450));
+    TEST_ASSERT_TRUE(layout.update(gbtDataProfile, e450));
+    TEST_ASSERT_EQUAL_UINT32(hash, layout.getHash());
+
+    // a changed descriptor in the reused buffer does not match the kept octets, the layout is resolved again
+    changedPdu[findPattern(activePower, sizeof(activePower)) + 2] = 0x04;
+
+    TEST_ASSERT_EQUAL_INT(0, gbtDataProfile.parse(changedPdu, E450_GBTPDU_SIZE));
+    TEST_ASSERT_FALSE(layout.matches(gbtDataProfile, e450));
+    TEST_ASSERT_TRUE(layout.update(gbtDataProfile, e450));
+    TEST_ASSERT_TRUE(hash != layout.getHash());
+
+    TEST_ASSERT_EQUAL_INT(0, gbtDataProfile.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+    TEST_ASSERT_FALSE(layout.matches(gbtDataProfile, e450));
+    TEST_ASSERT_TRUE(layout.update(gbtDataProfile, e450));
+    TEST_ASSERT_EQUAL_UINT32(hash, layout.getHash());
+
+    // a push without descriptors has no layout
+    GbtDataStore<10, 2> gbtDataEmpty;
+
+    TEST_ASSERT_FALSE(layout.update(gbtDataEmpty, e450));
+    TEST_ASSERT_EQUAL_UINT8(0, layout.getValueCount());
+    TEST_ASSERT_NULL(layout.getRegister(0));
+    TEST_ASSERT_EQUAL_UINT8(SmPushLayout::MAX_PUSHVALUES, layout.getDeviceNameIndex());
+}
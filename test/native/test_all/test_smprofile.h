@@ -0,0 +1,3 @@
+void test_smprofile_lookup(void);
+void test_smprofile_e450_layout(void);
+void test_smprofile_layout_cache(void);
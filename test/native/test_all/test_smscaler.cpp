@@ -0,0 +1,133 @@
+#include "unity.h"
+
+#include <stdint.h>
+
+#include "test_smscaler.h"
+#include "test_fixtures.h"
+
+#include "gbtdata.h"
+#include "smprofile.h"
+#include "smpushlayout.h"
+#include "smscaler.h"
+
+static GbtData gbtDataScaler;
+
+// push with current L1 (register, attribute 2), its scaler_unit (attribute 3, 10^-3 A) and the active energy +A
+static uint8_t const SCALERUNIT_PUSH[] = {
+    0x0f, 0x00, 0x00, 0x00, 0x01,
+    0x0c, 0x07, 0xe6, 0x0c, 0x1a, 0x01, 0x01, 0x1e, 0x23, 0xff, 0x80, 0x00, 0x00,
+    0x02, 0x04,
+    0x01, 0x04,
+    0x02, 0x04, 0x12, 0x00, 0x28, 0x09, 0x06, 0x00, 0x08, 0x19, 0x09, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00,
+    0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x00, 0x1f, 0x07, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00,
+    0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x00, 0x1f, 0x07, 0x00, 0xff, 0x0f, 0x03, 0x12, 0x00, 0x00,
+    0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06, 0x01, 0x01, 0x01, 0x08, 0x00, 0xff, 0x0f, 0x02, 0x12, 0x00, 0x00,
+    0x12, 0x04, 0xd2,
+    0x02, 0x02, 0x0f, 0xfd, 0x16, 0x21,
+    0x06, 0x00, 0x00, 0x00, 0x95
+};
+
+void test_smscaler_fixed_point(void)
+{
+    // 12.34 A (scaler -2) in mA
+    TEST_ASSERT_EQUAL_INT64(12340, SmScaler::toFixedPoint(1234, -2, 3));
+
+    // 149 Wh with 3 decimals
+    TEST_ASSERT_EQUAL_INT64(149000, SmScaler::toFixedPoint(149, 0, 3));
+
+    // scaler 10^2, e.g. 5 hWh in Wh
+    TEST_ASSERT_EQUAL_INT64(500, SmScaler::toFixedPoint(5, 2, 0));
+
+    // less decimals than the scaler, rounded half away from zero
+    TEST_ASSERT_EQUAL_INT64(12, SmScaler::toFixedPoint(1234, -2, 0));
+    TEST_ASSERT_EQUAL_INT64(13, SmScaler::toFixedPoint(1250, -2, 0));
+    TEST_ASSERT_EQUAL_INT64(-13, SmScaler::toFixedPoint(-1250, -2, 0));
+
+    // largest raw value
+    TEST_ASSERT_EQUAL_INT64(4294967295000LL, SmScaler::toFixedPoint(UINT32_MAX, 0, 3));
+}
+
+void test_smscaler_scale(void)
+{
+    SmScaledValue value = SmScaler::scale(1234, -2, SmUnit::SMUNIT_AMPERE);
+
+    TEST_ASSERT_EQUAL_INT32(1234, value.mantissa);
+    TEST_ASSERT_EQUAL_INT8(-2, value.exponent);
+    TEST_ASSERT_EQUAL_UINT8(33, (uint8_t) value.unit);
+
+    // positive scalers are multiplied out
+    value = SmScaler::scale(5, 2, SmUnit::SMUNIT_WATTHOUR);
+
+    TEST_ASSERT_EQUAL_INT32(500, value.mantissa);
+    TEST_ASSERT_EQUAL_INT8(0, value.exponent);
+
+    // as long as the mantissa fits
+    value = SmScaler::scale(300000000, 2, SmUnit::SMUNIT_WATTHOUR);
+
+    TEST_ASSERT_EQUAL_INT32(300000000, value.mantissa);
+    TEST_ASSERT_EQUAL_INT8(2, value.exponent);
+
+    // uint32 values beyond int32 lose the last digit
+    value = SmScaler::scale(UINT32_MAX, 0, SmUnit::SMUNIT_WATTHOUR);
+
+    TEST_ASSERT_EQUAL_INT32(429496730, value.mantissa);
+    TEST_ASSERT_EQUAL_INT8(1, value.exponent);
+}
+
+void test_smscaler_profile_units(void)
+{
+    SmPushLayout layout;
+
+    TEST_ASSERT_EQUAL_INT(0, gbtDataScaler.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+    TEST_ASSERT_TRUE(layout.update(gbtDataScaler, SmProfiles::getDefault()));
+
+    // active power, active energy and current L1 of the E450 push
+    TEST_ASSERT_EQUAL_INT8(0, layout.getScaler(2));
+    TEST_ASSERT_TRUE(layout.getUnit(2) == SmUnit::SMUNIT_WATT);
+    TEST_ASSERT_TRUE(layout.getUnit(4) == SmUnit::SMUNIT_WATTHOUR);
+    TEST_ASSERT_EQUAL_INT8(-2, layout.getScaler(11));
+    TEST_ASSERT_TRUE(layout.getUnit(11) == SmUnit::SMUNIT_AMPERE);
+
+    int64_t raw;
+
+    TEST_ASSERT_TRUE(SmScaler::getRawValue(gbtDataScaler.getValue(layout.getValueIndex(11)), raw));
+
+    SmScaledValue current = SmScaler::scale(raw, layout.getScaler(11), layout.getUnit(11));
+
+    TEST_ASSERT_EQUAL_INT32(11, current.mantissa);
+    TEST_ASSERT_EQUAL_INT8(-2, current.exponent);
+
+    // the device name is not numeric
+    TEST_ASSERT_FALSE(SmScaler::getRawValue(gbtDataScaler.getValue(layout.getValueIndex(1)), raw));
+}
+
+void test_smscaler_pushed_scaler_unit(void)
+{
+    SmPushLayout layout;
+
+    TEST_ASSERT_EQUAL_INT(0, gbtDataScaler.parse(SCALERUNIT_PUSH, sizeof(SCALERUNIT_PUSH)));
+    TEST_ASSERT_TRUE(layout.update(gbtDataScaler, SmProfiles::getDefault()));
+
+    // the scaler_unit is not a value of its own, it takes two values of the GbtData
+    TEST_ASSERT_EQUAL_UINT8(2, layout.getValueCount());
+    TEST_ASSERT_EQUAL_UINT8(16, layout.getValueIndex(0));
+    TEST_ASSERT_EQUAL_UINT8(19, layout.getValueIndex(1));
+
+    // pushed scaler overrides the profile (10^-2)
+    TEST_ASSERT_EQUAL_STRING("1.0.31.7.0.255", layout.getRegister(0)->obis);
+    TEST_ASSERT_EQUAL_INT8(-3, layout.getScaler(0));
+    TEST_ASSERT_TRUE(layout.getUnit(0) == SmUnit::SMUNIT_AMPERE);
+
+    // no scaler_unit pushed, profile scaler and unit
+    TEST_ASSERT_EQUAL_STRING("1.1.1.8.0.255", layout.getRegister(1)->obis);
+    TEST_ASSERT_EQUAL_INT8(0, layout.getScaler(1));
+    TEST_ASSERT_TRUE(layout.getUnit(1) == SmUnit::SMUNIT_WATTHOUR);
+
+    int64_t raw;
+
+    TEST_ASSERT_TRUE(SmScaler::getRawValue(gbtDataScaler.getValue(layout.getValueIndex(0)), raw));
+    TEST_ASSERT_EQUAL_INT64(1234, SmScaler::toFixedPoint(raw, layout.getScaler(0), 3));
+
+    TEST_ASSERT_TRUE(SmScaler::getRawValue(gbtDataScaler.getValue(layout.getValueIndex(1)), raw));
+    TEST_ASSERT_EQUAL_INT64(149, raw);
+}
@@ -0,0 +1,4 @@
+void test_smscaler_fixed_point(void);
+void test_smscaler_scale(void);
+void test_smscaler_profile_units(void);
+void test_smscaler_pushed_scaler_unit(void);
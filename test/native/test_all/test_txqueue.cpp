@@ -0,0 +1,639 @@
+#include "unity.h"
+
+#include <string.h>
+
+#include "test_txqueue.h"
+
+#include "smtxqueue.h"
+#include "smtxradio.h"
+
+#define TXQUEUE_MAX_SENT 64
+
+// radio which answers with injected results and keeps the packets handed to it
+class FakeRadio : public SmTxRadio
+{
+    public:
+        SmTxResult results[TXQUEUE_MAX_SENT];                                                       // result of each call, SMTX_SUCCESS after the injected ones
+        uint8_t resultCount = 0;
+        uint8_t calls = 0;
+        uint8_t sentCount = 0;
+        uint8_t sentFirstByte[TXQUEUE_MAX_SENT];
+        size_t sentSize[TXQUEUE_MAX_SENT];
+        uint8_t sentPort[TXQUEUE_MAX_SENT];
+        size_t maxPayloadSize = SmTxQueue::MAX_PACKET_SIZE;                                         // payload of the current data rate
+
+        void inject(SmTxResult const result, uint8_t const count)
+        {
+            for(uint8_t i = 0; i < count && resultCount < TXQUEUE_MAX_SENT; i++)
+            {
+                results[resultCount++] = result;
+            }
+        }
+
+        SmTxResult send(uint8_t const* data, size_t const size, uint8_t const fport) override
+        {
+            SmTxResult result = calls < resultCount ? results[calls] : SmTxResult::SMTX_SUCCESS;
+
+            calls++;
+
+            if(result == SmTxResult::SMTX_SUCCESS && sentCount < TXQUEUE_MAX_SENT)
+            {
+                sentFirstByte[sentCount] = data[0];
+                sentSize[sentCount] = size;
+                sentPort[sentCount] = fport;
+                sentCount++;
+            }
+
+            return result;
+        }
+
+        size_t getMaxPayloadSize() override
+        {
+            return maxPayloadSize;
+        }
+};
+
+// queues a packet filled with its number
+static bool queuePacket(SmTxQueue& queue, uint8_t const number, size_t const size, uint32_t const now)
+{
+    uint8_t* buffer = queue.reserve();
+
+    if(buffer == nullptr)
+    {
+        return false;
+    }
+
+    memset(buffer, number, size);
+
+    return queue.commit(size, number, now);
+}
+
+void test_txqueue_drain_in_order(void)
+{
+    FakeRadio radio;
+    SmTxQueue queue(radio);
+
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_IDLE, queue.getState());
+    TEST_ASSERT_EQUAL_UINT32(SmTxQueue::NO_TIMER, queue.getTimerDelay(0));
+
+    // the first packet is sent at once, the others wait for the end of its TX cycle
+    TEST_ASSERT_TRUE(queuePacket(queue, 1, 51, 0));
+    TEST_ASSERT_TRUE(queuePacket(queue, 2, 20, 0));
+    TEST_ASSERT_TRUE(queuePacket(queue, 3, 222, 0));
+
+    TEST_ASSERT_EQUAL_UINT8(1, radio.sentCount);
+    TEST_ASSERT_EQUAL_UINT8(3, queue.getCount());
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_SENDING, queue.getState());
+    TEST_ASSERT_EQUAL_UINT32(SmTxQueue::TXFIN_TIMEOUT, queue.getTimerDelay(0));
+
+    for(uint32_t now = 1000; queue.getCount() > 0; now += 1000)
+    {
+        queue.txFinished(true, now);
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(3, radio.sentCount);
+    TEST_ASSERT_EQUAL_UINT8(3, radio.calls);
+
+    size_t const sizes[3] = { 51, 20, 222 };
+
+    for(uint8_t i = 0; i < 3; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(i + 1, radio.sentFirstByte[i]);
+        TEST_ASSERT_EQUAL_UINT8(i + 1, radio.sentPort[i]);
+        TEST_ASSERT_EQUAL(sizes[i], radio.sentSize[i]);
+    }
+
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_IDLE, queue.getState());
+    TEST_ASSERT_EQUAL_UINT32(3, queue.getDeliveredCount());
+    TEST_ASSERT_EQUAL_UINT32(0, queue.getRetryCount());
+    TEST_ASSERT_EQUAL_UINT32(SmTxQueue::NO_TIMER, queue.getTimerDelay(10000));
+
+    // an end of a TX cycle without sent packet (e.g. a MAC uplink) is ignored
+    queue.txFinished(true, 10000);
+
+    TEST_ASSERT_EQUAL_UINT32(3, queue.getDeliveredCount());
+}
+
+void test_txqueue_busy(void)
+{
+    FakeRadio radio;
+    SmTxQueue queue(radio);
+
+    radio.inject(SmTxResult::SMTX_BUSY, 2);
+
+    // the busy transceiver does not block, the packet waits for the short timer
+    TEST_ASSERT_TRUE(queuePacket(queue, 1, 10, 0));
+    TEST_ASSERT_TRUE(queuePacket(queue, 2, 10, 0));
+
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_WAITING, queue.getState());
+    TEST_ASSERT_EQUAL_UINT32(SmTxQueue::BUSY_RETRY_DELAY, queue.getTimerDelay(0));
+    TEST_ASSERT_EQUAL_UINT8(0, radio.sentCount);
+
+    // a timer armed for an earlier event does not send before the time
+    queue.timerExpired(SmTxQueue::BUSY_RETRY_DELAY - 1);
+
+    TEST_ASSERT_EQUAL_UINT8(1, radio.calls);
+    TEST_ASSERT_EQUAL_UINT32(1, queue.getTimerDelay(SmTxQueue::BUSY_RETRY_DELAY - 1));
+
+    // a busy transceiver is no failure, the delay does not back off
+    queue.timerExpired(SmTxQueue::BUSY_RETRY_DELAY);
+
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_WAITING, queue.getState());
+    TEST_ASSERT_EQUAL_UINT8(2, radio.calls);
+    TEST_ASSERT_EQUAL_UINT32(SmTxQueue::BUSY_RETRY_DELAY, queue.getTimerDelay(SmTxQueue::BUSY_RETRY_DELAY));
+
+    // the end of a TX cycle (e.g. of a MAC uplink) frees the transceiver, the packet is sent without the timer
+    queue.txFinished(true, SmTxQueue::BUSY_RETRY_DELAY + 100);
+
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_SENDING, queue.getState());
+    TEST_ASSERT_EQUAL_UINT8(1, radio.sentCount);
+    TEST_ASSERT_EQUAL_UINT8(1, radio.sentFirstByte[0]);
+    TEST_ASSERT_EQUAL_UINT32(2, queue.getRetryCount());
+    TEST_ASSERT_EQUAL_UINT32(0, queue.getDeliveredCount());
+
+    // the busy attempts did not add to the backoff of the first failure
+    queue.txFinished(false, 20000);
+
+    TEST_ASSERT_EQUAL_UINT32(SmTxQueue::RETRY_DELAY, queue.getTimerDelay(20000));
+
+    queue.timerExpired(20000 + SmTxQueue::RETRY_DELAY);
+    queue.txFinished(true, 30000);
+    queue.txFinished(true, 31000);
+
+    TEST_ASSERT_EQUAL_UINT32(2, queue.getDeliveredCount());
+    TEST_ASSERT_EQUAL_UINT8(2, radio.sentFirstByte[2]);
+
+    // a transceiver busy for more than MAX_ATTEMPTS tries does not drop the packet
+    FakeRadio busyRadio;
+    SmTxQueue busyQueue(busyRadio);
+
+    busyRadio.inject(SmTxResult::SMTX_BUSY, SmTxQueue::MAX_ATTEMPTS + 2);
+
+    TEST_ASSERT_TRUE(queuePacket(busyQueue, 3, 10, 0));
+
+    uint32_t now = 0;
+
+    while(busyQueue.getState() == SmTxQueue::SmTxState::SMTXSTATE_WAITING)
+    {
+        TEST_ASSERT_EQUAL_UINT32(SmTxQueue::BUSY_RETRY_DELAY, busyQueue.getTimerDelay(now));
+
+        now += busyQueue.getTimerDelay(now);
+
+        busyQueue.timerExpired(now);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32((SmTxQueue::MAX_ATTEMPTS + 2) * SmTxQueue::BUSY_RETRY_DELAY, now);
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_SENDING, busyQueue.getState());
+    TEST_ASSERT_EQUAL_UINT32(0, busyQueue.getDroppedCount());
+    TEST_ASSERT_EQUAL_UINT8(1, busyRadio.sentCount);
+}
+
+void test_txqueue_error_drop(void)
+{
+    FakeRadio radio;
+    SmTxQueue queue(radio);
+
+    // the first packet is rejected on every attempt, it is dropped and the second one is sent
+    radio.inject(SmTxResult::SMTX_ERROR, SmTxQueue::MAX_ATTEMPTS);
+
+    TEST_ASSERT_TRUE(queuePacket(queue, 1, 10, 0));
+    TEST_ASSERT_TRUE(queuePacket(queue, 2, 10, 0));
+
+    uint32_t now = 0;
+
+    while(queue.getState() == SmTxQueue::SmTxState::SMTXSTATE_WAITING)
+    {
+        now += queue.getTimerDelay(now);
+
+        queue.timerExpired(now);
+    }
+
+    // the backoff doubles with each failure up to its limit, the next packet waits for it as well
+    uint32_t expected = 0;
+    uint32_t delay = SmTxQueue::RETRY_DELAY;
+
+    for(uint8_t i = 0; i < SmTxQueue::MAX_ATTEMPTS; i++)
+    {
+        expected += delay;
+        delay = delay * 2 < SmTxQueue::MAX_RETRY_DELAY ? delay * 2 : SmTxQueue::MAX_RETRY_DELAY;
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(expected, now);
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_SENDING, queue.getState());
+    TEST_ASSERT_EQUAL_UINT32(1, queue.getDroppedCount());
+    TEST_ASSERT_EQUAL_UINT32(SmTxQueue::MAX_ATTEMPTS - 1, queue.getRetryCount());
+    TEST_ASSERT_EQUAL_UINT8(1, queue.getCount());
+    TEST_ASSERT_EQUAL_UINT8(1, radio.sentCount);
+    TEST_ASSERT_EQUAL_UINT8(2, radio.sentFirstByte[0]);
+}
+
+void test_txqueue_nak(void)
+{
+    FakeRadio radio;
+    SmTxQueue queue(radio);
+
+    TEST_ASSERT_TRUE(queuePacket(queue, 1, 10, 0));
+    TEST_ASSERT_TRUE(queuePacket(queue, 2, 10, 0));
+
+    // a packet which is not acknowledged is sent again after the backoff, the next one waits
+    queue.txFinished(false, 1000);
+
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_WAITING, queue.getState());
+    TEST_ASSERT_EQUAL_UINT32(SmTxQueue::RETRY_DELAY, queue.getTimerDelay(1000));
+
+    queue.timerExpired(1000 + SmTxQueue::RETRY_DELAY);
+    queue.txFinished(false, 7000);
+
+    TEST_ASSERT_EQUAL_UINT32(2 * SmTxQueue::RETRY_DELAY, queue.getTimerDelay(7000));
+
+    queue.timerExpired(7000 + 2 * SmTxQueue::RETRY_DELAY);
+    queue.txFinished(true, 18000);
+
+    TEST_ASSERT_EQUAL_UINT8(4, radio.sentCount);
+
+    uint8_t const order[4] = { 1, 1, 1, 2 };
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(order, radio.sentFirstByte, 4);
+    TEST_ASSERT_EQUAL_UINT32(2, queue.getRetryCount());
+    TEST_ASSERT_EQUAL_UINT32(1, queue.getDeliveredCount());
+
+    // the acknowledgement resets the backoff, a packet which is never acknowledged is dropped after MAX_ATTEMPTS attempts
+    uint32_t now = 19000;
+
+    queue.txFinished(false, now);
+
+    TEST_ASSERT_EQUAL_UINT32(SmTxQueue::RETRY_DELAY, queue.getTimerDelay(now));
+
+    while(queue.getState() != SmTxQueue::SmTxState::SMTXSTATE_IDLE)
+    {
+        now += queue.getTimerDelay(now);
+
+        queue.timerExpired(now);
+        queue.txFinished(false, now);
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(4 + SmTxQueue::MAX_ATTEMPTS - 1, radio.sentCount);
+
+    TEST_ASSERT_EQUAL_UINT32(1, queue.getDroppedCount());
+    TEST_ASSERT_EQUAL_UINT8(0, queue.getCount());
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_IDLE, queue.getState());
+}
+
+void test_txqueue_txfin_timeout(void)
+{
+    FakeRadio radio;
+    SmTxQueue queue(radio);
+
+    TEST_ASSERT_TRUE(queuePacket(queue, 1, 10, 500));
+
+    // without end of the TX cycle the packet is sent again after the backoff
+    uint32_t timeout = 500 + SmTxQueue::TXFIN_TIMEOUT;
+
+    queue.timerExpired(timeout - 1);
+
+    TEST_ASSERT_EQUAL_UINT8(1, radio.sentCount);
+
+    queue.timerExpired(timeout);
+
+    TEST_ASSERT_EQUAL_UINT8(1, radio.sentCount);
+    TEST_ASSERT_EQUAL_UINT32(1, queue.getRetryCount());
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_WAITING, queue.getState());
+
+    queue.timerExpired(timeout + SmTxQueue::RETRY_DELAY);
+
+    TEST_ASSERT_EQUAL_UINT8(2, radio.sentCount);
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_SENDING, queue.getState());
+    TEST_ASSERT_EQUAL_UINT32(SmTxQueue::TXFIN_TIMEOUT, queue.getTimerDelay(timeout + SmTxQueue::RETRY_DELAY));
+}
+
+void test_txqueue_late_ack(void)
+{
+    FakeRadio radio;
+    SmTxQueue queue(radio);
+
+    TEST_ASSERT_TRUE(queuePacket(queue, 1, 10, 0));
+    TEST_ASSERT_TRUE(queuePacket(queue, 2, 10, 0));
+
+    // the end of the TX cycle comes after the timeout, the acknowledged packet is not sent twice
+    queue.timerExpired(SmTxQueue::TXFIN_TIMEOUT);
+
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_WAITING, queue.getState());
+
+    queue.txFinished(true, SmTxQueue::TXFIN_TIMEOUT + 1000);
+
+    uint8_t const order[2] = { 1, 2 };
+
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_SENDING, queue.getState());
+    TEST_ASSERT_EQUAL_UINT8(2, radio.sentCount);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(order, radio.sentFirstByte, 2);
+    TEST_ASSERT_EQUAL_UINT32(1, queue.getDeliveredCount());
+    TEST_ASSERT_EQUAL_UINT8(1, queue.getCount());
+
+    // a late end of the TX cycle without acknowledgement sends the packet again at once
+    uint32_t now = 2 * SmTxQueue::TXFIN_TIMEOUT + 1000;
+
+    queue.timerExpired(now);
+    queue.txFinished(false, now + 1000);
+
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_SENDING, queue.getState());
+    TEST_ASSERT_EQUAL_UINT8(3, radio.sentCount);
+    TEST_ASSERT_EQUAL_UINT8(2, radio.sentFirstByte[2]);
+    TEST_ASSERT_EQUAL_UINT32(1, queue.getDeliveredCount());
+
+    queue.txFinished(true, now + 2000);
+
+    TEST_ASSERT_EQUAL_UINT32(2, queue.getDeliveredCount());
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_IDLE, queue.getState());
+}
+
+void test_txqueue_full(void)
+{
+    FakeRadio radio;
+    SmTxQueue queue(radio);
+
+    // the pool holds four packets of the largest size, the fifth one has no room
+    uint8_t queued = 0;
+
+    while(queuePacket(queue, queued + 1, SmTxQueue::MAX_PACKET_SIZE, 0))
+    {
+        queued++;
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(SmTxQueue::POOL_SIZE / SmTxQueue::MAX_PACKET_SIZE, queued);
+    TEST_ASSERT_NULL(queue.reserve());
+    TEST_ASSERT_FALSE(queue.commit(10, 1, 0));
+
+    // a delivered packet makes room, the data of the others is kept
+    queue.txFinished(true, 1000);
+
+    TEST_ASSERT_TRUE(queuePacket(queue, 9, 10, 1000));
+
+    for(uint32_t now = 2000; queue.getCount() > 0; now += 1000)
+    {
+        queue.txFinished(true, now);
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(queued + 1, radio.sentCount);
+    TEST_ASSERT_EQUAL_UINT8(9, radio.sentFirstByte[queued]);
+
+    for(uint8_t i = 0; i < queued; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(i + 1, radio.sentFirstByte[i]);
+    }
+
+    // small packets are limited by the number of packets
+    FakeRadio busyRadio;
+    SmTxQueue busyQueue(busyRadio);
+
+    busyRadio.inject(SmTxResult::SMTX_BUSY, 1);
+
+    for(uint8_t i = 0; i < SmTxQueue::MAX_PACKETS; i++)
+    {
+        TEST_ASSERT_TRUE(queuePacket(busyQueue, i, 4, 0));
+    }
+
+    TEST_ASSERT_NULL(busyQueue.reserve());
+    TEST_ASSERT_EQUAL_UINT8(SmTxQueue::MAX_PACKETS, busyQueue.getCount());
+}
+
+void test_txqueue_fragments(void)
+{
+    FakeRadio radio;
+    SmTxQueue queue(radio);
+
+    // the fragments of a message are tracked one by one, only the one not acknowledged is sent again
+    uint32_t message = queue.openMessage(0);
+
+    TEST_ASSERT_TRUE(message != SmTxQueue::NO_MESSAGE);
+    TEST_ASSERT_TRUE(queuePacket(queue, 1, 10, 0));
+    TEST_ASSERT_TRUE(queuePacket(queue, 2, 10, 0));
+    TEST_ASSERT_TRUE(queuePacket(queue, 3, 10, 0));
+
+    queue.txFinished(true, 1000);
+    queue.txFinished(false, 2000);
+
+    TEST_ASSERT_FALSE(queue.isDelivered(0, message));
+
+    queue.timerExpired(2000 + SmTxQueue::RETRY_DELAY);
+    queue.txFinished(true, 8000);
+    queue.txFinished(true, 9000);
+
+    uint8_t const order[4] = { 1, 2, 2, 3 };
+
+    TEST_ASSERT_EQUAL_UINT8(4, radio.sentCount);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(order, radio.sentFirstByte, 4);
+    TEST_ASSERT_TRUE(queue.isDelivered(0, message));
+    TEST_ASSERT_FALSE(queue.isDelivered(1, message));
+
+    // a fragment which is dropped takes the rest of its message along, the next message is sent
+    uint32_t lost = queue.openMessage(0);
+
+    TEST_ASSERT_TRUE(lost != message);
+    TEST_ASSERT_TRUE(queuePacket(queue, 4, 10, 10000));
+    TEST_ASSERT_TRUE(queuePacket(queue, 5, 10, 10000));
+
+    queue.openMessage(1);
+
+    TEST_ASSERT_TRUE(queuePacket(queue, 6, 10, 10000));
+
+    uint32_t now = 10000;
+
+    while(queue.getDroppedCount() == 0)
+    {
+        queue.txFinished(false, now);
+
+        now += queue.getTimerDelay(now);
+
+        queue.timerExpired(now);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(2, queue.getDroppedCount());
+    TEST_ASSERT_EQUAL_UINT8(1, queue.getCount());
+    TEST_ASSERT_FALSE(queue.isDelivered(0, lost));
+    TEST_ASSERT_EQUAL_UINT8(6, radio.sentFirstByte[radio.sentCount - 1]);
+}
+
+void test_txqueue_supersede(void)
+{
+    FakeRadio radio;
+    SmTxQueue queue(radio);
+
+    radio.inject(SmTxResult::SMTX_SUCCESS, 1);
+    radio.inject(SmTxResult::SMTX_BUSY, 1);
+
+    // the first packet is on air, the others of the stream wait
+    uint32_t stale = queue.openMessage(0);
+
+    TEST_ASSERT_TRUE(queuePacket(queue, 1, 10, 0));
+    TEST_ASSERT_TRUE(queuePacket(queue, 2, 10, 0));
+
+    queue.openMessage(1);
+
+    TEST_ASSERT_TRUE(queuePacket(queue, 3, 10, 0));
+
+    // the newer message of the stream supersedes the waiting packet, the one on air and the other stream are kept
+    uint32_t newer = queue.openMessage(0);
+
+    TEST_ASSERT_TRUE(queuePacket(queue, 4, 20, 0));
+
+    TEST_ASSERT_EQUAL_UINT32(1, queue.getSupersededCount());
+    TEST_ASSERT_EQUAL_UINT8(3, queue.getCount());
+
+    // the acknowledged packet on air does not deliver the superseded message
+    queue.txFinished(true, 1000);
+
+    TEST_ASSERT_FALSE(queue.isDelivered(0, stale));
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_WAITING, queue.getState());
+
+    // a waiting head which is superseded makes way for the next packet at the time of the timer
+    queue.openMessage(1);
+
+    TEST_ASSERT_TRUE(queuePacket(queue, 5, 10, 1000));
+
+    TEST_ASSERT_EQUAL_UINT32(2, queue.getSupersededCount());
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_WAITING, queue.getState());
+
+    uint32_t now = 1000 + queue.getTimerDelay(1000);
+
+    queue.timerExpired(now);
+    queue.txFinished(true, now + 1000);
+    queue.txFinished(true, now + 2000);
+
+    uint8_t const order[3] = { 1, 4, 5 };
+
+    TEST_ASSERT_EQUAL_UINT8(3, radio.sentCount);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(order, radio.sentFirstByte, 3);
+    TEST_ASSERT_EQUAL(20, radio.sentSize[1]);
+    TEST_ASSERT_TRUE(queue.isDelivered(0, newer));
+    TEST_ASSERT_EQUAL_UINT32(3, queue.getDeliveredCount());
+
+    // all waiting packets of a stream may be superseded, the queue is idle then
+    FakeRadio busyRadio;
+    SmTxQueue busyQueue(busyRadio);
+
+    busyRadio.inject(SmTxResult::SMTX_BUSY, 1);
+
+    busyQueue.openMessage(2);
+
+    TEST_ASSERT_TRUE(queuePacket(busyQueue, 1, 10, 0));
+
+    busyQueue.openMessage(2);
+
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_IDLE, busyQueue.getState());
+    TEST_ASSERT_EQUAL_UINT8(0, busyQueue.getCount());
+    TEST_ASSERT_EQUAL(SmTxQueue::NO_MESSAGE, busyQueue.openMessage(SmTxQueue::MAX_STREAMS));
+}
+
+void test_txqueue_oversized(void)
+{
+    FakeRadio radio;
+    SmTxQueue queue(radio);
+
+    // two fragments of 51 bytes and an uplink of another stream, the first fragment is on air
+    uint32_t message = queue.openMessage(0);
+
+    TEST_ASSERT_TRUE(queuePacket(queue, 1, 51, 0));
+    TEST_ASSERT_TRUE(queuePacket(queue, 2, 51, 0));
+
+    uint32_t other = queue.openMessage(1);
+
+    TEST_ASSERT_TRUE(queuePacket(queue, 3, 11, 0));
+
+    uint8_t stream = 0;
+    uint32_t oversized = SmTxQueue::NO_MESSAGE;
+
+    TEST_ASSERT_FALSE(queue.takeOversized(stream, oversized));
+
+    // the data rate drops (ADR), the fragment left is dropped with its message without attempt, the next one is sent
+    radio.maxPayloadSize = 11;
+
+    queue.txFinished(true, 1000);
+
+    TEST_ASSERT_EQUAL_UINT8(2, radio.sentCount);
+    TEST_ASSERT_EQUAL_UINT8(3, radio.sentFirstByte[1]);
+    TEST_ASSERT_EQUAL_UINT32(1, queue.getOversizedCount());
+    TEST_ASSERT_EQUAL_UINT32(0, queue.getDroppedCount());
+    TEST_ASSERT_EQUAL_UINT32(0, queue.getRetryCount());
+    TEST_ASSERT_FALSE(queue.isDelivered(0, message));
+
+    // the message is reported once to be planned again
+    TEST_ASSERT_TRUE(queue.takeOversized(stream, oversized));
+    TEST_ASSERT_EQUAL_UINT8(0, stream);
+    TEST_ASSERT_EQUAL_UINT32(message, oversized);
+    TEST_ASSERT_FALSE(queue.takeOversized(stream, oversized));
+
+    queue.txFinished(true, 2000);
+
+    TEST_ASSERT_TRUE(queue.isDelivered(1, other));
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_IDLE, queue.getState());
+
+    // an unknown payload (pending MAC commands) does not drop the packet, the radio decides
+    radio.maxPayloadSize = 0;
+
+    queue.openMessage(0);
+
+    TEST_ASSERT_TRUE(queuePacket(queue, 4, 51, 3000));
+    TEST_ASSERT_EQUAL_UINT8(3, radio.sentCount);
+    TEST_ASSERT_FALSE(queue.takeOversized(stream, oversized));
+}
+
+void test_txqueue_abort(void)
+{
+    FakeRadio radio;
+    SmTxQueue queue(radio);
+
+    radio.inject(SmTxResult::SMTX_SUCCESS, 1);
+    radio.inject(SmTxResult::SMTX_BUSY, 1);
+
+    // an uplink of another stream is on air, the queue fills up with fragments of the next message
+    queue.openMessage(1);
+
+    TEST_ASSERT_TRUE(queuePacket(queue, 1, 10, 0));
+
+    uint32_t message = queue.openMessage(0);
+    uint8_t fragments = 0;
+
+    while(queuePacket(queue, 2, 60, 0))
+    {
+        fragments++;
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(1 + fragments, queue.getCount());
+
+    // the fragments queued so far cannot be reassembled, they are dropped and the packet on air is kept
+    queue.abortMessage();
+
+    TEST_ASSERT_EQUAL_UINT8(1, queue.getCount());
+    TEST_ASSERT_EQUAL_UINT32(fragments, queue.getDroppedCount());
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_SENDING, queue.getState());
+
+    // the packets committed after the abort have no message, the aborted one is never delivered
+    TEST_ASSERT_TRUE(queuePacket(queue, 3, 10, 0));
+
+    queue.txFinished(true, 1000);
+    queue.timerExpired(1000 + SmTxQueue::BUSY_RETRY_DELAY);
+    queue.txFinished(true, 3000);
+
+    uint8_t const order[2] = { 1, 3 };
+
+    TEST_ASSERT_EQUAL_UINT8(2, radio.sentCount);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(order, radio.sentFirstByte, 2);
+    TEST_ASSERT_FALSE(queue.isDelivered(0, message));
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_IDLE, queue.getState());
+
+    // a waiting head of the aborted message is dropped as well, the queue is idle then
+    FakeRadio busyRadio;
+    SmTxQueue busyQueue(busyRadio);
+
+    busyRadio.inject(SmTxResult::SMTX_BUSY, 1);
+
+    busyQueue.openMessage(0);
+
+    TEST_ASSERT_TRUE(queuePacket(busyQueue, 1, 10, 0));
+
+    busyQueue.abortMessage();
+
+    TEST_ASSERT_EQUAL_UINT8(0, busyQueue.getCount());
+    TEST_ASSERT_EQUAL(SmTxQueue::SmTxState::SMTXSTATE_IDLE, busyQueue.getState());
+    TEST_ASSERT_EQUAL_UINT32(SmTxQueue::NO_TIMER, busyQueue.getTimerDelay(0));
+}
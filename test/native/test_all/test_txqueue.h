@@ -0,0 +1,11 @@
+void test_txqueue_drain_in_order(void);
+void test_txqueue_busy(void);
+void test_txqueue_error_drop(void);
+void test_txqueue_nak(void);
+void test_txqueue_txfin_timeout(void);
+void test_txqueue_late_ack(void);
+void test_txqueue_full(void);
+void test_txqueue_fragments(void);
+void test_txqueue_supersede(void);
+void test_txqueue_oversized(void);
+void test_txqueue_abort(void);
@@ -0,0 +1,63 @@
+#include "unity.h"
+
+#include <stdio.h>
+#include <time.h>
+#include <chrono>
+
+#include "test_bench_datetime.h"
+
+#include "gbtddatetime.h"
+
+static uint32_t const BENCH_DATETIME_LOOPS = 1000000;
+
+// one 0x0c date time element, 26.12.2022 01:30:35 without deviation and clock status (as sent by the E450)
+static uint8_t const BENCH_DATETIME[13] = { 0x0c, 0x07, 0xe6, 0x0c, 0x1a, 0x01, 0x01, 0x1e, 0x23, 0x00, 0x80, 0x00, 0x00 };
+
+void test_bench_datetime_conversion(void)
+{
+    GbtDateTime dateTime;
+    ByteCursor cursor(BENCH_DATETIME, sizeof(BENCH_DATETIME));
+
+    dateTime.parse(cursor, 0, 0);
+
+    // volatile sink, the conversion must not be optimized away
+    volatile int64_t sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for(uint32_t i = 0; i < BENCH_DATETIME_LOOPS; i++)
+    {
+        sink = sink + (int64_t) dateTime.asUnixTimeStamp();
+    }
+
+    auto gbtDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    // reference, the libc conversion the previous implementation used
+    start = std::chrono::steady_clock::now();
+
+    for(uint32_t i = 0; i < BENCH_DATETIME_LOOPS; i++)
+    {
+        struct tm timeinfo = {};
+
+        timeinfo.tm_year = 2022 - 1900;
+        timeinfo.tm_mon = 11;
+        timeinfo.tm_mday = 26;
+        timeinfo.tm_hour = 1;
+        timeinfo.tm_min = 30;
+        timeinfo.tm_sec = 35;
+        timeinfo.tm_isdst = -1;
+
+        sink = sink + (int64_t) mktime(&timeinfo);
+    }
+
+    auto mktimeDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    char message[128];
+
+    snprintf(message, sizeof(message), "BENCH datetime asUnixTimeStamp %.1f ns/call, mktime %.1f ns/call",
+        (double) gbtDuration / BENCH_DATETIME_LOOPS, (double) mktimeDuration / BENCH_DATETIME_LOOPS);
+
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_TRUE(gbtDuration < mktimeDuration);
+}
@@ -0,0 +1 @@
+void test_bench_datetime_conversion(void);
@@ -0,0 +1,218 @@
+#include "unity.h"
+
+#include <stdio.h>
+#include <chrono>
+
+#include "test_bench_deltacodec.h"
+#include "../test_all/test_fixtures.h"
+
+#include "gbtdata.h"
+#include "gbtoctetstring.h"
+#include "smaggregator.h"
+#include "smdeltadecoder.h"
+#include "smdeltaencoder.h"
+#include "smprofile.h"
+#include "smpushextractor.h"
+
+static uint32_t const BENCH_DELTACODEC_PUSHES = 96 * 7;                 // one week of 15 minute pushes
+static uint32_t const BENCH_DELTACODEC_INTERVAL = 900;                  // push interval of the E450 in s
+static uint8_t const BENCH_DELTACODEC_MAX_RECORDS = 16;
+
+static GbtData gbtDataDeltaBench;
+
+// records of the E450 push, replayed with moving values as a sequence of pushes
+class ReplaySink : public SmRecordSink
+{
+    public:
+        uint32_t unixTime = 0;
+        uint8_t channel = 0;
+        uint8_t count = 0;
+        uint8_t channels[BENCH_DELTACODEC_MAX_RECORDS];
+        GbtValueBase const* rawValues[BENCH_DELTACODEC_MAX_RECORDS];
+        SmScaledValue scaledValues[BENCH_DELTACODEC_MAX_RECORDS];
+
+        bool addRecordTime(uint8_t const timeChannel, uint32_t const time) override
+        {
+            channel = timeChannel;
+            unixTime = time;
+
+            return true;
+        }
+
+        bool addRecordValue(uint8_t const valueChannel, GbtValueBase const* gbtValue) override
+        {
+            channels[count] = valueChannel;
+            rawValues[count++] = gbtValue;
+
+            return true;
+        }
+
+        bool addRecordScaled(uint8_t const valueChannel, SmScaledValue const& scaledValue) override
+        {
+            channels[count] = valueChannel;
+            rawValues[count] = nullptr;
+            scaledValues[count++] = scaledValue;
+
+            return true;
+        }
+};
+
+// size of the records in the meter data format of SmCayenne (channel, index, value type, value)
+class CayenneSizeSink : public SmRecordSink
+{
+    public:
+        uint32_t size = 0;
+
+        bool addRecordTime(uint8_t const channel, uint32_t const unixTime) override { size += 2 + 4; return true; }
+        bool addRecordValue(uint8_t const channel, GbtValueBase const* gbtValue) override
+        {
+            if(gbtValue->getValueType() == GbtValueBase::GbtValueType::GBTVALUETYPE_OCTETESTRING)
+            {
+                size += 3 + static_cast<GbtOctetString const*>(gbtValue)->getStringLength() + 1;
+            }
+            else
+            {
+                size += 3 + 4;
+            }
+
+            return true;
+        }
+        bool addRecordScaled(uint8_t const channel, SmScaledValue const& scaledValue) override { size += 3 + 6; return true; }
+};
+
+static uint32_t benchRandom = 1;
+
+// deterministic pseudo random numbers (LCG), the sequence is the same for every run
+static uint32_t nextRandom(uint32_t const range)
+{
+    benchRandom = benchRandom * 1103515245 + 12345;
+
+    return (benchRandom >> 16) % range;
+}
+
+// next push of the sequence: the counters rise, powers and currents vary around the recorded value, voltages by +-3 V
+static void nextPush(ReplaySink const& recorded, ReplaySink& push, uint32_t const index)
+{
+    push.unixTime = recorded.unixTime + index * BENCH_DELTACODEC_INTERVAL;
+
+    for(uint8_t i = 0; i < recorded.count; i++)
+    {
+        SmScaledValue& value = push.scaledValues[i];
+        int32_t const base = recorded.scaledValues[i].mantissa;
+
+        if(recorded.rawValues[i] != nullptr || value.unit == SmUnit::SMUNIT_NONE)
+        {
+            continue;
+        }
+
+        if(SmAggregator::isCounter(value.unit))
+        {
+            value.mantissa += nextRandom(400);
+        }
+        else if(value.unit == SmUnit::SMUNIT_VOLT)
+        {
+            value.mantissa = base + (int32_t) nextRandom(60) - 30;
+        }
+        else
+        {
+            value.mantissa = base / 2 + (int32_t) nextRandom(base + 1);
+        }
+    }
+}
+
+// adds the records of a push to a sink
+static void replayPush(ReplaySink const& push, SmRecordSink& sink)
+{
+    sink.addRecordTime(push.channel, push.unixTime);
+
+    for(uint8_t i = 0; i < push.count; i++)
+    {
+        if(push.rawValues[i] != nullptr)
+        {
+            sink.addRecordValue(push.channels[i], push.rawValues[i]);
+        }
+        else
+        {
+            sink.addRecordScaled(push.channels[i], push.scaledValues[i]);
+        }
+    }
+}
+
+// encodes the sequence, every lossEvery-th acknowledgement is lost (0 for none), the decoder checks each frame
+static void runSequence(ReplaySink const& recorded, uint32_t const lossEvery, uint32_t& cayenneBytes, uint32_t& deltaBytes, uint32_t& keyframes, int64_t& encodeNs)
+{
+    ReplaySink push = recorded;
+    SmDeltaEncoder encoder;
+    SmDeltaDecoder decoder;
+    SmDeltaFrame frame;
+    uint8_t buffer[222];
+
+    benchRandom = 1;
+    cayenneBytes = 0;
+    deltaBytes = 0;
+    keyframes = 0;
+    encodeNs = 0;
+
+    for(uint32_t index = 0; index < BENCH_DELTACODEC_PUSHES; index++)
+    {
+        CayenneSizeSink cayenne;
+
+        nextPush(recorded, push, index);
+
+        replayPush(push, cayenne);
+
+        auto start = std::chrono::steady_clock::now();
+
+        replayPush(push, encoder);
+
+        size_t size = encoder.encode(buffer, sizeof(buffer));
+
+        encodeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        TEST_ASSERT_TRUE(size > 0);
+        TEST_ASSERT_TRUE(decoder.decode(buffer, size, frame));
+        TEST_ASSERT_EQUAL_UINT32(push.unixTime, frame.getTime());
+
+        cayenneBytes += cayenne.size;
+        deltaBytes += size;
+        keyframes += decoder.isKeyframe() ? 1 : 0;
+
+        if(lossEvery == 0 || index % lossEvery != lossEvery - 1)
+        {
+            encoder.acknowledged();
+        }
+    }
+}
+
+void test_bench_deltacodec_e450_sequence(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, gbtDataDeltaBench.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+
+    SmPushExtractor extractor;
+    ReplaySink recorded;
+
+    TEST_ASSERT_TRUE(extractor.extract(gbtDataDeltaBench, SmProfiles::getDefault(), 10, true, recorded));
+
+    uint32_t cayenneBytes, deltaBytes, keyframes;
+    int64_t encodeNs;
+
+    runSequence(recorded, 0, cayenneBytes, deltaBytes, keyframes, encodeNs);
+
+    char message[200];
+
+    snprintf(message, sizeof(message), "BENCH deltacodec E450 %lu pushes, Cayenne %.1f bytes/uplink, delta %.1f bytes/uplink (%lu keyframes), encode %.0f ns/push",
+        (unsigned long) BENCH_DELTACODEC_PUSHES, (double) cayenneBytes / BENCH_DELTACODEC_PUSHES, (double) deltaBytes / BENCH_DELTACODEC_PUSHES,
+        (unsigned long) keyframes, (double) encodeNs / BENCH_DELTACODEC_PUSHES);
+
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_TRUE(deltaBytes < cayenneBytes);
+
+    // every 5th acknowledgement lost, the frames are sent against an older reference
+    runSequence(recorded, 5, cayenneBytes, deltaBytes, keyframes, encodeNs);
+
+    snprintf(message, sizeof(message), "BENCH deltacodec E450 with 20%% lost acknowledgements, delta %.1f bytes/uplink (%lu keyframes)",
+        (double) deltaBytes / BENCH_DELTACODEC_PUSHES, (unsigned long) keyframes);
+
+    TEST_MESSAGE(message);
+}
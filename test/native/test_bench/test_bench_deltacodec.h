@@ -0,0 +1 @@
+void test_bench_deltacodec_e450_sequence(void);
@@ -0,0 +1,88 @@
+#include "unity.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#include "test_bench_gbtcompression.h"
+#include "../test_all/test_fixtures.h"
+
+#include "smgbtcompressor.h"
+#include "smgbtdecompressor.h"
+#include "smprofile.h"
+
+static uint32_t const BENCH_GBTCOMPRESSION_PUSHES = 96 * 7;             // one week of 15 minute pushes
+static size_t const BENCH_GBTCOMPRESSION_VALUES = 290;                  // offset of the values in the E450 push (after the capture objects)
+static size_t const BENCH_GBTCOMPRESSION_FRAME = 51;                    // payload of DR0 (EU868)
+
+static SmGbtCompressor benchCompressor;
+static uint8_t benchPush[E450_GBTPDU_SIZE];
+static uint8_t benchRestored[SmGbtCompressor::MAX_INPUT_SIZE];
+
+static uint32_t benchRandom = 1;
+
+// deterministic pseudo random numbers (LCG), the sequence is the same for every run
+static uint32_t nextRandom(uint32_t const range)
+{
+    benchRandom = benchRandom * 1103515245UL + 12345UL;
+
+    return (benchRandom >> 16) % range;
+}
+
+void test_bench_gbtcompression_e450(void)
+{
+    TEST_ASSERT_TRUE(benchCompressor.select(SmProfiles::SMPROFILE_LG_E450));
+
+    memcpy(benchPush, e450GbtPdu, sizeof(benchPush));
+
+    uint32_t compressedBytes = 0;
+    uint32_t compressedFrames = 0;
+    int64_t encodeNs = 0;
+    int64_t decodeNs = 0;
+
+    for(uint32_t push = 0; push < BENCH_GBTCOMPRESSION_PUSHES; push++)
+    {
+        // the time stamp and the values move, the layout stays
+        benchPush[13] = push % 60;
+
+        for(uint8_t i = 0; i < 4; i++)
+        {
+            benchPush[BENCH_GBTCOMPRESSION_VALUES + 20 + nextRandom(E450_GBTPDU_SIZE - BENCH_GBTCOMPRESSION_VALUES - 20)] = nextRandom(256);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        size_t compressed = benchCompressor.compress(benchPush, sizeof(benchPush));
+
+        encodeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+
+        size_t restored = SmGbtDecompressor::decompress(benchCompressor.getOutput(), compressed, benchRestored, sizeof(benchRestored));
+
+        decodeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        TEST_ASSERT_EQUAL_size_t(sizeof(benchPush), restored);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(benchPush, benchRestored, sizeof(benchPush));
+
+        compressedBytes += compressed;
+        compressedFrames += (compressed + BENCH_GBTCOMPRESSION_FRAME - 1) / BENCH_GBTCOMPRESSION_FRAME;
+    }
+
+    char message[200];
+
+    snprintf(message, sizeof(message), "BENCH gbtcompression E450 %lu pushes, raw %u bytes, compressed %.1f bytes/push (ratio %.2f), %.2f frames at DR0 instead of %u",
+        (unsigned long) BENCH_GBTCOMPRESSION_PUSHES, (unsigned) E450_GBTPDU_SIZE, (double) compressedBytes / BENCH_GBTCOMPRESSION_PUSHES,
+        (double) E450_GBTPDU_SIZE * BENCH_GBTCOMPRESSION_PUSHES / compressedBytes, (double) compressedFrames / BENCH_GBTCOMPRESSION_PUSHES,
+        (unsigned) ((E450_GBTPDU_SIZE + BENCH_GBTCOMPRESSION_FRAME - 1) / BENCH_GBTCOMPRESSION_FRAME));
+
+    TEST_MESSAGE(message);
+
+    snprintf(message, sizeof(message), "BENCH gbtcompression E450 encode %.0f ns/push, decode %.0f ns/push (host), RAM %u bytes, dictionary %u bytes flash",
+        (double) encodeNs / BENCH_GBTCOMPRESSION_PUSHES, (double) decodeNs / BENCH_GBTCOMPRESSION_PUSHES,
+        (unsigned) sizeof(SmGbtCompressor), (unsigned) benchCompressor.getDictionary()->size);
+
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_TRUE(compressedBytes * 4 < E450_GBTPDU_SIZE * BENCH_GBTCOMPRESSION_PUSHES);
+}
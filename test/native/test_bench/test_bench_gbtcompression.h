@@ -0,0 +1 @@
+void test_bench_gbtcompression_e450(void);
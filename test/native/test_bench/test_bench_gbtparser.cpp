@@ -0,0 +1,64 @@
+#include "unity.h"
+
+#include <stdio.h>
+#include <chrono>
+
+#include "test_bench_gbtparser.h"
+#include "../test_all/test_fixtures.h"
+
+#include "gbtdata.h"
+
+static uint32_t const BENCH_GBTPARSER_LOOPS = 100000;
+
+static GbtData gbtDataBench;                                        // long-lived instance, as in the Wmb controller
+
+// sums the numeric values, measures the decoder without materialising the values
+class SumVisitor : public GbtVisitor
+{
+    public:
+        uint32_t sum = 0;
+
+        GbtVisitResult onUint8(uint8_t const value, uint8_t const structureIdent, uint8_t const arrayIdent) { sum += value; return GbtVisitResult::GBTVISIT_CONTINUE; }
+        GbtVisitResult onUint16(uint16_t const value, uint8_t const structureIdent, uint8_t const arrayIdent) { sum += value; return GbtVisitResult::GBTVISIT_CONTINUE; }
+        GbtVisitResult onUint32(uint32_t const value, uint8_t const structureIdent, uint8_t const arrayIdent) { sum += value; return GbtVisitResult::GBTVISIT_CONTINUE; }
+        GbtVisitResult onOctetString(uint8_t const* data, uint8_t const length, uint8_t const structureIdent, uint8_t const arrayIdent) { sum += length; return GbtVisitResult::GBTVISIT_CONTINUE; }
+};
+
+// the single runs of this test vary by more than 30 % on the host, the decoder versions were compared by the minimum
+// of 60 interleaved runs: about 265-287 ns/frame with the unchecked pointer reads before the ByteCursor, 251-267 with
+// the cursor and 247-268 with one size check per element and unchecked reads within it (no measurable cost)
+void test_bench_gbtparser_valid_frame(void)
+{
+    uint32_t valueCount = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for(uint32_t i = 0; i < BENCH_GBTPARSER_LOOPS; i++)
+    {
+        gbtDataBench.parse(e450GbtPdu, E450_GBTPDU_SIZE);
+
+        valueCount += gbtDataBench.getValueCount();
+    }
+
+    auto gbtDataDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    SumVisitor visitor;
+
+    start = std::chrono::steady_clock::now();
+
+    for(uint32_t i = 0; i < BENCH_GBTPARSER_LOOPS; i++)
+    {
+        GbtParser::parse(e450GbtPdu, E450_GBTPDU_SIZE, visitor);
+    }
+
+    auto parserDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    char message[160];
+
+    snprintf(message, sizeof(message), "BENCH gbtparser E450 frame (%d bytes) GbtData %.1f ns/frame, decoder only %.1f ns/frame (sum %u)",
+        E450_GBTPDU_SIZE, (double) gbtDataDuration / BENCH_GBTPARSER_LOOPS, (double) parserDuration / BENCH_GBTPARSER_LOOPS, visitor.sum);
+
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_EQUAL_UINT32(74 * BENCH_GBTPARSER_LOOPS, valueCount);
+}
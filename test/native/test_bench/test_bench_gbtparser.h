@@ -0,0 +1 @@
+void test_bench_gbtparser_valid_frame(void);
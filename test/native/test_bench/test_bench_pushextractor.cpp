@@ -0,0 +1,280 @@
+#include "unity.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#include "test_bench_pushextractor.h"
+#include "../test_all/test_fixtures.h"
+
+#include "gbtdata.h"
+#include "gbtoctetstring.h"
+#include "mylog.h"
+#include "smprofile.h"
+#include "smpushextractor.h"
+
+static uint32_t const BENCH_PUSHEXTRACTOR_LOOPS = 100000;
+static uint8_t const BASELINE_CHANNEL = 10;                                                         // channel of the SmLg450 of the baseline
+
+static GbtData gbtDataExtractorBench;
+
+// OBIS codes of E450 registers used for the synthetic pushes
+static uint8_t const BENCH_OBIS[][6] = {
+    { 0x01, 0x00, 0x01, 0x07, 0x00, 0xff }, { 0x01, 0x00, 0x02, 0x07, 0x00, 0xff },
+    { 0x01, 0x01, 0x01, 0x08, 0x00, 0xff }, { 0x01, 0x01, 0x02, 0x08, 0x00, 0xff },
+    { 0x01, 0x01, 0x05, 0x08, 0x00, 0xff }, { 0x01, 0x01, 0x06, 0x08, 0x00, 0xff },
+    { 0x01, 0x01, 0x07, 0x08, 0x00, 0xff }, { 0x01, 0x01, 0x08, 0x08, 0x00, 0xff }
+};
+
+// builds a push with the push setup and registerCount uint32 registers (same form as the E450 push)
+static size_t buildPush(uint8_t* pdu, uint8_t const registerCount)
+{
+    uint8_t const head[] = {
+        0x0f, 0x00, 0x00, 0x00, 0x01,
+        0x0c, 0x07, 0xe6, 0x0c, 0x1a, 0x01, 0x01, 0x1e, 0x23, 0xff, 0x80, 0x00, 0x00,
+        0x02, (uint8_t) (registerCount + 2), 0x01, (uint8_t) (registerCount + 1),
+        0x02, 0x04, 0x12, 0x00, 0x28, 0x09, 0x06, 0x00, 0x08, 0x19, 0x09, 0x00, 0xff, 0x0f, 0x01, 0x12, 0x00, 0x00
+    };
+
+    size_t size = sizeof(head);
+
+    memcpy(pdu, head, size);
+
+    for(uint8_t i = 0; i < registerCount; i++)
+    {
+        uint8_t const descriptor[] = { 0x02, 0x04, 0x12, 0x00, 0x03, 0x09, 0x06 };
+        uint8_t const attribute[] = { 0x0f, 0x02, 0x12, 0x00, 0x00 };
+
+        memcpy(pdu + size, descriptor, sizeof(descriptor));
+        size += sizeof(descriptor);
+        memcpy(pdu + size, BENCH_OBIS[i % 8], 6);
+        size += 6;
+        memcpy(pdu + size, attribute, sizeof(attribute));
+        size += sizeof(attribute);
+    }
+
+    uint8_t const pushSetup[] = { 0x09, 0x06, 0x00, 0x08, 0x19, 0x09, 0x00, 0xff };
+
+    memcpy(pdu + size, pushSetup, sizeof(pushSetup));
+    size += sizeof(pushSetup);
+
+    for(uint8_t i = 0; i < registerCount; i++)
+    {
+        uint8_t const value[] = { 0x06, 0x00, 0x01, 0x02, i };
+
+        memcpy(pdu + size, value, sizeof(value));
+        size += sizeof(value);
+    }
+
+    return size;
+}
+
+// SmLg450::parse of the baseline (the pre-change path), the device name and the time stamp are kept in the arguments
+static bool baselineParse(GbtDataBase const& gbtData, char* logicalDeviceName, GbtDateTime& gdbdateTime)
+{
+    MyLog::log("SMLG450", "Parse GBT data for SMLG450");
+
+    uint8_t index = 0;
+
+    // get the date and time from the GBT data
+    auto const& gbtDateTime = gbtData.getDateTime();
+
+    // copy the date and time into the member variable
+    gdbdateTime.clone(gbtDateTime);
+
+    uint8_t valueCount = gbtData.getValueCount();
+
+    while(index < valueCount)
+    {
+        auto const* gbtValue = gbtData.getValue(index);
+
+        if(gbtValue == nullptr)
+        {
+            MyLog::log("SMLG450", "Invalid GBT value returned for %d", index);
+
+            index++;
+        }
+        // GBT block
+        else if(gbtValue->getStructureIdent() == 4)
+        {
+            // describing structures are currently ignored
+            index += 4;
+        }
+        // LG block, order identifies the items based on the GBT block descriptions
+        else if(gbtValue->getValueType() == GbtValueBase::GbtValueType::GBTVALUETYPE_OCTETESTRING)
+        {
+            auto gbtIdentifier = static_cast<GbtOctetString const*>(gbtValue);
+
+            // test for the device name identifier
+            if(strcmp(gbtIdentifier->getStringValue(), "0.8.25.9.0.255") != 0)
+            {
+                continue;
+            }
+
+            // get the device name (in the next value)
+            auto const* gbtValueDeviceNameData = gbtData.getValue(index + 1);
+
+            // something went wrong
+            if(gbtValueDeviceNameData == nullptr)
+            {
+                MyLog::log("SMLG450", "Null LG GBT value returned for index %d, expected pointer to device name, breaking loop", index + 1);
+
+                break;
+            }
+
+            // check if the value is an octet string
+            if(gbtValueDeviceNameData->getValueType() != GbtValueBase::GbtValueType::GBTVALUETYPE_OCTETESTRING)
+            {
+                MyLog::log("SMLG450", "Invalid LG GBT value returned for index %d, expected string for the device name, breaking loop", index + 1);
+
+                break;
+            }
+
+            auto const* gbtValueDeviceName = static_cast<GbtOctetString const*>(gbtValueDeviceNameData);
+
+            MyLog::log("SMLG450", "Found device name %s", gbtValueDeviceName->getStringValue());
+
+            // copy the device name into the member variable
+            strncpy(logicalDeviceName, gbtValueDeviceName->getStringValue(), gbtValueDeviceName->getStringLength() + 1);
+
+            // point to the next value
+            index += 14;
+        }
+        else
+        {
+            // point to the next value
+            index++;
+        }
+    }
+
+    return true;
+}
+
+// SmLg450::copyData of the baseline (the pre-change path), the values go into the sink instead of cayenne
+static void baselineCopyData(GbtDataBase const& gbtData, SmRecordSink& sink)
+{
+    uint8_t i = 0;
+
+    sink.addRecordTime(BASELINE_CHANNEL, gbtData.getDateTime().asUnixTimeStamp());
+
+    uint8_t valueItems = gbtData.getValueCount();
+
+    while(i < valueItems)
+    {
+        GbtValueBase const *gbtValue = gbtData.getValue(i);
+
+        if(gbtValue == nullptr)
+        {
+            MyLog::log("SMLG450", "Invalid GBT value returned for %d", i);
+
+            continue;
+        }
+
+        // GBT block
+        if(gbtValue->getStructureIdent() == 4)
+        {
+            // describing structures are currently ignored
+            i += 4;
+        }
+        // LG block, order identifies the items based on the GBT block descriptions
+        else
+        {
+            sink.addRecordValue(BASELINE_CHANNEL, gbtValue);
+
+            MyLog::log("SMLG450", "Add data for channel %d", BASELINE_CHANNEL);
+
+            i += 1;
+        }
+    }
+}
+
+void test_bench_pushextractor_e450(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, gbtDataExtractorBench.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+
+    SmProfile const& e450 = SmProfiles::getDefault();
+    SmPushExtractor extractor;
+    CountingSink sink;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // one pass: device name, time stamp and records
+    for(uint32_t loop = 0; loop < BENCH_PUSHEXTRACTOR_LOOPS; loop++)
+    {
+        extractor.extract(gbtDataExtractorBench, e450, e450.channel, false, sink);
+    }
+
+    auto onePassDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    CountingSink baselineSink;
+    char deviceName[SmPushExtractor::MAX_DEVICENAME];
+    GbtDateTime dateTime;
+
+    start = std::chrono::steady_clock::now();
+
+    // pre-change path: SmLg450::parse, then SmLg450::copyData
+    for(uint32_t loop = 0; loop < BENCH_PUSHEXTRACTOR_LOOPS; loop++)
+    {
+        baselineParse(gbtDataExtractorBench, deviceName, dateTime);
+        baselineCopyData(gbtDataExtractorBench, baselineSink);
+    }
+
+    auto baselineDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    char message[160];
+
+    snprintf(message, sizeof(message), "BENCH pushextractor E450, one pass %.1f ns/push, SmLg450 parse and copyData %.1f ns/push",
+        (double) onePassDuration / BENCH_PUSHEXTRACTOR_LOOPS, (double) baselineDuration / BENCH_PUSHEXTRACTOR_LOOPS);
+
+    TEST_MESSAGE(message);
+
+    // both send the time stamp and the 14 values of the E450 push
+    TEST_ASSERT_EQUAL_UINT32(15 * BENCH_PUSHEXTRACTOR_LOOPS, sink.records);
+    TEST_ASSERT_EQUAL_UINT32(sink.records, baselineSink.records);
+    TEST_ASSERT_EQUAL_STRING(extractor.getDeviceName(), deviceName);
+
+    // regression guard, the cached layout keeps the one pass at least as fast as the SmLg450 path
+    TEST_ASSERT_TRUE(onePassDuration <= baselineDuration);
+}
+
+void test_bench_pushextractor_scaling(void)
+{
+    uint8_t pdu[512];
+
+    SmProfile const& e450 = SmProfiles::getDefault();
+
+    double nsPerValue[3];
+    uint8_t const registerCounts[3] = { 4, 8, 16 };
+
+    for(uint8_t run = 0; run < 3; run++)
+    {
+        size_t size = buildPush(pdu, registerCounts[run]);
+
+        TEST_ASSERT_EQUAL_INT(0, gbtDataExtractorBench.parse(pdu, size));
+
+        SmPushExtractor extractor;
+        CountingSink sink;
+
+        TEST_ASSERT_TRUE(extractor.extract(gbtDataExtractorBench, e450, e450.channel, false, sink));
+        TEST_ASSERT_EQUAL_UINT8(registerCounts[run] + 1, extractor.getLayout().getValueCount());
+        TEST_ASSERT_EQUAL_UINT8(registerCounts[run] + 1, extractor.getRecordCount());
+
+        auto start = std::chrono::steady_clock::now();
+
+        for(uint32_t loop = 0; loop < BENCH_PUSHEXTRACTOR_LOOPS; loop++)
+        {
+            extractor.extract(gbtDataExtractorBench, e450, e450.channel, false, sink);
+        }
+
+        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        nsPerValue[run] = (double) duration / BENCH_PUSHEXTRACTOR_LOOPS / gbtDataExtractorBench.getValueCount();
+    }
+
+    char message[160];
+
+    snprintf(message, sizeof(message), "BENCH pushextractor scaling, %.2f / %.2f / %.2f ns/value for 4 / 8 / 16 registers",
+        nsPerValue[0], nsPerValue[1], nsPerValue[2]);
+
+    TEST_MESSAGE(message);
+}
@@ -0,0 +1,2 @@
+void test_bench_pushextractor_e450(void);
+void test_bench_pushextractor_scaling(void);
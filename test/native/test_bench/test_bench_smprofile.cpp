@@ -0,0 +1,109 @@
+#include "unity.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#include "test_bench_smprofile.h"
+#include "../test_all/test_fixtures.h"
+
+#include "gbtdata.h"
+#include "gbtoctetstring.h"
+#include "smprofile.h"
+#include "smpushlayout.h"
+
+static uint32_t const BENCH_SMPROFILE_LOOPS = 100000;
+
+static GbtData gbtDataProfileBench;
+
+void test_bench_smprofile_layout(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, gbtDataProfileBench.parse(e450GbtPdu, E450_GBTPDU_SIZE));
+
+    SmProfile const& e450 = SmProfiles::getDefault();
+    SmPushLayout layout;
+
+    uint32_t profileCount = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // value selection per push with the cached layout (as the copy loop of SmPushExtractor::extract)
+    for(uint32_t loop = 0; loop < BENCH_SMPROFILE_LOOPS; loop++)
+    {
+        layout.update(gbtDataProfileBench, e450);
+
+        if(layout.getDeviceNameIndex() < layout.getValueCount()
+            && gbtDataProfileBench.getValue(layout.getValueIndex(layout.getDeviceNameIndex()))->getValueType() == GbtValueBase::GbtValueType::GBTVALUETYPE_OCTETESTRING)
+        {
+            profileCount++;
+        }
+
+        for(uint8_t i = 0; i < layout.getValueCount(); i++)
+        {
+            if(layout.getRegister(i) != nullptr && gbtDataProfileBench.getValue(layout.getValueIndex(i)) != nullptr)
+            {
+                profileCount++;
+            }
+        }
+    }
+
+    auto profileDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    uint32_t handWrittenCount = 0;
+
+    start = std::chrono::steady_clock::now();
+
+    // value selection of the former hand written E450 handler, parse (device name) and copy (skip the descriptors, send everything else)
+    for(uint32_t loop = 0; loop < BENCH_SMPROFILE_LOOPS; loop++)
+    {
+        uint8_t i = 0;
+
+        while(i < gbtDataProfileBench.getValueCount())
+        {
+            auto const* gbtValue = gbtDataProfileBench.getValue(i);
+
+            if(gbtValue->getStructureIdent() == 4)
+            {
+                i += 4;
+            }
+            else if(gbtValue->getValueType() == GbtValueBase::GbtValueType::GBTVALUETYPE_OCTETESTRING
+                && strcmp(static_cast<GbtOctetString const*>(gbtValue)->getStringValue(), "0.8.25.9.0.255") == 0
+                && gbtDataProfileBench.getValue(i + 1)->getValueType() == GbtValueBase::GbtValueType::GBTVALUETYPE_OCTETESTRING)
+            {
+                i += 14;
+            }
+            else
+            {
+                i++;
+            }
+        }
+
+        i = 0;
+
+        while(i < gbtDataProfileBench.getValueCount())
+        {
+            if(gbtDataProfileBench.getValue(i)->getStructureIdent() == 4)
+            {
+                i += 4;
+            }
+            else
+            {
+                handWrittenCount++;
+
+                i += 1;
+            }
+        }
+    }
+
+    auto handWrittenDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    char message[160];
+
+    snprintf(message, sizeof(message), "BENCH smprofile E450 value selection, cached layout %.1f ns/push, hand written %.1f ns/push",
+        (double) profileDuration / BENCH_SMPROFILE_LOOPS, (double) handWrittenDuration / BENCH_SMPROFILE_LOOPS);
+
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_EQUAL_UINT32(14 * BENCH_SMPROFILE_LOOPS, handWrittenCount);
+    TEST_ASSERT_EQUAL_UINT32(15 * BENCH_SMPROFILE_LOOPS, profileCount);
+}
@@ -0,0 +1 @@
+void test_bench_smprofile_layout(void);
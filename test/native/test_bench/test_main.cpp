@@ -0,0 +1,38 @@
+#include "unity.h"
+#include "test_bench_datetime.h"
+#include "test_bench_gbtparser.h"
+#include "test_bench_smprofile.h"
+#include "test_bench_pushextractor.h"
+#include "test_bench_deltacodec.h"
+#include "test_bench_gbtcompression.h"
+
+// host benchmarks, run in a PlatformIO Terminal window using
+// pio test -e testnative -f native/test_bench -v
+
+
+void setUp(void) {
+  // set stuff up here
+}
+
+void tearDown(void) {
+  // clean stuff up here
+}
+
+int runUnityTests(void) {
+
+  UNITY_BEGIN();
+
+  RUN_TEST(test_bench_datetime_conversion);
+  RUN_TEST(test_bench_gbtparser_valid_frame);
+  RUN_TEST(test_bench_smprofile_layout);
+  RUN_TEST(test_bench_pushextractor_e450);
+  RUN_TEST(test_bench_pushextractor_scaling);
+  RUN_TEST(test_bench_deltacodec_e450_sequence);
+  RUN_TEST(test_bench_gbtcompression_e450);
+
+  return UNITY_END();
+}
+
+int main(void) {
+  return runUnityTests();
+}